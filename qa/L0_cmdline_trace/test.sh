@@ -27,6 +27,7 @@
 
 SIMPLE_CLIENT=../clients/simple_client
 TRACE_SUMMARY=../common/trace_summary.py
+TRACE_CONVERT=../common/trace_binary_to_json.py
 
 REPO_VERSION=${NVIDIA_TRITON_SERVER_VERSION}
 if [ "$#" -ge 1 ]; then
@@ -121,7 +122,8 @@ wait $SERVER_PID
 
 set +e
 
-$TRACE_SUMMARY -t trace_1.log > summary_1.log
+$TRACE_CONVERT -o trace_1.json trace_1.log
+$TRACE_SUMMARY -t trace_1.json > summary_1.log
 
 if [ `grep -c "compute input end" summary_1.log` != "0" ]; then
     cat summary_1.log
@@ -168,7 +170,8 @@ wait $SERVER_PID
 
 set +e
 
-$TRACE_SUMMARY -t trace_6.log > summary_6.log
+$TRACE_CONVERT -o trace_6.json trace_6.log
+$TRACE_SUMMARY -t trace_6.json > summary_6.log
 
 if [ `grep -c "compute input end" summary_6.log` != "0" ]; then
     cat summary_6.log
@@ -215,7 +218,8 @@ wait $SERVER_PID
 
 set +e
 
-$TRACE_SUMMARY -t trace_9.log > summary_9.log
+$TRACE_CONVERT -o trace_9.json trace_9.log
+$TRACE_SUMMARY -t trace_9.json > summary_9.log
 
 if [ `grep -c "compute input end" summary_9.log` != "2" ]; then
     cat summary_9.log
@@ -280,7 +284,8 @@ wait $SERVER_PID
 
 set +e
 
-$TRACE_SUMMARY -t trace_ensemble.log > summary_ensemble.log
+$TRACE_CONVERT -o trace_ensemble.json trace_ensemble.log
+$TRACE_SUMMARY -t trace_ensemble.json > summary_ensemble.log
 
 if [ `grep -c "compute input end" summary_ensemble.log` != "7" ]; then
     cat summary_9.log
@@ -0,0 +1,120 @@
+#!/usr/bin/python
+
+# Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Convert a binary trace file written by --trace-file into the JSON
+# trace format understood by trace_summary.py and documented in
+# docs/trace.rst.
+#
+# The binary format is an 8-byte magic header "TRTSTRC1" followed by
+# self-describing records, all multi-byte values little-endian:
+#
+#   name record:  u8 type=1, u16 table index, u16 length, 'length'
+#                 bytes of name
+#   trace record: u8 type=2, u16 model-name table index, i64 model
+#                 version, i64 id, i64 parent id, u16 event count,
+#                 then for each event a u16 name table index and a
+#                 u64 nanosecond timestamp
+
+import argparse
+import json
+import struct
+import sys
+
+FLAGS = None
+
+TRACE_FILE_MAGIC = b'TRTSTRC1'
+NAME_RECORD_TYPE = 1
+TRACE_RECORD_TYPE = 2
+
+def read_exactly(f, byte_cnt):
+    buf = f.read(byte_cnt)
+    if len(buf) != byte_cnt:
+        raise ValueError('truncated trace file')
+    return buf
+
+def parse_trace_file(f):
+    if read_exactly(f, 8) != TRACE_FILE_MAGIC:
+        raise ValueError('not a binary trace file, bad magic')
+
+    names = {}
+    traces = []
+
+    while True:
+        record_type = f.read(1)
+        if len(record_type) == 0:
+            break
+        record_type = struct.unpack('<B', record_type)[0]
+
+        if record_type == NAME_RECORD_TYPE:
+            index, length = struct.unpack('<HH', read_exactly(f, 4))
+            names[index] = read_exactly(f, length).decode('utf-8')
+        elif record_type == TRACE_RECORD_TYPE:
+            model_index, model_version, trace_id, parent_id, event_cnt = \
+                struct.unpack('<HqqqH', read_exactly(f, 28))
+            trace = {
+                'model_name': names[model_index],
+                'model_version': model_version
+            }
+            if trace_id != -1:
+                trace['id'] = trace_id
+            if parent_id != -1:
+                trace['parent_id'] = parent_id
+            trace['timestamps'] = []
+            for _ in range(event_cnt):
+                name_index, ns = struct.unpack('<HQ', read_exactly(f, 10))
+                trace['timestamps'].append({
+                    'name': names[name_index],
+                    'ns': ns
+                })
+            traces.append(trace)
+        else:
+            raise ValueError(
+                'unknown trace record type {}'.format(record_type))
+
+    return traces
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        '-o',
+        '--output',
+        type=str,
+        required=False,
+        default=None,
+        help='Output file, default is stdout')
+    parser.add_argument('file', type=argparse.FileType('rb'))
+    FLAGS = parser.parse_args()
+
+    traces = parse_trace_file(FLAGS.file)
+
+    if FLAGS.output is not None:
+        with open(FLAGS.output, 'w') as f:
+            json.dump(traces, f)
+    else:
+        json.dump(traces, sys.stdout)
+        sys.stdout.write('\n')
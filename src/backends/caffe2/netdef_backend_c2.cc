@@ -339,6 +339,16 @@ Caffe2WorkspaceCreate(
     netdef_model.mutable_op()->CopyFrom(new_input_ops.op());
   }
 
+  // Use the operator-level DAG executor so that independent branches
+  // of the net execute concurrently, on separate streams for GPU
+  // operators, instead of serializing in graph order. RunNet() still
+  // waits for the whole net so the synchronous semantics of Run() are
+  // unchanged. A net that explicitly requests a different executor
+  // keeps it.
+  if (netdef_model.type().empty() || (netdef_model.type() == "simple")) {
+    netdef_model.set_type("async_scheduling");
+  }
+
   Caffe2WorkspaceImpl* c2wsimpl;
   Caffe2Workspace::Error err = Caffe2WorkspaceImpl::Create(
       &c2wsimpl, model_name, max_batch_size, input_names, output_names,
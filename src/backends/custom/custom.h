@@ -69,6 +69,37 @@ typedef enum custom_serverparamkind_enum {
   MODEL_REPOSITORY_PATH = 1
 } CustomServerParameter;
 
+/// Type for the CustomPinnedAlloc callback function.
+///
+/// This callback function is provided in CustomInitializeData and is
+/// used to allocate a buffer from the server's pinned-memory
+/// pool. Pinned buffers give full-bandwidth cudaMemcpy transfers and
+/// should be used to stage data moving to or from GPU memory; this is
+/// the same fast path used by the built-in backends. A buffer
+/// obtained from this function must be returned with the
+/// corresponding CustomPinnedFreeFn_t function.
+///
+/// \param pinned_memory_context The pinned memory context provided in
+/// CustomInitializeData.
+/// \param byte_size The size of the buffer, in bytes.
+/// \param buffer Returns the allocated buffer.
+/// \return false if error, true if success.
+typedef bool (*CustomPinnedAllocFn_t)(
+    void* pinned_memory_context, uint64_t byte_size, void** buffer);
+
+/// Type for the CustomPinnedFree callback function.
+///
+/// This callback function is provided in CustomInitializeData and is
+/// used to release a buffer obtained from a CustomPinnedAllocFn_t
+/// function back to the server's pinned-memory pool.
+///
+/// \param pinned_memory_context The pinned memory context provided in
+/// CustomInitializeData.
+/// \param buffer The buffer to release.
+/// \return false if error, true if success.
+typedef bool (*CustomPinnedFreeFn_t)(
+    void* pinned_memory_context, void* buffer);
+
 // The initialization information provided to a custom backend when it
 // is created.
 typedef struct custom_initdata_struct {
@@ -97,6 +128,20 @@ typedef struct custom_initdata_struct {
   /// and must be copied if a persistent copy of required by the
   /// custom backend.
   const char** server_parameters;
+
+  /// The context to use with the 'pinned_alloc_fn' and
+  /// 'pinned_free_fn' callback functions.
+  void* pinned_memory_context;
+
+  /// The callback function to allocate a staging buffer from the
+  /// server's pinned-memory pool (see CustomPinnedAllocFn_t). May be
+  /// nullptr if the server does not expose the pool.
+  CustomPinnedAllocFn_t pinned_alloc_fn;
+
+  /// The callback function to release a buffer obtained from
+  /// 'pinned_alloc_fn' (see CustomPinnedFreeFn_t). May be nullptr if
+  /// the server does not expose the pool.
+  CustomPinnedFreeFn_t pinned_free_fn;
 } CustomInitializeData;
 
 /// A payload represents the input tensors and the required output
@@ -238,6 +283,54 @@ typedef int (*CustomExecuteV2Fn_t)(
     void*, uint32_t, CustomPayload*, CustomGetNextInputV2Fn_t,
     CustomGetOutputV2Fn_t);
 
+/// Type for the CustomOutputRelease callback function.
+///
+/// This function is invoked by the inference server to release an
+/// output buffer that was donated by the custom backend in a call to
+/// a CustomPutOutputV2Fn_t function. After this function is invoked
+/// the server holds no reference to the buffer.
+typedef void (*CustomOutputReleaseFn_t)(void* release_userp);
+
+/// Type for the CustomPutOutput callback function.
+///
+/// This callback function is provided in the call to CustomExecuteV3
+/// and is used to donate a backend-owned buffer holding the complete
+/// value of an output tensor, as an alternative to filling a
+/// server-provided buffer obtained from CustomGetOutputV2Fn_t. If
+/// this function returns true the server takes a reference to
+/// 'content' and will invoke 'release_fn' with 'release_userp' when
+/// the buffer is no longer needed; the backend must keep the buffer
+/// valid and unmodified until then. If this function returns false
+/// the server holds no reference and 'release_fn' will not be
+/// invoked.
+///
+/// \param output_context The output context provided in call to
+/// CustomExecuteV3.
+/// \param name The name of the output tensor.
+/// \param shape_dim_cnt The number of dimensions in the output shape.
+/// \param shape_dims The dimensions of the output shape.
+/// \param content_byte_size The size, in bytes, of the output tensor.
+/// \param content The backend-owned buffer holding the output tensor
+/// value.
+/// \param memory_type The memory type of 'content'.
+/// \param memory_type_id The memory type id of 'content'.
+/// \param release_fn The function the server invokes when it no
+/// longer references 'content'. May be nullptr if the backend
+/// guarantees the buffer outlives the execute call without an
+/// explicit release.
+/// \param release_userp The user pointer passed to 'release_fn'.
+/// \return false if error, true if success.
+typedef bool (*CustomPutOutputV2Fn_t)(
+    void* output_context, const char* name, size_t shape_dim_cnt,
+    int64_t* shape_dims, uint64_t content_byte_size, void* content,
+    CustomMemoryType memory_type, int64_t memory_type_id,
+    CustomOutputReleaseFn_t release_fn, void* release_userp);
+
+/// Type for the CustomExecuteV3 function.
+typedef int (*CustomExecuteV3Fn_t)(
+    void*, uint32_t, CustomPayload*, CustomGetNextInputV2Fn_t,
+    CustomGetOutputV2Fn_t, CustomPutOutputV2Fn_t);
+
 /// Get the custom version. For a custom backend that doesn't define this entry
 /// point, the inference server will assume the backend version is 1. The
 /// currently supported versions are defined below, returning any other version
@@ -253,6 +346,11 @@ typedef int (*CustomExecuteV2Fn_t)(
 /// CustomGetNextInputV2Fn_t and CustomGetOutputV2Fn_t define the function
 /// signature for the input and output callbacks.
 ///
+/// Version 3: Like version 2, and in addition the backend may donate its
+/// own buffer as the value of an output via the CustomPutOutputV2Fn_t
+/// callback instead of copying into a server-provided buffer. The
+/// CustomExecuteV3 function must be defined.
+///
 /// \return the custom version.
 TRTIS_CUSTOM_EXPORT uint32_t CustomVersion();
 
@@ -317,6 +415,19 @@ TRTIS_CUSTOM_EXPORT int CustomExecuteV2(
     void* custom_context, uint32_t payload_cnt, CustomPayload* payloads,
     CustomGetNextInputV2Fn_t input_fn, CustomGetOutputV2Fn_t output_fn);
 
+/// Execute the custom model using the version 3 implementation of the execute
+/// interface. This function must be defined when the custom backend returns 3
+/// from CustomVersion. See CustomExecute for description of the other
+/// parameters.
+///
+/// \param put_output_fn The callback function to donate a
+/// backend-owned buffer as the value of an output (see
+/// CustomPutOutputV2Fn_t).
+TRTIS_CUSTOM_EXPORT int CustomExecuteV3(
+    void* custom_context, uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetNextInputV2Fn_t input_fn, CustomGetOutputV2Fn_t output_fn,
+    CustomPutOutputV2Fn_t put_output_fn);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,9 +29,11 @@
 #include <stdint.h>
 #include "src/backends/custom/loader.h"
 #include "src/core/constants.h"
+#include "src/core/cuda_utils.h"
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/pinned_memory_manager.h"
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
 
@@ -126,6 +128,10 @@ CustomBackend::CreateExecutionContexts(
             group.name() + "_" + std::to_string(c) + "_cpu";
         RETURN_IF_ERROR(CreateExecutionContext(
             instance_name, Context::NO_GPU_DEVICE, libraries));
+        RegisterContextFactory([this, instance_name, libraries]() -> Status {
+          return CreateExecutionContext(
+              instance_name, Context::NO_GPU_DEVICE, libraries);
+        });
         total_context_cnt++;
       } else {
         for (int gpu_device : group.gpus()) {
@@ -134,6 +140,11 @@ CustomBackend::CreateExecutionContexts(
                                             std::to_string(gpu_device);
           RETURN_IF_ERROR(
               CreateExecutionContext(instance_name, gpu_device, libraries));
+          RegisterContextFactory(
+              [this, instance_name, gpu_device, libraries]() -> Status {
+                return CreateExecutionContext(
+                    instance_name, gpu_device, libraries);
+              });
           total_context_cnt++;
         }
       }
@@ -226,11 +237,13 @@ CustomBackend::CreateExecutionContext(
       mn_itr->second, &(context->library_handle_), &(context->InitializeFn_),
       &(context->FinalizeFn_), &(context->ErrorStringFn_),
       &(context->ExecuteFn_), &(context->ExecuteV2Fn_),
-      &(context->custom_version_)));
+      &(context->ExecuteV3Fn_), &(context->custom_version_)));
 
   // Only create stream on V1 as backend is not aware of different memory
-  // types. For other version, the backend should handle this explicitly.
-  if (context->custom_version_ == 1) {
+  // types, and on V3 where the server copies donated output buffers on
+  // behalf of the backend. For V2, the backend should handle this
+  // explicitly.
+  if ((context->custom_version_ == 1) || (context->custom_version_ == 3)) {
     RETURN_IF_ERROR(context->CreateCudaStream());
   }
 
@@ -249,6 +262,12 @@ CustomBackend::CreateExecutionContext(
     }
   }
 
+  // Collect the batch inputs whose values must be generated by the
+  // server for each payload.
+  for (const auto& batch_input : Config().batch_input()) {
+    context->batch_inputs_.push_back(batch_input);
+  }
+
   return Status::Success;
 }
 
@@ -288,6 +307,13 @@ CustomBackend::InitBackend(uint32_t runner_idx)
     init_data.server_parameters = nullptr;
   }
 
+  // Give the backend access to the server's pinned-memory pool for
+  // staging transfers to and from GPU memory. The callbacks are
+  // stateless so no context object is needed.
+  init_data.pinned_memory_context = nullptr;
+  init_data.pinned_alloc_fn = CustomPinnedAlloc;
+  init_data.pinned_free_fn = CustomPinnedFree;
+
   int err =
       context->InitializeFn_(&init_data, &(context->library_context_handle_));
   if (context->library_context_handle_ == nullptr) {
@@ -474,6 +500,11 @@ CustomBackend::Context::Run(
   // requested outputs.
   int err = 0;
   switch (custom_version_) {
+    case 3:
+      err = ExecuteV3Fn_(
+          library_context_handle_, custom_payloads.size(), &custom_payloads[0],
+          CustomGetNextInputV2, CustomGetOutputV2, CustomPutOutputV2);
+      break;
     case 2:
       err = ExecuteV2Fn_(
           library_context_handle_, custom_payloads.size(), &custom_payloads[0],
@@ -514,6 +545,18 @@ CustomBackend::Context::Run(
   cudaStreamSynchronize(stream_);
 #endif  // TRTIS_ENABLE_GPU
 
+  // Release output buffers donated by the backend via the V3
+  // interface, now that any deferred copies into the response buffers
+  // have completed.
+  for (auto& work_io_context : work_io_contexts) {
+    for (auto& donated : work_io_context.donated_buffers_) {
+      if (donated.first != nullptr) {
+        donated.first(donated.second);
+      }
+    }
+    work_io_context.donated_buffers_.clear();
+  }
+
 #ifdef TRTIS_ENABLE_STATS
   for (auto& payload : *payloads) {
     if (payload.stats_ != nullptr) {
@@ -589,6 +632,18 @@ CustomBackend::Context::GetNextInput(
   const std::string name(cname);
   Scheduler::Payload* payload = input_context->payload_;
 
+  // The requested input may be a batch input whose value is generated
+  // by the server rather than provided by the request.
+  for (const auto& batch_input : batch_inputs_) {
+    for (const auto& target : batch_input.target_name()) {
+      if (target == name) {
+        return GetBatchInput(
+            input_context, batch_input, name, content, content_byte_size,
+            memory_type, memory_type_id);
+      }
+    }
+  }
+
   const InferenceRequest::Input* rinput;
   Status status = payload->request_->ImmutableInput(name, &rinput);
   if (status.IsOk()) {
@@ -619,6 +674,60 @@ CustomBackend::Context::GetNextInput(
   return status.IsOk();
 }
 
+bool
+CustomBackend::Context::GetBatchInput(
+    GetInputOutputContext* input_context, const ModelBatchInput& batch_input,
+    const std::string& name, const void** content, uint64_t* content_byte_size,
+    CustomMemoryType* memory_type, int64_t* memory_type_id)
+{
+  // All content for a batch input is returned in a single buffer, so
+  // a second request for the same target indicates end-of-input.
+  if (!input_context->returned_batch_inputs_.insert(name).second) {
+    *content = nullptr;
+    *content_byte_size = 0;
+    return true;
+  }
+
+  // The custom interface hands the backend one payload at a time so
+  // only the per-request element count can be communicated here.
+  if (batch_input.kind() != ModelBatchInput::BATCH_ELEMENT_COUNT) {
+    LOG_ERROR << "unsupported batch input kind for custom backend input '"
+              << name << "'";
+    return false;
+  }
+
+  Scheduler::Payload* payload = input_context->payload_;
+  const InferenceRequest::Input* src;
+  Status status =
+      payload->request_->ImmutableInput(batch_input.source_input(0), &src);
+  if (!status.IsOk()) {
+    LOG_VERBOSE(1) << status.AsString();
+    return false;
+  }
+
+  int64_t element_count = GetElementCount(src->Shape());
+  if (payload->request_->BatchSize() != 0) {
+    element_count *= payload->request_->BatchSize();
+  }
+
+  const size_t byte_size = GetDataTypeByteSize(batch_input.data_type());
+  input_context->input_buffers_.emplace_back(new char[byte_size]);
+  char* buffer = input_context->input_buffers_.back().get();
+  if (batch_input.data_type() == TYPE_FP32) {
+    const float value = element_count;
+    memcpy(buffer, &value, sizeof(value));
+  } else {
+    const int32_t value = element_count;
+    memcpy(buffer, &value, sizeof(value));
+  }
+
+  *content = buffer;
+  *content_byte_size = byte_size;
+  *memory_type = CUSTOM_MEMORY_CPU;
+  *memory_type_id = 0;
+  return true;
+}
+
 bool
 CustomBackend::Context::GetOutput(
     GetInputOutputContext* output_context, const char* cname,
@@ -710,6 +819,59 @@ CustomBackend::Context::GetOutput(
   return true;
 }
 
+bool
+CustomBackend::Context::PutOutput(
+    GetInputOutputContext* output_context, const char* cname,
+    size_t shape_dim_cnt, int64_t* shape_dims, uint64_t content_byte_size,
+    void* content, CustomMemoryType memory_type, int64_t memory_type_id,
+    CustomOutputReleaseFn_t release_fn, void* release_userp)
+{
+  const std::string name(cname);
+  Scheduler::Payload* payload = output_context->payload_;
+
+  // If the output is not required simply take the reference and
+  // release it after the execution completes. The backend doesn't
+  // need to distinguish this case from a consumed output.
+  if ((payload->response_provider_ == nullptr) ||
+      !payload->response_provider_->RequiresOutput(name)) {
+    output_context->donated_buffers_.emplace_back(release_fn, release_userp);
+    return true;
+  }
+
+  std::vector<int64_t> shape;
+  if (shape_dim_cnt > 0) {
+    shape.assign(shape_dims, shape_dims + shape_dim_cnt);
+  }
+
+  // The response allocator requires the output content to end up in
+  // the buffer it provides, so allocate that buffer, preferring the
+  // memory type of the donated buffer, and copy asynchronously on the
+  // context's stream. The donated buffer is held as the copy source
+  // until the execution completes.
+  void* buffer = nullptr;
+  TRTSERVER_Memory_Type actual_memory_type;
+  int64_t actual_memory_type_id;
+  Status status = payload->response_provider_->AllocateOutputBuffer(
+      name, &buffer, content_byte_size, shape,
+      ToTRTServerMemoryType(memory_type), memory_type_id, &actual_memory_type,
+      &actual_memory_type_id);
+  if (status.IsOk() && (buffer != nullptr) && (content_byte_size > 0)) {
+    bool cuda_used = false;
+    status = CopyBuffer(
+        name, ToTRTServerMemoryType(memory_type), memory_type_id,
+        actual_memory_type, actual_memory_type_id, content_byte_size, content,
+        buffer, stream_, &cuda_used);
+  }
+  if (!status.IsOk()) {
+    LOG_VERBOSE(1) << status.AsString();
+    return false;
+  }
+
+  output_context->donated_buffers_.emplace_back(release_fn, release_userp);
+
+  return true;
+}
+
 std::string
 CustomBackend::Context::LibraryErrorString(const int err)
 {
@@ -790,4 +952,47 @@ CustomGetOutputV2(
       memory_type, memory_type_id);
 }
 
+bool
+CustomPutOutputV2(
+    void* output_context, const char* name, size_t shape_dim_cnt,
+    int64_t* shape_dims, uint64_t content_byte_size, void* content,
+    CustomMemoryType memory_type, int64_t memory_type_id,
+    CustomOutputReleaseFn_t release_fn, void* release_userp)
+{
+  CustomBackend::Context::GetInputOutputContext* ocontext =
+      static_cast<CustomBackend::Context::GetInputOutputContext*>(
+          output_context);
+  return ocontext->context_->PutOutput(
+      ocontext, name, shape_dim_cnt, shape_dims, content_byte_size, content,
+      memory_type, memory_type_id, release_fn, release_userp);
+}
+
+bool
+CustomPinnedAlloc(
+    void* pinned_memory_context, uint64_t byte_size, void** buffer)
+{
+  TRTSERVER_Memory_Type allocated_type;
+  Status status = PinnedMemoryManager::Alloc(
+      buffer, byte_size, &allocated_type, false /* allow_nonpinned_fallback */);
+  if (!status.IsOk()) {
+    LOG_VERBOSE(1) << status.AsString();
+    *buffer = nullptr;
+    return false;
+  }
+
+  return true;
+}
+
+bool
+CustomPinnedFree(void* pinned_memory_context, void* buffer)
+{
+  Status status = PinnedMemoryManager::Free(buffer);
+  if (!status.IsOk()) {
+    LOG_VERBOSE(1) << status.AsString();
+    return false;
+  }
+
+  return true;
+}
+
 }}  // namespace nvidia::inferenceserver
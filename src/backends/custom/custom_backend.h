@@ -70,6 +70,9 @@ class CustomBackend : public InferenceBackend {
   friend bool CustomGetOutputV2(
       void*, const char*, size_t, int64_t*, uint64_t, void**, CustomMemoryType*,
       int64_t*);
+  friend bool CustomPutOutputV2(
+      void*, const char*, size_t, int64_t*, uint64_t, void*, CustomMemoryType,
+      int64_t, CustomOutputReleaseFn_t, void*);
 
   // For each model instance there is a context.
   struct Context : BackendContext {
@@ -105,11 +108,22 @@ class CustomBackend : public InferenceBackend {
       std::unordered_map<const InferenceRequest::Input*, size_t>
           input_data_idx_;
 
+      // The batch-input targets that have already been returned for
+      // this payload, so that a second request for the same target
+      // reports end-of-input.
+      std::set<std::string> returned_batch_inputs_;
+
       // Variable for being compatible with V1 interface in the case
       // of GPU I/O
       std::vector<std::unique_ptr<char[]>> input_buffers_;
       std::vector<std::tuple<void*, std::unique_ptr<char[]>, uint64_t>>
           output_buffers_;
+
+      // Release callbacks for output buffers donated by the backend
+      // via the V3 interface. The donated buffers may be the source
+      // of asynchronous copies so they are released only after the
+      // execution completes.
+      std::vector<std::pair<CustomOutputReleaseFn_t, void*>> donated_buffers_;
     };
 
     // Callback used by custom backends to get the next block of input
@@ -126,6 +140,14 @@ class CustomBackend : public InferenceBackend {
         const void** content, uint64_t* content_byte_size,
         CustomMemoryType* memory_type, int64_t* memory_type_id);
 
+    // Return the server-generated value of the batch input 'name' for
+    // the payload associated with 'input_context'.
+    bool GetBatchInput(
+        GetInputOutputContext* input_context,
+        const ModelBatchInput& batch_input, const std::string& name,
+        const void** content, uint64_t* content_byte_size,
+        CustomMemoryType* memory_type, int64_t* memory_type_id);
+
     // Callback used by custom backends to get the output buffer for a
     // 'name'd output tensor. This function will enforce that
     // the 'content' will be in CPU memory.
@@ -141,6 +163,16 @@ class CustomBackend : public InferenceBackend {
         size_t shape_dim_cnt, int64_t* shape_dims, uint64_t content_byte_size,
         void** content, CustomMemoryType* memory_type, int64_t* memory_type_id);
 
+    // Callback used by custom backends to donate a backend-owned
+    // buffer as the value of a 'name'd output tensor. On success the
+    // buffer is held until the execution completes and then released
+    // with 'release_fn'.
+    bool PutOutput(
+        GetInputOutputContext* output_context, const char* name,
+        size_t shape_dim_cnt, int64_t* shape_dims, uint64_t content_byte_size,
+        void* content, CustomMemoryType memory_type, int64_t memory_type_id,
+        CustomOutputReleaseFn_t release_fn, void* release_userp);
+
     // The handle to the shared library associated with this context.
     void* library_handle_;
 
@@ -154,6 +186,7 @@ class CustomBackend : public InferenceBackend {
     CustomErrorStringFn_t ErrorStringFn_;
     CustomExecuteFn_t ExecuteFn_;
     CustomExecuteV2Fn_t ExecuteV2Fn_;
+    CustomExecuteV3Fn_t ExecuteV3Fn_;
 
     // The version of the custom interface.
     int custom_version_;
@@ -165,6 +198,12 @@ class CustomBackend : public InferenceBackend {
     std::unordered_map<std::string, std::unique_ptr<std::vector<int64_t>>>
         fixed_input_shapes_;
 
+    // The batch inputs specified in the model configuration. The
+    // values for these inputs are generated by the server, most
+    // commonly to communicate the per-request shape of an input
+    // packed into a ragged batch.
+    std::vector<ModelBatchInput> batch_inputs_;
+
     // The current device from last model execution. Use to ensure invariant
     // from custom backend's point of view.
     int current_execute_device_;
@@ -209,4 +248,23 @@ bool CustomGetOutputV2(
     int64_t* shape_dims, uint64_t content_byte_size, void** content,
     CustomMemoryType* memory_type, int64_t* memory_type_id);
 
+// Callback used by custom backends to donate a backend-owned buffer
+// holding the complete value of an output tensor. On success the
+// server references the buffer until the execution completes and then
+// invokes 'release_fn' with 'release_userp'.
+bool CustomPutOutputV2(
+    void* output_context, const char* name, size_t shape_dim_cnt,
+    int64_t* shape_dims, uint64_t content_byte_size, void* content,
+    CustomMemoryType memory_type, int64_t memory_type_id,
+    CustomOutputReleaseFn_t release_fn, void* release_userp);
+
+// Callback used by custom backends to allocate a staging buffer from
+// the server's pinned-memory pool.
+bool CustomPinnedAlloc(
+    void* pinned_memory_context, uint64_t byte_size, void** buffer);
+
+// Callback used by custom backends to release a buffer obtained from
+// CustomPinnedAlloc back to the server's pinned-memory pool.
+bool CustomPinnedFree(void* pinned_memory_context, void* buffer);
+
 }}  // namespace nvidia::inferenceserver
@@ -44,6 +44,8 @@ namespace nvidia { namespace inferenceserver {
 /// library if the custom interface version is 1 or not set.
 /// \param ExecuteV2Fn Returns the execute function from the custom
 /// library if the custom interface version is 2.
+/// \param ExecuteV3Fn Returns the execute function from the custom
+/// library if the custom interface version is 3.
 /// \param custom_version Returns the custom interface version from
 /// the custom library.
 /// \return Error status.
@@ -51,7 +53,8 @@ Status LoadCustom(
     const std::string& path, void** dlhandle,
     CustomInitializeFn_t* InitializeFn, CustomFinalizeFn_t* FinalizeFn,
     CustomErrorStringFn_t* ErrorStringFn, CustomExecuteFn_t* ExecuteFn,
-    CustomExecuteV2Fn_t* ExecuteV2Fn, int* custom_version);
+    CustomExecuteV2Fn_t* ExecuteV2Fn, CustomExecuteV3Fn_t* ExecuteV3Fn,
+    int* custom_version);
 
 /// Unload custom shared library.
 ///
@@ -102,6 +102,15 @@ Status
 OnnxLoader::LoadSession(
     const std::pair<bool, std::string>& model_data,
     const OrtSessionOptions* session_options, OrtSession** session)
+{
+  return LoadSession(model_data, session_options, "" /* share_key */, session);
+}
+
+Status
+OnnxLoader::LoadSession(
+    const std::pair<bool, std::string>& model_data,
+    const OrtSessionOptions* session_options, const std::string& share_key,
+    OrtSession** session)
 {
   if (loader != nullptr) {
     {
@@ -111,6 +120,20 @@ OnnxLoader::LoadSession(
       } else {
         loader->live_session_cnt_++;
       }
+
+      // If a live session was created with the same share key then
+      // reference it instead of loading a duplicate copy of the
+      // model.
+      if (!share_key.empty()) {
+        auto itr = loader->shared_sessions_.find(share_key);
+        if (itr != loader->shared_sessions_.end()) {
+          itr->second.second++;
+          *session = itr->second.first;
+          LOG_VERBOSE(1) << "reusing session '" << share_key << "', "
+                         << itr->second.second << " references";
+          return Status::Success;
+        }
+      }
     }
 
     OrtStatus* status = nullptr;
@@ -129,6 +152,22 @@ OnnxLoader::LoadSession(
       TryRelease(true);
     }
     RETURN_IF_ORT_ERROR(status);
+
+    if (!share_key.empty()) {
+      std::lock_guard<std::mutex> lk(loader->mu_);
+      auto itr = loader->shared_sessions_.find(share_key);
+      if (itr != loader->shared_sessions_.end()) {
+        // A concurrent load with the same key won the race, use its
+        // session instead of the one just created.
+        ort_api->ReleaseSession(*session);
+        itr->second.second++;
+        *session = itr->second.first;
+      } else {
+        loader->shared_sessions_.emplace(
+            share_key, std::make_pair(*session, (size_t)1));
+        loader->session_keys_.emplace(*session, share_key);
+      }
+    }
   } else {
     return Status(
         Status::Code::UNAVAILABLE,
@@ -141,7 +180,23 @@ Status
 OnnxLoader::UnloadSession(OrtSession* session)
 {
   if (loader != nullptr) {
-    ort_api->ReleaseSession(session);
+    bool release = true;
+    {
+      std::lock_guard<std::mutex> lk(loader->mu_);
+      auto key_itr = loader->session_keys_.find(session);
+      if (key_itr != loader->session_keys_.end()) {
+        auto& entry = loader->shared_sessions_[key_itr->second];
+        if (--entry.second > 0) {
+          release = false;
+        } else {
+          loader->shared_sessions_.erase(key_itr->second);
+          loader->session_keys_.erase(key_itr);
+        }
+      }
+    }
+    if (release) {
+      ort_api->ReleaseSession(session);
+    }
     TryRelease(true);
   } else {
     return Status(
@@ -27,6 +27,9 @@
 
 #include <onnxruntime_c_api.h>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -56,6 +59,26 @@ class OnnxLoader {
       const std::pair<bool, std::string>& model_data,
       const OrtSessionOptions* session_options, OrtSession** session);
 
+  /// Load a Onnx model from a path and return the corresponding
+  /// OrtSession, sharing one session between all loads that use the
+  /// same share key. A shared session holds a single copy of the
+  /// model weights no matter how many loads reference it, and is
+  /// released when the last reference is unloaded. The caller must
+  /// ensure that the key captures everything that shapes the session,
+  /// in particular the model content and the session options.
+  ///
+  /// \param model_data The Onnx model or path to the directory
+  /// holding the onnx model
+  /// \param session_options The options to use when creating the session
+  /// \param share_key The key identifying the sessions that can be
+  /// shared. If empty the session is not shared.
+  /// \param session Returns the Onnx model session
+  /// \return Error status.
+  static Status LoadSession(
+      const std::pair<bool, std::string>& model_data,
+      const OrtSessionOptions* session_options, const std::string& share_key,
+      OrtSession** session);
+
   /// Unload a Onnx model session
   ///
   /// \param session The Onnx model session to be unloaded
@@ -77,6 +100,13 @@ class OnnxLoader {
   std::mutex mu_;
   size_t live_session_cnt_;
   bool closing_;
+
+  // The live shared sessions and their reference counts, by share
+  // key, with the reverse mapping used to find the key when a session
+  // is unloaded.
+  std::unordered_map<std::string, std::pair<OrtSession*, size_t>>
+      shared_sessions_;
+  std::unordered_map<OrtSession*, std::string> session_keys_;
 };
 
 }}  // namespace nvidia::inferenceserver
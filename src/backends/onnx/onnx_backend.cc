@@ -27,14 +27,18 @@
 #include "src/backends/onnx/onnx_backend.h"
 
 #include <stdint.h>
+#include <string.h>
 #include <mutex>
 #include "src/backends/onnx/loader.h"
 #include "src/backends/onnx/onnx_utils.h"
 #include "src/core/constants.h"
 #include "src/core/cuda_utils.h"
+#include "src/core/filesystem.h"
 #include "src/core/logging.h"
+#include "src/core/model_artifact_cache.h"
 #include "src/core/model_config_cuda.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/nvtx.h"
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
 
@@ -59,7 +63,7 @@ OnnxBackend::Context::Context(
     : BackendContext(
           name, gpu_device, max_batch_size, enable_pinned_input,
           enable_pinned_output),
-      session_(nullptr), allocator_(nullptr)
+      session_(nullptr), allocator_(nullptr), input_copy_stream_(nullptr)
 {
 }
 
@@ -67,6 +71,21 @@ OnnxBackend::Context::~Context()
 {
   LOG_VERBOSE(1) << "~OnnxBackend::Context ";
 
+  if (compute_thread_.joinable()) {
+    compute_queue_.Put(nullptr);
+    compute_thread_.join();
+  }
+
+#ifdef TRTIS_ENABLE_GPU
+  if (input_copy_stream_ != nullptr) {
+    cudaError_t err = cudaStreamDestroy(input_copy_stream_);
+    if (err != cudaSuccess) {
+      LOG_ERROR << "Failed to destroy cuda stream: " << cudaGetErrorString(err);
+    }
+    input_copy_stream_ = nullptr;
+  }
+#endif  // TRTIS_ENABLE_GPU
+
   ReleaseOrtRunResources();
   if (session_ != nullptr) {
     OnnxLoader::UnloadSession(session_);
@@ -122,8 +141,11 @@ OnnxBackend::CreateExecutionContextsHelper(
       if (group.kind() == ModelInstanceGroup::KIND_CPU) {
         const std::string instance_name =
             group.name() + "_" + std::to_string(c) + "_cpu";
+        const std::vector<int32_t> cpus(
+            group.cpus().begin(), group.cpus().end());
         RETURN_IF_ERROR(CreateExecutionContext(
-            instance_name, Context::NO_GPU_DEVICE, session_options, models));
+            instance_name, Context::NO_GPU_DEVICE, cpus, session_options,
+            models));
         total_context_cnt++;
       } else {
         for (int gpu_device : group.gpus()) {
@@ -131,7 +153,8 @@ OnnxBackend::CreateExecutionContextsHelper(
                                             std::to_string(c) + "_gpu" +
                                             std::to_string(gpu_device);
           RETURN_IF_ERROR(CreateExecutionContext(
-              instance_name, gpu_device, session_options, models));
+              instance_name, gpu_device, std::vector<int32_t>(),
+              session_options, models));
           total_context_cnt++;
         }
       }
@@ -159,7 +182,7 @@ OnnxBackend::CreateExecutionContextsHelper(
 Status
 OnnxBackend::CreateExecutionContext(
     const std::string& instance_name, const int gpu_device,
-    OrtSessionOptions* base_session_options,
+    const std::vector<int32_t>& cpus, OrtSessionOptions* base_session_options,
     const std::unordered_map<std::string, std::pair<bool, std::string>>& models)
 {
   // For a GPU context, determine the model file to use for device
@@ -215,8 +238,11 @@ OnnxBackend::CreateExecutionContext(
   contexts_.emplace_back(
       new Context(instance_name, gpu_device, mbs, pinned_input, pinned_output));
   Context* context = static_cast<Context*>(contexts_.back().get());
+  context->cpus_ = cpus;
 
   RETURN_IF_ERROR(context->CreateCudaStream());
+  RETURN_IF_ERROR(
+      context->CreateCudaStream(0, &context->input_copy_stream_));
 
   // Set Onnx session option with proper device
   OrtSessionOptions* session_options;
@@ -289,6 +315,59 @@ OnnxBackend::CreateExecutionContext(
     }
   }
 
+  // Byte-identical model content loaded with equivalent options
+  // produces an identical session, so share one session across model
+  // versions (and instances) instead of holding a duplicate copy of
+  // the weights. This makes holding two versions of a model live
+  // during a rollout cost one set of weights when the version bump
+  // did not change the content. The key covers everything that shapes
+  // the session: the model content, the ONNX Runtime version, the
+  // device and compute capability, and the optimization settings.
+  auto model = op_itr->second;
+  std::string session_key;
+  if (model.first) {
+    session_key =
+        "onnx_session_" + std::to_string(ORT_API_VERSION) +
+        (cc.empty() ? "" : ("_cc" + cc)) + "_dev" +
+        std::to_string(gpu_device) + "_" +
+        std::to_string(ModelArtifactCache::Hash(model.second)) + "_" +
+        std::to_string(ModelArtifactCache::Hash(
+            Config().optimization().SerializeAsString()));
+  }
+
+  // If the persistent artifact cache is enabled, reuse the optimized
+  // graph saved by a previous server run for this exact model
+  // content, ONNX Runtime version and compute capability. On a cache
+  // miss have ONNX Runtime write the optimized graph into the cache
+  // so the next restart can skip optimization.
+  if (ModelArtifactCache::Enabled() && model.first) {
+    const std::string key =
+        "onnx_" + std::to_string(ORT_API_VERSION) +
+        (cc.empty() ? "" : ("_cc" + cc)) + "_" +
+        std::to_string(ModelArtifactCache::Hash(model.second));
+    std::string entry_dir;
+    Status cache_status = ModelArtifactCache::EntryDir(key, &entry_dir);
+    if (cache_status.IsOk()) {
+      const auto cached_path = JoinPath({entry_dir, kOnnxRuntimeOnnxFilename});
+      bool exists = false;
+      cache_status = FileExists(cached_path, &exists);
+      if (cache_status.IsOk()) {
+        if (exists) {
+          LOG_INFO << instance_name
+                   << ": loading optimized model from artifact cache";
+          model = std::make_pair(false, entry_dir);
+        } else {
+          RETURN_IF_ORT_ERROR(ort_api->SetOptimizedModelFilePath(
+              session_options, cached_path.c_str()));
+        }
+      }
+    }
+    if (!cache_status.IsOk()) {
+      LOG_WARNING << "artifact cache unavailable for " << instance_name << ": "
+                  << cache_status.Message();
+    }
+  }
+
   // ONNX session creation with OpenVINO is not thread-safe,
   // so multiple creations are serialized with a global lock.
   static std::mutex global_context_mu;
@@ -297,11 +376,49 @@ OnnxBackend::CreateExecutionContext(
     glock.lock();
   }
 
+  // Each session creates its own private GPU arena in the CUDA
+  // execution provider; this ONNX Runtime version has no way to
+  // register one shared per-device allocator, so the arenas of the
+  // loaded models compete for device memory with each other and with
+  // the CUDA memory pool. Track the free device memory around session
+  // creation so that an over-committed device shows up in the log
+  // before it turns into an allocation failure at inference time.
+#ifdef TRTIS_ENABLE_GPU
+  size_t free_before = 0;
+  if (gpu_device != Context::NO_GPU_DEVICE) {
+    size_t free_mem, total_mem;
+    if ((cudaSetDevice(gpu_device) == cudaSuccess) &&
+        (cudaMemGetInfo(&free_mem, &total_mem) == cudaSuccess)) {
+      free_before = free_mem;
+    }
+  }
+#endif  // TRTIS_ENABLE_GPU
+
   RETURN_IF_ERROR(OnnxLoader::LoadSession(
-      op_itr->second, session_options, &context->session_));
+      model, session_options, session_key, &context->session_));
   RETURN_IF_ORT_ERROR(
       ort_api->GetAllocatorWithDefaultOptions(&context->allocator_));
 
+#ifdef TRTIS_ENABLE_GPU
+  if ((gpu_device != Context::NO_GPU_DEVICE) && (free_before != 0)) {
+    size_t free_mem, total_mem;
+    if (cudaMemGetInfo(&free_mem, &total_mem) == cudaSuccess) {
+      if (free_mem < free_before) {
+        LOG_VERBOSE(1) << instance_name << ": session holds "
+                       << ((free_before - free_mem) >> 20)
+                       << " MB of device memory, " << (free_mem >> 20)
+                       << " MB free of " << (total_mem >> 20) << " MB";
+      }
+      if (free_mem < (total_mem / 20)) {
+        LOG_WARNING << "device " << gpu_device << " has only "
+                    << (free_mem >> 20) << " MB of " << (total_mem >> 20)
+                    << " MB free after creating " << instance_name
+                    << ", further model loads or arena growth may fail";
+      }
+    }
+  }
+#endif  // TRTIS_ENABLE_GPU
+
   size_t expected_input_cnt = (size_t)Config().input().size();
 
   // If this is a sequence model then make sure that the required
@@ -343,6 +460,14 @@ OnnxBackend::CreateExecutionContext(
       Config().name(), Config().input(), expected_input_cnt));
   RETURN_IF_ERROR(context->ValidateOutputs(Config().name(), Config().output()));
 
+  // Start the compute thread for the context. Two staging slots allow
+  // the runner thread to stage the next batch from the pinned pool
+  // while the compute thread executes the current one.
+  context->slot_queue_.Put(0);
+  context->slot_queue_.Put(1);
+  context->compute_thread_ =
+      std::thread([context]() { context->ComputeThread(); });
+
   return Status::Success;
 }
 
@@ -547,12 +672,137 @@ OnnxBackend::Context::ValidateOutputs(
   return Status::Success;
 }
 
+void
+OnnxBackend::Run(
+    uint32_t runner_idx, std::vector<Scheduler::Payload>* payloads,
+    std::function<void(Status)> OnCompleteQueuedPayloads)
+{
+  // Each runner executes using the corresponding context...
+  if (runner_idx >= contexts_.size()) {
+    OnCompleteQueuedPayloads(Status(
+        Status::Code::INTERNAL,
+        "unexpected runner index" + std::to_string(runner_idx) +
+            ", max allowed " + std::to_string(contexts_.size())));
+    return;
+  }
+  if (contexts_[runner_idx] == nullptr) {
+    OnCompleteQueuedPayloads(Status(
+        Status::Code::INTERNAL, "runner index " + std::to_string(runner_idx) +
+                                    " has no execution context"));
+    return;
+  }
+
+#ifdef TRTIS_ENABLE_STATS
+  // Stop queue timer and start compute timer when the payload is
+  // scheduled to run
+  for (auto& payload : *payloads) {
+    if (payload.stats_ != nullptr) {
+      payload.stats_->CaptureTimestamp(
+          ModelInferStats::TimestampKind::kComputeStart);
+      payload.stats_->SetGPUDevice(contexts_[runner_idx]->gpu_device_);
+    }
+  }
+#endif  // TRTIS_ENABLE_STATS
+
+  // Stage the batch on this thread and hand it to the context's
+  // compute thread. The completion callback is invoked from the
+  // compute thread, so this function can return and the scheduler can
+  // form and stage the next batch while this one executes.
+  static_cast<Context*>(contexts_[runner_idx].get())
+      ->BeginRun(this, payloads, std::move(OnCompleteQueuedPayloads));
+}
+
 Status
 OnnxBackend::Context::Run(
     const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads)
 {
+  // Synchronous path, used by warmup. The scheduler-driven path goes
+  // through BeginRun() / ComputeThread() instead so that staging the
+  // next batch overlaps the current execution.
+  PipelinedBatch batch;
+  batch.base_ = base;
+  batch.payloads_ = payloads;
+
+  RETURN_IF_ERROR(StageBatch(&batch));
+
+  // If there are no valid payloads then no need to run the
+  // inference. The payloads will have their error status set so can
+  // just return.
+  if (batch.total_batch_size_ == 0) {
+    return Status::Success;
+  }
+
+  return ExecuteBatch(&batch);
+}
+
+void
+OnnxBackend::Context::BeginRun(
+    const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads,
+    std::function<void(Status)> OnComplete)
+{
+  // Take a staging slot, blocking if too many batches are already in
+  // flight. The slot is returned when the batch completes.
+  slot_queue_.Get();
+
+  std::unique_ptr<PipelinedBatch> batch(new PipelinedBatch());
+  batch->base_ = base;
+  batch->payloads_ = payloads;
+  batch->OnComplete_ = std::move(OnComplete);
+
+  Status status = StageBatch(batch.get());
+  if (!status.IsOk() || (batch->total_batch_size_ == 0)) {
+    slot_queue_.Put(0);
+    batch->OnComplete_(status);
+    return;
+  }
+
+  compute_queue_.Put(batch.release());
+}
+
+void
+OnnxBackend::Context::ComputeThread()
+{
+  // The runner thread is bound to the instance group's cpuset by the
+  // scheduler initialization; the compute thread executes the session
+  // for the same instance so apply the same cpuset here.
+  Status affinity_status = SetCpuAffinity(cpus_);
+  if (!affinity_status.IsOk()) {
+    LOG_ERROR << "failed to set cpu affinity for " << name_ << ": "
+              << affinity_status.Message();
+  }
+
+  while (true) {
+    std::unique_ptr<PipelinedBatch> batch(compute_queue_.Get());
+    if (batch == nullptr) {
+      break;
+    }
+
+    Status status = ExecuteBatch(batch.get());
+
+#ifdef TRTIS_ENABLE_STATS
+    // Stop compute timers.
+    for (auto& payload : *(batch->payloads_)) {
+      if (payload.stats_ != nullptr) {
+        payload.stats_->CaptureTimestamp(
+            ModelInferStats::TimestampKind::kComputeEnd);
+      }
+    }
+#endif  // TRTIS_ENABLE_STATS
+
+    batch->OnComplete_(status);
+    batch.reset();
+    slot_queue_.Put(0);
+  }
+}
+
+Status
+OnnxBackend::Context::StageBatch(PipelinedBatch* batch)
+{
+  std::vector<Scheduler::Payload>* payloads = batch->payloads_;
+
   LOG_VERBOSE(1) << "Running " << name_ << " with " << payloads->size()
                  << " request payloads";
+  NVTX_RANGE(nvtx_, "StageBatch " + name_);
 
   const InferenceRequest* repr_input_request = nullptr;
 
@@ -577,8 +827,9 @@ OnnxBackend::Context::Run(
   }
 
   // If there are no valid payloads then no need to run the
-  // inference. The payloads will have their error status set so can
-  // just return.
+  // inference. The payloads will have their error status set so the
+  // caller can just complete them.
+  batch->total_batch_size_ = total_batch_size;
   if (total_batch_size == 0) {
     return Status::Success;
   }
@@ -592,7 +843,9 @@ OnnxBackend::Context::Run(
             name_ + "', max allowed is " + std::to_string(max_batch_size_));
   }
 
-  // use Scoped wrapper to clean up Ort tensors when Run() returns
+  // Use scoped wrapper to clean up the Ort tensors if staging
+  // fails. On success the tensors have been moved into 'batch' and
+  // the member vectors are empty.
   static auto io_tensor_deleter = [](Context* ctx) {
     if (ctx != nullptr) {
       ctx->ReleaseOrtRunResources();
@@ -600,11 +853,7 @@ OnnxBackend::Context::Run(
   };
   OrtResourceWrapper<Context*> io_tensor_wrapper(this, io_tensor_deleter);
 
-  // Hold reference to each buffer of input data so that it stays
-  // until the inference has completed.
-  std::vector<std::unique_ptr<AllocatedMemory>> input_buffers;
   std::vector<InputInfo> inputs;
-  std::vector<const char*> input_names;
   bool cuda_copy = false;
 
   for (const auto& pr : repr_input_request->ImmutableInputs()) {
@@ -613,23 +862,28 @@ OnnxBackend::Context::Run(
 
     // Create a tensor for each input sized correctly for the total
     // payload batch size. Concatenate input values from each payload
-    // into the corresponding tensor.
+    // into the corresponding tensor. The buffers are held by 'batch'
+    // until the inference has completed.
     RETURN_IF_ERROR(SetInputTensor(
         name, input->DType(), input->Shape(), total_batch_size, payloads,
-        &input_buffers, &inputs, &input_names, &cuda_copy));
+        &batch->input_buffers_, &inputs, &batch->input_names_, &cuda_copy));
   }
 
-  // Request to retrieve all output specified in model config
-  // and reserve placeholder for output tensors
-  std::vector<const char*> output_names;
-  for (const auto& output : base->Config().output()) {
-    output_names.emplace_back(output.name().c_str());
-    output_tensors_.emplace_back(nullptr);
-  }
+  // Request to retrieve all output specified in model config and
+  // reserve placeholder for output tensors. Outputs with a known
+  // fixed size are pre-allocated over pinned buffers, kept alive in
+  // 'batch' until the results have been read.
+  RETURN_IF_ERROR(SetOutputTensors(
+      batch->base_, total_batch_size, &batch->output_names_,
+      &batch->output_buffers_));
 
 #ifdef TRTIS_ENABLE_GPU
+  // The staging copies are issued on 'input_copy_stream_' so that
+  // they overlap the execution and output copies of the previous
+  // batch, and must have completed before the batch is handed to the
+  // compute thread.
   if (cuda_copy) {
-    cudaStreamSynchronize(stream_);
+    cudaStreamSynchronize(input_copy_stream_);
   }
   cuda_copy = false;
   for (auto& input : inputs) {
@@ -645,19 +899,19 @@ OnnxBackend::Context::Run(
       auto status = CopyBuffer(
           "indirect buffer", buffer_memory_type, buffer_memory_id,
           input.memory_type_, input.memory_type_id_, buffer_byte_size, buffer,
-          input.input_buffer_ + std::get<1>(indirect_buffer), stream_,
-          &cuda_used);
+          input.input_buffer_ + std::get<1>(indirect_buffer),
+          input_copy_stream_, &cuda_used);
       if (!status.IsOk()) {
         for (const auto& payload_idx : std::get<2>(indirect_buffer)) {
           (*payloads)[payload_idx].status_ = status;
         }
       } else {
-        cuda_copy |= cuda_copy;
+        cuda_copy |= cuda_used;
       }
     }
   }
   if (cuda_copy) {
-    cudaStreamSynchronize(stream_);
+    cudaStreamSynchronize(input_copy_stream_);
   }
 #endif  // TRTIS_ENABLE_GPU
 
@@ -670,14 +924,47 @@ OnnxBackend::Context::Run(
   }
 #endif  // TRTIS_ENABLE_STATS
 
+  batch->input_tensors_.swap(input_tensors_);
+  batch->output_tensors_.swap(output_tensors_);
+
+  return Status::Success;
+}
+
+Status
+OnnxBackend::Context::ExecuteBatch(PipelinedBatch* batch)
+{
+  NVTX_RANGE(nvtx_, "ExecuteBatch " + name_);
+
+  // Use scoped wrapper to clean up the Ort tensors held by the batch
+  // when ExecuteBatch() returns.
+  static auto batch_tensor_deleter = [](PipelinedBatch* b) {
+    if (b != nullptr) {
+      for (auto& tensor : b->input_tensors_) {
+        if (tensor != nullptr) {
+          ort_api->ReleaseValue(tensor);
+        }
+      }
+      b->input_tensors_.clear();
+      for (auto& tensor : b->output_tensors_) {
+        if (tensor != nullptr) {
+          ort_api->ReleaseValue(tensor);
+        }
+      }
+      b->output_tensors_.clear();
+    }
+  };
+  OrtResourceWrapper<PipelinedBatch*> batch_tensor_wrapper(
+      batch, batch_tensor_deleter);
+
   // Run...
   RETURN_IF_ORT_ERROR(ort_api->Run(
-      session_, NULL /* run options */, input_names.data(),
-      (const OrtValue* const*)input_tensors_.data(), input_tensors_.size(),
-      output_names.data(), output_names.size(), output_tensors_.data()));
+      session_, NULL /* run options */, batch->input_names_.data(),
+      (const OrtValue* const*)batch->input_tensors_.data(),
+      batch->input_tensors_.size(), batch->output_names_.data(),
+      batch->output_names_.size(), batch->output_tensors_.data()));
 
 #ifdef TRTIS_ENABLE_STATS
-  for (auto& payload : *payloads) {
+  for (auto& payload : *(batch->payloads_)) {
     if (payload.stats_ != nullptr) {
       payload.stats_->CaptureTimestamp(
           ModelInferStats::TimestampKind::kComputeOutputStart);
@@ -687,7 +974,67 @@ OnnxBackend::Context::Run(
 
   // Make sure each output is of the expected size and copy it into
   // the payload responses.
-  return ReadOutputTensors(base, total_batch_size, output_names, payloads);
+  return ReadOutputTensors(
+      batch->base_, batch->total_batch_size_, batch->output_names_,
+      batch->output_buffers_, batch->output_tensors_, batch->payloads_);
+}
+
+Status
+OnnxBackend::Context::SetOutputTensors(
+    const InferenceBackend* base, const size_t total_batch_size,
+    std::vector<const char*>* output_names,
+    std::vector<std::unique_ptr<AllocatedMemory>>* output_buffers)
+{
+  const OrtMemoryInfo* allocator_info;
+  RETURN_IF_ORT_ERROR(ort_api->AllocatorGetInfo(allocator_, &allocator_info));
+
+  for (const auto& output : base->Config().output()) {
+    output_names->emplace_back(output.name().c_str());
+    output_tensors_.emplace_back(nullptr);
+    output_buffers->emplace_back(nullptr);
+
+    if (output.data_type() == TYPE_STRING) {
+      continue;
+    }
+
+    // The model-reported shape has already been validated against the
+    // config at load time, so the config shape (taking any reshape
+    // into account) is the shape the session will produce. If it
+    // contains a wildcard the size isn't known until after the run
+    // and ONNX Runtime must allocate the output itself.
+    const DimsList& dims =
+        (output.has_reshape()) ? output.reshape().shape() : output.dims();
+
+    std::vector<int64_t> output_dims;
+    if (max_batch_size_ != NO_BATCHING) {
+      output_dims.push_back(total_batch_size);
+    }
+    bool has_wildcard = false;
+    for (const auto dim : dims) {
+      has_wildcard |= (dim == WILDCARD_DIM);
+      output_dims.push_back(dim);
+    }
+    if (has_wildcard) {
+      continue;
+    }
+
+    const size_t byte_size =
+        GetElementCount(output_dims) *
+        GetDataTypeByteSize(output.data_type());
+    output_buffers->back().reset(
+        new AllocatedMemory(byte_size, TRTSERVER_MEMORY_CPU_PINNED, 0));
+    TRTSERVER_Memory_Type memory_type;
+    int64_t memory_type_id;
+    char* buffer =
+        output_buffers->back()->MutableBuffer(&memory_type, &memory_type_id);
+
+    RETURN_IF_ORT_ERROR(ort_api->CreateTensorWithDataAsOrtValue(
+        allocator_info, (void*)buffer, byte_size, output_dims.data(),
+        output_dims.size(), ConvertToOnnxDataType(output.data_type()),
+        &output_tensors_.back()));
+  }
+
+  return Status::Success;
 }
 
 Status
@@ -752,8 +1099,8 @@ OnnxBackend::Context::SetInputTensor(
 
   // Note that 'cuda_used' will be updated only
   // for non-string data type. For string, the data must be ready to proceed.
-  auto tmp_cuda_used =
-      SetInputBuffer(name, expected_byte_sizes, payloads, &input);
+  auto tmp_cuda_used = SetInputBuffer(
+      name, expected_byte_sizes, payloads, input_copy_stream_, &input);
 
   if (data_type != TYPE_STRING) {
     const OrtMemoryInfo* allocator_info;
@@ -766,7 +1113,7 @@ OnnxBackend::Context::SetInputTensor(
   } else {
 #ifdef TRTIS_ENABLE_GPU
     if (tmp_cuda_used) {
-      cudaStreamSynchronize(stream_);
+      cudaStreamSynchronize(input_copy_stream_);
     }
 #endif  // TRTIS_ENABLE_GPU
 
@@ -805,41 +1152,22 @@ OnnxBackend::Context::SetStringInputBuffer(
 
     size_t element_cnt = 0;
     if (payload.status_.IsOk()) {
-      size_t remaining_bytes = expected_byte_size;
       char* data_content = input_buffer + buffer_copy_offset;
-      // Continue if the remaining bytes may still contain size info
-      while (remaining_bytes >= sizeof(uint32_t)) {
-        if (element_cnt >= expected_element_cnt) {
-          payload.status_ = Status(
-              Status::Code::INVALID_ARG,
-              "unexpected number of string elements " +
-                  std::to_string(element_cnt + 1) + " for inference input '" +
-                  name + "', expecting " +
-                  std::to_string(expected_element_cnt));
-          break;
-        }
 
-        const uint32_t len = *(reinterpret_cast<const uint32_t*>(data_content));
-        remaining_bytes -= sizeof(uint32_t);
-        // Make first byte of size info 0, so that if there is string data
-        // in front of it, the data becomes valid C string.
-        *data_content = 0;
-        data_content = data_content + sizeof(uint32_t);
-        if (len > remaining_bytes) {
-          payload.status_ = Status(
-              Status::Code::INVALID_ARG,
-              "incomplete string data for inference input '" + name +
-                  "', expecting string of length " + std::to_string(len) +
-                  " but only " + std::to_string(remaining_bytes) +
-                  " bytes available");
-          break;
-        } else {
-          string_data->push_back(data_content);
-          element_cnt++;
-          data_content = data_content + len;
-          remaining_bytes -= len;
-        }
+      // Compute the offsets of all elements in a single pass, then
+      // terminate and publish the strings in bulk. Zeroing the first
+      // byte of each length prefix makes the string in front of it a
+      // valid C string.
+      std::vector<StringTensorElement> elements;
+      payload.status_ = ParseSerializedStringTensor(
+          name, data_content, expected_byte_size, expected_element_cnt,
+          &elements);
+
+      for (const auto& element : elements) {
+        *(const_cast<char*>(element.first) - sizeof(uint32_t)) = 0;
+        string_data->push_back(element.first);
       }
+      element_cnt = elements.size();
     }
 
     FillStringData(string_data, expected_element_cnt - element_cnt);
@@ -860,8 +1188,10 @@ OnnxBackend::Context::FillStringData(
 
 Status
 OnnxBackend::Context::ReadOutputTensors(
-    const InferenceBackend* base, size_t total_batch_size,
+    const InferenceBackend* base, const size_t total_batch_size,
     const std::vector<const char*>& output_names,
+    const std::vector<std::unique_ptr<AllocatedMemory>>& output_buffers,
+    const std::vector<OrtValue*>& output_tensors,
     std::vector<Scheduler::Payload>* payloads)
 {
   bool cuda_copy = false;
@@ -875,7 +1205,7 @@ OnnxBackend::Context::ReadOutputTensors(
     const ModelOutput* output_config;
     RETURN_IF_ERROR(base->GetOutput(name, &output_config));
 
-    OrtValue* output_tensor = output_tensors_[idx];
+    OrtValue* output_tensor = output_tensors[idx];
     if (output_tensor == nullptr) {
       return Status(
           Status::Code::INTERNAL,
@@ -943,8 +1273,16 @@ OnnxBackend::Context::ReadOutputTensors(
 
       // [TODO] currently ONNX output data are always on CPU
       // https://github.com/microsoft/onnxruntime/issues/1621
-      output.memory_type_ = TRTSERVER_MEMORY_CPU;
-      output.memory_type_id_ = 0;
+      if (output_buffers[idx] != nullptr) {
+        // Output was pre-allocated so report the actual memory type
+        // of the buffer, which allows the response copy to be
+        // asynchronous when the buffer is pinned.
+        output_buffers[idx]->MutableBuffer(
+            &output.memory_type_, &output.memory_type_id_);
+      } else {
+        output.memory_type_ = TRTSERVER_MEMORY_CPU;
+        output.memory_type_id_ = 0;
+      }
       cuda_copy |=
           SetFixedSizeOutputBuffer(name, batch1_byte_size, &output, payloads);
     }
@@ -995,6 +1333,8 @@ OnnxBackend::Context::SetStringOutputBuffer(
 {
   size_t element_idx = 0;
   bool cuda_copy = false;
+  // Reused across payloads to avoid re-allocating the arena.
+  std::vector<char> serialized;
   for (auto& payload : *payloads) {
     const auto& irequest = payload.request_;
     const size_t expected_element_cnt =
@@ -1020,34 +1360,28 @@ OnnxBackend::Context::SetStringOutputBuffer(
           preferred_memory_type, 0 /* preferred_memory_type_id */,
           &actual_memory_type, &actual_memory_type_id);
       if (status.IsOk()) {
-        bool cuda_used = false;
-        size_t copied_byte_size = 0;
+        // Serialize the length-prefixed string representation for
+        // the entire payload into a contiguous arena in one pass so
+        // that a single copy delivers it to the response buffer,
+        // instead of two CopyBuffer calls per element.
+        serialized.resize(expected_byte_size);
+        char* dst = serialized.data();
         for (size_t e = 0; e < expected_element_cnt; ++e) {
           const uint32_t len =
               offsets[element_idx + e + 1] - offsets[element_idx + e];
-          // Prepend size of the string
-          payload.status_ = CopyBuffer(
-              name, TRTSERVER_MEMORY_CPU /* src_memory_type */,
-              0 /* src_memory_type_id */, actual_memory_type,
-              actual_memory_type_id, sizeof(uint32_t),
-              static_cast<const void*>(&len),
-              static_cast<char*>(buffer) + copied_byte_size, stream_,
-              &cuda_used);
-
-          cuda_copy |= cuda_used;
-          copied_byte_size += sizeof(uint32_t);
-
-          // Copy raw string content
-          payload.status_ = CopyBuffer(
-              name, TRTSERVER_MEMORY_CPU /* src_memory_type */,
-              0 /* src_memory_type_id */, actual_memory_type,
-              actual_memory_type_id, len, content + offsets[element_idx + e],
-              static_cast<char*>(buffer) + copied_byte_size, stream_,
-              &cuda_used);
-
-          cuda_copy |= cuda_used;
-          copied_byte_size += len;
+          memcpy(dst, &len, sizeof(uint32_t));
+          dst += sizeof(uint32_t);
+          memcpy(dst, content + offsets[element_idx + e], len);
+          dst += len;
         }
+
+        bool cuda_used = false;
+        payload.status_ = CopyBuffer(
+            name, TRTSERVER_MEMORY_CPU /* src_memory_type */,
+            0 /* src_memory_type_id */, actual_memory_type,
+            actual_memory_type_id, expected_byte_size, serialized.data(),
+            static_cast<char*>(buffer), stream_, &cuda_used);
+        cuda_copy |= cuda_used;
       } else {
         payload.status_ = status;
       }
@@ -27,11 +27,13 @@
 
 #include <onnxruntime_c_api.h>
 #include <memory>
+#include <thread>
 #include "src/core/backend.h"
 #include "src/core/backend_context.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
+#include "src/core/sync_queue.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -50,10 +52,21 @@ class OnnxBackend : public InferenceBackend {
           paths);
   Status CreateExecutionContext(
       const std::string& instance_name, const int gpu_device,
+      const std::vector<int32_t>& cpus,
       OrtSessionOptions* base_session_options,
       const std::unordered_map<std::string, std::pair<bool, std::string>>&
           paths);
 
+  // Run model on the context associated with 'runner_idx' to execute
+  // for one or more requests. The input staging runs on the calling
+  // runner thread and the session run is handed to the context's
+  // compute thread, so the runner can stage the next batch while the
+  // current one executes. 'OnCompleteQueuedPayloads' is called from
+  // the compute thread when the batch completes.
+  void Run(
+      uint32_t runner_idx, std::vector<Scheduler::Payload>* payloads,
+      std::function<void(Status)> OnCompleteQueuedPayloads) override;
+
  private:
   // Helper function for CreateExecutionContexts() so that session_options
   // will be released properly regardless of possible errors
@@ -92,11 +105,55 @@ class OnnxBackend : public InferenceBackend {
         const ModelSequenceBatching::Control::Kind control_kind, bool required,
         bool* have_control);
 
-    // See BackendContext::Run()
+    // State for a batch as it moves through the two pipeline stages:
+    // staged on the runner thread, executed and completed on the
+    // context's compute thread. Owns the input/output buffers and Ort
+    // tensors until the batch completes.
+    struct PipelinedBatch {
+      const InferenceBackend* base_ = nullptr;
+      std::vector<Scheduler::Payload>* payloads_ = nullptr;
+      std::function<void(Status)> OnComplete_;
+      size_t total_batch_size_ = 0;
+      std::vector<std::unique_ptr<AllocatedMemory>> input_buffers_;
+      std::vector<std::unique_ptr<AllocatedMemory>> output_buffers_;
+      std::vector<const char*> input_names_;
+      std::vector<const char*> output_names_;
+      std::vector<OrtValue*> input_tensors_;
+      std::vector<OrtValue*> output_tensors_;
+    };
+
+    // See BackendContext::Run(). Synchronous path that stages and
+    // executes the batch on the calling thread, used by warmup.
     Status Run(
         const InferenceBackend* base,
         std::vector<Scheduler::Payload>* payloads);
 
+    // Stage 'payloads' into a new batch on the calling thread and
+    // queue the batch for execution on the compute thread. Blocks
+    // until a staging slot is available, which bounds the number of
+    // in-flight batches. 'OnComplete' is called when the batch
+    // completes or fails to stage.
+    void BeginRun(
+        const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads,
+        std::function<void(Status)> OnComplete);
+
+    // Stage the inputs and output placeholders of 'batch'. Input
+    // copies are issued on 'input_copy_stream_' so they overlap the
+    // execution of the previous batch, and have completed by the time
+    // this function returns. On success the created Ort tensors are
+    // moved into 'batch'.
+    Status StageBatch(PipelinedBatch* batch);
+
+    // Execute a staged batch and copy the outputs into the payload
+    // responses. The Ort tensors held by 'batch' are released before
+    // returning.
+    Status ExecuteBatch(PipelinedBatch* batch);
+
+    // Loop of 'compute_thread_'. Executes staged batches in FIFO
+    // order and invokes their completion callbacks. Exits when a
+    // nullptr batch is dequeued.
+    void ComputeThread();
+
     // Set an input tensor from one or more payloads.
     Status SetInputTensor(
         const std::string& name, const DataType data_type,
@@ -117,10 +174,26 @@ class OnnxBackend : public InferenceBackend {
     // Helper function to fill 'string_data' with 'cnt' number of empty string
     void FillStringData(std::vector<const char*>* string_data, size_t cnt);
 
-    // Read output tensors into one or more payloads accordingly.
+    // Request all outputs specified in the model config. For
+    // fixed-size outputs whose shape is fully known before the run,
+    // pre-allocate the output tensor over a pinned buffer so that the
+    // session writes the result directly into memory that can be
+    // copied to the response asynchronously. Outputs that can't be
+    // pre-allocated (strings, wildcard dims) get a nullptr
+    // placeholder and are allocated by ONNX Runtime as before. The
+    // pre-allocated buffers are returned in 'output_buffers', indexed
+    // as 'output_names'.
+    Status SetOutputTensors(
+        const InferenceBackend* base, const size_t total_batch_size,
+        std::vector<const char*>* output_names,
+        std::vector<std::unique_ptr<AllocatedMemory>>* output_buffers);
+
+    // Read 'output_tensors' into one or more payloads accordingly.
     Status ReadOutputTensors(
         const InferenceBackend* base, const size_t total_batch_size,
         const std::vector<const char*>& output_names,
+        const std::vector<std::unique_ptr<AllocatedMemory>>& output_buffers,
+        const std::vector<OrtValue*>& output_tensors,
         std::vector<Scheduler::Payload>* payloads);
 
     // Helper function to set output buffer of string data type to payloads.
@@ -138,9 +211,29 @@ class OnnxBackend : public InferenceBackend {
     OrtSession* session_;
     OrtAllocator* allocator_;
 
-    // Onnx Runtime variables that will be reset and used for every run
+    // Onnx Runtime variables that are populated during staging and
+    // then moved into the batch being staged
     std::vector<OrtValue*> input_tensors_;
     std::vector<OrtValue*> output_tensors_;
+
+    // The stream used for input staging copies, so that they overlap
+    // the output copies of the previous batch issued on 'stream_'.
+    cudaStream_t input_copy_stream_;
+
+    // The thread executing staged batches, fed through
+    // 'compute_queue_'. A nullptr batch causes the thread to exit.
+    std::thread compute_thread_;
+    SyncQueue<PipelinedBatch*> compute_queue_;
+
+    // Staging slot tokens. Holding two tokens allows one batch to be
+    // staged from the pinned pool while another executes, without
+    // letting staging run unboundedly ahead.
+    SyncQueue<size_t> slot_queue_;
+
+    // The cpuset configured for the instance group of this context,
+    // applied to 'compute_thread_'. The runner thread is bound by the
+    // scheduler initialization. Empty if no cpuset is configured.
+    std::vector<int32_t> cpus_;
   };
 };
 
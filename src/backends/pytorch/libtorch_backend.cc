@@ -51,18 +51,46 @@ struct LibTorchBackend::Context::InputMetaData {
   std::unique_ptr<AllocatedMemory> input_buffer_;
 };
 
+struct LibTorchBackend::Context::PipelinedBatch {
+  const InferenceBackend* base_ = nullptr;
+  std::vector<Scheduler::Payload>* payloads_ = nullptr;
+  std::function<void(Status)> OnComplete_;
+  size_t total_batch_size_ = 0;
+
+  // The input buffers and tensors, held until the inference has
+  // completed.
+  std::vector<InputMetaData> input_meta_data_;
+  std::vector<torch::jit::IValue> inputs_;
+  std::vector<torch::Tensor> outputs_;
+};
+
 LibTorchBackend::Context::Context(
     const std::string& name, const int gpu_device, const int max_batch_size,
     const bool enable_pinned_input, const bool enable_pinned_output)
     : BackendContext(
           name, gpu_device, max_batch_size, enable_pinned_input,
           enable_pinned_output),
-      device_(torch::Device(torch::kCPU))
+      device_(torch::Device(torch::kCPU)), input_copy_stream_(nullptr)
 {
 }
 
 LibTorchBackend::Context::~Context()
 {
+  if (compute_thread_.joinable()) {
+    compute_queue_.Put(nullptr);
+    compute_thread_.join();
+  }
+
+#ifdef TRTIS_ENABLE_GPU
+  if (input_copy_stream_ != nullptr) {
+    cudaError_t err = cudaStreamDestroy(input_copy_stream_);
+    if (err != cudaSuccess) {
+      LOG_ERROR << "Failed to destroy cuda stream: " << cudaGetErrorString(err);
+    }
+    input_copy_stream_ = nullptr;
+  }
+#endif  // TRTIS_ENABLE_GPU
+
   torch_model_.reset();
 #ifdef TRTIS_ENABLE_GPU
   c10::cuda::CUDACachingAllocator::emptyCache();
@@ -152,16 +180,27 @@ LibTorchBackend::CreateExecutionContexts(
       if (group.kind() == ModelInstanceGroup::KIND_CPU) {
         const std::string instance_name =
             group.name() + "_" + std::to_string(c) + "_cpu";
+        const std::vector<int32_t> cpus(
+            group.cpus().begin(), group.cpus().end());
         RETURN_IF_ERROR(CreateExecutionContext(
-            instance_name, Context::NO_GPU_DEVICE, models));
+            instance_name, Context::NO_GPU_DEVICE, cpus, models));
+        RegisterContextFactory([this, instance_name, cpus, models]() -> Status {
+          return CreateExecutionContext(
+              instance_name, Context::NO_GPU_DEVICE, cpus, models);
+        });
         total_context_cnt++;
       } else {
         for (int gpu_device : group.gpus()) {
           const std::string instance_name = group.name() + "_" +
                                             std::to_string(c) + "_gpu" +
                                             std::to_string(gpu_device);
-          RETURN_IF_ERROR(
-              CreateExecutionContext(instance_name, gpu_device, models));
+          RETURN_IF_ERROR(CreateExecutionContext(
+              instance_name, gpu_device, std::vector<int32_t>(), models));
+          RegisterContextFactory(
+              [this, instance_name, gpu_device, models]() -> Status {
+                return CreateExecutionContext(
+                    instance_name, gpu_device, std::vector<int32_t>(), models);
+              });
           total_context_cnt++;
         }
       }
@@ -189,6 +228,7 @@ LibTorchBackend::CreateExecutionContexts(
 Status
 LibTorchBackend::CreateExecutionContext(
     const std::string& instance_name, const int gpu_device,
+    const std::vector<int32_t>& cpus,
     const std::unordered_map<std::string, std::string>& models)
 {
   // For a GPU context, determine the model file to use for device
@@ -244,8 +284,11 @@ LibTorchBackend::CreateExecutionContext(
   contexts_.emplace_back(
       new Context(instance_name, gpu_device, mbs, pinned_input, pinned_output));
   Context* context = static_cast<Context*>(contexts_.back().get());
+  context->cpus_ = cpus;
 
   RETURN_IF_ERROR(context->CreateCudaStream());
+  RETURN_IF_ERROR(
+      context->CreateCudaStream(0, &context->input_copy_stream_));
 
   if (gpu_device == Context::NO_GPU_DEVICE) {
     context->device_ = torch::Device(torch::kCPU);
@@ -267,6 +310,15 @@ LibTorchBackend::CreateExecutionContext(
 
   RETURN_IF_ERROR(context->ValidateInputs(Config().input()));
   RETURN_IF_ERROR(context->ValidateOutputs(Config().output()));
+
+  // Start the compute thread for the context. Two staging slots allow
+  // the runner thread to stage the next batch while the compute
+  // thread executes the current one.
+  context->slot_queue_.Put(0);
+  context->slot_queue_.Put(1);
+  context->compute_thread_ =
+      std::thread([context]() { context->ComputeThread(); });
+
   return Status::Success;
 }
 
@@ -423,7 +475,12 @@ LibTorchBackend::Context::GetOutputTensor(
     size_t* byte_size, std::vector<int64_t>* content_shape)
 {
   try {
-    torch::Tensor output_flat = (*outputs_)[op_index].contiguous().flatten();
+    // Store the contiguous tensor back so that it stays alive while
+    // 'content' is in use -- contiguous() materializes a copy when
+    // the model output is non-contiguous -- and so that a second read
+    // of the same output doesn't pay for the copy again.
+    (*outputs_)[op_index] = (*outputs_)[op_index].contiguous();
+    const torch::Tensor& output_flat = (*outputs_)[op_index];
 
     // verify output datatype matches datatype from model config
     DataType rec_dtype = ConvertTorchTypeToDataType(output_flat.scalar_type());
@@ -523,15 +580,140 @@ LibTorchBackend::Context::SetFixedSizedInputBuffer(
     expected_byte_sizes.push_back(irequest->BatchSize() * batch1_byte_size);
   }
 
-  *cuda_copy |= SetInputBuffer(name, expected_byte_sizes, payloads, input);
+  *cuda_copy |= SetInputBuffer(
+      name, expected_byte_sizes, payloads, input_copy_stream_, input);
 
   return Status::Success;
 }
 
+void
+LibTorchBackend::Run(
+    uint32_t runner_idx, std::vector<Scheduler::Payload>* payloads,
+    std::function<void(Status)> OnCompleteQueuedPayloads)
+{
+  // Each runner executes using the corresponding context...
+  if (runner_idx >= contexts_.size()) {
+    OnCompleteQueuedPayloads(Status(
+        Status::Code::INTERNAL,
+        "unexpected runner index" + std::to_string(runner_idx) +
+            ", max allowed " + std::to_string(contexts_.size())));
+    return;
+  }
+  if (contexts_[runner_idx] == nullptr) {
+    OnCompleteQueuedPayloads(Status(
+        Status::Code::INTERNAL, "runner index " + std::to_string(runner_idx) +
+                                    " has no execution context"));
+    return;
+  }
+
+#ifdef TRTIS_ENABLE_STATS
+  // Stop queue timer and start compute timer when the payload is
+  // scheduled to run
+  for (auto& payload : *payloads) {
+    if (payload.stats_ != nullptr) {
+      payload.stats_->CaptureTimestamp(
+          ModelInferStats::TimestampKind::kComputeStart);
+      payload.stats_->SetGPUDevice(contexts_[runner_idx]->gpu_device_);
+    }
+  }
+#endif  // TRTIS_ENABLE_STATS
+
+  // Stage the batch on this thread and hand it to the context's
+  // compute thread. The completion callback is invoked from the
+  // compute thread, so this function can return and the scheduler can
+  // form and stage the next batch while this one executes.
+  static_cast<Context*>(contexts_[runner_idx].get())
+      ->BeginRun(this, payloads, std::move(OnCompleteQueuedPayloads));
+}
+
 Status
 LibTorchBackend::Context::Run(
     const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads)
 {
+  // Synchronous path, used by warmup. The scheduler-driven path goes
+  // through BeginRun() / ComputeThread() instead so that staging the
+  // next batch overlaps the current execution.
+  PipelinedBatch batch;
+  batch.base_ = base;
+  batch.payloads_ = payloads;
+
+  RETURN_IF_ERROR(StageBatch(&batch));
+
+  // If there are no valid payloads then no need to run the
+  // inference. The payloads will have their error status set so can
+  // just return.
+  if (batch.total_batch_size_ == 0) {
+    return Status::Success;
+  }
+
+  return ExecuteBatch(&batch);
+}
+
+void
+LibTorchBackend::Context::BeginRun(
+    const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads,
+    std::function<void(Status)> OnComplete)
+{
+  // Take a staging slot, blocking if too many batches are already in
+  // flight. The slot is returned when the batch completes.
+  slot_queue_.Get();
+
+  std::unique_ptr<PipelinedBatch> batch(new PipelinedBatch());
+  batch->base_ = base;
+  batch->payloads_ = payloads;
+  batch->OnComplete_ = std::move(OnComplete);
+
+  Status status = StageBatch(batch.get());
+  if (!status.IsOk() || (batch->total_batch_size_ == 0)) {
+    slot_queue_.Put(0);
+    batch->OnComplete_(status);
+    return;
+  }
+
+  compute_queue_.Put(batch.release());
+}
+
+void
+LibTorchBackend::Context::ComputeThread()
+{
+  // The runner thread is bound to the instance group's cpuset by the
+  // scheduler initialization; the compute thread executes the forward
+  // pass for the same instance so apply the same cpuset here.
+  Status affinity_status = SetCpuAffinity(cpus_);
+  if (!affinity_status.IsOk()) {
+    LOG_ERROR << "failed to set cpu affinity for " << name_ << ": "
+              << affinity_status.Message();
+  }
+
+  while (true) {
+    std::unique_ptr<PipelinedBatch> batch(compute_queue_.Get());
+    if (batch == nullptr) {
+      break;
+    }
+
+    Status status = ExecuteBatch(batch.get());
+
+#ifdef TRTIS_ENABLE_STATS
+    // Stop compute timers.
+    for (auto& payload : *(batch->payloads_)) {
+      if (payload.stats_ != nullptr) {
+        payload.stats_->CaptureTimestamp(
+            ModelInferStats::TimestampKind::kComputeEnd);
+      }
+    }
+#endif  // TRTIS_ENABLE_STATS
+
+    batch->OnComplete_(status);
+    batch.reset();
+    slot_queue_.Put(0);
+  }
+}
+
+Status
+LibTorchBackend::Context::StageBatch(PipelinedBatch* batch)
+{
+  std::vector<Scheduler::Payload>* payloads = batch->payloads_;
+
   LOG_VERBOSE(1) << "Running " << name_ << " with " << payloads->size()
                  << " request payloads";
 
@@ -558,8 +740,9 @@ LibTorchBackend::Context::Run(
   }
 
   // If there are no valid payloads then no need to run the
-  // inference. The payloads will have their error status set so can
-  // just return.
+  // inference. The payloads will have their error status set so the
+  // caller can just complete them.
+  batch->total_batch_size_ = total_batch_size;
   if (total_batch_size == 0) {
     return Status::Success;
   }
@@ -575,13 +758,12 @@ LibTorchBackend::Context::Run(
 
   size_t input_count = repr_input_request->ImmutableInputs().size();
 
-  // Hold reference to each buffer of input data so that it stays
-  // until the inference has completed.
-  std::vector<InputMetaData> input_meta_data(input_count);
-
-  // Store input and output tensors
-  std::vector<torch::jit::IValue> inputs_(input_count);
-  std::vector<torch::Tensor> outputs_;
+  // The input buffers and tensors are held by 'batch' so that they
+  // stay until the inference has completed.
+  std::vector<InputMetaData>& input_meta_data = batch->input_meta_data_;
+  input_meta_data.resize(input_count);
+  std::vector<torch::jit::IValue>& inputs_ = batch->inputs_;
+  inputs_.resize(input_count);
   std::vector<InputInfo> inputs;
 
   // Collect input metadata. FIXME override inputs from controls
@@ -628,8 +810,12 @@ LibTorchBackend::Context::Run(
   }
 
 #ifdef TRTIS_ENABLE_GPU
+  // The staging copies are issued on 'input_copy_stream_' so that
+  // they overlap the execution and output copies of the previous
+  // batch, and must have completed before the batch is handed to the
+  // compute thread.
   if (cuda_copy) {
-    cudaStreamSynchronize(stream_);
+    cudaStreamSynchronize(input_copy_stream_);
   }
   cuda_copy = false;
   for (auto& input : inputs) {
@@ -645,8 +831,8 @@ LibTorchBackend::Context::Run(
       auto status = CopyBuffer(
           "indirect buffer", buffer_memory_type, buffer_memory_id,
           input.memory_type_, input.memory_type_id_, buffer_byte_size, buffer,
-          input.input_buffer_ + std::get<1>(indirect_buffer), stream_,
-          &cuda_used);
+          input.input_buffer_ + std::get<1>(indirect_buffer),
+          input_copy_stream_, &cuda_used);
       if (!status.IsOk()) {
         for (const auto& payload_idx : std::get<2>(indirect_buffer)) {
           (*payloads)[payload_idx].status_ = status;
@@ -657,7 +843,7 @@ LibTorchBackend::Context::Run(
     }
   }
   if (cuda_copy) {
-    cudaStreamSynchronize(stream_);
+    cudaStreamSynchronize(input_copy_stream_);
   }
 #endif  // TRTIS_ENABLE_GPU
 
@@ -674,8 +860,20 @@ LibTorchBackend::Context::Run(
   }
 #endif  // TRTIS_ENABLE_STATS
 
+  return Status::Success;
+}
+
+Status
+LibTorchBackend::Context::ExecuteBatch(PipelinedBatch* batch)
+{
+  const InferenceBackend* base = batch->base_;
+  std::vector<Scheduler::Payload>* payloads = batch->payloads_;
+  const size_t total_batch_size = batch->total_batch_size_;
+  std::vector<torch::Tensor>& outputs_ = batch->outputs_;
+  bool cuda_copy = false;
+
   // Run...
-  RETURN_IF_ERROR(Execute(&inputs_, &outputs_));
+  RETURN_IF_ERROR(Execute(&batch->inputs_, &outputs_));
 
 #ifdef TRTIS_ENABLE_STATS
   for (auto& payload : *payloads) {
@@ -778,22 +976,25 @@ LibTorchBackend::Context::Execute(
 {
   torch::jit::IValue model_outputs_;
 
+  // Autograd bookkeeping (gradient graph construction, version
+  // counters) is pure overhead for inference so disable it for the
+  // duration of the forward pass.
+  torch::NoGradGuard no_grad;
+
   try {
     model_outputs_ = torch_model_->forward(*inputs_);
-    auto model_outputs_tuple = model_outputs_.toTuple();
-    for (auto& m_op : model_outputs_tuple->elements()) {
-      outputs_->push_back(m_op.toTensor());
+    if (model_outputs_.isTuple()) {
+      auto model_outputs_tuple = model_outputs_.toTuple();
+      for (auto& m_op : model_outputs_tuple->elements()) {
+        outputs_->push_back(m_op.toTensor());
+      }
+    } else {
+      outputs_->push_back(model_outputs_.toTensor());
     }
   }
   catch (std::exception& ex) {
-    try {
-      auto model_output_tensor = model_outputs_.toTensor();
-      outputs_->push_back(model_output_tensor);
-    }
-    catch (std::exception& exx) {
-      LOG_VERBOSE(1) << ex.what();
-      return Status(Status::Code::INTERNAL, "failed to run model '" + name_);
-    }
+    LOG_VERBOSE(1) << ex.what();
+    return Status(Status::Code::INTERNAL, "failed to run model '" + name_);
   }
 
   return Status::Success;
@@ -28,6 +28,7 @@
 #include <torch/script.h>  // One-stop header.
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include "src/core/backend.h"
@@ -36,6 +37,7 @@
 #include "src/core/model_config.pb.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
+#include "src/core/sync_queue.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -55,9 +57,19 @@ class LibTorchBackend : public InferenceBackend {
       const std::unordered_map<std::string, std::string>& paths);
   Status CreateExecutionContext(
       const std::string& instance_name, const int gpu_device,
+      const std::vector<int32_t>& cpus,
       const std::unordered_map<std::string, std::string>& paths);
 
- private:
+  // Run model on the context associated with 'runner_idx' to execute
+  // for one or more requests. The input staging runs on the calling
+  // runner thread and the forward pass is handed to the context's
+  // compute thread, so the runner can stage the next batch while the
+  // current one executes. 'OnCompleteQueuedPayloads' is called from
+  // the compute thread when the batch completes.
+  void Run(
+      uint32_t runner_idx, std::vector<Scheduler::Payload>* payloads,
+      std::function<void(Status)> OnCompleteQueuedPayloads) override;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(LibTorchBackend);
   friend std::ostream& operator<<(std::ostream&, const LibTorchBackend&);
@@ -66,6 +78,12 @@ class LibTorchBackend : public InferenceBackend {
   struct Context : BackendContext {
     struct InputMetaData;
 
+    // State for a batch as it moves through the two pipeline stages:
+    // staged on the runner thread, executed and completed on the
+    // context's compute thread. Defined in the implementation file
+    // since it holds InputMetaData.
+    struct PipelinedBatch;
+
     Context(
         const std::string& name, const int gpu_device, const int max_batch_size,
         const bool enable_pinned_input, const bool enable_pinned_output);
@@ -87,11 +105,36 @@ class LibTorchBackend : public InferenceBackend {
         std::vector<InputInfo>* inputs, InputMetaData* meta_data,
         bool* cuda_copy);
 
-    // See BackendContext::Run()
+    // See BackendContext::Run(). Synchronous path that stages and
+    // executes the batch on the calling thread, used by warmup.
     Status Run(
         const InferenceBackend* base,
         std::vector<Scheduler::Payload>* payloads) override;
 
+    // Stage 'payloads' into a new batch on the calling thread and
+    // queue the batch for execution on the compute thread. Blocks
+    // until a staging slot is available, which bounds the number of
+    // in-flight batches. 'OnComplete' is called when the batch
+    // completes or fails to stage.
+    void BeginRun(
+        const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads,
+        std::function<void(Status)> OnComplete);
+
+    // Stage the inputs of 'batch'. Input copies are issued on
+    // 'input_copy_stream_' so they overlap the execution of the
+    // previous batch, and have completed by the time this function
+    // returns. On success the input tensors are held by 'batch'.
+    Status StageBatch(PipelinedBatch* batch);
+
+    // Execute a staged batch and copy the outputs into the payload
+    // responses.
+    Status ExecuteBatch(PipelinedBatch* batch);
+
+    // Loop of 'compute_thread_'. Executes staged batches in FIFO
+    // order and invokes their completion callbacks. Exits when a
+    // nullptr batch is dequeued.
+    void ComputeThread();
+
     // Helper function to set an input buffer from one or more payloads.
     Status SetFixedSizedInputBuffer(
         const std::string& name, const size_t batch1_byte_size,
@@ -123,6 +166,25 @@ class LibTorchBackend : public InferenceBackend {
     torch::Device device_;
     std::unordered_map<std::string, int> input_index_map_;
     std::unordered_map<std::string, int> output_index_map_;
+
+    // The stream used for input staging copies, so that they overlap
+    // the output copies of the previous batch issued on 'stream_'.
+    cudaStream_t input_copy_stream_;
+
+    // The thread executing staged batches, fed through
+    // 'compute_queue_'. A nullptr batch causes the thread to exit.
+    std::thread compute_thread_;
+    SyncQueue<PipelinedBatch*> compute_queue_;
+
+    // Staging slot tokens. Holding two tokens allows one batch to be
+    // staged from the pinned pool while another executes, without
+    // letting staging run unboundedly ahead.
+    SyncQueue<size_t> slot_queue_;
+
+    // The cpuset configured for the instance group of this context,
+    // applied to 'compute_thread_'. The runner thread is bound by the
+    // scheduler initialization. Empty if no cpuset is configured.
+    std::vector<int32_t> cpus_;
   };
 };
 
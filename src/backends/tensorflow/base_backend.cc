@@ -34,6 +34,7 @@
 #include "src/core/logging.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/nvtx.h"
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
 
@@ -41,6 +42,10 @@
 #include <cuda_runtime_api.h>
 #endif  // TRTIS_ENABLE_GPU
 
+#ifdef __linux__
+#include <sched.h>
+#endif  // __linux__
+
 namespace nvidia { namespace inferenceserver {
 
 BaseBackend::Context::Context(
@@ -50,13 +55,57 @@ BaseBackend::Context::Context(
           name, gpu_device, max_batch_size, enable_pinned_input,
           enable_pinned_output),
       trtistf_model_(nullptr, TRTISTF_ModelDelete),
-      input_device_id_(MODEL_DEVICE)
+      input_device_id_(MODEL_DEVICE), input_copy_stream_(nullptr)
 {
+#ifdef TRTIS_ENABLE_GPU
+  output_ready_event_ = nullptr;
+#endif  // TRTIS_ENABLE_GPU
 }
 
 BaseBackend::Context::~Context()
 {
   LOG_VERBOSE(1) << "~BaseBackend::Context ";
+
+  // Stop the compute thread before anything it may reference is
+  // destroyed.
+  if (compute_thread_.joinable()) {
+    compute_queue_.Put(nullptr);
+    compute_thread_.join();
+  }
+
+#ifdef TRTIS_ENABLE_GPU
+  if (output_ready_event_ != nullptr) {
+    cudaError_t err = cudaEventDestroy(output_ready_event_);
+    if (err != cudaSuccess) {
+      LOG_ERROR << "Failed to destroy cuda event: " << cudaGetErrorString(err);
+    }
+    output_ready_event_ = nullptr;
+  }
+  if (input_copy_stream_ != nullptr) {
+    cudaError_t err = cudaStreamDestroy(input_copy_stream_);
+    if (err != cudaSuccess) {
+      LOG_ERROR << "Failed to destroy cuda stream: " << cudaGetErrorString(err);
+    }
+    input_copy_stream_ = nullptr;
+  }
+#endif  // TRTIS_ENABLE_GPU
+}
+
+Status
+BaseBackend::Context::CreateOutputReadyEvent()
+{
+#ifdef TRTIS_ENABLE_GPU
+  if (stream_ != nullptr) {
+    auto cuerr =
+        cudaEventCreateWithFlags(&output_ready_event_, cudaEventDisableTiming);
+    if (cuerr != cudaSuccess) {
+      return Status(
+          Status::Code::INTERNAL, "unable to create cuda event for " + name_ +
+                                      ": " + cudaGetErrorString(cuerr));
+    }
+  }
+#endif  // TRTIS_ENABLE_GPU
+  return Status::Success;
 }
 
 Status
@@ -87,22 +136,39 @@ BaseBackend::CreateExecutionContexts(
       if (group.kind() == ModelInstanceGroup::KIND_CPU) {
         const std::string instance_name =
             group.name() + "_" + std::to_string(c) + "_cpu";
+        const std::vector<int32_t> cpus(
+            group.cpus().begin(), group.cpus().end());
         RETURN_IF_ERROR(CreateExecutionContext(
-            instance_name, Context::NO_GPU_DEVICE, paths));
+            instance_name, Context::NO_GPU_DEVICE, cpus, paths));
+        RegisterContextFactory([this, instance_name, cpus, paths]() -> Status {
+          return CreateExecutionContext(
+              instance_name, Context::NO_GPU_DEVICE, cpus, paths);
+        });
         total_context_cnt++;
       } else if (group.kind() == ModelInstanceGroup::KIND_MODEL) {
         const std::string instance_name =
             group.name() + "_" + std::to_string(c) + "_model_device";
         RETURN_IF_ERROR(CreateExecutionContext(
-            instance_name, Context::MODEL_DEVICE, paths));
+            instance_name, Context::MODEL_DEVICE, std::vector<int32_t>(),
+            paths));
+        RegisterContextFactory([this, instance_name, paths]() -> Status {
+          return CreateExecutionContext(
+              instance_name, Context::MODEL_DEVICE, std::vector<int32_t>(),
+              paths);
+        });
         total_context_cnt++;
       } else {
         for (int gpu_device : group.gpus()) {
           const std::string instance_name = group.name() + "_" +
                                             std::to_string(c) + "_gpu" +
                                             std::to_string(gpu_device);
-          RETURN_IF_ERROR(
-              CreateExecutionContext(instance_name, gpu_device, paths));
+          RETURN_IF_ERROR(CreateExecutionContext(
+              instance_name, gpu_device, std::vector<int32_t>(), paths));
+          RegisterContextFactory(
+              [this, instance_name, gpu_device, paths]() -> Status {
+                return CreateExecutionContext(
+                    instance_name, gpu_device, std::vector<int32_t>(), paths);
+              });
           total_context_cnt++;
         }
       }
@@ -132,6 +198,7 @@ BaseBackend::CreateExecutionContexts(
 Status
 BaseBackend::CreateExecutionContext(
     const std::string& instance_name, const int gpu_device,
+    const std::vector<int32_t>& cpus,
     const std::unordered_map<std::string, std::string>& paths)
 {
   // For a GPU context, determine the model file to use for device
@@ -199,7 +266,12 @@ BaseBackend::CreateExecutionContext(
       new Context(instance_name, gpu_device, mbs, pinned_input, pinned_output));
   Context* context = static_cast<Context*>(contexts_.back().get());
 
+  context->cpus_ = cpus;
+
   RETURN_IF_ERROR(context->CreateCudaStream());
+  RETURN_IF_ERROR(
+      context->CreateCudaStream(0, &context->input_copy_stream_));
+  RETURN_IF_ERROR(context->CreateOutputReadyEvent());
 
   RETURN_IF_ERROR(context->ValidateInputs(Config().input()));
   RETURN_IF_ERROR(context->ValidateOutputs(Config().output()));
@@ -288,11 +360,33 @@ BaseBackend::CreateExecutionContext(
     tftrt_config_ptr = &tftrt_config;
   }
 
-  RETURN_IF_ERROR(CreateTRTISTFModel(
+  // The session thread pools are created with the model and the
+  // worker threads inherit the affinity mask of the creating thread,
+  // so bind this thread to the configured cpuset for the duration of
+  // model creation and restore the previous mask afterwards.
+#ifdef __linux__
+  cpu_set_t prev_cpuset;
+  const bool restore_cpuset =
+      !cpus.empty() &&
+      (sched_getaffinity(0, sizeof(cpu_set_t), &prev_cpuset) == 0);
+  if (restore_cpuset) {
+    RETURN_IF_ERROR(SetCpuAffinity(cpus));
+  }
+#endif  // __linux__
+
+  Status model_status = CreateTRTISTFModel(
       backend_config_, vgpu_device, Config().optimization().has_graph(),
       Config().optimization().graph().level(), gdp_itr->first, gdp_itr->second,
       &context->trtistf_model_, &context->input_name_map_,
-      &context->output_name_map_, tftrt_config_ptr));
+      &context->output_name_map_, tftrt_config_ptr);
+
+#ifdef __linux__
+  if (restore_cpuset) {
+    sched_setaffinity(0 /* calling thread */, sizeof(cpu_set_t), &prev_cpuset);
+  }
+#endif  // __linux__
+
+  RETURN_IF_ERROR(model_status);
 
 
   if (context->input_device_id_ != Context::MODEL_DEVICE) {
@@ -313,6 +407,14 @@ BaseBackend::CreateExecutionContext(
         num_inputs, output_names.data(), output_types.data(), num_outputs);
   }
 
+  // Two staging slots so that one batch can be staged while another
+  // executes on the compute thread.
+  context->slot_queue_.Put(0);
+  context->slot_queue_.Put(1);
+  context->compute_thread_ = std::thread([context]() {
+    context->ComputeThread();
+  });
+
   return Status::Success;
 }
 
@@ -395,6 +497,46 @@ BaseBackend::Context::SetInput(
 
   // Only try to create a tensor on specific device if 'input_device_id_' is set
   const TRTISTF_DataType dtype = ConvertDataType(datatype);
+
+  // For a single-request batch whose input content is already a
+  // single contiguous chunk in host memory, wrap the request's buffer
+  // directly as the TF tensor instead of allocating a new one and
+  // copying into it. No release callback is needed because the
+  // request owns the buffer and lives until the completion callback
+  // of the batch, after the model execution consuming the tensor
+  // completes. GPU-resident content still goes through the
+  // copy path below since a GPU-fed model requires the tensor to be
+  // placed by the TF GPU allocator.
+  if ((dtype != TRTISTF_DataType::TRTISTF_TYPE_STRING) &&
+      (input_device_id_ < 0) && (payloads->size() == 1) &&
+      (*payloads)[0].status_.IsOk()) {
+    const InferenceRequest::Input* rinput;
+    if ((*payloads)[0].request_->ImmutableInput(name, &rinput).IsOk() &&
+        (rinput->ContentBufferCount() == 1)) {
+      const void* src_ptr = nullptr;
+      size_t src_byte_size = 0;
+      TRTSERVER_Memory_Type src_memory_type = TRTSERVER_MEMORY_CPU;
+      int64_t src_memory_type_id = 0;
+      if (rinput
+              ->Content(
+                  0, &src_ptr, &src_byte_size, &src_memory_type,
+                  &src_memory_type_id)
+              .IsOk() &&
+          (src_ptr != nullptr) && (src_memory_type != TRTSERVER_MEMORY_GPU)) {
+        TRTISTF_Tensor* borrowed_tensor = TRTISTF_TensorNewFromBuffer(
+            input_tensor_name->c_str(), dtype, shape.size(),
+            (shape.size() == 0) ? nullptr : &shape[0],
+            const_cast<char*>(static_cast<const char*>(src_ptr)),
+            src_byte_size, nullptr /* release_fn */,
+            nullptr /* release_userp */);
+        if (borrowed_tensor != nullptr) {
+          *input_tensors = TRTISTF_TensorListNew(borrowed_tensor, *input_tensors);
+          return Status::Success;
+        }
+      }
+    }
+  }
+
   TRTISTF_Tensor* tensor = TRTISTF_TensorNew(
       input_tensor_name->c_str(), dtype, shape.size(),
       (shape.size() == 0) ? nullptr : &shape[0], input_device_id_);
@@ -455,8 +597,8 @@ BaseBackend::Context::SetFixedSizedInputTensor(
       (TRTISTF_TensorIsGPUTensor(tensor)) ? gpu_device_ : 0;
   LOG_VERBOSE(1) << "input '" << input_name
                  << "' is GPU tensor: " << TRTISTF_TensorIsGPUTensor(tensor);
-  *cuda_copy |=
-      SetInputBuffer(input_name, expected_byte_sizes, payloads, input);
+  *cuda_copy |= SetInputBuffer(
+      input_name, expected_byte_sizes, payloads, input_copy_stream_, input);
 }
 
 void
@@ -503,48 +645,29 @@ BaseBackend::Context::SetStringInputTensor(
     }
 #endif  // TRTIS_ENABLE_GPU
 
-    // Parse content and assign them to the 'tensor'. Each string
-    // in 'content' is a 4-byte length followed by the string
-    // itself with no null-terminator.
-    while (content_byte_size >= sizeof(uint32_t)) {
-      if (element_idx >= expected_element_cnt) {
-        payload.status_ = Status(
-            Status::Code::INVALID_ARG,
-            "unexpected number of string elements " +
-                std::to_string(element_idx + 1) + " for inference input '" +
-                input_name + "', expecting " +
-                std::to_string(expected_element_cnt));
-        FillStringTensor(
-            tensor, tensor_element_idx + element_idx,
-            expected_element_cnt - element_idx);
-        break;
-      }
-
-      const uint32_t len = *(reinterpret_cast<const uint32_t*>(content));
-      content += sizeof(uint32_t);
-      content_byte_size -= sizeof(uint32_t);
-
-      if (content_byte_size < len) {
-        payload.status_ = Status(
-            Status::Code::INVALID_ARG,
-            "incomplete string data for inference input '" + input_name +
-                "', expecting string of length " + std::to_string(len) +
-                " but only " + std::to_string(content_byte_size) +
-                " bytes available");
-        FillStringTensor(
-            tensor, tensor_element_idx + element_idx,
-            expected_element_cnt - element_idx);
-        break;
-      }
+    // Parse content and assign the strings to the 'tensor'. Each
+    // string in 'content' is a 4-byte length followed by the string
+    // itself with no null-terminator. The offsets of all elements are
+    // computed in a single pass before the strings are handed to the
+    // tensor.
+    std::vector<StringTensorElement> elements;
+    Status parse_status = ParseSerializedStringTensor(
+        input_name, content, content_byte_size, expected_element_cnt,
+        &elements);
 
+    for (const auto& element : elements) {
       TRTISTF_TensorSetString(
-          tensor, tensor_element_idx + element_idx, content, len);
-      content += len;
-      content_byte_size -= len;
+          tensor, tensor_element_idx + element_idx, element.first,
+          element.second);
       element_idx++;
     }
 
-    if (payload.status_.IsOk() && (element_idx != expected_element_cnt)) {
+    if (!parse_status.IsOk()) {
+      payload.status_ = parse_status;
+      FillStringTensor(
+          tensor, tensor_element_idx + element_idx,
+          expected_element_cnt - element_idx);
+    } else if (element_idx != expected_element_cnt) {
       payload.status_ = Status(
           Status::Code::INTERNAL,
           "expected " + std::to_string(expected_element_cnt) +
@@ -637,12 +760,137 @@ BaseBackend::Context::ReadStringOutputTensor(
   }
 }
 
+void
+BaseBackend::Run(
+    uint32_t runner_idx, std::vector<Scheduler::Payload>* payloads,
+    std::function<void(Status)> OnCompleteQueuedPayloads)
+{
+  // Each runner executes using the corresponding context...
+  if (runner_idx >= contexts_.size()) {
+    OnCompleteQueuedPayloads(Status(
+        Status::Code::INTERNAL,
+        "unexpected runner index" + std::to_string(runner_idx) +
+            ", max allowed " + std::to_string(contexts_.size())));
+    return;
+  }
+  if (contexts_[runner_idx] == nullptr) {
+    OnCompleteQueuedPayloads(Status(
+        Status::Code::INTERNAL, "runner index " + std::to_string(runner_idx) +
+                                    " has no execution context"));
+    return;
+  }
+
+#ifdef TRTIS_ENABLE_STATS
+  // Stop queue timer and start compute timer when the payload is
+  // scheduled to run
+  for (auto& payload : *payloads) {
+    if (payload.stats_ != nullptr) {
+      payload.stats_->CaptureTimestamp(
+          ModelInferStats::TimestampKind::kComputeStart);
+      payload.stats_->SetGPUDevice(contexts_[runner_idx]->gpu_device_);
+    }
+  }
+#endif  // TRTIS_ENABLE_STATS
+
+  // Stage the batch on this thread and hand it to the context's
+  // compute thread. The completion callback is invoked from the
+  // compute thread, so this function can return and the scheduler can
+  // form and stage the next batch while this one executes.
+  static_cast<Context*>(contexts_[runner_idx].get())
+      ->BeginRun(this, payloads, std::move(OnCompleteQueuedPayloads));
+}
+
 Status
 BaseBackend::Context::Run(
     const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads)
 {
+  // Synchronous path, used by warmup. The scheduler-driven path goes
+  // through BeginRun() / ComputeThread() instead so that staging the
+  // next batch overlaps the current execution.
+  PipelinedBatch batch;
+  batch.base_ = base;
+  batch.payloads_ = payloads;
+
+  RETURN_IF_ERROR(StageBatch(&batch));
+
+  // If there are no valid payloads then no need to run the
+  // inference. The payloads will have their error status set so can
+  // just return.
+  if (batch.total_batch_size_ == 0) {
+    return Status::Success;
+  }
+
+  return ExecuteBatch(&batch);
+}
+
+void
+BaseBackend::Context::BeginRun(
+    const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads,
+    std::function<void(Status)> OnComplete)
+{
+  // Take a staging slot, blocking if too many batches are already in
+  // flight. The slot is returned when the batch completes.
+  slot_queue_.Get();
+
+  std::unique_ptr<PipelinedBatch> batch(new PipelinedBatch());
+  batch->base_ = base;
+  batch->payloads_ = payloads;
+  batch->OnComplete_ = std::move(OnComplete);
+
+  Status status = StageBatch(batch.get());
+  if (!status.IsOk() || (batch->total_batch_size_ == 0)) {
+    slot_queue_.Put(0);
+    batch->OnComplete_(status);
+    return;
+  }
+
+  compute_queue_.Put(batch.release());
+}
+
+void
+BaseBackend::Context::ComputeThread()
+{
+  // The runner thread is bound to the instance group's cpuset by the
+  // scheduler initialization; the compute thread executes the session
+  // for the same instance so apply the same cpuset here.
+  Status affinity_status = SetCpuAffinity(cpus_);
+  if (!affinity_status.IsOk()) {
+    LOG_ERROR << "failed to set cpu affinity for " << name_ << ": "
+              << affinity_status.Message();
+  }
+
+  while (true) {
+    std::unique_ptr<PipelinedBatch> batch(compute_queue_.Get());
+    if (batch == nullptr) {
+      break;
+    }
+
+    Status status = ExecuteBatch(batch.get());
+
+#ifdef TRTIS_ENABLE_STATS
+    // Stop compute timers.
+    for (auto& payload : *(batch->payloads_)) {
+      if (payload.stats_ != nullptr) {
+        payload.stats_->CaptureTimestamp(
+            ModelInferStats::TimestampKind::kComputeEnd);
+      }
+    }
+#endif  // TRTIS_ENABLE_STATS
+
+    batch->OnComplete_(status);
+    batch.reset();
+    slot_queue_.Put(0);
+  }
+}
+
+Status
+BaseBackend::Context::StageBatch(PipelinedBatch* batch)
+{
+  std::vector<Scheduler::Payload>* payloads = batch->payloads_;
+
   LOG_VERBOSE(1) << "Running " << name_ << " with " << payloads->size()
                  << " request payloads";
+  NVTX_RANGE(nvtx_, "StageBatch " + name_);
 
   const InferenceRequest* repr_input_request = nullptr;
 
@@ -667,8 +915,9 @@ BaseBackend::Context::Run(
   }
 
   // If there are no valid payloads then no need to run the
-  // inference. The payloads will have their error status set so can
-  // just return.
+  // inference. The payloads will have their error status set so the
+  // caller can just complete them.
+  batch->total_batch_size_ = total_batch_size;
   if (total_batch_size == 0) {
     return Status::Success;
   }
@@ -720,26 +969,28 @@ BaseBackend::Context::Run(
   }
 
   // Create the vector of required output names using the names
-  // expected by the model.
-  std::vector<std::string> model_output_names;
-  const char* output_names_cstr[required_outputs.size()];
-  {
-    size_t oidx = 0;
-    for (const auto& name : required_outputs) {
-      model_output_names.push_back(name);
-      const auto& tn_itr = output_name_map_.find(name);
-      if (tn_itr == output_name_map_.end()) {
-        output_names_cstr[oidx] = name.c_str();
-      } else {
-        output_names_cstr[oidx] = tn_itr->second.c_str();
-      }
-      oidx++;
+  // expected by the model. The name storage is held by 'batch' so the
+  // c-string pointers stay valid until the model run; the pointers
+  // are built only after 'model_output_names_' is fully populated
+  // since growing the vector may move the strings.
+  batch->model_output_names_.assign(
+      required_outputs.begin(), required_outputs.end());
+  for (const auto& name : batch->model_output_names_) {
+    const auto& tn_itr = output_name_map_.find(name);
+    if (tn_itr == output_name_map_.end()) {
+      batch->tf_output_names_.push_back(name.c_str());
+    } else {
+      batch->tf_output_names_.push_back(tn_itr->second.c_str());
     }
   }
 
 #ifdef TRTIS_ENABLE_GPU
+  // The staging copies are issued on 'input_copy_stream_' so that
+  // they overlap the execution and output copies of the previous
+  // batch, and must have completed before the batch is handed to the
+  // compute thread.
   if (cuda_copy) {
-    cudaStreamSynchronize(stream_);
+    cudaStreamSynchronize(input_copy_stream_);
   }
   cuda_copy = false;
   for (auto& input : inputs) {
@@ -755,8 +1006,8 @@ BaseBackend::Context::Run(
       auto status = CopyBuffer(
           "indirect buffer", buffer_memory_type, buffer_memory_id,
           input.memory_type_, input.memory_type_id_, buffer_byte_size, buffer,
-          input.input_buffer_ + std::get<1>(indirect_buffer), stream_,
-          &cuda_used);
+          input.input_buffer_ + std::get<1>(indirect_buffer),
+          input_copy_stream_, &cuda_used);
       if (!status.IsOk()) {
         for (const auto& payload_idx : std::get<2>(indirect_buffer)) {
           (*payloads)[payload_idx].status_ = status;
@@ -767,7 +1018,7 @@ BaseBackend::Context::Run(
     }
   }
   if (cuda_copy) {
-    cudaStreamSynchronize(stream_);
+    cudaStreamSynchronize(input_copy_stream_);
   }
 #endif  // TRTIS_ENABLE_GPU
 
@@ -780,15 +1031,35 @@ BaseBackend::Context::Run(
   }
 #endif  // TRTIS_ENABLE_STATS
 
+  // The input tensor list is held by 'batch' until it is handed to
+  // the model run.
+  batch->input_tensors_ = input_head_ptr;
+  input_tensors.release();
+
+  return Status::Success;
+}
+
+Status
+BaseBackend::Context::ExecuteBatch(PipelinedBatch* batch)
+{
+  NVTX_RANGE(nvtx_, "ExecuteBatch " + name_);
+
+  const InferenceBackend* base = batch->base_;
+  std::vector<Scheduler::Payload>* payloads = batch->payloads_;
+  const size_t total_batch_size = batch->total_batch_size_;
+
   // Run. Session will update the 'output_tensors'.
   std::unique_ptr<TRTISTF_TensorList, decltype(&TRTISTF_TensorListDelete)>
       output_tensors(nullptr, TRTISTF_TensorListDelete);
 
   {
+    // Ownership of the input tensor list passes to the model run.
+    TRTISTF_TensorList* input_tensors = batch->input_tensors_;
+    batch->input_tensors_ = nullptr;
     TRTISTF_TensorList* rtl;
     RETURN_IF_TRTISTF_ERROR(TRTISTF_ModelRun(
-        trtistf_model_.get(), *(input_tensors.release()),
-        required_outputs.size(), output_names_cstr, &rtl));
+        trtistf_model_.get(), input_tensors, batch->tf_output_names_.size(),
+        batch->tf_output_names_.data(), &rtl));
     output_tensors.reset(rtl);
   }
 
@@ -803,10 +1074,10 @@ BaseBackend::Context::Run(
 
   // Make sure each output is of the expected size and copy it into
   // the appropriate response providers.
-  cuda_copy = false;
+  bool cuda_copy = false;
   std::vector<OutputInfo> outputs;
   TRTISTF_TensorList* output_tensor_itr = output_tensors.get();
-  for (const auto& name : model_output_names) {
+  for (const auto& name : batch->model_output_names_) {
     outputs.emplace_back();
     const ModelOutput* output_config;
     RETURN_IF_ERROR(base->GetOutput(name, &output_config));
@@ -874,7 +1145,11 @@ BaseBackend::Context::Run(
 
 #ifdef TRTIS_ENABLE_GPU
   if (cuda_copy) {
-    cudaStreamSynchronize(stream_);
+    // The output copies were issued asynchronously on 'stream_' so
+    // wait on an event marking their completion rather than
+    // synchronizing the entire stream.
+    cudaEventRecord(output_ready_event_, stream_);
+    cudaEventSynchronize(output_ready_event_);
   }
   cuda_copy = false;
   for (auto& output : outputs) {
@@ -902,7 +1177,8 @@ BaseBackend::Context::Run(
     }
   }
   if (cuda_copy) {
-    cudaStreamSynchronize(stream_);
+    cudaEventRecord(output_ready_event_, stream_);
+    cudaEventSynchronize(output_ready_event_);
   }
 #endif  // TRTIS_ENABLE_GPU
 
@@ -25,6 +25,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <thread>
 #include "src/backends/tensorflow/graphdef_backend_factory.h"
 #include "src/backends/tensorflow/tensorflow_backend_tf.h"
 #include "src/core/backend.h"
@@ -32,6 +33,7 @@
 #include "src/core/model_config.pb.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
+#include "src/core/sync_queue.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -56,8 +58,19 @@ class BaseBackend : public InferenceBackend {
       const std::unordered_map<std::string, std::string>& paths);
   Status CreateExecutionContext(
       const std::string& instance_name, const int gpu_device,
+      const std::vector<int32_t>& cpus,
       const std::unordered_map<std::string, std::string>& paths);
 
+  // Run model on the context associated with 'runner_idx' to execute
+  // for one or more requests. The input staging runs on the calling
+  // runner thread and the session run is handed to the context's
+  // compute thread, so the runner can stage the next batch while the
+  // current one executes. 'OnCompleteQueuedPayloads' is called from
+  // the compute thread when the batch completes.
+  void Run(
+      uint32_t runner_idx, std::vector<Scheduler::Payload>* payloads,
+      std::function<void(Status)> OnCompleteQueuedPayloads) override;
+
  protected:
   using TRTISTFModelHandle =
       std::unique_ptr<TRTISTF_Model, decltype(&TRTISTF_ModelDelete)>;
@@ -85,6 +98,11 @@ class BaseBackend : public InferenceBackend {
     DISALLOW_MOVE(Context);
     DISALLOW_COPY_AND_ASSIGN(Context);
 
+    // Create 'output_ready_event_' used to wait for the completion
+    // of the output copies issued on 'stream_'. Has no effect if no
+    // stream has been created.
+    Status CreateOutputReadyEvent();
+
     Status ValidateInputs(
         const ::google::protobuf::RepeatedPtrField<ModelInput>& ios);
     Status ValidateOutputs(
@@ -124,17 +142,54 @@ class BaseBackend : public InferenceBackend {
         const std::vector<int64_t>& shape, const size_t batch1_element_cnt,
         std::vector<Scheduler::Payload>* payloads, bool* cuda_copy);
 
-    // Run model to execute for one or more requests. This function
-    // assumes that it is only called by the single runner thread that
-    // is assigned to this context. A non-OK return status indicates
-    // an internal error that prevents any of the of requests from
-    // completing. If an error is isolate to a single request payload
-    // it will be reported in that payload.
-    // See BackendContext::Run()
+    // State for a batch as it moves through the two pipeline stages:
+    // staged on the runner thread, executed and completed on the
+    // context's compute thread. Owns the input tensor list until it is
+    // handed to the model run.
+    struct PipelinedBatch {
+      const InferenceBackend* base_ = nullptr;
+      std::vector<Scheduler::Payload>* payloads_ = nullptr;
+      std::function<void(Status)> OnComplete_;
+      size_t total_batch_size_ = 0;
+      TRTISTF_TensorList* input_tensors_ = nullptr;
+      std::vector<std::string> model_output_names_;
+      std::vector<const char*> tf_output_names_;
+    };
+
+    // See BackendContext::Run(). Synchronous path that stages and
+    // executes the batch on the calling thread, used by warmup. A
+    // non-OK return status indicates an internal error that prevents
+    // any of the of requests from completing. If an error is isolate
+    // to a single request payload it will be reported in that payload.
     Status Run(
         const InferenceBackend* base,
         std::vector<Scheduler::Payload>* payloads) override;
 
+    // Stage 'payloads' into a new batch on the calling thread and
+    // queue the batch for execution on the compute thread. Blocks
+    // until a staging slot is available, which bounds the number of
+    // in-flight batches. 'OnComplete' is called when the batch
+    // completes or fails to stage.
+    void BeginRun(
+        const InferenceBackend* base, std::vector<Scheduler::Payload>* payloads,
+        std::function<void(Status)> OnComplete);
+
+    // Stage the inputs of 'batch'. Input copies are issued on
+    // 'input_copy_stream_' so they overlap the execution of the
+    // previous batch, and have completed by the time this function
+    // returns. On success the input tensor list is held by 'batch'.
+    Status StageBatch(PipelinedBatch* batch);
+
+    // Execute a staged batch and copy the outputs into the payload
+    // responses. Ownership of the input tensor list is passed to the
+    // model run.
+    Status ExecuteBatch(PipelinedBatch* batch);
+
+    // Loop of 'compute_thread_'. Executes staged batches in FIFO
+    // order and invokes their completion callbacks. Exits when a
+    // nullptr batch is dequeued.
+    void ComputeThread();
+
     // Map from configuration name for an input to tensor name for
     // that input in the model.
     IONameMap input_name_map_;
@@ -148,6 +203,32 @@ class BaseBackend : public InferenceBackend {
 
     // use for GPU allocator
     int input_device_id_;
+
+    // The stream used for input staging copies, so that they overlap
+    // the output copies of the previous batch issued on 'stream_'.
+    cudaStream_t input_copy_stream_;
+
+    // The thread executing staged batches, fed through
+    // 'compute_queue_'. A nullptr batch causes the thread to exit.
+    std::thread compute_thread_;
+    SyncQueue<PipelinedBatch*> compute_queue_;
+
+    // Staging slot tokens. Holding two tokens allows one batch to be
+    // staged while another executes, without letting staging run
+    // unboundedly ahead.
+    SyncQueue<size_t> slot_queue_;
+
+    // The cpuset configured for the instance group of this context,
+    // applied to 'compute_thread_'. The runner thread is bound by the
+    // scheduler initialization. Empty if no cpuset is configured.
+    std::vector<int32_t> cpus_;
+
+#ifdef TRTIS_ENABLE_GPU
+    // The event recorded after the output copies are issued on
+    // 'stream_' so that completion waits on just those copies instead
+    // of synchronizing the entire stream.
+    cudaEvent_t output_ready_event_;
+#endif  // TRTIS_ENABLE_GPU
   };
 
  private:
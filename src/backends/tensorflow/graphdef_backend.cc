@@ -50,7 +50,7 @@ GraphDefBackend::CreateTRTISTFModel(
       has_graph_level, graph_level, backend_config->allow_gpu_memory_growth,
       backend_config->per_process_gpu_memory_fraction,
       backend_config->allow_soft_placement, backend_config->memory_limit_mb,
-      tftrt_config));
+      tftrt_config, backend_config->shared_thread_pool_size));
 
   trtistf_model->reset(model);
 
@@ -46,6 +46,12 @@ class GraphDefBackendFactory {
     float per_process_gpu_memory_fraction;
     bool allow_soft_placement;
     std::map<int, std::vector<float>> memory_limit_mb;
+
+    // If >= 0, sessions schedule work on a thread pool shared across
+    // all TF models (sized to the value, or to the TF default when
+    // 0) instead of creating per-session pools. If < 0 each session
+    // creates its own pools.
+    int shared_thread_pool_size;
   };
 
   static Status Create(
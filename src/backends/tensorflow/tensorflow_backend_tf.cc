@@ -33,6 +33,7 @@
 #include "tensorflow/core/common_runtime/gpu/gpu_id_utils.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_mem_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -213,11 +214,26 @@ NewSessionOptions(
     const float per_process_gpu_memory_fraction,
     const bool allow_soft_placement,
     const std::map<int, std::vector<float>>& memory_limit_mb,
-    const TRTISTF_TFTRTConfig* tftrt_config,
+    const TRTISTF_TFTRTConfig* tftrt_config, const int shared_thread_pool_size,
     tensorflow::SessionOptions* session_options)
 {
   session_options->config.mutable_gpu_options()->set_allow_growth(
       allow_gpu_memory_growth);
+
+  // Schedule inter-op work on a thread pool shared across all
+  // sessions that request it. TF shares pools with the same
+  // 'global_name' process-wide. The intra-op pool can't be shared
+  // across sessions, so cap it instead to bound the total thread
+  // count.
+  if (shared_thread_pool_size >= 0) {
+    auto pool = session_options->config.add_session_inter_op_thread_pool();
+    pool->set_num_threads(shared_thread_pool_size);
+    pool->set_global_name("trtserver_shared_inter_op");
+    if (shared_thread_pool_size > 0) {
+      session_options->config.set_intra_op_parallelism_threads(
+          shared_thread_pool_size);
+    }
+  }
   session_options->config.mutable_gpu_options()
       ->set_per_process_gpu_memory_fraction(per_process_gpu_memory_fraction);
   session_options->config.set_allow_soft_placement(allow_soft_placement);
@@ -314,11 +330,49 @@ GetTFGPUDeviceName(
 //
 // TensorImpl
 //
+// A TensorBuffer that wraps an externally-owned data buffer. The
+// release callback, if any, is invoked when the last tensor
+// referencing the buffer is destroyed.
+class BorrowedTensorBuffer : public tensorflow::TensorBuffer {
+ public:
+  BorrowedTensorBuffer(
+      char* data, size_t byte_size, void (*release_fn)(void*),
+      void* release_userp)
+      : tensorflow::TensorBuffer(data), byte_size_(byte_size),
+        release_fn_(release_fn), release_userp_(release_userp)
+  {
+  }
+  ~BorrowedTensorBuffer() override
+  {
+    if (release_fn_ != nullptr) {
+      release_fn_(release_userp_);
+    }
+  }
+
+  size_t size() const override { return byte_size_; }
+  tensorflow::TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(
+      tensorflow::AllocationDescription* proto) const override
+  {
+    proto->set_requested_bytes(byte_size_);
+    proto->set_allocated_bytes(byte_size_);
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const size_t byte_size_;
+  void (*release_fn_)(void*);
+  void* release_userp_;
+};
+
 class TensorImpl {
  public:
   TensorImpl(
       const char* name, TRTISTF_DataType dtype, TRTISTF_Shape* shape,
       const tensorflow::TensorShape& tfshape, const int tf_gpu_id);
+  TensorImpl(
+      const char* name, TRTISTF_DataType dtype, TRTISTF_Shape* shape,
+      tensorflow::Tensor&& tftensor);
   TensorImpl(tensorflow::Tensor&& tftensor);
   ~TensorImpl();
 
@@ -368,6 +422,14 @@ TensorImpl::TensorImpl(
   Init();
 }
 
+TensorImpl::TensorImpl(
+    const char* name, TRTISTF_DataType dtype, TRTISTF_Shape* shape,
+    tensorflow::Tensor&& tftensor)
+    : name_(name), dtype_(dtype), shape_(shape), tftensor_(std::move(tftensor))
+{
+  Init();
+}
+
 TensorImpl::TensorImpl(tensorflow::Tensor&& tftensor)
     : name_(), dtype_(ConvertDataType(tftensor.dtype())),
       shape_(ConvertShape(tftensor.shape())), tftensor_(std::move(tftensor))
@@ -731,6 +793,40 @@ TRTISTF_TensorNew(
   return reinterpret_cast<TRTISTF_Tensor*>(tensor);
 }
 
+TRTISTF_Tensor*
+TRTISTF_TensorNewFromBuffer(
+    const char* name, TRTISTF_DataType dtype, size_t shape_rank,
+    int64_t* shape_dims, char* data, size_t byte_size,
+    void (*release_fn)(void* userp), void* release_userp)
+{
+  if ((dtype == TRTISTF_DataType::TRTISTF_TYPE_STRING) || (data == nullptr)) {
+    return nullptr;
+  }
+
+  TRTISTF_Shape* shape = TRTISTF_ShapeNew(shape_rank, shape_dims);
+  tensorflow::TensorShape tfshape;
+  ConvertShape(shape, &tfshape);
+
+  // The buffer must hold exactly the tensor contents.
+  const tensorflow::DataType tfdtype = ConvertDataType(dtype);
+  const int64_t expected_byte_size =
+      tfshape.num_elements() * tensorflow::DataTypeSize(tfdtype);
+  if (expected_byte_size != (int64_t)byte_size) {
+    TRTISTF_ShapeDelete(shape);
+    return nullptr;
+  }
+
+  auto buffer =
+      new BorrowedTensorBuffer(data, byte_size, release_fn, release_userp);
+  tensorflow::Tensor tftensor(tfdtype, tfshape, buffer);
+
+  // The tensor holds its own reference to the buffer.
+  buffer->Unref();
+
+  TensorImpl* tensor = new TensorImpl(name, dtype, shape, std::move(tftensor));
+  return reinterpret_cast<TRTISTF_Tensor*>(tensor);
+}
+
 TRTISTF_DataType
 TRTISTF_TensorDataType(TRTISTF_Tensor* tensor)
 {
@@ -806,13 +902,13 @@ TRTISTF_ModelCreateFromGraphDef(
     const float per_process_gpu_memory_fraction,
     const bool allow_soft_placement,
     const std::map<int, std::vector<float>>& memory_limit_mb,
-    const TRTISTF_TFTRTConfig* tftrt_config)
+    const TRTISTF_TFTRTConfig* tftrt_config, const int shared_thread_pool_size)
 {
   tensorflow::SessionOptions session_options;
   NewSessionOptions(
       has_graph_level, graph_level, allow_gpu_memory_growth,
       per_process_gpu_memory_fraction, allow_soft_placement, memory_limit_mb,
-      tftrt_config, &session_options);
+      tftrt_config, shared_thread_pool_size, &session_options);
 
   tensorflow::Session* session;
   RETURN_IF_TF_ERROR(tensorflow::NewSession(session_options, &session));
@@ -885,13 +981,13 @@ TRTISTF_ModelCreateFromSavedModel(
     const float per_process_gpu_memory_fraction,
     const bool allow_soft_placement,
     const std::map<int, std::vector<float>>& memory_limit_mb,
-    const TRTISTF_TFTRTConfig* tftrt_config)
+    const TRTISTF_TFTRTConfig* tftrt_config, const int shared_thread_pool_size)
 {
   tensorflow::SessionOptions session_options;
   NewSessionOptions(
       has_graph_level, graph_level, allow_gpu_memory_growth,
       per_process_gpu_memory_fraction, allow_soft_placement, memory_limit_mb,
-      tftrt_config, &session_options);
+      tftrt_config, shared_thread_pool_size, &session_options);
 
 
   if (device_id != TRTISTF_MODEL_DEVICE) {
@@ -168,6 +168,21 @@ TRTISTF_EXPORT TRTISTF_Tensor* TRTISTF_TensorNew(
     const char* name, TRTISTF_DataType dtype, size_t shape_rank,
     int64_t* shape_dims, int tf_gpu_id);
 
+// Create a new tensor that wraps an existing data buffer instead of
+// allocating and copying into a new one. 'data' must be a contiguous
+// buffer of 'byte_size' bytes holding the tensor contents and must
+// remain valid until 'release_fn' is called with 'release_userp',
+// which happens when the tensor no longer references the buffer.
+// 'release_fn' may be nullptr if the caller guarantees the buffer
+// outlives the tensor. Defined only for non-string datatypes. Return
+// nullptr if the tensor can not be created, for example if 'byte_size'
+// doesn't match the shape and datatype; in that case 'release_fn' is
+// not called and the caller retains the buffer.
+TRTISTF_EXPORT TRTISTF_Tensor* TRTISTF_TensorNewFromBuffer(
+    const char* name, TRTISTF_DataType dtype, size_t shape_rank,
+    int64_t* shape_dims, char* data, size_t byte_size,
+    void (*release_fn)(void* userp), void* release_userp);
+
 // Return a tensor's datatype.
 TRTISTF_EXPORT TRTISTF_DataType TRTISTF_TensorDataType(TRTISTF_Tensor* tensor);
 
@@ -215,7 +230,13 @@ TRTISTF_EXPORT void TRTISTF_TensorSetString(
 // Opaque handle to a model
 struct TRTISTF_Model;
 
-// Create a GraphDef model.
+// Create a GraphDef model. If 'shared_thread_pool_size' is >= 0 the
+// session schedules its inter-op work on a thread pool shared by all
+// sessions created with a non-negative value, sized to the value (or
+// to the TF default when 0), and its intra-op parallelism is capped
+// to the same size; concurrently loaded CPU models then cooperate
+// instead of over-subscribing the cores with per-session pools. If
+// < 0 the session creates its own thread pools as before.
 TRTISTF_EXPORT TRTISTF_Error* TRTISTF_ModelCreateFromGraphDef(
     TRTISTF_Model** trtistf_model, const char* model_name,
     const char* model_path, const int device_id, const bool has_graph_level,
@@ -223,9 +244,10 @@ TRTISTF_EXPORT TRTISTF_Error* TRTISTF_ModelCreateFromGraphDef(
     const float per_process_gpu_memory_fraction,
     const bool allow_soft_placement,
     const std::map<int, std::vector<float>>& memory_limit_mb,
-    const TRTISTF_TFTRTConfig* tftrt_config);
+    const TRTISTF_TFTRTConfig* tftrt_config, const int shared_thread_pool_size);
 
-// Create a SavedModel model.
+// Create a SavedModel model. See TRTISTF_ModelCreateFromGraphDef for
+// the meaning of 'shared_thread_pool_size'.
 TRTISTF_EXPORT TRTISTF_Error* TRTISTF_ModelCreateFromSavedModel(
     TRTISTF_Model** trtistf_model, const char* model_name,
     const char* model_path, const int device_id, const bool has_graph_level,
@@ -233,7 +255,7 @@ TRTISTF_EXPORT TRTISTF_Error* TRTISTF_ModelCreateFromSavedModel(
     const float per_process_gpu_memory_fraction,
     const bool allow_soft_placement,
     const std::map<int, std::vector<float>>& memory_limit_mb,
-    const TRTISTF_TFTRTConfig* tftrt_config);
+    const TRTISTF_TFTRTConfig* tftrt_config, const int shared_thread_pool_size);
 
 // Delete a model.
 TRTISTF_EXPORT void TRTISTF_ModelDelete(TRTISTF_Model* model);
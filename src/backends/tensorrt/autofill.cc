@@ -527,14 +527,14 @@ AutoFillPlan::Create(
   for (auto file : plan_files) {
     const auto plan_path = JoinPath({version_path, file});
 
-    std::string plan_data_str;
-    status = ReadTextFile(plan_path, &plan_data_str);
+    std::shared_ptr<MappedFile> plan_data;
+    status = MapFile(plan_path, &plan_data);
     if (!status.IsOk()) {
       continue;
     }
-    std::vector<char> plan_data(plan_data_str.begin(), plan_data_str.end());
 
-    if (!LoadPlan(plan_data, &runtime, &engine).IsOk()) {
+    if (!LoadPlan(plan_data->Data(), plan_data->ByteSize(), &runtime, &engine)
+             .IsOk()) {
       if (engine != nullptr) {
         engine->destroy();
       }
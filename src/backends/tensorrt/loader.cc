@@ -35,8 +35,8 @@ namespace nvidia { namespace inferenceserver {
 
 Status
 LoadPlan(
-    const std::vector<char>& model_data, nvinfer1::IRuntime** runtime,
-    nvinfer1::ICudaEngine** engine)
+    const void* model_data, const size_t model_byte_size,
+    nvinfer1::IRuntime** runtime, nvinfer1::ICudaEngine** engine)
 {
   // Create runtime only if it is not provided
   if (*runtime == nullptr) {
@@ -54,8 +54,7 @@ LoadPlan(
     return Status(Status::Code::INTERNAL, "unable to create TensorRT runtime");
   }
 
-  *engine =
-      (*runtime)->deserializeCudaEngine(&model_data[0], model_data.size());
+  *engine = (*runtime)->deserializeCudaEngine(model_data, model_byte_size);
   if (*engine == nullptr) {
     return Status(Status::Code::INTERNAL, "unable to create TensorRT engine");
   }
@@ -26,7 +26,6 @@
 #pragma once
 
 #include <NvInfer.h>
-#include <vector>
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -37,13 +36,14 @@ namespace nvidia { namespace inferenceserver {
 /// even if an error is returned.
 ///
 /// \param model_data The binary blob of the plan data
+/// \param model_byte_size The size of the plan data, in bytes
 /// \param runtime Returns the IRuntime object, or nullptr if failed
 /// to create
 /// \param engine Returns the ICudaEngine object, or nullptr if failed
 /// to create
 /// \return Error status.
 Status LoadPlan(
-    const std::vector<char>& model_data, nvinfer1::IRuntime** runtime,
-    nvinfer1::ICudaEngine** engine);
+    const void* model_data, const size_t model_byte_size,
+    nvinfer1::IRuntime** runtime, nvinfer1::ICudaEngine** engine);
 
 }}  // namespace nvidia::inferenceserver
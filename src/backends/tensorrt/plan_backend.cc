@@ -28,7 +28,10 @@
 
 #include <NvInfer.h>
 #include <stdint.h>
+#include <string.h>
 #include <future>
+#include <mutex>
+#include <unordered_map>
 #include "src/backends/tensorrt/loader.h"
 #include "src/backends/tensorrt/plan_utils.h"
 #include "src/core/constants.h"
@@ -60,6 +63,29 @@ CreateCudaEvent(const std::string& event_name, cudaEvent_t* event)
   return Status::Success;
 }
 
+// Registry of deserialized engines keyed by device and plan-file
+// content so that backends loading byte-identical plans (e.g. two
+// versions of a model that differ only in configuration, or the same
+// model repeated across ensembles) share one copy of the weights on
+// the device. The registry does not own the engines, an entry expires
+// when the last backend using its engine is destroyed.
+std::mutex engine_registry_mu;
+std::unordered_map<std::string, std::weak_ptr<PlanBackend::SharedEngine>>
+    engine_registry;
+
+std::string
+EngineRegistryKey(const int gpu_device, const char* data, const size_t size)
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= (uint64_t)(uint8_t)data[i];
+    hash *= 0x100000001b3ull;
+  }
+
+  return std::to_string(gpu_device) + "_" + std::to_string(size) + "_" +
+         std::to_string(hash);
+}
+
 }  // namespace
 
 PlanBackend::Context::Context(
@@ -73,6 +99,7 @@ PlanBackend::Context::Context(
 {
   stream_ = nullptr;
   input_copy_stream_ = nullptr;
+  output_copy_stream_ = nullptr;
 
   next_set_ = 0;
   for (size_t idx = 0; idx < EVENT_SET_COUNT; idx++) {
@@ -131,6 +158,15 @@ PlanBackend::Context::~Context()
     stream_ = nullptr;
   }
 
+  if (output_copy_stream_ != nullptr) {
+    cudaError_t err = cudaStreamDestroy(output_copy_stream_);
+    if (err != cudaSuccess) {
+      LOG_ERROR << "Failed to destroy cuda output copy stream: "
+                << cudaGetErrorString(err);
+    }
+    output_copy_stream_ = nullptr;
+  }
+
   if ((engine_ != nullptr) && (!is_shared_engine_)) {
     engine_->destroy();
     engine_ = nullptr;
@@ -147,7 +183,39 @@ PlanBackend::Context::~Context()
 
 Status
 PlanBackend::CreateExecutionContexts(
-    const std::unordered_map<std::string, std::vector<char>>& models)
+    const std::unordered_map<std::string, std::shared_ptr<MappedFile>>& models)
+{
+  // Pin the plan contents in host memory while the engines are
+  // created so that the weight upload performed by engine
+  // deserialization runs at full transfer bandwidth instead of
+  // through a pageable-memory staging copy. The pinning is transient:
+  // it is undone before returning so that a retained plan does not
+  // hold pinned memory for the lifetime of the model. A plan that
+  // can't be pinned is not an error, its upload just runs from
+  // pageable memory.
+  std::vector<std::shared_ptr<MappedFile>> pinned;
+  for (const auto& pr : models) {
+    Status status = pr.second->Pin();
+    if (status.IsOk()) {
+      pinned.push_back(pr.second);
+    } else {
+      LOG_WARNING << "unable to pin PLAN model '" << pr.first << "' for "
+                  << Name() << ": " << status.Message();
+    }
+  }
+
+  Status status = CreateExecutionContextsHelper(models);
+
+  for (const auto& mapped : pinned) {
+    mapped->Unpin();
+  }
+
+  return status;
+}
+
+Status
+PlanBackend::CreateExecutionContextsHelper(
+    const std::unordered_map<std::string, std::shared_ptr<MappedFile>>& models)
 {
   // TensorRT engine creation is not thread-safe, so multiple creations
   // are serialized with a global lock.
@@ -230,11 +298,8 @@ PlanBackend::CreateExecutionContexts(
         // Create shared engine for the device if haven't tried so.
         auto eit = device_engines_.find(gpu_device);
         if (eit == device_engines_.end()) {
-          eit = device_engines_
-                    .emplace(gpu_device, std::make_pair(nullptr, nullptr))
-                    .first;
+          eit = device_engines_.emplace(gpu_device, nullptr).first;
 
-          // Create a CUDA engine shared by all contexts
           cuerr = cudaSetDevice(gpu_device);
           if (cuerr != cudaSuccess) {
             return Status(
@@ -242,25 +307,62 @@ PlanBackend::CreateExecutionContexts(
                                             ": " + cudaGetErrorString(cuerr));
           }
 
-          RETURN_IF_ERROR(LoadPlan(
-              mn_itr->second, &eit->second.first, &eit->second.second));
-          // Validate whether the engine can be shared
-          bool is_dynamic = false;
-          for (int idx = 0; idx < eit->second.second->getNbBindings(); idx++) {
-            auto dims = eit->second.second->getBindingDimensions(idx);
-            // Detect whether dynamic or not
-            if (ContainsWildcard(dims)) {
-              is_dynamic = true;
-              break;
+          // If another backend already deserialized a byte-identical
+          // plan on this device (e.g. the previous version of this
+          // model during a rolling update) share its engine instead of
+          // keeping a second copy of the weights resident.
+          const std::string key = EngineRegistryKey(
+              gpu_device, mn_itr->second->Data(), mn_itr->second->ByteSize());
+          {
+            std::lock_guard<std::mutex> lock(engine_registry_mu);
+            auto rit = engine_registry.find(key);
+            if (rit != engine_registry.end()) {
+              auto candidate = rit->second.lock();
+              if ((candidate != nullptr) &&
+                  (candidate->plan_->ByteSize() ==
+                   mn_itr->second->ByteSize()) &&
+                  (memcmp(
+                       candidate->plan_->Data(), mn_itr->second->Data(),
+                       mn_itr->second->ByteSize()) == 0)) {
+                eit->second = std::move(candidate);
+              }
             }
           }
-          // Model with dynamic shapes can't share engine, set to engine to
-          // 'nullptr' as hint, but keeping runtime as it can be used repeatedly
-          if (is_dynamic) {
-            if (eit->second.second != nullptr) {
-              eit->second.second->destroy();
-              eit->second.second = nullptr;
+
+          if (eit->second != nullptr) {
+            LOG_INFO << "Sharing CUDA engine of an identical plan already "
+                     << "loaded on GPU " << gpu_device << " for " << Name();
+          } else {
+            // Create a CUDA engine shared by all contexts
+            std::shared_ptr<SharedEngine> shared_engine(new SharedEngine());
+            RETURN_IF_ERROR(LoadPlan(
+                mn_itr->second->Data(), mn_itr->second->ByteSize(),
+                &shared_engine->runtime_, &shared_engine->engine_));
+            // Validate whether the engine can be shared
+            bool is_dynamic = false;
+            for (int idx = 0; idx < shared_engine->engine_->getNbBindings();
+                 idx++) {
+              auto dims = shared_engine->engine_->getBindingDimensions(idx);
+              // Detect whether dynamic or not
+              if (ContainsWildcard(dims)) {
+                is_dynamic = true;
+                break;
+              }
+            }
+            // A dynamic-shape engine is shared only among the
+            // instances of this backend, each claiming disjoint
+            // optimization profiles, so don't publish it in the
+            // cross-backend registry.
+            if (is_dynamic) {
+              shared_engine->is_dynamic_ = true;
+            } else {
+              // Retain the plan so that later lookups can verify that
+              // a matching registry key really is an identical plan.
+              shared_engine->plan_ = mn_itr->second;
+              std::lock_guard<std::mutex> lock(engine_registry_mu);
+              engine_registry[key] = shared_engine;
             }
+            eit->second = std::move(shared_engine);
           }
         }
 
@@ -281,6 +383,27 @@ PlanBackend::CreateExecutionContexts(
       [this](uint32_t runner_idx) -> Status {
         // Obtain any context as the next context for the corresponding runner
         next_context_[runner_idx] = available_context_queue_[runner_idx]->Get();
+
+        // Restrict the runner thread to the NUMA node local to the GPU it
+        // serves so that the buffers it allocates and first touches are
+        // placed on that node. Binding is best effort, failure must not
+        // prevent the model from loading.
+        const int gpu_device =
+            contexts_[next_context_[runner_idx]]->gpu_device_;
+        if (gpu_device != Context::NO_GPU_DEVICE) {
+          int numa_node = -1;
+          auto status = GetNumaNode(gpu_device, &numa_node);
+          if (status.IsOk() && (numa_node >= 0)) {
+            status = BindThreadToNumaNode(numa_node);
+          }
+          if (!status.IsOk()) {
+            LOG_VERBOSE(1) << "unable to bind runner " << runner_idx
+                           << " for " << Name()
+                           << " to the NUMA node of GPU " << gpu_device
+                           << ": " << status.Message();
+          }
+        }
+
         return Status::Success;
       },
       [this](
@@ -394,7 +517,7 @@ PlanBackend::Context::InitOptimizationProfiles(
 Status
 PlanBackend::CreateExecutionContext(
     const std::string& instance_name, const int gpu_device,
-    const std::vector<char>& model,
+    const std::shared_ptr<MappedFile>& model,
     const ::google::protobuf::RepeatedPtrField<std::string>& profile_names,
     const std::shared_ptr<SyncQueue<size_t>>& context_queue)
 {
@@ -425,16 +548,53 @@ PlanBackend::CreateExecutionContext(
   RETURN_IF_ERROR(context->CreateCudaStream(cuda_stream_priority));
   RETURN_IF_ERROR(context->CreateCudaStream(
       cuda_stream_priority, &context->input_copy_stream_));
+  RETURN_IF_ERROR(context->CreateCudaStream(
+      cuda_stream_priority, &context->output_copy_stream_));
 
   // Create CUDA events associated with the execution states
   RETURN_IF_ERROR(context->InitEventSet());
 
   auto eit = device_engines_.find(gpu_device);
-  if (eit->second.second == nullptr) {
-    context->is_shared_engine_ = false;
-    RETURN_IF_ERROR(LoadPlan(model, &eit->second.first, &context->engine_));
+  bool share_engine = (eit->second->engine_ != nullptr);
+  if (share_engine && eit->second->is_dynamic_) {
+    // TensorRT allows an optimization profile to be used by only one
+    // execution context at a time, so instances of a dynamic-shape
+    // model can share the engine, and so the weights, only when each
+    // claims profiles no other instance on the device uses.
+    std::set<int> profile_indexes{0};
+    if (!profile_names.empty()) {
+      profile_indexes.clear();
+      for (const auto& profile_name : profile_names) {
+        int profile_index = 0;
+        RETURN_IF_ERROR(GetProfileIndex(profile_name, &profile_index));
+        profile_indexes.insert(profile_index);
+      }
+    }
+    for (const auto profile_index : profile_indexes) {
+      if (eit->second->claimed_profile_indexes_.find(profile_index) !=
+          eit->second->claimed_profile_indexes_.end()) {
+        share_engine = false;
+        break;
+      }
+    }
+    if (share_engine) {
+      eit->second->claimed_profile_indexes_.insert(
+          profile_indexes.begin(), profile_indexes.end());
+    } else {
+      LOG_WARNING << "Instance " << instance_name << " of " << Name()
+                  << " uses an optimization profile already claimed by "
+                  << "another instance, loading a separate engine. Build "
+                  << "the plan with one optimization profile per instance "
+                  << "to share the weights across instances.";
+    }
+  }
+  if (share_engine) {
+    context->engine_ = eit->second->engine_;
   } else {
-    context->engine_ = eit->second.second;
+    context->is_shared_engine_ = false;
+    RETURN_IF_ERROR(LoadPlan(
+        model->Data(), model->ByteSize(), &eit->second->runtime_,
+        &context->engine_));
   }
 
   RETURN_IF_ERROR(context->InitOptimizationProfiles(profile_names));
@@ -818,10 +978,35 @@ PlanBackend::Context::InitializeShapeInputBinding(
   return Status::Success;
 }
 
+template <typename TDims>
+int64_t
+PlanBackend::Context::AdjustByteSizeForFormat(
+    const int binding_index, const int64_t byte_size, const TDims& dims,
+    const int dims_offset) const
+{
+  const int vectorized_dim = engine_->getBindingVectorizedDim(binding_index);
+  if ((vectorized_dim < 0) || (byte_size <= 0)) {
+    return byte_size;
+  }
+
+  const int64_t vector_width =
+      engine_->getBindingComponentsPerElement(binding_index);
+  const int dim_idx = vectorized_dim + dims_offset;
+  if ((dim_idx < 0) || (dim_idx >= (int)dims.size()) ||
+      (dims[dim_idx] <= 0) || (vector_width <= 0)) {
+    return byte_size;
+  }
+
+  const int64_t padded_dim =
+      ((dims[dim_idx] + vector_width - 1) / vector_width) * vector_width;
+  return byte_size / dims[dim_idx] * padded_dim;
+}
+
 Status
 PlanBackend::Context::InitializeExecuteInputBinding(
     const std::string& input_name, const DataType input_datatype,
-    const DimsList& model_config_dims, const bool is_control)
+    const DimsList& model_config_dims, const bool is_control,
+    const TensorMemoryFormat memory_format)
 {
   // the maximum byte sizes across all profiles
   int64_t max_byte_size = 0;
@@ -867,12 +1052,13 @@ PlanBackend::Context::InitializeExecuteInputBinding(
 
     MemoryFormat fmt =
         ConvertTrtFmtToFmt(engine_->getBindingFormat(binding_index));
-    if (fmt != MemoryFormat::LINEAR) {
+    if (fmt != ConvertConfigFmtToFmt(memory_format)) {
       return Status(
           Status::Code::INVALID_ARG,
           "unexpected tensor format " + MemoryFormat_Name(fmt) +
               " for input '" + input_name +
-              "'. Only LINEAR memory format is supported at present.");
+              "'. Vectorized formats must be declared with 'memory_format' "
+              "in the model configuration.");
     }
 
     nvinfer1::Dims engine_dims = engine_->getBindingDimensions(binding_index);
@@ -914,7 +1100,11 @@ PlanBackend::Context::InitializeExecuteInputBinding(
     int64_t byte_size = 0;
     std::vector<int64_t> maximum_dims;
     if (!is_dynamic_) {
-      byte_size = GetByteSize(max_batch_size_, dt, model_config_dims);
+      byte_size = AdjustByteSizeForFormat(
+          binding_index, GetByteSize(max_batch_size_, dt, model_config_dims),
+          model_config_dims,
+          (engine_->hasImplicitBatchDimension() || !support_batching_) ? 0
+                                                                       : -1);
     } else {
       context.max_dims_[io_index] = engine_->getProfileDimensions(
           binding_index, profile_index, nvinfer1::OptProfileSelector::kMAX);
@@ -936,7 +1126,9 @@ PlanBackend::Context::InitializeExecuteInputBinding(
       RETURN_IF_ERROR(MaximumDims(
           context.max_dims_[io_index], model_config_dims, support_batching_,
           max_batch_size_, &maximum_dims));
-      byte_size = GetByteSize(dt, maximum_dims);
+      byte_size = AdjustByteSizeForFormat(
+          binding_index, GetByteSize(dt, maximum_dims), maximum_dims,
+          0 /* dims_offset */);
       // Update the maximum dimension with respect to the allocated buffer
       DimVecToDims(maximum_dims, &context.max_dims_[io_index]);
 
@@ -1059,7 +1251,8 @@ PlanBackend::Context::InitializeConfigExecuteInputBindings(
     const DimsList& model_config_dims =
         (io.has_reshape()) ? io.reshape().shape() : io.dims();
     RETURN_IF_ERROR(InitializeExecuteInputBinding(
-        io.name(), io.data_type(), model_config_dims));
+        io.name(), io.data_type(), model_config_dims, false /* is_control */,
+        io.memory_format()));
   }
 
   return Status::Success;
@@ -1228,12 +1421,13 @@ PlanBackend::Context::InitializeConfigExecuteOutputBindings(
 
       MemoryFormat fmt =
           ConvertTrtFmtToFmt(engine_->getBindingFormat(binding_index));
-      if (fmt != MemoryFormat::LINEAR) {
+      if (fmt != ConvertConfigFmtToFmt(io.memory_format())) {
         return Status(
             Status::Code::INVALID_ARG,
             "unexpected tensor format " + MemoryFormat_Name(fmt) +
                 " for output '" + io.name() +
-                "'. Only LINEAR memory format is supported at present.");
+                "'. Vectorized formats must be declared with 'memory_format' "
+                "in the model configuration.");
       }
 
       const DimsList& model_config_dims =
@@ -1261,13 +1455,19 @@ PlanBackend::Context::InitializeConfigExecuteOutputBindings(
 
       int64_t byte_size;
       if (!is_dynamic_) {
-        byte_size = GetByteSize(max_batch_size_, dt, model_config_dims);
+        byte_size = AdjustByteSizeForFormat(
+            binding_index, GetByteSize(max_batch_size_, dt, model_config_dims),
+            model_config_dims,
+            (engine_->hasImplicitBatchDimension() || !support_batching_) ? 0
+                                                                         : -1);
       } else {
         const nvinfer1::Dims output_dim =
             context.context_->getBindingDimensions(binding_index);
         std::vector<int64_t> dim_vec;
         DimsToDimVec(output_dim, &dim_vec);
-        byte_size = GetByteSize(dt, dim_vec);
+        byte_size = AdjustByteSizeForFormat(
+            binding_index, GetByteSize(dt, dim_vec), dim_vec,
+            0 /* dims_offset */);
       }
 
       if (byte_size == -1) {
@@ -1309,6 +1509,16 @@ PlanBackend::Context::PeekShapeTensor(
     const InferenceRequest::Input& input, const Scheduler::Payload& payload,
     std::vector<int64_t>* shape)
 {
+  // If the value was peeked on the frontend thread when the request
+  // was admitted then use it and avoid reading the tensor contents
+  // here.
+  const std::vector<int64_t>* peeked =
+      payload.request_->PeekedShapeTensor(input.Name());
+  if (peeked != nullptr) {
+    *shape = *peeked;
+    return Status::Success;
+  }
+
   // It is the caller's responsibility to only call on shape tensors,
   // which means the datatype must be INT32.
   int64_t element_cnt = GetElementCount(input.Shape());
@@ -1422,23 +1632,26 @@ PlanBackend::Context::BuildCudaGraph(
 }
 #endif
 
+PlanBackend::SharedEngine::~SharedEngine()
+{
+  if (engine_ != nullptr) {
+    engine_->destroy();
+    engine_ = nullptr;
+  }
+  if (runtime_ != nullptr) {
+    runtime_->destroy();
+    runtime_ = nullptr;
+  }
+}
+
 PlanBackend::~PlanBackend()
 {
   // Must destory all TensorRT contexts before engine
   contexts_.clear();
 
-  for (auto& device_engine : device_engines_) {
-    auto& runtime = device_engine.second.first;
-    auto& engine = device_engine.second.second;
-    if (engine != nullptr) {
-      engine->destroy();
-      engine = nullptr;
-    }
-    if (runtime != nullptr) {
-      runtime->destroy();
-      runtime = nullptr;
-    }
-  }
+  // An engine and its runtime are destroyed when the last backend
+  // sharing them releases its reference.
+  device_engines_.clear();
 }
 
 void
@@ -1712,7 +1925,9 @@ PlanBackend::Context::Run(
       DataType dt =
           ConvertTrtTypeToDataType(engine_->getBindingDataType(io_index));
 
-      batch1_byte_size = GetByteSize(dt, shape);
+      batch1_byte_size = AdjustByteSizeForFormat(
+          io_index, GetByteSize(dt, shape), shape,
+          (max_batch_size_ != 0) ? -1 : 0);
       if (max_batch_size_ != 0) {
         // The first element of the vector will be the batch size and should not
         // be included in the batch1_byte_size computation above.
@@ -1805,14 +2020,23 @@ PlanBackend::Context::Run(
 
   cudaEventRecord(events_[next_set_].input_ready_, input_copy_stream_);
 
-  // Ensure inputs are ready before execution. Output buffers will always be
-  // available at this point as the execution and output copy are on the same
-  // stream.
+  // Ensure inputs are ready before execution.
   cudaStreamWaitEvent(stream_, events_[next_set_].input_ready_, 0);
 
+  // The execution overwrites the output buffers, so it must also wait
+  // for the previous batch's output copies which run concurrently on
+  // 'output_copy_stream_'. Waiting on a never-recorded event (the
+  // first run) is a no-op.
+  const size_t prev_set = (next_set_ + EVENT_SET_COUNT - 1) % EVENT_SET_COUNT;
+  cudaStreamWaitEvent(stream_, events_[prev_set].output_ready_, 0);
+
   // Async execute the inference using a CUDA graph if available for
-  // the batch-size, otherwise execution normally.
-  auto itr = citr->second.cuda_graph_execs_.find(total_batch_size);
+  // the batch-size, otherwise execution normally. A batch that
+  // doesn't exactly match a captured graph replays the next largest
+  // captured graph: each request in an implicit-batch engine is
+  // computed independently and only 'total_batch_size' results are
+  // copied out, so the padded portion of the batch is ignored.
+  auto itr = citr->second.cuda_graph_execs_.lower_bound(total_batch_size);
   if (itr != citr->second.cuda_graph_execs_.end()) {
     cudaError_t err = cudaGraphLaunch(itr->second, stream_);
     if (err != cudaSuccess) {
@@ -1862,9 +2086,25 @@ PlanBackend::Context::Run(
 
   cudaEventRecord(events_[next_set_].ready_for_output_, stream_);
 
+  // Issue the output copies on 'output_copy_stream_', ordered after
+  // the execution, so that they overlap with the execution of the
+  // next batch issued on 'stream_'.
+  cudaStreamWaitEvent(
+      output_copy_stream_, events_[next_set_].ready_for_output_, 0);
+
   // For each requested output verify that the output can accept the
   // actual model output and then copy that output from the GPU
   bool cuda_copy = false;
+
+  // True if any payload's response provider consumes outputs
+  // incrementally, in which case an event is recorded after each
+  // output binding's copy so the completion thread can report an
+  // output as soon as its own copy finishes.
+  bool output_streaming = false;
+  for (const auto& payload : *payloads) {
+    output_streaming |= (payload.response_provider_ != nullptr) &&
+                        payload.response_provider_->OutputStreamingEnabled();
+  }
   for (int bindex = 0; bindex < num_expected_bindings_; ++bindex) {
     int io_index = binding_offset + bindex;
     if (engine_->bindingIsInput(io_index)) {
@@ -1884,10 +2124,13 @@ PlanBackend::Context::Run(
     }
 
     if (engine_->isShapeBinding(io_index)) {
-      // Obtain the shape value
+      // Obtain the shape value. 'shape_value_scratch_' is reused
+      // across executions to avoid a malloc/free on every run.
       if (dims.nbDims != 0) {
-        int32_t* shape_value_ptr =
-            (int32_t*)malloc(dims.d[0] * sizeof(int32_t));
+        if (shape_value_scratch_.size() < (size_t)dims.d[0]) {
+          shape_value_scratch_.resize(dims.d[0]);
+        }
+        int32_t* shape_value_ptr = shape_value_scratch_.data();
         if (!citr->second.context_->getShapeBinding(
                 io_index, shape_value_ptr)) {
           return Status(
@@ -1917,9 +2160,7 @@ PlanBackend::Context::Run(
 
         cuda_copy |= SetOutputShapeTensorBuffer(
             name, shape_value_ptr, content_shape, support_batching_,
-            TRTSERVER_MEMORY_CPU, 0, payloads);
-
-        free(shape_value_ptr);
+            TRTSERVER_MEMORY_CPU, 0, payloads, output_copy_stream_);
       }
     } else {
       output.output_buffer_ = static_cast<const char*>(buffers_[bindex]);
@@ -1938,7 +2179,10 @@ PlanBackend::Context::Run(
       DataType dt = ConvertTrtTypeToDataType(
           engine_->getBindingDataType(binding_offset + bindex));
 
-      size_t batch1_byte_size = GetByteSize(dt, output.output_shape_);
+      size_t batch1_byte_size = AdjustByteSizeForFormat(
+          binding_offset + bindex, GetByteSize(dt, output.output_shape_),
+          output.output_shape_,
+          (!is_dynamic_ && support_batching_) ? 1 : 0);
       if (support_batching_) {
         batch1_byte_size /= total_batch_size;
       }
@@ -1952,12 +2196,38 @@ PlanBackend::Context::Run(
                 std::to_string(batch1_byte_size));
       }
 
-      cuda_copy |=
-          SetFixedSizeOutputBuffer(name, batch1_byte_size, &output, payloads);
+      cuda_copy |= SetFixedSizeOutputBuffer(
+          name, batch1_byte_size, &output, payloads, output_copy_stream_);
+
+      // Record an event after this output's copy so the completion
+      // thread can report it complete without waiting for the
+      // remaining outputs. An output staged through an indirect
+      // buffer is only complete after the indirect copies and so is
+      // never reported early.
+      if (output_streaming && output.indirect_buffers_.empty()) {
+        output.name_ = name;
+        auto& binding_events = events_[next_set_].binding_ready_;
+        if (binding_events.size() <= (size_t)bindex) {
+          binding_events.resize(bindex + 1, nullptr);
+        }
+        if (binding_events[bindex] == nullptr) {
+          Status status = CreateCudaEvent(
+              "binding " + std::to_string(bindex) + " output ready",
+              &binding_events[bindex]);
+          if (!status.IsOk()) {
+            LOG_WARNING << status.Message();
+            binding_events[bindex] = nullptr;
+          }
+        }
+        if (binding_events[bindex] != nullptr) {
+          cudaEventRecord(binding_events[bindex], output_copy_stream_);
+          output.ready_event_ = binding_events[bindex];
+        }
+      }
     }
   }
 
-  cudaEventRecord(events_[next_set_].output_ready_, stream_);
+  cudaEventRecord(events_[next_set_].output_ready_, output_copy_stream_);
 
   return Status::Success;
 }
@@ -2003,6 +2273,23 @@ PlanBackend::Context::ProcessResponse(
     }
 #endif  // TRTIS_ENABLE_STATS
 
+    // Report each output with its own copy event as soon as that copy
+    // completes, so a provider consuming outputs incrementally sees a
+    // large output before the remaining output copies finish. The
+    // events were recorded in binding order, matching the order the
+    // copies were issued on the copy stream.
+    for (const auto& output : *(std::get<3>(OnCompleteMetaData))) {
+      if (output.ready_event_ != nullptr) {
+        cudaEventSynchronize(static_cast<cudaEvent_t>(output.ready_event_));
+        for (auto& payload : *payloads) {
+          if (payload.status_.IsOk() &&
+              (payload.response_provider_ != nullptr)) {
+            payload.response_provider_->OutputReady(output.name_);
+          }
+        }
+      }
+    }
+
     cudaEventSynchronize(event_set.output_ready_);
     NVTX_MARKER("plan_output_ready");
     // Issue the last steps here if outputs are placed in indirect buffer
@@ -2091,6 +2378,12 @@ PlanBackend::Context::DestroyEventSet()
     if (events_[idx].output_ready_ != nullptr) {
       cudaEventDestroy(events_[idx].output_ready_);
     }
+    for (auto& event : events_[idx].binding_ready_) {
+      if (event != nullptr) {
+        cudaEventDestroy(event);
+      }
+    }
+    events_[idx].binding_ready_.clear();
   }
   return Status::Success;
 }
@@ -2138,19 +2431,27 @@ PlanBackend::Context::GetMostOptimizedProfile(
   // [TODO] traverse it with more efficient data structure (i.e. K-D tree)
   auto ret_it = trt_contexts_.begin();
   if (trt_contexts_.size() != 1) {
+    // The binding index for an input and whether it is dynamic don't
+    // depend on the profile, so resolve them once instead of once per
+    // profile. An input with no dynamic shape that is not a shape
+    // binding contributes zero distance to every profile and is
+    // dropped entirely.
+    std::vector<std::pair<const InferenceRequest::Input*, int>> dynamic_inputs;
+    for (const auto& pr : input_request.ImmutableInputs()) {
+      const auto input = pr.second;
+      const int io_index = engine_->getBindingIndex(input->Name().c_str());
+      const nvinfer1::Dims engine_dims = engine_->getBindingDimensions(io_index);
+      if (ContainsWildcard(engine_dims) || engine_->isShapeBinding(io_index)) {
+        dynamic_inputs.emplace_back(input, io_index);
+      }
+    }
+
     int64_t shortest_distance = LLONG_MAX;
     for (auto cit = trt_contexts_.begin(); cit != trt_contexts_.end(); cit++) {
       int64_t current_distance = 0;
-      for (const auto& pr : input_request.ImmutableInputs()) {
-        const auto input = pr.second;
-        int io_index = engine_->getBindingIndex(input->Name().c_str());
-        nvinfer1::Dims engine_dims = engine_->getBindingDimensions(io_index);
-        // If the input has no dynamic shape nor is a shape binding, then skip
-        // it as distance will be 0
-        if (!(ContainsWildcard(engine_dims) ||
-              engine_->isShapeBinding(io_index))) {
-          continue;
-        }
+      for (const auto& pr : dynamic_inputs) {
+        const auto input = pr.first;
+        const int io_index = pr.second;
         auto status = ValidateDimension(
             input->Shape(), cit->second.min_dims_[io_index],
             cit->second.max_dims_[io_index], true);
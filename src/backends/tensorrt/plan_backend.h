@@ -27,9 +27,11 @@
 
 #include <NvInfer.h>
 #include <cuda_runtime_api.h>
+#include <set>
 #include <thread>
 #include "src/core/backend.h"
 #include "src/core/backend_context.h"
+#include "src/core/filesystem.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
@@ -54,13 +56,52 @@ class PlanBackend : public InferenceBackend {
       uint32_t runner_idx, const WarmupData& sample,
       std::function<void(Status)> OnCompleteWarmup) override;
 
+  // A CUDA engine and the runtime that created it. An engine is
+  // shared across all instances on a device so that adding an
+  // instance costs only the activation memory of its execution
+  // contexts, not another copy of the weights. An engine for a model
+  // without dynamic shape is additionally shared, when the serialized
+  // plans are byte-identical, across backends; during a rolling
+  // version update this keeps one copy of the weights resident per
+  // device instead of one per version. The engine and runtime are
+  // destroyed when the last backend using them is destroyed.
+  struct SharedEngine {
+    ~SharedEngine();
+
+    nvinfer1::IRuntime* runtime_ = nullptr;
+    nvinfer1::ICudaEngine* engine_ = nullptr;
+
+    // True if the engine uses dynamic shapes. TensorRT allows an
+    // optimization profile to be used by only one execution context
+    // at a time, so a dynamic-shape engine is shared only among
+    // instances of this backend that claim disjoint profiles, and is
+    // never published in the cross-backend registry.
+    bool is_dynamic_ = false;
+
+    // The optimization profile indexes claimed by instances sharing
+    // the engine. Used only when 'is_dynamic_' is true.
+    std::set<int> claimed_profile_indexes_;
+
+    // The serialized plan the engine was created from, retained so
+    // that a backend looking for an engine to share can verify that
+    // its plan really is byte-identical.
+    std::shared_ptr<MappedFile> plan_;
+  };
+
   // Create a context for execution for each instance for the
-  // serialized plans specified in 'models'.
+  // serialized plans specified in 'models'. The plan contents are
+  // pinned in host memory for the duration of context creation so
+  // that engine deserialization uploads the weights at full transfer
+  // bandwidth.
   Status CreateExecutionContexts(
-      const std::unordered_map<std::string, std::vector<char>>& models);
+      const std::unordered_map<std::string, std::shared_ptr<MappedFile>>&
+          models);
+  Status CreateExecutionContextsHelper(
+      const std::unordered_map<std::string, std::shared_ptr<MappedFile>>&
+          models);
   Status CreateExecutionContext(
       const std::string& instance_name, const int gpu_device,
-      const std::vector<char>& models,
+      const std::shared_ptr<MappedFile>& model,
       const ::google::protobuf::RepeatedPtrField<std::string>& profile_names,
       const std::shared_ptr<SyncQueue<size_t>>& context_queue);
 
@@ -93,7 +134,8 @@ class PlanBackend : public InferenceBackend {
 
     Status InitializeExecuteInputBinding(
         const std::string& input_name, const DataType input_datatype,
-        const DimsList& input_dims, const bool is_control = false);
+        const DimsList& input_dims, const bool is_control = false,
+        const TensorMemoryFormat memory_format = MEMORY_FORMAT_LINEAR);
     Status InitializeShapeInputBinding(
         const std::string& input_name, const DataType input_datatype,
         const DimsList& input_dims);
@@ -111,6 +153,17 @@ class PlanBackend : public InferenceBackend {
     Status InitOptimizationProfiles(
         const ::google::protobuf::RepeatedPtrField<std::string>& profile_names);
 
+    // Pad a linear byte size for a vectorized binding format. 'dims'
+    // holds the shape used to compute 'byte_size' and 'dims_offset' is
+    // added to the engine's vectorized dimension index to locate the
+    // vectorized dimension within 'dims' (e.g. -1 when 'dims' excludes
+    // an implicit batch dimension). Returns 'byte_size' unchanged for
+    // linear bindings.
+    template <typename TDims>
+    int64_t AdjustByteSizeForFormat(
+        const int binding_index, const int64_t byte_size, const TDims& dims,
+        const int dims_offset) const;
+
     // See BackendContext::Run()
     Status Run(
         const InferenceBackend* base,
@@ -139,9 +192,11 @@ class PlanBackend : public InferenceBackend {
       nvinfer1::IExecutionContext* context_;
 
       // The CUDA graphs captured for the model for different
-      // batch-sizes.
-      std::unordered_map<int, cudaGraph_t> cuda_graphs_;
-      std::unordered_map<int, cudaGraphExec_t> cuda_graph_execs_;
+      // batch-sizes. Kept ordered by batch-size so that a request
+      // batch that doesn't exactly match a captured graph can be
+      // rounded up to the next largest captured graph.
+      std::map<int, cudaGraph_t> cuda_graphs_;
+      std::map<int, cudaGraphExec_t> cuda_graph_execs_;
 
       // Min Dimensions per bindings
       std::vector<nvinfer1::Dims> min_dims_;
@@ -175,6 +230,13 @@ class PlanBackend : public InferenceBackend {
       // CUDA event for capturing correct timestamp.
       cudaEvent_t ready_for_output_;
       cudaEvent_t output_ready_;
+
+      // Per-binding events recorded after each output binding's copy,
+      // so the completion thread can report an output as complete
+      // before the remaining output copies finish. Created lazily,
+      // only when a response provider consumes outputs incrementally,
+      // and indexed by binding index.
+      std::vector<cudaEvent_t> binding_ready_;
     };
 
     // Number of CUDA event set for each instance.
@@ -190,17 +252,22 @@ class PlanBackend : public InferenceBackend {
         size_t total_batch_size, const InferenceRequest& input_request,
         const std::map<int, std::vector<int32_t>>& request_shape_values);
 
-    // The engine used for the context. If the model uses dynamic shape, then
-    // the CUDA engine is owned by the context. Otherwise, the engine is shared
-    // across all contexts and it must not be destroyed by the contexts.
-    // In the future version of TensorRT, the engine may be shared even in the
-    // dynamic shape case.
+    // The engine used for the context. Normally the engine is shared
+    // across all contexts on the device and must not be destroyed by
+    // the contexts. A dynamic-shape model whose instances contend for
+    // the same optimization profile falls back to a per-context
+    // engine owned by the context.
     nvinfer1::ICudaEngine* engine_;
     bool is_shared_engine_;
 
     // Additional CUDA stream to overlap copy and execution.
     cudaStream_t input_copy_stream_;
 
+    // Additional CUDA stream for D2H output copies so that the output
+    // copy of one batch overlaps the execution of the next batch on
+    // 'stream_'. Ordered after the execution by 'ready_for_output_'.
+    cudaStream_t output_copy_stream_;
+
     // Use two sets of events each for current request and next request.
     CUDAEventSet events_[EVENT_SET_COUNT];
     size_t next_set_;
@@ -249,11 +316,15 @@ class PlanBackend : public InferenceBackend {
 
     std::vector<InputInfo> inputs_;
     std::vector<OutputInfo> outputs_;
+
+    // Scratch buffer for reading back output shape-binding values,
+    // reused across executions.
+    std::vector<int32_t> shape_value_scratch_;
   };
 
-  // CUDA engine shared across all model instances on the same device.
-  std::map<int, std::pair<nvinfer1::IRuntime*, nvinfer1::ICudaEngine*>>
-      device_engines_;
+  // CUDA engine shared across all model instances on the same device,
+  // and possibly with other backends that loaded an identical plan.
+  std::map<int, std::shared_ptr<SharedEngine>> device_engines_;
 
   // vector for storing available context queue associated with a runner
   std::vector<std::shared_ptr<SyncQueue<size_t>>> available_context_queue_;
@@ -76,12 +76,15 @@ PlanBackendFactory::CreateBackend(
   RETURN_IF_ERROR(
       GetDirectoryFiles(path, true /* skip_hidden_files */, &plan_files));
 
-  std::unordered_map<std::string, std::vector<char>> models;
+  std::unordered_map<std::string, std::shared_ptr<MappedFile>> models;
   for (const auto& filename : plan_files) {
     const auto plan_path = JoinPath({path, filename});
-    std::string model_data_str;
-    RETURN_IF_ERROR(ReadTextFile(plan_path, &model_data_str));
-    std::vector<char> model_data(model_data_str.begin(), model_data_str.end());
+    std::shared_ptr<MappedFile> model_data;
+    // Prefer pinned host memory for the plan contents so that engine
+    // deserialization uploads weights over DMA directly from the read
+    // destination.
+    RETURN_IF_ERROR(
+        MapFile(plan_path, true /* pinned_memory_preferred */, &model_data));
     models.emplace(filename, std::move(model_data));
   }
 
@@ -68,6 +68,29 @@ ConvertTrtFmtToFmt(nvinfer1::TensorFormat trt_fmt)
   return MemoryFormat::INVALID;
 }
 
+MemoryFormat
+ConvertConfigFmtToFmt(TensorMemoryFormat config_fmt)
+{
+  switch (config_fmt) {
+    case MEMORY_FORMAT_LINEAR:
+      return MemoryFormat::LINEAR;
+    case MEMORY_FORMAT_CHW2:
+      return MemoryFormat::CHW2;
+    case MEMORY_FORMAT_CHW4:
+      return MemoryFormat::CHW4;
+    case MEMORY_FORMAT_HWC8:
+      return MemoryFormat::HCW8;
+    case MEMORY_FORMAT_CHW16:
+      return MemoryFormat::CHW16;
+    case MEMORY_FORMAT_CHW32:
+      return MemoryFormat::CHW32;
+    default:
+      break;
+  }
+
+  return MemoryFormat::INVALID;
+}
+
 const std::string
 MemoryFormat_Name(MemoryFormat fmt)
 {
@@ -52,6 +52,8 @@ enum class MemoryFormat {
 
 MemoryFormat ConvertTrtFmtToFmt(nvinfer1::TensorFormat trt_fmt);
 
+MemoryFormat ConvertConfigFmtToFmt(TensorMemoryFormat config_fmt);
+
 const std::string MemoryFormat_Name(MemoryFormat fmt);
 
 DataType ConvertTrtTypeToDataType(nvinfer1::DataType trt_type);
@@ -375,6 +375,183 @@ RunAsyncConcurrent(
   sem_destroy(sem);
 }
 
+void
+CreateStatusContext(
+    const std::string& protocol, const std::string& url,
+    const std::string& model_name, const bool verbose,
+    std::unique_ptr<nic::ServerStatusContext>* ctx)
+{
+  nic::Error err;
+  if (protocol == "http") {
+    err = nic::ServerStatusHttpContext::Create(ctx, url, model_name, verbose);
+  } else {
+    err = nic::ServerStatusGrpcContext::Create(ctx, url, model_name, verbose);
+  }
+
+  FAIL_IF_ERR(err, "unable to create status context");
+}
+
+// Server-side deltas between two status snapshots for the model being
+// benchmarked.
+struct ServerSideDelta {
+  uint64_t count{0};
+  uint64_t total_ns{0};
+  uint64_t queue_ns{0};
+  uint64_t compute_ns{0};
+};
+
+void
+SummarizeModelStats(
+    const ni::ServerStatus& start_status, const ni::ServerStatus& end_status,
+    const std::string& model_name, const uint32_t batch_size,
+    ServerSideDelta* delta)
+{
+  const auto& end_model_itr = end_status.model_status().find(model_name);
+  FAIL_IF(
+      end_model_itr == end_status.model_status().end(),
+      "unable to find status for model " + model_name);
+
+  // Use the latest (highest valued) version, matching the -1 version
+  // the inference context requests.
+  int64_t model_version = 0;
+  for (const auto& vp : end_model_itr->second.version_status()) {
+    model_version = std::max(model_version, vp.first);
+  }
+
+  const auto& vend_itr =
+      end_model_itr->second.version_status().find(model_version);
+  FAIL_IF(
+      vend_itr == end_model_itr->second.version_status().end(),
+      "missing model version status");
+  const auto& end_itr = vend_itr->second.infer_stats().find(batch_size);
+  FAIL_IF(
+      end_itr == vend_itr->second.infer_stats().end(),
+      "missing inference stats");
+
+  uint64_t start_cnt = 0;
+  uint64_t start_total_ns = 0;
+  uint64_t start_queue_ns = 0;
+  uint64_t start_compute_ns = 0;
+
+  const auto& start_model_itr = start_status.model_status().find(model_name);
+  if (start_model_itr != start_status.model_status().end()) {
+    const auto& vstart_itr =
+        start_model_itr->second.version_status().find(model_version);
+    if (vstart_itr != start_model_itr->second.version_status().end()) {
+      const auto& start_itr =
+          vstart_itr->second.infer_stats().find(batch_size);
+      if (start_itr != vstart_itr->second.infer_stats().end()) {
+        start_cnt = start_itr->second.success().count();
+        start_total_ns = start_itr->second.success().total_time_ns();
+        start_queue_ns = start_itr->second.queue().total_time_ns();
+        start_compute_ns = start_itr->second.compute().total_time_ns();
+      }
+    }
+  }
+
+  delta->count = end_itr->second.success().count() - start_cnt;
+  delta->total_ns = end_itr->second.success().total_time_ns() - start_total_ns;
+  delta->queue_ns = end_itr->second.queue().total_time_ns() - start_queue_ns;
+  delta->compute_ns =
+      end_itr->second.compute().total_time_ns() - start_compute_ns;
+}
+
+// Measure the per-request endpoint overhead, separated into client
+// serialize/send, server (queue + compute + frontend) and receive
+// components, with the wire and frontend remainder derived from the
+// totals. A single context is created up front so the connection is
+// warmed and connect cost is excluded: the reported numbers are the
+// steady-state overhead of the endpoint, independent of model
+// compute. All timestamps come from CLOCK_MONOTONIC, which is
+// vDSO-backed and cheap relative to the round-trips being measured.
+void
+RunBreakdown(
+    const InferContextFactory& factory, const std::string& protocol,
+    const std::string& url, const std::string& model_name,
+    const std::string& benchmark_name, const std::string& framework,
+    const uint32_t batch_size, const uint32_t tensor_size,
+    const uint32_t warmup_iters, const uint32_t measure_iters,
+    const bool verbose)
+{
+  std::unique_ptr<nic::InferContext> ctx;
+  factory.Create(&ctx);
+
+  uint64_t ignored_ns;
+  RunSyncSerial(
+      ctx.get(), warmup_iters, 0, warmup_iters - 1, &ignored_ns,
+      nullptr /* request_duration_ns */);
+
+  std::unique_ptr<nic::ServerStatusContext> status_ctx;
+  CreateStatusContext(protocol, url, model_name, verbose, &status_ctx);
+
+  nic::InferContext::Stat start_stat;
+  FAIL_IF_ERR(ctx->GetStat(&start_stat), "unable to get start stat");
+  ni::ServerStatus start_status;
+  FAIL_IF_ERR(
+      status_ctx->GetServerStatus(&start_status),
+      "unable to get start server status");
+
+  uint64_t total_duration_ns;
+  std::vector<uint64_t> request_duration_ns;
+  RunSyncSerial(
+      ctx.get(), measure_iters, 0, measure_iters - 1, &total_duration_ns,
+      &request_duration_ns);
+
+  nic::InferContext::Stat end_stat;
+  FAIL_IF_ERR(ctx->GetStat(&end_stat), "unable to get end stat");
+  ni::ServerStatus end_status;
+  FAIL_IF_ERR(
+      status_ctx->GetServerStatus(&end_status),
+      "unable to get end server status");
+
+  const uint64_t completed =
+      end_stat.completed_request_count - start_stat.completed_request_count;
+  FAIL_IF(completed == 0, "no requests completed in measurement window");
+
+  const uint64_t total_us = (end_stat.cumulative_total_request_time_ns -
+                             start_stat.cumulative_total_request_time_ns) /
+                            1000 / completed;
+  const uint64_t send_us = (end_stat.cumulative_send_time_ns -
+                            start_stat.cumulative_send_time_ns) /
+                           1000 / completed;
+  const uint64_t receive_us = (end_stat.cumulative_receive_time_ns -
+                               start_stat.cumulative_receive_time_ns) /
+                              1000 / completed;
+
+  ServerSideDelta delta;
+  SummarizeModelStats(start_status, end_status, model_name, batch_size, &delta);
+  FAIL_IF(delta.count == 0, "no server-side requests in measurement window");
+
+  const uint64_t server_total_us = delta.total_ns / 1000 / delta.count;
+  const uint64_t server_queue_us = delta.queue_ns / 1000 / delta.count;
+  const uint64_t server_compute_us = delta.compute_ns / 1000 / delta.count;
+
+  // What remains after removing the client-side send/receive and the
+  // entire server-side handling is the wire plus the protocol
+  // frontend: the number that should stay stable release over
+  // release for a fixed minimal tensor.
+  const uint64_t sum_us = send_us + receive_us + server_total_us;
+  const uint64_t overhead_us = (total_us > sum_us) ? (total_us - sum_us) : 0;
+
+  std::cout << "{\"s_benchmark_kind\":\"simple_perf_breakdown\",";
+  std::cout << "\"s_benchmark_name\":\"" << benchmark_name << "\",";
+  std::cout << "\"s_protocol\":\"" << protocol << "\",";
+  std::cout << "\"s_framework\":\"" << framework << "\",";
+  std::cout << "\"s_model\":\"" << model_name << "\",";
+  std::cout << "\"l_batch_size\":" << batch_size << ",";
+  std::cout << "\"l_iters\":" << measure_iters << ",";
+  std::cout << "\"l_size\":" << tensor_size << ",";
+  std::cout << "\"d_latency_avg_ms\":" << (total_us / 1000.0) << ",";
+  std::cout << "\"d_send_avg_ms\":" << (send_us / 1000.0) << ",";
+  std::cout << "\"d_receive_avg_ms\":" << (receive_us / 1000.0) << ",";
+  std::cout << "\"d_server_avg_ms\":" << (server_total_us / 1000.0) << ",";
+  std::cout << "\"d_server_queue_avg_ms\":" << (server_queue_us / 1000.0)
+            << ",";
+  std::cout << "\"d_server_compute_avg_ms\":" << (server_compute_us / 1000.0)
+            << ",";
+  std::cout << "\"d_wire_frontend_avg_ms\":" << (overhead_us / 1000.0) << "}";
+}
+
 // Return stddev of ns values. Returned value is in
 // microseconds. Optionally return the mean in microseconds in
 // 'r_mean_us'.
@@ -462,10 +639,19 @@ Usage(char** argv, const std::string& msg = std::string())
   std::cerr << "\t-w <warmup iterations>" << std::endl;
   std::cerr << "\t-n <measurement iterations>" << std::endl;
   std::cerr << "\t-a" << std::endl;
+  std::cerr << "\t-b" << std::endl;
   std::cerr << std::endl;
   std::cerr
       << "For -i, available protocols are 'grpc' and 'http'. Default is 'http."
       << std::endl;
+  std::cerr << "For -u with the 'grpc' protocol, the URL may name a Unix "
+               "domain socket, e.g. unix:///tmp/trtis.sock."
+            << std::endl;
+  std::cerr
+      << "For -b, measure the per-request endpoint overhead over a warmed "
+         "connection and report it broken into send, receive, server and "
+         "wire/frontend components. Concurrency is fixed at 1."
+      << std::endl;
   std::cerr
       << "For -s, specify the input size in fp32 elements. So a value of 8 "
          "indicates that input will be a tensor of 8 fp32 elements. Output "
@@ -482,6 +668,7 @@ main(int argc, char** argv)
 {
   bool verbose = false;
   bool async = false;
+  bool breakdown = false;
   std::string benchmark_name;
   std::string protocol = "http";
   std::string url("localhost:8000");
@@ -496,7 +683,7 @@ main(int argc, char** argv)
 
   // Parse commandline...
   int opt;
-  while ((opt = getopt(argc, argv, "avl:i:u:m:f:c:d:x:s:w:n:")) != -1) {
+  while ((opt = getopt(argc, argv, "abvl:i:u:m:f:c:d:x:s:w:n:")) != -1) {
     switch (opt) {
       case 'v':
         verbose = true;
@@ -504,6 +691,9 @@ main(int argc, char** argv)
       case 'a':
         async = true;
         break;
+      case 'b':
+        breakdown = true;
+        break;
       case 'l':
         benchmark_name = optarg;
         break;
@@ -556,6 +746,13 @@ main(int argc, char** argv)
   InferContextFactory factory(
       protocol, url, model_name, batch_size, tensor_size, verbose);
 
+  if (breakdown) {
+    RunBreakdown(
+        factory, protocol, url, model_name, benchmark_name, framework,
+        batch_size, tensor_size, warmup_iters, measure_iters, verbose);
+    return 0;
+  }
+
   std::vector<uint64_t> total_duration_ns;
   std::vector<uint64_t> request_duration_ns;
 
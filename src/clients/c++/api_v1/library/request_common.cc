@@ -825,24 +825,30 @@ InferContextImpl::Init(std::unique_ptr<ServerStatusContext> sctx)
           RequestStatusCode::INTERNAL,
           "unable to find status information for \"" + model_name_ + "\"");
     } else {
-      const ModelConfig& model_info = itr->second.config();
-
-      max_batch_size_ =
-          static_cast<uint64_t>(std::max(0, model_info.max_batch_size()));
-
-      // Create inputs and outputs
-      for (const auto& io : model_info.input()) {
-        inputs_.emplace_back(std::make_shared<InputImpl>(io));
-      }
-      for (const auto& io : model_info.output()) {
-        outputs_.emplace_back(std::make_shared<OutputImpl>(io));
-      }
+      err = Init(itr->second.config());
     }
   }
 
   return err;
 }
 
+Error
+InferContextImpl::Init(const ModelConfig& model_info)
+{
+  max_batch_size_ =
+      static_cast<uint64_t>(std::max(0, model_info.max_batch_size()));
+
+  // Create inputs and outputs
+  for (const auto& io : model_info.input()) {
+    inputs_.emplace_back(std::make_shared<InputImpl>(io));
+  }
+  for (const auto& io : model_info.output()) {
+    outputs_.emplace_back(std::make_shared<OutputImpl>(io));
+  }
+
+  return Error::Success;
+}
+
 Error
 InferContextImpl::GetInput(
     const std::string& name, std::shared_ptr<Input>* input) const
@@ -370,6 +370,15 @@ class ResultImpl : public InferContext::Result {
       const uint8_t* buf, size_t size, const bool inplace,
       size_t* result_bytes);
 
+  // For an in-place RAW result, hold a reference to the
+  // transport-owned buffer that the result points into so that the
+  // pointers returned by GetRaw() and GetRawAtCursor() remain valid
+  // until this result is destroyed.
+  void HoldRawResult(const std::shared_ptr<std::vector<uint8_t>>& buffer)
+  {
+    raw_result_buffer_ = buffer;
+  }
+
  private:
   Error SetBatchRawResult(
       const size_t batch1_byte_size, const uint8_t* buf, size_t size,
@@ -395,6 +404,10 @@ class ResultImpl : public InferContext::Result {
   std::vector<const uint8_t*> inplace_ptrs_;
   mutable std::vector<std::vector<uint8_t>> buffers_;
 
+  // The transport-owned buffer referenced by 'inplace_ptrs_', if the
+  // transport shared its ownership with this result.
+  std::shared_ptr<std::vector<uint8_t>> raw_result_buffer_;
+
   size_t bufs_idx_;
   std::vector<size_t> bufs_pos_;
   std::vector<size_t> bufs_byte_size_;
@@ -492,6 +505,10 @@ class InferContextImpl : public InferContext {
  protected:
   Error Init(std::unique_ptr<ServerStatusContext> sctx);
 
+  // Initialize directly from the model configuration, without
+  // contacting the server.
+  Error Init(const ModelConfig& model_info);
+
   // Update the context stat with the given timer
   Error UpdateStat(const RequestTimers& timer);
 
@@ -30,8 +30,10 @@
 
 #include <grpcpp/grpcpp.h>
 #include <cstdint>
+#include <cstdlib>
 #include <future>
 #include <iostream>
+#include <mutex>
 #include "src/clients/c++/api_v1/library/request_common.h"
 #include "src/core/grpc_service.grpc.pb.h"
 #include "src/core/model_config.pb.h"
@@ -44,24 +46,102 @@ namespace {
 
 //==============================================================================
 
-// Use map to keep track of GRPC channels. <key, value> : <url, Channel*>
-// If context is created on url that has established Channel, then reuse it.
-std::map<std::string, std::shared_ptr<grpc::Channel>> grpc_channel_map_;
+// Channels to the same endpoint are shared across all contexts so
+// that a client process holds a bounded number of TCP connections to
+// each server no matter how many contexts it creates. The number of
+// channels (and so connections) per endpoint defaults to 1 and can be
+// raised for throughput with the TRTIS_CLIENT_GRPC_CHANNEL_COUNT
+// environment variable; contexts round-robin over the pool. The mutex
+// makes context creation safe from multiple threads.
+struct GrpcChannelPool {
+  size_t next_{0};
+  std::vector<std::shared_ptr<grpc::Channel>> channels_;
+};
+
+std::mutex grpc_channel_mtx_;
+std::map<std::string, GrpcChannelPool> grpc_channel_map_;
+
+size_t
+ChannelCount()
+{
+  static size_t count = []() -> size_t {
+    const char* count_str = getenv("TRTIS_CLIENT_GRPC_CHANNEL_COUNT");
+    if (count_str != nullptr) {
+      const int count = atoi(count_str);
+      if (count > 0) {
+        return count;
+      }
+    }
+    return 1;
+  }();
+  return count;
+}
+
 std::shared_ptr<grpc::Channel>
 GetChannel(const std::string& url)
 {
-  const auto& channel_itr = grpc_channel_map_.find(url);
-  if (channel_itr != grpc_channel_map_.end()) {
-    return channel_itr->second;
-  } else {
-    grpc::ChannelArguments arguments;
-    arguments.SetMaxSendMessageSize(MAX_GRPC_MESSAGE_SIZE);
-    arguments.SetMaxReceiveMessageSize(MAX_GRPC_MESSAGE_SIZE);
-    std::shared_ptr<grpc::Channel> channel = grpc::CreateCustomChannel(
-        url, grpc::InsecureChannelCredentials(), arguments);
-    grpc_channel_map_.insert(std::make_pair(url, channel));
-    return channel;
+  std::lock_guard<std::mutex> lock(grpc_channel_mtx_);
+
+  GrpcChannelPool& pool = grpc_channel_map_[url];
+  if (pool.channels_.empty()) {
+    for (size_t idx = 0; idx < ChannelCount(); idx++) {
+      grpc::ChannelArguments arguments;
+      arguments.SetMaxSendMessageSize(MAX_GRPC_MESSAGE_SIZE);
+      arguments.SetMaxReceiveMessageSize(MAX_GRPC_MESSAGE_SIZE);
+      // A distinct argument value keeps gRPC from collapsing the
+      // pool onto one shared subchannel, and so onto one connection.
+      arguments.SetInt("trtis.client_channel_index", idx);
+      pool.channels_.emplace_back(grpc::CreateCustomChannel(
+          url, grpc::InsecureChannelCredentials(), arguments));
+    }
   }
+
+  return pool.channels_[pool.next_++ % pool.channels_.size()];
+}
+
+// Model configurations already fetched by this process, keyed by
+// endpoint and model. Creating an InferContext for an already-seen
+// model reuses the cached configuration instead of paying a status
+// round-trip, making creation cheap enough to do per request. The
+// cache lives for the process, so a model configuration change on the
+// server is not seen by contexts created after the first.
+std::map<std::string, ModelConfig> grpc_model_config_map_;
+
+Error
+GetModelConfig(
+    const std::string& url, const std::string& model_name, const bool verbose,
+    ModelConfig* model_config)
+{
+  const std::string key = url + "/" + model_name;
+  {
+    std::lock_guard<std::mutex> lock(grpc_channel_mtx_);
+    const auto itr = grpc_model_config_map_.find(key);
+    if (itr != grpc_model_config_map_.end()) {
+      *model_config = itr->second;
+      return Error::Success;
+    }
+  }
+
+  std::unique_ptr<ServerStatusContext> sctx;
+  Error err = ServerStatusGrpcContext::Create(&sctx, url, model_name, verbose);
+  if (err.IsOk()) {
+    ServerStatus server_status;
+    err = sctx->GetServerStatus(&server_status);
+    if (err.IsOk()) {
+      const auto& itr = server_status.model_status().find(model_name);
+      if (itr == server_status.model_status().end()) {
+        err = Error(
+            RequestStatusCode::INTERNAL,
+            "unable to find status information for \"" + model_name + "\"");
+      } else {
+        *model_config = itr->second.config();
+        std::lock_guard<std::mutex> lock(grpc_channel_mtx_);
+        grpc_model_config_map_.emplace(key, *model_config);
+      }
+    }
+  }
+
+  return err;
 }
 
 }  // namespace
@@ -761,11 +841,12 @@ GrpcRequestImpl::GetResults(
 Error
 InferGrpcContextImpl::InitGrpc(const std::string& server_url)
 {
-  std::unique_ptr<ServerStatusContext> sctx;
-  Error err =
-      ServerStatusGrpcContext::Create(&sctx, server_url, model_name_, verbose_);
+  // Only the first context created for a model contacts the server;
+  // later creations reuse the cached model configuration.
+  ModelConfig model_info;
+  Error err = GetModelConfig(server_url, model_name_, verbose_, &model_info);
   if (err.IsOk()) {
-    err = Init(std::move(sctx));
+    err = Init(model_info);
     if (err.IsOk()) {
       // Create request context for synchronous request.
       sync_request_.reset(
@@ -1121,8 +1121,9 @@ class HttpRequestImpl : public RequestImpl {
       const InferHttpContextImpl& ctx,
       const InferResponseHeader::Output& output, const size_t batch_size);
 
-  // Copy into the context 'size' bytes of result data from
-  // 'buf'. Return the actual amount copied in 'result_bytes'.
+  // Append 'size' bytes of response body data from 'buf' to the
+  // response buffers. Return the actual amount appended in
+  // 'result_bytes'.
   Error SetNextRawResult(const uint8_t* buf, size_t size, size_t* result_bytes);
 
   // Get results from an inference request.
@@ -1162,8 +1163,15 @@ class HttpRequestImpl : public RequestImpl {
   // Current positions within input vectors when sending request.
   size_t input_pos_idx_;
 
-  // Current positions within output vectors when processing response.
-  size_t result_pos_idx_;
+  // Buffer that accumulates the raw result data portion of the
+  // response body. Ownership is shared with the results so that
+  // in-place result pointers remain valid until the results are
+  // destroyed.
+  std::shared_ptr<std::vector<uint8_t>> raw_result_buffer_;
+
+  // The expected total byte size of the raw result data delivered in
+  // the response body.
+  size_t total_raw_result_byte_size_;
 
   // Callback data for response handler.
   ResponseHandlerUserP response_handler_userp_;
@@ -1222,7 +1230,7 @@ HttpRequestImpl::HttpRequestImpl(
     InferContext::OnCompleteFn callback)
     : RequestImpl(id, std::move(callback)), easy_handle_(curl_easy_init()),
       header_list_(nullptr), inputs_(inputs), total_input_byte_size_(0),
-      input_pos_idx_(0), result_pos_idx_(0)
+      input_pos_idx_(0), total_raw_result_byte_size_(0)
 {
   if (easy_handle_ != nullptr) {
     SetRunIndex(reinterpret_cast<uintptr_t>(easy_handle_));
@@ -1260,7 +1268,19 @@ HttpRequestImpl::InitializeRequest()
 
   total_input_byte_size_ = 0;
   input_pos_idx_ = 0;
-  result_pos_idx_ = 0;
+
+  // The buffer persists across Run calls as a result arena: when the
+  // caller has released the previous results this request object is
+  // the only owner and the buffer is reused, keeping its capacity so
+  // that steady-state runs decode into already-allocated memory. A
+  // fresh buffer is only needed while results of a previous request
+  // still reference the old one.
+  if ((raw_result_buffer_ == nullptr) || (raw_result_buffer_.use_count() > 1)) {
+    raw_result_buffer_ = std::make_shared<std::vector<uint8_t>>();
+  } else {
+    raw_result_buffer_->clear();
+  }
+  total_raw_result_byte_size_ = 0;
 
   return Error::Success;
 }
@@ -1304,26 +1324,19 @@ HttpRequestImpl::SetNextRawResult(
 {
   *result_bytes = 0;
 
-  while ((size > 0) && (result_pos_idx_ < ordered_results_.size())) {
-    ResultImpl* io = ordered_results_[result_pos_idx_].get();
-    size_t ob = 0;
-
-    // Only try to read raw result for RAW
-    if (io->ResultFormat() == InferContext::Result::ResultFormat::RAW) {
-      Error err = io->SetNextRawResult(buf, size, false /* inplace */, &ob);
-      if (!err.IsOk()) {
-        return err;
-      }
-    }
-
-    // If output couldn't accept any more bytes then move to the next.
-    if (ob == 0) {
-      result_pos_idx_++;
-    } else {
-      *result_bytes += ob;
-      size -= ob;
-      buf += ob;
+  // The raw result data arrives first in the response body. Collect
+  // it into a single contiguous buffer that the results reference
+  // in-place instead of copying from.
+  if (raw_result_buffer_->size() < total_raw_result_byte_size_) {
+    if (raw_result_buffer_->capacity() < total_raw_result_byte_size_) {
+      raw_result_buffer_->reserve(total_raw_result_byte_size_);
     }
+    const size_t csz = std::min(
+        size, total_raw_result_byte_size_ - raw_result_buffer_->size());
+    raw_result_buffer_->insert(raw_result_buffer_->end(), buf, buf + csz);
+    *result_bytes += csz;
+    size -= csz;
+    buf += csz;
   }
 
   // If there is any bytes left then they belong to the response
@@ -1359,6 +1372,13 @@ HttpRequestImpl::CreateResult(
     result->SetUsesSharedMemory(true);
   }
 
+  // Only RAW results not delivered via shared memory contribute raw
+  // data to the response body.
+  if ((result->ResultFormat() == InferContext::Result::ResultFormat::RAW) &&
+      !ctx.UsesSharedMemory(output.name())) {
+    total_raw_result_byte_size_ += output.raw().batch_byte_size();
+  }
+
   ordered_results_.emplace_back(std::move(result));
 
   return Error::Success;
@@ -1414,6 +1434,27 @@ HttpRequestImpl::GetResults(InferContext::ResultMap* results)
 
   infer_response.ParseFromString(infer_response_buffer_);
 
+  // Hand each RAW result a reference into the accumulated transport
+  // buffer instead of copying the result data out of it. The results
+  // share ownership of the buffer so the references remain valid
+  // until the results are destroyed.
+  const uint8_t* rbuf = raw_result_buffer_->data();
+  size_t remaining = raw_result_buffer_->size();
+  for (auto& r : ordered_results_) {
+    if (r->ResultFormat() == InferContext::Result::ResultFormat::RAW) {
+      size_t result_bytes = 0;
+      Error err = r->SetNextRawResult(
+          rbuf, remaining, true /* inplace */, &result_bytes);
+      if (!err.IsOk()) {
+        ordered_results_.clear();
+        return err;
+      }
+      r->HoldRawResult(raw_result_buffer_);
+      rbuf += result_bytes;
+      remaining -= result_bytes;
+    }
+  }
+
   results->clear();
   for (auto& r : ordered_results_) {
     const std::string& name = r->GetOutput()->Name();
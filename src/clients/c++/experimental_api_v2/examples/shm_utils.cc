@@ -25,10 +25,13 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <fcntl.h>
+#include <stdint.h>
 #include <sys/mman.h>
 #include <unistd.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <utility>
 
 #include "src/clients/c++/experimental_api_v2/examples/shm_utils.h"
 
@@ -105,4 +108,72 @@ UnmapSharedMemory(void* shm_addr, size_t byte_size)
   return nic::Error::Success;
 }
 
+nic::Error
+SharedMemoryPool::Create(
+    const std::string& shm_key, size_t byte_size,
+    std::unique_ptr<SharedMemoryPool>* pool)
+{
+  int shm_fd;
+  nic::Error err = CreateSharedMemoryRegion(shm_key, byte_size, &shm_fd);
+  if (!err.IsOk()) {
+    return err;
+  }
+
+  std::unique_ptr<SharedMemoryPool> lpool(
+      new SharedMemoryPool(shm_key, byte_size));
+  err = MapSharedMemory(shm_fd, 0, byte_size, &lpool->base_addr_);
+
+  // The descriptor is no longer needed once the region is mapped.
+  CloseSharedMemory(shm_fd);
+
+  if (!err.IsOk()) {
+    UnlinkSharedMemoryRegion(shm_key);
+    return err;
+  }
+
+  *pool = std::move(lpool);
+  return nic::Error::Success;
+}
+
+SharedMemoryPool::SharedMemoryPool(
+    const std::string& shm_key, size_t byte_size)
+    : shm_key_(shm_key), byte_size_(byte_size), base_addr_(nullptr),
+      alloc_offset_(0)
+{
+}
+
+SharedMemoryPool::~SharedMemoryPool()
+{
+  if (base_addr_ != nullptr) {
+    UnmapSharedMemory(base_addr_, byte_size_);
+  }
+  UnlinkSharedMemoryRegion(shm_key_);
+}
+
+nic::Error
+SharedMemoryPool::Alloc(size_t byte_size, void** addr, size_t* offset)
+{
+  const size_t aligned_offset =
+      (alloc_offset_ + (kAlignment - 1)) & ~(kAlignment - 1);
+  if ((aligned_offset + byte_size) > byte_size_) {
+    return nic::Error(
+        "shared memory pool '" + shm_key_ + "' exhausted: " +
+        std::to_string(byte_size) + " bytes requested, " +
+        std::to_string(byte_size_ - std::min(byte_size_, aligned_offset)) +
+        " available");
+  }
+
+  *addr = reinterpret_cast<uint8_t*>(base_addr_) + aligned_offset;
+  *offset = aligned_offset;
+  alloc_offset_ = aligned_offset + byte_size;
+
+  return nic::Error::Success;
+}
+
+void
+SharedMemoryPool::Reset()
+{
+  alloc_offset_ = 0;
+}
+
 }}}  // namespace nvidia::inferenceserver::client
@@ -66,4 +66,63 @@ nic::Error UnlinkSharedMemoryRegion(std::string shm_key);
 // \return error Returns an error if unable to unmap shared memory region.
 nic::Error UnmapSharedMemory(void* shm_addr, size_t byte_size);
 
+// A pooled shared memory region. The pool creates and maps one large
+// region up front and hands out sub-blocks from it, so the per-use
+// cost is a bump allocation instead of shm_open + ftruncate + mmap,
+// and the region needs to be registered with the server only once
+// (RegisterSystemSharedMemory with Key() and ByteSize()); each
+// sub-block is then addressed by the offset returned from Alloc().
+// Use this instead of a region per tensor when the allocation pattern
+// repeats, e.g. one pool per stream reset between requests.
+class SharedMemoryPool {
+ public:
+  // Create a shared memory pool over a new region identified by
+  // 'shm_key' of 'byte_size' bytes.
+  // \param shm_key The string identifier of the shared memory region
+  // \param byte_size The size in bytes of the shared memory region
+  // \param pool Returns the created pool
+  // \return error Returns an error if unable to create or map the
+  // shared memory region.
+  static nic::Error Create(
+      const std::string& shm_key, size_t byte_size,
+      std::unique_ptr<SharedMemoryPool>* pool);
+
+  // Unmaps and unlinks the underlying region. The region must be
+  // unregistered from the server first.
+  ~SharedMemoryPool();
+
+  // The string identifier of the underlying shared memory region.
+  const std::string& Key() const { return shm_key_; }
+
+  // The total size in bytes of the underlying shared memory region.
+  size_t ByteSize() const { return byte_size_; }
+
+  // The base address of the mapped region.
+  void* BaseAddr() const { return base_addr_; }
+
+  // Allocate 'byte_size' bytes from the pool. Allocations are 64-byte
+  // aligned.
+  // \param byte_size The size in bytes of the block
+  // \param addr Returns the mapped address of the block
+  // \param offset Returns the offset of the block within the region,
+  // as taken by InferInput::SetSharedMemory()
+  // \return error Returns an error if the pool is exhausted.
+  nic::Error Alloc(size_t byte_size, void** addr, size_t* offset);
+
+  // Return the pool to the empty state, making the full region
+  // available to Alloc() again. The caller must ensure that no
+  // in-flight request still uses a previously allocated block.
+  void Reset();
+
+ private:
+  SharedMemoryPool(const std::string& shm_key, size_t byte_size);
+
+  static const size_t kAlignment = 64;
+
+  const std::string shm_key_;
+  const size_t byte_size_;
+  void* base_addr_;
+  size_t alloc_offset_;
+};
+
 }}}  // namespace nvidia::inferenceserver::client
@@ -153,6 +153,40 @@ InferInput::AppendRaw(const uint8_t* input, size_t input_byte_size)
   return Error::Success;
 }
 
+Error
+InferInput::AppendRawStrided(
+    const uint8_t* input, size_t element_byte_size, size_t stride_byte_size,
+    size_t element_cnt)
+{
+  if (stride_byte_size < element_byte_size) {
+    return Error(
+        "'stride_byte_size' must not be smaller than 'element_byte_size' for "
+        "input '" +
+        name_ + "'");
+  }
+
+  // A dense array is just a single contiguous reference.
+  if (stride_byte_size == element_byte_size) {
+    return AppendRaw(input, element_byte_size * element_cnt);
+  }
+
+  // Record each element as its own reference into the caller's
+  // storage. The transport gathers the references into its send
+  // buffer in one pass, so the interleaving happens during the send
+  // and no intermediate assembly buffer is needed.
+  bufs_.reserve(bufs_.size() + element_cnt);
+  buf_byte_sizes_.reserve(buf_byte_sizes_.size() + element_cnt);
+  for (size_t e = 0; e < element_cnt; e++) {
+    bufs_.push_back(input + (e * stride_byte_size));
+    buf_byte_sizes_.push_back(element_byte_size);
+  }
+
+  byte_size_ += element_byte_size * element_cnt;
+  io_type_ = RAW;
+
+  return Error::Success;
+}
+
 Error
 InferInput::SetSharedMemory(
     const std::string& name, size_t byte_size, size_t offset)
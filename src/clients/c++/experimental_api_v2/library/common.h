@@ -255,6 +255,27 @@ class InferInput {
   /// \return Error object indicating success or failure.
   Error AppendRaw(const uint8_t* input, size_t input_byte_size);
 
+  /// Append tensor values for this input from a strided array, for
+  /// example one column of a row-major table. Element 'e', for 'e'
+  /// from 0 to 'element_cnt' - 1, is read as 'element_byte_size'
+  /// bytes (typically the size of the tensor's datatype) starting at
+  /// 'input' + 'e' * 'stride_byte_size'. The array is not copied: the
+  /// elements are gathered directly into the transport buffer when
+  /// the request is sent, so columnar data doesn't need to be
+  /// interleaved into a contiguous buffer first. As with AppendRaw()
+  /// the array must not be modified or destroyed until this input is
+  /// no longer needed, multiple calls keep adding tensor data, and
+  /// the data is delivered in the order it was added.
+  /// \param input The pointer to the array holding the tensor values.
+  /// \param element_byte_size The size of each element in bytes.
+  /// \param stride_byte_size The distance in bytes between the starts
+  /// of consecutive elements.
+  /// \param element_cnt The number of elements to append.
+  /// \return Error object indicating success or failure.
+  Error AppendRawStrided(
+      const uint8_t* input, size_t element_byte_size, size_t stride_byte_size,
+      size_t element_cnt);
+
   /// Set tensor values for this input by reference into a shared memory
   /// region. The values are not copied and so the shared memory region and
   /// its contents must not be modified or destroyed until this input is no
@@ -78,6 +78,31 @@ class GrpcInferRequest : public InferRequest {
   std::shared_ptr<ModelInferResponse> grpc_response_;
 };
 
+//==============================================================================
+// A GrpcBatchInferRequest represents an inflight batched RPC carrying
+// several coalesced inference requests.
+//
+class GrpcBatchInferRequest {
+ public:
+  GrpcBatchInferRequest()
+      : grpc_status_(),
+        grpc_response_(std::make_shared<ModelBatchInferResponse>())
+  {
+  }
+
+  friend InferenceServerGrpcClient;
+
+ private:
+  // The coalesced requests, in the order they appear on the wire.
+  std::vector<std::shared_ptr<GrpcInferRequest>> requests_;
+
+  // Variables for GRPC call
+  grpc::ClientContext grpc_context_;
+  grpc::Status grpc_status_;
+  ModelBatchInferRequest grpc_request_;
+  std::shared_ptr<ModelBatchInferResponse> grpc_response_;
+};
+
 //==============================================================================
 
 class InferResultGrpc : public InferResult {
@@ -793,6 +818,10 @@ InferenceServerGrpcClient::AsyncInfer(
     return Error(
         "Callback function must be provided along with AsyncInfer() call.");
   }
+  if (batching_active_) {
+    return BatchedAsyncInfer(
+        std::move(callback), options, inputs, outputs, headers);
+  }
   if (!worker_.joinable()) {
     worker_ = std::thread(&InferenceServerGrpcClient::AsyncTransfer, this);
   }
@@ -835,6 +864,107 @@ InferenceServerGrpcClient::AsyncInfer(
   return Error::Success;
 }
 
+Error
+InferenceServerGrpcClient::StartBatching(
+    uint64_t max_batch_delay_us, uint32_t max_batch_requests)
+{
+  if (batcher_worker_.joinable()) {
+    return Error("batching is already started for this client.");
+  }
+  if (batcher_exiting_) {
+    return Error("cannot restart batching once it has been stopped.");
+  }
+  if (max_batch_requests == 0) {
+    return Error("'max_batch_requests' must be non-zero.");
+  }
+
+  max_batch_delay_us_ = max_batch_delay_us;
+  max_batch_requests_ = max_batch_requests;
+  batching_active_ = true;
+
+  batcher_worker_ =
+      std::thread(&InferenceServerGrpcClient::BatcherWorker, this);
+  batch_transfer_worker_ =
+      std::thread(&InferenceServerGrpcClient::BatchTransfer, this);
+
+  if (verbose_) {
+    std::cout << "Started batching..." << std::endl;
+  }
+
+  return Error::Success;
+}
+
+Error
+InferenceServerGrpcClient::StopBatching()
+{
+  if (batcher_worker_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(batcher_mutex_);
+      batching_active_ = false;
+      batcher_exiting_ = true;
+    }
+    batcher_cv_.notify_all();
+    // The batcher thread flushes the pending requests before returning
+    batcher_worker_.join();
+    // The transfer thread drains the in-flight batches properly
+    batch_completion_queue_.Shutdown();
+    batch_transfer_worker_.join();
+    if (verbose_) {
+      std::cout << "Stopped batching..." << std::endl;
+    }
+  }
+
+  return Error::Success;
+}
+
+Error
+InferenceServerGrpcClient::BatchedAsyncInfer(
+    OnCompleteFn callback, const InferOptions& options,
+    const std::vector<InferInput*>& inputs,
+    const std::vector<const InferRequestedOutput*>& outputs,
+    const Headers& headers)
+{
+  std::shared_ptr<GrpcInferRequest> async_request(
+      new GrpcInferRequest(std::move(callback)));
+
+  async_request->Timer().CaptureTimestamp(RequestTimers::Kind::REQUEST_START);
+  async_request->Timer().CaptureTimestamp(RequestTimers::Kind::SEND_START);
+  Error err = PreRunProcessing(options, inputs, outputs);
+  if (!err.IsOk()) {
+    return err;
+  }
+  async_request->Timer().CaptureTimestamp(RequestTimers::Kind::SEND_END);
+
+  bool notify = false;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    PendingBatch& pending = pending_batches_[options.model_name_];
+    if (pending.requests_.empty()) {
+      pending.oldest_ = std::chrono::steady_clock::now();
+      pending.headers_ = headers;
+    }
+    pending.batch_request_.add_requests()->Swap(&infer_request_);
+    pending.requests_.push_back(async_request);
+    // Wake the batcher for the first request of a batch, to arm the
+    // delay, and when the batch is full, to flush it immediately.
+    notify = (pending.requests_.size() == 1) ||
+             (pending.requests_.size() >= max_batch_requests_);
+  }
+  if (notify) {
+    batcher_cv_.notify_one();
+  }
+
+  if (verbose_) {
+    std::cout << "Queued request";
+    if (options.request_id_.size() != 0) {
+      std::cout << " '" << options.request_id_ << "'";
+    }
+    std::cout << " for batching" << std::endl;
+  }
+
+  return Error::Success;
+}
+
 Error
 InferenceServerGrpcClient::StartStream(
     OnCompleteFn callback, bool enable_stats, const Headers& headers)
@@ -1084,6 +1214,156 @@ InferenceServerGrpcClient::AsyncTransfer()
   }
 }
 
+void
+InferenceServerGrpcClient::BatcherWorker()
+{
+  const std::chrono::microseconds delay(max_batch_delay_us_);
+
+  std::unique_lock<std::mutex> lock(batcher_mutex_);
+  while (true) {
+    if (pending_batches_.empty()) {
+      if (batcher_exiting_) {
+        break;
+      }
+      batcher_cv_.wait(lock);
+      continue;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (!batcher_exiting_) {
+      // Sleep until the delay of the oldest pending batch expires,
+      // unless a batch is already due or full.
+      auto earliest = std::chrono::steady_clock::time_point::max();
+      bool due = false;
+      for (const auto& pr : pending_batches_) {
+        if (pr.second.requests_.size() >= max_batch_requests_) {
+          due = true;
+          break;
+        }
+        earliest = std::min(earliest, pr.second.oldest_ + delay);
+      }
+      if (!due && (earliest > now)) {
+        batcher_cv_.wait_until(lock, earliest);
+        now = std::chrono::steady_clock::now();
+      }
+    }
+
+    auto it = pending_batches_.begin();
+    while (it != pending_batches_.end()) {
+      if (batcher_exiting_ ||
+          (it->second.requests_.size() >= max_batch_requests_) ||
+          ((it->second.oldest_ + delay) <= now)) {
+        const std::string model_name = it->first;
+        PendingBatch pending(std::move(it->second));
+        it = pending_batches_.erase(it);
+        // Issue the RPC without holding the lock so that new requests
+        // can keep accumulating for the next batch. Map iterators
+        // remain valid across the insertions that may happen here.
+        lock.unlock();
+        DispatchBatch(model_name, &pending);
+        lock.lock();
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+void
+InferenceServerGrpcClient::DispatchBatch(
+    const std::string& model_name, PendingBatch* pending)
+{
+  GrpcBatchInferRequest* batch_request = new GrpcBatchInferRequest();
+  for (const auto& it : pending->headers_) {
+    batch_request->grpc_context_.AddMetadata(it.first, it.second);
+  }
+  batch_request->grpc_request_.Swap(&pending->batch_request_);
+  batch_request->requests_.swap(pending->requests_);
+
+  std::unique_ptr<grpc::ClientAsyncResponseReader<ModelBatchInferResponse>>
+      rpc(stub_->PrepareAsyncModelBatchInfer(
+          &batch_request->grpc_context_, batch_request->grpc_request_,
+          &batch_completion_queue_));
+
+  rpc->StartCall();
+
+  rpc->Finish(
+      batch_request->grpc_response_.get(), &batch_request->grpc_status_,
+      (void*)batch_request);
+
+  if (verbose_) {
+    std::cout << "Sent batch of " << batch_request->requests_.size()
+              << " requests to model '" << model_name << "'" << std::endl;
+  }
+}
+
+void
+InferenceServerGrpcClient::BatchTransfer()
+{
+  while (true) {
+    GrpcBatchInferRequest* raw_batch;
+    bool ok = true;
+    bool status =
+        batch_completion_queue_.Next((void**)(&raw_batch), &ok);
+    if (!status) {
+      if (!batcher_exiting_) {
+        fprintf(stderr, "Batch completion queue is closed.\n");
+      }
+      break;
+    }
+    if (!ok) {
+      fprintf(stderr, "Unexpected not ok on client side.\n");
+    }
+    if (raw_batch == nullptr) {
+      fprintf(stderr, "Unexpected null tag received at client.\n");
+      continue;
+    }
+
+    std::shared_ptr<GrpcBatchInferRequest> batch(raw_batch);
+    Error rpc_err;
+    if (!batch->grpc_status_.ok()) {
+      rpc_err = Error(batch->grpc_status_.error_message());
+    } else if (verbose_) {
+      std::cout << batch->grpc_response_->DebugString() << std::endl;
+    }
+
+    // Demultiplex the responses to the per-request callbacks, in the
+    // order the requests were carried on the wire. A failure of the
+    // batched RPC fails every request it carried.
+    for (size_t idx = 0; idx < batch->requests_.size(); idx++) {
+      std::shared_ptr<GrpcInferRequest>& async_request =
+          batch->requests_[idx];
+      async_request->Timer().CaptureTimestamp(RequestTimers::Kind::RECV_START);
+      InferResult* async_result;
+      Error err = rpc_err;
+      if (err.IsOk() &&
+          (idx >= (size_t)batch->grpc_response_->responses_size())) {
+        err = Error(
+            "batched response is missing the result for request " +
+            std::to_string(idx));
+      }
+      if (err.IsOk()) {
+        // The aliased shared_ptr keeps the whole batched response
+        // alive for as long as any of its results is held.
+        std::shared_ptr<ModelStreamInferResponse> response(
+            batch->grpc_response_,
+            batch->grpc_response_->mutable_responses(idx));
+        InferResultGrpc::Create(&async_result, response);
+      } else {
+        InferResultGrpc::Create(
+            &async_result, async_request->grpc_response_, err);
+      }
+      async_request->Timer().CaptureTimestamp(RequestTimers::Kind::RECV_END);
+      async_request->Timer().CaptureTimestamp(RequestTimers::Kind::REQUEST_END);
+      err = UpdateInferStat(async_request->Timer());
+      if (!err.IsOk()) {
+        std::cerr << "Failed to update context stat: " << err << std::endl;
+      }
+      async_request->callback_(async_result);
+    }
+  }
+}
+
 void
 InferenceServerGrpcClient::AsyncStreamTransfer()
 {
@@ -1134,13 +1414,16 @@ InferenceServerGrpcClient::AsyncStreamTransfer()
 
 InferenceServerGrpcClient::InferenceServerGrpcClient(
     const std::string& url, bool verbose)
-    : InferenceServerClient(verbose),
+    : InferenceServerClient(verbose), batching_active_(false),
+      batcher_exiting_(false), max_batch_delay_us_(0), max_batch_requests_(0),
       stub_(GRPCInferenceService::NewStub(GetChannel(url)))
 {
 }
 
 InferenceServerGrpcClient::~InferenceServerGrpcClient()
 {
+  StopBatching();
+
   exiting_ = true;
   // Close complete queue and wait for the worker thread to return
   async_request_completion_queue_.Shutdown();
@@ -36,6 +36,8 @@
 
 namespace nvidia { namespace inferenceserver { namespace client {
 
+class GrpcInferRequest;
+
 /// The key-value map type to be included in the request
 /// metadata
 typedef std::map<std::string, std::string> Headers;
@@ -301,6 +303,33 @@ class InferenceServerGrpcClient : public InferenceServerClient {
           std::vector<const InferRequestedOutput*>(),
       const Headers& headers = Headers());
 
+  /// Starts coalescing AsyncInfer() requests into batched RPCs. While
+  /// batching is active the requests issued to the same model within
+  /// 'max_batch_delay_us' microseconds of each other are carried by a
+  /// single ModelBatchInfer RPC instead of one ModelInfer RPC each,
+  /// which reduces the per-RPC overhead roughly by the number of
+  /// requests coalesced. Each request is still executed by the server
+  /// as an individual inference request and each callback receives its
+  /// own result. The headers of the first request in a batch are
+  /// applied to the batched RPC so requests that need different
+  /// headers should not be batched together. Batching only applies to
+  /// AsyncInfer(), not to Infer() or AsyncStreamInfer().
+  /// \param max_batch_delay_us The maximum time, in microseconds, a
+  /// request may be held back waiting for others to coalesce with.
+  /// \param max_batch_requests The maximum number of requests to carry
+  /// in one batched RPC. A batch is sent as soon as it reaches this
+  /// many requests, without waiting for the delay to expire.
+  /// \return Error object indicating success or failure of the request.
+  Error StartBatching(
+      uint64_t max_batch_delay_us = 500, uint32_t max_batch_requests = 8);
+
+  /// Stops coalescing AsyncInfer() requests, if batching is active.
+  /// The pending requests are flushed to the server and the callbacks
+  /// of the in-flight batches are still invoked on completion. Once
+  /// stopped, batching cannot be restarted on this client.
+  /// \return Error object indicating success or failure of the request.
+  Error StopBatching();
+
   /// Starts a grpc bi-directional stream to send streaming inferences.
   /// \param callback The callback function to be invoked on receiving a
   /// response at the stream.
@@ -336,12 +365,35 @@ class InferenceServerGrpcClient : public InferenceServerClient {
           std::vector<const InferRequestedOutput*>());
 
  private:
+  // The requests pending for a model, waiting to be coalesced into a
+  // batched RPC. Protected by batcher_mutex_.
+  struct PendingBatch {
+    // The batched wire message accumulated from the pending requests.
+    ModelBatchInferRequest batch_request_;
+    // The pending requests, in the order their serialized form appears
+    // in 'batch_request_'.
+    std::vector<std::shared_ptr<GrpcInferRequest>> requests_;
+    // The headers of the first pending request, applied to the
+    // batched RPC.
+    Headers headers_;
+    // When the oldest pending request was queued.
+    std::chrono::time_point<std::chrono::steady_clock> oldest_;
+  };
+
   InferenceServerGrpcClient(const std::string& url, bool verbose);
   Error PreRunProcessing(
       const InferOptions& options, const std::vector<InferInput*>& inputs,
       const std::vector<const InferRequestedOutput*>& outputs);
+  Error BatchedAsyncInfer(
+      OnCompleteFn callback, const InferOptions& options,
+      const std::vector<InferInput*>& inputs,
+      const std::vector<const InferRequestedOutput*>& outputs,
+      const Headers& headers);
+  void DispatchBatch(const std::string& model_name, PendingBatch* pending);
   void AsyncTransfer();
   void AsyncStreamTransfer();
+  void BatcherWorker();
+  void BatchTransfer();
 
   // The producer-consumer queue used to communicate asynchronously with
   // the GRPC runtime.
@@ -359,6 +411,18 @@ class InferenceServerGrpcClient : public InferenceServerClient {
   std::queue<std::unique_ptr<RequestTimers>> ongoing_stream_request_timers_;
   std::mutex stream_mutex_;
 
+  // Required to support client-side batching of AsyncInfer() requests.
+  bool batching_active_;
+  bool batcher_exiting_;
+  uint64_t max_batch_delay_us_;
+  uint32_t max_batch_requests_;
+  std::map<std::string, PendingBatch> pending_batches_;
+  std::mutex batcher_mutex_;
+  std::condition_variable batcher_cv_;
+  std::thread batcher_worker_;
+  std::thread batch_transfer_worker_;
+  grpc::CompletionQueue batch_completion_queue_;
+
   // GRPC end point.
   std::unique_ptr<GRPCInferenceService::Stub> stub_;
   // request for GRPC call, one request object can be used for multiple calls
@@ -27,6 +27,8 @@
 #include "src/clients/c++/experimental_api_v2/library/http_client.h"
 
 #include <curl/curl.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <cstdint>
 #include <iostream>
 #include <queue>
@@ -441,6 +443,11 @@ InferenceServerHttpClient::~InferenceServerHttpClient()
   // (it is default constructed thread before the first AsyncInfer() call)
   if (worker_.joinable()) {
     cv_.notify_all();
+    if (wakeup_fds_[1] != -1) {
+      // Wake the transfer thread out of curl_multi_wait()
+      char wake_byte = 0;
+      (void)!write(wakeup_fds_[1], &wake_byte, 1);
+    }
     worker_.join();
   }
 
@@ -452,6 +459,12 @@ InferenceServerHttpClient::~InferenceServerHttpClient()
     }
     curl_multi_cleanup(multi_handle_);
   }
+
+  for (const auto fd : wakeup_fds_) {
+    if (fd != -1) {
+      close(fd);
+    }
+  }
 }
 
 Error
@@ -950,13 +963,6 @@ InferenceServerHttpClient::AsyncInfer(
   {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    auto insert_result = ongoing_async_requests_.emplace(std::make_pair(
-        reinterpret_cast<uintptr_t>(async_request->easy_handle_),
-        async_request));
-
-    if (!insert_result.second) {
-      return Error("Failed to insert new asynchronous request context.");
-    }
     async_request->Timer().CaptureTimestamp(RequestTimers::Kind::SEND_START);
     if (async_request->total_input_byte_size_ == 0) {
       // Set SEND_END here because CURLOPT_READFUNCTION will not be called if
@@ -964,10 +970,16 @@ InferenceServerHttpClient::AsyncInfer(
       // (send ends after sending request header).
       async_request->Timer().CaptureTimestamp(RequestTimers::Kind::SEND_END);
     }
-    curl_multi_add_handle(multi_handle_, async_request->easy_handle_);
+    // The transfer thread owns the multi handle, hand the request over
+    // and wake it up. Submission never blocks on ongoing transfers.
+    pending_async_requests_.emplace_back(std::move(async_request));
   }
 
   cv_.notify_all();
+  if (wakeup_fds_[1] != -1) {
+    char wake_byte = 0;
+    (void)!write(wakeup_fds_[1], &wake_byte, 1);
+  }
   return Error::Success;
 }
 
@@ -976,6 +988,23 @@ InferenceServerHttpClient::InferenceServerHttpClient(
     : InferenceServerClient(verbose), url_(url),
       multi_handle_(curl_multi_init())
 {
+  if (multi_handle_ != nullptr) {
+    // Keep completed connections pooled for reuse instead of closing
+    // them, and multiplex concurrent transfers over a shared
+    // connection when the server supports it. Both are required for
+    // the client to sustain a large number of concurrent inferences.
+    curl_multi_setopt(multi_handle_, CURLMOPT_MAXCONNECTS, 128L);
+    curl_multi_setopt(multi_handle_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  }
+
+  // The transfer thread blocks in curl_multi_wait(), the pipe wakes it
+  // when a request is submitted.
+  wakeup_fds_[0] = -1;
+  wakeup_fds_[1] = -1;
+  if (pipe(wakeup_fds_) == 0) {
+    fcntl(wakeup_fds_[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakeup_fds_[1], F_SETFL, O_NONBLOCK);
+  }
 }
 
 
@@ -1278,15 +1307,31 @@ InferenceServerHttpClient::AsyncTransfer()
   do {
     std::vector<std::shared_ptr<HttpInferRequest>> request_list;
 
-    // sleep if no work is available
-    std::unique_lock<std::mutex> lock(mutex_);
-    cv_.wait(lock, [this] {
-      if (this->exiting_) {
-        return true;
+    {
+      // Sleep if no work is available. While transfers are in flight
+      // the thread blocks in curl_multi_wait() below instead, so the
+      // lock is only held long enough to ingest new requests.
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] {
+        if (this->exiting_) {
+          return true;
+        }
+        // wake up if an async request has been generated
+        return !(this->ongoing_async_requests_.empty() &&
+                 this->pending_async_requests_.empty());
+      });
+
+      // Move the newly submitted requests onto the multi handle. Only
+      // this thread operates on the multi handle so the transfers
+      // proceed without serializing against request submission.
+      for (auto& request : pending_async_requests_) {
+        ongoing_async_requests_.emplace(
+            reinterpret_cast<uintptr_t>(request->easy_handle_), request);
+        curl_multi_add_handle(multi_handle_, request->easy_handle_);
       }
-      // wake up if an async request has been generated
-      return !this->ongoing_async_requests_.empty();
-    });
+      pending_async_requests_.clear();
+    }
+
     curl_multi_perform(multi_handle_, &place_holder);
     while ((msg = curl_multi_info_read(multi_handle_, &place_holder))) {
       // update request status
@@ -1320,7 +1365,6 @@ InferenceServerHttpClient::AsyncTransfer()
       }
       async_request->http_status_ = msg->data.result;
     }
-    lock.unlock();
 
     for (auto& this_request : request_list) {
       InferResult* result;
@@ -1329,6 +1373,28 @@ InferenceServerHttpClient::AsyncTransfer()
           this_request->response_json_size_);
       this_request->callback_(result);
     }
+
+    if (exiting_) {
+      break;
+    }
+
+    // Wait for activity on the ongoing transfers, bounded so that the
+    // loop periodically re-evaluates 'exiting_'. A byte on the wakeup
+    // pipe reports a newly submitted request.
+    if (!ongoing_async_requests_.empty()) {
+      struct curl_waitfd wakeup;
+      wakeup.fd = wakeup_fds_[0];
+      wakeup.events = CURL_WAIT_POLLIN;
+      wakeup.revents = 0;
+      const int extra_fds = (wakeup_fds_[0] != -1) ? 1 : 0;
+      curl_multi_wait(
+          multi_handle_, &wakeup, extra_fds, 500 /* ms */, &place_holder);
+      if (wakeup.revents != 0) {
+        char drain_buffer[64];
+        while (read(wakeup_fds_[0], drain_buffer, sizeof(drain_buffer)) > 0) {
+        }
+      }
+    }
   } while (!exiting_);
 }
 
@@ -27,6 +27,7 @@
 
 /// \file
 
+#include <deque>
 #include <map>
 #include <memory>
 #include "rapidjson/document.h"
@@ -400,11 +401,20 @@ class InferenceServerHttpClient : public InferenceServerClient {
   const std::string url_;
 
   using AsyncReqMap = std::map<uintptr_t, std::shared_ptr<HttpInferRequest>>;
-  // curl multi handle for processing asynchronous requests
+  // curl multi handle for processing asynchronous requests. Only the
+  // transfer thread operates on the multi handle so that transfers
+  // proceed without serializing against request submission.
   void* multi_handle_;
   // map to record ongoing asynchronous requests with pointer to easy handle
-  // or tag id as key
+  // or tag id as key. Only accessed by the transfer thread once it is
+  // running.
   AsyncReqMap ongoing_async_requests_;
+  // newly submitted asynchronous requests that the transfer thread has
+  // not yet moved onto the multi handle. Protected by 'mutex_'.
+  std::deque<std::shared_ptr<HttpInferRequest>> pending_async_requests_;
+  // A pipe used to wake the transfer thread out of curl_multi_wait()
+  // when a request is submitted or the client is destructed.
+  int wakeup_fds_[2];
 };
 
 }}}  // namespace nvidia::inferenceserver::client
@@ -0,0 +1,102 @@
+#!/usr/bin/env python
+# Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Compare a baseline file written by 'perf_client --baseline-file'
+# against a stored reference baseline and fail if the throughput of any
+# matching configuration regressed by more than the tolerance.
+
+import argparse
+import csv
+import sys
+
+FLAGS = None
+
+
+def read_baseline(path):
+    # Map (instance count, preferred batch size, concurrency, request
+    # rate) to (throughput, latency)
+    baseline = {}
+    with open(path, 'r') as f:
+        reader = csv.reader(f)
+        header = next(reader)
+        for row in reader:
+            if len(row) < 6:
+                continue
+            key = (row[0], row[1], row[2], row[3])
+            baseline[key] = (float(row[4]), float(row[5]))
+    return baseline
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--baseline',
+                        type=str,
+                        required=True,
+                        help='The stored reference baseline file')
+    parser.add_argument('--latest',
+                        type=str,
+                        required=True,
+                        help='The baseline file of the latest run')
+    parser.add_argument(
+        '--tolerance',
+        type=float,
+        default=5.0,
+        help='Allowed throughput regression in percent. Default is 5.')
+    FLAGS = parser.parse_args()
+
+    reference = read_baseline(FLAGS.baseline)
+    latest = read_baseline(FLAGS.latest)
+
+    regressed = False
+    compared = 0
+    for key, (ref_throughput, ref_latency) in sorted(reference.items()):
+        if key not in latest:
+            print("WARNING: configuration {} missing from latest run".format(
+                key))
+            continue
+        compared += 1
+        throughput, latency = latest[key]
+        delta_pct = 100.0 * (throughput -
+                             ref_throughput) / ref_throughput
+        status = "ok"
+        if delta_pct < -FLAGS.tolerance:
+            status = "REGRESSED"
+            regressed = True
+        print(
+            "instance_count={} preferred_batch_size={} concurrency={} "
+            "request_rate={}: {:.2f} infer/sec vs {:.2f} infer/sec "
+            "({:+.2f}%) {}".format(key[0], key[1], key[2], key[3], throughput,
+                                   ref_throughput, delta_pct, status))
+
+    if compared == 0:
+        print("no matching configurations between baseline and latest run")
+        sys.exit(1)
+    if regressed:
+        print("throughput regressed by more than {}% for at least one "
+              "configuration".format(FLAGS.tolerance))
+        sys.exit(1)
+    sys.exit(0)
@@ -316,7 +316,7 @@ ConcurrencyManager::Infer(
                   std::lock_guard<std::mutex> lock(thread_stat->mu_);
                   thread_stat->request_timestamps_.emplace_back(std::make_tuple(
                       start_time_async, end_time_async, flags,
-                      false /* delayed */));
+                      false /* delayed */, uint64_t(0) /* lateness */));
                   ctxs[ctx_id]->ctx_->GetStat(
                       &(thread_stat->contexts_stat_[ctx_id]));
                 }
@@ -353,7 +353,8 @@ ConcurrencyManager::Infer(
           // locking
           std::lock_guard<std::mutex> lock(thread_stat->mu_);
           thread_stat->request_timestamps_.emplace_back(std::make_tuple(
-              start_time_sync, end_time_sync, flags, false /* delayed */));
+              start_time_sync, end_time_sync, flags, false /* delayed */,
+              uint64_t(0) /* lateness */));
           ctxs[ctx_id]->ctx_->GetStat(&(thread_stat->contexts_stat_[ctx_id]));
         }
         free_ctx_ids.push(ctx_id);
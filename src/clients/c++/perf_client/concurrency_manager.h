@@ -80,9 +80,10 @@ class ConcurrencyManager : public LoadManager {
   /// 'concurrent_request_count' (by creating or pausing threads)
   /// \param concurent_request_count The number of concurrent requests.
   /// \return Error object indicating success or failure.
-  nic::Error ChangeConcurrencyLevel(const size_t concurrent_request_count);
+  virtual nic::Error ChangeConcurrencyLevel(
+      const size_t concurrent_request_count);
 
- private:
+ protected:
   ConcurrencyManager(
       const bool async,
       const std::unordered_map<std::string, std::vector<int64_t>>& input_shapes,
@@ -91,6 +92,7 @@ class ConcurrencyManager : public LoadManager {
       const SharedMemoryType shared_memory_type, const size_t output_shm_size,
       const std::shared_ptr<ContextFactory>& factory);
 
+ private:
   struct ThreadConfig {
     ThreadConfig(size_t thread_id)
         : thread_id_(thread_id), concurrency_(0),
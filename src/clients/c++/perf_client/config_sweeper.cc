@@ -0,0 +1,172 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/clients/c++/perf_client/config_sweeper.h"
+
+#include <google/protobuf/text_format.h>
+#include <fstream>
+#include <sstream>
+#include "src/core/model_config.h"
+
+nic::Error
+ConfigSweeper::Create(
+    const std::string& model_repository_path,
+    const std::vector<int64_t>& instance_counts,
+    const std::vector<int64_t>& preferred_batch_sizes,
+    const std::shared_ptr<ContextFactory>& factory,
+    std::unique_ptr<ConfigSweeper>* sweeper)
+{
+  const std::string config_path = model_repository_path + "/" +
+                                  factory->ModelName() + "/config.pbtxt";
+
+  std::ifstream config_file(config_path);
+  if (!config_file.good()) {
+    return nic::Error(
+        ni::RequestStatusCode::INVALID_ARG,
+        "failed to open model configuration '" + config_path + "'");
+  }
+  std::stringstream original_config;
+  original_config << config_file.rdbuf();
+
+  // Validate that the configuration parses before the sweep mangles it
+  ni::ModelConfig parsed_config;
+  if (!google::protobuf::TextFormat::ParseFromString(
+          original_config.str(), &parsed_config)) {
+    return nic::Error(
+        ni::RequestStatusCode::INVALID_ARG,
+        "failed to parse model configuration '" + config_path + "'");
+  }
+
+  std::unique_ptr<ConfigSweeper> local_sweeper(new ConfigSweeper(
+      config_path, factory->ModelName(), original_config.str()));
+
+  // Sweep the cross product of the requested values. An empty list
+  // leaves the corresponding setting at its original value.
+  std::vector<int64_t> counts = instance_counts;
+  if (counts.empty()) {
+    counts.push_back(0);
+  }
+  std::vector<int64_t> batch_sizes = preferred_batch_sizes;
+  if (batch_sizes.empty()) {
+    batch_sizes.push_back(0);
+  }
+  for (const auto count : counts) {
+    for (const auto batch_size : batch_sizes) {
+      local_sweeper->configs_.emplace_back(count, batch_size);
+    }
+  }
+
+  RETURN_IF_ERROR(
+      factory->CreateModelControlContext(&local_sweeper->control_ctx_));
+
+  *sweeper = std::move(local_sweeper);
+  return nic::Error::Success;
+}
+
+ConfigSweeper::ConfigSweeper(
+    const std::string& config_path, const std::string& model_name,
+    const std::string& original_config)
+    : config_path_(config_path), model_name_(model_name),
+      original_config_(original_config), config_modified_(false)
+{
+}
+
+ConfigSweeper::~ConfigSweeper()
+{
+  if (config_modified_) {
+    nic::Error err = RestoreOriginalConfig();
+    if (!err.IsOk()) {
+      std::cerr << "WARNING: failed to restore original configuration of "
+                << "model '" << model_name_ << "': " << err.Message()
+                << std::endl;
+    }
+  }
+}
+
+nic::Error
+ConfigSweeper::ApplyConfig(const SweepConfig& config)
+{
+  ni::ModelConfig model_config;
+  if (!google::protobuf::TextFormat::ParseFromString(
+          original_config_, &model_config)) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "failed to parse model configuration '" + config_path_ + "'");
+  }
+
+  if (config.instance_count_ > 0) {
+    if (model_config.instance_group_size() == 0) {
+      model_config.add_instance_group();
+    }
+    for (auto& group : *model_config.mutable_instance_group()) {
+      group.set_count(config.instance_count_);
+    }
+  }
+  if (config.preferred_batch_size_ > 0) {
+    auto* dynamic_batching = model_config.mutable_dynamic_batching();
+    dynamic_batching->clear_preferred_batch_size();
+    dynamic_batching->add_preferred_batch_size(config.preferred_batch_size_);
+  }
+
+  std::string config_text;
+  if (!google::protobuf::TextFormat::PrintToString(
+          model_config, &config_text)) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "failed to serialize the updated model configuration");
+  }
+
+  return WriteConfigAndReload(config_text);
+}
+
+nic::Error
+ConfigSweeper::RestoreOriginalConfig()
+{
+  RETURN_IF_ERROR(WriteConfigAndReload(original_config_));
+  config_modified_ = false;
+  return nic::Error::Success;
+}
+
+nic::Error
+ConfigSweeper::WriteConfigAndReload(const std::string& config_text)
+{
+  {
+    std::ofstream config_file(config_path_, std::ofstream::trunc);
+    if (!config_file.good()) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "failed to open model configuration '" + config_path_ +
+              "' for writing");
+    }
+    config_file << config_text;
+  }
+  config_modified_ = true;
+
+  // Reloading a model that is already loaded picks up the latest
+  // configuration.
+  RETURN_IF_ERROR(control_ctx_->Load(model_name_));
+  return nic::Error::Success;
+}
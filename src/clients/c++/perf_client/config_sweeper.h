@@ -0,0 +1,117 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "src/clients/c++/perf_client/context_factory.h"
+#include "src/clients/c++/perf_client/perf_utils.h"
+
+//==============================================================================
+/// ConfigSweeper is a helper class that iterates a model over a set of
+/// server-side configurations (instance count and dynamic batcher
+/// preferred batch size) so that perf_client can measure each one and
+/// answer which configuration performs best on the deployed hardware.
+///
+/// The sweeper rewrites the config.pbtxt of the model in a local copy
+/// of the model repository that the server is also watching, and
+/// triggers a reload through the model control API. The server must
+/// therefore run with --model-control-mode=explicit (or with polling
+/// enabled) on the same repository.
+///
+class ConfigSweeper {
+ public:
+  /// A single server-side configuration to measure.
+  struct SweepConfig {
+    SweepConfig(int64_t instance_count, int64_t preferred_batch_size)
+        : instance_count_(instance_count),
+          preferred_batch_size_(preferred_batch_size)
+    {
+    }
+
+    // The instance count to set on every instance group, 0 to leave
+    // the instance groups untouched.
+    int64_t instance_count_;
+    // The preferred batch size to set on the dynamic batcher, 0 to
+    // leave the dynamic batcher untouched.
+    int64_t preferred_batch_size_;
+  };
+
+  ~ConfigSweeper();
+
+  /// Create a sweeper over the cross product of the given instance
+  /// counts and preferred batch sizes.
+  /// \param model_repository_path The local path to the model repository
+  /// served by the inference server.
+  /// \param instance_counts The instance counts to sweep, may be empty.
+  /// \param preferred_batch_sizes The dynamic batcher preferred batch
+  /// sizes to sweep, may be empty.
+  /// \param factory The ContextFactory object used to create the model
+  /// control context.
+  /// \param sweeper Returns a new ConfigSweeper object.
+  /// \return Error object indicating success or failure.
+  static nic::Error Create(
+      const std::string& model_repository_path,
+      const std::vector<int64_t>& instance_counts,
+      const std::vector<int64_t>& preferred_batch_sizes,
+      const std::shared_ptr<ContextFactory>& factory,
+      std::unique_ptr<ConfigSweeper>* sweeper);
+
+  /// \return The configurations to measure.
+  const std::vector<SweepConfig>& Configs() const { return configs_; }
+
+  /// Rewrite the model configuration as described by 'config' and
+  /// reload the model on the server.
+  /// \param config The configuration to apply.
+  /// \return Error object indicating success or failure.
+  nic::Error ApplyConfig(const SweepConfig& config);
+
+  /// Restore the original model configuration and reload the model.
+  /// \return Error object indicating success or failure.
+  nic::Error RestoreOriginalConfig();
+
+ private:
+  ConfigSweeper(
+      const std::string& config_path, const std::string& model_name,
+      const std::string& original_config);
+
+  /// Write the given configuration text to config.pbtxt and reload the
+  /// model on the server.
+  /// \param config_text The configuration in protobuf text format.
+  /// \return Error object indicating success or failure.
+  nic::Error WriteConfigAndReload(const std::string& config_text);
+
+  const std::string config_path_;
+  const std::string model_name_;
+  // The configuration text found before the sweep, restored when the
+  // sweep completes.
+  const std::string original_config_;
+  bool config_modified_;
+
+  std::vector<SweepConfig> configs_;
+  std::unique_ptr<nic::ModelControlContext> control_ctx_;
+};
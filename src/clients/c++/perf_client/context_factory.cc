@@ -127,6 +127,20 @@ ContextFactory::CreateInferContext(std::unique_ptr<nic::InferContext>* ctx)
 }
 
 
+nic::Error
+ContextFactory::CreateModelControlContext(
+    std::unique_ptr<nic::ModelControlContext>* ctx)
+{
+  nic::Error err;
+  if (protocol_ == ProtocolType::HTTP) {
+    err = nic::ModelControlHttpContext::Create(
+        ctx, url_, http_headers_, verbose_);
+  } else {
+    err = nic::ModelControlGrpcContext::Create(ctx, url_, verbose_);
+  }
+  return err;
+}
+
 nic::Error
 ContextFactory::CreateSharedMemoryControlContext(
     std::unique_ptr<nic::SharedMemoryControlContext>* ctx)
@@ -77,6 +77,11 @@ class ContextFactory {
   nic::Error CreateSharedMemoryControlContext(
       std::unique_ptr<nic::SharedMemoryControlContext>* ctx);
 
+  /// Create a Model Control Context.
+  /// \param ctx Returns a new ModelControlContext object.
+  nic::Error CreateModelControlContext(
+      std::unique_ptr<nic::ModelControlContext>* ctx);
+
   /// \return The model name.
   const std::string& ModelName() const { return model_name_; }
 
@@ -71,7 +71,8 @@ CustomLoadManager::CustomLoadManager(
           async, input_shapes, Distribution::CUSTOM, batch_size,
           measurement_window_ms, max_threads, num_of_sequences, sequence_length,
           shared_memory_type, output_shm_size, factory),
-      request_intervals_file_(request_intervals_file)
+      request_intervals_file_(request_intervals_file),
+      has_trace_fields_(false)
 {
 }
 
@@ -79,20 +80,101 @@ nic::Error
 CustomLoadManager::InitCustomIntervals()
 {
   schedule_.clear();
+  trace_.clear();
   schedule_.emplace_back(0);
   if (!request_intervals_file_.empty()) {
-    RETURN_IF_ERROR(
-        ReadTimeIntervalsFile(request_intervals_file_, &custom_intervals_));
+    RETURN_IF_ERROR(ParseTraceFile(request_intervals_file_));
     size_t index = 0;
+    if (has_trace_fields_) {
+      trace_.emplace_back(custom_trace_[0]);
+    }
     while (schedule_.back() < *gen_duration_) {
       std::chrono::nanoseconds next_timestamp(
-          schedule_.back() + custom_intervals_[index++]);
+          schedule_.back() + custom_intervals_[index]);
       schedule_.emplace_back(next_timestamp);
+      index++;
       if (index == custom_intervals_.size()) {
         index = 0;
       }
+      if (has_trace_fields_) {
+        trace_.emplace_back(custom_trace_[index]);
+      }
+    }
+  }
+  return nic::Error::Success;
+}
+
+nic::Error
+CustomLoadManager::ParseTraceFile(const std::string& path)
+{
+  custom_intervals_.clear();
+  custom_trace_.clear();
+  has_trace_fields_ = false;
+
+  std::vector<std::string> lines;
+  RETURN_IF_ERROR(ReadTextFile(path, &lines));
+
+  for (const auto& line : lines) {
+    TraceEntry entry;
+    const size_t interval_end = line.find(',');
+    try {
+      custom_intervals_.emplace_back(
+          std::stol(line.substr(0, interval_end)) * 1000);
+
+      if (interval_end != std::string::npos) {
+        std::string remainder = line.substr(interval_end + 1);
+        const size_t data_end = remainder.find(',');
+        std::string data_str = remainder.substr(0, data_end);
+        if (!data_str.empty()) {
+          const size_t colon = data_str.find(':');
+          if (colon == std::string::npos) {
+            return nic::Error(
+                ni::RequestStatusCode::INVALID_ARG,
+                "trace data reference must be '<stream>:<step>'. Got '" +
+                    data_str + "' in file '" + path + "'");
+          }
+          entry.stream_id_ = std::stoull(data_str.substr(0, colon));
+          entry.step_id_ = std::stoull(data_str.substr(colon + 1));
+          entry.has_data_ = true;
+          has_trace_fields_ = true;
+        }
+        if (data_end != std::string::npos) {
+          entry.corr_id_ = std::stoull(remainder.substr(data_end + 1));
+          has_trace_fields_ = true;
+        }
+      }
+    }
+    catch (const std::exception& e) {
+      return nic::Error(
+          ni::RequestStatusCode::INVALID_ARG,
+          "failed to parse trace line '" + line + "' in file '" + path + "'");
+    }
+
+    if (entry.has_data_) {
+      if (!using_json_data_) {
+        return nic::Error(
+            ni::RequestStatusCode::INVALID_ARG,
+            "the trace references input data but no json data was provided "
+            "with --input-data");
+      }
+      if ((entry.stream_id_ >= data_loader_->GetDataStreamsCount()) ||
+          (entry.step_id_ >= data_loader_->GetTotalSteps(entry.stream_id_))) {
+        return nic::Error(
+            ni::RequestStatusCode::INVALID_ARG,
+            "trace data reference '" + std::to_string(entry.stream_id_) + ":" +
+                std::to_string(entry.step_id_) +
+                "' is outside the provided input data");
+      }
     }
+
+    custom_trace_.emplace_back(entry);
+  }
+
+  if (custom_intervals_.empty()) {
+    return nic::Error(
+        ni::RequestStatusCode::INVALID_ARG, "file '" + path + "' is empty");
   }
+
   return nic::Error::Success;
 }
 
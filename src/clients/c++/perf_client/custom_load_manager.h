@@ -32,6 +32,18 @@
 /// inference server in accordance with  user provided time intervals. This
 /// load manager can be used to model certain patterns of interest.
 ///
+/// In addition to a plain time interval, each line of the trace file may
+/// record per-request replay information captured from production:
+///
+///   <interval us>[,<stream>:<step>][,<correlation id>]
+///
+/// The stream and step reference the input data provided with
+/// --input-data (a json file may record a different payload and shape
+/// for every step), so the replayed load reproduces the production
+/// shape and payload distribution. The correlation ID keeps the
+/// requests of a production sequence on the same sequence slot when
+/// measuring a sequence model.
+///
 class CustomLoadManager : public RequestRateManager {
  public:
   ~CustomLoadManager() = default;
@@ -94,6 +106,17 @@ class CustomLoadManager : public RequestRateManager {
       const SharedMemoryType shared_memory_type, const size_t output_shm_size,
       const std::shared_ptr<ContextFactory>& factory);
 
+  /// Parses the trace file into the custom intervals and the
+  /// per-request replay information, validating any data references
+  /// against the loaded input data.
+  /// \param path The path to the trace file.
+  /// \return Error object indicating success or failure.
+  nic::Error ParseTraceFile(const std::string& path);
+
   std::string request_intervals_file_;
   std::vector<std::chrono::nanoseconds> custom_intervals_;
+  // Per-request replay information parallel to 'custom_intervals_'.
+  std::vector<TraceEntry> custom_trace_;
+  // True if any trace line recorded more than a time interval.
+  bool has_trace_fields_;
 };
@@ -29,6 +29,10 @@
 #include <b64/decode.h>
 #include "src/core/model_config.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <fstream>
 #include "rapidjson/filereadstream.h"
 
@@ -41,6 +45,15 @@ DataLoader::DataLoader(
 {
 }
 
+DataLoader::~DataLoader()
+{
+  for (auto& mapped_file : mmap_input_data_) {
+    munmap(
+        const_cast<uint8_t*>(mapped_file.second.addr_),
+        mapped_file.second.length_);
+  }
+}
+
 nic::Error
 DataLoader::ReadDataFromDir(
     std::vector<std::shared_ptr<nic::InferContext::Input>> inputs,
@@ -55,16 +68,19 @@ DataLoader::ReadDataFromDir(
       const auto file_path = data_directory + "/" + input->Name();
       std::string key_name(
           input->Name() + "_" + std::to_string(0) + "_" + std::to_string(0));
-      auto it = input_data_.emplace(key_name, std::vector<char>()).first;
-      RETURN_IF_ERROR(ReadFile(file_path, &it->second));
+      // Memory-map the file rather than copying it into a buffer so
+      // that large data files do not inflate the load time or the
+      // memory usage of the client.
+      RETURN_IF_ERROR(MapInputDataFile(file_path, key_name));
       size_t batch1_size = input->ByteSize();
-      if (batch1_size != it->second.size()) {
+      const auto& mapped_file = mmap_input_data_[key_name];
+      if (batch1_size != mapped_file.length_) {
         return nic::Error(
             ni::RequestStatusCode::INVALID_ARG,
             "input '" + input->Name() + "' requires " +
                 std::to_string(batch1_size) +
                 " bytes for each batch, but provided data has " +
-                std::to_string(it->second.size()) + " bytes");
+                std::to_string(mapped_file.length_) + " bytes");
       }
     } else {
       const auto file_path = data_directory + "/" + input->Name();
@@ -228,8 +244,8 @@ DataLoader::GetInputData(
     std::shared_ptr<nic::InferContext::Input> input, const int stream_id,
     const int step_id, const uint8_t** data_ptr, size_t* batch1_size)
 {
-  // If json data is available then try to retrieve the data from there
-  if (!input_data_.empty()) {
+  // If user data is available then try to retrieve the data from there
+  if (!input_data_.empty() || !mmap_input_data_.empty()) {
     // validate if the indices conform to the vector sizes
     if (stream_id < 0 || stream_id >= (int)data_stream_cnt_) {
       return nic::Error(
@@ -248,6 +264,14 @@ DataLoader::GetInputData(
     std::string key_name(
         input->Name() + "_" + std::to_string(stream_id) + "_" +
         std::to_string(step_id));
+    // Memory-mapped files hold their data directly, serve the request
+    // from the mapping without any copy.
+    auto mmap_it = mmap_input_data_.find(key_name);
+    if (mmap_it != mmap_input_data_.end()) {
+      *batch1_size = mmap_it->second.length_;
+      *data_ptr = mmap_it->second.addr_;
+      return nic::Error::Success;
+    }
     // Get the data and the corresponding byte-size
     auto it = input_data_.find(key_name);
     if (it != input_data_.end()) {
@@ -430,3 +454,44 @@ DataLoader::ReadInputTensorData(
 
   return nic::Error::Success;
 }
+
+nic::Error
+DataLoader::MapInputDataFile(
+    const std::string& file_path, const std::string& key_name)
+{
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return nic::Error(
+        ni::RequestStatusCode::INVALID_ARG,
+        "failed to open file '" + file_path + "'");
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    close(fd);
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "failed to get the size of file '" + file_path + "'");
+  }
+
+  const size_t file_length = file_stat.st_size;
+  if (file_length == 0) {
+    close(fd);
+    return nic::Error(
+        ni::RequestStatusCode::INVALID_ARG,
+        "file '" + file_path + "' is empty");
+  }
+
+  void* addr = mmap(nullptr, file_length, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "failed to memory-map file '" + file_path + "'");
+  }
+
+  mmap_input_data_[key_name] =
+      MappedFile{reinterpret_cast<const uint8_t*>(addr), file_length};
+  return nic::Error::Success;
+}
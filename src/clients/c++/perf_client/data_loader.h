@@ -34,6 +34,7 @@ class DataLoader {
       size_t batch_size,
       const std::unordered_map<std::string, std::vector<int64_t>>&
           default_input_shapes);
+  ~DataLoader();
 
   /// Returns the total number of data steps that can be supported by a
   /// non-sequence model.
@@ -129,8 +130,27 @@ class DataLoader {
   // The maximum supported data step id for non-sequence model.
   size_t max_non_sequence_step_id_;
 
+  /// Helper function to memory-map the file holding the data for the
+  /// specified input. The mapping is read-only and is released in the
+  /// destructor; requests reference the mapped region directly so the
+  /// data is never copied into client memory.
+  /// \param file_path The path to the file containing the data.
+  /// \param key_name The key to use for retrieving the mapped data.
+  /// Returns error object indicating status
+  nic::Error MapInputDataFile(
+      const std::string& file_path, const std::string& key_name);
+
+  // A memory-mapped input data file.
+  struct MappedFile {
+    const uint8_t* addr_;
+    size_t length_;
+  };
+
   // User provided input data, it will be preferred over synthetic data
   std::unordered_map<std::string, std::vector<char>> input_data_;
+  // Memory-mapped input data files, keyed the same way as 'input_data_'
+  // and consulted first.
+  std::unordered_map<std::string, MappedFile> mmap_input_data_;
   std::unordered_map<std::string, std::vector<int64_t>> input_shapes_;
 
   // The default shapes to use if json doesn't provide shapes
@@ -80,6 +80,40 @@ ReportServerSideStats(const ServerSideStats& stats, const int iteration)
   return nic::Error(ni::RequestStatusCode::SUCCESS);
 }
 
+void
+ReportServerMetrics(const ServerMetrics& start, const ServerMetrics& end)
+{
+  const uint64_t inference_cnt =
+      end.inference_count - start.inference_count;
+  const uint64_t execution_cnt =
+      end.execution_count - start.execution_count;
+
+  std::cout << "  Server (metrics endpoint): " << std::endl;
+  if (start.has_gpu_metrics && end.has_gpu_metrics) {
+    // The utilization is a gauge, report the average of the two
+    // boundary samples.
+    std::cout << "    GPU utilization: "
+              << (100.0 * (start.gpu_utilization + end.gpu_utilization) / 2.0)
+              << "%" << std::endl;
+  }
+  std::cout << "    Inference count: " << inference_cnt << std::endl
+            << "    Execution count: " << execution_cnt << std::endl;
+  if (execution_cnt > 0) {
+    std::cout << "    Avg batch size: "
+              << ((double)inference_cnt / execution_cnt) << std::endl;
+  }
+  if (inference_cnt > 0) {
+    std::cout << "    Avg queue time: "
+              << ((end.queue_duration_us - start.queue_duration_us) /
+                  inference_cnt)
+              << " usec" << std::endl
+              << "    Avg compute time: "
+              << ((end.compute_duration_us - start.compute_duration_us) /
+                  inference_cnt)
+              << " usec" << std::endl;
+  }
+}
+
 nic::Error
 ReportClientSideStats(
     const ClientSideStats& stats, const int64_t percentile,
@@ -133,6 +167,11 @@ ReportClientSideStats(
     std::cout << "    Delayed Request Count: " << stats.delayed_request_count
               << std::endl;
   }
+  if (stats.schedule_error_max_ns != 0) {
+    std::cout << "    Send schedule error: avg "
+              << (stats.schedule_error_avg_ns / 1000) << " usec, max "
+              << (stats.schedule_error_max_ns / 1000) << " usec" << std::endl;
+  }
   if (on_sequence_model) {
     std::cout << "    Sequence count: " << stats.sequence_count << " ("
               << stats.sequence_per_sec << " seq/sec)" << std::endl;
@@ -148,6 +187,24 @@ ReportClientSideStats(
               << " latency: " << (percentile.second / 1000) << " usec"
               << std::endl;
   }
+  // Only meaningful when the load follows a schedule; matches the raw
+  // numbers exactly otherwise and is omitted.
+  if (stats.corrected_avg_latency_ns != stats.avg_latency_ns) {
+    std::cout << "    Corrected for coordinated omission (measured from "
+                 "intended send time):"
+              << std::endl;
+    if (percentile == -1) {
+      std::cout << "      Avg latency: "
+                << (stats.corrected_avg_latency_ns / 1000) << " usec"
+                << std::endl;
+    }
+    for (const auto& corrected_percentile :
+         stats.corrected_percentile_latency_ns) {
+      std::cout << "      p" << corrected_percentile.first << " latency: "
+                << (corrected_percentile.second / 1000) << " usec"
+                << std::endl;
+    }
+  }
 
   std::cout << client_library_detail << std::endl;
 
@@ -167,6 +224,11 @@ Report(
   std::cout << "  Server: " << std::endl;
   ReportServerSideStats(summary.server_stats, 1);
 
+  if (summary.has_server_metrics) {
+    ReportServerMetrics(
+        summary.server_metrics_start, summary.server_metrics_end);
+  }
+
   return nic::Error(ni::RequestStatusCode::SUCCESS);
 }
 
@@ -177,7 +239,7 @@ InferenceProfiler::Create(
     const bool verbose, const double stability_threshold,
     const uint64_t measurement_window_ms, const size_t max_trials,
     const int64_t percentile, const uint64_t latency_threshold_ms_,
-    std::shared_ptr<ContextFactory>& factory,
+    const std::string& metrics_url, std::shared_ptr<ContextFactory>& factory,
     std::unique_ptr<LoadManager> manager,
     std::unique_ptr<InferenceProfiler>* profiler)
 {
@@ -190,6 +252,12 @@ InferenceProfiler::Create(
       factory->Protocol(), factory->SchedulerType(), factory->ModelName(),
       factory->ModelVersion(), std::move(status_ctx), std::move(manager)));
 
+  if (!metrics_url.empty()) {
+    RETURN_IF_ERROR(MetricsCollector::Create(
+        metrics_url, factory->ModelName(),
+        &local_profiler->metrics_collector_));
+  }
+
   if (local_profiler->scheduler_type_ == ContextFactory::ENSEMBLE ||
       local_profiler->scheduler_type_ == ContextFactory::ENSEMBLE_SEQUENCE) {
     ni::ServerStatus server_status;
@@ -570,6 +638,22 @@ InferenceProfiler::Measure(PerfStatus& status_summary)
   RETURN_IF_ERROR(GetServerSideStatus(&start_status));
   RETURN_IF_ERROR(manager_->GetAccumulatedContextStat(&start_stat));
 
+  // Take the server metrics snapshot at the window boundaries so that
+  // the server-side view can be reported without correlating a
+  // separately collected scrape by wall clock. Failure to scrape only
+  // drops the metrics from the report, not the measurement.
+  bool has_server_metrics = false;
+  ServerMetrics metrics_start;
+  ServerMetrics metrics_end;
+  if (metrics_collector_ != nullptr) {
+    nic::Error metrics_err = metrics_collector_->Scrape(&metrics_start);
+    if (metrics_err.IsOk()) {
+      has_server_metrics = true;
+    } else {
+      std::cerr << "WARNING: " << metrics_err << std::endl;
+    }
+  }
+
   // Wait for specified time interval in msec
   std::this_thread::sleep_for(
       std::chrono::milliseconds((uint64_t)(measurement_window_ms_ * 1.2)));
@@ -580,6 +664,17 @@ InferenceProfiler::Measure(PerfStatus& status_summary)
   // before and after status.
   RETURN_IF_ERROR(GetServerSideStatus(&end_status));
 
+  if (has_server_metrics) {
+    nic::Error metrics_err = metrics_collector_->Scrape(&metrics_end);
+    if (!metrics_err.IsOk()) {
+      has_server_metrics = false;
+      std::cerr << "WARNING: " << metrics_err << std::endl;
+    }
+  }
+  status_summary.has_server_metrics = has_server_metrics;
+  status_summary.server_metrics_start = metrics_start;
+  status_summary.server_metrics_end = metrics_end;
+
   TimestampVector current_timestamps;
   RETURN_IF_ERROR(manager_->SwapTimestamps(current_timestamps));
 
@@ -603,13 +698,18 @@ InferenceProfiler::Summarize(
 
   // Get measurement from requests that fall within the time interval
   std::pair<uint64_t, uint64_t> valid_range = MeasurementTimestamp(timestamps);
+  std::vector<uint64_t> corrected_latencies;
   std::vector<uint64_t> latencies = ValidLatencyMeasurement(
-      timestamps, valid_range, valid_sequence_count, delayed_request_count);
+      timestamps, valid_range, valid_sequence_count, delayed_request_count,
+      &corrected_latencies);
 
   RETURN_IF_ERROR(SummarizeLatency(latencies, summary));
+  SummarizeCorrectedLatency(corrected_latencies, summary);
   RETURN_IF_ERROR(SummarizeClientStat(
       start_stat, end_stat, valid_range.second - valid_range.first,
       latencies.size(), valid_sequence_count, delayed_request_count, summary));
+  summary.raw_latencies_ns = std::move(latencies);
+  summary.corrected_latencies_ns = std::move(corrected_latencies);
 
   RETURN_IF_ERROR(
       SummarizeServerStats(start_status, end_status, &(summary.server_stats)));
@@ -654,7 +754,8 @@ std::vector<uint64_t>
 InferenceProfiler::ValidLatencyMeasurement(
     const TimestampVector& timestamps,
     const std::pair<uint64_t, uint64_t>& valid_range,
-    size_t& valid_sequence_count, size_t& delayed_request_count)
+    size_t& valid_sequence_count, size_t& delayed_request_count,
+    std::vector<uint64_t>* corrected_latencies)
 {
   std::vector<uint64_t> valid_latencies;
   valid_sequence_count = 0;
@@ -666,7 +767,13 @@ InferenceProfiler::ValidLatencyMeasurement(
       // Only counting requests that end within the time interval
       if ((request_end_ns >= valid_range.first) &&
           (request_end_ns <= valid_range.second)) {
-        valid_latencies.push_back(request_end_ns - request_start_ns);
+        const uint64_t latency_ns = request_end_ns - request_start_ns;
+        valid_latencies.push_back(latency_ns);
+        // The corrected latency is measured from the intended send
+        // time of the request instead of the actual send time so a
+        // stalled sender does not suppress the samples that should
+        // show the stall (coordinated omission).
+        corrected_latencies->push_back(latency_ns + std::get<4>(timestamp));
         if (std::get<2>(timestamp) &
             ni::InferRequestHeader::FLAG_SEQUENCE_END) {
           valid_sequence_count++;
@@ -680,6 +787,7 @@ InferenceProfiler::ValidLatencyMeasurement(
 
   // Always sort measured latencies as percentile will be reported as default
   std::sort(valid_latencies.begin(), valid_latencies.end());
+  std::sort(corrected_latencies->begin(), corrected_latencies->end());
 
   return valid_latencies;
 }
@@ -739,6 +847,34 @@ InferenceProfiler::SummarizeLatency(
   return nic::Error::Success;
 }
 
+void
+InferenceProfiler::SummarizeCorrectedLatency(
+    const std::vector<uint64_t>& latencies, PerfStatus& summary)
+{
+  summary.client_stats.corrected_avg_latency_ns = 0;
+  summary.client_stats.corrected_percentile_latency_ns.clear();
+  if (latencies.size() == 0) {
+    return;
+  }
+
+  uint64_t tol_latency_ns = 0;
+  for (const auto& latency : latencies) {
+    tol_latency_ns += latency;
+  }
+  summary.client_stats.corrected_avg_latency_ns =
+      tol_latency_ns / latencies.size();
+
+  std::set<size_t> percentiles{50, 90, 95, 99};
+  if (extra_percentile_) {
+    percentiles.emplace(percentile_);
+  }
+  for (const auto percentile : percentiles) {
+    size_t index = (percentile / 100.0) * (latencies.size() - 1) + 0.5;
+    summary.client_stats.corrected_percentile_latency_ns.emplace(
+        percentile, latencies[index]);
+  }
+}
+
 nic::Error
 InferenceProfiler::SummarizeClientStat(
     const nic::InferContext::Stat& start_stat,
@@ -753,6 +889,20 @@ InferenceProfiler::SummarizeClientStat(
   summary.client_stats.request_count = valid_request_count;
   summary.client_stats.sequence_count = valid_sequence_count;
   summary.client_stats.delayed_request_count = delayed_request_count;
+  summary.client_stats.schedule_error_avg_ns = 0;
+  summary.client_stats.schedule_error_max_ns = 0;
+  RequestRateManager* rate_manager =
+      dynamic_cast<RequestRateManager*>(manager_.get());
+  if (rate_manager != nullptr) {
+    uint64_t error_count, total_error_ns, max_error_ns;
+    rate_manager->GetAndResetScheduleError(
+        &error_count, &total_error_ns, &max_error_ns);
+    if (error_count != 0) {
+      summary.client_stats.schedule_error_avg_ns =
+          total_error_ns / error_count;
+      summary.client_stats.schedule_error_max_ns = max_error_ns;
+    }
+  }
   summary.client_stats.duration_ns = duration_ns;
   float client_duration_sec =
       (float)summary.client_stats.duration_ns / ni::NANOS_PER_SECOND;
@@ -29,6 +29,7 @@
 #include "src/clients/c++/perf_client/concurrency_manager.h"
 #include "src/clients/c++/perf_client/context_factory.h"
 #include "src/clients/c++/perf_client/custom_load_manager.h"
+#include "src/clients/c++/perf_client/metrics_collector.h"
 #include "src/clients/c++/perf_client/request_rate_manager.h"
 
 using ModelInfo = std::pair<std::string, int64_t>;
@@ -76,6 +77,16 @@ struct ClientSideStats {
   uint64_t sequence_count;
   // The number of requests that missed their schedule
   uint64_t delayed_request_count;
+  // The average and maximum time by which a request send missed its
+  // scheduled send time. Only non-zero for open-loop load managers
+  // that follow a precomputed schedule.
+  uint64_t schedule_error_avg_ns;
+  uint64_t schedule_error_max_ns;
+  // Latency summary corrected for coordinated omission: measured from
+  // the intended send time of each request instead of the actual send
+  // time. Matches the raw summary when there is no schedule.
+  uint64_t corrected_avg_latency_ns;
+  std::map<size_t, uint64_t> corrected_percentile_latency_ns;
   uint64_t duration_ns;
   uint64_t avg_latency_ns;
   // a ordered map of percentiles to be reported (<percentile, value> pair)
@@ -104,6 +115,19 @@ struct PerfStatus {
 
   // placeholder for the latency value that is used for conditional checking
   uint64_t stabilizing_latency_ns;
+
+  // Sorted request latencies measured within the window, both raw
+  // (from the actual send time) and corrected for coordinated omission
+  // (from the intended send time). Retained for histogram export.
+  std::vector<uint64_t> raw_latencies_ns;
+  std::vector<uint64_t> corrected_latencies_ns;
+
+  // Snapshots of the server Prometheus metrics taken at the start and
+  // end of the measurement window. Only valid when
+  // 'has_server_metrics' is true.
+  bool has_server_metrics;
+  ServerMetrics server_metrics_start;
+  ServerMetrics server_metrics_end;
 };
 
 
@@ -144,6 +168,8 @@ class InferenceProfiler {
   /// average latency will be reported and used as stable criteria.
   /// \param latency_threshold_ms The threshold on the latency measurements in
   /// microseconds.
+  /// \param metrics_url The url of the server metrics endpoint to scrape
+  /// at measurement window boundaries, empty to disable scraping.
   /// \param factory The ContextFactory object used to create InferContext.
   /// \param manager Returns a new InferenceProfiler object.
   /// \return Error object indicating success or failure.
@@ -151,7 +177,7 @@ class InferenceProfiler {
       const bool verbose, const double stability_threshold,
       const uint64_t measurement_window_ms, const size_t max_trials,
       const int64_t percentile, const uint64_t latency_threshold_ms,
-      std::shared_ptr<ContextFactory>& factory,
+      const std::string& metrics_url, std::shared_ptr<ContextFactory>& factory,
       std::unique_ptr<LoadManager> manager,
       std::unique_ptr<InferenceProfiler>* profiler);
 
@@ -331,12 +357,16 @@ class InferenceProfiler {
   /// \param valid_sequence_count Returns the number of completed sequences
   /// during the measurement. A sequence is a set of correlated requests sent to
   /// sequence model.
+  /// \param corrected_latencies Returns the sorted latencies measured
+  /// from the intended send time of each request to correct for
+  /// coordinated omission.
   /// \return the vector of request latencies where the requests are completed
   /// within the measurement window.
   std::vector<uint64_t> ValidLatencyMeasurement(
       const TimestampVector& timestamps,
       const std::pair<uint64_t, uint64_t>& valid_range,
-      size_t& valid_sequence_count, size_t& delayed_request_count);
+      size_t& valid_sequence_count, size_t& delayed_request_count,
+      std::vector<uint64_t>* corrected_latencies);
 
   /// \param latencies The vector of request latencies collected.
   /// \param summary Returns the summary that the latency related fields are
@@ -345,6 +375,13 @@ class InferenceProfiler {
   nic::Error SummarizeLatency(
       const std::vector<uint64_t>& latencies, PerfStatus& summary);
 
+  /// \param latencies The sorted coordinated-omission-corrected request
+  /// latencies collected.
+  /// \param summary Returns the summary that the corrected latency
+  /// fields are set.
+  void SummarizeCorrectedLatency(
+      const std::vector<uint64_t>& latencies, PerfStatus& summary);
+
   /// \param start_stat The accumulated context status at the start.
   /// \param end_stat The accumulated context status at the end.
   /// \param duration_ns The duration of the measurement in nsec.
@@ -410,5 +447,7 @@ class InferenceProfiler {
 
   std::unique_ptr<nic::ServerStatusContext> status_ctx_;
   std::unique_ptr<LoadManager> manager_;
+  // Scrapes the server metrics endpoint, nullptr when disabled.
+  std::unique_ptr<MetricsCollector> metrics_collector_;
   LoadParams load_parameters_;
 };
@@ -38,18 +38,19 @@ class LoadManager {
 
   /// Check if the load manager is working as expected.
   /// \return Error object indicating success or failure.
-  nic::Error CheckHealth();
+  virtual nic::Error CheckHealth();
 
   /// Swap the content of the timestamp vector recorded by the load
   /// manager with a new timestamp vector
   /// \param new_timestamps The timestamp vector to be swapped.
   /// \return Error object indicating success or failure.
-  nic::Error SwapTimestamps(TimestampVector& new_timestamps);
+  virtual nic::Error SwapTimestamps(TimestampVector& new_timestamps);
 
   /// Get the sum of all contexts' stat
   /// \param contexts_stat Returned the accumulated stat from all contexts
   /// in load manager
-  nic::Error GetAccumulatedContextStat(nic::InferContext::Stat* contexts_stat);
+  virtual nic::Error GetAccumulatedContextStat(
+      nic::InferContext::Stat* contexts_stat);
 
   /// \return the batch size used for the inference requests
   size_t BatchSize() const { return batch_size_; }
@@ -0,0 +1,173 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/clients/c++/perf_client/metrics_collector.h"
+
+#include <curl/curl.h>
+#include <sstream>
+
+namespace {
+
+size_t
+ExpositionHandler(void* contents, size_t size, size_t nmemb, void* userp)
+{
+  std::string* exposition = reinterpret_cast<std::string*>(userp);
+  exposition->append(reinterpret_cast<char*>(contents), size * nmemb);
+  return size * nmemb;
+}
+
+}  // namespace
+
+nic::Error
+MetricsCollector::Create(
+    const std::string& metrics_url, const std::string& model_name,
+    std::unique_ptr<MetricsCollector>* collector)
+{
+  if (metrics_url.empty()) {
+    return nic::Error(
+        ni::RequestStatusCode::INVALID_ARG, "metrics url must not be empty");
+  }
+
+  // Safe to call multiple times, libcurl reference counts the
+  // initializations.
+  if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL, "global initialization failed");
+  }
+
+  collector->reset(new MetricsCollector(metrics_url, model_name));
+  return nic::Error::Success;
+}
+
+MetricsCollector::MetricsCollector(
+    const std::string& metrics_url, const std::string& model_name)
+    : metrics_url_(metrics_url), model_name_(model_name)
+{
+}
+
+nic::Error
+MetricsCollector::Scrape(ServerMetrics* metrics)
+{
+  CURL* curl = curl_easy_init();
+  if (curl == nullptr) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL, "failed to initialize client curl");
+  }
+
+  std::string exposition;
+  curl_easy_setopt(curl, CURLOPT_URL, metrics_url_.c_str());
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, ExpositionHandler);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &exposition);
+
+  CURLcode res = curl_easy_perform(curl);
+  if (res != CURLE_OK) {
+    curl_easy_cleanup(curl);
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "failed to scrape metrics endpoint '" + metrics_url_ +
+            "': " + curl_easy_strerror(res));
+  }
+
+  long http_code = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+  curl_easy_cleanup(curl);
+  if (http_code != 200) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "metrics endpoint '" + metrics_url_ + "' returned status " +
+            std::to_string(http_code));
+  }
+
+  return ParseExposition(exposition, metrics);
+}
+
+nic::Error
+MetricsCollector::ParseExposition(
+    const std::string& exposition, ServerMetrics* metrics)
+{
+  *metrics = ServerMetrics();
+
+  const std::string model_label = "model=\"" + model_name_ + "\"";
+  double gpu_utilization_total = 0.0;
+  size_t gpu_count = 0;
+
+  std::istringstream stream(exposition);
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.empty() || (line[0] == '#')) {
+      continue;
+    }
+
+    // Each sample is '<name>[{<labels>}] <value>'
+    const size_t name_end = line.find_first_of("{ ");
+    const size_t value_begin = line.find_last_of(' ');
+    if ((name_end == std::string::npos) ||
+        (value_begin == std::string::npos) || (value_begin <= name_end)) {
+      continue;
+    }
+    const std::string name = line.substr(0, name_end);
+    const std::string labels = line.substr(name_end, value_begin - name_end);
+
+    double value;
+    try {
+      value = std::stod(line.substr(value_begin + 1));
+    }
+    catch (const std::exception& e) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "failed to parse metrics sample '" + line + "'");
+    }
+
+    if (name == "nv_gpu_utilization") {
+      gpu_utilization_total += value;
+      gpu_count++;
+      continue;
+    }
+
+    // The inference counters carry a model label, only accumulate the
+    // series of the profiled model.
+    if (labels.find(model_label) == std::string::npos) {
+      continue;
+    }
+    if (name == "nv_inference_count") {
+      metrics->inference_count += (uint64_t)value;
+    } else if (name == "nv_inference_exec_count") {
+      metrics->execution_count += (uint64_t)value;
+    } else if (name == "nv_inference_queue_duration_us") {
+      metrics->queue_duration_us += (uint64_t)value;
+    } else if (name == "nv_inference_compute_duration_us") {
+      metrics->compute_duration_us += (uint64_t)value;
+    }
+  }
+
+  if (gpu_count > 0) {
+    metrics->has_gpu_metrics = true;
+    metrics->gpu_utilization = gpu_utilization_total / gpu_count;
+  }
+
+  return nic::Error::Success;
+}
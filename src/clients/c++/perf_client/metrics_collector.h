@@ -0,0 +1,93 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <memory>
+#include <string>
+#include "src/clients/c++/perf_client/perf_utils.h"
+
+//==============================================================================
+/// A snapshot of the server-side Prometheus metrics that are relevant
+/// to a perf run. The counters are cumulative since server start, the
+/// difference of two snapshots gives the activity within a measurement
+/// window.
+///
+struct ServerMetrics {
+  ServerMetrics()
+      : has_gpu_metrics(false), gpu_utilization(0.0), inference_count(0),
+        execution_count(0), queue_duration_us(0), compute_duration_us(0)
+  {
+  }
+
+  // True if the server reported GPU metrics.
+  bool has_gpu_metrics;
+  // The utilization averaged across the reported GPUs [0.0 - 1.0).
+  double gpu_utilization;
+  // Cumulative counters for the profiled model.
+  uint64_t inference_count;
+  uint64_t execution_count;
+  uint64_t queue_duration_us;
+  uint64_t compute_duration_us;
+};
+
+//==============================================================================
+/// MetricsCollector is a helper class that scrapes the Prometheus
+/// metrics endpoint exposed by the inference server so that the
+/// server-side view of a measurement (GPU utilization, queue and
+/// compute time, batching) can be reported alongside the client-side
+/// latencies without correlating separate artifacts by wall clock.
+///
+class MetricsCollector {
+ public:
+  /// Create a collector that scrapes the given metrics endpoint.
+  /// \param metrics_url The url of the server metrics endpoint.
+  /// \param model_name The name of the model being profiled, used to
+  /// restrict the per-model counters to the profiled model.
+  /// \param collector Returns a new MetricsCollector object.
+  /// \return Error object indicating success or failure.
+  static nic::Error Create(
+      const std::string& metrics_url, const std::string& model_name,
+      std::unique_ptr<MetricsCollector>* collector);
+
+  /// Scrape the metrics endpoint and parse the result.
+  /// \param metrics Returns the snapshot of the server metrics.
+  /// \return Error object indicating success or failure.
+  nic::Error Scrape(ServerMetrics* metrics);
+
+ private:
+  MetricsCollector(
+      const std::string& metrics_url, const std::string& model_name);
+
+  /// Parse the Prometheus text exposition into a snapshot.
+  /// \param exposition The body returned by the metrics endpoint.
+  /// \param metrics Returns the snapshot of the server metrics.
+  /// \return Error object indicating success or failure.
+  nic::Error ParseExposition(
+      const std::string& exposition, ServerMetrics* metrics);
+
+  std::string metrics_url_;
+  std::string model_name_;
+};
@@ -0,0 +1,432 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/clients/c++/perf_client/multi_process_concurrency_manager.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+// Commands sent from the coordinator to the worker processes.
+constexpr char kCmdChangeConcurrency = 'c';
+constexpr char kCmdCheckHealth = 'h';
+constexpr char kCmdSwapTimestamps = 's';
+constexpr char kCmdGetContextStat = 'g';
+constexpr char kCmdExit = 'e';
+
+// Fixed-layout representation of one timestamp tuple for transfer over
+// the worker reply pipe.
+struct TimestampRecord {
+  int64_t start_sec;
+  int64_t start_nsec;
+  int64_t end_sec;
+  int64_t end_nsec;
+  uint32_t flags;
+  uint8_t delayed;
+  uint64_t schedule_lateness_ns;
+};
+
+// Fixed-layout representation of an InferContext::Stat for transfer over
+// the worker reply pipe.
+struct ContextStatRecord {
+  uint64_t completed_request_count;
+  uint64_t cumulative_total_request_time_ns;
+  uint64_t cumulative_send_time_ns;
+  uint64_t cumulative_receive_time_ns;
+};
+
+// Read exactly 'byte_size' bytes from 'fd', retrying on interruption.
+// Returns false on EOF or error.
+bool
+ReadAll(const int fd, void* buf, const size_t byte_size)
+{
+  uint8_t* pos = reinterpret_cast<uint8_t*>(buf);
+  size_t remaining = byte_size;
+  while (remaining > 0) {
+    const ssize_t rv = read(fd, pos, remaining);
+    if (rv < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (rv == 0) {
+      return false;
+    }
+    pos += rv;
+    remaining -= rv;
+  }
+  return true;
+}
+
+// Write exactly 'byte_size' bytes to 'fd', retrying on interruption.
+// Returns false on error.
+bool
+WriteAll(const int fd, const void* buf, const size_t byte_size)
+{
+  const uint8_t* pos = reinterpret_cast<const uint8_t*>(buf);
+  size_t remaining = byte_size;
+  while (remaining > 0) {
+    const ssize_t rv = write(fd, pos, remaining);
+    if (rv < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    pos += rv;
+    remaining -= rv;
+  }
+  return true;
+}
+
+// Write the status code of 'err' to 'fd'.
+bool
+WriteStatus(const int fd, const nic::Error& err)
+{
+  const int32_t code = static_cast<int32_t>(err.Code());
+  return WriteAll(fd, &code, sizeof(code));
+}
+
+}  // namespace
+
+nic::Error
+MultiProcessConcurrencyManager::Create(
+    const bool async, const int32_t batch_size, const size_t max_threads,
+    const size_t max_concurrency, const size_t sequence_length,
+    const size_t string_length, const std::string& string_data,
+    const bool zero_input,
+    const std::unordered_map<std::string, std::vector<int64_t>>& input_shapes,
+    std::vector<std::string>& user_data,
+    const SharedMemoryType shared_memory_type, const size_t output_shm_size,
+    const size_t num_processes, const std::shared_ptr<ContextFactory>& factory,
+    std::unique_ptr<LoadManager>* manager)
+{
+  std::unique_ptr<MultiProcessConcurrencyManager> local_manager(
+      new MultiProcessConcurrencyManager(
+          async, input_shapes, batch_size, max_threads, max_concurrency,
+          sequence_length, shared_memory_type, output_shm_size, factory));
+
+  // A worker that exits early must not kill the coordinator with
+  // SIGPIPE; the failed pipe write is detected and reported instead.
+  signal(SIGPIPE, SIG_IGN);
+
+  for (size_t i = 0; i < num_processes; i++) {
+    int cmd_pipe[2];
+    int rsp_pipe[2];
+    if ((pipe(cmd_pipe) != 0) || (pipe(rsp_pipe) != 0)) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "failed to create pipes for worker process: " +
+              std::string(strerror(errno)));
+    }
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "failed to fork worker process: " + std::string(strerror(errno)));
+    }
+
+    if (pid == 0) {
+      // Worker process. The coordinator owns interrupt handling; the
+      // worker exits when told to (or when the command pipe closes).
+      signal(SIGINT, SIG_IGN);
+      close(cmd_pipe[1]);
+      close(rsp_pipe[0]);
+      for (const auto& worker : local_manager->workers_) {
+        close(worker.cmd_fd_);
+        close(worker.rsp_fd_);
+      }
+
+      std::unique_ptr<LoadManager> worker_manager;
+      nic::Error err = ConcurrencyManager::Create(
+          async, batch_size, max_threads, max_concurrency, sequence_length,
+          string_length, string_data, zero_input, input_shapes, user_data,
+          shared_memory_type, output_shm_size, factory, &worker_manager);
+      WriteStatus(rsp_pipe[1], err);
+      if (err.IsOk()) {
+        WorkerLoop(cmd_pipe[0], rsp_pipe[1], worker_manager);
+      }
+      // Destroy the load manager (stopping its worker threads) before
+      // exiting without running the coordinator's exit handlers.
+      worker_manager.reset();
+      _exit(err.IsOk() ? 0 : 1);
+    }
+
+    // Coordinator process.
+    close(cmd_pipe[0]);
+    close(rsp_pipe[1]);
+
+    WorkerProcess worker;
+    worker.pid_ = pid;
+    worker.cmd_fd_ = cmd_pipe[1];
+    worker.rsp_fd_ = rsp_pipe[0];
+    local_manager->workers_.push_back(worker);
+
+    nic::Error init_status = local_manager->ReadWorkerStatus(worker);
+    if (!init_status.IsOk()) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "failed to initialize worker process " + std::to_string(i) + ": " +
+              init_status.Message());
+    }
+  }
+
+  *manager = std::move(local_manager);
+
+  return nic::Error::Success;
+}
+
+MultiProcessConcurrencyManager::MultiProcessConcurrencyManager(
+    const bool async,
+    const std::unordered_map<std::string, std::vector<int64_t>>& input_shapes,
+    const int32_t batch_size, const size_t max_threads,
+    const size_t max_concurrency, const size_t sequence_length,
+    const SharedMemoryType shared_memory_type, const size_t output_shm_size,
+    const std::shared_ptr<ContextFactory>& factory)
+    : ConcurrencyManager(
+          async, input_shapes, batch_size, max_threads, max_concurrency,
+          sequence_length, shared_memory_type, output_shm_size, factory)
+{
+}
+
+MultiProcessConcurrencyManager::~MultiProcessConcurrencyManager()
+{
+  for (const auto& worker : workers_) {
+    WriteAll(worker.cmd_fd_, &kCmdExit, sizeof(kCmdExit));
+  }
+  for (const auto& worker : workers_) {
+    close(worker.cmd_fd_);
+    close(worker.rsp_fd_);
+    int wstatus;
+    waitpid(worker.pid_, &wstatus, 0);
+  }
+}
+
+void
+MultiProcessConcurrencyManager::WorkerLoop(
+    const int cmd_fd, const int rsp_fd,
+    const std::unique_ptr<LoadManager>& manager)
+{
+  ConcurrencyManager* concurrency_manager =
+      dynamic_cast<ConcurrencyManager*>(manager.get());
+
+  while (true) {
+    char cmd;
+    if (!ReadAll(cmd_fd, &cmd, sizeof(cmd)) || (cmd == kCmdExit)) {
+      return;
+    }
+
+    switch (cmd) {
+      case kCmdChangeConcurrency: {
+        uint64_t concurrency;
+        if (!ReadAll(cmd_fd, &concurrency, sizeof(concurrency))) {
+          return;
+        }
+        WriteStatus(
+            rsp_fd, concurrency_manager->ChangeConcurrencyLevel(concurrency));
+        break;
+      }
+      case kCmdCheckHealth: {
+        WriteStatus(rsp_fd, manager->CheckHealth());
+        break;
+      }
+      case kCmdSwapTimestamps: {
+        TimestampVector timestamps;
+        nic::Error err = manager->SwapTimestamps(timestamps);
+        WriteStatus(rsp_fd, err);
+        if (err.IsOk()) {
+          const uint64_t count = timestamps.size();
+          WriteAll(rsp_fd, &count, sizeof(count));
+          for (const auto& timestamp : timestamps) {
+            TimestampRecord record;
+            record.start_sec = std::get<0>(timestamp).tv_sec;
+            record.start_nsec = std::get<0>(timestamp).tv_nsec;
+            record.end_sec = std::get<1>(timestamp).tv_sec;
+            record.end_nsec = std::get<1>(timestamp).tv_nsec;
+            record.flags = std::get<2>(timestamp);
+            record.delayed = std::get<3>(timestamp) ? 1 : 0;
+            record.schedule_lateness_ns = std::get<4>(timestamp);
+            WriteAll(rsp_fd, &record, sizeof(record));
+          }
+        }
+        break;
+      }
+      case kCmdGetContextStat: {
+        nic::InferContext::Stat stat;
+        nic::Error err = manager->GetAccumulatedContextStat(&stat);
+        WriteStatus(rsp_fd, err);
+        if (err.IsOk()) {
+          ContextStatRecord record;
+          record.completed_request_count = stat.completed_request_count;
+          record.cumulative_total_request_time_ns =
+              stat.cumulative_total_request_time_ns;
+          record.cumulative_send_time_ns = stat.cumulative_send_time_ns;
+          record.cumulative_receive_time_ns = stat.cumulative_receive_time_ns;
+          WriteAll(rsp_fd, &record, sizeof(record));
+        }
+        break;
+      }
+      default:
+        return;
+    }
+  }
+}
+
+nic::Error
+MultiProcessConcurrencyManager::BroadcastCommand(const char cmd)
+{
+  for (const auto& worker : workers_) {
+    if (!WriteAll(worker.cmd_fd_, &cmd, sizeof(cmd))) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "failed to send command to worker process");
+    }
+  }
+  return nic::Error::Success;
+}
+
+nic::Error
+MultiProcessConcurrencyManager::ReadWorkerStatus(const WorkerProcess& worker)
+{
+  int32_t code;
+  if (!ReadAll(worker.rsp_fd_, &code, sizeof(code))) {
+    return nic::Error(
+        ni::RequestStatusCode::INTERNAL,
+        "lost connection to worker process");
+  }
+  if (static_cast<ni::RequestStatusCode>(code) !=
+      ni::RequestStatusCode::SUCCESS) {
+    return nic::Error(
+        static_cast<ni::RequestStatusCode>(code),
+        "worker process reported failure");
+  }
+  return nic::Error::Success;
+}
+
+nic::Error
+MultiProcessConcurrencyManager::ChangeConcurrencyLevel(
+    const size_t concurrent_request_count)
+{
+  // Divide the requested concurrency as evenly as possible across the
+  // worker processes. Issue the command to every worker before reading
+  // any reply so the workers adjust in parallel.
+  const size_t base = concurrent_request_count / workers_.size();
+  const size_t remainder = concurrent_request_count % workers_.size();
+  for (size_t i = 0; i < workers_.size(); i++) {
+    const uint64_t concurrency = base + ((i < remainder) ? 1 : 0);
+    if (!WriteAll(
+            workers_[i].cmd_fd_, &kCmdChangeConcurrency,
+            sizeof(kCmdChangeConcurrency)) ||
+        !WriteAll(workers_[i].cmd_fd_, &concurrency, sizeof(concurrency))) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "failed to send command to worker process");
+    }
+  }
+
+  for (const auto& worker : workers_) {
+    RETURN_IF_ERROR(ReadWorkerStatus(worker));
+  }
+
+  return nic::Error::Success;
+}
+
+nic::Error
+MultiProcessConcurrencyManager::CheckHealth()
+{
+  RETURN_IF_ERROR(BroadcastCommand(kCmdCheckHealth));
+  for (const auto& worker : workers_) {
+    RETURN_IF_ERROR(ReadWorkerStatus(worker));
+  }
+  return nic::Error::Success;
+}
+
+nic::Error
+MultiProcessConcurrencyManager::SwapTimestamps(TimestampVector& new_timestamps)
+{
+  TimestampVector total_timestamp;
+
+  RETURN_IF_ERROR(BroadcastCommand(kCmdSwapTimestamps));
+  for (const auto& worker : workers_) {
+    RETURN_IF_ERROR(ReadWorkerStatus(worker));
+    uint64_t count;
+    if (!ReadAll(worker.rsp_fd_, &count, sizeof(count))) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "lost connection to worker process");
+    }
+    for (uint64_t i = 0; i < count; i++) {
+      TimestampRecord record;
+      if (!ReadAll(worker.rsp_fd_, &record, sizeof(record))) {
+        return nic::Error(
+            ni::RequestStatusCode::INTERNAL,
+            "lost connection to worker process");
+      }
+      struct timespec start;
+      start.tv_sec = record.start_sec;
+      start.tv_nsec = record.start_nsec;
+      struct timespec end;
+      end.tv_sec = record.end_sec;
+      end.tv_nsec = record.end_nsec;
+      total_timestamp.emplace_back(
+          start, end, record.flags, (record.delayed != 0),
+          record.schedule_lateness_ns);
+    }
+  }
+
+  // Swap the results
+  total_timestamp.swap(new_timestamps);
+  return nic::Error::Success;
+}
+
+nic::Error
+MultiProcessConcurrencyManager::GetAccumulatedContextStat(
+    nic::InferContext::Stat* contexts_stat)
+{
+  RETURN_IF_ERROR(BroadcastCommand(kCmdGetContextStat));
+  for (const auto& worker : workers_) {
+    RETURN_IF_ERROR(ReadWorkerStatus(worker));
+    ContextStatRecord record;
+    if (!ReadAll(worker.rsp_fd_, &record, sizeof(record))) {
+      return nic::Error(
+          ni::RequestStatusCode::INTERNAL,
+          "lost connection to worker process");
+    }
+    contexts_stat->completed_request_count += record.completed_request_count;
+    contexts_stat->cumulative_total_request_time_ns +=
+        record.cumulative_total_request_time_ns;
+    contexts_stat->cumulative_send_time_ns += record.cumulative_send_time_ns;
+    contexts_stat->cumulative_receive_time_ns +=
+        record.cumulative_receive_time_ns;
+  }
+  return nic::Error::Success;
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <sys/types.h>
+#include "src/clients/c++/perf_client/concurrency_manager.h"
+
+//==============================================================================
+/// MultiProcessConcurrencyManager generates the request load from multiple
+/// worker processes instead of multiple threads in a single process. At high
+/// concurrency a single client process can itself become the bottleneck
+/// (allocator contention, a single set of HTTP/GRPC channels) and under-drive
+/// the server; separate processes avoid sharing any client-library state.
+///
+/// Detail:
+/// The coordinator process forks the requested number of worker processes
+/// before any client contexts are created. Each worker runs an independent
+/// ConcurrencyManager and serves commands over a pipe: change concurrency,
+/// check health, swap timestamps and get accumulated context statistics.
+/// The coordinator implements the LoadManager interface by forwarding each
+/// operation to every worker and aggregating the replies, so the existing
+/// InferenceProfiler measurement and report are unchanged. The requested
+/// concurrency level is divided as evenly as possible across the workers.
+///
+class MultiProcessConcurrencyManager : public ConcurrencyManager {
+ public:
+  ~MultiProcessConcurrencyManager();
+
+  /// Create a manager that maintains the specified load on the inference
+  /// server using multiple worker processes.
+  /// \param async Whether to use asynchronous or synchronous API for infer
+  /// request.
+  /// \param batch_size The batch size used for each request.
+  /// \param max_threads The maximum number of working threads to be spawned
+  /// in each worker process.
+  /// \param max_concurrency The maximum concurrency which will be requested.
+  /// \param sequence_length The base length of each sequence.
+  /// \param zero_input Whether to fill the input tensors with zero.
+  /// \param input_shapes The shape of the input tensors.
+  /// \param user_data The vector containing path/paths to user-provided data
+  /// that can be a directory or path to a json data file.
+  /// \param shared_memory_type The type of shared memory to use for inputs.
+  /// \param output_shm_size The size in bytes of the shared memory to
+  /// allocate for the output.
+  /// \param num_processes The number of worker processes to fork.
+  /// \param factory The ContextFactory object used to create
+  /// InferContext.
+  /// \param manager Returns a new MultiProcessConcurrencyManager object.
+  /// \return Error object indicating success or failure.
+  static nic::Error Create(
+      const bool async, const int32_t batch_size, const size_t max_threads,
+      const size_t max_concurrency, const size_t sequence_length,
+      const size_t string_length, const std::string& string_data,
+      const bool zero_input,
+      const std::unordered_map<std::string, std::vector<int64_t>>& input_shapes,
+      std::vector<std::string>& user_data,
+      const SharedMemoryType shared_memory_type, const size_t output_shm_size,
+      const size_t num_processes,
+      const std::shared_ptr<ContextFactory>& factory,
+      std::unique_ptr<LoadManager>* manager);
+
+  /// Divides 'concurrent_request_count' across the worker processes and
+  /// instructs each worker to produce its share.
+  /// \param concurent_request_count The number of concurrent requests.
+  /// \return Error object indicating success or failure.
+  nic::Error ChangeConcurrencyLevel(
+      const size_t concurrent_request_count) override;
+
+  /// Check the health of every worker process.
+  /// \return Error object indicating success or failure.
+  nic::Error CheckHealth() override;
+
+  /// Gather the timestamps recorded by all worker processes.
+  /// \param new_timestamps The timestamp vector to be swapped.
+  /// \return Error object indicating success or failure.
+  nic::Error SwapTimestamps(TimestampVector& new_timestamps) override;
+
+  /// Get the sum of all worker processes' context stat.
+  /// \param contexts_stat Returned the accumulated stat from all workers.
+  nic::Error GetAccumulatedContextStat(
+      nic::InferContext::Stat* contexts_stat) override;
+
+ private:
+  MultiProcessConcurrencyManager(
+      const bool async,
+      const std::unordered_map<std::string, std::vector<int64_t>>& input_shapes,
+      const int32_t batch_size, const size_t max_threads,
+      const size_t max_concurrency, const size_t sequence_length,
+      const SharedMemoryType shared_memory_type, const size_t output_shm_size,
+      const std::shared_ptr<ContextFactory>& factory);
+
+  // A forked worker process and the pipe pair used to drive it. The
+  // coordinator writes commands to 'cmd_fd_' and reads replies from
+  // 'rsp_fd_'.
+  struct WorkerProcess {
+    pid_t pid_;
+    int cmd_fd_;
+    int rsp_fd_;
+  };
+
+  /// Command loop run by a worker process. Reads commands from 'cmd_fd',
+  /// applies them to 'manager' and writes the replies to 'rsp_fd'. Returns
+  /// when the exit command is received or the command pipe is closed.
+  static void WorkerLoop(
+      const int cmd_fd, const int rsp_fd,
+      const std::unique_ptr<LoadManager>& manager);
+
+  /// Send a single command byte to every worker.
+  nic::Error BroadcastCommand(const char cmd);
+
+  /// Read a status-code reply from the given worker and convert it to an
+  /// Error.
+  nic::Error ReadWorkerStatus(const WorkerProcess& worker);
+
+  std::vector<WorkerProcess> workers_;
+};
@@ -27,10 +27,12 @@
 #include <getopt.h>
 
 #include "src/clients/c++/perf_client/concurrency_manager.h"
+#include "src/clients/c++/perf_client/config_sweeper.h"
 #include "src/clients/c++/perf_client/context_factory.h"
 #include "src/clients/c++/perf_client/custom_load_manager.h"
 #include "src/clients/c++/perf_client/inference_profiler.h"
 #include "src/clients/c++/perf_client/load_manager.h"
+#include "src/clients/c++/perf_client/multi_process_concurrency_manager.h"
 #include "src/clients/c++/perf_client/perf_utils.h"
 #include "src/clients/c++/perf_client/request_rate_manager.h"
 
@@ -228,6 +230,7 @@ Usage(char** argv, const std::string& msg = std::string())
   std::cerr << "\t--latency-threshold (-l) <latency threshold (in msec)>"
             << std::endl;
   std::cerr << "\t--max-threads <thread counts>" << std::endl;
+  std::cerr << "\t--worker-processes <process count>" << std::endl;
   std::cerr << "\t--stability-percentage (-s) <deviation threshold for stable "
                "measurement (in percentage)>"
             << std::endl;
@@ -257,9 +260,21 @@ Usage(char** argv, const std::string& msg = std::string())
   std::cerr << "\t-u <URL for inference service>" << std::endl;
   std::cerr << "\t-i <Protocol used to communicate with inference service>"
             << std::endl;
+  std::cerr << "\t--metrics-url <URL for server metrics endpoint>" << std::endl;
   std::cerr << std::endl;
   std::cerr << "IV. OTHER OPTIONS: " << std::endl;
   std::cerr << "\t-f <filename for storing report in csv format>" << std::endl;
+  std::cerr << "\t--latency-histogram <filename for storing latency "
+               "distributions in csv format>"
+            << std::endl;
+  std::cerr << "\t--sweep-model-repository <path to model repository>"
+            << std::endl;
+  std::cerr << "\t--sweep-instance-counts <comma separated list>" << std::endl;
+  std::cerr << "\t--sweep-preferred-batch-sizes <comma separated list>"
+            << std::endl;
+  std::cerr << "\t--baseline-file <filename for storing sweep baseline in "
+               "csv format>"
+            << std::endl;
   std::cerr << "\t-H <HTTP header>" << std::endl;
   std::cerr << "\t--streaming" << std::endl;
   std::cerr << std::endl;
@@ -404,6 +419,18 @@ Usage(char** argv, const std::string& msg = std::string())
              "is specified otherwise default is 16.",
              18)
       << std::endl;
+  std::cerr
+      << FormatMessage(
+             " --worker-processes: Sets the number of worker processes used "
+             "to generate the request load. At high concurrency a single "
+             "client process can itself become the bottleneck and under-drive "
+             "the server; with more than one worker process the requested "
+             "concurrency is divided across independent processes and the "
+             "measurements are aggregated into a single report. Only "
+             "supported for concurrency measurement on non-sequence models "
+             "without shared memory. Default is 1.",
+             18)
+      << std::endl;
   std::cerr
       << FormatMessage(
              " --stability-percentage (-s): Indicates the allowed variation in "
@@ -527,6 +554,17 @@ Usage(char** argv, const std::string& msg = std::string())
                    "are gRPC and HTTP. Default is HTTP.",
                    9)
             << std::endl;
+  std::cerr
+      << FormatMessage(
+             " --metrics-url: The URL of the Prometheus metrics endpoint of "
+             "the server, e.g. \"localhost:8002/metrics\". When specified, "
+             "the endpoint is scraped at the boundaries of every measurement "
+             "window and the server-side deltas (GPU utilization, queue and "
+             "compute time, batch statistics) are reported alongside the "
+             "client-side latencies. By default, the metrics endpoint is not "
+             "scraped.",
+             18)
+      << std::endl;
   std::cerr << std::endl;
   std::cerr << "IV. OTHER OPTIONS: " << std::endl;
   std::cerr
@@ -536,6 +574,52 @@ Usage(char** argv, const std::string& msg = std::string())
              "this option. By default, the result is not recorded in a file.",
              9)
       << std::endl;
+  std::cerr
+      << FormatMessage(
+             " --latency-histogram: The full latency distribution of each "
+             "measurement will be stored in the file named by this option, "
+             "one cumulative-distribution row per percentile point. Both the "
+             "raw latencies and the coordinated-omission-corrected latencies "
+             "(measured from the intended send time of each request, only "
+             "different when the load follows a schedule) are recorded. By "
+             "default, the distributions are not recorded.",
+             18)
+      << std::endl;
+  std::cerr
+      << FormatMessage(
+             " --sweep-model-repository: The local path to the model "
+             "repository served by the inference server. When specified, "
+             "perf_client sweeps the server-side configurations given by "
+             "--sweep-instance-counts and --sweep-preferred-batch-sizes: for "
+             "every combination it rewrites the config.pbtxt of the model, "
+             "reloads the model through the model control API and runs the "
+             "requested measurement. The original configuration is restored "
+             "when the sweep completes. The server must serve the same "
+             "repository and allow model control.",
+             18)
+      << std::endl;
+  std::cerr
+      << FormatMessage(
+             " --sweep-instance-counts: Comma separated list of instance "
+             "counts to sweep. Each value is applied to every instance group "
+             "of the model.",
+             18)
+      << std::endl;
+  std::cerr
+      << FormatMessage(
+             " --sweep-preferred-batch-sizes: Comma separated list of dynamic "
+             "batcher preferred batch sizes to sweep.",
+             18)
+      << std::endl;
+  std::cerr
+      << FormatMessage(
+             " --baseline-file: The sweep results will be stored in the file "
+             "named by this option in csv format, one row per configuration "
+             "and load level. The file can be compared against a stored "
+             "baseline with the perf_baseline_check build target to catch "
+             "performance regressions.",
+             18)
+      << std::endl;
   std::cerr
       << std::setw(9) << std::left << " -H: "
       << FormatMessage(
@@ -554,6 +638,152 @@ Usage(char** argv, const std::string& msg = std::string())
   exit(1);
 }
 
+// Write the raw and coordinated-omission-corrected latency
+// distributions of a measurement as an HDR-style cumulative
+// distribution: one row per percentile point, halving the remaining
+// tail at each step until it is exhausted by the sample count.
+void
+WriteLatencyDistribution(
+    std::ofstream& ofs, const PerfStatus& status, const bool target_concurrency)
+{
+  const std::vector<uint64_t>& raw = status.raw_latencies_ns;
+  const std::vector<uint64_t>& corrected = status.corrected_latencies_ns;
+  if (raw.empty()) {
+    return;
+  }
+
+  if (target_concurrency) {
+    ofs << "# Concurrency: " << status.concurrency << std::endl;
+  } else {
+    ofs << "# Request Rate: " << status.request_rate << std::endl;
+  }
+  ofs << "Percentile,Raw latency (usec),Corrected latency (usec)" << std::endl;
+
+  double denominator = 1.0;
+  while (true) {
+    const double fraction = 1.0 - (1.0 / denominator);
+    const size_t index = (size_t)(fraction * (raw.size() - 1) + 0.5);
+    ofs << (fraction * 100.0) << "," << (raw[index] / 1000) << ","
+        << (corrected[index] / 1000) << std::endl;
+    if (denominator >= (2.0 * raw.size())) {
+      break;
+    }
+    denominator *= 2.0;
+  }
+  ofs << "100," << (raw.back() / 1000) << "," << (corrected.back() / 1000)
+      << std::endl;
+}
+
+// Parse a comma-separated list of positive integers.
+nic::Error
+ParseInt64List(const std::string& arg, std::vector<int64_t>* values)
+{
+  size_t pos = 0;
+  while (pos != std::string::npos) {
+    const size_t comma_pos = arg.find(',', pos);
+    std::string token;
+    if (comma_pos == std::string::npos) {
+      token = arg.substr(pos);
+      pos = std::string::npos;
+    } else {
+      token = arg.substr(pos, comma_pos - pos);
+      pos = comma_pos + 1;
+    }
+    try {
+      const int64_t value = std::stoll(token);
+      if (value <= 0) {
+        return nic::Error(
+            ni::RequestStatusCode::INVALID_ARG,
+            "list values must be positive, got '" + token + "'");
+      }
+      values->push_back(value);
+    }
+    catch (const std::exception& e) {
+      return nic::Error(
+          ni::RequestStatusCode::INVALID_ARG,
+          "failed to parse list value '" + token + "'");
+    }
+  }
+  return nic::Error::Success;
+}
+
+// Measure every server-side configuration of the sweep and record the
+// results as a machine-readable baseline, one row per configuration
+// and load level.
+nic::Error
+RunSweep(
+    ConfigSweeper* sweeper, InferenceProfiler* profiler,
+    const bool target_concurrency, const uint64_t concurrency_range[3],
+    const double request_rate_range[3], const SearchMode search_mode,
+    const std::string& baseline_file)
+{
+  std::ofstream baseline_ofs;
+  if (!baseline_file.empty()) {
+    baseline_ofs.open(baseline_file, std::ofstream::out);
+    baseline_ofs << "Instance Count,Preferred Batch Size,Concurrency,"
+                 << "Request Rate,Inferences/Second,"
+                 << "Stabilizing Latency (usec)" << std::endl;
+  }
+
+  for (const auto& config : sweeper->Configs()) {
+    std::cout << "*** Sweep: instance_count=" << config.instance_count_
+              << " preferred_batch_size=" << config.preferred_batch_size_
+              << " ***" << std::endl;
+    nic::Error err = sweeper->ApplyConfig(config);
+    if (!err.IsOk()) {
+      return err;
+    }
+
+    std::vector<PerfStatus> summary;
+    if (target_concurrency) {
+      err = profiler->Profile<size_t>(
+          concurrency_range[SEARCH_RANGE::kSTART],
+          concurrency_range[SEARCH_RANGE::kEND],
+          concurrency_range[SEARCH_RANGE::kSTEP], search_mode, summary);
+    } else {
+      err = profiler->Profile<double>(
+          request_rate_range[SEARCH_RANGE::kSTART],
+          request_rate_range[SEARCH_RANGE::kEND],
+          request_rate_range[SEARCH_RANGE::kSTEP], search_mode, summary);
+    }
+    // A failing configuration should not abort the sweep, the
+    // remaining configurations still need their measurements.
+    if (!err.IsOk()) {
+      std::cerr << "WARNING: measurement failed for instance_count="
+                << config.instance_count_
+                << " preferred_batch_size=" << config.preferred_batch_size_
+                << ": " << err.Message() << std::endl;
+      continue;
+    }
+
+    for (const PerfStatus& status : summary) {
+      if (baseline_ofs.is_open()) {
+        baseline_ofs << config.instance_count_ << ","
+                     << config.preferred_batch_size_ << ","
+                     << status.concurrency << "," << status.request_rate << ","
+                     << status.client_stats.infer_per_sec << ","
+                     << (status.stabilizing_latency_ns / 1000) << std::endl;
+      }
+      std::cout << "  instance_count=" << config.instance_count_
+                << " preferred_batch_size=" << config.preferred_batch_size_;
+      if (target_concurrency) {
+        std::cout << " concurrency=" << status.concurrency;
+      } else {
+        std::cout << " request_rate=" << status.request_rate;
+      }
+      std::cout << ": throughput " << status.client_stats.infer_per_sec
+                << " infer/sec, latency "
+                << (status.stabilizing_latency_ns / 1000) << " usec"
+                << std::endl;
+    }
+  }
+
+  if (baseline_ofs.is_open()) {
+    baseline_ofs.close();
+  }
+  return sweeper->RestoreOriginalConfig();
+}
+
 }  // namespace
 
 int
@@ -562,6 +792,7 @@ main(int argc, char** argv)
   bool verbose = false;
   bool streaming = false;
   size_t max_threads = 4;
+  size_t worker_processes = 1;
   // average length of a sentence
   size_t sequence_length = 20;
   int32_t percentile = -1;
@@ -576,6 +807,12 @@ main(int argc, char** argv)
   int64_t model_version = -1;
   std::string url("localhost:8000");
   std::string filename("");
+  std::string latency_histogram_file("");
+  std::string metrics_url("");
+  std::string sweep_model_repository("");
+  std::vector<int64_t> sweep_instance_counts;
+  std::vector<int64_t> sweep_preferred_batch_sizes;
+  std::string baseline_file("");
   ProtocolType protocol = ProtocolType::HTTP;
   std::map<std::string, std::string> http_headers;
   SharedMemoryType shared_memory_type = SharedMemoryType::NO_SHARED_MEMORY;
@@ -630,6 +867,13 @@ main(int argc, char** argv)
       {"request-intervals", 1, 0, 20},
       {"shared-memory", 1, 0, 21},
       {"output-shared-memory-size", 1, 0, 22},
+      {"worker-processes", 1, 0, 23},
+      {"latency-histogram", 1, 0, 24},
+      {"metrics-url", 1, 0, 25},
+      {"sweep-model-repository", 1, 0, 26},
+      {"sweep-instance-counts", 1, 0, 27},
+      {"sweep-preferred-batch-sizes", 1, 0, 28},
+      {"baseline-file", 1, 0, 29},
       {0, 0, 0, 0}};
 
   // Parse commandline...
@@ -836,6 +1080,37 @@ main(int argc, char** argv)
       case 22:
         output_shm_size = std::atoi(optarg);
         break;
+      case 23:
+        worker_processes = std::atoi(optarg);
+        break;
+      case 24:
+        latency_histogram_file = optarg;
+        break;
+      case 25:
+        metrics_url = optarg;
+        break;
+      case 26:
+        sweep_model_repository = optarg;
+        break;
+      case 27: {
+        nic::Error parse_err =
+            ParseInt64List(optarg, &sweep_instance_counts);
+        if (!parse_err.IsOk()) {
+          Usage(argv, "failed to parse --sweep-instance-counts");
+        }
+        break;
+      }
+      case 28: {
+        nic::Error parse_err =
+            ParseInt64List(optarg, &sweep_preferred_batch_sizes);
+        if (!parse_err.IsOk()) {
+          Usage(argv, "failed to parse --sweep-preferred-batch-sizes");
+        }
+        break;
+      }
+      case 29:
+        baseline_file = optarg;
+        break;
       case 'v':
         verbose = true;
         break;
@@ -1022,6 +1297,45 @@ main(int argc, char** argv)
       (using_concurrency_range || using_old_options ||
        !(using_request_rate_range || using_custom_intervals));
 
+  if (worker_processes == 0) {
+    Usage(argv, "worker processes must be > 0");
+  }
+  if (worker_processes > 1) {
+    if (!target_concurrency) {
+      Usage(
+          argv,
+          "--worker-processes > 1 is only supported for concurrency "
+          "measurement");
+    }
+    if (shared_memory_type != SharedMemoryType::NO_SHARED_MEMORY) {
+      Usage(
+          argv,
+          "--worker-processes > 1 can not be used with shared memory as the "
+          "worker processes would register conflicting regions");
+    }
+  }
+
+  const bool using_sweep = !sweep_model_repository.empty();
+  if (using_sweep) {
+    if (sweep_instance_counts.empty() && sweep_preferred_batch_sizes.empty()) {
+      Usage(
+          argv,
+          "--sweep-model-repository requires at least one of "
+          "--sweep-instance-counts or --sweep-preferred-batch-sizes");
+    }
+  } else {
+    if (!sweep_instance_counts.empty() ||
+        !sweep_preferred_batch_sizes.empty()) {
+      Usage(
+          argv,
+          "--sweep-instance-counts and --sweep-preferred-batch-sizes require "
+          "--sweep-model-repository");
+    }
+    if (!baseline_file.empty()) {
+      Usage(argv, "--baseline-file requires --sweep-model-repository");
+    }
+  }
+
 
   // Overriding the max_threads default for request_rate search
   if (!max_threads_specified && target_concurrency) {
@@ -1095,10 +1409,26 @@ main(int argc, char** argv)
       }
     }
 
-    err = ConcurrencyManager::Create(
-        async, batch_size, max_threads, max_concurrency, sequence_length,
-        string_length, string_data, zero_input, input_shapes, user_data,
-        shared_memory_type, output_shm_size, factory, &manager);
+    if (worker_processes > 1) {
+      if ((factory->SchedulerType() == ContextFactory::SEQUENCE) ||
+          (factory->SchedulerType() == ContextFactory::ENSEMBLE_SEQUENCE)) {
+        std::cerr << "can not use multiple worker processes with sequence "
+                     "models as the processes would generate overlapping "
+                     "correlation IDs"
+                  << std::endl;
+        return 1;
+      }
+      err = MultiProcessConcurrencyManager::Create(
+          async, batch_size, max_threads, max_concurrency, sequence_length,
+          string_length, string_data, zero_input, input_shapes, user_data,
+          shared_memory_type, output_shm_size, worker_processes, factory,
+          &manager);
+    } else {
+      err = ConcurrencyManager::Create(
+          async, batch_size, max_threads, max_concurrency, sequence_length,
+          string_length, string_data, zero_input, input_shapes, user_data,
+          shared_memory_type, output_shm_size, factory, &manager);
+    }
 
   } else if (using_request_rate_range) {
     err = RequestRateManager::Create(
@@ -1122,7 +1452,8 @@ main(int argc, char** argv)
 
   err = InferenceProfiler::Create(
       verbose, stability_threshold, measurement_window_ms, max_trials,
-      percentile, latency_threshold_ms, factory, std::move(manager), &profiler);
+      percentile, latency_threshold_ms, metrics_url, factory,
+      std::move(manager), &profiler);
   if (!err.IsOk()) {
     std::cerr << err << std::endl;
     return 1;
@@ -1188,6 +1519,25 @@ main(int argc, char** argv)
     search_mode = SearchMode::NONE;
   }
 
+  if (using_sweep) {
+    std::unique_ptr<ConfigSweeper> sweeper;
+    err = ConfigSweeper::Create(
+        sweep_model_repository, sweep_instance_counts,
+        sweep_preferred_batch_sizes, factory, &sweeper);
+    if (!err.IsOk()) {
+      std::cerr << err << std::endl;
+      return 1;
+    }
+    err = RunSweep(
+        sweeper.get(), profiler.get(), target_concurrency, concurrency_range,
+        request_rate_range, search_mode, baseline_file);
+    if (!err.IsOk()) {
+      std::cerr << err << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
   if (target_concurrency) {
     err = profiler->Profile<size_t>(
         concurrency_range[SEARCH_RANGE::kSTART],
@@ -1229,6 +1579,14 @@ main(int argc, char** argv)
                 << std::endl;
     }
 
+    if (!latency_histogram_file.empty()) {
+      std::ofstream hist_ofs(latency_histogram_file, std::ofstream::out);
+      for (PerfStatus& status : summary) {
+        WriteLatencyDistribution(hist_ofs, status, target_concurrency);
+      }
+      hist_ofs.close();
+    }
+
     if (!filename.empty()) {
       std::ofstream ofs(filename, std::ofstream::out);
       if (target_concurrency) {
@@ -41,8 +41,13 @@
 namespace ni = nvidia::inferenceserver;
 namespace nic = nvidia::inferenceserver::client;
 
-using TimestampVector =
-    std::vector<std::tuple<struct timespec, struct timespec, uint32_t, bool>>;
+// One entry per request: <send time, completion time, request flags,
+// whether the request missed its schedule, the time in nanoseconds by
+// which the send missed its intended send time (zero when there is no
+// schedule)>. The last element allows latency to also be measured from
+// the intended send time to correct for coordinated omission.
+using TimestampVector = std::vector<
+    std::tuple<struct timespec, struct timespec, uint32_t, bool, uint64_t>>;
 
 // Will use the characters specified here to construct random strings
 std::string const character_set =
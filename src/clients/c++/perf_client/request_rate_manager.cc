@@ -26,6 +26,19 @@
 
 #include "src/clients/c++/perf_client/request_rate_manager.h"
 
+#include "src/core/spin_wait.h"
+
+namespace {
+
+// When the time until the next scheduled send is larger than this
+// slack the worker sleeps for the difference; the remainder is
+// busy-waited. Sleeping all the way to the scheduled time oversleeps
+// by the timer quantum, which at high request rates deviates the
+// generated schedule badly from the intended distribution.
+constexpr std::chrono::nanoseconds kScheduleSpinSlack(100 * 1000);
+
+}  // namespace
+
 RequestRateManager::~RequestRateManager()
 {
   // The destruction of derived class should wait for all the request generator
@@ -108,6 +121,24 @@ RequestRateManager::ResetWorkers()
   return nic::Error::Success;
 }
 
+void
+RequestRateManager::GetAndResetScheduleError(
+    uint64_t* count, uint64_t* total_error_ns, uint64_t* max_error_ns)
+{
+  *count = 0;
+  *total_error_ns = 0;
+  *max_error_ns = 0;
+  for (auto& thread_config : threads_config_) {
+    *count += thread_config->schedule_error_cnt_.exchange(0);
+    *total_error_ns += thread_config->schedule_error_total_ns_.exchange(0);
+    const uint64_t thread_max =
+        thread_config->schedule_error_max_ns_.exchange(0);
+    if (thread_max > *max_error_ns) {
+      *max_error_ns = thread_max;
+    }
+  }
+}
+
 void
 RequestRateManager::GenerateSchedule(const double request_rate)
 {
@@ -120,6 +151,7 @@ RequestRateManager::GenerateSchedule(const double request_rate)
     return;
   }
   schedule_.clear();
+  trace_.clear();
   schedule_.emplace_back(0);
 
   std::mt19937 schedule_rng;
@@ -218,11 +250,12 @@ RequestRateManager::Infer(
     // Sleep if required
     std::chrono::steady_clock::time_point now =
         std::chrono::steady_clock::now();
-    std::chrono::nanoseconds wait_time =
-        (schedule_[thread_config->index_] +
-         (thread_config->rounds_ * (*gen_duration_))) -
-        (now - start_time_);
+    std::chrono::nanoseconds scheduled_offset =
+        schedule_[thread_config->index_] +
+        (thread_config->rounds_ * (*gen_duration_));
+    std::chrono::nanoseconds wait_time = scheduled_offset - (now - start_time_);
 
+    const size_t schedule_index = thread_config->index_;
     thread_config->index_ = (thread_config->index_ + thread_config->stride_);
     // Loop around the schedule to keep running
     thread_config->rounds_ += (thread_config->index_ / schedule_.size());
@@ -232,16 +265,50 @@ RequestRateManager::Infer(
     if (wait_time.count() < 0) {
       delayed = true;
     } else {
-      std::this_thread::sleep_for(wait_time);
+      // Sleep to within the spin slack of the scheduled send time and
+      // busy-wait the remainder so the send is not deferred by the
+      // timer quantum.
+      if (wait_time > kScheduleSpinSlack) {
+        std::this_thread::sleep_for(wait_time - kScheduleSpinSlack);
+      }
+      const std::chrono::steady_clock::time_point target =
+          start_time_ + scheduled_offset;
+      while (std::chrono::steady_clock::now() < target) {
+        ni::SpinPause();
+      }
     }
 
-    // Update the inputs if required
+    // Account for how much the send missed its scheduled time so the
+    // quality of the generated schedule can be reported.
+    const std::chrono::nanoseconds schedule_error =
+        (std::chrono::steady_clock::now() - start_time_) - scheduled_offset;
+    const uint64_t error_ns =
+        (schedule_error.count() > 0) ? schedule_error.count() : 0;
+    thread_config->schedule_error_cnt_++;
+    thread_config->schedule_error_total_ns_ += error_ns;
+    uint64_t prev_max = thread_config->schedule_error_max_ns_.load();
+    while ((error_ns > prev_max) &&
+           !thread_config->schedule_error_max_ns_.compare_exchange_weak(
+               prev_max, error_ns)) {
+    }
+
+    // Update the inputs if required. A trace entry overrides the
+    // round-robin data selection with the stream and step recorded
+    // for the request.
     if (using_json_data_ && (!on_sequence_model_)) {
-      int step_id = (thread_config->non_sequence_data_step_id_ %
-                     data_loader_->GetTotalStepsNonSequence()) *
-                    batch_size_;
-      thread_config->non_sequence_data_step_id_ += max_threads_;
-      thread_stat->status_ = UpdateInputs(ctx->ctx_->Inputs(), 0, step_id);
+      int stream_id = 0;
+      int step_id;
+      if ((!trace_.empty()) && trace_[schedule_index].has_data_) {
+        stream_id = trace_[schedule_index].stream_id_;
+        step_id = trace_[schedule_index].step_id_;
+      } else {
+        step_id = (thread_config->non_sequence_data_step_id_ %
+                   data_loader_->GetTotalStepsNonSequence()) *
+                  batch_size_;
+        thread_config->non_sequence_data_step_id_ += max_threads_;
+      }
+      thread_stat->status_ =
+          UpdateInputs(ctx->ctx_->Inputs(), stream_id, step_id);
       if (!thread_stat->status_.IsOk()) {
         return;
       }
@@ -252,8 +319,14 @@ RequestRateManager::Infer(
 
     if (on_sequence_model_) {
       flags = 0;
-      // Select one of the sequence at random for this request
-      seq_id = rand() % sequence_stat_.size();
+      // Select one of the sequence at random for this request, unless
+      // a trace entry recorded a correlation ID in which case requests
+      // with the same ID are kept on the same sequence slot.
+      if ((!trace_.empty()) && (trace_[schedule_index].corr_id_ != 0)) {
+        seq_id = trace_[schedule_index].corr_id_ % sequence_stat_.size();
+      } else {
+        seq_id = rand() % sequence_stat_.size();
+      }
       // Need lock to protect the order of dispatch across worker threads.
       // This also helps in reporting the realistic latencies.
       std::lock_guard<std::mutex> guard(sequence_stat_[seq_id]->mtx_);
@@ -288,10 +361,10 @@ RequestRateManager::Infer(
         }
       }
 
-      Request(ctx, flags, delayed, start_time, thread_stat);
+      Request(ctx, flags, delayed, start_time, error_ns, thread_stat);
       sequence_stat_[seq_id]->remaining_queries_--;
     } else {
-      Request(ctx, flags, delayed, start_time, thread_stat);
+      Request(ctx, flags, delayed, start_time, error_ns, thread_stat);
     }
 
     if (early_exit || (!thread_stat->cb_status_.IsOk())) {
@@ -313,7 +386,9 @@ RequestRateManager::Infer(
             // Override the correlation ID.
             options->SetCorrelationId(sequence_stat_[i]->corr_id_);
             ctx->ctx_->SetRunOptions(*options);
-            Request(ctx, flags, false /* delayed */, start_time, thread_stat);
+            Request(
+                ctx, flags, false /* delayed */, start_time,
+                0 /* schedule_lateness_ns */, thread_stat);
             sequence_stat_[i]->remaining_queries_ = 0;
           }
         }
@@ -335,11 +410,13 @@ void
 RequestRateManager::Request(
     std::shared_ptr<InferContextMetaData> context, const uint32_t flags,
     const bool delayed, const struct timespec start_time,
+    const uint64_t schedule_lateness_ns,
     std::shared_ptr<ThreadStat> thread_stat)
 {
   if (async_) {
     thread_stat->status_ = context->ctx_->AsyncRun(
-        [context, start_time, flags, delayed, thread_stat](
+        [context, start_time, flags, delayed, schedule_lateness_ns,
+         thread_stat](
             nic::InferContext* ctx,
             std::shared_ptr<nic::InferContext::Request> request) {
           std::map<std::string, std::unique_ptr<nic::InferContext::Result>>
@@ -353,8 +430,9 @@ RequestRateManager::Request(
               // Add the request timestamp to thread Timestamp vector with
               // proper locking
               std::lock_guard<std::mutex> lock(thread_stat->mu_);
-              thread_stat->request_timestamps_.emplace_back(
-                  std::make_tuple(start_time, end_time_async, flags, delayed));
+              thread_stat->request_timestamps_.emplace_back(std::make_tuple(
+                  start_time, end_time_async, flags, delayed,
+                  schedule_lateness_ns));
               context->ctx_->GetStat(&(thread_stat->contexts_stat_[0]));
             }
           } else if (thread_stat->cb_status_.IsOk()) {
@@ -378,8 +456,8 @@ RequestRateManager::Request(
       // Add the request timestamp to thread Timestamp vector with proper
       // locking
       std::lock_guard<std::mutex> lock(thread_stat->mu_);
-      thread_stat->request_timestamps_.emplace_back(
-          std::make_tuple(start_time, end_time_sync, flags, delayed));
+      thread_stat->request_timestamps_.emplace_back(std::make_tuple(
+          start_time, end_time_sync, flags, delayed, schedule_lateness_ns));
       context->ctx_->GetStat(&(thread_stat->contexts_stat_[0]));
     }
   }
@@ -29,6 +29,7 @@
 #include "src/clients/c++/perf_client/load_manager.h"
 #include "src/clients/c++/perf_client/perf_utils.h"
 
+#include <atomic>
 #include <condition_variable>
 #include <thread>
 
@@ -100,11 +101,22 @@ class RequestRateManager : public LoadManager {
   /// \return Error object indicating success or failure.
   nic::Error ResetWorkers() override;
 
+  /// Get and reset the send-timestamp error accounting. The error of a
+  /// request is the time by which its send missed the scheduled send
+  /// time; requests sent on time contribute zero.
+  /// \param count Returns the number of requests sent since last reset.
+  /// \param total_error_ns Returns the accumulated send-timestamp error.
+  /// \param max_error_ns Returns the largest single send-timestamp error.
+  void GetAndResetScheduleError(
+      uint64_t* count, uint64_t* total_error_ns, uint64_t* max_error_ns);
+
  protected:
   struct ThreadConfig {
     ThreadConfig(uint32_t index, uint32_t stride)
         : index_(index), id_(index), stride_(stride), is_paused_(false),
-          rounds_(0), non_sequence_data_step_id_(index)
+          rounds_(0), non_sequence_data_step_id_(index),
+          schedule_error_cnt_(0), schedule_error_total_ns_(0),
+          schedule_error_max_ns_(0)
     {
     }
 
@@ -114,6 +126,11 @@ class RequestRateManager : public LoadManager {
     bool is_paused_;
     uint64_t rounds_;
     int non_sequence_data_step_id_;
+    // Send-timestamp error accounting. Updated by the owning worker
+    // thread and collected by GetAndResetScheduleError().
+    std::atomic<uint64_t> schedule_error_cnt_;
+    std::atomic<uint64_t> schedule_error_total_ns_;
+    std::atomic<uint64_t> schedule_error_max_ns_;
   };
 
   RequestRateManager(
@@ -148,17 +165,38 @@ class RequestRateManager : public LoadManager {
   /// \param delayed Whether the request fell behind its scheduled time.
   /// \param start_time The start time of the request to be used for latency
   /// measurements.
+  /// \param schedule_lateness_ns The time by which the send missed its
+  /// scheduled send time.
   /// \param thread_stat The runnning status of the worker thread
   void Request(
       std::shared_ptr<InferContextMetaData> ctx, const uint32_t flags,
       const bool delayed, const struct timespec start_time,
+      const uint64_t schedule_lateness_ns,
       std::shared_ptr<ThreadStat> thread_stat);
 
+  // Per-request replay information recorded in a production trace.
+  struct TraceEntry {
+    TraceEntry() : stream_id_(0), step_id_(0), corr_id_(0), has_data_(false) {}
+
+    // The data stream and step providing the payload and shapes for
+    // the request. Only used when 'has_data_' is true.
+    uint64_t stream_id_;
+    uint64_t step_id_;
+    // The correlation ID recorded for the request, 0 if none. For
+    // sequence models requests with the same correlation ID are
+    // dispatched to the same sequence slot.
+    uint64_t corr_id_;
+    bool has_data_;
+  };
+
   std::vector<std::shared_ptr<ThreadConfig>> threads_config_;
 
   std::unique_ptr<std::chrono::nanoseconds> gen_duration_;
   Distribution request_distribution_;
   std::vector<std::chrono::nanoseconds> schedule_;
+  // Trace replay information parallel to 'schedule_'. Empty unless a
+  // trace file provides per-request information.
+  std::vector<TraceEntry> trace_;
   std::chrono::steady_clock::time_point start_time_;
   bool execute_;
 };
@@ -0,0 +1,192 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver {
+
+// A bump allocator for the short-lived objects created for each
+// inference request. Allocations are served from fixed-size blocks
+// with no per-allocation bookkeeping and are freed wholesale when the
+// arena is reset. An arena serves a single request and so is not
+// thread-safe.
+class Arena {
+ public:
+  Arena() : block_idx_(0), block_offset_(0)
+  {
+    blocks_.emplace_back(new char[kBlockByteSize]);
+  }
+
+  // Allocate 'byte_size' bytes aligned to 'alignment'. Allocations
+  // larger than a block fall back to the heap and are released on
+  // Reset().
+  void* Allocate(const size_t byte_size, const size_t alignment)
+  {
+    if (byte_size > kBlockByteSize) {
+      oversized_.emplace_back(new char[byte_size + alignment]);
+      return Align(oversized_.back().get(), alignment);
+    }
+
+    char* base = Align(blocks_[block_idx_].get() + block_offset_, alignment);
+    if ((base + byte_size) > (blocks_[block_idx_].get() + kBlockByteSize)) {
+      block_idx_++;
+      if (block_idx_ == blocks_.size()) {
+        blocks_.emplace_back(new char[kBlockByteSize]);
+      }
+
+      block_offset_ = 0;
+      base = Align(blocks_[block_idx_].get(), alignment);
+    }
+
+    block_offset_ = (base + byte_size) - blocks_[block_idx_].get();
+    return base;
+  }
+
+  // Release every allocation made from the arena. The blocks
+  // themselves are retained for reuse.
+  void Reset()
+  {
+    block_idx_ = 0;
+    block_offset_ = 0;
+    oversized_.clear();
+  }
+
+ private:
+  static char* Align(char* ptr, const size_t alignment)
+  {
+    const uintptr_t value = reinterpret_cast<uintptr_t>(ptr);
+    const uintptr_t aligned = (value + alignment - 1) & ~(alignment - 1);
+    return reinterpret_cast<char*>(aligned);
+  }
+
+  static constexpr size_t kBlockByteSize = 4096;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  std::vector<std::unique_ptr<char[]>> oversized_;
+  size_t block_idx_;
+  size_t block_offset_;
+};
+
+// A process-wide pool of recycled arenas. Get() returns a
+// shared_ptr whose deleter resets the arena and returns it to the
+// pool, so holding the shared_ptr (directly or via an ArenaAllocator)
+// keeps the arena alive for the lifetime of the request.
+class ArenaPool {
+ public:
+  static std::shared_ptr<Arena> Get()
+  {
+    ArenaPool* pool = Singleton();
+
+    Arena* arena = nullptr;
+    {
+      std::lock_guard<std::mutex> lk(pool->mtx_);
+      if (!pool->free_.empty()) {
+        arena = pool->free_.back().release();
+        pool->free_.pop_back();
+      }
+    }
+
+    if (arena == nullptr) {
+      arena = new Arena();
+    }
+
+    return std::shared_ptr<Arena>(arena, [pool](Arena* arena) {
+      arena->Reset();
+      std::lock_guard<std::mutex> lk(pool->mtx_);
+      if (pool->free_.size() < kMaxFreeArenas) {
+        pool->free_.emplace_back(arena);
+      } else {
+        delete arena;
+      }
+    });
+  }
+
+ private:
+  static ArenaPool* Singleton()
+  {
+    static ArenaPool* singleton = new ArenaPool();
+    return singleton;
+  }
+
+  static constexpr size_t kMaxFreeArenas = 64;
+
+  std::mutex mtx_;
+  std::vector<std::unique_ptr<Arena>> free_;
+};
+
+// A C++11 allocator backed by an arena, suitable for
+// std::allocate_shared so that an object and its shared_ptr control
+// block are placed in the arena with a single bump allocation. The
+// allocator holds a reference to the arena so the arena is recycled
+// only once every object allocated from it has been released.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(const std::shared_ptr<Arena>& arena) : arena_(arena)
+  {
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& rhs) : arena_(rhs.arena_)
+  {
+  }
+
+  T* allocate(const size_t cnt)
+  {
+    return reinterpret_cast<T*>(
+        arena_->Allocate(cnt * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t)
+  {
+    // Individual deallocation is a no-op, the memory is released when
+    // the arena is reset.
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& rhs) const
+  {
+    return arena_ == rhs.arena_;
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& rhs) const
+  {
+    return arena_ != rhs.arena_;
+  }
+
+  std::shared_ptr<Arena> arena_;
+};
+
+}}  // namespace nvidia::inferenceserver
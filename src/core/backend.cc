@@ -31,9 +31,13 @@
 #include "src/core/constants.h"
 #include "src/core/dynamic_batch_scheduler.h"
 #include "src/core/filesystem.h"
+#include "src/core/gpu_execution_coordinator.h"
+#include "src/core/infer_request.h"
 #include "src/core/logging.h"
 #include "src/core/metric_model_reporter.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/nvtx.h"
+#include "src/core/probes.h"
 #include "src/core/sequence_batch_scheduler.h"
 #include "src/core/trtserver.h"
 
@@ -43,14 +47,29 @@ Status
 InferenceBackend::GetInput(
     const std::string& name, const ModelInput** input) const
 {
-  const auto itr = input_map_.find(name);
-  if (itr == input_map_.end()) {
+  const int32_t index = input_names_.Intern(name);
+  if (index < 0) {
     return Status(
         Status::Code::INVALID_ARG,
         "unexpected inference input '" + name + "' for model '" + Name() + "'");
   }
 
-  *input = &itr->second;
+  *input = &inputs_[index];
+  return Status::Success;
+}
+
+Status
+InferenceBackend::GetInputPlan(
+    const std::string& name, const InputPlan** plan) const
+{
+  const int32_t index = input_names_.Intern(name);
+  if (index < 0) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "unexpected inference input '" + name + "' for model '" + Name() + "'");
+  }
+
+  *plan = &input_plans_[index];
   return Status::Success;
 }
 
@@ -58,14 +77,29 @@ Status
 InferenceBackend::GetOutput(
     const std::string& name, const ModelOutput** output) const
 {
-  const auto itr = output_map_.find(name);
-  if (itr == output_map_.end()) {
+  const int32_t index = output_names_.Intern(name);
+  if (index < 0) {
     return Status(
         Status::Code::INVALID_ARG, "unexpected inference output '" + name +
                                        "' for model '" + Name() + "'");
   }
 
-  *output = &itr->second;
+  *output = &outputs_[index];
+  return Status::Success;
+}
+
+Status
+InferenceBackend::GetOutputPlan(
+    const std::string& name, const OutputPlan** plan) const
+{
+  const int32_t index = output_names_.Intern(name);
+  if (index < 0) {
+    return Status(
+        Status::Code::INVALID_ARG, "unexpected inference output '" + name +
+                                       "' for model '" + Name() + "'");
+  }
+
+  *plan = &output_plans_[index];
   return Status::Success;
 }
 
@@ -74,28 +108,84 @@ InferenceBackend::SetModelConfig(
     const std::string& path, const ModelConfig& config)
 {
   config_ = config;
+  max_batch_size_ = config.max_batch_size();
   RETURN_IF_ERROR(GetModelVersionFromPath(path, &version_));
 
   // Create the metric reporter for this backend.
   metric_reporter_ = std::make_shared<MetricModelReporter>(
       Name(), version_, config_.metric_tags());
 
-  // Initialize the input map
+  // Intern the input names and collect the input configurations,
+  // indexed by the interned name index.
   for (const auto& io : config.input()) {
-    input_map_.insert(std::make_pair(io.name(), io));
+    const int32_t index = input_names_.Add(io.name());
+    if (index == (int32_t)inputs_.size()) {
+      inputs_.push_back(io);
+
+      // Compile the normalization expectations for this input so the
+      // request path compares plain integers.
+      InputPlan plan;
+      plan.data_type_ = io.data_type();
+      plan.fixed_size_data_type_ = IsFixedSizeDataType(io.data_type());
+      plan.is_shape_tensor_ = io.is_shape_tensor();
+      plan.is_non_linear_format_ = (io.memory_format() != MEMORY_FORMAT_LINEAR);
+      plan.has_reshape_ = io.has_reshape();
+      plan.dims_.assign(io.dims().begin(), io.dims().end());
+      if (plan.has_reshape_) {
+        plan.reshape_dims_.assign(
+            io.reshape().shape().begin(), io.reshape().shape().end());
+        plan.default_shape_ = plan.reshape_dims_;
+      } else {
+        plan.default_shape_ = plan.dims_;
+      }
+      plan.default_shape_has_variable_dim_ = false;
+      for (const auto dim : plan.default_shape_) {
+        if (dim < 0) {
+          plan.default_shape_has_variable_dim_ = true;
+          break;
+        }
+      }
+      input_plans_.emplace_back(std::move(plan));
+    }
   }
+  input_names_.Freeze();
 
-  // Initialize the output map and label provider for each output
+  // Same for the outputs, and initialize the label provider for each
+  // output.
   label_provider_ = std::make_shared<LabelProvider>();
   model_dir_ = DirName(path);
   for (const auto& io : config.output()) {
-    output_map_.insert(std::make_pair(io.name(), io));
+    const int32_t index = output_names_.Add(io.name());
+    if (index == (int32_t)outputs_.size()) {
+      outputs_.push_back(io);
+
+      // Compile the response expectations for this output so that
+      // finalizing a response reads flat arrays.
+      OutputPlan plan;
+      plan.data_type_ = io.data_type();
+      plan.fixed_size_data_type_ = IsFixedSizeDataType(io.data_type());
+      plan.has_reshape_ = io.has_reshape();
+      plan.dims_.assign(io.dims().begin(), io.dims().end());
+      if (plan.has_reshape_) {
+        plan.expected_shape_.assign(
+            io.reshape().shape().begin(), io.reshape().shape().end());
+      } else {
+        plan.expected_shape_ = plan.dims_;
+      }
+      for (size_t idx = 0; idx < plan.expected_shape_.size(); idx++) {
+        if (plan.expected_shape_[idx] == -1) {
+          plan.variable_dim_index_.push_back(idx);
+        }
+      }
+      output_plans_.emplace_back(std::move(plan));
+    }
 
     if (!io.label_filename().empty()) {
       const auto label_path = JoinPath({model_dir_, io.label_filename()});
       RETURN_IF_ERROR(label_provider_->AddLabels(io.name(), label_path));
     }
   }
+  output_names_.Freeze();
 
   if (config_.has_dynamic_batching()) {
     default_priority_level_ =
@@ -121,6 +211,41 @@ InferenceBackend::SetScheduler(std::unique_ptr<Scheduler> scheduler)
   return Status::Success;
 }
 
+Status
+InferenceBackend::UpdateSchedulerConfig(const ModelConfig& config)
+{
+  if (scheduler_ == nullptr) {
+    return Status(
+        Status::Code::UNAVAILABLE, "no scheduler for model " + Name());
+  }
+
+  RETURN_IF_ERROR(scheduler_->UpdateConfig(config));
+
+  // Reflect the applied parameters in the served configuration so
+  // that status reporting shows the values actually in use.
+  if (config_.has_dynamic_batching() && config.has_dynamic_batching()) {
+    config_.mutable_dynamic_batching()
+        ->mutable_preferred_batch_size()
+        ->CopyFrom(config.dynamic_batching().preferred_batch_size());
+    config_.mutable_dynamic_batching()->set_max_queue_delay_microseconds(
+        config.dynamic_batching().max_queue_delay_microseconds());
+  }
+  if (config_.has_sequence_batching() && config.has_sequence_batching()) {
+    config_.mutable_sequence_batching()->set_max_sequence_idle_microseconds(
+        config.sequence_batching().max_sequence_idle_microseconds());
+    if (config_.sequence_batching().has_oldest() &&
+        config.sequence_batching().has_oldest()) {
+      auto oldest = config_.mutable_sequence_batching()->mutable_oldest();
+      oldest->mutable_preferred_batch_size()->CopyFrom(
+          config.sequence_batching().oldest().preferred_batch_size());
+      oldest->set_max_queue_delay_microseconds(
+          config.sequence_batching().oldest().max_queue_delay_microseconds());
+    }
+  }
+
+  return Status::Success;
+}
+
 Status
 InferenceBackend::SetConfiguredScheduler(
     const uint32_t runner_cnt, const Scheduler::StandardInitFunc& OnInit,
@@ -146,14 +271,16 @@ InferenceBackend::SetConfiguredScheduler(
       LOG_VERBOSE(1) << "model '" << sample.request_->ModelName()
                      << "' instance " << std::to_string(runner_idx)
                      << " is running warmup sample '" << sample.sample_name_
-                     << "'";
-
-      std::promise<Status> warmup_promise;
-      auto warmup_future = warmup_promise.get_future();
-      WarmUp(runner_idx, sample, [&warmup_promise](Status status) {
-        warmup_promise.set_value(status);
-      });
-      RETURN_IF_ERROR(warmup_future.get());
+                     << "' " << sample.count_ << " time(s)";
+
+      for (size_t cnt = 0; cnt < sample.count_; cnt++) {
+        std::promise<Status> warmup_promise;
+        auto warmup_future = warmup_promise.get_future();
+        WarmUp(runner_idx, sample, [&warmup_promise](Status status) {
+          warmup_promise.set_value(status);
+        });
+        RETURN_IF_ERROR(warmup_future.get());
+      }
     }
 
     return Status::Success;
@@ -174,12 +301,156 @@ InferenceBackend::SetConfiguredScheduler(
     }
   }
 
+  // Determine whether dynamic instance scaling is configured. The
+  // minimum active instance count is derived from the instance groups
+  // the same way the backends derive 'runner_cnt': one runner per
+  // instance, with GPU groups contributing one instance per
+  // (count, gpu) pair.
+  uint32_t total_instance_cnt = 0;
+  uint32_t min_instance_cnt = 0;
+  for (const auto& group : config_.instance_group()) {
+    const uint32_t replica_cnt =
+        ((group.kind() == ModelInstanceGroup::KIND_CPU) ||
+         (group.gpus_size() == 0))
+            ? 1
+            : group.gpus_size();
+    total_instance_cnt += group.count() * replica_cnt;
+    const int32_t group_min_count =
+        ((group.min_count() <= 0) || (group.min_count() >= group.count()))
+            ? group.count()
+            : group.min_count();
+    min_instance_cnt += group_min_count * replica_cnt;
+  }
+
+  // Bind each runner thread to the cpuset its instance group
+  // configures, if any. The runner ordering is derived the same way
+  // as 'total_instance_cnt' above. The binding is applied on the
+  // runner thread itself, before it executes any request, so all
+  // model execution that runs inline on the runner is covered.
+  std::vector<std::vector<int32_t>> runner_cpus;
+  bool has_cpus = false;
+  for (const auto& group : config_.instance_group()) {
+    const uint32_t replica_cnt =
+        ((group.kind() == ModelInstanceGroup::KIND_CPU) ||
+         (group.gpus_size() == 0))
+            ? 1
+            : group.gpus_size();
+    const std::vector<int32_t> cpus(group.cpus().begin(), group.cpus().end());
+    has_cpus |= !cpus.empty();
+    for (uint32_t r = 0; r < (uint32_t)group.count() * replica_cnt; r++) {
+      runner_cpus.push_back(cpus);
+    }
+  }
+
+  Scheduler::StandardInitFunc OnInitBound = OnInit;
+  if (has_cpus && (runner_cpus.size() == runner_cnt)) {
+    OnInitBound = [OnInit, runner_cpus](uint32_t runner_idx) -> Status {
+      RETURN_IF_ERROR(SetCpuAffinity(runner_cpus[runner_idx]));
+      return OnInit(runner_idx);
+    };
+  }
+
+  // Scaling requires a registered factory for every context and a
+  // one-to-one instance-to-runner mapping. A backend that doesn't
+  // satisfy either runs with all instances always active. The
+  // sequence batcher pins requests to instances and so never scales.
+  // A configured residency idle timeout allows every instance to be
+  // demoted, so it implies scaling with no active-instance floor.
+  const bool scale_to_zero =
+      (config_.residency().idle_timeout_seconds() != 0);
+  const bool scaling_enabled =
+      ((min_instance_cnt < runner_cnt) || scale_to_zero) &&
+      (total_instance_cnt == runner_cnt) &&
+      (context_factories_.size() == runner_cnt) &&
+      !config_.has_sequence_batching();
+  const uint32_t min_active_runner_cnt =
+      scaling_enabled ? (scale_to_zero ? 0 : min_instance_cnt) : runner_cnt;
+  const uint64_t scale_to_zero_idle_microseconds =
+      (scaling_enabled && scale_to_zero)
+          ? config_.residency().idle_timeout_seconds() * 1000 * 1000
+          : 0;
+  if (scale_to_zero && !scaling_enabled) {
+    LOG_WARNING << "residency idle timeout is ignored for '" << Name()
+                << "': the backend does not support instance scaling";
+  }
+
+  // When GPU execution coordination is configured, wrap the run
+  // function so that a runner takes a per-device execution slot
+  // before the batch is handed to the backend and returns it when the
+  // batch completes. The per-runner device is derived with the same
+  // instance ordering the backends use when creating contexts: count
+  // replicas per group, GPU groups contributing one instance per gpu.
+  Scheduler::StandardRunFunc OnRunCoordinated = OnRun;
+  const auto& coordination = config_.optimization().gpu_execution_coordination();
+  if (coordination.enable()) {
+    std::vector<int32_t> runner_gpus;
+    for (const auto& group : config_.instance_group()) {
+      for (int32_t c = 0; c < group.count(); c++) {
+        if ((group.kind() == ModelInstanceGroup::KIND_CPU) ||
+            (group.gpus_size() == 0)) {
+          runner_gpus.push_back(-1);
+        } else {
+          for (const int32_t gpu : group.gpus()) {
+            runner_gpus.push_back(gpu);
+          }
+        }
+      }
+    }
+
+    if (runner_gpus.size() == runner_cnt) {
+      std::vector<std::shared_ptr<GpuExecutionCoordinator>> coordinators;
+      for (const auto gpu : runner_gpus) {
+        coordinators.push_back(
+            (gpu < 0) ? nullptr
+                      : GpuExecutionCoordinator::Get(gpu, coordination.slots()));
+      }
+      const uint32_t coordination_priority = coordination.priority();
+      OnRunCoordinated = [OnRun, coordinators, coordination_priority](
+                             uint32_t runner_idx,
+                             std::vector<Scheduler::Payload>* payloads,
+                             std::function<void(Status)> OnCompletePayloads) {
+        const auto& coordinator = coordinators[runner_idx];
+        if (coordinator == nullptr) {
+          OnRun(runner_idx, payloads, std::move(OnCompletePayloads));
+          return;
+        }
+        coordinator->Acquire(coordination_priority);
+        auto OnCompleteRelease =
+            [coordinator, OnCompletePayloads](Status status) {
+              coordinator->Release();
+              OnCompletePayloads(status);
+            };
+        OnRun(runner_idx, payloads, std::move(OnCompleteRelease));
+      };
+    } else {
+      LOG_ERROR << "unable to derive per-runner devices for GPU execution "
+                   "coordination for '"
+                << Name() << "', coordination is disabled";
+    }
+  }
+
+  Scheduler::StandardInitFunc OnInitContext = OnInitBound;
+  Scheduler::StandardReleaseFunc OnRelease;
+  if (scaling_enabled) {
+    // Reserve the transient extra slot used while recreating a
+    // context so that 'contexts_' never reallocates once the runner
+    // threads are indexing it.
+    contexts_.reserve(contexts_.size() + 1);
+    OnInitContext = [this, OnInitBound](uint32_t runner_idx) -> Status {
+      RETURN_IF_ERROR(EnsureContext(runner_idx));
+      return OnInitBound(runner_idx);
+    };
+    OnRelease = [this](uint32_t runner_idx) -> Status {
+      return ReleaseContext(runner_idx);
+    };
+  }
+
   // If 'sequence_batching' is configured use the SequenceBatchScheduler,
   // otherwise use the default DynamicBatchScheduler.
   if (config_.has_sequence_batching()) {
     // Sequence batcher
     RETURN_IF_ERROR(SequenceBatchScheduler::Create(
-        config_, runner_cnt, OnInit, OnWarmup, OnRun, OnPeek,
+        config_, runner_cnt, OnInitBound, OnWarmup, OnRunCoordinated, OnPeek,
         enforce_equal_shape_tensors, &scheduler));
   } else if (config_.has_dynamic_batching()) {
     // Dynamic batcher
@@ -189,30 +460,100 @@ InferenceBackend::SetConfiguredScheduler(
     }
 
     RETURN_IF_ERROR(DynamicBatchScheduler::Create(
-        0 /* runner_id_start */, runner_cnt, GetCpuNiceLevel(config_), OnInit,
-        OnWarmup, OnRun, OnPeek, true /* dynamic_batching_enabled */,
-        enforce_equal_shape_tensors,
+        0 /* runner_id_start */, runner_cnt, GetCpuNiceLevel(config_),
+        OnInitContext, OnWarmup, OnRunCoordinated, OnPeek,
+        true /* dynamic_batching_enabled */, enforce_equal_shape_tensors,
         config_.dynamic_batching().preserve_ordering(), preferred_batch_sizes,
         config_.dynamic_batching().max_queue_delay_microseconds(),
+        config_.dynamic_batching().queue_latency_target_microseconds(),
         config_.dynamic_batching().default_queue_policy(),
         config_.dynamic_batching().priority_levels(),
-        config_.dynamic_batching().priority_queue_policy(), &scheduler));
+        config_.dynamic_batching().priority_queue_policy(),
+        min_active_runner_cnt, scale_to_zero_idle_microseconds, OnRelease,
+        metric_reporter_, &scheduler));
   } else {
     // Default scheduler. Use dynamic batch scheduler (with batching
     // disabled) as the default scheduler.
     RETURN_IF_ERROR(DynamicBatchScheduler::Create(
-        0 /* runner_id_start */, runner_cnt, GetCpuNiceLevel(config_), OnInit,
-        OnWarmup, OnRun, OnPeek, false /* dynamic_batching_enabled */,
+        0 /* runner_id_start */, runner_cnt, GetCpuNiceLevel(config_),
+        OnInitContext, OnWarmup, OnRunCoordinated, OnPeek,
+        false /* dynamic_batching_enabled */,
         std::unordered_map<
             std::string, bool>() /* enforce_equal_shape_tensors */,
         false /* preserve_ordering */,
         std::set<int32_t>() /* preferred_batch_sizes */,
-        0 /* max_queue_delay_microseconds */, &scheduler));
+        0 /* max_queue_delay_microseconds */, min_active_runner_cnt,
+        scale_to_zero_idle_microseconds, OnRelease, metric_reporter_,
+        &scheduler));
   }
 
   return SetScheduler(std::move(scheduler));
 }
 
+void
+InferenceBackend::RegisterContextFactory(std::function<Status()> factory)
+{
+  context_factories_.emplace_back(std::move(factory));
+}
+
+Status
+InferenceBackend::EnsureContext(const uint32_t runner_idx)
+{
+  std::lock_guard<std::mutex> lock(context_scaling_mu_);
+  if (runner_idx >= contexts_.size()) {
+    return Status(
+        Status::Code::INTERNAL,
+        "unexpected runner index" + std::to_string(runner_idx) +
+            ", max allowed " + std::to_string(contexts_.size()));
+  }
+  if (contexts_[runner_idx] != nullptr) {
+    return Status::Success;
+  }
+  if ((runner_idx >= context_factories_.size()) ||
+      (context_factories_[runner_idx] == nullptr)) {
+    return Status(
+        Status::Code::INTERNAL, "no context factory registered for runner " +
+                                    std::to_string(runner_idx));
+  }
+
+  // The factory creates the replacement context at the back of
+  // 'contexts_'; move it into the vacated slot. The extra slot was
+  // reserved when scaling was enabled so the vector never reallocates
+  // here.
+  const size_t prev_size = contexts_.size();
+  RETURN_IF_ERROR(context_factories_[runner_idx]());
+  if (contexts_.size() != (prev_size + 1)) {
+    return Status(
+        Status::Code::INTERNAL,
+        "context factory did not create a context for runner " +
+            std::to_string(runner_idx));
+  }
+  contexts_[runner_idx] = std::move(contexts_.back());
+  contexts_.pop_back();
+
+  LOG_VERBOSE(1) << "recreated execution context for runner "
+                 << std::to_string(runner_idx) << " of '" << Name() << "'";
+  return Status::Success;
+}
+
+Status
+InferenceBackend::ReleaseContext(const uint32_t runner_idx)
+{
+  std::lock_guard<std::mutex> lock(context_scaling_mu_);
+  if (runner_idx >= contexts_.size()) {
+    return Status(
+        Status::Code::INTERNAL,
+        "unexpected runner index" + std::to_string(runner_idx) +
+            ", max allowed " + std::to_string(contexts_.size()));
+  }
+  if (contexts_[runner_idx] != nullptr) {
+    LOG_VERBOSE(1) << "releasing execution context for runner "
+                   << std::to_string(runner_idx) << " of '" << Name() << "'";
+    contexts_[runner_idx].reset();
+  }
+  return Status::Success;
+}
+
 Status
 InferenceBackend::Init(
     const std::string& path, const ModelConfig& config,
@@ -222,6 +563,30 @@ InferenceBackend::Init(
       ValidateModelConfig(config, platform, min_compute_capability_));
   RETURN_IF_ERROR(SetModelConfig(path, config));
 
+  if (config_.response_cache().enable()) {
+    uint64_t max_byte_size = config_.response_cache().max_byte_size();
+    if (max_byte_size == 0) {
+      max_byte_size = 1 << 26;  // 64 MB
+    }
+
+    response_cache_.reset(new ResponseCache(max_byte_size));
+  }
+
+  const auto& admission = config_.admission_control();
+  if (admission.rate_limit().requests_per_second() > 0) {
+    rate_limit_.reset(new TokenBucket(
+        admission.rate_limit().requests_per_second(),
+        admission.rate_limit().burst_size()));
+  }
+  for (const auto& pr : admission.priority_rate_limit()) {
+    if (pr.second.requests_per_second() > 0) {
+      priority_rate_limits_[pr.first].reset(new TokenBucket(
+          pr.second.requests_per_second(), pr.second.burst_size()));
+    }
+  }
+
+  memory_usage_ = MemoryUsageTracker::UsageForModel(Name());
+
   return Status::Success;
 }
 
@@ -232,6 +597,110 @@ InferenceBackend::Run(
     const std::shared_ptr<InferResponseProvider>& response_provider,
     std::function<void(const Status&)> OnCompleteHandleInfer)
 {
+  // Charge allocations made while the request is dispatched to the
+  // model's usage record. The runner threads establish their own
+  // scope, see the payload Run() below.
+  MemoryUsageTracker::Scope usage_scope(memory_usage_);
+
+  // Try to answer the request from the response cache, bypassing the
+  // scheduler entirely on a hit. On a miss the completion callback is
+  // wrapped so that the response is inserted into the cache.
+  if (response_cache_ != nullptr) {
+    uint64_t digest;
+    if (ResponseCache::Digest(*request, &digest)) {
+      const Status status = response_cache_->Lookup(digest, response_provider);
+      if (status.StatusCode() != Status::Code::NOT_FOUND) {
+        OnCompleteHandleInfer(status);
+        return;
+      }
+
+      auto OnCompleteCacheInsert = [this, digest, request, response_provider,
+                                    OnCompleteHandleInfer](
+                                       const Status& status) {
+        if (status.IsOk()) {
+          response_cache_->Insert(digest, *request, response_provider);
+        }
+        OnCompleteHandleInfer(status);
+      };
+      OnCompleteHandleInfer = std::move(OnCompleteCacheInsert);
+    }
+  }
+
+  // Enforce the configured token-bucket rate limits ahead of the
+  // scheduler queue: the bucket of the request's priority level, if
+  // one is configured, is drained first, then the per-model bucket.
+  // A request shed by the per-model bucket has already taken its
+  // priority token, which slightly under-admits that level while the
+  // model as a whole is over its rate.
+  if ((rate_limit_ != nullptr) || !priority_rate_limits_.empty()) {
+    TokenBucket* priority_bucket = nullptr;
+    const auto pitr = priority_rate_limits_.find(request->Priority());
+    if (pitr != priority_rate_limits_.end()) {
+      priority_bucket = pitr->second.get();
+    }
+    if (((priority_bucket != nullptr) && !priority_bucket->TryAcquire()) ||
+        ((rate_limit_ != nullptr) && !rate_limit_->TryAcquire())) {
+      OnCompleteHandleInfer(Status(
+          Status::Code::UNAVAILABLE,
+          "request rate limit exceeded for model '" + Name() + "'"));
+      return;
+    }
+  }
+
+  // Enforce the configured memory budgets. The budgets are checked
+  // against the usage already charged by in-flight requests rather
+  // than reserved up front; a request admitted while the model is
+  // just under a budget may still push it over, but once over, new
+  // requests are shed until enough in-flight allocations are
+  // released.
+  const auto& admission = config_.admission_control();
+  if (((admission.max_system_memory_byte_size() > 0) &&
+       (memory_usage_->ByteSize(MemoryUsage::SYSTEM) >
+        admission.max_system_memory_byte_size())) ||
+      ((admission.max_pinned_memory_byte_size() > 0) &&
+       (memory_usage_->ByteSize(MemoryUsage::PINNED) >
+        admission.max_pinned_memory_byte_size())) ||
+      ((admission.max_gpu_memory_byte_size() > 0) &&
+       (memory_usage_->ByteSize(MemoryUsage::GPU) >
+        admission.max_gpu_memory_byte_size()))) {
+    OnCompleteHandleInfer(Status(
+        Status::Code::UNAVAILABLE,
+        "in-flight memory budget exceeded for model '" + Name() + "'"));
+    return;
+  }
+
+  if ((admission.max_inflight_requests() > 0) ||
+      (admission.max_inflight_byte_size() > 0)) {
+    // Optimistically account for the request and back out if a limit
+    // is exceeded. This keeps the check a pair of atomic adds instead
+    // of requiring a lock around the compare-and-update.
+    const uint64_t request_byte_size = request->TotalInputByteSize();
+    const uint64_t inflight_count = ++inflight_request_count_;
+    const uint64_t inflight_bytes = (inflight_byte_size_ += request_byte_size);
+    if (((admission.max_inflight_requests() > 0) &&
+         (inflight_count > admission.max_inflight_requests())) ||
+        ((admission.max_inflight_byte_size() > 0) &&
+         (inflight_bytes > admission.max_inflight_byte_size()))) {
+      inflight_request_count_--;
+      inflight_byte_size_ -= request_byte_size;
+      OnCompleteHandleInfer(Status(
+          Status::Code::UNAVAILABLE,
+          "in-flight request limit exceeded for model '" + Name() + "'"));
+      return;
+    }
+
+    // 'OnCompleteHandleInfer' holds a reference to the backend so
+    // 'this' is guaranteed to be valid when the wrapper runs.
+    scheduler_->Enqueue(
+        stats, request, response_provider,
+        [this, request_byte_size, OnCompleteHandleInfer](const Status& status) {
+          inflight_request_count_--;
+          inflight_byte_size_ -= request_byte_size;
+          OnCompleteHandleInfer(status);
+        });
+    return;
+  }
+
   scheduler_->Enqueue(stats, request, response_provider, OnCompleteHandleInfer);
 }
 
@@ -248,6 +717,16 @@ InferenceBackend::Run(
             ", max allowed " + std::to_string(contexts_.size())));
     return;
   }
+  if (contexts_[runner_idx] == nullptr) {
+    OnCompleteQueuedPayloads(Status(
+        Status::Code::INTERNAL, "runner index " + std::to_string(runner_idx) +
+                                    " has no execution context"));
+    return;
+  }
+
+  // Charge the output and staging buffers allocated while the batch
+  // executes to the model's usage record.
+  MemoryUsageTracker::Scope usage_scope(memory_usage_);
 
 #ifdef TRTIS_ENABLE_STATS
   // Stop queue timer and start compute timer when the payload is
@@ -261,7 +740,21 @@ InferenceBackend::Run(
   }
 #endif  // TRTIS_ENABLE_STATS
 
-  Status status = contexts_[runner_idx]->Run(this, payloads);
+  Status status;
+  {
+    NVTX_RANGE(nvtx_, "Run " + Name());
+#ifdef TRTIS_ENABLE_NVTX
+    // One marker per batched request inside the run range, so a
+    // capture can connect this execution back to the requests whose
+    // ids appear at arrival, enqueue and dequeue.
+    for (const auto& payload : *payloads) {
+      NVTX_MARKER_ID("RunRequest " + Name(), payload.request_->UniqueId());
+    }
+#endif  // TRTIS_ENABLE_NVTX
+    TRTIS_PROBE2(backend_run_start, Name().c_str(), payloads->size());
+    status = contexts_[runner_idx]->Run(this, payloads);
+    TRTIS_PROBE2(backend_run_end, Name().c_str(), payloads->size());
+  }
 
 #ifdef TRTIS_ENABLE_STATS
   // Stop compute timers.
@@ -303,217 +796,249 @@ InferenceBackend::GenerateWarmupData(std::vector<WarmupData>* samples)
 {
   samples->clear();
   for (const auto& warmup_setting : config_.model_warmup()) {
-    LOG_VERBOSE(1) << "Generating warmup sample data for '"
-                   << warmup_setting.name() << "'";
-
-    // Three passes. First pass to get max byte size for synthetic
-    // data. Second pass to add original inputs and third pass to add
-    // override inputs for control inputs.
-    int64_t max_zero_byte_size = 0;
-    int64_t max_random_byte_size = 0;
-    for (const auto& input_meta : warmup_setting.inputs()) {
-      auto element_count = GetElementCount(input_meta.second.dims());
-      if (element_count == -1) {
-        return Status(
-            Status::Code::INVALID_ARG,
-            "warmup setting expects all variable-size dimensions are specified "
-            "for input '" +
-                input_meta.first + "'");
+    // A batch size of 0 runs the sample at every preferred batch size
+    // of the dynamic batcher so that each batching path the scheduler
+    // may take is exercised before the model reports ready.
+    if (warmup_setting.batch_size() == 0) {
+      if (config_.dynamic_batching().preferred_batch_size().empty()) {
+        RETURN_IF_ERROR(GenerateWarmupSample(
+            warmup_setting, warmup_setting.name(), 1, samples));
+      } else {
+        for (const auto size :
+             config_.dynamic_batching().preferred_batch_size()) {
+          RETURN_IF_ERROR(GenerateWarmupSample(
+              warmup_setting,
+              warmup_setting.name() + "_" + std::to_string(size), size,
+              samples));
+        }
+      }
+    } else {
+      RETURN_IF_ERROR(GenerateWarmupSample(
+          warmup_setting, warmup_setting.name(), warmup_setting.batch_size(),
+          samples));
+    }
+  }
+
+  return Status::Success;
+}
+
+Status
+InferenceBackend::GenerateWarmupSample(
+    const ModelWarmup& warmup_setting, const std::string& sample_name,
+    const size_t batch_size, std::vector<WarmupData>* samples)
+{
+  LOG_VERBOSE(1) << "Generating warmup sample data for '" << sample_name
+                 << "'";
+
+  // Three passes. First pass to get max byte size for synthetic
+  // data. Second pass to add original inputs and third pass to add
+  // override inputs for control inputs.
+  int64_t max_zero_byte_size = 0;
+  int64_t max_random_byte_size = 0;
+  for (const auto& input_meta : warmup_setting.inputs()) {
+    auto element_count = GetElementCount(input_meta.second.dims());
+    if (element_count == -1) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "warmup setting expects all variable-size dimensions are specified "
+          "for input '" +
+              input_meta.first + "'");
+    }
+
+    int64_t batch_byte_size =
+        element_count * GetDataTypeByteSize(input_meta.second.data_type());
+    if (batch_byte_size == 0) {
+      batch_byte_size = element_count * sizeof(int32_t);
+    }
+
+    switch (input_meta.second.input_data_type_case()) {
+      case ModelWarmup_Input::InputDataTypeCase::kZeroData:
+        max_zero_byte_size = std::max(batch_byte_size, max_zero_byte_size);
+        break;
+      case ModelWarmup_Input::InputDataTypeCase::kRandomData: {
+        if (input_meta.second.data_type() == DataType::TYPE_STRING) {
+          max_zero_byte_size = std::max(batch_byte_size, max_zero_byte_size);
+        } else {
+          max_random_byte_size =
+              std::max(batch_byte_size, max_random_byte_size);
+        }
+        break;
       }
+      default:
+        break;
+    }
+  }
+
+  samples->emplace_back(
+      sample_name, batch_size,
+      std::max<size_t>(1, warmup_setting.count()));
+  auto& warmup_data = samples->back();
+  // Create buffers for synthetic data
+  TRTSERVER_Memory_Type type;
+  int64_t type_id;
+  warmup_data.zero_data_.reset(new AllocatedMemory(
+      max_zero_byte_size, TRTSERVER_MEMORY_CPU_PINNED /* memory_type */,
+      0 /* memory_type_id */));
+  char* zero_buffer = warmup_data.zero_data_->MutableBuffer(&type, &type_id);
+  memset(zero_buffer, 0, max_zero_byte_size);
+
+  warmup_data.random_data_.reset(new AllocatedMemory(
+      max_random_byte_size, TRTSERVER_MEMORY_CPU_PINNED /* memory_type */,
+      0 /* memory_type_id */));
+  char* random_buffer =
+      warmup_data.random_data_->MutableBuffer(&type, &type_id);
+  for (int64_t offset = 0; offset < max_random_byte_size; offset++) {
+    random_buffer[offset] = rand();
+  }
+
+  // Use batch-1 for every request, batch size is simulated by
+  // populating requests for single run. FIXMEV2 once
+  // protocol_version 2 is the only one remove SetBatchSize and
+  // adjust the input/output tensors to have appropriate shape
+  warmup_data.request_ =
+      std::make_shared<InferenceRequest>(Name(), Version(), Version(), 1);
+  warmup_data.request_->SetBatchSize(1);
 
-      int64_t batch_byte_size =
+  // Request all outputs
+  for (const auto& io : Config().output()) {
+    RETURN_IF_ERROR(warmup_data.request_->AddRequestedOutput(io.name()));
+  }
+
+  // Second pass to prepare original inputs.
+  for (const auto& input_meta : warmup_setting.inputs()) {
+    const ModelInput* input_config;
+    if (GetInput(input_meta.first, &input_config).IsOk()) {
+      std::vector<int64_t> input_meta_shape;
+      for (auto d : input_meta.second.dims()) {
+        input_meta_shape.push_back(d);
+      }
+
+      auto element_count = GetElementCount(input_meta_shape);
+      auto batch_byte_size =
           element_count * GetDataTypeByteSize(input_meta.second.data_type());
       if (batch_byte_size == 0) {
         batch_byte_size = element_count * sizeof(int32_t);
       }
 
+      const char* allocated_ptr;
       switch (input_meta.second.input_data_type_case()) {
         case ModelWarmup_Input::InputDataTypeCase::kZeroData:
-          max_zero_byte_size = std::max(batch_byte_size, max_zero_byte_size);
+          allocated_ptr = zero_buffer;
           break;
         case ModelWarmup_Input::InputDataTypeCase::kRandomData: {
           if (input_meta.second.data_type() == DataType::TYPE_STRING) {
-            max_zero_byte_size = std::max(batch_byte_size, max_zero_byte_size);
+            allocated_ptr = zero_buffer;
           } else {
-            max_random_byte_size =
-                std::max(batch_byte_size, max_random_byte_size);
+            allocated_ptr = random_buffer;
           }
           break;
         }
-        default:
-          break;
-      }
-    }
-
-    samples->emplace_back(warmup_setting.name(), warmup_setting.batch_size());
-    auto& warmup_data = samples->back();
-    // Create buffers for synthetic data
-    TRTSERVER_Memory_Type type;
-    int64_t type_id;
-    warmup_data.zero_data_.reset(new AllocatedMemory(
-        max_zero_byte_size, TRTSERVER_MEMORY_CPU_PINNED /* memory_type */,
-        0 /* memory_type_id */));
-    char* zero_buffer = warmup_data.zero_data_->MutableBuffer(&type, &type_id);
-    memset(zero_buffer, 0, max_zero_byte_size);
-
-    warmup_data.random_data_.reset(new AllocatedMemory(
-        max_random_byte_size, TRTSERVER_MEMORY_CPU_PINNED /* memory_type */,
-        0 /* memory_type_id */));
-    char* random_buffer =
-        warmup_data.random_data_->MutableBuffer(&type, &type_id);
-    for (int64_t offset = 0; offset < max_random_byte_size; offset++) {
-      random_buffer[offset] = rand();
-    }
-
-    // Use batch-1 for every request, batch size is simulated by
-    // populating requests for single run. FIXMEV2 once
-    // protocol_version 2 is the only one remove SetBatchSize and
-    // adjust the input/output tensors to have appropriate shape
-    warmup_data.request_ =
-        std::make_shared<InferenceRequest>(Name(), Version(), Version(), 1);
-    warmup_data.request_->SetBatchSize(1);
-
-    // Request all outputs
-    for (const auto& io : Config().output()) {
-      RETURN_IF_ERROR(warmup_data.request_->AddRequestedOutput(io.name()));
-    }
-
-    // Second pass to prepare original inputs.
-    for (const auto& input_meta : warmup_setting.inputs()) {
-      const ModelInput* input_config;
-      if (GetInput(input_meta.first, &input_config).IsOk()) {
-        std::vector<int64_t> input_meta_shape;
-        for (auto d : input_meta.second.dims()) {
-          input_meta_shape.push_back(d);
-        }
+        case ModelWarmup_Input::InputDataTypeCase::kInputDataFile: {
+          // For data provided from file, we can set buffer in first pass
+          warmup_data.provided_data_.emplace_back();
+          auto& input_data = warmup_data.provided_data_.back();
+          RETURN_IF_ERROR(ReadTextFile(
+              JoinPath({model_dir_, kWarmupDataFolder,
+                        input_meta.second.input_data_file()}),
+              &input_data));
 
-        auto element_count = GetElementCount(input_meta_shape);
-        auto batch_byte_size =
-            element_count * GetDataTypeByteSize(input_meta.second.data_type());
-        if (batch_byte_size == 0) {
-          batch_byte_size = element_count * sizeof(int32_t);
-        }
-
-        const char* allocated_ptr;
-        switch (input_meta.second.input_data_type_case()) {
-          case ModelWarmup_Input::InputDataTypeCase::kZeroData:
-            allocated_ptr = zero_buffer;
-            break;
-          case ModelWarmup_Input::InputDataTypeCase::kRandomData: {
-            if (input_meta.second.data_type() == DataType::TYPE_STRING) {
-              allocated_ptr = zero_buffer;
-            } else {
-              allocated_ptr = random_buffer;
-            }
-            break;
-          }
-          case ModelWarmup_Input::InputDataTypeCase::kInputDataFile: {
-            // For data provided from file, we can set buffer in first pass
-            warmup_data.provided_data_.emplace_back();
-            auto& input_data = warmup_data.provided_data_.back();
-            RETURN_IF_ERROR(ReadTextFile(
-                JoinPath({model_dir_, kWarmupDataFolder,
-                          input_meta.second.input_data_file()}),
-                &input_data));
-
-            if (input_meta.second.data_type() == DataType::TYPE_STRING) {
-              batch_byte_size = input_data.size();
-            } else if (((size_t)batch_byte_size) > input_data.size()) {
-              return Status(
-                  Status::Code::INVALID_ARG,
-                  "warmup setting expects " + std::to_string(batch_byte_size) +
-                      " bytes, but the data "
-                      "provided from " +
-                      input_meta.second.input_data_file() + "only has " +
-                      std::to_string(input_data.size()) + " bytes");
-            }
-            allocated_ptr = input_data.data();
-            break;
-          }
-          default:
+          if (input_meta.second.data_type() == DataType::TYPE_STRING) {
+            batch_byte_size = input_data.size();
+          } else if (((size_t)batch_byte_size) > input_data.size()) {
             return Status(
-                Status::Code::INVALID_ARG, "warmup setting expects input '" +
-                                               input_meta.first +
-                                               "' to have input_data_type set");
+                Status::Code::INVALID_ARG,
+                "warmup setting expects " + std::to_string(batch_byte_size) +
+                    " bytes, but the data "
+                    "provided from " +
+                    input_meta.second.input_data_file() + "only has " +
+                    std::to_string(input_data.size()) + " bytes");
+          }
+          allocated_ptr = input_data.data();
+          break;
         }
-
-        InferenceRequest::Input* input = nullptr;
-        RETURN_IF_ERROR(warmup_data.request_->AddOriginalInput(
-            input_meta.first, input_meta_shape, batch_byte_size, &input));
-        RETURN_IF_ERROR(input->AppendData(
-            allocated_ptr, batch_byte_size,
-            TRTSERVER_MEMORY_CPU /* memory_type */, 0 /* memory_type_id */));
+        default:
+          return Status(
+              Status::Code::INVALID_ARG, "warmup setting expects input '" +
+                                             input_meta.first +
+                                             "' to have input_data_type set");
       }
+
+      InferenceRequest::Input* input = nullptr;
+      RETURN_IF_ERROR(warmup_data.request_->AddOriginalInput(
+          input_meta.first, input_meta_shape, batch_byte_size, &input));
+      RETURN_IF_ERROR(input->AppendData(
+          allocated_ptr, batch_byte_size,
+          TRTSERVER_MEMORY_CPU /* memory_type */, 0 /* memory_type_id */));
     }
+  }
 
-    RETURN_IF_ERROR(warmup_data.request_->PrepareForInference(*this));
+  RETURN_IF_ERROR(warmup_data.request_->PrepareForInference(*this));
 
-    // Third pass to prepare control inputs.
-    for (const auto& input_meta : warmup_setting.inputs()) {
-      const ModelInput* input_config;
-      if (!GetInput(input_meta.first, &input_config).IsOk()) {
-        std::vector<int64_t> input_meta_shape;
-        for (auto d : input_meta.second.dims()) {
-          input_meta_shape.push_back(d);
-        }
+  // Third pass to prepare control inputs.
+  for (const auto& input_meta : warmup_setting.inputs()) {
+    const ModelInput* input_config;
+    if (!GetInput(input_meta.first, &input_config).IsOk()) {
+      std::vector<int64_t> input_meta_shape;
+      for (auto d : input_meta.second.dims()) {
+        input_meta_shape.push_back(d);
+      }
 
-        auto element_count = GetElementCount(input_meta_shape);
-        auto batch_byte_size =
-            element_count * GetDataTypeByteSize(input_meta.second.data_type());
-        if (batch_byte_size == 0) {
-          batch_byte_size = element_count * sizeof(int32_t);
-        }
+      auto element_count = GetElementCount(input_meta_shape);
+      auto batch_byte_size =
+          element_count * GetDataTypeByteSize(input_meta.second.data_type());
+      if (batch_byte_size == 0) {
+        batch_byte_size = element_count * sizeof(int32_t);
+      }
 
-        std::vector<uint8_t> content;
-        switch (input_meta.second.input_data_type_case()) {
-          case ModelWarmup_Input::InputDataTypeCase::kZeroData:
+      std::vector<uint8_t> content;
+      switch (input_meta.second.input_data_type_case()) {
+        case ModelWarmup_Input::InputDataTypeCase::kZeroData:
+          content.assign(zero_buffer, zero_buffer + batch_byte_size);
+          break;
+        case ModelWarmup_Input::InputDataTypeCase::kRandomData: {
+          if (input_meta.second.data_type() == DataType::TYPE_STRING) {
             content.assign(zero_buffer, zero_buffer + batch_byte_size);
-            break;
-          case ModelWarmup_Input::InputDataTypeCase::kRandomData: {
-            if (input_meta.second.data_type() == DataType::TYPE_STRING) {
-              content.assign(zero_buffer, zero_buffer + batch_byte_size);
-            } else {
-              content.assign(random_buffer, random_buffer + batch_byte_size);
-            }
-            break;
-          }
-          case ModelWarmup_Input::InputDataTypeCase::kInputDataFile: {
-            std::string input_data;
-            RETURN_IF_ERROR(ReadTextFile(
-                JoinPath({model_dir_, kWarmupDataFolder,
-                          input_meta.second.input_data_file()}),
-                &input_data));
-
-            if (input_meta.second.data_type() == DataType::TYPE_STRING) {
-              batch_byte_size = input_data.size();
-            } else if (((size_t)batch_byte_size) > input_data.size()) {
-              return Status(
-                  Status::Code::INVALID_ARG,
-                  "warmup setting expects " + std::to_string(batch_byte_size) +
-                      " bytes, but the data "
-                      "provided from " +
-                      input_meta.second.input_data_file() + "only has " +
-                      std::to_string(input_data.size()) + " bytes");
-            }
-
-            content.assign(
-                input_data.data(), input_data.data() + input_data.size());
-            break;
+          } else {
+            content.assign(random_buffer, random_buffer + batch_byte_size);
           }
-          default:
-            return Status(
-                Status::Code::INVALID_ARG, "warmup setting expects input '" +
-                                               input_meta.first +
-                                               "' to have input_data_type set");
+          break;
         }
+        case ModelWarmup_Input::InputDataTypeCase::kInputDataFile: {
+          std::string input_data;
+          RETURN_IF_ERROR(ReadTextFile(
+              JoinPath({model_dir_, kWarmupDataFolder,
+                        input_meta.second.input_data_file()}),
+              &input_data));
 
-        std::shared_ptr<InferenceRequest::Input> input;
-        RETURN_IF_ERROR(warmup_data.request_->AddOverrideInput(
-            input_meta.first, input_meta.second.data_type(), input_meta_shape,
-            content.size(), &input));
-        RETURN_IF_ERROR(input->AppendData(
-            &content[0], content.size(), TRTSERVER_MEMORY_CPU, 0));
+          if (input_meta.second.data_type() == DataType::TYPE_STRING) {
+            batch_byte_size = input_data.size();
+          } else if (((size_t)batch_byte_size) > input_data.size()) {
+            return Status(
+                Status::Code::INVALID_ARG,
+                "warmup setting expects " + std::to_string(batch_byte_size) +
+                    " bytes, but the data "
+                    "provided from " +
+                    input_meta.second.input_data_file() + "only has " +
+                    std::to_string(input_data.size()) + " bytes");
+          }
+
+          content.assign(
+              input_data.data(), input_data.data() + input_data.size());
+          break;
+        }
+        default:
+          return Status(
+              Status::Code::INVALID_ARG, "warmup setting expects input '" +
+                                             input_meta.first +
+                                             "' to have input_data_type set");
       }
+
+      std::shared_ptr<InferenceRequest::Input> input;
+      RETURN_IF_ERROR(warmup_data.request_->AddOverrideInput(
+          input_meta.first, input_meta.second.data_type(), input_meta_shape,
+          content.size(), &input));
+      RETURN_IF_ERROR(input->AppendData(
+          &content[0], content.size(), TRTSERVER_MEMORY_CPU, 0));
     }
   }
 
@@ -25,11 +25,19 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
 #include "src/core/api.pb.h"
 #include "src/core/backend_context.h"
 #include "src/core/label_provider.h"
+#include "src/core/memory_usage.h"
 #include "src/core/model_config.pb.h"
+#include "src/core/name_table.h"
 #include "src/core/provider.h"
+#include "src/core/rate_limiter.h"
+#include "src/core/response_cache.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
 
@@ -59,18 +67,102 @@ class InferenceBackend {
   // Get the configuration of model being served.
   const ModelConfig& Config() const { return config_; }
 
+  // Get the maximum batch size compiled from the model configuration.
+  // A value of 0 indicates the model does not support batching.
+  int MaxBatchSize() const { return max_batch_size_; }
+  bool SupportsBatching() const { return max_batch_size_ != 0; }
+
   // Get the metric reporter for the model being served.
   const std::shared_ptr<MetricModelReporter>& MetricReporter() const
   {
     return metric_reporter_;
   }
 
+  // Per-input expectations compiled from the model configuration at
+  // load time so that request normalization validates with plain
+  // integer comparisons instead of walking the protobuf per request.
+  struct InputPlan {
+    DataType data_type_;
+    bool fixed_size_data_type_;
+    bool is_shape_tensor_;
+    bool has_reshape_;
+
+    // True if the input declares a non-linear memory format, in which
+    // case the content includes vectorization padding and its byte
+    // size can't be calculated from the shape.
+    bool is_non_linear_format_;
+
+    // The configured dims; -1 marks a variable dimension.
+    std::vector<int64_t> dims_;
+
+    // The reshape target, empty unless 'has_reshape_' is true.
+    std::vector<int64_t> reshape_dims_;
+
+    // The shape after any reshape is applied, used when the request
+    // doesn't specify a shape; -1 marks a variable dimension.
+    std::vector<int64_t> default_shape_;
+    bool default_shape_has_variable_dim_;
+  };
+
+  // Per-output expectations compiled from the model configuration at
+  // load time so that response finalization reads flat arrays instead
+  // of walking the protobuf per response.
+  struct OutputPlan {
+    DataType data_type_;
+    bool fixed_size_data_type_;
+    bool has_reshape_;
+
+    // The configured dims; -1 marks a variable dimension.
+    std::vector<int64_t> dims_;
+
+    // The batch-1 shape the backend is expected to produce: the
+    // reshape target if one is configured, the configured dims
+    // otherwise; -1 marks a variable dimension.
+    std::vector<int64_t> expected_shape_;
+
+    // The positions of the variable dimensions in 'expected_shape_',
+    // in order. Used when a reshape is configured to map the sizes
+    // the backend produced back onto the variable dimensions of
+    // 'dims_' for the response shape.
+    std::vector<size_t> variable_dim_index_;
+  };
+
   // Get the model configuration for a named input.
   Status GetInput(const std::string& name, const ModelInput** input) const;
 
+  // Get the compiled normalization plan for a named input.
+  Status GetInputPlan(const std::string& name, const InputPlan** plan) const;
+
   // Get the model configuration for a named output.
   Status GetOutput(const std::string& name, const ModelOutput** output) const;
 
+  // Get the compiled response plan for a named output.
+  Status GetOutputPlan(const std::string& name, const OutputPlan** plan) const;
+
+  // Get the interned index for a named input / output, or -1 if the
+  // model has no such tensor. The index is stable for the lifetime of
+  // the backend so callers can resolve a name once and use the index
+  // on the request path.
+  int32_t InputIndex(const std::string& name) const
+  {
+    return input_names_.Intern(name);
+  }
+  int32_t OutputIndex(const std::string& name) const
+  {
+    return output_names_.Intern(name);
+  }
+
+  // Get the model configuration for the input / output with an
+  // interned index as returned by InputIndex() / OutputIndex().
+  const ModelInput& InputAt(const int32_t index) const
+  {
+    return inputs_[index];
+  }
+  const ModelOutput& OutputAt(const int32_t index) const
+  {
+    return outputs_[index];
+  }
+
   // Get a label provider for the model.
   const std::shared_ptr<LabelProvider>& GetLabelProvider() const
   {
@@ -94,15 +186,24 @@ class InferenceBackend {
 
   uint32_t MaxPriorityLevel() const { return max_priority_level_; }
 
+  // Apply the hot-swappable scheduler parameters of 'config' to the
+  // live scheduler without reloading the model. Returns an error if
+  // the scheduler cannot apply the update in place, in which case the
+  // caller must fall back to a full model reload.
+  Status UpdateSchedulerConfig(const ModelConfig& config);
+
  protected:
   struct WarmupData {
-    WarmupData(const std::string& sample_name, size_t batch_size)
-        : sample_name_(sample_name), batch_size_(batch_size)
+    WarmupData(
+        const std::string& sample_name, size_t batch_size, size_t count)
+        : sample_name_(sample_name), batch_size_(batch_size), count_(count)
     {
     }
 
     std::string sample_name_;
     size_t batch_size_;
+    // The number of times the sample is run on each model instance.
+    size_t count_;
     std::shared_ptr<InferenceRequest> request_;
 
     // Placeholder for input data
@@ -139,12 +240,37 @@ class InferenceBackend {
   // Get the raw pointer to the scheduler of this backend.
   Scheduler* BackendScheduler() { return scheduler_.get(); }
 
+  // Register a factory that recreates the execution context for the
+  // next model instance. Factories must be registered in the same
+  // order the contexts are created so that they index like
+  // 'contexts_', and each factory must create its context at the back
+  // of 'contexts_'. Registering a factory for every context enables
+  // dynamic instance scaling for the model when the instance groups
+  // configure a 'min_count' below 'count'.
+  void RegisterContextFactory(std::function<Status()> factory);
+
   std::vector<std::unique_ptr<BackendContext>> contexts_;
 
  private:
+  // Recreate the execution context associated with 'runner_idx' if it
+  // has been released by dynamic instance scaling. Must only be
+  // called from the runner associated with the context.
+  Status EnsureContext(const uint32_t runner_idx);
+
+  // Release the execution context associated with 'runner_idx',
+  // freeing its resources until EnsureContext() recreates it. Must
+  // only be called from the runner associated with the context.
+  Status ReleaseContext(const uint32_t runner_idx);
+
   // Generate warmup data
   Status GenerateWarmupData(std::vector<WarmupData>* samples);
 
+  // Generate one warmup sample for 'warmup_setting' at the given
+  // batch size and append it to 'samples'.
+  Status GenerateWarmupSample(
+      const ModelWarmup& warmup_setting, const std::string& sample_name,
+      const size_t batch_size, std::vector<WarmupData>* samples);
+
   // The minimum supported CUDA compute capability.
   const double min_compute_capability_;
 
@@ -163,15 +289,59 @@ class InferenceBackend {
   // The scheduler to use for this backend.
   std::unique_ptr<Scheduler> scheduler_;
 
-  // Map from input name to the model configuration for that input.
-  std::unordered_map<std::string, ModelInput> input_map_;
-
-  // Map from output name to the model configuration for that output.
-  std::unordered_map<std::string, ModelOutput> output_map_;
+  // Factories able to recreate a released execution context, indexed
+  // like 'contexts_'. Empty if the backend does not register
+  // factories, which leaves dynamic instance scaling disabled.
+  std::vector<std::function<Status()>> context_factories_;
+
+  // Serializes context release and recreation for dynamic instance
+  // scaling. The dispatch path in Run() is not serialized; it only
+  // ever reads the slot of 'contexts_' owned by its runner.
+  std::mutex context_scaling_mu_;
+
+  // The response cache for this backend, nullptr if response caching
+  // is not enabled for the model.
+  std::unique_ptr<ResponseCache> response_cache_;
+
+  // The token buckets enforcing the admission rate limits from the
+  // model configuration: one for the model and one per configured
+  // priority level. nullptr / empty if no rate limit is configured.
+  std::unique_ptr<TokenBucket> rate_limit_;
+  std::unordered_map<uint32_t, std::unique_ptr<TokenBucket>>
+      priority_rate_limits_;
+
+  // Interned input / output names and the model configuration for
+  // each tensor, indexed by the interned name index.
+  TensorNameTable input_names_;
+  TensorNameTable output_names_;
+  std::vector<ModelInput> inputs_;
+  std::vector<ModelOutput> outputs_;
+
+  // Compiled normalization plan for each input, indexed by the
+  // interned name index like 'inputs_', and response plan for each
+  // output, indexed like 'outputs_'.
+  std::vector<InputPlan> input_plans_;
+  std::vector<OutputPlan> output_plans_;
+
+  // The maximum batch size from the model configuration, kept flat so
+  // the request and response paths don't read the protobuf.
+  int max_batch_size_ = 0;
 
   // Path to model
   std::string model_dir_;
 
+  // The number of requests in flight for the model and the total byte
+  // size of their input tensors. Used to enforce the admission-control
+  // limits from the model configuration.
+  std::atomic<uint64_t> inflight_request_count_{0};
+  std::atomic<uint64_t> inflight_byte_size_{0};
+
+  // The memory consumed by the model's in-flight requests, charged by
+  // the allocation paths while a request for the model is being
+  // served. Used to enforce the memory budgets from the model
+  // configuration. Owned by MemoryUsageTracker.
+  MemoryUsage* memory_usage_ = nullptr;
+
   // The default priority level for the backend.
   uint32_t default_priority_level_;
 
@@ -26,19 +26,241 @@
 
 #include "src/core/backend_context.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include "src/core/cuda_utils.h"
 #include "src/core/logging.h"
 #include "src/core/nvtx.h"
+#include "src/core/pinned_memory_manager.h"
+#include "src/core/probes.h"
 #include "src/core/provider.h"
 
+#ifdef __F16C__
+#include <immintrin.h>
+#endif  // __F16C__
+
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// Fill the batch-input values for all payloads. The value type is a
+// template parameter so the datatype is dispatched once per tensor
+// and the per-payload loop stays branch-free on it.
+template <typename T>
+Status
+FillBatchInputBuffer(
+    const ModelBatchInput& batch_input, const std::string& source_name,
+    std::vector<Scheduler::Payload>* payloads, char* buffer)
+{
+  T* values = reinterpret_cast<T*>(buffer);
+  if (batch_input.kind() ==
+      ModelBatchInput::BATCH_ACCUMULATED_ELEMENT_COUNT_WITH_ZERO) {
+    *values++ = 0;
+  }
+
+  const bool accumulate =
+      (batch_input.kind() != ModelBatchInput::BATCH_ELEMENT_COUNT);
+  int64_t accumulated_count = 0;
+  for (auto& payload : *payloads) {
+    const InferenceRequest::Input* rinput;
+    RETURN_IF_ERROR(payload.request_->ImmutableInput(source_name, &rinput));
+
+    int64_t element_count = GetElementCount(rinput->Shape());
+    if (payload.request_->BatchSize() != 0) {
+      element_count *= payload.request_->BatchSize();
+    }
+
+    if (accumulate) {
+      accumulated_count += element_count;
+      *values++ = accumulated_count;
+    } else {
+      *values++ = element_count;
+    }
+  }
+
+  return Status::Success;
+}
+
+uint16_t
+Fp32ToFp16Scalar(const float value)
+{
+  uint32_t f;
+  memcpy(&f, &value, sizeof(f));
+  const uint16_t sign = (f >> 16) & 0x8000;
+  const uint32_t abs = f & 0x7fffffff;
+
+  if (abs >= 0x7f800000) {
+    // Inf / NaN. For a NaN keep the top 10 payload bits and set the
+    // quiet bit, which is what F16C hardware produces.
+    if (abs > 0x7f800000) {
+      return sign | 0x7c00 | 0x200 | (uint16_t)((abs & 0x7fffff) >> 13);
+    }
+    return sign | 0x7c00;
+  }
+  if (abs >= 0x47800000) {
+    // Magnitude too large for FP16, overflow to Inf.
+    return sign | 0x7c00;
+  }
+  if (abs < 0x38800000) {
+    // Subnormal in FP16. Shift the mantissa (with implicit bit) into
+    // place, rounding to nearest even.
+    const uint32_t shift = 126 - (abs >> 23);
+    if (shift > 25) {
+      return sign;
+    }
+    const uint32_t mant = (abs & 0x7fffff) | 0x800000;
+    uint32_t result = mant >> shift;
+    const uint32_t rem = mant & ((1u << shift) - 1);
+    const uint32_t half = 1u << (shift - 1);
+    if ((rem > half) || ((rem == half) && ((result & 1) != 0))) {
+      result++;
+    }
+    return sign | (uint16_t)result;
+  }
+
+  // Normal value. Rebias the exponent and round the 13 dropped
+  // mantissa bits to nearest even. Rounding may carry into the
+  // exponent, which gives the correct result.
+  const uint32_t mant = abs & 0x7fffff;
+  uint32_t result = ((((abs >> 23) - 112) << 10) | (mant >> 13));
+  const uint32_t rem = mant & 0x1fff;
+  if ((rem > 0x1000) || ((rem == 0x1000) && ((result & 1) != 0))) {
+    result++;
+  }
+  return sign | (uint16_t)result;
+}
+
+float
+Fp16ToFp32Scalar(const uint16_t value)
+{
+  const uint32_t sign = ((uint32_t)(value & 0x8000)) << 16;
+  const uint32_t exp = (value >> 10) & 0x1f;
+  uint32_t mant = value & 0x3ff;
+
+  uint32_t f;
+  if (exp == 0x1f) {
+    // Inf / NaN. A NaN is quietized like F16C hardware does:
+    // shifting a signaling FP16 NaN's payload into place without
+    // setting the quiet bit would emit a signaling FP32 NaN, which
+    // hardware never produces.
+    f = sign | 0x7f800000 | (mant << 13) | ((mant != 0) ? 0x400000 : 0);
+  } else if (exp != 0) {
+    f = sign | ((exp + 112) << 23) | (mant << 13);
+  } else if (mant == 0) {
+    f = sign;
+  } else {
+    // Subnormal in FP16, normalize for FP32.
+    uint32_t e = 112;
+    do {
+      mant <<= 1;
+      e--;
+    } while ((mant & 0x400) == 0);
+    f = sign | ((e + 1) << 23) | ((mant & 0x3ff) << 13);
+  }
+
+  float result;
+  memcpy(&result, &f, sizeof(result));
+  return result;
+}
+
+// Convert 'cnt' FP32 values in 'src' to FP16 values in 'dst'. Uses
+// F16C instructions when the compiler targets them, otherwise falls
+// back to scalar conversion. Neither pointer needs to be aligned.
+void
+ConvertFp32ToFp16(uint16_t* dst, const float* src, const size_t cnt)
+{
+  size_t i = 0;
+#ifdef __F16C__
+  for (; (i + 8) <= cnt; i += 8) {
+    _mm_storeu_si128(
+        (__m128i*)(dst + i),
+        _mm256_cvtps_ph(
+            _mm256_loadu_ps(src + i),
+            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+#endif  // __F16C__
+  for (; i < cnt; i++) {
+    float value;
+    memcpy(&value, src + i, sizeof(value));
+    dst[i] = Fp32ToFp16Scalar(value);
+  }
+}
+
+// Convert 'cnt' FP16 values in 'src' to FP32 values in 'dst'. See
+// ConvertFp32ToFp16.
+void
+ConvertFp16ToFp32(float* dst, const uint16_t* src, const size_t cnt)
+{
+  size_t i = 0;
+#ifdef __F16C__
+  for (; (i + 8) <= cnt; i += 8) {
+    _mm256_storeu_ps(
+        dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+  }
+#endif  // __F16C__
+  for (; i < cnt; i++) {
+    uint16_t value;
+    memcpy(&value, src + i, sizeof(value));
+    const float result = Fp16ToFp32Scalar(value);
+    memcpy(dst + i, &result, sizeof(result));
+  }
+}
+
+}  // namespace
+
+Status
+ParseSerializedStringTensor(
+    const std::string& name, const char* content,
+    const size_t content_byte_size, const size_t expected_element_cnt,
+    std::vector<StringTensorElement>* elements)
+{
+  elements->clear();
+  elements->reserve(expected_element_cnt);
+
+  // The length prefixes form a serial dependency chain, so the parse
+  // is a single tight pass that only records each element's offset
+  // and length. One comparison bounds-checks both the prefix and the
+  // string data, and the error strings are constructed only on the
+  // failure paths.
+  size_t offset = 0;
+  while ((content_byte_size - offset) >= sizeof(uint32_t)) {
+    if (elements->size() >= expected_element_cnt) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "unexpected number of string elements " +
+              std::to_string(expected_element_cnt + 1) +
+              " for inference input '" + name + "', expecting " +
+              std::to_string(expected_element_cnt));
+    }
+
+    uint32_t len;
+    memcpy(&len, content + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+
+    if (len > (content_byte_size - offset)) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "incomplete string data for inference input '" + name +
+              "', expecting string of length " + std::to_string(len) +
+              " but only " + std::to_string(content_byte_size - offset) +
+              " bytes available");
+    }
+
+    elements->emplace_back(content + offset, len);
+    offset += len;
+  }
+
+  return Status::Success;
+}
+
 BackendContext::BackendContext(
     const std::string& name, const int gpu_device, const int max_batch_size,
     const bool enable_pinned_input, const bool enable_pinned_output)
     : name_(name), gpu_device_(gpu_device), max_batch_size_(max_batch_size),
       enable_pinned_input_(enable_pinned_input),
-      enable_pinned_output_(enable_pinned_output)
+      enable_pinned_output_(enable_pinned_output),
+      pinned_copy_max_chunk_byte_size_(SIZE_MAX), pinned_copy_tuned_(false)
 {
 #ifdef TRTIS_ENABLE_GPU
   stream_ = nullptr;
@@ -111,12 +333,31 @@ BackendContext::SetInputBuffer(
     std::vector<Scheduler::Payload>* payloads, cudaStream_t stream,
     InputInfo* input)
 {
+  NVTX_RANGE(nvtx_, "SetInputBuffer " + name);
+  TRTIS_PROBE1(input_copy_start, name.c_str());
+
+#ifdef TRTIS_ENABLE_NVTX
+  // One marker per gathered request so a capture can connect the
+  // input copies back to the requests' ids.
+  for (const auto& payload : *payloads) {
+    NVTX_MARKER_ID("GatherInput " + name, payload.request_->UniqueId());
+  }
+#endif  // TRTIS_ENABLE_NVTX
+
   bool cuda_copy = false;
 
   bool need_buffer;
   TRTSERVER_Memory_Type candidate_type;
   GetIndirectBufferRequirement(
       input->memory_type_, true, &candidate_type, &need_buffer);
+
+  // Measure the staged-vs-direct copy tradeoff for this context the
+  // first time staging is considered, typically during model warmup.
+  if (need_buffer && (input->memory_type_ == TRTSERVER_MEMORY_GPU) &&
+      !pinned_copy_tuned_) {
+    TunePinnedCopyThreshold();
+  }
+
   BufferInfo pinned_buffer_info{0, 0, {}};
 
   // Visit the payloads in order and copy the input tensors to
@@ -160,8 +401,12 @@ BackendContext::SetInputBuffer(
 
         if (content_byte_size > 0) {
           // Defer memory copy for the buffer if it's better put into an
-          // intermediate pinned buffer first.
-          if (need_buffer && (src_memory_type == candidate_type)) {
+          // intermediate pinned buffer first. Chunks above the measured
+          // threshold reach full bandwidth on their own and skip the
+          // extra staging copy.
+          if (need_buffer && (src_memory_type == candidate_type) &&
+              ((input->memory_type_ != TRTSERVER_MEMORY_GPU) ||
+               (content_byte_size <= pinned_copy_max_chunk_byte_size_))) {
             std::get<1>(pinned_buffer_info) += content_byte_size;
             std::get<2>(pinned_buffer_info)
                 .emplace_back(idx, data.get(), data_idx);
@@ -224,6 +469,180 @@ BackendContext::SetInputBuffer(
         name, pinned_buffer_info, payloads, stream, input);
   }
 
+  TRTIS_PROBE1(input_copy_end, name.c_str());
+  return cuda_copy;
+}
+
+bool
+BackendContext::SetInputBufferFP32ToFP16(
+    const std::string& name, const std::vector<size_t>& expected_byte_sizes,
+    std::vector<Scheduler::Payload>* payloads, InputInfo* input)
+{
+  bool cuda_copy = false;
+
+  size_t total_byte_size = 0;
+  for (const size_t byte_size : expected_byte_sizes) {
+    total_byte_size += byte_size;
+  }
+
+  // The conversion runs on the CPU, so when the input buffer is on the
+  // GPU the converted values are gathered into a pinned staging buffer
+  // that is recorded as an indirect buffer. The caller's existing
+  // indirect-buffer flush then transfers it in a single copy.
+  char* conversion_buffer = input->input_buffer_;
+  std::unique_ptr<AllocatedMemory> staging_buffer;
+  if (input->memory_type_ == TRTSERVER_MEMORY_GPU) {
+    auto staging_memory_type = TRTSERVER_MEMORY_CPU_PINNED;
+    int64_t staging_memory_type_id = 0;
+    staging_buffer.reset(new AllocatedMemory(
+        total_byte_size / 2, staging_memory_type, staging_memory_type_id));
+    conversion_buffer = staging_buffer->MutableBuffer(
+        &staging_memory_type, &staging_memory_type_id);
+    if (conversion_buffer == nullptr) {
+      const Status status = Status(
+          Status::Code::INTERNAL,
+          "failed to allocate conversion buffer for input '" + name + "'");
+      for (auto& payload : *payloads) {
+        if (payload.status_.IsOk()) {
+          payload.status_ = status;
+        }
+      }
+      return cuda_copy;
+    }
+  }
+
+  // Visit the payloads in order and convert the FP32 input tensors
+  // into 'conversion_buffer' as FP16, fused into the gather so the
+  // data is only passed over once.
+  size_t buffer_copy_offset = 0;
+  for (size_t idx = 0; idx < expected_byte_sizes.size(); idx++) {
+    auto& payload = (*payloads)[idx];
+    const size_t expected_byte_size = expected_byte_sizes[idx];
+
+    const InferenceRequest::Input* rinput;
+    Status status = payload.request_->ImmutableInput(name, &rinput);
+    if (!status.IsOk()) {
+      payload.status_ = status;
+    } else if ((expected_byte_size % sizeof(float)) != 0) {
+      payload.status_ = Status(
+          Status::Code::INVALID_ARG,
+          "unexpected size " + std::to_string(expected_byte_size) +
+              " for FP32 inference input '" + name +
+              "', expecting a multiple of " + std::to_string(sizeof(float)));
+    } else {
+      const std::shared_ptr<Memory>& data = rinput->Data();
+
+      // An element may straddle a chunk boundary, so a partial element
+      // is carried over to the next chunk.
+      char carry[sizeof(float)];
+      size_t carry_byte_cnt = 0;
+
+      size_t dst_byte_offset = buffer_copy_offset / 2;
+      size_t copied_byte_size = 0;
+      size_t data_idx = 0;
+      while (payload.status_.IsOk()) {
+        auto src_memory_type = TRTSERVER_MEMORY_CPU;
+        int64_t src_memory_type_id = 0;
+        size_t content_byte_size = expected_byte_size - copied_byte_size;
+        const void* content = data->BufferAt(
+            data_idx, &content_byte_size, &src_memory_type,
+            &src_memory_type_id);
+
+        // No more input content available then done with converting...
+        if (content == nullptr) {
+          break;
+        }
+
+        if ((copied_byte_size + content_byte_size) > expected_byte_size) {
+          payload.status_ = Status(
+              Status::Code::INVALID_ARG,
+              "unexpected size " +
+                  std::to_string(copied_byte_size + content_byte_size) +
+                  " for inference input '" + name + "', expecting " +
+                  std::to_string(expected_byte_size));
+          break;
+        }
+
+        if (content_byte_size > 0) {
+          // GPU-resident chunks must be brought to the CPU before they
+          // can be converted.
+          std::unique_ptr<char[]> host_chunk;
+          if (src_memory_type == TRTSERVER_MEMORY_GPU) {
+            host_chunk.reset(new char[content_byte_size]);
+            bool cuda_used = false;
+            payload.status_ = CopyBuffer(
+                name, src_memory_type, src_memory_type_id,
+                TRTSERVER_MEMORY_CPU, 0, content_byte_size, content,
+                host_chunk.get(), stream_, &cuda_used);
+            if (!payload.status_.IsOk()) {
+              break;
+            }
+#ifdef TRTIS_ENABLE_GPU
+            if (cuda_used) {
+              cudaStreamSynchronize(stream_);
+            }
+#endif  // TRTIS_ENABLE_GPU
+            content = host_chunk.get();
+          }
+
+          const char* src = reinterpret_cast<const char*>(content);
+          size_t remaining_byte_size = content_byte_size;
+
+          if (carry_byte_cnt > 0) {
+            const size_t take = std::min(
+                sizeof(carry) - carry_byte_cnt, remaining_byte_size);
+            memcpy(carry + carry_byte_cnt, src, take);
+            carry_byte_cnt += take;
+            src += take;
+            remaining_byte_size -= take;
+            if (carry_byte_cnt == sizeof(carry)) {
+              ConvertFp32ToFp16(
+                  reinterpret_cast<uint16_t*>(
+                      conversion_buffer + dst_byte_offset),
+                  reinterpret_cast<const float*>(carry), 1);
+              dst_byte_offset += sizeof(uint16_t);
+              carry_byte_cnt = 0;
+            }
+          }
+
+          const size_t element_cnt = remaining_byte_size / sizeof(float);
+          ConvertFp32ToFp16(
+              reinterpret_cast<uint16_t*>(conversion_buffer + dst_byte_offset),
+              reinterpret_cast<const float*>(src), element_cnt);
+          dst_byte_offset += element_cnt * sizeof(uint16_t);
+
+          const size_t tail_byte_cnt = remaining_byte_size % sizeof(float);
+          if (tail_byte_cnt > 0) {
+            memcpy(carry, src + (element_cnt * sizeof(float)), tail_byte_cnt);
+            carry_byte_cnt = tail_byte_cnt;
+          }
+        }
+
+        copied_byte_size += content_byte_size;
+        data_idx++;
+      }
+
+      if (payload.status_.IsOk() && (copied_byte_size != expected_byte_size)) {
+        payload.status_ = Status(
+            Status::Code::INTERNAL,
+            "expected " + std::to_string(expected_byte_size) +
+                " bytes of data for inference input '" + name + "', got " +
+                std::to_string(copied_byte_size));
+      }
+    }
+
+    buffer_copy_offset += expected_byte_size;
+  }
+
+  if (staging_buffer != nullptr) {
+    std::vector<size_t> payload_idxs(payloads->size());
+    for (size_t idx = 0; idx < payload_idxs.size(); idx++) {
+      payload_idxs[idx] = idx;
+    }
+    input->indirect_buffers_.emplace_back(
+        std::move(staging_buffer), 0, std::move(payload_idxs));
+  }
+
   return cuda_copy;
 }
 
@@ -248,6 +667,109 @@ BackendContext::GetIndirectBufferRequirement(
   return;
 }
 
+void
+BackendContext::TunePinnedCopyThreshold()
+{
+  // Measure only once even if the measurement can't run.
+  pinned_copy_tuned_ = true;
+
+#ifdef TRTIS_ENABLE_GPU
+  if ((gpu_device_ == NO_GPU_DEVICE) || (stream_ == nullptr)) {
+    return;
+  }
+
+  constexpr size_t chunk_byte_sizes[] = {1 << 12, 1 << 16, 1 << 20, 1 << 23};
+  constexpr size_t max_chunk_byte_size = 1 << 23;
+  constexpr int iteration_cnt = 8;
+
+  int current_device;
+  if (cudaGetDevice(&current_device) != cudaSuccess) {
+    return;
+  }
+  const bool overridden = (current_device != gpu_device_);
+  if (overridden && (cudaSetDevice(gpu_device_) != cudaSuccess)) {
+    return;
+  }
+
+  void* device_buffer = nullptr;
+  void* pinned_buffer = nullptr;
+  TRTSERVER_Memory_Type pinned_memory_type;
+  std::vector<char> pageable_buffer(max_chunk_byte_size, 0);
+  auto cuerr = cudaMalloc(&device_buffer, max_chunk_byte_size);
+  auto status = (cuerr == cudaSuccess)
+                    ? PinnedMemoryManager::Alloc(
+                          &pinned_buffer, max_chunk_byte_size,
+                          &pinned_memory_type)
+                    : Status(
+                          Status::Code::INTERNAL,
+                          "unable to allocate measurement buffer");
+  if (status.IsOk()) {
+    size_t staged_winner_byte_size = 0;
+    for (const size_t chunk_byte_size : chunk_byte_sizes) {
+      // Warm both paths so initialization cost isn't measured.
+      cudaMemcpyAsync(
+          device_buffer, pageable_buffer.data(), chunk_byte_size,
+          cudaMemcpyHostToDevice, stream_);
+      cudaMemcpyAsync(
+          device_buffer, pinned_buffer, chunk_byte_size,
+          cudaMemcpyHostToDevice, stream_);
+      cudaStreamSynchronize(stream_);
+
+      auto start = std::chrono::steady_clock::now();
+      for (int iter = 0; iter < iteration_cnt; iter++) {
+        cudaMemcpyAsync(
+            device_buffer, pageable_buffer.data(), chunk_byte_size,
+            cudaMemcpyHostToDevice, stream_);
+      }
+      cudaStreamSynchronize(stream_);
+      const auto direct_duration =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start);
+
+      start = std::chrono::steady_clock::now();
+      for (int iter = 0; iter < iteration_cnt; iter++) {
+        memcpy(pinned_buffer, pageable_buffer.data(), chunk_byte_size);
+        cudaMemcpyAsync(
+            device_buffer, pinned_buffer, chunk_byte_size,
+            cudaMemcpyHostToDevice, stream_);
+      }
+      cudaStreamSynchronize(stream_);
+      const auto staged_duration =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start);
+
+      LOG_VERBOSE(1) << name_ << " pinned-copy measurement, chunk size "
+                     << chunk_byte_size << ": direct "
+                     << direct_duration.count() << "ns, staged "
+                     << staged_duration.count() << "ns";
+
+      if (staged_duration > direct_duration) {
+        // Stage chunks only up to the largest size where staging won.
+        pinned_copy_max_chunk_byte_size_ = staged_winner_byte_size;
+        break;
+      }
+      staged_winner_byte_size = chunk_byte_size;
+    }
+  } else {
+    LOG_VERBOSE(1) << "unable to measure pinned-copy threshold for " << name_
+                   << ": " << status.Message();
+  }
+
+  if (pinned_buffer != nullptr) {
+    PinnedMemoryManager::Free(pinned_buffer);
+  }
+  if (device_buffer != nullptr) {
+    cudaFree(device_buffer);
+  }
+  if (overridden) {
+    cudaSetDevice(current_device);
+  }
+
+  LOG_VERBOSE(1) << name_ << " staging input chunks up to "
+                 << pinned_copy_max_chunk_byte_size_ << " bytes";
+#endif  // TRTIS_ENABLE_GPU
+}
+
 bool
 BackendContext::IssueIndirectInputBufferCopy(
     const std::string& name,
@@ -281,17 +803,47 @@ BackendContext::IssueIndirectInputBufferCopy(
   auto src_mem_type_id = input->memory_type_id_;
   size_t src_byte_size;
   size_t buffer_offset = 0;
+
+  // Gather the chunk copies and issue them as one batched call per
+  // (memory type, memory type id) group so a batch assembled from many
+  // small request chunks doesn't pay per-chunk copy-launch overhead.
+  std::vector<CopyParams> copy_params;
+  std::vector<size_t> group_payload_idxs;
+  auto group_mem_type = src_mem_type;
+  auto group_mem_type_id = src_mem_type_id;
+  auto flush_group = [&]() {
+    if (!copy_params.empty()) {
+      auto status = CopyBuffers(
+          name, group_mem_type, group_mem_type_id, mem_type, mem_id,
+          copy_params, stream, &cuda_used);
+      cuda_copy |= cuda_used;
+      if (!status.IsOk()) {
+        for (const auto pidx : group_payload_idxs) {
+          (*payloads)[pidx].status_ = status;
+        }
+      }
+      copy_params.clear();
+      group_payload_idxs.clear();
+    }
+  };
+
   for (const auto& data_info : std::get<2>(pinned_buffer_info)) {
     payload_idxs.emplace_back(std::get<0>(data_info));
     const void* src_data = std::get<1>(data_info)->BufferAt(
         std::get<2>(data_info), &src_byte_size, &src_mem_type,
         &src_mem_type_id);
-    (*payloads)[payload_idxs.back()].status_ = CopyBuffer(
-        name, src_mem_type, src_mem_type_id, mem_type, mem_id, src_byte_size,
-        src_data, buffer + buffer_offset, stream, &cuda_used);
+    if ((src_mem_type != group_mem_type) ||
+        (src_mem_type_id != group_mem_type_id)) {
+      flush_group();
+      group_mem_type = src_mem_type;
+      group_mem_type_id = src_mem_type_id;
+    }
+    copy_params.emplace_back(
+        buffer + buffer_offset, src_data, src_byte_size);
+    group_payload_idxs.emplace_back(payload_idxs.back());
     buffer_offset += src_byte_size;
-    cuda_copy |= cuda_used;
   }
+  flush_group();
 
   if (!direct_copy) {
     input->indirect_buffers_.emplace_back(
@@ -302,6 +854,55 @@ BackendContext::IssueIndirectInputBufferCopy(
   return cuda_copy;
 }
 
+Status
+BackendContext::SetBatchInputBuffer(
+    const ModelBatchInput& batch_input,
+    std::vector<Scheduler::Payload>* payloads, char* buffer,
+    const size_t buffer_byte_size)
+{
+  if (batch_input.source_input_size() == 0) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "batch input must specify a 'source_input'");
+  }
+
+  const std::string& source_name = batch_input.source_input(0);
+
+  size_t value_cnt = payloads->size();
+  if (batch_input.kind() ==
+      ModelBatchInput::BATCH_ACCUMULATED_ELEMENT_COUNT_WITH_ZERO) {
+    value_cnt++;
+  }
+
+  switch (batch_input.kind()) {
+    case ModelBatchInput::BATCH_ELEMENT_COUNT:
+    case ModelBatchInput::BATCH_ACCUMULATED_ELEMENT_COUNT:
+    case ModelBatchInput::BATCH_ACCUMULATED_ELEMENT_COUNT_WITH_ZERO:
+      break;
+    default:
+      return Status(
+          Status::Code::INVALID_ARG,
+          "unexpected batch input kind '" +
+              ModelBatchInput_Kind_Name(batch_input.kind()) + "'");
+  }
+
+  const size_t value_byte_size = GetDataTypeByteSize(batch_input.data_type());
+  if ((value_cnt * value_byte_size) > buffer_byte_size) {
+    return Status(
+        Status::Code::INTERNAL,
+        "expected batch input buffer of at least " +
+            std::to_string(value_cnt * value_byte_size) + " bytes, got " +
+            std::to_string(buffer_byte_size));
+  }
+
+  if (batch_input.data_type() == TYPE_FP32) {
+    return FillBatchInputBuffer<float>(
+        batch_input, source_name, payloads, buffer);
+  }
+  return FillBatchInputBuffer<int32_t>(
+      batch_input, source_name, payloads, buffer);
+}
+
 bool
 BackendContext::SetShapeInputBuffer(
     const std::string& name, const int32_t total_batch_size,
@@ -376,6 +977,18 @@ BackendContext::SetFixedSizeOutputBuffer(
     const std::string& name, const size_t batch1_byte_size, OutputInfo* output,
     std::vector<Scheduler::Payload>* payloads)
 {
+  return SetFixedSizeOutputBuffer(
+      name, batch1_byte_size, output, payloads, stream_);
+}
+
+bool
+BackendContext::SetFixedSizeOutputBuffer(
+    const std::string& name, const size_t batch1_byte_size, OutputInfo* output,
+    std::vector<Scheduler::Payload>* payloads, cudaStream_t stream)
+{
+  NVTX_RANGE(nvtx_, "SetFixedSizeOutputBuffer " + name);
+  TRTIS_PROBE1(output_copy_start, name.c_str());
+
   bool cuda_copy = false;
   size_t output_offset = 0;
   bool need_buffer;
@@ -427,13 +1040,13 @@ BackendContext::SetFixedSizeOutputBuffer(
             status = CopyBuffer(
                 name, output->memory_type_, output->memory_type_id_,
                 dst_memory_type, dst_memory_type_id, expected_byte_size,
-                output->output_buffer_ + output_offset, buffer, stream_,
+                output->output_buffer_ + output_offset, buffer, stream,
                 &cuda_used);
             cuda_copy |= cuda_used;
 
             if (std::get<1>(pinned_buffer_info) > 0) {
               cuda_copy |= IssueIndirectOutputBufferCopy(
-                  name, pinned_buffer_info, payloads, stream_, output);
+                  name, pinned_buffer_info, payloads, stream, output);
             }
             // reset 'pinned_buffer_info'
             pinned_buffer_info =
@@ -455,7 +1068,7 @@ BackendContext::SetFixedSizeOutputBuffer(
     if (!process_payload) {
       if (std::get<1>(pinned_buffer_info) > 0) {
         cuda_copy |= IssueIndirectOutputBufferCopy(
-            name, pinned_buffer_info, payloads, stream_, output);
+            name, pinned_buffer_info, payloads, stream, output);
       }
       // reset 'pinned_buffer_info'
       pinned_buffer_info =
@@ -468,7 +1081,7 @@ BackendContext::SetFixedSizeOutputBuffer(
   // Issue pending indirect copy if any
   if (std::get<1>(pinned_buffer_info) > 0) {
     cuda_copy |= IssueIndirectOutputBufferCopy(
-        name, pinned_buffer_info, payloads, stream_, output);
+        name, pinned_buffer_info, payloads, stream, output);
   }
 
   // The last element in 'indirect_buffers_' is always a placeholder for next
@@ -476,6 +1089,110 @@ BackendContext::SetFixedSizeOutputBuffer(
   // so we should always remove it to avoid accessing nullptr
   output->indirect_buffers_.pop_back();
 
+  TRTIS_PROBE1(output_copy_end, name.c_str());
+  return cuda_copy;
+}
+
+bool
+BackendContext::SetFixedSizeOutputBufferFP16ToFP32(
+    const std::string& name, const size_t batch1_byte_size, OutputInfo* output,
+    std::vector<Scheduler::Payload>* payloads)
+{
+  bool cuda_copy = false;
+
+  // The conversion runs on the CPU, so a GPU-resident output is first
+  // staged to the CPU in a single transfer.
+  const char* conversion_buffer = output->output_buffer_;
+  std::unique_ptr<char[]> staging_buffer;
+  if (output->memory_type_ == TRTSERVER_MEMORY_GPU) {
+    size_t total_byte_size = 0;
+    for (auto& payload : *payloads) {
+      total_byte_size +=
+          (payload.request_->BatchSize() * batch1_byte_size) / 2;
+    }
+    staging_buffer.reset(new char[total_byte_size]);
+    bool cuda_used = false;
+    const Status status = CopyBuffer(
+        name, output->memory_type_, output->memory_type_id_,
+        TRTSERVER_MEMORY_CPU, 0, total_byte_size, output->output_buffer_,
+        staging_buffer.get(), stream_, &cuda_used);
+    if (!status.IsOk()) {
+      for (auto& payload : *payloads) {
+        if (payload.status_.IsOk()) {
+          payload.status_ = status;
+        }
+      }
+      return cuda_copy;
+    }
+#ifdef TRTIS_ENABLE_GPU
+    if (cuda_used) {
+      cudaStreamSynchronize(stream_);
+    }
+#endif  // TRTIS_ENABLE_GPU
+    conversion_buffer = staging_buffer.get();
+  }
+
+  size_t output_offset = 0;
+  for (auto& payload : *payloads) {
+    const auto& irequest = payload.request_;
+    const size_t expected_byte_size = irequest->BatchSize() * batch1_byte_size;
+    const size_t element_cnt = expected_byte_size / sizeof(float);
+
+    // If 'payload' should have valid output (status ok) and if
+    // 'payload' requested this output then convert it from
+    // 'conversion_buffer'. If it did not request this output then just
+    // skip it in the 'conversion_buffer'.
+    if (payload.status_.IsOk() && (payload.response_provider_ != nullptr) &&
+        payload.response_provider_->RequiresOutput(name)) {
+      TRTSERVER_Memory_Type dst_memory_type;
+      int64_t dst_memory_type_id;
+      void* buffer = nullptr;
+
+      // Prefer a CPU buffer so the conversion can write the response
+      // directly, fused with the scatter to the payloads.
+      Status status = payload.response_provider_->AllocateOutputBuffer(
+          name, &buffer, expected_byte_size, output->output_shape_,
+          TRTSERVER_MEMORY_CPU, 0, &dst_memory_type, &dst_memory_type_id);
+      if (status.IsOk() && (expected_byte_size != 0)) {
+        if (buffer == nullptr) {
+          status = Status(
+              Status::Code::INTERNAL,
+              "failed to allocate buffer for output '" + name + "'");
+        } else if (dst_memory_type != TRTSERVER_MEMORY_GPU) {
+          ConvertFp16ToFp32(
+              reinterpret_cast<float*>(buffer),
+              reinterpret_cast<const uint16_t*>(
+                  conversion_buffer + output_offset),
+              element_cnt);
+        } else {
+          // Convert into a temporary buffer and copy that to the
+          // GPU-resident response buffer. The temporary buffer is
+          // released on return so wait for the copy to complete.
+          std::unique_ptr<char[]> converted(new char[expected_byte_size]);
+          ConvertFp16ToFp32(
+              reinterpret_cast<float*>(converted.get()),
+              reinterpret_cast<const uint16_t*>(
+                  conversion_buffer + output_offset),
+              element_cnt);
+          bool cuda_used = false;
+          status = CopyBuffer(
+              name, TRTSERVER_MEMORY_CPU, 0, dst_memory_type,
+              dst_memory_type_id, expected_byte_size, converted.get(), buffer,
+              stream_, &cuda_used);
+#ifdef TRTIS_ENABLE_GPU
+          if (cuda_used) {
+            cudaStreamSynchronize(stream_);
+          }
+#endif  // TRTIS_ENABLE_GPU
+        }
+      }
+
+      payload.status_ = status;
+    }
+
+    output_offset += expected_byte_size / 2;
+  }
+
   return cuda_copy;
 }
 
@@ -535,6 +1252,18 @@ BackendContext::SetOutputShapeTensorBuffer(
     std::vector<int64_t>& content_shape, const bool support_batching,
     TRTSERVER_Memory_Type src_memory_type, int64_t src_memory_type_id,
     std::vector<Scheduler::Payload>* payloads)
+{
+  return SetOutputShapeTensorBuffer(
+      name, content, content_shape, support_batching, src_memory_type,
+      src_memory_type_id, payloads, stream_);
+}
+
+bool
+BackendContext::SetOutputShapeTensorBuffer(
+    const std::string& name, const int32_t* content,
+    std::vector<int64_t>& content_shape, const bool support_batching,
+    TRTSERVER_Memory_Type src_memory_type, int64_t src_memory_type_id,
+    std::vector<Scheduler::Payload>* payloads, cudaStream_t stream)
 {
   if (content_shape.empty()) {
     return false;
@@ -581,7 +1310,7 @@ BackendContext::SetOutputShapeTensorBuffer(
                 name, src_memory_type, src_memory_type_id, dst_memory_type,
                 dst_memory_type_id, nb_shape_values * sizeof(int32_t),
                 (void*)(content + content_offset),
-                (void*)(buffer + buffer_offset), stream_, &cuda_used);
+                (void*)(buffer + buffer_offset), stream, &cuda_used);
             cuda_copy |= cuda_used;
             buffer_offset += nb_shape_values * sizeof(int32_t);
           }
@@ -607,6 +1336,22 @@ BackendContext::GetContiguousInputContent(
   const InferenceRequest::Input* rinput;
   RETURN_IF_ERROR(payload.request_->ImmutableInput(name, &rinput));
 
+  // If another context already gathered this input into a contiguous
+  // buffer of the requested memory type, reuse that copy. The cached
+  // copy is kept alive by the input's Memory object, which outlives
+  // the payload, so 'contiguous_buffer' need not hold it.
+  const TRTSERVER_Memory_Type req_memory_type = memory_type;
+  const int64_t req_memory_type_id = memory_type_id;
+  {
+    std::shared_ptr<Memory> cached =
+        rinput->Data()->ContiguousCopy(req_memory_type, req_memory_type_id);
+    if (cached != nullptr) {
+      *content =
+          cached->BufferAt(0, content_byte_size, &memory_type, &memory_type_id);
+      return Status::Success;
+    }
+  }
+
   // Peek input buffers to check if data copy is necessary
   MemoryReference input_buffers;
   size_t chunk_count = 0;
@@ -647,6 +1392,7 @@ BackendContext::GetContiguousInputContent(
           Status::Code::INTERNAL, "failed to allocate contiguous buffer");
     }
 
+    bool gather_cuda_copy = false;
     size_t offset = 0;
     for (size_t i = 0; i < chunk_count; i++) {
       bool cuda_used;
@@ -658,12 +1404,24 @@ BackendContext::GetContiguousInputContent(
           name, src_memory_type, src_memory_type_id, memory_type,
           memory_type_id, *content_byte_size, src_ptr, dst_ptr + offset,
           stream_, &cuda_used));
-      *cuda_copy |= cuda_used;
+      gather_cuda_copy |= cuda_used;
       offset += *content_byte_size;
     }
+    *cuda_copy |= gather_cuda_copy;
 
     *content = dst_ptr;
     *content_byte_size = (*contiguous_buffer)->TotalByteSize();
+
+    // Cache the gathered copy on the input memory so other contexts
+    // consuming the same input don't repeat the gather. A copy issued
+    // asynchronously on this context's stream can't be safely shared
+    // with contexts operating on other streams, so only a completed
+    // (non-CUDA) gather is cached.
+    if (!gather_cuda_copy) {
+      std::shared_ptr<Memory> flattened(contiguous_buffer->release());
+      rinput->Data()->SetContiguousCopy(
+          req_memory_type, req_memory_type_id, flattened);
+    }
   }
 
   return Status::Success;
@@ -27,6 +27,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include "src/core/model_config.h"
 #include "src/core/provider.h"
@@ -56,6 +57,15 @@ struct OutputInfo {
   std::vector<int64_t> output_shape_;
   TRTSERVER_Memory_Type memory_type_;
   int64_t memory_type_id_;
+
+  // Name of the output. Set by backends that report per-output
+  // readiness so the completion path can identify the output.
+  std::string name_;
+
+  // Opaque event (cudaEvent_t on GPU builds) recorded after the copy
+  // of this output into its response buffer, or nullptr if the output
+  // is not reported incrementally. Owned by the backend context.
+  void* ready_event_ = nullptr;
   // indirect pinned memory buffers, the memory references appointing to
   // the destinations in payloads and the payload's index
   std::vector<std::pair<
@@ -64,6 +74,23 @@ struct OutputInfo {
       indirect_buffers_;
 };
 
+// An element of a serialized string tensor: the pointer to the start
+// of the string data and the length of the string.
+using StringTensorElement = std::pair<const char*, uint32_t>;
+
+// Parse the serialized string tensor in 'content' where each element
+// is a 4-byte length followed by that many bytes of string data with
+// no terminator. A single pass computes the offset and length of
+// every element into 'elements' so that the caller can assign the
+// strings in bulk instead of interleaving parsing with per-element
+// processing. On a malformed element the returned status describes
+// the error and 'elements' holds the elements parsed before it.
+// 'name' is the input name, used only in error messages.
+Status ParseSerializedStringTensor(
+    const std::string& name, const char* content,
+    const size_t content_byte_size, const size_t expected_element_cnt,
+    std::vector<StringTensorElement>* elements);
+
 struct BackendContext {
  public:
 #ifndef TRTIS_ENABLE_GPU
@@ -125,6 +152,19 @@ struct BackendContext {
       std::vector<Scheduler::Payload>* payloads, cudaStream_t stream,
       InputInfo* input);
 
+  // Variant of SetInputBuffer() for FP16-native models served FP32
+  // inputs. The FP32 data from the payloads is converted to FP16 in
+  // the same pass that gathers it into 'input_buffer', using F16C
+  // instructions when available. 'expected_byte_sizes' gives the FP32
+  // byte size contributed by each payload; 'input_buffer' must be a
+  // continuous block that can hold half the sum of those sizes.
+  // Return true if cudaMemcpyAsync is called, and the caller should
+  // call cudaStreamSynchronize before using the data. Otherwise,
+  // return false.
+  bool SetInputBufferFP32ToFP16(
+      const std::string& name, const std::vector<size_t>& expected_byte_sizes,
+      std::vector<Scheduler::Payload>* payloads, InputInfo* input);
+
   // Helper function to populate the shape value of specified shape input
   // that corresponds with the batch size. The first shape value is asssumed
   // to be the batch size. Its the user's responsibility to ensure it is called
@@ -137,6 +177,16 @@ struct BackendContext {
       Scheduler::Payload* payload, TRTSERVER_Memory_Type dst_memory_type,
       int64_t dst_memory_type_id, char* input_buffer);
 
+  // Helper function to fill 'buffer' with the value of a batch input
+  // generated from the requests in 'payloads', for example the
+  // per-request element counts of a ragged input. 'buffer' must be a
+  // CPU buffer large enough to hold one value per payload, plus one
+  // additional value for BATCH_ACCUMULATED_ELEMENT_COUNT_WITH_ZERO.
+  Status SetBatchInputBuffer(
+      const ModelBatchInput& batch_input,
+      std::vector<Scheduler::Payload>* payloads, char* buffer,
+      const size_t buffer_byte_size);
+
   // Helper function to set output buffer of fixed size data type to
   // payloads Return true if cudaMemcpyAsync is called, and the caller
   // should call cudaStreamSynchronize before using the data. Otherwise,
@@ -145,6 +195,25 @@ struct BackendContext {
       const std::string& name, const size_t batch1_byte_size,
       OutputInfo* output, std::vector<Scheduler::Payload>* payloads);
 
+  // Overload of SetFixedSizeOutputBuffer() which issues the CUDA
+  // copies on 'stream' instead of 'stream_'.
+  bool SetFixedSizeOutputBuffer(
+      const std::string& name, const size_t batch1_byte_size,
+      OutputInfo* output, std::vector<Scheduler::Payload>* payloads,
+      cudaStream_t stream);
+
+  // Variant of SetFixedSizeOutputBuffer() for FP16-native models that
+  // must report FP32 outputs. The FP16 data in 'output_buffer' is
+  // converted to FP32 in the same pass that scatters it to the
+  // payloads, using F16C instructions when available.
+  // 'batch1_byte_size' gives the FP32 byte size of a batch-1 output.
+  // Return true if cudaMemcpyAsync is called, and the caller should
+  // call cudaStreamSynchronize before using the data. Otherwise,
+  // return false.
+  bool SetFixedSizeOutputBufferFP16ToFP32(
+      const std::string& name, const size_t batch1_byte_size,
+      OutputInfo* output, std::vector<Scheduler::Payload>* payloads);
+
   // Helper function to set output buffer Output Shape tensor to payloads. It is
   // callers resposibilty to ensure this method is called only for the shape
   // tensors. Return true if cudaMemcpyAsync is called, and the caller should
@@ -155,6 +224,14 @@ struct BackendContext {
       TRTSERVER_Memory_Type src_memory_type, int64_t src_memory_type_id,
       std::vector<Scheduler::Payload>* payloads);
 
+  // Overload of SetOutputShapeTensorBuffer() which issues the CUDA
+  // copies on 'stream' instead of 'stream_'.
+  bool SetOutputShapeTensorBuffer(
+      const std::string& name, const int32_t* content,
+      std::vector<int64_t>& content_shape, const bool support_batching,
+      TRTSERVER_Memory_Type src_memory_type, int64_t src_memory_type_id,
+      std::vector<Scheduler::Payload>* payloads, cudaStream_t stream);
+
   // This function will return the requested input content within a
   // payload in a contiguous chunk. In some cases this will require
   // copying the data. If it happens, 'contiguous_buffer' will be set
@@ -218,6 +295,14 @@ struct BackendContext {
       TRTSERVER_Memory_Type ref_buffer_type, bool is_input,
       TRTSERVER_Memory_Type* candidate_type, bool* need_indirect_buffer);
 
+  // Measure the achieved host-to-device bandwidth of direct copies vs.
+  // copies staged through a pinned buffer for a range of chunk sizes
+  // and set 'pinned_copy_max_chunk_byte_size_' from the measurements.
+  // The right staging cutoff differs between interconnects (e.g. PCIe
+  // vs. NVLink), so it is measured per context rather than fixed. Has
+  // no effect without a GPU.
+  void TunePinnedCopyThreshold();
+
   // Name of the model instance
   std::string name_;
 
@@ -233,6 +318,14 @@ struct BackendContext {
   const bool enable_pinned_input_;
   const bool enable_pinned_output_;
 
+  // Largest input chunk byte size that is staged through an indirect
+  // pinned buffer; larger chunks are copied to the GPU directly. Set by
+  // TunePinnedCopyThreshold(), until then every chunk is staged.
+  size_t pinned_copy_max_chunk_byte_size_;
+
+  // True once the staged-vs-direct measurement has been attempted.
+  bool pinned_copy_tuned_;
+
   // The stream where data transfer operations are executed on.
   cudaStream_t stream_;
 };
@@ -30,10 +30,14 @@
 namespace nvidia { namespace inferenceserver {
 
 constexpr char kInferRequestHTTPHeader[] = "NV-InferRequest";
+constexpr char kInferRequestDeadlineHTTPHeader[] = "NV-InferRequest-Deadline";
+constexpr char kInferRequestDigestHTTPHeader[] = "NV-InferRequest-Digest";
+constexpr char kInferRequestIdHTTPHeader[] = "NV-InferRequest-Id";
 constexpr char kInferResponseHTTPHeader[] = "NV-InferResponse";
 constexpr char kStatusHTTPHeader[] = "NV-Status";
 constexpr char kInferHeaderContentLengthHTTPHeader[] =
     "Inference-Header-Content-Length";
+constexpr char kContentEncodingHTTPHeader[] = "Content-Encoding";
 
 constexpr char kInferRESTEndpoint[] = "api/infer";
 constexpr char kStatusRESTEndpoint[] = "api/status";
@@ -0,0 +1,141 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/cpu_affinity.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif  // __linux__
+
+#include "src/core/logging.h"
+
+namespace nvidia { namespace inferenceserver {
+
+#ifdef __linux__
+
+namespace {
+
+// The configured CPU set for each pool. Written during startup,
+// before the pools create their threads, and read-only afterwards.
+struct PoolCpus {
+  bool configured_ = false;
+  cpu_set_t cpus_;
+};
+
+PoolCpus pool_cpus_[static_cast<size_t>(AffinityPool::POOL_COUNT_)];
+
+}  // namespace
+
+Status
+SetAffinityPoolCpus(const AffinityPool pool, const std::string& cpu_list)
+{
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+
+  // Parse the taskset list format: comma-separated CPU indices or
+  // inclusive ranges, e.g. "0-3,8,10-11".
+  size_t pos = 0;
+  while (pos < cpu_list.size()) {
+    size_t comma = cpu_list.find(',', pos);
+    if (comma == std::string::npos) {
+      comma = cpu_list.size();
+    }
+
+    const std::string token = cpu_list.substr(pos, comma - pos);
+    try {
+      const size_t dash = token.find('-');
+      int first, last;
+      if (dash == std::string::npos) {
+        first = last = std::stoi(token);
+      } else {
+        first = std::stoi(token.substr(0, dash));
+        last = std::stoi(token.substr(dash + 1));
+      }
+
+      if ((first < 0) || (last < first) || (last >= CPU_SETSIZE)) {
+        throw std::invalid_argument(token);
+      }
+
+      for (int cpu = first; cpu <= last; ++cpu) {
+        CPU_SET(cpu, &cpus);
+      }
+    }
+    catch (const std::exception& ex) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "invalid CPU list '" + cpu_list + "', expected comma-separated CPU "
+          "indices or ranges such as '0-3,8'");
+    }
+
+    pos = comma + 1;
+  }
+
+  if (CPU_COUNT(&cpus) == 0) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "invalid CPU list '" + cpu_list + "', at least one CPU is required");
+  }
+
+  PoolCpus& pool_cpu = pool_cpus_[static_cast<size_t>(pool)];
+  pool_cpu.cpus_ = cpus;
+  pool_cpu.configured_ = true;
+
+  return Status::Success;
+}
+
+void
+BindThreadToAffinityPool(const AffinityPool pool)
+{
+  const PoolCpus& pool_cpu = pool_cpus_[static_cast<size_t>(pool)];
+  if (!pool_cpu.configured_) {
+    return;
+  }
+
+  if (sched_setaffinity(0 /* calling thread */, sizeof(cpu_set_t),
+                        &pool_cpu.cpus_) != 0) {
+    LOG_WARNING << "failed to set CPU affinity for thread pool "
+                << static_cast<size_t>(pool);
+  }
+}
+
+#else
+
+Status
+SetAffinityPoolCpus(const AffinityPool pool, const std::string& cpu_list)
+{
+  return Status(
+      Status::Code::UNSUPPORTED,
+      "thread affinity is not supported on this platform");
+}
+
+void
+BindThreadToAffinityPool(const AffinityPool pool)
+{
+}
+
+#endif  // __linux__
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,53 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <string>
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+// The named thread pools whose threads can be bound to a configured
+// set of CPUs. On NUMA systems binding the frontend pools and the
+// scheduler runners to distinct sockets avoids cross-socket traffic.
+enum class AffinityPool {
+  HTTP_WORKER = 0,
+  GRPC_POLLER = 1,
+  SCHEDULER = 2,
+  POOL_COUNT_ = 3
+};
+
+// Configure the set of CPUs that threads of 'pool' are bound to.
+// 'cpu_list' uses the taskset list format, e.g. "0-3,8,10-11". Must
+// be called during startup, before the pools create their threads.
+// Returns UNSUPPORTED on platforms without thread affinity support.
+Status SetAffinityPoolCpus(const AffinityPool pool, const std::string& cpu_list);
+
+// Bind the calling thread to the CPU set configured for 'pool'. Does
+// nothing if no set was configured for the pool.
+void BindThreadToAffinityPool(const AffinityPool pool);
+
+}}  // namespace nvidia::inferenceserver
@@ -60,6 +60,17 @@ std::unique_ptr<CudaMemoryManager> CudaMemoryManager::instance_;
 
 CudaMemoryManager::~CudaMemoryManager()
 {
+  // Complete any deferred frees before tearing down the pool.
+  for (auto& pending : pending_frees_) {
+    cudaEventSynchronize(pending.ready_event_);
+    cudaSetDevice(pending.device_id_);
+    cnmemFree(pending.ptr_, nullptr);
+    cudaEventDestroy(pending.ready_event_);
+  }
+  for (auto& event : event_pool_) {
+    cudaEventDestroy(event);
+  }
+
   auto status = cnmemFinalize();
   if (status != CNMEM_STATUS_SUCCESS) {
     LOG_ERROR << "Failed to finalize CUDA memory manager: [" << status << "] "
@@ -119,6 +130,10 @@ CudaMemoryManager::Alloc(void** ptr, uint64_t size, int64_t device_id)
         Status::Code::UNAVAILABLE, "CudaMemoryManager has not been created");
   }
 
+  // Blocks whose deferred frees have completed can be reused by this
+  // allocation.
+  instance_->ReclaimPendingFrees();
+
   int current_device;
   RETURN_IF_CUDA_ERR(
       cudaGetDevice(&current_device), std::string("Failed to get device"));
@@ -171,4 +186,82 @@ CudaMemoryManager::Free(void* ptr, int64_t device_id)
   return Status::Success;
 }
 
+Status
+CudaMemoryManager::FreeAsync(void* ptr, int64_t device_id, cudaStream_t stream)
+{
+  if (instance_ == nullptr) {
+    return Status(
+        Status::Code::UNAVAILABLE, "CudaMemoryManager has not been created");
+  }
+
+  instance_->ReclaimPendingFrees();
+
+  cudaEvent_t event = nullptr;
+  {
+    std::lock_guard<std::mutex> lk(instance_->pending_mtx_);
+    if (!instance_->event_pool_.empty()) {
+      event = instance_->event_pool_.back();
+      instance_->event_pool_.pop_back();
+    }
+  }
+  if (event == nullptr) {
+    RETURN_IF_CUDA_ERR(
+        cudaEventCreateWithFlags(&event, cudaEventDisableTiming),
+        std::string("Failed to create event for deferred free"));
+  }
+
+  auto err = cudaEventRecord(event, stream);
+  if (err != cudaSuccess) {
+    std::lock_guard<std::mutex> lk(instance_->pending_mtx_);
+    instance_->event_pool_.push_back(event);
+    return Status(
+        Status::Code::INTERNAL,
+        std::string("Failed to record event for deferred free: ") +
+            cudaGetErrorString(err));
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(instance_->pending_mtx_);
+    instance_->pending_frees_.push_back(
+        PendingFree{ptr, device_id, event});
+  }
+
+  return Status::Success;
+}
+
+void
+CudaMemoryManager::ReclaimPendingFrees()
+{
+  std::vector<PendingFree> ready;
+  {
+    std::lock_guard<std::mutex> lk(pending_mtx_);
+    for (size_t idx = 0; idx < pending_frees_.size();) {
+      if (cudaEventQuery(pending_frees_[idx].ready_event_) == cudaSuccess) {
+        ready.push_back(pending_frees_[idx]);
+        pending_frees_[idx] = pending_frees_.back();
+        pending_frees_.pop_back();
+      } else {
+        idx++;
+      }
+    }
+  }
+  // Clear the not-ready error that cudaEventQuery may have set.
+  cudaGetLastError();
+
+  if (!ready.empty()) {
+    for (const auto& pending : ready) {
+      auto status = Free(pending.ptr_, pending.device_id_);
+      if (!status.IsOk()) {
+        LOG_ERROR << "Failed to complete deferred CUDA memory free: "
+                  << status.Message();
+      }
+    }
+
+    std::lock_guard<std::mutex> lk(pending_mtx_);
+    for (const auto& pending : ready) {
+      event_pool_.push_back(pending.ready_event_);
+    }
+  }
+}
+
 }}  // namespace nvidia::inferenceserver
@@ -26,8 +26,11 @@
 //
 #pragma once
 
+#include <cuda_runtime_api.h>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -69,6 +72,14 @@ class CudaMemoryManager {
   // Return Status object indicating success or failure.
   static Status Free(void* ptr, int64_t device_id);
 
+  // Free the memory allocated by the memory manager on 'device_id'
+  // once all work currently enqueued on 'stream' has completed. The
+  // call returns immediately without synchronizing, so callers can
+  // release per-execution buffers while the stream is still running.
+  // The memory is returned to the pool lazily by later calls into the
+  // manager. Return Status object indicating success or failure.
+  static Status FreeAsync(void* ptr, int64_t device_id, cudaStream_t stream);
+
  protected:
   CudaMemoryManager() = default;
 
@@ -77,7 +88,26 @@ class CudaMemoryManager {
   static void Reset();
 
  private:
+  // A block freed with FreeAsync whose stream may still have work
+  // enqueued against the memory. 'ready_event_' was recorded on the
+  // stream at the time of the free.
+  struct PendingFree {
+    void* ptr_;
+    int64_t device_id_;
+    cudaEvent_t ready_event_;
+  };
+
+  // Return to the pool the pending blocks whose streams have
+  // completed the work enqueued before their free.
+  void ReclaimPendingFrees();
+
   static std::unique_ptr<CudaMemoryManager> instance_;
+
+  std::mutex pending_mtx_;
+  std::vector<PendingFree> pending_frees_;
+
+  // Completed events kept for reuse by later FreeAsync calls.
+  std::vector<cudaEvent_t> event_pool_;
 };
 
 }}  // namespace nvidia::inferenceserver
@@ -26,11 +26,147 @@
 
 #include "src/core/cuda_utils.h"
 
+#ifdef TRTIS_ENABLE_GPU
+#include <sched.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#endif  // TRTIS_ENABLE_GPU
+#include "src/core/logging.h"
 #include "src/core/model_config_utils.h"
 #include "src/core/nvtx.h"
+#if defined(TRTIS_ENABLE_METRICS) && defined(TRTIS_ENABLE_METRICS_GPU)
+#include "src/core/metrics.h"
+#endif  // TRTIS_ENABLE_METRICS && TRTIS_ENABLE_METRICS_GPU
 
 namespace nvidia { namespace inferenceserver {
 
+#ifdef TRTIS_ENABLE_GPU
+namespace {
+
+// Device pairs with peer access enabled. Written once by
+// EnablePeerAccess() during server initialization and read-only
+// afterwards.
+std::set<std::pair<int, int>> peer_access_pairs;
+
+// A dedicated stream per source device for inter-GPU copies so that
+// peer-to-peer transfers overlap with the same-device copies issued on
+// the caller's stream. Events sequence the transfer against the
+// caller's stream so the caller's usual synchronization still covers
+// it.
+struct InterGpuStream {
+  std::mutex mtx_;
+  cudaStream_t stream_ = nullptr;
+  cudaEvent_t src_ready_ = nullptr;
+  cudaEvent_t copy_done_ = nullptr;
+};
+
+std::mutex inter_gpu_mu;
+std::map<int, std::unique_ptr<InterGpuStream>> inter_gpu_streams;
+
+InterGpuStream*
+GetInterGpuStream(const int device_id)
+{
+  std::lock_guard<std::mutex> lock(inter_gpu_mu);
+  auto it = inter_gpu_streams.find(device_id);
+  if (it == inter_gpu_streams.end()) {
+    std::unique_ptr<InterGpuStream> igs(new InterGpuStream());
+    int current_device;
+    if ((cudaGetDevice(&current_device) == cudaSuccess) &&
+        (cudaSetDevice(device_id) == cudaSuccess)) {
+      if ((cudaStreamCreateWithFlags(&igs->stream_, cudaStreamNonBlocking) !=
+           cudaSuccess) ||
+          (cudaEventCreateWithFlags(&igs->src_ready_, cudaEventDisableTiming) !=
+           cudaSuccess) ||
+          (cudaEventCreateWithFlags(&igs->copy_done_, cudaEventDisableTiming) !=
+           cudaSuccess)) {
+        LOG_WARNING << "unable to create inter-GPU copy stream for device "
+                    << device_id << ", copies will use the caller's stream";
+        if (igs->stream_ != nullptr) {
+          cudaStreamDestroy(igs->stream_);
+          igs->stream_ = nullptr;
+        }
+        if (igs->src_ready_ != nullptr) {
+          cudaEventDestroy(igs->src_ready_);
+          igs->src_ready_ = nullptr;
+        }
+      }
+      cudaSetDevice(current_device);
+    }
+    it = inter_gpu_streams.emplace(device_id, std::move(igs)).first;
+  }
+  return it->second.get();
+}
+
+// Account an inter-GPU transfer, labeled by whether the direct
+// peer-to-peer path is available for the pair. The per-pair counters
+// are created lazily on first use.
+void
+RecordGpuTransfer(const int src_id, const int dst_id, const size_t byte_size)
+{
+#if defined(TRTIS_ENABLE_METRICS) && defined(TRTIS_ENABLE_METRICS_GPU)
+  static std::mutex mtx;
+  static std::map<std::pair<int, int>, prometheus::Counter*> counters;
+  std::lock_guard<std::mutex> lock(mtx);
+  const auto key = std::make_pair(src_id, dst_id);
+  auto it = counters.find(key);
+  if (it == counters.end()) {
+    const bool peer = (peer_access_pairs.count(key) > 0);
+    prometheus::Counter& counter = Metrics::FamilyGpuTransferBytes().Add(
+        {{"gpu_src", std::to_string(src_id)},
+         {"gpu_dst", std::to_string(dst_id)},
+         {"path", peer ? "peer" : "staged"}});
+    it = counters.emplace(key, &counter).first;
+  }
+  it->second->Increment(byte_size);
+#endif  // TRTIS_ENABLE_METRICS && TRTIS_ENABLE_METRICS_GPU
+}
+
+// Issue an inter-GPU copy on the dedicated stream of the source
+// device. Falls back to the caller's stream when the dedicated stream
+// could not be created.
+cudaError_t
+InterGpuCopyAsync(
+    void* dst, const int64_t dst_id, const void* src, const int64_t src_id,
+    const size_t byte_size, cudaStream_t cuda_stream)
+{
+  RecordGpuTransfer((int)src_id, (int)dst_id, byte_size);
+
+  InterGpuStream* igs = GetInterGpuStream((int)src_id);
+  if (igs->stream_ == nullptr) {
+    return cudaMemcpyPeerAsync(
+        dst, dst_id, src, src_id, byte_size, cuda_stream);
+  }
+
+  // The persistent events are safe to reuse under the lock since a
+  // pending stream-wait captures the work recorded in the event at the
+  // time of the wait call.
+  std::lock_guard<std::mutex> lock(igs->mtx_);
+  cudaError_t cuerr = cudaEventRecord(igs->src_ready_, cuda_stream);
+  if (cuerr == cudaSuccess) {
+    cuerr = cudaStreamWaitEvent(igs->stream_, igs->src_ready_, 0);
+  }
+  if (cuerr == cudaSuccess) {
+    cuerr = cudaMemcpyPeerAsync(
+        dst, dst_id, src, src_id, byte_size, igs->stream_);
+  }
+  if (cuerr == cudaSuccess) {
+    cuerr = cudaEventRecord(igs->copy_done_, igs->stream_);
+  }
+  if (cuerr == cudaSuccess) {
+    cuerr = cudaStreamWaitEvent(cuda_stream, igs->copy_done_, 0);
+  }
+  return cuerr;
+}
+
+}  // namespace
+#endif  // TRTIS_ENABLE_GPU
+
 Status
 EnablePeerAccess(const double min_compute_capability)
 {
@@ -54,6 +190,10 @@ EnablePeerAccess(const double min_compute_capability)
           cuerr = cudaDeviceCanAccessPeer(&can_access_peer, host, peer);
           if ((cuerr == cudaSuccess) && (can_access_peer == 1)) {
             cuerr = cudaDeviceEnablePeerAccess(peer, 0);
+            if ((cuerr == cudaSuccess) ||
+                (cuerr == cudaErrorPeerAccessAlreadyEnabled)) {
+              peer_access_pairs.emplace(host, peer);
+            }
           }
 
           all_enabled &= ((cuerr == cudaSuccess) && (can_access_peer == 1));
@@ -70,6 +210,17 @@ EnablePeerAccess(const double min_compute_capability)
   return Status::Success;
 }
 
+bool
+PeerAccessEnabled(const int64_t src_id, const int64_t dst_id)
+{
+#ifdef TRTIS_ENABLE_GPU
+  return peer_access_pairs.count(
+             std::make_pair((int)src_id, (int)dst_id)) > 0;
+#else
+  return false;
+#endif  // TRTIS_ENABLE_GPU
+}
+
 Status
 CopyBuffer(
     const std::string& msg, const TRTSERVER_Memory_Type src_memory_type,
@@ -101,7 +252,7 @@ CopyBuffer(
     if ((src_memory_type_id != dst_memory_type_id) &&
         (copy_kind == cudaMemcpyDeviceToDevice)) {
       RETURN_IF_CUDA_ERR(
-          cudaMemcpyPeerAsync(
+          InterGpuCopyAsync(
               dst, dst_memory_type_id, src, src_memory_type_id, byte_size,
               cuda_stream),
           msg + ": failed to perform CUDA copy");
@@ -121,6 +272,80 @@ CopyBuffer(
   return Status::Success;
 }
 
+Status
+CopyBuffers(
+    const std::string& msg, const TRTSERVER_Memory_Type src_memory_type,
+    const int64_t src_memory_type_id,
+    const TRTSERVER_Memory_Type dst_memory_type,
+    const int64_t dst_memory_type_id, const std::vector<CopyParams>& params,
+    cudaStream_t cuda_stream, bool* cuda_used)
+{
+  NVTX_RANGE(nvtx_, "CopyBuffers");
+
+  *cuda_used = false;
+
+  if ((src_memory_type != TRTSERVER_MEMORY_GPU) &&
+      (dst_memory_type != TRTSERVER_MEMORY_GPU)) {
+    for (const auto& param : params) {
+      memcpy(param.dst_, param.src_, param.byte_size_);
+    }
+    return Status::Success;
+  }
+
+#ifdef TRTIS_ENABLE_GPU
+  // [TODO] use cudaMemcpyDefault if UVM is supported for the device
+  auto copy_kind = cudaMemcpyDeviceToDevice;
+  if (src_memory_type != TRTSERVER_MEMORY_GPU) {
+    copy_kind = cudaMemcpyHostToDevice;
+  } else if (dst_memory_type != TRTSERVER_MEMORY_GPU) {
+    copy_kind = cudaMemcpyDeviceToHost;
+  }
+  const bool peer_copy = (src_memory_type_id != dst_memory_type_id) &&
+                         (copy_kind == cudaMemcpyDeviceToDevice);
+
+  // Set before issuing so the caller still synchronizes if a later
+  // copy in the batch fails after earlier ones were launched.
+  *cuda_used = true;
+
+  // Fuse runs of copies that are contiguous in both source and
+  // destination into a single transfer so a batch of small chunks is
+  // issued with as few copies as possible.
+  size_t idx = 0;
+  while (idx < params.size()) {
+    const char* src = reinterpret_cast<const char*>(params[idx].src_);
+    char* dst = reinterpret_cast<char*>(params[idx].dst_);
+    size_t byte_size = params[idx].byte_size_;
+    size_t next = idx + 1;
+    while ((next < params.size()) &&
+           (params[next].src_ == (src + byte_size)) &&
+           (params[next].dst_ == (dst + byte_size))) {
+      byte_size += params[next].byte_size_;
+      next++;
+    }
+
+    if (peer_copy) {
+      RETURN_IF_CUDA_ERR(
+          InterGpuCopyAsync(
+              dst, dst_memory_type_id, src, src_memory_type_id, byte_size,
+              cuda_stream),
+          msg + ": failed to perform CUDA copy");
+    } else {
+      RETURN_IF_CUDA_ERR(
+          cudaMemcpyAsync(dst, src, byte_size, copy_kind, cuda_stream),
+          msg + ": failed to perform CUDA copy");
+    }
+
+    idx = next;
+  }
+
+  return Status::Success;
+#else
+  return Status(
+      Status::Code::INTERNAL,
+      msg + ": try to use CUDA copy while GPU is not supported");
+#endif  // TRTIS_ENABLE_GPU
+}
+
 #ifdef TRTIS_ENABLE_GPU
 Status
 CheckGPUCompatibility(const int gpu_id, const double min_compute_capability)
@@ -177,6 +402,76 @@ GetSupportedGPUs(
   return Status::Success;
 }
 
+Status
+GetNumaNode(const int gpu_id, int* numa_node)
+{
+  *numa_node = -1;
+
+  char pci_bus_id[64];
+  RETURN_IF_CUDA_ERR(
+      cudaDeviceGetPCIBusId(pci_bus_id, sizeof(pci_bus_id), gpu_id),
+      "unable to get PCI bus id for GPU " + std::to_string(gpu_id));
+
+  // Sysfs addresses PCI devices with a lower-case bus id.
+  std::string bus_id(pci_bus_id);
+  std::transform(bus_id.begin(), bus_id.end(), bus_id.begin(), ::tolower);
+
+  std::ifstream numa_file("/sys/bus/pci/devices/" + bus_id + "/numa_node");
+  if (!numa_file) {
+    return Status(
+        Status::Code::INTERNAL,
+        "unable to read NUMA node of PCI device " + bus_id);
+  }
+
+  // Sysfs reports -1 when the system is not NUMA.
+  numa_file >> *numa_node;
+  return Status::Success;
+}
+
+Status
+BindThreadToNumaNode(const int numa_node)
+{
+  std::ifstream cpulist_file(
+      "/sys/devices/system/node/node" + std::to_string(numa_node) +
+      "/cpulist");
+  if (!cpulist_file) {
+    return Status(
+        Status::Code::INTERNAL, "unable to read CPU list of NUMA node " +
+                                    std::to_string(numa_node));
+  }
+
+  std::string cpulist;
+  std::getline(cpulist_file, cpulist);
+
+  // The list has the form "0-3,8-11".
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  size_t pos = 0;
+  while (pos < cpulist.size()) {
+    size_t end = cpulist.find(',', pos);
+    const std::string range = cpulist.substr(pos, end - pos);
+    pos = (end == std::string::npos) ? cpulist.size() : (end + 1);
+
+    const size_t dash = range.find('-');
+    const int first_cpu = atoi(range.substr(0, dash).c_str());
+    const int last_cpu = (dash == std::string::npos)
+                             ? first_cpu
+                             : atoi(range.substr(dash + 1).c_str());
+    for (int cpu = first_cpu; cpu <= last_cpu; cpu++) {
+      CPU_SET(cpu, &cpus);
+    }
+  }
+
+  if (sched_setaffinity(0, sizeof(cpu_set_t), &cpus) != 0) {
+    return Status(
+        Status::Code::INTERNAL, "unable to bind thread to NUMA node " +
+                                    std::to_string(numa_node) + ": " +
+                                    strerror(errno));
+  }
+
+  return Status::Success;
+}
+
 #endif
 
 }}  // namespace nvidia::inferenceserver
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <set>
+#include <vector>
 #include "src/core/status.h"
 
 #ifdef TRTIS_ENABLE_GPU
@@ -55,6 +56,11 @@ using cudaStream_t = void*;
 /// \return The error status. A non-OK status means not all pairs are enabled
 Status EnablePeerAccess(const double min_compute_capability);
 
+/// Return true if peer access was successfully enabled from 'src_id'
+/// to 'dst_id' by EnablePeerAccess(). Cross-device copies between a
+/// pair without peer access are staged through host memory by CUDA.
+bool PeerAccessEnabled(const int64_t src_id, const int64_t dst_id);
+
 /// Copy buffer from 'src' to 'dst' for given 'byte_size'. The buffer location
 /// is identified by the memory type and id, and the corresponding copy will be
 /// initiated.
@@ -72,6 +78,36 @@ Status CopyBuffer(
     const int64_t dst_memory_type_id, const size_t byte_size, const void* src,
     void* dst, cudaStream_t cuda_stream, bool* cuda_used);
 
+/// One copy of a batched CopyBuffers() call.
+struct CopyParams {
+  CopyParams(void* dst, const void* src, const size_t byte_size)
+      : dst_(dst), src_(src), byte_size_(byte_size)
+  {
+  }
+  void* dst_;
+  const void* src_;
+  const size_t byte_size_;
+};
+
+/// Copy a batch of buffers that all reside in 'src_memory_type' to
+/// 'dst_memory_type'. Used when assembling a batch from many small
+/// request chunks: runs of copies that are contiguous in both source
+/// and destination are fused into a single transfer so the batch does
+/// not pay per-chunk copy-launch overhead.
+/// 'msg' is the message to be prepended in error message.
+/// 'cuda_stream' specifies the stream to be associated with, and 0 can be
+/// passed for default stream.
+/// 'cuda_used' returns whether a CUDA memory copy is initiated. If true,
+/// the caller should synchronize on the given 'cuda_stream' to ensure data copy
+/// is completed.
+/// \return The error status.
+Status CopyBuffers(
+    const std::string& msg, const TRTSERVER_Memory_Type src_memory_type,
+    const int64_t src_memory_type_id,
+    const TRTSERVER_Memory_Type dst_memory_type,
+    const int64_t dst_memory_type_id, const std::vector<CopyParams>& params,
+    cudaStream_t cuda_stream, bool* cuda_used);
+
 #ifdef TRTIS_ENABLE_GPU
 /// Validates the compute capability of the GPU indexed
 /// \param gpu_id The index of the target GPU.
@@ -91,6 +127,20 @@ Status CheckGPUCompatibility(
 /// errors encountered while querying GPU devices.
 Status GetSupportedGPUs(
     std::set<int>* supported_gpus, const double min_compute_capability);
+
+/// Obtains the NUMA node that the GPU indexed is attached to.
+/// \param gpu_id The index of the target GPU.
+/// \param numa_node Returns the NUMA node local to the GPU, or -1 if
+/// the node can not be determined (e.g. on a non-NUMA system).
+/// \return The error status.
+Status GetNumaNode(const int gpu_id, int* numa_node);
+
+/// Restricts the calling thread to the CPUs of the given NUMA node so
+/// that the memory it allocates and first touches is placed on that
+/// node.
+/// \param numa_node The target NUMA node.
+/// \return The error status.
+Status BindThreadToNumaNode(const int numa_node);
 #endif
 
 }}  // namespace nvidia::inferenceserver
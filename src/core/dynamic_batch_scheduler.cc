@@ -26,20 +26,39 @@
 
 #include "src/core/dynamic_batch_scheduler.h"
 
+#include <limits>
+
 #include <sys/resource.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include "src/core/constants.h"
+#include "src/core/cpu_affinity.h"
 #include "src/core/logging.h"
+#include "src/core/metric_model_reporter.h"
+#include "src/core/metrics.h"
 #include "src/core/model_config.h"
 #include "src/core/nvtx.h"
+#include "src/core/probes.h"
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
+#include "src/core/spin_wait.h"
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// Deactivate a runner after this much continuous idle time.
+constexpr uint64_t kScaleDownIdleNs = 30ull * 1000 * 1000 * 1000;
+
+// Floor on the smoothed queue delay that triggers reactivation of a
+// runner, so that models with no configured batching delay don't
+// scale up on insignificant queueing.
+constexpr uint64_t kScaleUpMinDelayNs = 1000 * 1000;
+
+}  // namespace
+
 DynamicBatchScheduler::DynamicBatchScheduler(
     const uint32_t runner_id_start, const uint32_t runner_cnt,
     const StandardInitFunc& OnInit, const StandardWarmupFunc& OnWarmup,
@@ -50,24 +69,97 @@ DynamicBatchScheduler::DynamicBatchScheduler(
     const bool preserve_ordering,
     const std::set<int32_t>& preferred_batch_sizes,
     const uint64_t max_queue_delay_microseconds,
+    const uint64_t queue_latency_target_microseconds,
     const ModelQueuePolicy& default_queue_policy,
-    const uint32_t priority_levels, const ModelQueuePolicyMap& queue_policy_map)
+    const uint32_t priority_levels, const ModelQueuePolicyMap& queue_policy_map,
+    const uint32_t min_active_runner_cnt,
+    const uint64_t scale_to_zero_idle_microseconds,
+    const StandardReleaseFunc& OnRelease,
+    const std::shared_ptr<MetricModelReporter>& metric_reporter)
     : OnInit_(OnInit), OnWarmup_(OnWarmup), OnSchedule_(OnSchedule),
       OnPeek_(OnPeek), dynamic_batching_enabled_(dynamic_batching_enabled),
       scheduler_thread_cnt_(runner_cnt), idle_scheduler_thread_cnt_(0),
+      wake_pending_(false),
       queue_(default_queue_policy, priority_levels, queue_policy_map),
+      priority_levels_(priority_levels),
       preferred_batch_sizes_(preferred_batch_sizes),
       pending_batch_delay_ns_(max_queue_delay_microseconds * 1000),
+      queue_latency_target_ns_(queue_latency_target_microseconds * 1000),
       pending_batch_size_(0), queued_batch_size_(0),
       next_preferred_batch_size_(0),
       enforce_equal_shape_tensors_(enforce_equal_shape_tensors),
-      preserve_ordering_(preserve_ordering)
+      pending_batch_signature_(0), preserve_ordering_(preserve_ordering),
+      work_stealing_enabled_(!preserve_ordering && (runner_cnt > 1)),
+      OnRelease_(OnRelease), min_active_runner_cnt_(min_active_runner_cnt),
+      scale_to_zero_idle_ns_(scale_to_zero_idle_microseconds * 1000),
+      instance_scaling_enabled_(
+          (OnRelease != nullptr) &&
+          ((min_active_runner_cnt > 0) ||
+           (scale_to_zero_idle_microseconds != 0)) &&
+          (min_active_runner_cnt < runner_cnt)),
+      active_runner_cnt_(runner_cnt), queue_delay_ewma_ns_(0),
+      metric_reporter_(metric_reporter), queue_depth_(0),
+      oldest_enqueue_time_ns_(0), sampler_id_(0), next_dispatch_sequence_(0),
+      next_deliver_sequence_(0), ordered_delivering_(false)
 {
+  if (preserve_ordering_) {
+    ordered_completions_.reset(
+        new OrderedCompletion[kOrderedCompletionRingSize]);
+  }
+
   max_preferred_batch_size_ = 0;
   for (const auto size : preferred_batch_sizes_) {
     max_preferred_batch_size_ =
         std::max(max_preferred_batch_size_, (size_t)size);
   }
+
+  // Shape signatures can stand in for explicit shape comparison only
+  // if no enforced tensor requires its contents to match.
+  shape_signatures_enabled_ = !enforce_equal_shape_tensors_.empty();
+  for (const auto& pr : enforce_equal_shape_tensors_) {
+    if (pr.second) {
+      shape_signatures_enabled_ = false;
+      break;
+    }
+  }
+
+  for (uint32_t c = 0; c < runner_cnt; ++c) {
+    owned_batches_.emplace_back(new OwnedBatches());
+    runner_loads_.emplace_back(new RunnerLoad());
+    runner_scale_states_.emplace_back(new RunnerScaleState());
+  }
+
+  // With adaptive delay tuning, a zero configured delay would leave
+  // the controller nothing to shrink or grow, so start halfway to the
+  // latency target and let the measurements take over.
+  if ((queue_latency_target_ns_ != 0) && (pending_batch_delay_ns_ == 0)) {
+    pending_batch_delay_ns_ = queue_latency_target_ns_ / 2;
+  }
+
+#if defined(TRTIS_ENABLE_METRICS) && defined(TRTIS_ENABLE_STATS)
+  // Export the queue depth and oldest-request age as gauges that are
+  // refreshed at scrape time. The scheduler threads keep the atomics
+  // current while they already hold 'mu_'; the sampler only reads
+  // them, so a metrics scrape never contends on the scheduling lock.
+  if (metric_reporter_ != nullptr) {
+    sampler_id_ = Metrics::AddSampler([this]() {
+      metric_reporter_->MetricModelQueueDepth(-1 /* gpu_device */)
+          .Set(queue_depth_.load());
+      double age_us = 0.0;
+      const uint64_t oldest_ns = oldest_enqueue_time_ns_.load();
+      if (oldest_ns != 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        const uint64_t now_ns = TIMESPEC_TO_NANOS(now);
+        if (now_ns > oldest_ns) {
+          age_us = (now_ns - oldest_ns) / 1000.0;
+        }
+      }
+      metric_reporter_->MetricModelOldestRequestAge(-1 /* gpu_device */)
+          .Set(age_us);
+    });
+  }
+#endif  // TRTIS_ENABLE_METRICS && TRTIS_ENABLE_STATS
 }
 
 Status
@@ -81,13 +173,19 @@ DynamicBatchScheduler::Create(
     const bool preserve_ordering,
     const std::set<int32_t>& preferred_batch_sizes,
     const uint64_t max_queue_delay_microseconds,
+    const uint32_t min_active_runner_cnt,
+    const uint64_t scale_to_zero_idle_microseconds,
+    const StandardReleaseFunc& OnRelease,
+    const std::shared_ptr<MetricModelReporter>& metric_reporter,
     std::unique_ptr<Scheduler>* scheduler)
 {
   return Create(
       runner_id_start, runner_cnt, nice, OnInit, OnWarmup, OnSchedule, OnPeek,
       dynamic_batching_enabled, enforce_equal_shape_tensors, preserve_ordering,
-      preferred_batch_sizes, max_queue_delay_microseconds, ModelQueuePolicy(),
-      0, ModelQueuePolicyMap(), scheduler);
+      preferred_batch_sizes, max_queue_delay_microseconds,
+      0 /* queue_latency_target_microseconds */, ModelQueuePolicy(), 0,
+      ModelQueuePolicyMap(), min_active_runner_cnt,
+      scale_to_zero_idle_microseconds, OnRelease, metric_reporter, scheduler);
 }
 
 Status
@@ -101,15 +199,22 @@ DynamicBatchScheduler::Create(
     const bool preserve_ordering,
     const std::set<int32_t>& preferred_batch_sizes,
     const uint64_t max_queue_delay_microseconds,
+    const uint64_t queue_latency_target_microseconds,
     const ModelQueuePolicy& default_queue_policy,
     const uint32_t priority_levels, const ModelQueuePolicyMap& queue_policy_map,
+    const uint32_t min_active_runner_cnt,
+    const uint64_t scale_to_zero_idle_microseconds,
+    const StandardReleaseFunc& OnRelease,
+    const std::shared_ptr<MetricModelReporter>& metric_reporter,
     std::unique_ptr<Scheduler>* scheduler)
 {
   DynamicBatchScheduler* dyna_sched = new DynamicBatchScheduler(
       runner_id_start, runner_cnt, OnInit, OnWarmup, OnSchedule, OnPeek,
       dynamic_batching_enabled, enforce_equal_shape_tensors, preserve_ordering,
-      preferred_batch_sizes, max_queue_delay_microseconds, default_queue_policy,
-      priority_levels, queue_policy_map);
+      preferred_batch_sizes, max_queue_delay_microseconds,
+      queue_latency_target_microseconds, default_queue_policy, priority_levels,
+      queue_policy_map, min_active_runner_cnt, scale_to_zero_idle_microseconds,
+      OnRelease, metric_reporter);
   std::unique_ptr<DynamicBatchScheduler> sched(dyna_sched);
 
   // Create one scheduler thread for each requested runner. Associate
@@ -139,10 +244,6 @@ DynamicBatchScheduler::Create(
         "Initialization failed for all dynamic-batch scheduler threads");
   }
 
-  sched->completion_queues_ =
-      std::vector<std::queue<std::shared_ptr<std::vector<Scheduler::Payload>>>>(
-          sched->scheduler_thread_cnt_);
-
   scheduler->reset(sched.release());
 
   return Status::Success;
@@ -150,6 +251,14 @@ DynamicBatchScheduler::Create(
 
 DynamicBatchScheduler::~DynamicBatchScheduler()
 {
+#if defined(TRTIS_ENABLE_METRICS) && defined(TRTIS_ENABLE_STATS)
+  // Remove the sampler before anything else is torn down; once
+  // RemoveSampler() returns the sampler cannot be running.
+  if (sampler_id_ != 0) {
+    Metrics::RemoveSampler(sampler_id_);
+  }
+#endif  // TRTIS_ENABLE_METRICS && TRTIS_ENABLE_STATS
+
   // Signal the scheduler threads to exit and then wait for them...
   {
     std::unique_lock<std::mutex> lock(mu_);
@@ -158,6 +267,7 @@ DynamicBatchScheduler::~DynamicBatchScheduler()
     }
 
     cv_.notify_all();
+    scale_cv_.notify_all();
   }
 
   // It is possible for (one of) the scheduler threads to be the last
@@ -188,37 +298,112 @@ DynamicBatchScheduler::Enqueue(
   // scheduling process
   stats->CaptureTimestamp(ModelInferStats::TimestampKind::kQueueStart);
 
-  Status enqueue_status;
-  bool wake_runner = false;
-  {
-    std::lock_guard<std::mutex> lock(mu_);
-    enqueue_status = queue_.Enqueue(
-        request->Priority(),
-        std::move(Payload(stats, request, response_provider, OnComplete)));
-    if (enqueue_status.IsOk()) {
-      queued_batch_size_ += request->BatchSize();
-    }
+  const auto batch_size = request->BatchSize();
+  TRTIS_PROBE2(queue_enqueue, request->ModelName().c_str(), batch_size);
+  NVTX_MARKER_ID(
+      "QueueEnqueue " + request->ModelName(), request->UniqueId());
 
-    // If there are any idle runners and the queued batch size is greater or
-    // equal to next preferred batch size, then wake one up to service this
-    // request. We do the actual wake outside of the lock to avoid having the
-    // woken thread immediately block on the lock
-    wake_runner = (idle_scheduler_thread_cnt_ > 0);
+  Payload payload(stats, request, response_provider, OnComplete);
 
-    // We may wake up runner less often if we don't enforce equal shape within
-    // a batch, otherwise must always wake up runner to check it
-    if (enforce_equal_shape_tensors_.empty()) {
-      wake_runner &= (queued_batch_size_ >= next_preferred_batch_size_);
-    }
+  // Computing the shape signature on this thread keeps the cost off
+  // the scheduler threads' critical section.
+  if (shape_signatures_enabled_) {
+    payload.shape_signature_ =
+        ShapeSignature(*request, enforce_equal_shape_tensors_);
+  }
+
+  // Push onto the lock-free queue so this thread never contends on
+  // 'mu_'. The request is moved into 'queue_' by a scheduler thread,
+  // which also reports any queue-policy enqueue error.
+  enqueue_queue_.Push(
+      EnqueuedPayload(request->Priority(), std::move(payload)));
+  queued_batch_size_ += batch_size;
+
+  // If there are any idle runners and the queued batch size is greater or
+  // equal to next preferred batch size, then wake one up to service this
+  // request.
+  bool wake_runner = (idle_scheduler_thread_cnt_.load() > 0);
+
+  // We may wake up runner less often if we don't enforce equal shape within
+  // a batch, otherwise must always wake up runner to check it
+  if (enforce_equal_shape_tensors_.empty()) {
+    wake_runner &= (queued_batch_size_.load() >= next_preferred_batch_size_.load());
   }
 
-  if (wake_runner) {
+  // Coalesce the wakes: if a previously issued wake is still pending
+  // then the woken thread will see this request too and no additional
+  // syscall is needed.
+  if (wake_runner && !wake_pending_.exchange(true)) {
     cv_.notify_one();
   }
 
-  if (!enqueue_status.IsOk()) {
-    OnComplete(enqueue_status);
+  // If scale-to-zero has demoted every runner, wake the parked
+  // runners so one can promote the model back. The claim itself is
+  // made by a runner under 'mu_'; until its context is ready this and
+  // any following requests simply queue.
+  if (instance_scaling_enabled_ && (active_runner_cnt_.load() == 0)) {
+    scale_cv_.notify_all();
+  }
+}
+
+Status
+DynamicBatchScheduler::UpdateConfig(const ModelConfig& config)
+{
+  if (!dynamic_batching_enabled_) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "dynamic batching is not enabled for model " + config.name());
+  }
+
+  // The parameters come from the dynamic-batching configuration or,
+  // when this scheduler forms batches for an OldestFirst sequence
+  // batcher, from the sequence-batching configuration.
+  std::set<int32_t> preferred_batch_sizes;
+  uint64_t max_queue_delay_microseconds = 0;
+  if (config.has_dynamic_batching()) {
+    for (const auto size : config.dynamic_batching().preferred_batch_size()) {
+      preferred_batch_sizes.insert(size);
+    }
+    max_queue_delay_microseconds =
+        config.dynamic_batching().max_queue_delay_microseconds();
+  } else if (
+      config.has_sequence_batching() &&
+      config.sequence_batching().has_oldest()) {
+    for (const auto size :
+         config.sequence_batching().oldest().preferred_batch_size()) {
+      preferred_batch_sizes.insert(size);
+    }
+    max_queue_delay_microseconds =
+        config.sequence_batching().oldest().max_queue_delay_microseconds();
+  } else {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "model configuration does not specify batcher parameters for model " +
+            config.name());
   }
+
+  // Swap the parameters atomically with respect to batch formation.
+  // GetDynamicBatch() reads them under 'mu_' so an in-progress batch
+  // formation sees either all old or all new values.
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    preferred_batch_sizes_ = preferred_batch_sizes;
+    max_preferred_batch_size_ = 0;
+    for (const auto size : preferred_batch_sizes_) {
+      max_preferred_batch_size_ =
+          std::max(max_preferred_batch_size_, (size_t)size);
+    }
+    pending_batch_delay_ns_ = max_queue_delay_microseconds * 1000;
+    if ((queue_latency_target_ns_ != 0) && (pending_batch_delay_ns_ == 0)) {
+      pending_batch_delay_ns_ = queue_latency_target_ns_ / 2;
+    }
+  }
+
+  // Wake the scheduler threads so any wait based on the previous
+  // queue delay is recomputed with the new value.
+  cv_.notify_all();
+
+  return Status::Success;
 }
 
 void
@@ -236,6 +421,8 @@ DynamicBatchScheduler::SchedulerThread(
                    << " failed)...";
   }
 
+  BindThreadToAffinityPool(AffinityPool::SCHEDULER);
+
   // Initialize using the thread. If error then just exit this thread
   // now... that means the corresponding model instance will not have
   // any runner and so will not get used for execution.
@@ -288,15 +475,146 @@ DynamicBatchScheduler::SchedulerThread(
   while (!thread_exit->load()) {
     NVTX_RANGE(nvtx_, "DynamicBatchScheduler " + runner_id);
 
+    if (instance_scaling_enabled_) {
+      auto& sstate = *runner_scale_states_[completion_id];
+
+      // A deactivated runner parks here, without pulling work, until
+      // it is scaled up again. It waits on 'scale_cv_' so that it
+      // never consumes a wake meant for a runner that can accept
+      // work.
+      if (!sstate.active_.load()) {
+        std::unique_lock<std::mutex> lock(mu_);
+
+        // Promote on demand: when every runner has been demoted and a
+        // request is waiting, one parked runner claims the activation
+        // ('mu_' ensures only one claims it) and recreates its context
+        // below, on this thread, while further requests queue behind
+        // the one that triggered the promotion.
+        if ((active_runner_cnt_.load() == 0) &&
+            ((queued_batch_size_.load() != 0) || !enqueue_queue_.Empty())) {
+          sstate.active_.store(true);
+          active_runner_cnt_++;
+          LOG_INFO << "Promoting demoted model instance for dynamic-batch "
+                   << "scheduler thread " << runner_id << " on demand";
+          continue;
+        }
+
+        if (!sstate.active_.load() && !thread_exit->load()) {
+          scale_cv_.wait_for(
+              lock, std::chrono::microseconds(default_wait_microseconds));
+        }
+        continue;
+      }
+
+      // Just scaled up... recreate and initialize the execution
+      // context before accepting work. Warmup is not re-run; the
+      // warmup samples are only valid during the initial model load.
+      if (sstate.released_) {
+        Status status = OnInit_(runner_id);
+        if (!status.IsOk()) {
+          LOG_ERROR << "Failed to reactivate model instance for "
+                    << "dynamic-batch scheduler thread " << runner_id << ": "
+                    << status.Message();
+          sstate.active_.store(false);
+          active_runner_cnt_--;
+          // Back off before parking so that a persistent context
+          // creation failure, with requests waiting to promote the
+          // model, does not retry in a tight loop.
+          std::unique_lock<std::mutex> lock(mu_);
+          scale_cv_.wait_for(
+              lock, std::chrono::microseconds(default_wait_microseconds));
+          continue;
+        }
+        sstate.released_ = false;
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        sstate.last_busy_ns_.store(TIMESPEC_TO_NANOS(now));
+        LOG_INFO << "Reactivated model instance for dynamic-batch scheduler "
+                 << "thread " << runner_id;
+      }
+
+      // An idle runner over the instance minimum releases its context
+      // and parks.
+      if (MaybeScaleDown(runner_id, completion_id)) {
+        continue;
+      }
+    }
+
     std::shared_ptr<std::vector<Scheduler::Payload>> payloads;
     std::shared_ptr<std::vector<std::deque<Scheduler::Payload>>>
         rejected_payloads;
+    std::shared_ptr<std::vector<std::deque<Scheduler::Payload>>>
+        cancelled_payloads;
+    std::vector<Scheduler::Payload> failed_enqueues;
+    std::vector<Scheduler::Payload> cancelled_dequeues;
     bool wake_thread = false;
     uint64_t wait_microseconds = 0;
+    uint64_t order_sequence = 0;
+
+    // Execute a batch already formed for this runner before forming
+    // new ones from the shared queue.
+    if (work_stealing_enabled_) {
+      PopOwnedBatch(completion_id, &payloads);
+    }
 
     // Hold the lock for as short a time as possible.
-    {
+    if (payloads == nullptr) {
       std::unique_lock<std::mutex> lock(mu_);
+
+      // Refresh the service-time estimate used by wait-bounded queue
+      // policies before admitting new requests. The queue drains
+      // across all runners, so the per-payload estimate is the mean
+      // measured batch duration divided by the runner count.
+      uint64_t batch_ns_sum = 0;
+      uint64_t batch_ns_cnt = 0;
+      for (const auto& load : runner_loads_) {
+        const uint64_t avg_ns = load->avg_batch_ns_.load();
+        if (avg_ns != 0) {
+          batch_ns_sum += avg_ns;
+          batch_ns_cnt++;
+        }
+      }
+      queue_.SetServiceTimeEstimate(
+          (batch_ns_cnt == 0)
+              ? 0
+              : (batch_ns_sum / batch_ns_cnt / runner_loads_.size()));
+
+      // Move requests accepted by Enqueue() into the priority queue.
+      // Queue-policy enqueue errors are completed outside the lock.
+      // Invoked again after a batch is formed so that requests that
+      // arrived during formation can preempt it before dispatch.
+      auto drain_enqueue_queue = [&]() -> bool {
+        bool drained = false;
+        for (auto& enqueued : enqueue_queue_.DrainAll()) {
+          drained = true;
+          const auto batch_size = enqueued.payload_.request_->BatchSize();
+          const auto shape_signature = enqueued.payload_.shape_signature_;
+          Status enqueue_status =
+              queue_.Enqueue(enqueued.priority_, std::move(enqueued.payload_));
+          if (enqueue_status.IsOk()) {
+            if (shape_signature != 0) {
+              shape_bucket_counts_[shape_signature]++;
+            }
+          } else {
+            queued_batch_size_ -= batch_size;
+            enqueued.payload_.status_ = enqueue_status;
+            failed_enqueues.emplace_back(std::move(enqueued.payload_));
+          }
+        }
+        return drained;
+      };
+      drain_enqueue_queue();
+
+      // Proactively sweep out expired payloads so that batch
+      // formation only ever visits live requests.
+      queued_batch_size_ -= queue_.EnforceTimeouts();
+
+      // Refresh the queue-state metrics while already holding the
+      // lock. The metrics sampler reads these atomics at scrape time
+      // and so never needs to take 'mu_'.
+      queue_depth_.store(queue_.Size());
+      oldest_enqueue_time_ns_.store(queue_.OldestQueuedEnqueueTime());
+
       if (delay_cnt > 0) {
         // Debugging/testing... wait until queue contains 'delay_cnt'
         // items...
@@ -313,8 +631,42 @@ DynamicBatchScheduler::SchedulerThread(
         // Use dynamic batching to get request payload(s) to execute.
         wait_microseconds = GetDynamicBatch(runner_id);
 
+        // Preemption before dispatch: a higher-priority request that
+        // arrived while the batch was being formed is still in the
+        // staging ring and would otherwise wait behind the formed
+        // batch for a full execution. With priorities configured,
+        // drain the ring again; an enqueue that lands ahead of the
+        // pending batch invalidates the cursor, in which case the
+        // batch is re-formed so the higher-priority request
+        // dispatches first. This bounds priority inversion to
+        // executions already in flight.
+        if ((priority_levels_ != 0) && (wait_microseconds == 0) &&
+            (queue_.PendingBatchCount() != 0)) {
+          if (drain_enqueue_queue() && !queue_.IsCursorValid()) {
+            wait_microseconds = GetDynamicBatch(runner_id);
+          }
+        }
+
         // Get payloads that are rejected from searching dynamic batch.
         rejected_payloads = queue_.ReleaseRejectedPayloads();
+        if (rejected_payloads != nullptr) {
+          for (const auto& rejected_queue : *rejected_payloads) {
+            for (const auto& rejected_payload : rejected_queue) {
+              ReleaseShapeBucket(rejected_payload);
+            }
+          }
+        }
+
+        // Get payloads that were dropped because their request was
+        // cancelled.
+        cancelled_payloads = queue_.ReleaseCancelledPayloads();
+        if (cancelled_payloads != nullptr) {
+          for (const auto& cancelled_queue : *cancelled_payloads) {
+            for (const auto& cancelled_payload : cancelled_queue) {
+              ReleaseShapeBucket(cancelled_payload);
+            }
+          }
+        }
 
         // Extract batch only if there is pending batch
         auto pending_batch_queue_cnt = queue_.PendingBatchCount();
@@ -325,7 +677,20 @@ DynamicBatchScheduler::SchedulerThread(
             Scheduler::Payload payload;
             auto status = queue_.Dequeue(&payload);
             if (status.IsOk()) {
-              payloads->emplace_back(std::move(payload));
+              ReleaseShapeBucket(payload);
+              TRTIS_PROBE2(
+                  queue_dequeue, payload.request_->ModelName().c_str(),
+                  payload.request_->BatchSize());
+              NVTX_MARKER_ID(
+                  "QueueDequeue " + payload.request_->ModelName(),
+                  payload.request_->UniqueId());
+              // A request cancelled after the batch was formed is
+              // dropped here rather than executed.
+              if (payload.request_->IsCancelled()) {
+                cancelled_dequeues.emplace_back(std::move(payload));
+              } else {
+                payloads->emplace_back(std::move(payload));
+              }
             } else {
               // The queue is empty which conflicts with pending batch count.
               // Send the current batch if any and reset related variables.
@@ -334,14 +699,25 @@ DynamicBatchScheduler::SchedulerThread(
               queue_.ResetCursor();
               queued_batch_size_ = 0;
               pending_batch_size_ = 0;
+              shape_bucket_counts_.clear();
               break;
             }
           }
           if (preserve_ordering_ && !payloads->empty()) {
-            std::lock_guard<std::mutex> lock(completion_id_queue_mtx_);
-            completion_id_queue_.push(completion_id);
+            order_sequence = next_dispatch_sequence_.fetch_add(1);
           }
 
+#if defined(TRTIS_ENABLE_METRICS) && defined(TRTIS_ENABLE_STATS)
+          if ((metric_reporter_ != nullptr) &&
+              (max_preferred_batch_size_ > 0)) {
+            metric_reporter_
+                ->MetricInferenceBatchOccupancy(-1 /* gpu_device */)
+                .Observe(
+                    (double)pending_batch_size_ /
+                    (double)max_preferred_batch_size_);
+          }
+#endif  // TRTIS_ENABLE_METRICS && TRTIS_ENABLE_STATS
+
           queued_batch_size_ -= pending_batch_size_;
           // Set next preferred to be 0 so that enqueue thread will wake up
           // runners when new request arrives. In the case where the queue
@@ -363,17 +739,109 @@ DynamicBatchScheduler::SchedulerThread(
           // the lock to avoid having the woken thread immediately
           // block on the lock.
           wake_thread = !queue_.Empty() && (idle_scheduler_thread_cnt_ > 0);
+
+          // With work stealing enabled, eagerly form additional
+          // batches while the queue can still produce full ones and
+          // park them on this runner's deque so that idle peers can
+          // steal them instead of serializing on 'mu_'.
+          if (work_stealing_enabled_) {
+            auto& owned = *owned_batches_[completion_id];
+            while (!queue_.Empty()) {
+              {
+                std::lock_guard<std::mutex> lk(owned.mtx_);
+                if ((owned.batches_.size() + 1) >= scheduler_thread_cnt_) {
+                  break;
+                }
+              }
+              if (GetDynamicBatch(runner_id) != 0) {
+                break;
+              }
+              const auto extra_cnt = queue_.PendingBatchCount();
+              if (extra_cnt == 0) {
+                break;
+              }
+              auto extra = std::make_shared<std::vector<Scheduler::Payload>>();
+              extra->reserve(extra_cnt);
+              bool dequeue_failed = false;
+              for (size_t idx = 0; idx < extra_cnt; ++idx) {
+                Scheduler::Payload payload;
+                auto status = queue_.Dequeue(&payload);
+                if (status.IsOk()) {
+                  ReleaseShapeBucket(payload);
+                  TRTIS_PROBE2(
+                      queue_dequeue, payload.request_->ModelName().c_str(),
+                      payload.request_->BatchSize());
+                  if (payload.request_->IsCancelled()) {
+                    cancelled_dequeues.emplace_back(std::move(payload));
+                    continue;
+                  }
+                  extra->emplace_back(std::move(payload));
+                } else {
+                  LOG_ERROR
+                      << "Failed to retrieve payload from scheduler queue: "
+                      << status.Message();
+                  queue_.ResetCursor();
+                  queued_batch_size_ = 0;
+                  pending_batch_size_ = 0;
+                  shape_bucket_counts_.clear();
+                  dequeue_failed = true;
+                  break;
+                }
+              }
+#if defined(TRTIS_ENABLE_METRICS) && defined(TRTIS_ENABLE_STATS)
+              if ((metric_reporter_ != nullptr) &&
+                  (max_preferred_batch_size_ > 0)) {
+                metric_reporter_
+                    ->MetricInferenceBatchOccupancy(-1 /* gpu_device */)
+                    .Observe(
+                        (double)pending_batch_size_ /
+                        (double)max_preferred_batch_size_);
+              }
+#endif  // TRTIS_ENABLE_METRICS && TRTIS_ENABLE_STATS
+              queued_batch_size_ -= pending_batch_size_;
+              pending_batch_size_ = 0;
+              pending_batch_shapes_.clear();
+              if (!extra->empty()) {
+                std::lock_guard<std::mutex> lk(owned.mtx_);
+                owned.batches_.push_back(std::move(extra));
+              }
+              if (dequeue_failed) {
+                break;
+              }
+            }
+            {
+              std::lock_guard<std::mutex> lk(owned.mtx_);
+              wake_thread |= !owned.batches_.empty() &&
+                             (idle_scheduler_thread_cnt_ > 0);
+            }
+          }
         }
       } else {
         // No batching... execute next request payload
+        if (instance_scaling_enabled_) {
+          struct timespec now;
+          clock_gettime(CLOCK_MONOTONIC, &now);
+          const uint64_t now_ns = TIMESPEC_TO_NANOS(now);
+          const uint64_t oldest_ns = queue_.OldestEnqueueTime();
+          if ((oldest_ns != 0) && (now_ns > oldest_ns)) {
+            RecordQueueDelay(now_ns - oldest_ns);
+          }
+        }
         payloads = std::make_shared<std::vector<Scheduler::Payload>>();
         Scheduler::Payload payload;
         auto status = queue_.Dequeue(&payload);
         if (status.IsOk()) {
-          payloads->emplace_back(std::move(payload));
-          if (preserve_ordering_) {
-            std::lock_guard<std::mutex> lock(completion_id_queue_mtx_);
-            completion_id_queue_.push(completion_id);
+          ReleaseShapeBucket(payload);
+          TRTIS_PROBE2(
+              queue_dequeue, payload.request_->ModelName().c_str(),
+              payload.request_->BatchSize());
+          if (payload.request_->IsCancelled()) {
+            cancelled_dequeues.emplace_back(std::move(payload));
+          } else {
+            payloads->emplace_back(std::move(payload));
+            if (preserve_ordering_) {
+              order_sequence = next_dispatch_sequence_.fetch_add(1);
+            }
           }
         } else {
           LOG_ERROR << "Failed to retrieve payload from scheduler queue: "
@@ -384,23 +852,98 @@ DynamicBatchScheduler::SchedulerThread(
       // If no requests are to be handled, wait for notification or
       // for the specified timeout before checking the queue again.
       if (wait_microseconds > 0) {
+        // An idle runner first tries to steal a formed batch from a
+        // peer before committing to the wait.
+        if (work_stealing_enabled_ && StealBatch(completion_id, &payloads)) {
+          wait_microseconds = 0;
+        }
+      }
+
+      if (wait_microseconds > 0) {
+        // In low-latency mode spin for new work for a bounded window
+        // before sleeping, so an arriving request doesn't pay the
+        // condition-variable wakeup latency. The spin runs outside
+        // the lock so enqueuing threads are not blocked.
+        const int64_t spin_us = SpinWaitMicroseconds();
+        if ((spin_us > 0) && enqueue_queue_.Empty()) {
+          lock.unlock();
+          const auto spin_deadline = std::chrono::steady_clock::now() +
+                                     std::chrono::microseconds(spin_us);
+          while (enqueue_queue_.Empty() && !thread_exit->load() &&
+                 (std::chrono::steady_clock::now() < spin_deadline)) {
+            SpinPause();
+          }
+          lock.lock();
+        }
+
         idle_scheduler_thread_cnt_++;
-        std::chrono::microseconds wait_timeout(wait_microseconds);
-        cv_.wait_for(lock, wait_timeout);
+        // Recheck for requests that arrived before the idle count was
+        // visible to the enqueuing threads; those threads only notify
+        // when they observe an idle thread. A request that races with
+        // this check is picked up after at most 'wait_timeout'.
+        if (enqueue_queue_.Empty()) {
+          std::chrono::microseconds wait_timeout(wait_microseconds);
+          cv_.wait_for(lock, wait_timeout);
+        }
+        // Any pending wake has been consumed (either by this wait or
+        // by the non-empty recheck above); allow the next enqueue to
+        // issue a wake again.
+        wake_pending_.store(false);
         idle_scheduler_thread_cnt_--;
       }
     }
 
-    if (wake_thread) {
+    if (wake_thread && !wake_pending_.exchange(true)) {
       cv_.notify_one();
     }
 
+    // Requests that the queue policy refused to admit are completed
+    // with the error outside of the lock.
+    for (auto& failed : failed_enqueues) {
+      if (failed.complete_function_ != nullptr) {
+        failed.complete_function_(failed.status_);
+      }
+    }
+
+    // If this runner is measurably further behind than an idle peer
+    // (e.g. its GPU is also serving another hot model), park the batch
+    // for the peer to claim instead of adding to the backlog here.
+    // This only triggers when batches complete asynchronously; a
+    // runner that executes synchronously has no inflight work while
+    // it is forming a batch.
+    if (work_stealing_enabled_ && (payloads != nullptr) &&
+        !payloads->empty() && (idle_scheduler_thread_cnt_.load() > 0) &&
+        (LoadEstimate(completion_id) > MinPeerLoadEstimate(completion_id))) {
+      {
+        auto& owned = *owned_batches_[completion_id];
+        std::lock_guard<std::mutex> lk(owned.mtx_);
+        owned.batches_.push_front(std::move(payloads));
+      }
+      payloads = nullptr;
+      if (!wake_pending_.exchange(true)) {
+        cv_.notify_one();
+      }
+    }
+
     if ((payloads != nullptr) && !payloads->empty()) {
-      auto OnCompleteQueuedPayloads = [this, completion_id,
-                                       payloads](const Status& status) {
-        FinalizePayloads(completion_id, payloads, status);
+      struct timespec dispatch_ts;
+      clock_gettime(CLOCK_MONOTONIC, &dispatch_ts);
+      const uint64_t dispatch_ns = TIMESPEC_TO_NANOS(dispatch_ts);
+      runner_loads_[completion_id]->inflight_batches_++;
+
+      if (instance_scaling_enabled_) {
+        runner_scale_states_[completion_id]->last_busy_ns_.store(dispatch_ns);
+        MaybeScaleUp();
+      }
+
+      auto OnCompleteQueuedPayloads = [this, completion_id, order_sequence,
+                                       payloads,
+                                       dispatch_ns](const Status& status) {
+        RecordBatchComplete(completion_id, dispatch_ns);
+        FinalizePayloads(order_sequence, payloads, status);
       };
 
+      TRTIS_PROBE2(batch_dispatch, runner_id, payloads->size());
       OnSchedule_(runner_id, payloads.get(), OnCompleteQueuedPayloads);
 
       // For testing we introduce a delay here to make the
@@ -425,6 +968,26 @@ DynamicBatchScheduler::SchedulerThread(
       }
     }
 
+    // Finish cancelled payloads if any
+    if ((cancelled_payloads != nullptr) || !cancelled_dequeues.empty()) {
+      static Status cancelled_status =
+          Status(Status::Code::UNAVAILABLE, "Request cancelled by client");
+      if (cancelled_payloads != nullptr) {
+        for (auto& cancelled_queue : *cancelled_payloads) {
+          for (auto& cancelled_payload : cancelled_queue) {
+            if (cancelled_payload.complete_function_ != nullptr) {
+              cancelled_payload.complete_function_(cancelled_status);
+            }
+          }
+        }
+      }
+      for (auto& cancelled_payload : cancelled_dequeues) {
+        if (cancelled_payload.complete_function_ != nullptr) {
+          cancelled_payload.complete_function_(cancelled_status);
+        }
+      }
+    }
+
     // At the end of this scope 'payloads' will be destroyed.  A
     // handle to the backend is held through the
     // payload.complete_function_. If the server is exiting or the
@@ -443,6 +1006,266 @@ DynamicBatchScheduler::SchedulerThread(
                  << "...";
 }
 
+bool
+DynamicBatchScheduler::PopOwnedBatch(
+    const uint32_t completion_id,
+    std::shared_ptr<std::vector<Scheduler::Payload>>* payloads)
+{
+  // Leave parked batches for an idle, less-loaded peer to claim when
+  // this runner is the more loaded side; a peer was woken when the
+  // batch was parked.
+  if ((idle_scheduler_thread_cnt_.load() > 0) &&
+      (LoadEstimate(completion_id) > MinPeerLoadEstimate(completion_id))) {
+    return false;
+  }
+
+  auto& owned = *owned_batches_[completion_id];
+  std::lock_guard<std::mutex> lock(owned.mtx_);
+  if (owned.batches_.empty()) {
+    return false;
+  }
+
+  *payloads = std::move(owned.batches_.front());
+  owned.batches_.pop_front();
+  return true;
+}
+
+bool
+DynamicBatchScheduler::StealBatch(
+    const uint32_t completion_id,
+    std::shared_ptr<std::vector<Scheduler::Payload>>* payloads)
+{
+  // Prefer to steal from the peer with the largest estimated backlog,
+  // counting both its inflight batches and the batches parked on its
+  // deque, so that work drains away from the slowest instance first.
+  uint32_t victim = scheduler_thread_cnt_;
+  uint64_t victim_load = 0;
+  for (uint32_t i = 1; i < scheduler_thread_cnt_; ++i) {
+    const uint32_t peer = (completion_id + i) % scheduler_thread_cnt_;
+    size_t parked_cnt;
+    {
+      std::lock_guard<std::mutex> lock(owned_batches_[peer]->mtx_);
+      parked_cnt = owned_batches_[peer]->batches_.size();
+    }
+    if (parked_cnt == 0) {
+      continue;
+    }
+    const uint64_t avg_ns =
+        std::max(runner_loads_[peer]->avg_batch_ns_.load(), (uint64_t)1);
+    const uint64_t load = LoadEstimate(peer) + (parked_cnt * avg_ns);
+    if ((victim == scheduler_thread_cnt_) || (load > victim_load)) {
+      victim = peer;
+      victim_load = load;
+    }
+  }
+
+  if (victim != scheduler_thread_cnt_) {
+    auto& owned = *owned_batches_[victim];
+    std::lock_guard<std::mutex> lock(owned.mtx_);
+    if (!owned.batches_.empty()) {
+      *payloads = std::move(owned.batches_.back());
+      owned.batches_.pop_back();
+      return true;
+    }
+  }
+
+  // The chosen victim may have been drained since the scan, fall back
+  // to scanning the peers starting after this runner so that stealing
+  // doesn't always target the same victim.
+  for (uint32_t i = 1; i < scheduler_thread_cnt_; ++i) {
+    const uint32_t peer = (completion_id + i) % scheduler_thread_cnt_;
+    auto& owned = *owned_batches_[peer];
+    std::lock_guard<std::mutex> lock(owned.mtx_);
+    if (!owned.batches_.empty()) {
+      *payloads = std::move(owned.batches_.back());
+      owned.batches_.pop_back();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+uint64_t
+DynamicBatchScheduler::LoadEstimate(const uint32_t completion_id) const
+{
+  // Until a duration has been measured, weight each inflight batch
+  // equally so the estimate degrades to a queue-depth comparison.
+  const auto& load = *runner_loads_[completion_id];
+  const uint64_t avg_ns = std::max(load.avg_batch_ns_.load(), (uint64_t)1);
+  return load.inflight_batches_.load() * avg_ns;
+}
+
+uint64_t
+DynamicBatchScheduler::MinPeerLoadEstimate(const uint32_t completion_id) const
+{
+  uint64_t min_load = std::numeric_limits<uint64_t>::max();
+  for (uint32_t peer = 0; peer < scheduler_thread_cnt_; ++peer) {
+    if (peer != completion_id) {
+      min_load = std::min(min_load, LoadEstimate(peer));
+    }
+  }
+  return min_load;
+}
+
+void
+DynamicBatchScheduler::RecordBatchComplete(
+    const uint32_t completion_id, const uint64_t dispatch_ns)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_ns = TIMESPEC_TO_NANOS(now);
+
+  auto& load = *runner_loads_[completion_id];
+  if (now_ns > dispatch_ns) {
+    // Weight recent batches heavily so that a runner whose device
+    // starts serving another hot model is seen as slow quickly.
+    const uint64_t duration_ns = now_ns - dispatch_ns;
+    const uint64_t prev_ns = load.avg_batch_ns_.load();
+    load.avg_batch_ns_.store(
+        (prev_ns == 0) ? duration_ns
+                       : (prev_ns - (prev_ns / 4) + (duration_ns / 4)));
+  }
+  load.inflight_batches_--;
+
+  // A batch parked on this runner may have been waiting for capacity;
+  // wake a runner to claim it.
+  if (work_stealing_enabled_) {
+    bool parked;
+    {
+      std::lock_guard<std::mutex> lock(owned_batches_[completion_id]->mtx_);
+      parked = !owned_batches_[completion_id]->batches_.empty();
+    }
+    if (parked && !wake_pending_.exchange(true)) {
+      cv_.notify_one();
+    }
+  }
+}
+
+void
+DynamicBatchScheduler::RecordQueueDelay(const uint64_t delay_ns)
+{
+  if (!instance_scaling_enabled_) {
+    return;
+  }
+
+  // Weight recent batches heavily so that a sudden backlog is seen
+  // quickly. Updated by the scheduler threads, read by the scale-up
+  // check.
+  const uint64_t prev_ns = queue_delay_ewma_ns_.load();
+  queue_delay_ewma_ns_.store(
+      (prev_ns == 0) ? delay_ns : (prev_ns - (prev_ns / 8) + (delay_ns / 8)));
+}
+
+bool
+DynamicBatchScheduler::MaybeScaleDown(
+    const uint32_t runner_id, const uint32_t completion_id)
+{
+  if (active_runner_cnt_.load() <= min_active_runner_cnt_) {
+    return false;
+  }
+
+  // Only the highest-indexed active runner may deactivate, so that at
+  // most one runner deactivates at a time and the active set stays
+  // dense at the low indices.
+  for (uint32_t peer = completion_id + 1; peer < scheduler_thread_cnt_;
+       ++peer) {
+    if (runner_scale_states_[peer]->active_.load()) {
+      return false;
+    }
+  }
+
+  auto& sstate = *runner_scale_states_[completion_id];
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_ns = TIMESPEC_TO_NANOS(now);
+  const uint64_t last_busy_ns = sstate.last_busy_ns_.load();
+  if (last_busy_ns == 0) {
+    sstate.last_busy_ns_.store(now_ns);
+    return false;
+  }
+  // The last active runner holds the model's only resident context.
+  // Deactivating it demotes the model entirely, so it only happens
+  // when scale-to-zero is configured and then after the configured
+  // residency timeout rather than the fixed threshold.
+  const uint64_t idle_threshold_ns =
+      ((scale_to_zero_idle_ns_ != 0) && (active_runner_cnt_.load() == 1))
+          ? scale_to_zero_idle_ns_
+          : kScaleDownIdleNs;
+  if ((now_ns - last_busy_ns) < idle_threshold_ns) {
+    return false;
+  }
+
+  // Never deactivate while dispatched batches are still inflight or
+  // work is parked on this runner's deque.
+  if (runner_loads_[completion_id]->inflight_batches_.load() != 0) {
+    return false;
+  }
+  if (work_stealing_enabled_) {
+    std::lock_guard<std::mutex> lock(owned_batches_[completion_id]->mtx_);
+    if (!owned_batches_[completion_id]->batches_.empty()) {
+      return false;
+    }
+  }
+
+  Status status = OnRelease_(runner_id);
+  if (!status.IsOk()) {
+    LOG_ERROR << "Failed to deactivate model instance for dynamic-batch "
+              << "scheduler thread " << runner_id << ": " << status.Message();
+    sstate.last_busy_ns_.store(now_ns);
+    return false;
+  }
+
+  sstate.released_ = true;
+  sstate.active_.store(false);
+  active_runner_cnt_--;
+  LOG_INFO << "Deactivated idle model instance for dynamic-batch scheduler "
+           << "thread " << runner_id;
+  return true;
+}
+
+void
+DynamicBatchScheduler::MaybeScaleUp()
+{
+  if (active_runner_cnt_.load() >= scheduler_thread_cnt_) {
+    return;
+  }
+  if (queue_delay_ewma_ns_.load() < kScaleUpMinDelayNs) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mu_);
+
+  // Reactivate only on sustained queueing: the smoothed queue delay
+  // must also exceed the configured batching delay so that delay
+  // intentionally spent forming batches does not read as overload.
+  // 'pending_batch_delay_ns_' is read under 'mu_' because the
+  // adaptive delay tuning adjusts it.
+  const uint64_t threshold_ns =
+      std::max(2 * pending_batch_delay_ns_, kScaleUpMinDelayNs);
+  if (queue_delay_ewma_ns_.load() < threshold_ns) {
+    return;
+  }
+
+  for (uint32_t peer = 0; peer < scheduler_thread_cnt_; ++peer) {
+    auto& sstate = *runner_scale_states_[peer];
+    if (!sstate.active_.load()) {
+      sstate.active_.store(true);
+      active_runner_cnt_++;
+      LOG_INFO << "Queue delay " << queue_delay_ewma_ns_.load()
+               << "ns over threshold " << threshold_ns
+               << "ns, reactivating a model instance";
+      // Restart the delay measurement so that this activation is
+      // given time to absorb the backlog before another is
+      // considered.
+      queue_delay_ewma_ns_.store(0);
+      scale_cv_.notify_all();
+      return;
+    }
+  }
+}
+
 uint64_t
 DynamicBatchScheduler::GetDynamicBatch(const int64_t runner_id)
 {
@@ -469,10 +1292,13 @@ DynamicBatchScheduler::GetDynamicBatch(const int64_t runner_id)
     if (queue_.PendingBatchCount() == 0) {
       // Get the shape of the new batch that is being started...
       if (!enforce_equal_shape_tensors_.empty()) {
-        if (!InitPendingShape(
-                 runner_id, queue_.PayloadAtCursor(),
-                 enforce_equal_shape_tensors_, OnPeek_, &pending_batch_shapes_)
-                 .IsOk()) {
+        if (shape_signatures_enabled_) {
+          pending_batch_signature_ = queue_.PayloadAtCursor().shape_signature_;
+        } else if (!InitPendingShape(
+                        runner_id, queue_.PayloadAtCursor(),
+                        enforce_equal_shape_tensors_, OnPeek_,
+                        &pending_batch_shapes_)
+                        .IsOk()) {
           send_now = true;
           break;
         }
@@ -487,12 +1313,19 @@ DynamicBatchScheduler::GetDynamicBatch(const int64_t runner_id)
 
       // There is a pending batch and it has a different shape then
       // this request, so send the pending batch as it is.
-      if (!enforce_equal_shape_tensors_.empty() &&
-          !CompareWithPendingShape(
-              runner_id, queue_.PayloadAtCursor(), OnPeek_,
-              pending_batch_shapes_)) {
-        send_now = true;
-        break;
+      if (!enforce_equal_shape_tensors_.empty()) {
+        if (shape_signatures_enabled_) {
+          if (queue_.PayloadAtCursor().shape_signature_ !=
+              pending_batch_signature_) {
+            send_now = true;
+            break;
+          }
+        } else if (!CompareWithPendingShape(
+                        runner_id, queue_.PayloadAtCursor(), OnPeek_,
+                        pending_batch_shapes_)) {
+          send_now = true;
+          break;
+        }
       }
     }
 
@@ -511,6 +1344,7 @@ DynamicBatchScheduler::GetDynamicBatch(const int64_t runner_id)
   if (best_preferred_batch_size != 0) {
     pending_batch_size_ = best_preferred_batch_size;
     queue_.SetCursorToMark();
+    RecordPendingBatchLatency();
     return 0;
   }
 
@@ -525,9 +1359,22 @@ DynamicBatchScheduler::GetDynamicBatch(const int64_t runner_id)
   // pending.
   if (send_now || (pending_batch_delay_ns_ == 0) ||
       (pending_batch_size_ >= max_preferred_batch_size_)) {
+    RecordPendingBatchLatency();
     return 0;
   }
 
+  // With shape bucketing, if no queued request outside the pending
+  // batch has the batch's shape then nothing can join it... execute
+  // now instead of waiting out the queue delay.
+  if (shape_signatures_enabled_) {
+    const auto it = shape_bucket_counts_.find(pending_batch_signature_);
+    if ((it == shape_bucket_counts_.end()) ||
+        (it->second <= queue_.PendingBatchCount())) {
+      RecordPendingBatchLatency();
+      return 0;
+    }
+  }
+
   // Compare the age of the oldest pending request to the maximum
   // batch queuing delay and execute now if queuing delay is
   // exceeded. If queuing delay not exceeded create a timer to wakeup
@@ -538,6 +1385,7 @@ DynamicBatchScheduler::GetDynamicBatch(const int64_t runner_id)
   uint64_t delay_ns = now_ns - queue_.OldestEnqueueTime();
 
   if (delay_ns >= pending_batch_delay_ns_) {
+    RecordPendingBatchLatency();
     return 0;
   }
 
@@ -576,9 +1424,78 @@ DynamicBatchScheduler::GetDynamicBatch(const int64_t runner_id)
   return wait_ns / 1000;
 }
 
+void
+DynamicBatchScheduler::ReleaseShapeBucket(const Scheduler::Payload& payload)
+{
+  // 'mu_' mutex must be held when this function is called.
+  if (payload.shape_signature_ != 0) {
+    const auto it = shape_bucket_counts_.find(payload.shape_signature_);
+    if (it != shape_bucket_counts_.end()) {
+      if (--it->second == 0) {
+        shape_bucket_counts_.erase(it);
+      }
+    }
+  }
+}
+
+void
+DynamicBatchScheduler::RecordPendingBatchLatency()
+{
+  // 'mu_' mutex must be held when this function is called. The
+  // pending batch is about to be scheduled, so the age of its oldest
+  // request is the queue latency the batch experienced.
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_ns = TIMESPEC_TO_NANOS(now);
+  const uint64_t oldest_ns = queue_.OldestEnqueueTime();
+  if ((oldest_ns == 0) || (now_ns < oldest_ns)) {
+    return;
+  }
+
+  RecordQueueDelay(now_ns - oldest_ns);
+
+  if (queue_latency_target_ns_ == 0) {
+    return;
+  }
+
+  batch_latency_samples_.push_back(now_ns - oldest_ns);
+
+  // Adjust the effective delay once enough batches have been
+  // observed to estimate the p99 queue latency.
+  constexpr size_t kLatencyWindowSize = 64;
+  if (batch_latency_samples_.size() < kLatencyWindowSize) {
+    return;
+  }
+
+  std::sort(batch_latency_samples_.begin(), batch_latency_samples_.end());
+  const uint64_t p99_ns =
+      batch_latency_samples_[(batch_latency_samples_.size() * 99) / 100];
+  batch_latency_samples_.clear();
+
+  const uint64_t prev_delay_ns = pending_batch_delay_ns_;
+  if (p99_ns > queue_latency_target_ns_) {
+    // Over the target... back off the delay quickly.
+    pending_batch_delay_ns_ -= pending_batch_delay_ns_ / 4;
+  } else if (p99_ns < (queue_latency_target_ns_ -
+                       (queue_latency_target_ns_ / 4))) {
+    // Comfortably under the target... grow the delay slowly to allow
+    // larger batches to form, but never past the latency target.
+    pending_batch_delay_ns_ = std::min(
+        pending_batch_delay_ns_ + (pending_batch_delay_ns_ / 8) + 1000,
+        queue_latency_target_ns_);
+  }
+
+  if (pending_batch_delay_ns_ != prev_delay_ns) {
+    LOG_VERBOSE(1) << "Adaptive queue delay: p99 queue latency " << p99_ns
+                   << "ns, target " << queue_latency_target_ns_
+                   << "ns, delay adjusted " << prev_delay_ns << "ns -> "
+                   << pending_batch_delay_ns_ << "ns";
+  }
+}
+
 void
 DynamicBatchScheduler::FinalizePayloads(
-    const uint32_t completion_id,
+    const uint64_t sequence,
     std::shared_ptr<std::vector<Scheduler::Payload>> payloads,
     const Status& status)
 {
@@ -609,27 +1526,64 @@ DynamicBatchScheduler::FinalizePayloads(
   }
 
   if (preserve_ordering_) {
-    std::lock_guard<std::mutex> lock(completion_queues_mtx_);
-    completion_queues_[completion_id].push(payloads);
-    // Finalize the completed payloads in-order as far as possible
+    // Publish into the sequence-numbered slot. A slot is only reused
+    // after the completion 'kOrderedCompletionRingSize' dispatches
+    // earlier has been delivered; if the ring has wrapped that far,
+    // wait for the slot to free. The awaited completion runs on
+    // another thread so this always makes progress.
+    auto& slot = ordered_completions_[sequence % kOrderedCompletionRingSize];
+    while (slot.sequence_.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+    slot.payloads_ = std::move(payloads);
+    slot.sequence_.store(sequence + 1, std::memory_order_release);
+
+    // Deliver the contiguous prefix of published completions. A
+    // single thread holds the delivery flag at a time so responses
+    // are strictly in dispatch order.
     while (true) {
-      size_t head_completion_id;
-      {
-        std::lock_guard<std::mutex> lock(completion_id_queue_mtx_);
-        if (completion_id_queue_.empty() ||
-            completion_queues_[completion_id_queue_.front()].empty()) {
+      if (ordered_delivering_.exchange(true, std::memory_order_acquire)) {
+        // Another thread is delivering; it rechecks for newly
+        // published completions after clearing the flag, so this
+        // publication will not be stranded.
+        break;
+      }
+
+      while (true) {
+        const uint64_t head =
+            next_deliver_sequence_.load(std::memory_order_relaxed);
+        auto& head_slot =
+            ordered_completions_[head % kOrderedCompletionRingSize];
+        if (head_slot.sequence_.load(std::memory_order_acquire) !=
+            (head + 1)) {
           break;
         }
-        head_completion_id = completion_id_queue_.front();
-        completion_id_queue_.pop();
-      }
 
-      for (auto& payload : *completion_queues_[head_completion_id].front()) {
-        if (payload.complete_function_ != nullptr) {
-          payload.complete_function_(payload.status_);
+        // Free the slot before invoking the completion callbacks so
+        // publishers can reuse it while the callbacks run.
+        std::shared_ptr<std::vector<Scheduler::Payload>> ready =
+            std::move(head_slot.payloads_);
+        head_slot.sequence_.store(0, std::memory_order_release);
+        next_deliver_sequence_.store(head + 1, std::memory_order_release);
+
+        for (auto& payload : *ready) {
+          if (payload.complete_function_ != nullptr) {
+            payload.complete_function_(payload.status_);
+          }
         }
       }
-      completion_queues_[head_completion_id].pop();
+
+      ordered_delivering_.store(false, std::memory_order_release);
+
+      // A completion published after the drain ended but before the
+      // flag was cleared saw the flag still set and broke out; pick
+      // it up here instead of leaving it stranded.
+      const uint64_t head =
+          next_deliver_sequence_.load(std::memory_order_acquire);
+      if (ordered_completions_[head % kOrderedCompletionRingSize]
+              .sequence_.load(std::memory_order_acquire) != (head + 1)) {
+        break;
+      }
     }
   }
 }
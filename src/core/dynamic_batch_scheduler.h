@@ -30,12 +30,14 @@
 #include <deque>
 #include <future>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <set>
 #include <thread>
 #include "src/core/api.pb.h"
 #include "src/core/model_config.h"
+#include "src/core/mpsc_queue.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/scheduler.h"
 #include "src/core/scheduler_utils.h"
@@ -43,6 +45,8 @@
 
 namespace nvidia { namespace inferenceserver {
 
+class MetricModelReporter;
+
 // Scheduler that implements dynamic batching.
 class DynamicBatchScheduler : public Scheduler {
  public:
@@ -58,6 +62,10 @@ class DynamicBatchScheduler : public Scheduler {
       const bool preserve_ordering,
       const std::set<int32_t>& preferred_batch_sizes,
       const uint64_t max_queue_delay_microseconds,
+      const uint32_t min_active_runner_cnt,
+      const uint64_t scale_to_zero_idle_microseconds,
+      const StandardReleaseFunc& OnRelease,
+      const std::shared_ptr<MetricModelReporter>& metric_reporter,
       std::unique_ptr<Scheduler>* scheduler);
 
   // Create a scheduler to support a given number of runners and a run
@@ -73,9 +81,14 @@ class DynamicBatchScheduler : public Scheduler {
       const bool preserve_ordering,
       const std::set<int32_t>& preferred_batch_sizes,
       const uint64_t max_queue_delay_microseconds,
+      const uint64_t queue_latency_target_microseconds,
       const ModelQueuePolicy& default_queue_policy,
       const uint32_t priority_level,
       const ModelQueuePolicyMap& queue_policy_map,
+      const uint32_t min_active_runner_cnt,
+      const uint64_t scale_to_zero_idle_microseconds,
+      const StandardReleaseFunc& OnRelease,
+      const std::shared_ptr<MetricModelReporter>& metric_reporter,
       std::unique_ptr<Scheduler>* scheduler);
 
   ~DynamicBatchScheduler();
@@ -87,6 +100,9 @@ class DynamicBatchScheduler : public Scheduler {
       const std::shared_ptr<InferResponseProvider>& response_provider,
       std::function<void(const Status&)> OnComplete) override;
 
+  // \see Scheduler::UpdateConfig()
+  Status UpdateConfig(const ModelConfig& config) override;
+
  private:
   DynamicBatchScheduler(
       const uint32_t runner_id_start, const uint32_t runner_cnt,
@@ -98,16 +114,36 @@ class DynamicBatchScheduler : public Scheduler {
       const bool preserve_ordering,
       const std::set<int32_t>& preferred_batch_sizes,
       const uint64_t max_queue_delay_microseconds,
+      const uint64_t queue_latency_target_microseconds,
       const ModelQueuePolicy& default_queue_policy,
       const uint32_t priority_levels,
-      const ModelQueuePolicyMap& queue_policy_map);
+      const ModelQueuePolicyMap& queue_policy_map,
+      const uint32_t min_active_runner_cnt,
+      const uint64_t scale_to_zero_idle_microseconds,
+      const StandardReleaseFunc& OnRelease,
+      const std::shared_ptr<MetricModelReporter>& metric_reporter);
   void SchedulerThread(
       const uint32_t runner_id, const uint32_t completion_id, const int nice,
       const std::shared_ptr<std::atomic<bool>>& rthread_exit,
       std::promise<bool>* is_initialized);
   uint64_t GetDynamicBatch(const int64_t runner_id);
-  void FinalizePayloads(
+  void RecordPendingBatchLatency();
+  void ReleaseShapeBucket(const Scheduler::Payload& payload);
+  bool PopOwnedBatch(
       const uint32_t completion_id,
+      std::shared_ptr<std::vector<Scheduler::Payload>>* payloads);
+  bool StealBatch(
+      const uint32_t completion_id,
+      std::shared_ptr<std::vector<Scheduler::Payload>>* payloads);
+  uint64_t LoadEstimate(const uint32_t completion_id) const;
+  uint64_t MinPeerLoadEstimate(const uint32_t completion_id) const;
+  void RecordBatchComplete(
+      const uint32_t completion_id, const uint64_t dispatch_ns);
+  void RecordQueueDelay(const uint64_t delay_ns);
+  bool MaybeScaleDown(const uint32_t runner_id, const uint32_t completion_id);
+  void MaybeScaleUp();
+  void FinalizePayloads(
+      const uint64_t sequence,
       std::shared_ptr<std::vector<Scheduler::Payload>> payloads,
       const Status& status);
 
@@ -130,29 +166,70 @@ class DynamicBatchScheduler : public Scheduler {
   // The number of scheduler threads.
   const uint32_t scheduler_thread_cnt_;
 
-  // The number of scheduler threads currently idle.
-  uint32_t idle_scheduler_thread_cnt_;
+  // The number of scheduler threads currently idle. Atomic so that
+  // the lock-free enqueue path can decide whether a wakeup is needed
+  // without taking 'mu_'.
+  std::atomic<uint32_t> idle_scheduler_thread_cnt_;
+
+  // True when a wake has been issued on 'cv_' but no scheduler thread
+  // has yet responded to it. While set, further wakes are redundant
+  // and skipped so that at most one wake syscall is made per idle
+  // period. Cleared by a scheduler thread when it passes through the
+  // idle path.
+  std::atomic<bool> wake_pending_;
 
   // Mutex and condvar protecting the scheduling queue.
   std::mutex mu_;
   std::condition_variable cv_;
 
+  // A request as accepted by Enqueue() but not yet moved into
+  // 'queue_' by a scheduler thread.
+  struct EnqueuedPayload {
+    EnqueuedPayload(uint32_t priority, Scheduler::Payload&& payload)
+        : priority_(priority), payload_(std::move(payload))
+    {
+    }
+    uint32_t priority_;
+    Scheduler::Payload payload_;
+  };
+
+  // Lock-free queue accepting requests from the frontend threads.
+  // Drained into 'queue_' by the scheduler threads, under 'mu_', so
+  // that frontend threads never block on the scheduling lock.
+  MpscQueue<EnqueuedPayload> enqueue_queue_;
+
   // Map from priority level to queue holding inference requests for the model
   // represented by this scheduler. If priority queues are not supported by the
   // scheduler, then priority zero entry is used as the single queue.
   PriorityQueue queue_;
 
+  // The number of configured priority levels, 0 if the model does not
+  // use priorities. Preemption of a formed batch before dispatch is
+  // only attempted when priorities are configured.
+  const uint32_t priority_levels_;
+
   std::vector<std::unique_ptr<std::thread>> scheduler_threads_;
   std::vector<std::shared_ptr<std::atomic<bool>>> scheduler_threads_exit_;
 
   size_t max_preferred_batch_size_;
   std::set<int32_t> preferred_batch_sizes_;
   uint64_t pending_batch_delay_ns_;
+
+  // Adaptive tuning of 'pending_batch_delay_ns_'. If the target is
+  // non-zero the queue latency of each formed batch is sampled and the
+  // effective delay adjusted, between zero and the target, to track
+  // the p99 latency target. Protected by 'mu_'.
+  const uint64_t queue_latency_target_ns_;
+  std::vector<uint64_t> batch_latency_samples_;
   size_t pending_batch_size_;
   PendingBatchShapes pending_batch_shapes_;
 
-  size_t queued_batch_size_;
-  size_t next_preferred_batch_size_;
+  // Total batch size of the queued requests, including requests still
+  // on 'enqueue_queue_'. Atomic so that the lock-free enqueue path can
+  // account for a new request and consult the wakeup heuristic without
+  // taking 'mu_'.
+  std::atomic<size_t> queued_batch_size_;
+  std::atomic<size_t> next_preferred_batch_size_;
 
   // The input tensors that require shape checking before being
   // allowed in a batch. As a map from the tensor name to a bool. If
@@ -163,21 +240,136 @@ class DynamicBatchScheduler : public Scheduler {
   // the batch.
   const std::unordered_map<std::string, bool> enforce_equal_shape_tensors_;
 
+  // True when the equal-shape constraint can be represented by a
+  // per-request shape signature (no shape-tensor contents involved).
+  // Signatures are computed on the enqueuing thread and turn batch
+  // compatibility checks into integer compares.
+  bool shape_signatures_enabled_;
+
+  // Shape signature of the pending batch. Protected by 'mu_'.
+  uint64_t pending_batch_signature_;
+
+  // Number of queued requests per shape signature. Used to execute a
+  // pending batch immediately when no request of its shape remains to
+  // join it. Protected by 'mu_'.
+  std::unordered_map<uint64_t, size_t> shape_bucket_counts_;
+
   // If true the ordering of responses matches the order of requests
   // even when there are multiple scheduler threads.
   const bool preserve_ordering_;
 
-  // Holds the sequence of completion-queue indices in order the
-  // payloads were issued.
-  std::queue<size_t> completion_id_queue_;
-  // Lock to protect the completion_id_queue_
-  std::mutex completion_id_queue_mtx_;
-
-  // Per completion-id queues to store the ready payloads
-  std::vector<std::queue<std::shared_ptr<std::vector<Scheduler::Payload>>>>
-      completion_queues_;
-  // Lock to protect the completion_queues_
-  std::mutex completion_queues_mtx_;
+  // True if runner threads may steal formed batches from each other.
+  // Stealing breaks the one-outstanding-batch-per-runner invariant
+  // that in-order completion relies on, so it is disabled when
+  // 'preserve_ordering_' is set.
+  const bool work_stealing_enabled_;
+
+  // A deque of formed batches owned by one runner. The owner pushes
+  // and pops at the front; idle runners steal from the back.
+  struct OwnedBatches {
+    std::mutex mtx_;
+    std::deque<std::shared_ptr<std::vector<Scheduler::Payload>>> batches_;
+  };
+
+  // Per-runner owned batches, indexed by completion id.
+  std::vector<std::unique_ptr<OwnedBatches>> owned_batches_;
+
+  // Estimated outstanding work for one runner: the number of
+  // dispatched but not yet completed batches, and an exponential
+  // moving average of the measured batch duration. The product of the
+  // two approximates how far the runner is behind, which reflects
+  // external slowdowns (e.g. the runner's GPU also serving another hot
+  // model) that a plain batch count would miss.
+  struct RunnerLoad {
+    RunnerLoad() : avg_batch_ns_(0), inflight_batches_(0) {}
+    std::atomic<uint64_t> avg_batch_ns_;
+    std::atomic<uint32_t> inflight_batches_;
+  };
+
+  // Per-runner load estimates, indexed by completion id.
+  std::vector<std::unique_ptr<RunnerLoad>> runner_loads_;
+
+  // Function the scheduler will call to release the execution context
+  // of a runner deactivated by dynamic instance scaling.
+  const StandardReleaseFunc OnRelease_;
+
+  // The number of runners that must always stay active.
+  const uint32_t min_active_runner_cnt_;
+
+  // If non-zero the model is not required to stay resident: the last
+  // active runner may also deactivate, after this idle period, and a
+  // parked runner promotes the model back on demand when a request
+  // arrives.
+  const uint64_t scale_to_zero_idle_ns_;
+
+  // True if runners may be deactivated after a sustained idle period
+  // and reactivated when sustained queueing delay is observed.
+  const bool instance_scaling_enabled_;
+
+  // The number of runners currently active.
+  std::atomic<uint32_t> active_runner_cnt_;
+
+  // Exponential moving average of the queue delay experienced by
+  // scheduled batches. Used to decide when to reactivate a runner.
+  std::atomic<uint64_t> queue_delay_ewma_ns_;
+
+  // Condvar, paired with 'mu_', that deactivated runners wait on.
+  // Separate from 'cv_' so that a wake meant for work is never
+  // consumed by a runner that cannot accept work.
+  std::condition_variable scale_cv_;
+
+  // Dynamic instance scaling state for one runner.
+  struct RunnerScaleState {
+    RunnerScaleState() : active_(true), released_(false), last_busy_ns_(0) {}
+    std::atomic<bool> active_;
+    // True when the runner's execution context has been released.
+    // Only touched by the owning runner thread.
+    bool released_;
+    // When the runner last dispatched a batch.
+    std::atomic<uint64_t> last_busy_ns_;
+  };
+
+  // Per-runner scaling state, indexed by completion id.
+  std::vector<std::unique_ptr<RunnerScaleState>> runner_scale_states_;
+
+  // Metric reporter for the model served by this scheduler. May be
+  // nullptr if metrics are not being reported for the model.
+  const std::shared_ptr<MetricModelReporter> metric_reporter_;
+
+  // Queue state exported as metrics. Refreshed by the scheduler
+  // threads, while already holding 'mu_', and read by the metrics
+  // sampler at scrape time. Atomic so the sampler never takes 'mu_'.
+  std::atomic<size_t> queue_depth_;
+  std::atomic<uint64_t> oldest_enqueue_time_ns_;
+
+  // Id of the sampler registered with Metrics, or 0 if none.
+  uint64_t sampler_id_;
+
+  // With 'preserve_ordering_' completed batches are delivered to the
+  // response callbacks in dispatch order through a sequence-numbered
+  // ring. Each dispatched batch takes the next sequence number, its
+  // completion is published into the corresponding slot, and
+  // whichever completing thread holds the delivery flag delivers the
+  // contiguous prefix of published completions. Ordered delivery then
+  // costs a couple of uncontended atomics per batch instead of a
+  // contended lock shared by all the runners.
+  struct OrderedCompletion {
+    OrderedCompletion() : sequence_(0) {}
+    // Holds 'sequence + 1' of the published completion, 0 when the
+    // slot is free.
+    std::atomic<uint64_t> sequence_;
+    std::shared_ptr<std::vector<Scheduler::Payload>> payloads_;
+  };
+  static const size_t kOrderedCompletionRingSize = 1024;
+
+  // The completion ring, allocated only with 'preserve_ordering_'.
+  std::unique_ptr<OrderedCompletion[]> ordered_completions_;
+  // Sequence number taken by the next dispatched batch.
+  std::atomic<uint64_t> next_dispatch_sequence_;
+  // Sequence number of the next completion to deliver.
+  std::atomic<uint64_t> next_deliver_sequence_;
+  // Set while a thread is delivering the contiguous prefix.
+  std::atomic<bool> ordered_delivering_;
 };
 
 }}  // namespace nvidia::inferenceserver
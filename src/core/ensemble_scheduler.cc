@@ -32,6 +32,7 @@
 #include "src/core/api.pb.h"
 #include "src/core/backend.h"
 #include "src/core/cuda_utils.h"
+#include "src/core/ensemble_tensor_pool.h"
 #include "src/core/logging.h"
 #include "src/core/server.h"
 #include "src/core/server_status.h"
@@ -39,6 +40,8 @@
 
 namespace nvidia { namespace inferenceserver {
 
+const size_t EnsembleInfo::kNoStep;
+
 namespace {
 
 // Step specifies the backend, providers and status objects used for
@@ -49,7 +52,8 @@ struct Step {
   std::shared_ptr<InferenceBackend> backend_;
   std::shared_ptr<InferenceRequest> request_;
   std::shared_ptr<InferResponseProvider> response_provider_;
-  std::unordered_map<std::string, std::shared_ptr<AllocatedMemory>> output_map_;
+  std::shared_ptr<EnsembleTensorPool> tensor_pool_;
+  std::unordered_map<std::string, std::shared_ptr<Memory>> output_map_;
   Status infer_status_;
 
   size_t step_idx_;
@@ -71,6 +75,7 @@ class EnsembleContext {
       const std::shared_ptr<ModelInferStats>& stats,
       const std::shared_ptr<InferenceRequest>& request,
       const std::shared_ptr<InferResponseProvider>& response_provider,
+      const std::shared_ptr<EnsembleTensorPool>& tensor_pool,
       std::function<void(const Status&)> OnComplete, cudaStream_t stream);
 
   // Perform transition on 'context' state given the information of
@@ -110,16 +115,16 @@ class EnsembleContext {
       const std::shared_ptr<EnsembleContext>& context, const StepList& steps);
 
   // Helper function that updates ensemble state given 'completed_step' and
-  // returns the list of updated tensors in 'updated_tensors'
+  // returns the ids of the updated tensors in 'updated_tensors'
   Status UpdateEnsembleState(
       const std::shared_ptr<Step>& completed_step,
-      std::vector<std::string>& updated_tensors);
+      std::vector<size_t>& updated_tensors);
 
   // Helper function that returns a list of 'steps' that should be run under
   // current ensemble state. 'updated_tensors' is used so that we don't need to
   // iterate all the tensors to determine which step can be run.
   Status GetNextSteps(
-      const std::vector<std::string>& updated_tensors, StepList& steps);
+      const std::vector<size_t>& updated_tensors, StepList& steps);
 
   // Helper function that completes the response of the ensemble request
   Status FinishEnsemble();
@@ -138,7 +143,7 @@ class EnsembleContext {
   // Returns the batch size to be used after the reshape.
   size_t ReshapeTensorDims(
       const DimsList& config_dims, const bool allow_batching,
-      const size_t tensor_batch_size, const std::vector<int64_t>& dims,
+      const size_t tensor_batch_size, const ShapeVector& dims,
       std::vector<int64_t>* mutable_dims);
 
   InferenceServer* is_;
@@ -155,12 +160,18 @@ class EnsembleContext {
 
   size_t inflight_step_counter_;
 
-  // pointer that either points to 'pruned_tensor_to_step_' or to
-  // 'info_->tensor_to_step_' if all ensemble outputs are requested
-  std::unordered_map<std::string, std::set<size_t>>* tensor_to_step_;
+  // Per-tensor data for this invocation, indexed by tensor id
+  std::vector<TensorData> tensor_data_;
+
+  // Whether each tensor / step is needed for this invocation, false for
+  // the part of the ensemble pruned because its outputs are not
+  // requested
+  std::vector<bool> tensor_used_;
+  std::vector<bool> step_needed_;
 
-  std::unordered_map<std::string, std::set<size_t>> pruned_tensor_to_step_;
-  std::unordered_map<std::string, TensorData> tensor_data_;
+  // For each step, the number of distinct input tensors not yet ready.
+  // A step is dispatched when its count reaches zero.
+  std::vector<size_t> step_missing_inputs_;
 
   // Handle to all backend that may be used in the ensemble
   std::unordered_map<std::string, VersionMap> handles_;
@@ -179,6 +190,10 @@ class EnsembleContext {
   std::shared_ptr<InferResponseProvider> response_provider_;
   std::function<void(const Status&)> OnComplete_;
 
+  // All EnsembleContext of an ensemble share the pool that recycles
+  // the buffers backing intermediate tensors across invocations
+  std::shared_ptr<EnsembleTensorPool> tensor_pool_;
+
   // Output tensors whose labels are not provided by the ensemble
   std::set<std::string> no_label_tensors_;
 
@@ -194,10 +209,11 @@ EnsembleContext::EnsembleContext(
     const std::shared_ptr<ModelInferStats>& stats,
     const std::shared_ptr<InferenceRequest>& request,
     const std::shared_ptr<InferResponseProvider>& response_provider,
+    const std::shared_ptr<EnsembleTensorPool>& tensor_pool,
     std::function<void(const Status&)> OnComplete, cudaStream_t stream)
     : is_(is), info_(info), stream_(stream), inflight_step_counter_(0),
       stats_(stats), request_(request), response_provider_(response_provider),
-      OnComplete_(OnComplete),
+      OnComplete_(OnComplete), tensor_pool_(tensor_pool),
       allocator_(nullptr, TRTSERVER_ResponseAllocatorDelete)
 {
   // Obtain backend handles of all models in ensemble request such that
@@ -222,42 +238,59 @@ EnsembleContext::EnsembleContext(
     }
   }
 
+  const size_t tensor_count = info_->tensor_name_.size();
+  tensor_data_.resize(tensor_count);
+  tensor_used_.assign(tensor_count, true);
+  step_needed_.assign(info_->steps_.size(), true);
+  step_missing_inputs_ = info_->step_input_count_;
+
   // Prune ensemble first if not all outputs are requested
-  std::set<std::string> ignored_tensor;
-  for (const auto& ensemble_output : info_->ensemble_output_shape_) {
-    ignored_tensor.insert(ensemble_output.first);
-  }
-  for (const auto& pr : request_->RequestedOutputs()) {
-    ignored_tensor.erase(pr.first);
+  std::vector<size_t> ignored_tensor;
+  {
+    std::set<std::string> ignored_name;
+    for (const auto& ensemble_output : info_->ensemble_output_shape_) {
+      ignored_name.insert(ensemble_output.first);
+    }
+    for (const auto& pr : request_->RequestedOutputs()) {
+      ignored_name.erase(pr.first);
+    }
+    for (const auto& name : ignored_name) {
+      ignored_tensor.push_back(info_->tensor_id_[name]);
+    }
   }
-  if (ignored_tensor.empty()) {
-    tensor_to_step_ = &(info_->tensor_to_step_);
-  } else {
-    pruned_tensor_to_step_ = info_->tensor_to_step_;
-    tensor_to_step_ = &pruned_tensor_to_step_;
-    // Backward traversal
-    std::unordered_map<size_t, size_t> step_requested_output_count;
+  if (!ignored_tensor.empty()) {
+    // Backward traversal, prune a step once none of its outputs is
+    // needed and ignore a tensor once all steps consuming it are
+    // pruned.
+    std::vector<size_t> step_requested_output_count;
+    step_requested_output_count.reserve(info_->steps_.size());
+    for (const auto& step : info_->steps_) {
+      step_requested_output_count.push_back(step.output_tensor_ids_.size());
+    }
+    std::vector<size_t> tensor_consumer_count;
+    tensor_consumer_count.reserve(tensor_count);
+    for (const auto& consumers : info_->tensor_consumers_) {
+      tensor_consumer_count.push_back(consumers.size());
+    }
+
     while (!ignored_tensor.empty()) {
-      std::set<std::string> new_ignored_tensor;
-      for (const auto& output : ignored_tensor) {
-        auto step_idx = info_->tensor_to_prev_step_[output];
-        auto& step = info_->steps_[step_idx];
-        auto it = step_requested_output_count.find(step_idx);
-        if (it == step_requested_output_count.end()) {
-          auto output_count = step.output_to_tensor_.size();
-          it =
-              step_requested_output_count.emplace(step_idx, output_count).first;
+      std::vector<size_t> new_ignored_tensor;
+      for (const auto tensor_id : ignored_tensor) {
+        tensor_used_[tensor_id] = false;
+        const auto step_idx = info_->tensor_prev_step_[tensor_id];
+        if (step_idx == EnsembleInfo::kNoStep) {
+          continue;
         }
         // If none of the outputs of the step is requested,
         // then the step can be pruned
-        if (--it->second == 0) {
-          for (const auto& input : step.input_to_tensor_) {
-            auto& step_set = pruned_tensor_to_step_[input.second];
-            step_set.erase(step_idx);
+        if (--step_requested_output_count[step_idx] == 0) {
+          step_needed_[step_idx] = false;
+          for (const auto input_id :
+               info_->steps_[step_idx].distinct_input_tensor_ids_) {
             // If all steps depend on a tensor are pruned,
             // then the tensor can be ignored.
-            if (step_set.empty()) {
-              new_ignored_tensor.insert(input.second);
+            if (--tensor_consumer_count[input_id] == 0) {
+              new_ignored_tensor.push_back(input_id);
             }
           }
         }
@@ -266,10 +299,6 @@ EnsembleContext::EnsembleContext(
     }
   }
 
-  for (const auto& pair : *tensor_to_step_) {
-    tensor_data_.emplace(pair.first, TensorData());
-  }
-
   if (ensemble_status_.IsOk()) {
     batch_size_ = request_->BatchSize();
     correlation_id_ = request_->CorrelationId();
@@ -278,9 +307,9 @@ EnsembleContext::EnsembleContext(
 
     for (const auto& pr : request_->ImmutableInputs()) {
       const InferenceRequest::Input* input = pr.second;
-      auto it = tensor_data_.find(input->Name());
-      if (it != tensor_data_.end()) {
-        auto& tensor_data = it->second;
+      auto it = info_->tensor_id_.find(input->Name());
+      if (it != info_->tensor_id_.end()) {
+        auto& tensor_data = tensor_data_[it->second];
         std::get<0>(tensor_data) = *input;
         std::get<1>(tensor_data) = (info_->allow_batching_ ? batch_size_ : 0);
         std::get<2>(tensor_data) = input->Data();
@@ -325,27 +354,52 @@ EnsembleContext::ResponseAlloc(
     void** buffer_userp, TRTSERVER_Memory_Type* allocated_memory_type,
     int64_t* allocated_memory_type_id)
 {
-  auto tensor_data_map = reinterpret_cast<
-      std::unordered_map<std::string, std::shared_ptr<AllocatedMemory>>*>(
-      userp);
+  auto step = reinterpret_cast<Step*>(userp);
 
   *buffer = nullptr;
   *buffer_userp = nullptr;
+  *allocated_memory_type = preferred_memory_type;
+  *allocated_memory_type_id = preferred_memory_type_id;
+
+  // Always attempt to satisfy the producing model's preferred memory
+  // type so that an output produced on a GPU stays resident on that
+  // device and is handed to the next step without a host round trip
+  // (CopyBuffer() performs a device-to-device or peer copy as needed).
+  // When the producer prefers system memory, upgrade the request to
+  // pinned memory since intermediate tensors commonly cross a GPU
+  // boundary at the next step and pinned memory allows those copies to
+  // be performed asynchronously. AllocatedMemory falls back to
+  // non-pinned system memory if the preferred type is unavailable.
+  TRTSERVER_Memory_Type allocation_memory_type = preferred_memory_type;
+  if (allocation_memory_type == TRTSERVER_MEMORY_CPU) {
+    allocation_memory_type = TRTSERVER_MEMORY_CPU_PINNED;
+  }
 
-  auto allocated_buffer = std::make_shared<AllocatedMemory>(
-      byte_size, preferred_memory_type, preferred_memory_type_id);
+  // Draw the buffer from the ensemble's tensor pool so that steady
+  // state execution reuses the buffers of earlier invocations instead
+  // of allocating.
+  std::shared_ptr<MutableMemory> allocated_buffer;
+  if (byte_size == 0) {
+    allocated_buffer = std::make_shared<AllocatedMemory>(
+        0, allocation_memory_type, preferred_memory_type_id);
+  } else {
+    allocated_buffer = step->tensor_pool_->Get(
+        byte_size, allocation_memory_type, preferred_memory_type_id);
+  }
 
-  auto mutable_buffer = allocated_buffer->MutableBuffer(
-      allocated_memory_type, allocated_memory_type_id);
-  if ((mutable_buffer != nullptr) || (byte_size == 0)) {
-    if (byte_size != 0) {
-      *buffer = static_cast<void*>(mutable_buffer);
+  if (allocated_buffer != nullptr) {
+    auto mutable_buffer = allocated_buffer->MutableBuffer(
+        allocated_memory_type, allocated_memory_type_id);
+    if ((mutable_buffer != nullptr) || (byte_size == 0)) {
+      if (byte_size != 0) {
+        *buffer = static_cast<void*>(mutable_buffer);
+      }
+      step->output_map_.emplace(tensor_name, std::move(allocated_buffer));
+      LOG_VERBOSE(1) << "Internal response allocation: " << tensor_name
+                     << ", size " << byte_size << ", addr " << *buffer
+                     << ", memory type " << *allocated_memory_type
+                     << ", type id " << *allocated_memory_type_id;
     }
-    tensor_data_map->emplace(tensor_name, std::move(allocated_buffer));
-    LOG_VERBOSE(1) << "Internal response allocation: " << tensor_name
-                   << ", size " << byte_size << ", addr " << *buffer
-                   << ", memory type " << *allocated_memory_type << ", type id "
-                   << *allocated_memory_type_id;
   }
 
   return nullptr;  // Success
@@ -390,7 +444,7 @@ EnsembleContext::PrepareSteps(
 
     if (ensemble_status_.IsOk()) {
       StepList res;
-      std::vector<std::string> updated_tensors;
+      std::vector<size_t> updated_tensors;
       ensemble_status_ = UpdateEnsembleState(completed_step, updated_tensors);
       if (ensemble_status_.IsOk()) {
         ensemble_status_ = GetNextSteps(updated_tensors, res);
@@ -410,13 +464,13 @@ EnsembleContext::PrepareSteps(
 Status
 EnsembleContext::UpdateEnsembleState(
     const std::shared_ptr<Step>& completed_step,
-    std::vector<std::string>& updated_tensors)
+    std::vector<size_t>& updated_tensors)
 {
   updated_tensors.clear();
   if (completed_step == nullptr) {
-    for (const auto& pair : tensor_data_) {
-      if (std::get<2>(pair.second) != nullptr) {
-        updated_tensors.push_back(pair.first);
+    for (size_t tensor_id = 0; tensor_id < tensor_data_.size(); tensor_id++) {
+      if (std::get<2>(tensor_data_[tensor_id]) != nullptr) {
+        updated_tensors.push_back(tensor_id);
       }
     }
   } else {
@@ -434,8 +488,16 @@ EnsembleContext::UpdateEnsembleState(
         (allow_batching ? response_header.batch_size() : 0);
     for (const auto& output : response_header.output()) {
       if (output.has_raw()) {
-        auto it = info_->steps_[step_idx].output_to_tensor_.find(output.name());
-        if (it != info_->steps_[step_idx].output_to_tensor_.end()) {
+        // Linear search, a step maps only a handful of outputs
+        const auto& output_tensor_ids =
+            info_->steps_[step_idx].output_tensor_ids_;
+        auto it = output_tensor_ids.begin();
+        for (; it != output_tensor_ids.end(); it++) {
+          if (it->first == output.name()) {
+            break;
+          }
+        }
+        if (it != output_tensor_ids.end()) {
           auto& tensor_data = tensor_data_[it->second];
           auto& meta_data = std::get<0>(tensor_data);
 
@@ -452,7 +514,7 @@ EnsembleContext::UpdateEnsembleState(
               std::move(completed_step->output_map_[it->first]);
           updated_tensors.push_back(it->second);
 
-          auto tensor_it = no_label_tensors_.find(it->second);
+          auto tensor_it = no_label_tensors_.find(info_->tensor_name_[it->second]);
           if (tensor_it != no_label_tensors_.end()) {
             // Check the inner model's lookup map first in case it is also an
             // ensemble model. In that case, the label of the inner model may
@@ -489,32 +551,24 @@ EnsembleContext::UpdateEnsembleState(
 
 Status
 EnsembleContext::GetNextSteps(
-    const std::vector<std::string>& updated_tensors, StepList& steps)
+    const std::vector<size_t>& updated_tensors, StepList& steps)
 {
   steps.clear();
 
-  std::set<size_t> next_step_idx;
-  // Get steps whose tensors used for input are set
-  for (const auto tensor_name : updated_tensors) {
-    const auto& step_idx = (*tensor_to_step_)[tensor_name];
-    for (const auto& idx : step_idx) {
-      bool ready = true;
-      for (const auto& input_pair : info_->steps_[idx].input_to_tensor_) {
-        if (std::get<2>(tensor_data_[input_pair.second]) == nullptr) {
-          ready = false;
-          break;
-        }
+  // A step becomes ready when its last missing input tensor is set.
+  // Each tensor is set exactly once so a step reaches zero exactly
+  // once.
+  for (const auto tensor_id : updated_tensors) {
+    for (const auto step_idx : info_->tensor_consumers_[tensor_id]) {
+      if (!step_needed_[step_idx]) {
+        continue;
       }
-      if (ready) {
-        next_step_idx.insert(idx);
+      if (--step_missing_inputs_[step_idx] == 0) {
+        steps.emplace_back();
+        RETURN_IF_ERROR(InitStep(step_idx, &(steps.back())));
       }
     }
   }
-
-  for (const auto& idx : next_step_idx) {
-    steps.emplace_back();
-    RETURN_IF_ERROR(InitStep(idx, &(steps.back())));
-  }
   inflight_step_counter_ += steps.size();
 
   return Status::Success;
@@ -543,7 +597,7 @@ EnsembleContext::InitStep(const size_t step_idx, std::shared_ptr<Step>* step)
   irequest->SetTimeoutMicroseconds(0);
 
   // Set inputs in request and prepare input map
-  for (const auto& pair : istep.input_to_tensor_) {
+  for (const auto& pair : istep.input_tensor_ids_) {
     const auto& other = std::get<0>(tensor_data_[pair.second]);
 
     // If the actual shape and config shape agree with each other without
@@ -563,7 +617,7 @@ EnsembleContext::InitStep(const size_t step_idx, std::shared_ptr<Step>* step)
   }
 
   // Set requested outputs in request header
-  for (const auto& pair : istep.output_to_tensor_) {
+  for (const auto& pair : istep.output_tensor_ids_) {
     irequest->AddRequestedOutput(pair.first);
   }
 
@@ -577,21 +631,34 @@ EnsembleContext::InitStep(const size_t step_idx, std::shared_ptr<Step>* step)
   step->reset(new Step(step_idx));
   (*step)->backend_ = backend;
   (*step)->request_ = std::move(irequest);
+  (*step)->tensor_pool_ = tensor_pool_;
 
   // Request header is stored in response provider as reference, so use
   // header from request provider as the providers have same lifetime
   RETURN_IF_ERROR(InferResponseProvider::Create(
       (*step)->request_, (*step)->backend_->GetLabelProvider(),
-      allocator_.get(), ResponseAlloc, &((*step)->output_map_), ResponseRelease,
+      allocator_.get(), ResponseAlloc, (*step).get(), ResponseRelease,
       1 /* protocol_version */, &((*step)->response_provider_)));
 
+  // A nested ensemble hands its output buffers over directly instead
+  // of copying them into buffers freshly allocated by ResponseAlloc.
+  // The donated block reaches tensor_data_ the same way an allocated
+  // one does, through the step's output map.
+  Step* raw_step = step->get();
+  (*step)->response_provider_->SetBufferDonationFn(
+      [raw_step](
+          const std::string& name,
+          const std::shared_ptr<Memory>& memory) -> bool {
+        return raw_step->output_map_.emplace(name, memory).second;
+      });
+
   return Status::Success;
 }
 
 size_t
 EnsembleContext::ReshapeTensorDims(
     const DimsList& config_dims, const bool allow_batching,
-    const size_t tensor_batch_size, const std::vector<int64_t>& dims,
+    const size_t tensor_batch_size, const ShapeVector& dims,
     std::vector<int64_t>* mutable_dims)
 {
   size_t batch_size = tensor_batch_size;
@@ -656,7 +723,8 @@ EnsembleContext::CheckAndSetEnsembleOutput()
       continue;
     }
     // Check if output is ready
-    const auto& tensor_data = tensor_data_[output_pair.first];
+    const auto& tensor_data =
+        tensor_data_[info_->tensor_id_[output_pair.first]];
     const auto& meta_data = std::get<0>(tensor_data);
     const auto& memory_block = std::get<2>(tensor_data);
     if (memory_block == nullptr) {
@@ -684,6 +752,16 @@ EnsembleContext::CheckAndSetEnsembleOutput()
       shape.insert(shape.begin(), batch_size_);
     }
 
+    // If the consumer accepts ownership of the buffer itself (the
+    // enclosing ensemble of a nested ensemble does) then hand the
+    // block over and skip the allocate-and-copy path. The block is
+    // not written after this point so sharing it is safe even when
+    // the same tensor backs several ensemble outputs.
+    if (response_provider_->DonateOutputBuffer(
+            output_pair.first, shape, memory_block)) {
+      continue;
+    }
+
     // Use the memory type of the memory block as preferred memory type
     TRTSERVER_Memory_Type dst_memory_type, allocated_memory_type;
     int64_t dst_memory_type_id;
@@ -813,8 +891,8 @@ EnsembleScheduler::Enqueue(
     std::function<void(const Status&)> OnComplete)
 {
   std::shared_ptr<EnsembleContext> context(new EnsembleContext(
-      is_, info_.get(), stats, request, response_provider, OnComplete,
-      stream_));
+      is_, info_.get(), stats, request, response_provider, tensor_pool_,
+      OnComplete, stream_));
   EnsembleContext::Proceed(context);
 }
 
@@ -822,6 +900,11 @@ EnsembleScheduler::EnsembleScheduler(
     InferenceServer* const server, const ModelConfig& config)
     : is_(server), stream_(nullptr)
 {
+  // Cap the bytes the ensemble may hold in recycled intermediate
+  // tensor buffers. Buffers beyond the cap are freed on release.
+  tensor_pool_ = std::make_shared<EnsembleTensorPool>(
+      1 << 26 /* max_pooled_byte_size, 64 MB */);
+
 #ifdef TRTIS_ENABLE_GPU
   // create CUDA stream
   auto cuerr = cudaStreamCreate(&stream_);
@@ -832,17 +915,32 @@ EnsembleScheduler::EnsembleScheduler(
   }
 #endif  // TRTIS_ENABLE_GPU
 
-  // Set 'info_' based on 'config'
+  // Compile the ensemble DAG from 'config'. Tensors are interned into
+  // dense ids so that the per-request state is flat vectors and step
+  // dispatch after a completion touches only the consumers of the
+  // updated tensors.
   info_.reset(new EnsembleInfo());
 
   info_->ensemble_name_ = config.name();
   info_->allow_batching_ = (config.max_batch_size() != 0);
 
+  auto info = info_.get();
+  const auto intern_tensor = [info](const std::string& name) -> size_t {
+    auto it = info->tensor_id_.find(name);
+    if (it == info->tensor_id_.end()) {
+      it = info->tensor_id_.emplace(name, info->tensor_name_.size()).first;
+      info->tensor_name_.push_back(name);
+      info->tensor_consumers_.emplace_back();
+      info->tensor_prev_step_.push_back(EnsembleInfo::kNoStep);
+    }
+    return it->second;
+  };
+
   for (const auto& input : config.input()) {
-    info_->tensor_to_step_.emplace(input.name(), std::set<size_t>());
+    intern_tensor(input.name());
   }
   for (const auto& output : config.output()) {
-    info_->tensor_to_step_.emplace(output.name(), std::set<size_t>());
+    intern_tensor(output.name());
 
     if (output.has_reshape()) {
       info_->ensemble_output_shape_[output.name()] = output.reshape().shape();
@@ -854,27 +952,24 @@ EnsembleScheduler::EnsembleScheduler(
   for (const auto& element : config.ensemble_scheduling().step()) {
     size_t step_idx = info_->steps_.size();
     info_->steps_.emplace_back(element.model_name(), element.model_version());
+    auto& step_info = info_->steps_[step_idx];
+
+    std::set<size_t> distinct_input_ids;
     for (const auto& pair : element.input_map()) {
-      auto it = info_->tensor_to_step_.find(pair.second);
-      if (it == info_->tensor_to_step_.end()) {
-        it = info_->tensor_to_step_.emplace(pair.second, std::set<size_t>())
-                 .first;
-      }
-      it->second.insert(step_idx);
-      info_->steps_[step_idx].input_to_tensor_.emplace(
-          std::make_pair(pair.first, pair.second));
+      const size_t tensor_id = intern_tensor(pair.second);
+      step_info.input_tensor_ids_.emplace_back(pair.first, tensor_id);
+      distinct_input_ids.insert(tensor_id);
+    }
+    for (const auto tensor_id : distinct_input_ids) {
+      info_->tensor_consumers_[tensor_id].push_back(step_idx);
+      step_info.distinct_input_tensor_ids_.push_back(tensor_id);
     }
+    info_->step_input_count_.push_back(distinct_input_ids.size());
 
     for (const auto& pair : element.output_map()) {
-      auto it = info_->tensor_to_step_.find(pair.second);
-      if (it == info_->tensor_to_step_.end()) {
-        it = info_->tensor_to_step_.emplace(pair.second, std::set<size_t>())
-                 .first;
-      }
-      info_->steps_[step_idx].output_to_tensor_.emplace(
-          std::make_pair(pair.first, pair.second));
-
-      info_->tensor_to_prev_step_.emplace(pair.second, step_idx);
+      const size_t tensor_id = intern_tensor(pair.second);
+      step_info.output_tensor_ids_.emplace_back(pair.first, tensor_id);
+      info_->tensor_prev_step_[tensor_id] = step_idx;
     }
   }
 }
@@ -44,9 +44,17 @@ namespace nvidia { namespace inferenceserver {
 using cudaStream_t = void*;
 #endif  // TRTIS_ENABLE_GPU
 
+class EnsembleTensorPool;
 class InferenceServer;
 
+// The ensemble DAG compiled at model load time. Ensemble tensors are
+// interned into dense ids so that the per-request bookkeeping can use
+// flat vectors indexed by tensor / step id instead of string-keyed
+// maps.
 struct EnsembleInfo {
+  // Marks a tensor that is not produced by any step (ensemble input).
+  static const size_t kNoStep = static_cast<size_t>(-1);
+
   struct StepInfo {
     StepInfo(const std::string& model_name, const int64_t model_version)
         : model_name_(model_name), model_version_(model_version)
@@ -55,8 +63,14 @@ struct EnsembleInfo {
 
     std::string model_name_;
     int64_t model_version_;
-    std::unordered_map<std::string, std::string> input_to_tensor_;
-    std::unordered_map<std::string, std::string> output_to_tensor_;
+
+    // Model input / output name paired with the id of the ensemble
+    // tensor mapped to it, in model config order.
+    std::vector<std::pair<std::string, size_t>> input_tensor_ids_;
+    std::vector<std::pair<std::string, size_t>> output_tensor_ids_;
+
+    // The distinct ids of the tensors feeding this step.
+    std::vector<size_t> distinct_input_tensor_ids_;
   };
 
   std::string ensemble_name_;
@@ -68,11 +82,20 @@ struct EnsembleInfo {
 
   std::vector<StepInfo> steps_;
 
-  // Only include a step if the ensemble tensor is used as input in that step
-  std::unordered_map<std::string, std::set<size_t>> tensor_to_step_;
+  // Interned ensemble tensors, 'tensor_id_' maps a tensor name to its
+  // dense id and 'tensor_name_' is the reverse mapping.
+  std::unordered_map<std::string, size_t> tensor_id_;
+  std::vector<std::string> tensor_name_;
 
-  // backward path, ensemble tensor to the step that provides its data
-  std::unordered_map<std::string, size_t> tensor_to_prev_step_;
+  // For each tensor id, the ids of the steps consuming the tensor.
+  std::vector<std::vector<size_t>> tensor_consumers_;
+
+  // For each tensor id, the id of the step producing the tensor, or
+  // kNoStep for ensemble inputs.
+  std::vector<size_t> tensor_prev_step_;
+
+  // For each step id, the number of distinct tensors the step waits on.
+  std::vector<size_t> step_input_count_;
 };
 
 // Scheduler that implements ensemble scheduling.
@@ -101,6 +124,10 @@ class EnsembleScheduler : public Scheduler {
   // Ensemble information that is built from model config
   std::unique_ptr<EnsembleInfo> info_;
 
+  // The pool that recycles intermediate tensor buffers across
+  // invocations of the ensemble.
+  std::shared_ptr<EnsembleTensorPool> tensor_pool_;
+
   // The stream used for data transfer.
   cudaStream_t stream_;
 };
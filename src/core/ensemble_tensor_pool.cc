@@ -0,0 +1,128 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef TRTIS_ENABLE_ENSEMBLE
+
+#include "src/core/ensemble_tensor_pool.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// Round 'byte_size' up to its size class so that buffers can be
+// recycled across invocations with slightly different shapes.
+size_t
+SizeClass(const size_t byte_size)
+{
+  size_t size_class = 512;
+  while (size_class < byte_size) {
+    size_class <<= 1;
+  }
+  return size_class;
+}
+
+}  // namespace
+
+// A buffer handed out by the pool. Exposes the requested byte size of
+// the underlying block and returns the block to the pool on
+// destruction.
+class EnsembleTensorPool::PooledMemory : public MutableMemory {
+ public:
+  PooledMemory(
+      char* buffer, const size_t byte_size,
+      const TRTSERVER_Memory_Type memory_type, const int64_t memory_type_id,
+      std::unique_ptr<AllocatedMemory>&& block,
+      const std::shared_ptr<EnsembleTensorPool>& pool)
+      : MutableMemory(buffer, byte_size, memory_type, memory_type_id),
+        block_(std::move(block)), pool_(pool)
+  {
+  }
+
+  ~PooledMemory() override { pool_->Release(std::move(block_)); }
+
+ private:
+  std::unique_ptr<AllocatedMemory> block_;
+  std::shared_ptr<EnsembleTensorPool> pool_;
+};
+
+std::shared_ptr<MutableMemory>
+EnsembleTensorPool::Get(
+    const size_t byte_size, const TRTSERVER_Memory_Type memory_type,
+    const int64_t memory_type_id)
+{
+  const size_t size_class = SizeClass(byte_size);
+
+  std::unique_ptr<AllocatedMemory> block;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it =
+        free_blocks_.find(SizeClassKey(memory_type, memory_type_id, size_class));
+    if ((it != free_blocks_.end()) && !it->second.empty()) {
+      block = std::move(it->second.back());
+      it->second.pop_back();
+      pooled_byte_size_ -= block->TotalByteSize();
+    }
+  }
+
+  if (block == nullptr) {
+    block.reset(new AllocatedMemory(size_class, memory_type, memory_type_id));
+  }
+
+  TRTSERVER_Memory_Type actual_memory_type;
+  int64_t actual_memory_type_id;
+  char* buffer =
+      block->MutableBuffer(&actual_memory_type, &actual_memory_type_id);
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+
+  return std::shared_ptr<MutableMemory>(new PooledMemory(
+      buffer, byte_size, actual_memory_type, actual_memory_type_id,
+      std::move(block), shared_from_this()));
+}
+
+void
+EnsembleTensorPool::Release(std::unique_ptr<AllocatedMemory> block)
+{
+  TRTSERVER_Memory_Type memory_type;
+  int64_t memory_type_id;
+  block->MutableBuffer(&memory_type, &memory_type_id);
+  const size_t byte_size = block->TotalByteSize();
+
+  std::lock_guard<std::mutex> lock(mtx_);
+  if ((pooled_byte_size_ + byte_size) > max_pooled_byte_size_) {
+    // The pool is at capacity, let the block be freed.
+    return;
+  }
+
+  pooled_byte_size_ += byte_size;
+  free_blocks_[SizeClassKey(memory_type, memory_type_id, byte_size)]
+      .emplace_back(std::move(block));
+}
+
+}}  // namespace nvidia::inferenceserver
+
+#endif  // TRTIS_ENABLE_ENSEMBLE
@@ -0,0 +1,86 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#ifdef TRTIS_ENABLE_ENSEMBLE
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "src/core/memory.h"
+
+namespace nvidia { namespace inferenceserver {
+
+// A pool of buffers backing the intermediate tensors of an ensemble.
+// Buffers are recycled across ensemble invocations so that in steady
+// state an ensemble serves its internal responses without allocating.
+// Buffers are grouped into power-of-two size classes per memory type
+// and device; a buffer is returned to the pool when the memory object
+// handed out by Get() is destroyed. The pool must be owned by a
+// shared_ptr since outstanding buffers keep a reference to it.
+class EnsembleTensorPool
+    : public std::enable_shared_from_this<EnsembleTensorPool> {
+ public:
+  explicit EnsembleTensorPool(const size_t max_pooled_byte_size)
+      : max_pooled_byte_size_(max_pooled_byte_size), pooled_byte_size_(0)
+  {
+  }
+
+  // Get a buffer of 'byte_size' bytes with the given memory type and
+  // id, reusing a pooled buffer when one is available. Like
+  // AllocatedMemory, the buffer may be created on a different memory
+  // type and id if the request cannot be satisfied, so the caller
+  // should always check the actual memory type before use. Return
+  // nullptr if no buffer can be obtained.
+  std::shared_ptr<MutableMemory> Get(
+      const size_t byte_size, const TRTSERVER_Memory_Type memory_type,
+      const int64_t memory_type_id);
+
+ private:
+  class PooledMemory;
+
+  // Size classes are keyed by memory type, memory type id and class
+  // byte size.
+  using SizeClassKey = std::tuple<TRTSERVER_Memory_Type, int64_t, size_t>;
+
+  // Return 'block' to the pool. The block is freed instead if pooling
+  // it would exceed the pool capacity.
+  void Release(std::unique_ptr<AllocatedMemory> block);
+
+  const size_t max_pooled_byte_size_;
+
+  std::mutex mtx_;
+  size_t pooled_byte_size_;
+  std::map<SizeClassKey, std::vector<std::unique_ptr<AllocatedMemory>>>
+      free_blocks_;
+};
+
+}}  // namespace nvidia::inferenceserver
+
+#endif  // TRTIS_ENABLE_ENSEMBLE
@@ -101,20 +101,68 @@ ValidateTensorConsistency(
   return Status::Success;
 }
 
+/// The signature of a single model tensor, enough to build a
+/// TensorNode for it without consulting the model config again.
+struct TensorSignature {
+  DataType type_;
+  DimsList dims_;
+  // The number of config tensors that use this name. Greater than one
+  // only for a malformed config with duplicate tensor names.
+  size_t name_cnt_;
+};
+
+/// Per-model tensor signature tables. Built once per validation pass
+/// for each distinct model and shared by every affected ensemble, so
+/// validating a step is hash lookups instead of a scan over the model
+/// config.
+struct ModelSignatureTable {
+  std::unordered_map<std::string, TensorSignature> inputs_;
+  std::unordered_map<std::string, TensorSignature> outputs_;
+};
+
+using SignatureIndex = std::unordered_map<std::string, ModelSignatureTable>;
+
+const ModelSignatureTable&
+GetSignatureTable(
+    const std::string& model_name, const ModelConfig& model_config,
+    SignatureIndex* signature_index)
+{
+  auto it = signature_index->find(model_name);
+  if (it == signature_index->end()) {
+    ModelSignatureTable table;
+    for (const auto& model_input : model_config.input()) {
+      auto res = table.inputs_.emplace(
+          model_input.name(),
+          TensorSignature{model_input.data_type(), model_input.dims(), 1});
+      if (!res.second) {
+        res.first->second.name_cnt_++;
+      }
+    }
+    for (const auto& model_output : model_config.output()) {
+      auto res = table.outputs_.emplace(
+          model_output.name(),
+          TensorSignature{model_output.data_type(), model_output.dims(), 1});
+      if (!res.second) {
+        res.first->second.name_cnt_++;
+      }
+    }
+
+    it = signature_index->emplace(model_name, std::move(table)).first;
+  }
+
+  return it->second;
+}
+
 Status
 ValidateTensorMapping(
     const std::string& ensemble, const ModelEnsembling::Step& step,
-    const ModelConfig& model_config,
+    const ModelConfig& model_config, const ModelSignatureTable& signatures,
     std::unordered_map<std::string, TensorNode>* ensemble_tensors)
 {
   const bool batching = (model_config.max_batch_size() > 0);
   // Check all inputs are mapped and no mapping to invalid inputs
-  std::set<std::string> input_names;
-  for (const auto& model_input : model_config.input()) {
-    input_names.insert(model_input.name());
-  }
   for (const auto& input_map : step.input_map()) {
-    if (input_names.find(input_map.first) == input_names.end()) {
+    if (signatures.inputs_.find(input_map.first) == signatures.inputs_.end()) {
       return Status(
           Status::Code::INVALID_ARG,
           "in ensemble " + ensemble + ", ensemble tensor " + input_map.second +
@@ -122,49 +170,35 @@ ValidateTensorMapping(
               " in model " + step.model_name());
     }
   }
-  for (const auto& model_input : model_config.input()) {
-    size_t mapped_cnt = 0;
-    for (const auto& input_map : step.input_map()) {
-      if (model_input.name() == input_map.first) {
-        TensorNode model_tensor(
-            step.model_name(), batching, model_input.data_type(),
-            model_input.dims());
-        auto it = ensemble_tensors->find(input_map.second);
-        if (it != ensemble_tensors->end()) {
-          RETURN_IF_ERROR(ValidateTensorConsistency(
-              it->second, model_tensor,
-              "in ensemble " + ensemble + ", ensemble tensor " +
-                  input_map.second + ": "));
-        } else {
-          ensemble_tensors->emplace(
-              std::make_pair(input_map.second, model_tensor));
-        }
-        mapped_cnt++;
-      }
-    }
-    if (mapped_cnt == 0) {
+  for (const auto& model_input : signatures.inputs_) {
+    if (step.input_map().find(model_input.first) == step.input_map().end()) {
       return Status(
           Status::Code::INVALID_ARG,
-          "in ensemble " + ensemble + ", input " + model_input.name() +
+          "in ensemble " + ensemble + ", input " + model_input.first +
               " in model " + model_config.name() +
               " is not mapped to any ensemble tensors");
-    } else if (mapped_cnt > 1) {
-      return Status(
-          Status::Code::INVALID_ARG,
-          "in ensemble " + ensemble + ", input " + model_input.name() +
-              " in model " + model_config.name() +
-              " is mapped to multiple ensemble tensors");
+    }
+  }
+  for (const auto& input_map : step.input_map()) {
+    const auto& signature = signatures.inputs_.find(input_map.first)->second;
+    TensorNode model_tensor(
+        step.model_name(), batching, signature.type_, signature.dims_);
+    auto it = ensemble_tensors->find(input_map.second);
+    if (it != ensemble_tensors->end()) {
+      RETURN_IF_ERROR(ValidateTensorConsistency(
+          it->second, model_tensor,
+          "in ensemble " + ensemble + ", ensemble tensor " + input_map.second +
+              ": "));
+    } else {
+      ensemble_tensors->emplace(std::make_pair(input_map.second, model_tensor));
     }
   }
 
   // Check no multiple mappings to same ensemble tensor
   // and no mapping from invalid outputs
-  std::set<std::string> output_names;
-  for (const auto& model_output : model_config.output()) {
-    output_names.insert(model_output.name());
-  }
   for (const auto& output_map : step.output_map()) {
-    if (output_names.find(output_map.first) == output_names.end()) {
+    if (signatures.outputs_.find(output_map.first) ==
+        signatures.outputs_.end()) {
       return Status(
           Status::Code::INVALID_ARG,
           "in ensemble " + ensemble + ", ensemble tensor " + output_map.second +
@@ -173,32 +207,26 @@ ValidateTensorMapping(
     }
   }
   for (const auto& output_map : step.output_map()) {
-    size_t mapped_cnt = 0;
-    for (const auto& model_output : model_config.output()) {
-      if (model_output.name() == output_map.first) {
-        TensorNode model_tensor(
-            step.model_name(), batching, model_output.data_type(),
-            model_output.dims());
-        auto it = ensemble_tensors->find(output_map.second);
-        if (it != ensemble_tensors->end()) {
-          RETURN_IF_ERROR(ValidateTensorConsistency(
-              it->second, model_tensor,
-              "in ensemble " + ensemble + ", ensemble tensor " +
-                  output_map.second + ": "));
-        } else {
-          ensemble_tensors->emplace(
-              std::make_pair(output_map.second, model_tensor));
-        }
-        mapped_cnt++;
-      }
-    }
-    if (mapped_cnt > 1) {
+    const auto& signature = signatures.outputs_.find(output_map.first)->second;
+    if (signature.name_cnt_ > 1) {
       return Status(
           Status::Code::INVALID_ARG,
           "in ensemble " + ensemble + ", multiple outputs in model " +
               model_config.name() + " are mapped to the same ensemble tensor " +
               output_map.second);
     }
+
+    TensorNode model_tensor(
+        step.model_name(), batching, signature.type_, signature.dims_);
+    auto it = ensemble_tensors->find(output_map.second);
+    if (it != ensemble_tensors->end()) {
+      RETURN_IF_ERROR(ValidateTensorConsistency(
+          it->second, model_tensor,
+          "in ensemble " + ensemble + ", ensemble tensor " + output_map.second +
+              ": "));
+    } else {
+      ensemble_tensors->emplace(std::make_pair(output_map.second, model_tensor));
+    }
   }
 
   // link ensemble tensors
@@ -219,7 +247,8 @@ ValidateEnsembleConfig(
     std::unordered_map<
         std::string, std::pair<ModelRepositoryManager::DependencyNode*, bool>>*
         ensembles,
-    std::deque<std::string>* ensemble_dependency)
+    std::deque<std::string>* ensemble_dependency,
+    SignatureIndex* signature_index)
 {
   const auto& ensemble_name = ensemble->model_name_;
   if (!ensemble->missing_upstreams_.empty()) {
@@ -299,7 +328,8 @@ ValidateEnsembleConfig(
         if (it->second.second == false) {
           ensemble_dependency->push_back(ensemble_name);
           it->second.first->status_ = ValidateEnsembleConfig(
-              it->second.first, ensembles, ensemble_dependency);
+              it->second.first, ensembles, ensemble_dependency,
+              signature_index);
           it->second.second = true;
           ensemble_dependency->pop_back();
           if (!it->second.first->status_.IsOk()) {
@@ -312,8 +342,10 @@ ValidateEnsembleConfig(
       }
     }
 
+    const auto& signatures =
+        GetSignatureTable(model_name, model_config, signature_index);
     RETURN_IF_ERROR(ValidateTensorMapping(
-        ensemble_name, step, model_config, &ensemble_tensors));
+        ensemble_name, step, model_config, signatures, &ensemble_tensors));
   }
 
   return Status::Success;
@@ -335,6 +367,11 @@ ValidateEnsembleConfig(
         std::make_pair(node->model_name_, std::make_pair(node, false)));
   }
 
+  // The per-model signature tables are shared across all affected
+  // ensembles in this pass, so each distinct model's config is
+  // scanned at most once no matter how many ensembles reference it.
+  SignatureIndex signature_index;
+
   std::deque<std::string> ensemble_dependency;
   for (auto& pair : ensembles) {
     if (pair.second.second) {
@@ -342,7 +379,7 @@ ValidateEnsembleConfig(
     }
     // return not ok status if ensemble config is not valid
     pair.second.first->status_ = ValidateEnsembleConfig(
-        pair.second.first, &ensembles, &ensemble_dependency);
+        pair.second.first, &ensembles, &ensemble_dependency, &signature_index);
     pair.second.second = true;
   }
 }
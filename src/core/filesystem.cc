@@ -41,21 +41,175 @@
 #include <aws/s3/model/ListObjectsRequest.h>
 #endif  // TRTIS_ENABLE_S3
 
+#ifdef TRTIS_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif  // TRTIS_ENABLE_GPU
+
+#include <fcntl.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/text_format.h>
 #include <re2/re2.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#include <linux/io_uring.h>
+#define TRTIS_ENABLE_IO_URING 1
+#endif
+#endif  // __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cerrno>
+#include <chrono>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "src/core/constants.h"
+#include "src/core/logging.h"
 
 namespace nvidia { namespace inferenceserver {
 
 namespace {
 
+// Load read-bandwidth throttle, see ScopedReadThrottle in
+// filesystem.h. Reads on a throttled thread pay their byte count
+// into a shared token bucket and sleep off any debt, so all
+// concurrent loads together stay under the configured rate.
+uint64_t
+LoadReadBandwidthBytesPerSecond()
+{
+  static const uint64_t bytes_per_second = []() -> uint64_t {
+    const char* bstr = getenv("TRTSERVER_LOAD_READ_BANDWIDTH_MBS");
+    if (bstr == nullptr) {
+      return 0;
+    }
+    return strtoull(bstr, nullptr, 10) * 1024 * 1024;
+  }();
+  return bytes_per_second;
+}
+
+thread_local bool read_throttle_enabled = false;
+
+std::mutex read_throttle_mtx;
+double read_throttle_tokens = 0;
+uint64_t read_throttle_last_ns = 0;
+
+// The pacing granularity for throttled reads. Large files are read
+// in chunks of this size with a bucket charge per chunk, so live
+// traffic never waits behind more than one chunk on the device.
+constexpr size_t kReadThrottleChunkByteSize = 8 * 1024 * 1024;
+
+bool
+ReadThrottleActive()
+{
+  return read_throttle_enabled && (LoadReadBandwidthBytesPerSecond() != 0);
+}
+
+// Charge 'byte_size' bytes to the token bucket and block until the
+// read is within the configured bandwidth. No-op when the calling
+// thread is not throttled.
+void
+ThrottleRead(const uint64_t byte_size)
+{
+  if (!ReadThrottleActive()) {
+    return;
+  }
+
+  const double bytes_per_second = LoadReadBandwidthBytesPerSecond();
+  double wait_seconds = 0;
+  {
+    std::lock_guard<std::mutex> lk(read_throttle_mtx);
+    const uint64_t now_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    if (read_throttle_last_ns != 0) {
+      read_throttle_tokens = std::min(
+          bytes_per_second,
+          read_throttle_tokens +
+              ((now_ns - read_throttle_last_ns) / 1e9) * bytes_per_second);
+    } else {
+      // The bucket starts full so the first small reads of a load
+      // (config files, version directories) are not delayed.
+      read_throttle_tokens = bytes_per_second;
+    }
+    read_throttle_last_ns = now_ns;
+    read_throttle_tokens -= byte_size;
+    if (read_throttle_tokens < 0) {
+      wait_seconds = -read_throttle_tokens / bytes_per_second;
+    }
+  }
+  if (wait_seconds > 0) {
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(wait_seconds));
+  }
+}
+
+// MappedFile implementation that holds the file contents in a buffer,
+// used for filesystems that can't provide a memory mapping.
+class BufferedFile : public MappedFile {
+ public:
+  explicit BufferedFile(std::string&& contents)
+      : contents_(std::move(contents))
+  {
+  }
+  const char* Data() const override { return contents_.data(); }
+  size_t ByteSize() const override { return contents_.size(); }
+
+ private:
+  const std::string contents_;
+};
+
+// MappedFile implementation backed by a mmap'ed region of a local
+// file. The region is unmapped when the object is destroyed.
+class MmapFile : public MappedFile {
+ public:
+  MmapFile(void* base, size_t byte_size) : base_(base), byte_size_(byte_size)
+  {
+  }
+  ~MmapFile() override { munmap(base_, byte_size_); }
+  const char* Data() const override
+  {
+    return reinterpret_cast<const char*>(base_);
+  }
+  size_t ByteSize() const override { return byte_size_; }
+
+ private:
+  void* base_;
+  const size_t byte_size_;
+};
+
+#ifdef TRTIS_ENABLE_GPU
+// MappedFile implementation backed by a pinned host allocation that
+// the file contents were read into, so that device uploads of the
+// contents run at full transfer bandwidth without faulting pages in
+// from a file-backed mapping.
+class PinnedFile : public MappedFile {
+ public:
+  PinnedFile(char* base, size_t byte_size)
+      : MappedFile(true /* permanently_pinned */), base_(base),
+        byte_size_(byte_size)
+  {
+  }
+  ~PinnedFile() override { cudaFreeHost(base_); }
+  const char* Data() const override { return base_; }
+  size_t ByteSize() const override { return byte_size_; }
+
+ private:
+  char* base_;
+  const size_t byte_size_;
+};
+#endif  // TRTIS_ENABLE_GPU
+
 class FileSystem {
  public:
   virtual Status FileExists(const std::string& path, bool* exists) = 0;
@@ -70,6 +224,18 @@ class FileSystem {
       const std::string& path, std::set<std::string>* files) = 0;
   virtual Status ReadTextFile(
       const std::string& path, std::string* contents) = 0;
+  virtual Status MapFile(
+      const std::string& path, const bool pinned_memory_preferred,
+      std::shared_ptr<MappedFile>* mapped)
+  {
+    // By default read the contents into a buffer. Filesystems that
+    // can map the file directly or honor the pinned-memory preference
+    // should override.
+    std::string contents;
+    RETURN_IF_ERROR(ReadTextFile(path, &contents));
+    mapped->reset(new BufferedFile(std::move(contents)));
+    return Status::Success;
+  }
   virtual Status DownloadFileFolder(
       const std::string& path, std::string* local_path) = 0;
   virtual Status DestroyFileFolder(const std::string& path) = 0;
@@ -90,6 +256,9 @@ class LocalFileSystem : public FileSystem {
   Status GetDirectoryFiles(
       const std::string& path, std::set<std::string>* files) override;
   Status ReadTextFile(const std::string& path, std::string* contents) override;
+  Status MapFile(
+      const std::string& path, const bool pinned_memory_preferred,
+      std::shared_ptr<MappedFile>* mapped) override;
   Status DownloadFileFolder(
       const std::string& path, std::string* local_path) override;
   Status DestroyFileFolder(const std::string& path) override;
@@ -194,9 +363,264 @@ LocalFileSystem::GetDirectoryFiles(
   return Status::Success;
 }
 
+#ifdef TRTIS_ENABLE_IO_URING
+// The number of chunk reads kept in flight per file. Deep enough to
+// keep an NVMe device busy, shallow enough that the rings stay small.
+constexpr unsigned kIoUringQueueDepth = 64;
+
+// The size of each chunk read submitted to the ring.
+constexpr size_t kIoUringChunkByteSize = 1024 * 1024;
+
+// Files smaller than this are read with the plain synchronous path,
+// the ring setup cost isn't worth it below two chunks.
+constexpr size_t kIoUringMinFileByteSize = 2 * kIoUringChunkByteSize;
+
+int
+SysIoUringSetup(unsigned entries, struct io_uring_params* params)
+{
+  return syscall(__NR_io_uring_setup, entries, params);
+}
+
+int
+SysIoUringEnter(
+    int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+  return syscall(
+      __NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr,
+      0);
+}
+
+// Read 'byte_size' bytes from 'fd' into 'dst' by keeping up to
+// 'kIoUringQueueDepth' chunk reads in flight on an io_uring, instead
+// of a single synchronous read that leaves the device queue depth at
+// one. Return false if the ring can't be set up (e.g. the kernel
+// predates io_uring) or any read fails; the caller falls back to the
+// synchronous path. Each call uses its own ring so concurrent model
+// loads each submit their own batch of reads.
+bool
+IoUringRead(int fd, char* dst, const size_t byte_size)
+{
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  const int ring_fd = SysIoUringSetup(kIoUringQueueDepth, &params);
+  if (ring_fd < 0) {
+    return false;
+  }
+
+  // Map the submission ring, the completion ring and the SQE array.
+  // The rings are mapped separately, which works both before and
+  // after kernels that back them with a single region.
+  const size_t sq_ring_byte_size =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  const size_t cq_ring_byte_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const size_t sqes_byte_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  void* sq_ptr = mmap(
+      nullptr, sq_ring_byte_size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ptr == MAP_FAILED) {
+    close(ring_fd);
+    return false;
+  }
+
+  void* cq_ptr = mmap(
+      nullptr, cq_ring_byte_size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+  if (cq_ptr == MAP_FAILED) {
+    munmap(sq_ptr, sq_ring_byte_size);
+    close(ring_fd);
+    return false;
+  }
+
+  struct io_uring_sqe* sqes = reinterpret_cast<struct io_uring_sqe*>(mmap(
+      nullptr, sqes_byte_size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+  if (sqes == reinterpret_cast<struct io_uring_sqe*>(MAP_FAILED)) {
+    munmap(cq_ptr, cq_ring_byte_size);
+    munmap(sq_ptr, sq_ring_byte_size);
+    close(ring_fd);
+    return false;
+  }
+
+  unsigned* sq_head = reinterpret_cast<unsigned*>(
+      reinterpret_cast<char*>(sq_ptr) + params.sq_off.head);
+  unsigned* sq_tail = reinterpret_cast<unsigned*>(
+      reinterpret_cast<char*>(sq_ptr) + params.sq_off.tail);
+  unsigned* sq_mask = reinterpret_cast<unsigned*>(
+      reinterpret_cast<char*>(sq_ptr) + params.sq_off.ring_mask);
+  unsigned* sq_array = reinterpret_cast<unsigned*>(
+      reinterpret_cast<char*>(sq_ptr) + params.sq_off.array);
+  unsigned* cq_head = reinterpret_cast<unsigned*>(
+      reinterpret_cast<char*>(cq_ptr) + params.cq_off.head);
+  unsigned* cq_tail = reinterpret_cast<unsigned*>(
+      reinterpret_cast<char*>(cq_ptr) + params.cq_off.tail);
+  unsigned* cq_mask = reinterpret_cast<unsigned*>(
+      reinterpret_cast<char*>(cq_ptr) + params.cq_off.ring_mask);
+  struct io_uring_cqe* cqes = reinterpret_cast<struct io_uring_cqe*>(
+      reinterpret_cast<char*>(cq_ptr) + params.cq_off.cqes);
+
+  // One slot per SQE. A slot holds the range its in-flight read
+  // covers and the iovec describing it; SQE 'i' is always paired with
+  // slot 'i' so user_data is just the slot index.
+  struct Slot {
+    size_t offset_;
+    size_t len_;
+  };
+  const unsigned depth = params.sq_entries;
+  std::vector<Slot> slots(depth);
+  std::vector<struct iovec> iovs(depth);
+  std::vector<unsigned> free_slots;
+  std::vector<unsigned> retry_slots;
+  for (unsigned i = 0; i < depth; ++i) {
+    free_slots.push_back(i);
+  }
+
+  size_t next_offset = 0;
+  size_t completed_byte_size = 0;
+  // Every SQE the kernel consumes eventually produces exactly one
+  // CQE. Counting the reaped CQEs against the free-running SQ head
+  // tells how many reads are still in flight, see the drain below.
+  unsigned reaped_cnt = 0;
+  bool ok = true;
+
+  while (ok && (completed_byte_size < byte_size)) {
+    // Fill the submission ring... short reads being retried first,
+    // then new chunks.
+    unsigned tail = *sq_tail;
+    unsigned to_submit = 0;
+    while (!retry_slots.empty() ||
+           (!free_slots.empty() && (next_offset < byte_size))) {
+      unsigned slot;
+      if (!retry_slots.empty()) {
+        slot = retry_slots.back();
+        retry_slots.pop_back();
+      } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        slots[slot].offset_ = next_offset;
+        slots[slot].len_ =
+            std::min(kIoUringChunkByteSize, byte_size - next_offset);
+        next_offset += slots[slot].len_;
+      }
+
+      iovs[slot].iov_base = dst + slots[slot].offset_;
+      iovs[slot].iov_len = slots[slot].len_;
+
+      struct io_uring_sqe* sqe = &sqes[slot];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = IORING_OP_READV;
+      sqe->fd = fd;
+      sqe->addr = reinterpret_cast<unsigned long>(&iovs[slot]);
+      sqe->len = 1;
+      sqe->off = slots[slot].offset_;
+      sqe->user_data = slot;
+
+      sq_array[tail & *sq_mask] = slot;
+      tail++;
+      to_submit++;
+    }
+
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+    // A signal can interrupt the completion wait with EINTR in
+    // normal operation; retry instead of abandoning the overlapped
+    // read. Re-entering with the same count is safe because the
+    // kernel only consumes entries still in the ring.
+    int enter_status;
+    do {
+      enter_status =
+          SysIoUringEnter(ring_fd, to_submit, 1, IORING_ENTER_GETEVENTS);
+    } while ((enter_status < 0) && (errno == EINTR));
+    if (enter_status < 0) {
+      ok = false;
+      break;
+    }
+
+    // Reap completions.
+    unsigned head = *cq_head;
+    const unsigned reap_tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    while (head != reap_tail) {
+      const struct io_uring_cqe* cqe = &cqes[head & *cq_mask];
+      const unsigned slot = static_cast<unsigned>(cqe->user_data);
+      if (cqe->res <= 0) {
+        ok = false;
+      } else {
+        const size_t read_byte_size = static_cast<size_t>(cqe->res);
+        completed_byte_size += read_byte_size;
+        if (read_byte_size < slots[slot].len_) {
+          slots[slot].offset_ += read_byte_size;
+          slots[slot].len_ -= read_byte_size;
+          retry_slots.push_back(slot);
+        } else {
+          free_slots.push_back(slot);
+        }
+      }
+
+      reaped_cnt++;
+      head++;
+    }
+
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+  }
+
+  // On a failure path some chunk reads may still be in flight, and
+  // closing the ring fd neither cancels nor waits for them: the
+  // kernel would keep writing into 'dst' after the caller has reused
+  // or freed it. Reap until every consumed SQE has produced its
+  // completion before tearing the ring down. The wait is retried on
+  // any error, EINTR included, because returning with reads
+  // outstanding is never safe.
+  while (__atomic_load_n(sq_head, __ATOMIC_ACQUIRE) != reaped_cnt) {
+    SysIoUringEnter(ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+
+    unsigned head = *cq_head;
+    const unsigned reap_tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    while (head != reap_tail) {
+      reaped_cnt++;
+      head++;
+    }
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+  }
+
+  munmap(reinterpret_cast<void*>(sqes), sqes_byte_size);
+  munmap(cq_ptr, cq_ring_byte_size);
+  munmap(sq_ptr, sq_ring_byte_size);
+  close(ring_fd);
+
+  return ok && (completed_byte_size == byte_size);
+}
+#endif  // TRTIS_ENABLE_IO_URING
+
 Status
 LocalFileSystem::ReadTextFile(const std::string& path, std::string* contents)
 {
+#ifdef TRTIS_ENABLE_IO_URING
+  // Read large files through io_uring so the chunk reads overlap on
+  // the device instead of arriving one at a time. Any failure falls
+  // through to the synchronous path below, which also surfaces the
+  // error for a genuinely unreadable file. When the calling thread is
+  // read-throttled the overlapped path is skipped: the point of the
+  // throttle is to leave device bandwidth for live traffic, so the
+  // paced synchronous path below is used instead.
+  if (!ReadThrottleActive()) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd != -1) {
+      struct stat st;
+      if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) &&
+          (static_cast<size_t>(st.st_size) >= kIoUringMinFileByteSize)) {
+        contents->resize(st.st_size);
+        if (IoUringRead(fd, &(*contents)[0], contents->size())) {
+          close(fd);
+          return Status::Success;
+        }
+      }
+
+      close(fd);
+    }
+  }
+#endif  // TRTIS_ENABLE_IO_URING
+
   std::ifstream in(path, std::ios::in | std::ios::binary);
   if (!in) {
     return Status(
@@ -207,12 +631,119 @@ LocalFileSystem::ReadTextFile(const std::string& path, std::string* contents)
   in.seekg(0, std::ios::end);
   contents->resize(in.tellg());
   in.seekg(0, std::ios::beg);
-  in.read(&(*contents)[0], contents->size());
+  if (ReadThrottleActive()) {
+    // Read in chunks with a bucket charge per chunk so the configured
+    // load bandwidth is enforced within the file, not just across
+    // files.
+    size_t offset = 0;
+    while (offset < contents->size()) {
+      const size_t chunk_byte_size =
+          std::min(kReadThrottleChunkByteSize, contents->size() - offset);
+      ThrottleRead(chunk_byte_size);
+      in.read(&(*contents)[offset], chunk_byte_size);
+      offset += chunk_byte_size;
+    }
+  } else {
+    in.read(&(*contents)[0], contents->size());
+  }
   in.close();
 
   return Status::Success;
 }
 
+Status
+LocalFileSystem::MapFile(
+    const std::string& path, const bool pinned_memory_preferred,
+    std::shared_ptr<MappedFile>* mapped)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return Status(
+        Status::Code::INTERNAL,
+        "failed to open file for mapping " + path + ": " + strerror(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    close(fd);
+    return Status(
+        Status::Code::INTERNAL,
+        "failed to stat file " + path + ": " + strerror(errno));
+  }
+
+  // Can't mmap a zero-length region, represent an empty file with an
+  // empty buffer.
+  if (st.st_size == 0) {
+    close(fd);
+    mapped->reset(new BufferedFile(std::string()));
+    return Status::Success;
+  }
+
+#ifdef TRTIS_ENABLE_GPU
+  // Read the contents directly into a pinned allocation when the
+  // caller prefers it. Device uploads of the contents then DMA
+  // straight from the read destination, and the overlapped chunk
+  // reads fill the buffer at device bandwidth instead of the contents
+  // being faulted in page by page from a file-backed mapping. Any
+  // failure just falls through to the mmap path below.
+  if (pinned_memory_preferred) {
+    char* pinned_base = nullptr;
+    cudaError_t cuerr = cudaHostAlloc(
+        reinterpret_cast<void**>(&pinned_base), st.st_size,
+        cudaHostAllocDefault);
+    if (cuerr != cudaSuccess) {
+      LOG_VERBOSE(1) << "unable to allocate pinned buffer for " << path << ": "
+                     << cudaGetErrorString(cuerr);
+    } else {
+      bool read_ok = false;
+#ifdef TRTIS_ENABLE_IO_URING
+      read_ok = IoUringRead(fd, pinned_base, st.st_size);
+#endif  // TRTIS_ENABLE_IO_URING
+      if (!read_ok) {
+        size_t read_offset = 0;
+        read_ok = true;
+        while (read_offset < static_cast<size_t>(st.st_size)) {
+          const ssize_t read_byte_size = pread(
+              fd, pinned_base + read_offset, st.st_size - read_offset,
+              read_offset);
+          if (read_byte_size <= 0) {
+            read_ok = false;
+            break;
+          }
+
+          read_offset += read_byte_size;
+        }
+      }
+
+      if (read_ok) {
+        close(fd);
+        mapped->reset(new PinnedFile(pinned_base, st.st_size));
+        return Status::Success;
+      }
+
+      cudaFreeHost(pinned_base);
+    }
+  }
+#endif  // TRTIS_ENABLE_GPU
+
+  void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return Status(
+        Status::Code::INTERNAL,
+        "failed to mmap file " + path + ": " + strerror(errno));
+  }
+
+  // Advise the kernel that the mapping will be consumed front-to-back
+  // so it reads ahead aggressively. Failure to advise is not an
+  // error, the mapping is just read without the hints.
+  madvise(base, st.st_size, MADV_SEQUENTIAL);
+  madvise(base, st.st_size, MADV_WILLNEED);
+
+  mapped->reset(new MmapFile(base, st.st_size));
+  return Status::Success;
+}
+
 Status
 LocalFileSystem::DownloadFileFolder(
     const std::string& path, std::string* local_path)
@@ -571,6 +1102,16 @@ GCSFileSystem::WriteTextFile(
 
 namespace s3 = Aws::S3;
 
+// Objects at least this large are downloaded in parallel ranged parts.
+constexpr int64_t kS3MultipartDownloadThreshold = 64 * 1024 * 1024;
+
+// The size of each ranged part of a multipart download.
+constexpr int64_t kS3DownloadPartByteSize = 32 * 1024 * 1024;
+
+// The maximum number of threads used to download files of a folder or
+// parts of a large file.
+constexpr size_t kS3MaxDownloadThreads = 8;
+
 class S3FileSystem : public FileSystem {
  public:
   S3FileSystem(const Aws::SDKOptions& options, const std::string& s3_path);
@@ -595,9 +1136,20 @@ class S3FileSystem : public FileSystem {
  private:
   Status ParsePath(
       const std::string& path, std::string* bucket, std::string* object);
+  Status DownloadFile(
+      const std::string& bucket, const std::string& object,
+      const std::string& local_file_path);
+  Status DownloadFileParts(
+      const std::string& bucket, const std::string& object,
+      const std::string& local_file_path, const int64_t total_byte_size);
+
   Aws::SDKOptions options_;
   s3::S3Client client_;
   re2::RE2 s3_regex_;
+
+  // Directory holding previously downloaded objects keyed by their
+  // ETag, or empty if the download cache is disabled.
+  std::string cache_path_;
 };
 
 Status
@@ -653,6 +1205,18 @@ S3FileSystem::S3FileSystem(
   client_ = s3::S3Client(
       config, Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
       /*useVirtualAdressing*/ false);
+
+  // Enable the local download cache if requested. Downloaded objects
+  // are kept keyed by their ETag so that unchanged model versions are
+  // not re-fetched on later downloads.
+  if (const char* cache_path = std::getenv("TRTSERVER_S3_CACHE_PATH")) {
+    if ((mkdir(cache_path, S_IRWXU) == 0) || (errno == EEXIST)) {
+      cache_path_ = cache_path;
+    } else {
+      LOG_ERROR << "Failed to create S3 download cache directory '"
+                << cache_path << "': " << strerror(errno);
+    }
+  }
 }
 
 S3FileSystem::~S3FileSystem()
@@ -886,6 +1450,176 @@ S3FileSystem::ReadTextFile(const std::string& path, std::string* contents)
   return Status::Success;
 }
 
+Status
+S3FileSystem::DownloadFile(
+    const std::string& bucket, const std::string& object,
+    const std::string& local_file_path)
+{
+  // Get the object metadata so that the download can be sized and,
+  // when the cache is enabled, keyed by the object ETag.
+  s3::Model::HeadObjectRequest head_request;
+  head_request.SetBucket(bucket.c_str());
+  head_request.SetKey(object.c_str());
+
+  auto head_object_outcome = client_.HeadObject(head_request);
+  if (!head_object_outcome.IsSuccess()) {
+    return Status(
+        Status::Code::INTERNAL,
+        "Failed to get metadata for object at s3://" + bucket + "/" + object);
+  }
+
+  const int64_t total_byte_size =
+      head_object_outcome.GetResult().GetContentLength();
+
+  // The ETag identifies the object contents, so an object found in
+  // the cache under its ETag doesn't need to be fetched again.
+  std::string cache_file_path;
+  if (!cache_path_.empty()) {
+    std::string key;
+    const std::string etag(head_object_outcome.GetResult().GetETag().c_str());
+    for (const char c : etag) {
+      if (isalnum(c) || (c == '-')) {
+        key += c;
+      }
+    }
+    if (!key.empty()) {
+      cache_file_path = JoinPath({cache_path_, key});
+      if (access(cache_file_path.c_str(), R_OK) == 0) {
+        // Hard-link the cached copy into place, falling back to a
+        // copy if the cache is on a different filesystem.
+        remove(local_file_path.c_str());
+        if (link(cache_file_path.c_str(), local_file_path.c_str()) == 0) {
+          return Status::Success;
+        }
+        std::ifstream src(cache_file_path, std::ios::binary);
+        std::ofstream dst(local_file_path, std::ios::binary);
+        if (src && (dst << src.rdbuf())) {
+          return Status::Success;
+        }
+        // The cached copy can't be read... fall through and re-fetch.
+      }
+    }
+  }
+
+  if (total_byte_size >= kS3MultipartDownloadThreshold) {
+    RETURN_IF_ERROR(
+        DownloadFileParts(bucket, object, local_file_path, total_byte_size));
+  } else {
+    s3::Model::GetObjectRequest object_request;
+    object_request.SetBucket(bucket.c_str());
+    object_request.SetKey(object.c_str());
+
+    auto get_object_outcome = client_.GetObject(object_request);
+    if (!get_object_outcome.IsSuccess()) {
+      return Status(
+          Status::Code::INTERNAL,
+          "Failed to get object at s3://" + bucket + "/" + object);
+    }
+
+    auto& retrieved_file =
+        get_object_outcome.GetResultWithOwnership().GetBody();
+    std::ofstream output_file(local_file_path.c_str(), std::ios::binary);
+    output_file << retrieved_file.rdbuf();
+    output_file.close();
+  }
+
+  // Populate the cache with the downloaded object. Failing to cache
+  // is not an error, the next download just fetches again.
+  if (!cache_file_path.empty() &&
+      (link(local_file_path.c_str(), cache_file_path.c_str()) != 0)) {
+    const std::string cache_tmp_path = cache_file_path + ".tmp";
+    std::ifstream src(local_file_path, std::ios::binary);
+    std::ofstream dst(cache_tmp_path, std::ios::binary);
+    if (src && (dst << src.rdbuf())) {
+      dst.close();
+      rename(cache_tmp_path.c_str(), cache_file_path.c_str());
+    } else {
+      remove(cache_tmp_path.c_str());
+    }
+  }
+
+  return Status::Success;
+}
+
+Status
+S3FileSystem::DownloadFileParts(
+    const std::string& bucket, const std::string& object,
+    const std::string& local_file_path, const int64_t total_byte_size)
+{
+  int fd = open(
+      local_file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+      S_IRUSR | S_IWUSR);
+  if (fd == -1) {
+    return Status(
+        Status::Code::INTERNAL, "Failed to create local file " +
+                                    local_file_path + ": " + strerror(errno));
+  }
+
+  const int64_t part_count =
+      (total_byte_size + kS3DownloadPartByteSize - 1) / kS3DownloadPartByteSize;
+
+  // Each worker thread pulls the next not-yet-fetched part, gets it
+  // with a ranged request and writes it at its offset in the file.
+  std::mutex mtx;
+  Status status = Status::Success;
+  std::atomic<int64_t> next_part(0);
+
+  auto worker_func = [&]() {
+    for (int64_t part = next_part++; part < part_count; part = next_part++) {
+      const int64_t start = part * kS3DownloadPartByteSize;
+      const int64_t end =
+          std::min(start + kS3DownloadPartByteSize, total_byte_size) - 1;
+
+      s3::Model::GetObjectRequest object_request;
+      object_request.SetBucket(bucket.c_str());
+      object_request.SetKey(object.c_str());
+      object_request.SetRange(
+          ("bytes=" + std::to_string(start) + "-" + std::to_string(end))
+              .c_str());
+
+      Status part_status;
+      auto get_object_outcome = client_.GetObject(object_request);
+      if (get_object_outcome.IsSuccess()) {
+        auto& body = get_object_outcome.GetResultWithOwnership().GetBody();
+        std::vector<char> buffer(end - start + 1);
+        body.read(buffer.data(), buffer.size());
+        if ((body.gcount() != static_cast<std::streamsize>(buffer.size())) ||
+            (pwrite(fd, buffer.data(), buffer.size(), start) !=
+             static_cast<ssize_t>(buffer.size()))) {
+          part_status = Status(
+              Status::Code::INTERNAL,
+              "Failed to write object part to " + local_file_path);
+        }
+      } else {
+        part_status = Status(
+            Status::Code::INTERNAL, "Failed to get object part at s3://" +
+                                        bucket + "/" + object);
+      }
+
+      if (!part_status.IsOk()) {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (status.IsOk()) {
+          status = part_status;
+        }
+        return;
+      }
+    }
+  };
+
+  const size_t thread_count =
+      std::min(static_cast<size_t>(part_count), kS3MaxDownloadThreads);
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < thread_count; t++) {
+    workers.emplace_back(worker_func);
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  close(fd);
+  return status;
+}
+
 Status
 S3FileSystem::DownloadFileFolder(
     const std::string& path, std::string* local_path)
@@ -950,30 +1684,46 @@ S3FileSystem::DownloadFileFolder(
       }
     }
 
-    for (auto iter = files.begin(); iter != files.end(); ++iter) {
-      std::string bucket, object;
-      RETURN_IF_ERROR(ParsePath(*iter, &bucket, &object));
-
-      // Send a request for the objects metadata
-      s3::Model::GetObjectRequest object_request;
-      object_request.SetBucket(bucket.c_str());
-      object_request.SetKey(object.c_str());
-
-      auto get_object_outcome = client_.GetObject(object_request);
-      if (get_object_outcome.IsSuccess()) {
-        auto& retrieved_file =
-            get_object_outcome.GetResultWithOwnership().GetBody();
-        std::string s3_removed_path = (*iter).substr(effective_path.size());
-        std::string local_file_path = JoinPath({*local_path, s3_removed_path});
-        std::ofstream output_file(local_file_path.c_str(), std::ios::binary);
-        output_file << retrieved_file.rdbuf();
-        output_file.close();
-      } else {
-        return Status(
-            Status::Code::INTERNAL,
-            "Failed to get object at " + effective_path);
+    // Fetch the files in parallel, each worker thread pulling the
+    // next not-yet-downloaded file.
+    std::vector<std::string> file_vec(files.begin(), files.end());
+    std::mutex mtx;
+    Status status = Status::Success;
+    std::atomic<size_t> next_file(0);
+
+    auto worker_func = [&]() {
+      for (size_t idx = next_file++; idx < file_vec.size();
+           idx = next_file++) {
+        std::string bucket, object;
+        Status file_status = ParsePath(file_vec[idx], &bucket, &object);
+        if (file_status.IsOk()) {
+          std::string s3_removed_path =
+              file_vec[idx].substr(effective_path.size());
+          std::string local_file_path =
+              JoinPath({*local_path, s3_removed_path});
+          file_status = DownloadFile(bucket, object, local_file_path);
+        }
+        if (!file_status.IsOk()) {
+          std::lock_guard<std::mutex> lk(mtx);
+          if (status.IsOk()) {
+            status = file_status;
+          }
+          return;
+        }
       }
+    };
+
+    const size_t thread_count =
+        std::min(file_vec.size(), kS3MaxDownloadThreads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_count; t++) {
+      workers.emplace_back(worker_func);
+    }
+    for (auto& w : workers) {
+      w.join();
     }
+
+    RETURN_IF_ERROR(status);
   } else {
     int status = mkstemp(const_cast<char*>(file_template.c_str()));
     if (!status) {
@@ -985,23 +1735,7 @@ S3FileSystem::DownloadFileFolder(
     *local_path = file_template;
     std::string bucket, object;
     RETURN_IF_ERROR(ParsePath(effective_path, &bucket, &object));
-
-    // Send a request for the objects metadata
-    s3::Model::GetObjectRequest object_request;
-    object_request.SetBucket(bucket.c_str());
-    object_request.SetKey(object.c_str());
-
-    auto get_object_outcome = client_.GetObject(object_request);
-    if (get_object_outcome.IsSuccess()) {
-      auto& retrieved_file =
-          get_object_outcome.GetResultWithOwnership().GetBody();
-      std::ofstream output_file(local_path->c_str(), std::ios::binary);
-      output_file << retrieved_file.rdbuf();
-      output_file.close();
-    } else {
-      return Status(
-          Status::Code::INTERNAL, "Failed to get object at " + effective_path);
-    }
+    RETURN_IF_ERROR(DownloadFile(bucket, object, *local_path));
   }
   return Status::Success;
 }
@@ -1068,6 +1802,38 @@ GetFileSystem(const std::string& path, FileSystem** file_system)
 
 }  // namespace
 
+Status
+MappedFile::Pin()
+{
+#ifdef TRTIS_ENABLE_GPU
+  if ((ByteSize() == 0) || permanently_pinned_ || pinned_) {
+    return Status::Success;
+  }
+
+  cudaError_t cuerr = cudaHostRegister(
+      const_cast<char*>(Data()), ByteSize(), cudaHostRegisterDefault);
+  if (cuerr != cudaSuccess) {
+    return Status(
+        Status::Code::INTERNAL,
+        std::string("unable to pin file contents: ") +
+            cudaGetErrorString(cuerr));
+  }
+
+  pinned_ = true;
+#endif  // TRTIS_ENABLE_GPU
+  return Status::Success;
+}
+
+void
+MappedFile::Unpin()
+{
+#ifdef TRTIS_ENABLE_GPU
+  if (pinned_) {
+    cudaHostUnregister(const_cast<char*>(Data()));
+    pinned_ = false;
+  }
+#endif  // TRTIS_ENABLE_GPU
+}
 
 bool
 IsAbsolutePath(const std::string& path)
@@ -1209,6 +1975,16 @@ GetDirectoryFiles(
   return Status::Success;
 }
 
+ScopedReadThrottle::ScopedReadThrottle() : prev_(read_throttle_enabled)
+{
+  read_throttle_enabled = true;
+}
+
+ScopedReadThrottle::~ScopedReadThrottle()
+{
+  read_throttle_enabled = prev_;
+}
+
 Status
 ReadTextFile(const std::string& path, std::string* contents)
 {
@@ -1217,6 +1993,22 @@ ReadTextFile(const std::string& path, std::string* contents)
   return fs->ReadTextFile(path, contents);
 }
 
+Status
+MapFile(const std::string& path, std::shared_ptr<MappedFile>* mapped)
+{
+  return MapFile(path, false /* pinned_memory_preferred */, mapped);
+}
+
+Status
+MapFile(
+    const std::string& path, const bool pinned_memory_preferred,
+    std::shared_ptr<MappedFile>* mapped)
+{
+  FileSystem* fs;
+  RETURN_IF_ERROR(GetFileSystem(path, &fs));
+  return fs->MapFile(path, pinned_memory_preferred, mapped);
+}
+
 Status
 ReadTextProto(const std::string& path, google::protobuf::Message* msg)
 {
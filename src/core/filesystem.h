@@ -25,12 +25,54 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <memory>
 #include <string>
 #include "google/protobuf/message.h"
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
 
+/// A read-only view of a file's contents. For a file on the local
+/// filesystem the contents are memory-mapped so that the bytes come
+/// directly from the page cache; for other filesystems the contents
+/// are read into an internal buffer. The returned pointer stays valid
+/// for the lifetime of the object.
+class MappedFile {
+ public:
+  MappedFile() : permanently_pinned_(false), pinned_(false) {}
+  virtual ~MappedFile() = default;
+
+  /// \return a pointer to the first byte of the file contents.
+  virtual const char* Data() const = 0;
+
+  /// \return the size of the file contents, in bytes.
+  virtual size_t ByteSize() const = 0;
+
+  /// Pin the file contents in host memory so that device uploads
+  /// reading from them run at full transfer bandwidth instead of
+  /// through a pageable-memory staging copy. Must be paired with
+  /// Unpin() before the object is destroyed. No-op when the server is
+  /// built without GPU support.
+  /// \return Error status if the contents could not be pinned.
+  Status Pin();
+
+  /// Unpin file contents pinned by Pin(). No-op if the contents are
+  /// not pinned.
+  void Unpin();
+
+ protected:
+  /// For implementations whose contents live in pinned host memory
+  /// for their entire lifetime, making Pin() and Unpin() no-ops.
+  explicit MappedFile(bool permanently_pinned)
+      : permanently_pinned_(permanently_pinned), pinned_(false)
+  {
+  }
+
+ private:
+  const bool permanently_pinned_;
+  bool pinned_;
+};
+
 /// Is a path an absolute path?
 /// \param path The path.
 /// \return true if absolute path, false if relative path.
@@ -92,12 +134,51 @@ Status GetDirectoryFiles(
     const std::string& path, const bool skip_hidden_files,
     std::set<std::string>* files);
 
+/// Pace local file reads performed on the calling thread for the
+/// lifetime of the guard by the load read-bandwidth limit configured
+/// with TRTSERVER_LOAD_READ_BANDWIDTH_MBS (MB/s, unset or 0 disables
+/// pacing). Used around model loading so a background load trades its
+/// own duration for steady-state latency instead of saturating the
+/// storage device that live traffic also depends on.
+class ScopedReadThrottle {
+ public:
+  ScopedReadThrottle();
+  ~ScopedReadThrottle();
+
+ private:
+  const bool prev_;
+};
+
 /// Read a text file into a string.
 /// \param path The path of the file.
 /// \param contents Returns the contents of the file.
 /// \return Error status
 Status ReadTextFile(const std::string& path, std::string* contents);
 
+/// Map a file into memory for read. Uses mmap for files on the local
+/// filesystem, avoiding an extra copy of the file contents.
+/// \param path The path of the file.
+/// \param mapped Returns the mapped file contents.
+/// \return Error status
+Status MapFile(const std::string& path, std::shared_ptr<MappedFile>* mapped);
+
+/// Map a file into memory for read, optionally into pinned host
+/// memory. When 'pinned_memory_preferred' is true and the server is
+/// built with GPU support, a file on the local filesystem is read
+/// directly into a pinned allocation so that device uploads of the
+/// contents (e.g. TensorRT engine deserialization) DMA straight from
+/// the read destination instead of faulting pages in from a
+/// file-backed mapping. Falls back to the default mapping when pinned
+/// memory can't be used.
+/// \param path The path of the file.
+/// \param pinned_memory_preferred Prefer pinned host memory for the
+/// contents.
+/// \param mapped Returns the mapped file contents.
+/// \return Error status
+Status MapFile(
+    const std::string& path, const bool pinned_memory_preferred,
+    std::shared_ptr<MappedFile>* mapped);
+
 /// Create a local copy of the file/folder (if needed).
 /// \param path The path of the file.
 /// \param local_path Returns the local path of the file.
@@ -0,0 +1,95 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/gpu_execution_coordinator.h"
+
+#include "src/core/logging.h"
+
+namespace nvidia { namespace inferenceserver {
+
+std::shared_ptr<GpuExecutionCoordinator>
+GpuExecutionCoordinator::Get(const int gpu_device, const uint32_t slots)
+{
+  static std::mutex registry_mu;
+  static std::map<int, std::shared_ptr<GpuExecutionCoordinator>> registry;
+
+  const uint32_t slot_cnt = (slots == 0) ? 1 : slots;
+
+  std::lock_guard<std::mutex> lock(registry_mu);
+  auto itr = registry.find(gpu_device);
+  if (itr == registry.end()) {
+    itr = registry
+              .emplace(
+                  gpu_device, std::shared_ptr<GpuExecutionCoordinator>(
+                                  new GpuExecutionCoordinator(slot_cnt)))
+              .first;
+  } else if (itr->second->slots_ != slot_cnt) {
+    LOG_WARNING << "GPU execution coordinator for device " << gpu_device
+                << " already created with " << itr->second->slots_
+                << " slot(s), ignoring setting of " << slot_cnt;
+  }
+
+  return itr->second;
+}
+
+GpuExecutionCoordinator::GpuExecutionCoordinator(const uint32_t slots)
+    : slots_(slots), available_(slots)
+{
+}
+
+void
+GpuExecutionCoordinator::Acquire(const uint32_t priority)
+{
+  std::unique_lock<std::mutex> lock(mu_);
+  waiting_[priority]++;
+  cv_.wait(lock, [this, priority]() {
+    return (available_ > 0) && (waiting_.rbegin()->first == priority);
+  });
+
+  auto witr = waiting_.find(priority);
+  if (--(witr->second) == 0) {
+    waiting_.erase(witr);
+  }
+  available_--;
+
+  // Other waiters at the now-highest priority may still be eligible
+  // for the remaining slots.
+  if ((available_ > 0) && !waiting_.empty()) {
+    cv_.notify_all();
+  }
+}
+
+void
+GpuExecutionCoordinator::Release()
+{
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    available_++;
+  }
+  cv_.notify_all();
+}
+
+}}  // namespace nvidia::inferenceserver
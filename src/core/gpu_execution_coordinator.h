@@ -0,0 +1,77 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+namespace nvidia { namespace inferenceserver {
+
+// Coordinates the execution of the models sharing one GPU. Without
+// coordination each backend context launches work on its own streams
+// and the kernels of concurrently executing models interleave on the
+// device, which can cost a latency-critical model significantly. The
+// coordinator bounds the number of concurrent model executions on the
+// device with a fixed set of slots; models that opt in acquire a slot
+// before executing a batch and release it on completion, and a freed
+// slot is granted to the waiting model with the highest configured
+// priority.
+class GpuExecutionCoordinator {
+ public:
+  // Return the coordinator for 'gpu_device', creating it with 'slots'
+  // concurrent execution slots on first use. A slot count of 0 is
+  // treated as 1. The slot count is fixed by the first model that
+  // enables coordination on the device; a different setting from a
+  // later model is ignored with a warning.
+  static std::shared_ptr<GpuExecutionCoordinator> Get(
+      const int gpu_device, const uint32_t slots);
+
+  // Block until an execution slot is available. When multiple models
+  // are waiting, freed slots are granted to the waiters with the
+  // highest 'priority'.
+  void Acquire(const uint32_t priority);
+
+  // Return an execution slot, waking a waiter if any.
+  void Release();
+
+ private:
+  GpuExecutionCoordinator(const uint32_t slots);
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+
+  const uint32_t slots_;
+  uint32_t available_;
+
+  // The number of waiters at each priority, used to grant freed slots
+  // to the highest waiting priority first.
+  std::map<uint32_t, uint32_t> waiting_;
+};
+
+}}  // namespace nvidia::inferenceserver
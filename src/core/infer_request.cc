@@ -70,8 +70,35 @@ InferenceRequest::InferenceRequest(
     : needs_normalization_(true), model_name_(model_name),
       requested_model_version_(requested_model_version),
       actual_model_version_(actual_model_version),
-      protocol_version_(protocol_version), flags_(0), correlation_id_(0),
-      batch_size_(0), priority_(0), timeout_us_(0)
+      protocol_version_(protocol_version), id_(0),
+      unique_id_(NextUniqueId()), flags_(0), correlation_id_(0),
+      batch_size_(0), priority_(0), timeout_us_(0), deadline_ns_(0),
+      cancelled_(false), is_mirror_(false)
+{
+}
+
+uint64_t
+InferenceRequest::NextUniqueId()
+{
+  static std::atomic<uint64_t> next_id(1);
+  return next_id.fetch_add(1);
+}
+
+InferenceRequest::InferenceRequest(const InferenceRequest& rhs)
+    : needs_normalization_(rhs.needs_normalization_),
+      model_name_(rhs.model_name_),
+      requested_model_version_(rhs.requested_model_version_),
+      actual_model_version_(rhs.actual_model_version_),
+      protocol_version_(rhs.protocol_version_), id_(rhs.id_),
+      id_str_(rhs.id_str_), unique_id_(rhs.unique_id_), flags_(rhs.flags_),
+      correlation_id_(rhs.correlation_id_), batch_size_(rhs.batch_size_),
+      priority_(rhs.priority_), timeout_us_(rhs.timeout_us_),
+      deadline_ns_(rhs.deadline_ns_), cancelled_(rhs.cancelled_.load()),
+      is_mirror_(rhs.is_mirror_),
+      original_inputs_(rhs.original_inputs_),
+      override_inputs_(rhs.override_inputs_), inputs_(rhs.inputs_),
+      requested_outputs_(rhs.requested_outputs_),
+      peeked_shape_tensors_(rhs.peeked_shape_tensors_)
 {
 }
 
@@ -284,6 +311,20 @@ InferenceRequest::RemoveAllRequestedOutputs()
   return Status::Success;
 }
 
+uint64_t
+InferenceRequest::TotalInputByteSize() const
+{
+  uint64_t total_byte_size = 0;
+  for (const auto& pr : original_inputs_) {
+    const auto& data = pr.second.Data();
+    if (data != nullptr) {
+      total_byte_size += data->TotalByteSize();
+    }
+  }
+
+  return total_byte_size;
+}
+
 Status
 InferenceRequest::PrepareForInference(const InferenceBackend& backend)
 {
@@ -311,11 +352,95 @@ InferenceRequest::PrepareForInference(const InferenceBackend& backend)
     inputs_.emplace(std::make_pair(pr.first, std::addressof(pr.second)));
   }
 
+  // Cache the value of any host-resident shape-tensor inputs here on
+  // the frontend thread so that the scheduler can form dynamic
+  // batches without synchronizing with the device to peek them.
+  CacheShapeTensors(backend);
+
   LOG_VERBOSE(1) << "prepared: " << *this;
 
   return Status::Success;
 }
 
+const std::vector<int64_t>*
+InferenceRequest::PeekedShapeTensor(const std::string& name) const
+{
+  const auto itr = peeked_shape_tensors_.find(name);
+  if (itr == peeked_shape_tensors_.end()) {
+    return nullptr;
+  }
+
+  return &itr->second;
+}
+
+void
+InferenceRequest::CacheShapeTensors(const InferenceBackend& backend)
+{
+  peeked_shape_tensors_.clear();
+
+  for (const auto& io : backend.Config().input()) {
+    // Shape tensors must be INT32, skip anything else and let the
+    // backend report the error.
+    if (!io.is_shape_tensor()) {
+      continue;
+    }
+
+    const auto itr = inputs_.find(io.name());
+    if (itr == inputs_.end()) {
+      continue;
+    }
+
+    const Input* input = itr->second;
+    if ((input->DType() != DataType::TYPE_INT32) ||
+        (input->Data() == nullptr)) {
+      continue;
+    }
+
+    const int64_t element_cnt = GetElementCount(input->Shape());
+    if (element_cnt <= 0) {
+      continue;
+    }
+
+    const size_t expected_byte_size =
+        element_cnt * GetDataTypeByteSize(DataType::TYPE_INT32);
+
+    // Gather the value only if every buffer is already in host
+    // memory; otherwise leave the input for the backend to peek with
+    // a device synchronization.
+    std::vector<char> buffer;
+    buffer.reserve(expected_byte_size);
+
+    bool host_resident = true;
+    for (size_t idx = 0; idx < input->ContentBufferCount(); ++idx) {
+      const void* content = nullptr;
+      size_t content_byte_size = 0;
+      TRTSERVER_Memory_Type memory_type = TRTSERVER_MEMORY_CPU;
+      int64_t memory_type_id = 0;
+      if (!input
+               ->Content(
+                   idx, &content, &content_byte_size, &memory_type,
+                   &memory_type_id)
+               .IsOk() ||
+          (memory_type == TRTSERVER_MEMORY_GPU)) {
+        host_resident = false;
+        break;
+      }
+
+      buffer.insert(
+          buffer.end(), static_cast<const char*>(content),
+          static_cast<const char*>(content) + content_byte_size);
+    }
+
+    if (!host_resident || (buffer.size() != expected_byte_size)) {
+      continue;
+    }
+
+    const int32_t* dims = reinterpret_cast<const int32_t*>(buffer.data());
+    peeked_shape_tensors_.emplace(
+        io.name(), std::vector<int64_t>(dims, dims + element_cnt));
+  }
+}
+
 Status
 InferenceRequest::NormalizeV1(const InferenceBackend& backend)
 {
@@ -361,13 +486,15 @@ InferenceRequest::NormalizeV1(const InferenceBackend& backend)
             " inputs for model '" + model_name_ + "'");
   }
 
-  // Update each input to have shape, datatype and batch-byte-size.
+  // Update each input to have shape, datatype and batch-byte-size,
+  // validating against the plan compiled from the model configuration
+  // at load time.
   for (auto& pr : original_inputs_) {
-    const ModelInput* input_config;
-    RETURN_IF_ERROR(backend.GetInput(pr.first, &input_config));
+    const InferenceBackend::InputPlan* plan;
+    RETURN_IF_ERROR(backend.GetInputPlan(pr.first, &plan));
     auto& input = pr.second;
 
-    input.SetDType(input_config->data_type());
+    input.SetDType(plan->data_type_);
 
     auto new_shape = input.MutableShape();
     *new_shape = input.OriginalShape();
@@ -375,29 +502,28 @@ InferenceRequest::NormalizeV1(const InferenceBackend& backend)
     // If the inference request specifies a shape for an input, make
     // sure it matches what the model expects.
     if (new_shape->size() > 0) {
-      if (!CompareDimsWithWildcard(input_config->dims(), *new_shape)) {
+      if (!CompareDimsWithWildcard(plan->dims_, *new_shape)) {
         return Status(
             Status::Code::INVALID_ARG,
             "unexpected shape for input '" + pr.first + "' for model '" +
-                model_name_ + "'. Expected " +
-                DimsListToString(input_config->dims()) + ", got " +
-                DimsListToString(*new_shape));
+                model_name_ + "'. Expected " + DimsListToString(plan->dims_) +
+                ", got " + DimsListToString(*new_shape));
       }
 
       // If there is a reshape for this input then set the shape to
       // match the reshape. As reshape may have variable-size
       // dimensions, we need to record corresponding value so that we
       // can set the value correctly for reshape.
-      if (input_config->has_reshape()) {
+      if (plan->has_reshape_) {
         std::deque<int64_t> variable_size_values;
-        for (int64_t idx = 0; idx < input_config->dims_size(); idx++) {
-          if (input_config->dims(idx) == -1) {
+        for (size_t idx = 0; idx < plan->dims_.size(); idx++) {
+          if (plan->dims_[idx] == -1) {
             variable_size_values.push_back((*new_shape)[idx]);
           }
         }
 
         new_shape->clear();
-        for (const auto& dim : input_config->reshape().shape()) {
+        for (const auto& dim : plan->reshape_dims_) {
           if (dim == -1) {
             new_shape->push_back(variable_size_values.front());
             variable_size_values.pop_front();
@@ -412,24 +538,18 @@ InferenceRequest::NormalizeV1(const InferenceBackend& backend)
     // request didn't specify it, or it has a reshape that we must use
     // instead.
     if (new_shape->size() == 0) {
-      const DimsList& dims = (input_config->has_reshape())
-                                 ? input_config->reshape().shape()
-                                 : input_config->dims();
-
       // Inference request doesn't specify shape, make sure input
       // shape is fully specified in the model and calculate expected
       // size from the model configuration.
-      for (auto dim : dims) {
-        if (dim < 0) {
-          return Status(
-              Status::Code::INVALID_ARG,
-              "model supports variable-size for input '" + pr.first +
-                  "', request must specify input shape for model '" +
-                  model_name_ + "'");
-        }
-
-        new_shape->push_back(dim);
+      if (plan->default_shape_has_variable_dim_) {
+        return Status(
+            Status::Code::INVALID_ARG,
+            "model supports variable-size for input '" + pr.first +
+                "', request must specify input shape for model '" +
+                model_name_ + "'");
       }
+
+      *new_shape = plan->default_shape_;
     }
 
     // For fixed-size datatype the tensor used to calculate byte-size
@@ -451,12 +571,12 @@ InferenceRequest::NormalizeV1(const InferenceBackend& backend)
     // that will always be shape [], i.e. a tensor with no contents.
     //
     uint64_t bs = 0;
-    if (IsFixedSizeDataType(input_config->data_type())) {
-      bs = GetByteSize(input_config->data_type(), *new_shape);
-      int multiplier = (input_config->is_shape_tensor() ? 1 : batch_size_);
+    if (plan->fixed_size_data_type_ && !plan->is_non_linear_format_) {
+      bs = GetByteSize(plan->data_type_, *new_shape);
+      int multiplier = (plan->is_shape_tensor_ ? 1 : batch_size_);
       if (model_config.max_batch_size() > 0) {
         if (new_shape->size() == 0) {
-          bs = GetDataTypeByteSize(input_config->data_type()) * multiplier;
+          bs = GetDataTypeByteSize(plan->data_type_) * multiplier;
         } else {
           bs *= multiplier;
         }
@@ -473,8 +593,11 @@ InferenceRequest::NormalizeV1(const InferenceBackend& backend)
                 model_name_ + "'");
       }
     } else {
-      // The input's datatype is not fixed-sized (like TYPE_STRING),
-      // use the full-batch size specified by the request.
+      // The byte size can't be calculated from the shape when the
+      // input's datatype is not fixed-sized (like TYPE_STRING) or when
+      // the input is in a vectorized memory format whose padding is
+      // known only to the backend, so use the full-batch size specified
+      // by the request.
       bs = input.BatchByteSize();
     }
 
@@ -579,10 +702,12 @@ InferenceRequest::NormalizeV2(const InferenceBackend& backend)
   }
 
   // Verify that each input shape is valid for the model, make
-  // adjustments for reshapes and find the total tensor size.
+  // adjustments for reshapes and find the total tensor size. The
+  // expectations were compiled from the model configuration at load
+  // time.
   for (auto& pr : original_inputs_) {
-    const ModelInput* input_config;
-    RETURN_IF_ERROR(backend.GetInput(pr.first, &input_config));
+    const InferenceBackend::InputPlan* plan;
+    RETURN_IF_ERROR(backend.GetInputPlan(pr.first, &plan));
 
     auto& input = pr.second;
     auto shape = input.MutableShape();
@@ -591,42 +716,41 @@ InferenceRequest::NormalizeV2(const InferenceBackend& backend)
     // endpoints switch to new TRITONSERVER APIs where they always
     // specify datatype.
 #if 0
-    if (input.DType() != input_config->data_type()) {
+    if (input.DType() != plan->data_type_) {
       return Status(
           Status::Code::INVALID_ARG,
           "inference input data-type is '" +
               std::string(DataTypeToProtocolString(input.DType())) +
               "', model expects '" +
-              std::string(DataTypeToProtocolString(input_config->data_type())) +
+              std::string(DataTypeToProtocolString(plan->data_type_)) +
               "' for '" + model_name_ + "'");
     }
 #else
-    input.SetDType(input_config->data_type());
+    input.SetDType(plan->data_type_);
 #endif
 
-    if (!CompareDimsWithWildcard(input_config->dims(), *shape)) {
+    if (!CompareDimsWithWildcard(plan->dims_, *shape)) {
       return Status(
           Status::Code::INVALID_ARG,
           "unexpected shape for input '" + pr.first + "' for model '" +
-              model_name_ + "'. Expected " +
-              DimsListToString(input_config->dims()) + ", got " +
-              DimsListToString(*shape));
+              model_name_ + "'. Expected " + DimsListToString(plan->dims_) +
+              ", got " + DimsListToString(*shape));
     }
 
     // If there is a reshape for this input then adjust them to
     // match the reshape. As reshape may have variable-size
     // dimensions, we need to record corresponding value so that we
     // can set the value correctly for reshape.
-    if (input_config->has_reshape()) {
+    if (plan->has_reshape_) {
       std::deque<int64_t> variable_size_values;
-      for (int64_t idx = 0; idx < input_config->dims_size(); idx++) {
-        if (input_config->dims(idx) == -1) {
+      for (size_t idx = 0; idx < plan->dims_.size(); idx++) {
+        if (plan->dims_[idx] == -1) {
           variable_size_values.push_back((*shape)[idx]);
         }
       }
 
       shape->clear();
-      for (const auto& dim : input_config->reshape().shape()) {
+      for (const auto& dim : plan->reshape_dims_) {
         if (dim == -1) {
           shape->push_back(variable_size_values.front());
           variable_size_values.pop_front();
@@ -750,7 +874,9 @@ std::ostream&
 operator<<(std::ostream& out, const InferenceRequest& request)
 {
   out << "[0x" << std::addressof(request) << "] "
-      << "request id: " << request.IdStr() << ", model: " << request.ModelName()
+      << "unique id: " << request.UniqueId()
+      << ", request id: " << request.IdStr()
+      << ", model: " << request.ModelName()
       << ", requested version: " << request.RequestedModelVersion()
       << ", actual version: " << request.ActualModelVersion() << ", flags: 0x"
       << std::hex << request.Flags() << std::dec
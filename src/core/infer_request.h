@@ -25,6 +25,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -80,16 +81,13 @@ class InferenceRequest {
     void SetDType(const DataType t) { datatype_ = t; }
 
     // The original shape of the input tensor.
-    const std::vector<int64_t>& OriginalShape() const
-    {
-      return original_shape_;
-    }
+    const ShapeVector& OriginalShape() const { return original_shape_; }
 
     // The shape of the input tensor after normalization. This shape
     // is the original shape modified as required/expected by
     // inference processing.
-    const std::vector<int64_t>& Shape() const { return shape_; }
-    std::vector<int64_t>* MutableShape() { return &shape_; }
+    const ShapeVector& Shape() const { return shape_; }
+    ShapeVector* MutableShape() { return &shape_; }
 
     // The size, in bytes, of the entire input tensor. We should
     // ultimately be able to remove this "batch_byte_size" parameter
@@ -146,8 +144,8 @@ class InferenceRequest {
 
     std::string name_;
     DataType datatype_;
-    std::vector<int64_t> original_shape_;
-    std::vector<int64_t> shape_;
+    ShapeVector original_shape_;
+    ShapeVector shape_;
 
     // FIXMEV2 why needed? Should get total data size from data_.
     uint64_t batch_byte_size_;
@@ -193,6 +191,10 @@ class InferenceRequest {
       const std::string& model_name, const int64_t requested_model_version,
       const int64_t actual_model_version, const uint32_t protocol_version);
 
+  // Copy constructor. Member-wise, except that the atomic
+  // cancellation flag requires copying its value explicitly.
+  InferenceRequest(const InferenceRequest& rhs);
+
   uint32_t ProtocolVersion() const { return protocol_version_; }
   const std::string& ModelName() const { return model_name_; }
   int64_t RequestedModelVersion() const { return requested_model_version_; }
@@ -205,6 +207,13 @@ class InferenceRequest {
   const std::string& IdStr() const { return id_str_; }
   void SetIdStr(const std::string& i) { id_str_ = i; }
 
+  // A server-assigned identifier for the request, monotonically
+  // allocated at construction and unique within the server process.
+  // Internal paths (scheduler, stats, tracing, logging) correlate on
+  // this 64-bit value; the client-visible ids ('Id' / 'IdStr') are
+  // only materialized at the API edges.
+  uint64_t UniqueId() const { return unique_id_; }
+
   uint32_t Flags() const { return flags_; }
   void SetFlags(uint32_t f) { flags_ = f; }
 
@@ -223,9 +232,39 @@ class InferenceRequest {
   uint32_t Priority() const { return priority_; }
   void SetPriority(uint32_t p) { priority_ = p; }
 
+  // Return the total byte size of the data of all original inputs.
+  uint64_t TotalInputByteSize() const;
+
   uint64_t TimeoutMicroseconds() const { return timeout_us_; }
   void SetTimeoutMicroseconds(uint64_t t) { timeout_us_ = t; }
 
+  // The deadline for the request in nanoseconds on the scheduler's
+  // monotonic clock, or 0 if the request has no deadline. The
+  // deadline is derived by the frontend from the transport (for
+  // example the gRPC call deadline). Unlike TimeoutMicroseconds(),
+  // which takes effect only when the model's queue policy allows a
+  // timeout override, the deadline is always honored: a queued
+  // request whose deadline has passed is rejected instead of
+  // executed, since the client will not use the response.
+  uint64_t DeadlineNanoseconds() const { return deadline_ns_; }
+  void SetDeadlineNanoseconds(uint64_t d) { deadline_ns_ = d; }
+
+  // Mark the request as cancelled. Called by a frontend when the
+  // client that issued the request is no longer waiting for the
+  // response (e.g. it disconnected). A cancelled request that is
+  // still queued is dropped by the scheduler instead of executed;
+  // cancellation is not reversible. May be called from any thread.
+  void Cancel() { cancelled_.store(true); }
+
+  // True if the request has been cancelled.
+  bool IsCancelled() const { return cancelled_.load(); }
+
+  // True if the request is a mirrored copy of another request. A
+  // mirrored request is never itself mirrored, so mirror
+  // configurations cannot chain.
+  bool IsMirror() const { return is_mirror_; }
+  void SetIsMirror(bool m) { is_mirror_ = m; }
+
   // The original inputs are the inputs added to the request before
   // the inference executed (that is before
   // TRITONSERVER_ServerInferAsync or equivalent is called). Once
@@ -319,6 +358,13 @@ class InferenceRequest {
   Status RemoveRequestedOutput(const std::string& name);
   Status RemoveAllRequestedOutputs();
 
+  // The value of a shape-tensor input peeked on the frontend thread
+  // by PrepareForInference, or nullptr if the value was not cached
+  // (e.g. the tensor contents reside in device memory). The cached
+  // value lets the scheduler form dynamic batches without touching
+  // CUDA to read shape tensors.
+  const std::vector<int64_t>* PeekedShapeTensor(const std::string& name) const;
+
   // Prepare this request for inference. We pass backend here as
   // non-shared-ptr because normalize must be used in contexts where
   // the backend shared_ptr does not yet exist (e.g. warmup).
@@ -331,6 +377,11 @@ class InferenceRequest {
   Status NormalizeV1(const InferenceBackend& backend);
   Status NormalizeV2(const InferenceBackend& backend);
 
+  // Record the value of every shape-tensor input whose contents are
+  // already in host memory so that batch formation doesn't need to
+  // peek them from the device.
+  void CacheShapeTensors(const InferenceBackend& backend);
+
   // Has anything in the request potentially changed in a way that
   // causes normalization to be required when preparing the request
   // for inference.
@@ -346,20 +397,42 @@ class InferenceRequest {
   // FIXMEV2 remove
   uint32_t protocol_version_;
 
+  // Return the next server-wide unique request id.
+  static uint64_t NextUniqueId();
+
   // For V1 id is an int, for V2 it is a string.
   uint64_t id_;
   std::string id_str_;
 
+  // The server-assigned unique id for the request. A copy of a
+  // request keeps the id since it identifies the logical request.
+  uint64_t unique_id_;
+
   uint32_t flags_;
   uint64_t correlation_id_;
   uint32_t batch_size_;
   uint32_t priority_;
   uint64_t timeout_us_;
 
+  // Absolute deadline on the monotonic clock, in ns. 0 indicates no
+  // deadline.
+  uint64_t deadline_ns_;
+
+  // True if the request has been cancelled. Atomic because a frontend
+  // thread sets it while the scheduler threads read it.
+  std::atomic<bool> cancelled_;
+
+  // True if the request is a mirrored copy of another request.
+  bool is_mirror_;
+
   std::unordered_map<std::string, Input> original_inputs_;
   std::unordered_map<std::string, std::shared_ptr<Input>> override_inputs_;
   std::unordered_map<std::string, Input*> inputs_;
   std::unordered_map<std::string, RequestedOutput> requested_outputs_;
+
+  // Shape-tensor values peeked from host-resident input contents by
+  // PrepareForInference, keyed by input name.
+  std::unordered_map<std::string, std::vector<int64_t>> peeked_shape_tensors_;
 };
 
 std::ostream& operator<<(std::ostream& out, const InferenceRequest& request);
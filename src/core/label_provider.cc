@@ -50,6 +50,28 @@ LabelProvider::GetLabel(const std::string& name, size_t index) const
   return itr->second[index];
 }
 
+const std::vector<std::string>*
+LabelProvider::GetLabels(const std::string& name) const
+{
+  auto itr = label_map_.find(name);
+  if (itr == label_map_.end()) {
+    return nullptr;
+  }
+
+  return &itr->second;
+}
+
+const std::vector<std::string>*
+LabelProvider::GetLabelSuffixes(const std::string& name) const
+{
+  auto itr = label_suffix_map_.find(name);
+  if (itr == label_suffix_map_.end()) {
+    return nullptr;
+  }
+
+  return &itr->second;
+}
+
 Status
 LabelProvider::AddLabels(const std::string& name, const std::string& filepath)
 {
@@ -70,6 +92,12 @@ LabelProvider::AddLabels(const std::string& name, const std::string& filepath)
     itr->second.push_back(line);
   }
 
+  auto& suffixes = label_suffix_map_[name];
+  suffixes.reserve(itr->second.size());
+  for (const auto& label : itr->second) {
+    suffixes.push_back(label.empty() ? label : (":" + label));
+  }
+
   return Status::Success;
 }
 
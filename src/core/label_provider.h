@@ -42,6 +42,18 @@ class LabelProvider {
   // 'index'. Return empty string if no label is available.
   const std::string& GetLabel(const std::string& name, size_t index) const;
 
+  // Return all labels associated with 'name', or nullptr if no labels
+  // have been added. Lets callers that format many classes per
+  // response avoid a map lookup per class.
+  const std::vector<std::string>* GetLabels(const std::string& name) const;
+
+  // Return the labels associated with 'name' preformatted as
+  // ":<label>" suffixes ready to be appended to a class result
+  // string, or nullptr if no labels have been added. Entries with no
+  // label are empty strings.
+  const std::vector<std::string>* GetLabelSuffixes(
+      const std::string& name) const;
+
   // Associate with 'name' a set of labels initialized from a given
   // 'filepath'. Within the file each label is specified on its own
   // line. The first label (line 0) is the index-0 label, the second
@@ -52,6 +64,10 @@ class LabelProvider {
   DISALLOW_COPY_AND_ASSIGN(LabelProvider);
 
   std::unordered_map<std::string, std::vector<std::string>> label_map_;
+
+  // Labels preformatted as ":<label>" suffixes, built when the labels
+  // are added so result formatting is a memcpy per class.
+  std::unordered_map<std::string, std::vector<std::string>> label_suffix_map_;
 };
 
 }}  // namespace nvidia::inferenceserver
@@ -29,24 +29,106 @@
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// Maximum number of messages queued for the writer thread. Messages
+// logged while the queue is full are dropped.
+constexpr size_t kMaxQueueSize = 8192;
+
+// How long the writer thread sleeps waiting for messages before
+// rechecking the queue.
+constexpr int kWriterIntervalMs = 100;
+
+}  // namespace
+
 Logger gLogger_;
 
-Logger::Logger() : enables_{true, true, true}, vlevel_(0) {}
+Logger::Logger()
+    : enables_{true, true, true}, vlevel_(0), queue_size_(0), dropped_cnt_(0),
+      writer_thread_exit_(false)
+{
+}
+
+Logger::~Logger()
+{
+  if (writer_thread_ != nullptr) {
+    {
+      std::lock_guard<std::mutex> lk(writer_mu_);
+      writer_thread_exit_.store(true);
+    }
+    writer_cv_.notify_one();
+    writer_thread_->join();
+  }
+}
 
 void
 Logger::Log(const std::string& msg)
 {
-  std::cerr << msg << std::endl;
+  std::call_once(writer_once_, [this] {
+    writer_thread_.reset(new std::thread([this] { WriterThread(); }));
+  });
+
+  if (queue_size_.fetch_add(1) >= kMaxQueueSize) {
+    queue_size_.fetch_sub(1);
+    dropped_cnt_.fetch_add(1);
+    return;
+  }
+
+  queue_.Push(std::string(msg));
+  writer_cv_.notify_one();
+}
+
+void
+Logger::WriterThread()
+{
+  uint64_t reported_dropped_cnt = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lk(writer_mu_);
+      writer_cv_.wait_for(
+          lk, std::chrono::milliseconds(kWriterIntervalMs),
+          [this] { return writer_thread_exit_.load() || !queue_.Empty(); });
+    }
+
+    auto msgs = queue_.DrainAll();
+    for (const auto& msg : msgs) {
+      std::cerr << msg << "\n";
+    }
+
+    const uint64_t dropped_cnt = dropped_cnt_.load();
+    if (dropped_cnt != reported_dropped_cnt) {
+      LOG_WARNING << "dropped " << (dropped_cnt - reported_dropped_cnt)
+                  << " log messages, log queue was full";
+      reported_dropped_cnt = dropped_cnt;
+    }
+
+    std::cerr << std::flush;
+
+    // Decrement the queue size only after the messages are written so
+    // that Flush() can wait for the queue size to reach zero.
+    queue_size_.fetch_sub(msgs.size());
+
+    if (writer_thread_exit_.load() && queue_.Empty()) {
+      break;
+    }
+  }
 }
 
 void
 Logger::Flush()
 {
+  while ((writer_thread_ != nullptr) && (queue_size_.load() > 0)) {
+    writer_cv_.notify_one();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
   std::cerr << std::flush;
 }
 
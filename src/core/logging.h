@@ -25,9 +25,15 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
+#include "src/core/mpsc_queue.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -48,9 +54,16 @@ class LogMessage {
 };
 
 // Global logger for messages. Controls how log messages are reported.
+//
+// Messages are preformatted by the calling thread but written to
+// stderr by a dedicated writer thread, so a burst of logging does not
+// block the request threads on I/O. The queue of pending messages is
+// bounded; messages logged while the queue is full are dropped and a
+// count of the drops is reported by the writer thread.
 class Logger {
  public:
   Logger();
+  ~Logger();
 
   // Is a log level enabled.
   bool IsEnabled(LogMessage::Level level) const { return enables_[level]; }
@@ -67,15 +80,37 @@ class Logger {
   // Set the current verbose logging level.
   void SetVerboseLevel(uint32_t vlevel) { vlevel_ = vlevel; }
 
-  // Log a message.
+  // Log a message. The message is queued for the writer thread, or
+  // dropped if the queue is full.
   void Log(const std::string& msg);
 
-  // Flush the log.
+  // Flush the log. Blocks until all queued messages have been
+  // written.
   void Flush();
 
  private:
+  // The writer thread drains 'queue_' to stderr.
+  void WriterThread();
+
   std::vector<bool> enables_;
   uint32_t vlevel_;
+
+  // Pending messages and the count of messages dropped because the
+  // queue was full. 'queue_size_' bounds the lock-free queue; it is
+  // decremented only after a message has been written so that Flush()
+  // can wait on it.
+  MpscQueue<std::string> queue_;
+  std::atomic<size_t> queue_size_;
+  std::atomic<uint64_t> dropped_cnt_;
+
+  // The writer thread, started on first use. The mutex and condition
+  // variable are used only to wake the writer, never on the logging
+  // path.
+  std::once_flag writer_once_;
+  std::mutex writer_mu_;
+  std::condition_variable writer_cv_;
+  std::unique_ptr<std::thread> writer_thread_;
+  std::atomic<bool> writer_thread_exit_;
 };
 
 extern Logger gLogger_;
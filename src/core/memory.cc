@@ -27,6 +27,7 @@
 #include "src/core/memory.h"
 
 #include "src/core/logging.h"
+#include "src/core/memory_usage.h"
 #include "src/core/pinned_memory_manager.h"
 
 #ifdef TRTIS_ENABLE_GPU
@@ -36,6 +37,47 @@
 
 namespace nvidia { namespace inferenceserver {
 
+//
+// Memory
+//
+std::shared_ptr<Memory>
+Memory::ContiguousCopy(
+    TRTSERVER_Memory_Type memory_type, int64_t memory_type_id) const
+{
+  std::lock_guard<std::mutex> lock(copy_mtx_);
+  for (const auto& cc : contiguous_copies_) {
+    if ((cc.memory_type_ == memory_type) &&
+        (cc.memory_type_id_ == memory_type_id)) {
+      return cc.copy_;
+    }
+  }
+
+  return nullptr;
+}
+
+void
+Memory::SetContiguousCopy(
+    TRTSERVER_Memory_Type memory_type, int64_t memory_type_id,
+    const std::shared_ptr<Memory>& copy) const
+{
+  std::lock_guard<std::mutex> lock(copy_mtx_);
+  for (const auto& cc : contiguous_copies_) {
+    if ((cc.memory_type_ == memory_type) &&
+        (cc.memory_type_id_ == memory_type_id)) {
+      return;
+    }
+  }
+
+  contiguous_copies_.emplace_back(memory_type, memory_type_id, copy);
+}
+
+void
+Memory::InvalidateContiguousCopies()
+{
+  std::lock_guard<std::mutex> lock(copy_mtx_);
+  contiguous_copies_.clear();
+}
+
 //
 // MemoryReference
 //
@@ -66,6 +108,7 @@ MemoryReference::AddBuffer(
   total_byte_size_ += byte_size;
   buffer_count_++;
   buffer_.emplace_back(buffer, byte_size, memory_type, memory_type_id);
+  InvalidateContiguousCopies();
   return buffer_.size() - 1;
 }
 
@@ -148,10 +191,18 @@ AllocatedMemory::AllocatedMemory(
     }
   }
   total_byte_size_ = (buffer_ == nullptr) ? 0 : total_byte_size_;
+
+  // Charge the allocation to the model scope active on this thread,
+  // if any, using the actual memory type after any fallback.
+  usage_ = MemoryUsageTracker::Charge(memory_type_, total_byte_size_);
 }
 
 AllocatedMemory::~AllocatedMemory()
 {
+  if (usage_ != nullptr) {
+    MemoryUsageTracker::Release(usage_, memory_type_, total_byte_size_);
+  }
+
   if (buffer_ != nullptr) {
     switch (memory_type_) {
       case TRTSERVER_MEMORY_GPU: {
@@ -25,12 +25,16 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <vector>
 #include "src/core/constants.h"
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
 
+class MemoryUsage;
+
 //
 // Memory used to access data in inference requests
 //
@@ -55,10 +59,47 @@ class Memory {
   // Return the total byte size of the data buffer
   size_t TotalByteSize() const { return total_byte_size_; }
 
+  // Get a cached contiguous copy of this memory for
+  // 'memory_type'/'memory_type_id'. Returns nullptr if no copy has
+  // been cached for that memory type and id. \see SetContiguousCopy()
+  std::shared_ptr<Memory> ContiguousCopy(
+      TRTSERVER_Memory_Type memory_type, int64_t memory_type_id) const;
+
+  // Cache 'copy' as a contiguous copy of this memory for
+  // 'memory_type'/'memory_type_id' so that multiple consumers of the
+  // same memory pay the gather exactly once. If a copy is already
+  // cached for the memory type and id the existing copy is kept. The
+  // cache is cleared whenever the composition of the memory changes.
+  void SetContiguousCopy(
+      TRTSERVER_Memory_Type memory_type, int64_t memory_type_id,
+      const std::shared_ptr<Memory>& copy) const;
+
  protected:
   Memory() : total_byte_size_(0), buffer_count_(0) {}
+
+  // Drop any cached contiguous copies. Must be called whenever the
+  // buffers composing the memory change.
+  void InvalidateContiguousCopies();
+
   size_t total_byte_size_;
   size_t buffer_count_;
+
+ private:
+  struct ContiguousCopyEntry {
+    ContiguousCopyEntry(
+        TRTSERVER_Memory_Type memory_type, int64_t memory_type_id,
+        const std::shared_ptr<Memory>& copy)
+        : memory_type_(memory_type), memory_type_id_(memory_type_id),
+          copy_(copy)
+    {
+    }
+    TRTSERVER_Memory_Type memory_type_;
+    int64_t memory_type_id_;
+    std::shared_ptr<Memory> copy_;
+  };
+
+  mutable std::mutex copy_mtx_;
+  mutable std::vector<ContiguousCopyEntry> contiguous_copies_;
 };
 
 //
@@ -147,6 +188,12 @@ class AllocatedMemory : public MutableMemory {
       int64_t memory_type_id);
 
   ~AllocatedMemory() override;
+
+ private:
+  // The per-model usage record charged for this allocation, nullptr
+  // if no request scope was active when the allocation was made. See
+  // MemoryUsageTracker.
+  MemoryUsage* usage_;
 };
 
 }}  // namespace nvidia::inferenceserver
@@ -0,0 +1,161 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/memory_usage.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include "src/core/constants.h"
+
+#ifdef TRTIS_ENABLE_METRICS
+#include "src/core/metrics.h"
+#endif  // TRTIS_ENABLE_METRICS
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// The usage record being charged by the current thread, see
+// MemoryUsageTracker::Scope.
+thread_local MemoryUsage* current_usage = nullptr;
+
+struct UsageEntry {
+  MemoryUsage usage_;
+#ifdef TRTIS_ENABLE_METRICS
+  prometheus::Gauge* gauges_[MemoryUsage::KIND_COUNT];
+#endif  // TRTIS_ENABLE_METRICS
+};
+
+struct UsageRegistry {
+  std::mutex mu_;
+  std::map<std::string, std::unique_ptr<UsageEntry>> entries_;
+};
+
+UsageRegistry*
+GetUsageRegistry()
+{
+  static UsageRegistry registry;
+  return &registry;
+}
+
+#ifdef TRTIS_ENABLE_METRICS
+const char*
+KindString(const size_t kind)
+{
+  switch (kind) {
+    case MemoryUsage::GPU:
+      return "gpu";
+    case MemoryUsage::PINNED:
+      return "pinned";
+    default:
+      return "system";
+  }
+}
+
+// Refresh the usage gauges of every model at scrape time so the
+// allocation paths only touch the atomic counters. Must not be called
+// while holding the registry mutex; the sampler takes it at scrape
+// time.
+void
+EnsureUsageSampler(UsageRegistry* registry)
+{
+  static const uint64_t sampler_id = Metrics::AddSampler([registry]() {
+    std::lock_guard<std::mutex> lock(registry->mu_);
+    for (const auto& pr : registry->entries_) {
+      for (size_t kind = 0; kind < MemoryUsage::KIND_COUNT; kind++) {
+        pr.second->gauges_[kind]->Set(
+            pr.second->usage_.ByteSize(static_cast<MemoryUsage::Kind>(kind)));
+      }
+    }
+  });
+  (void)sampler_id;
+}
+#endif  // TRTIS_ENABLE_METRICS
+
+}  // namespace
+
+MemoryUsageTracker::Scope::Scope(MemoryUsage* usage)
+{
+  previous_ = current_usage;
+  current_usage = usage;
+}
+
+MemoryUsageTracker::Scope::~Scope()
+{
+  current_usage = previous_;
+}
+
+MemoryUsage*
+MemoryUsageTracker::UsageForModel(const std::string& model_name)
+{
+  auto registry = GetUsageRegistry();
+#ifdef TRTIS_ENABLE_METRICS
+  EnsureUsageSampler(registry);
+#endif  // TRTIS_ENABLE_METRICS
+  std::lock_guard<std::mutex> lock(registry->mu_);
+
+  auto itr = registry->entries_.find(model_name);
+  if (itr == registry->entries_.end()) {
+    std::unique_ptr<UsageEntry> entry(new UsageEntry());
+#ifdef TRTIS_ENABLE_METRICS
+    for (size_t kind = 0; kind < MemoryUsage::KIND_COUNT; kind++) {
+      std::map<std::string, std::string> labels;
+      labels.insert(std::map<std::string, std::string>::value_type(
+          std::string(kMetricsLabelModelName), model_name));
+      labels.insert(std::map<std::string, std::string>::value_type(
+          "kind", KindString(kind)));
+      entry->gauges_[kind] = &Metrics::FamilyMemoryUsage().Add(labels);
+    }
+#endif  // TRTIS_ENABLE_METRICS
+    itr = registry->entries_.emplace(model_name, std::move(entry)).first;
+  }
+
+  return &itr->second->usage_;
+}
+
+MemoryUsage*
+MemoryUsageTracker::Charge(
+    const TRTSERVER_Memory_Type memory_type, const size_t byte_size)
+{
+  MemoryUsage* usage = current_usage;
+  if ((usage == nullptr) || (byte_size == 0)) {
+    return nullptr;
+  }
+
+  usage->byte_size_[MemoryUsage::KindOf(memory_type)] += byte_size;
+  return usage;
+}
+
+void
+MemoryUsageTracker::Release(
+    MemoryUsage* usage, const TRTSERVER_Memory_Type memory_type,
+    const size_t byte_size)
+{
+  usage->byte_size_[MemoryUsage::KindOf(memory_type)] -= byte_size;
+}
+
+}}  // namespace nvidia::inferenceserver
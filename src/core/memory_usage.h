@@ -0,0 +1,117 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+// The host, pinned and device memory currently consumed by a model's
+// in-flight requests. The counters are kept current by the allocation
+// paths, see MemoryUsageTracker; readers only need plain atomic loads
+// so the admission check and a metrics scrape never contend with
+// allocation.
+class MemoryUsage {
+ public:
+  enum Kind {
+    SYSTEM = 0,
+    PINNED = 1,
+    GPU = 2,
+    KIND_COUNT = 3,
+  };
+
+  MemoryUsage()
+  {
+    for (auto& byte_size : byte_size_) {
+      byte_size = 0;
+    }
+  }
+
+  // Get the byte size currently consumed for a memory kind.
+  uint64_t ByteSize(const Kind kind) const { return byte_size_[kind].load(); }
+
+  // Get the memory kind for a memory type, mapping the pageable
+  // fallback of a pinned allocation to SYSTEM.
+  static Kind KindOf(const TRTSERVER_Memory_Type memory_type)
+  {
+    switch (memory_type) {
+      case TRTSERVER_MEMORY_GPU:
+        return GPU;
+      case TRTSERVER_MEMORY_CPU_PINNED:
+        return PINNED;
+      default:
+        return SYSTEM;
+    }
+  }
+
+ private:
+  friend class MemoryUsageTracker;
+
+  std::atomic<uint64_t> byte_size_[KIND_COUNT];
+};
+
+// Tracks the memory consumed by each model's in-flight requests. The
+// request paths name the model being served with a Scope; allocations
+// made by a thread while a scope is active are charged to that
+// model's usage record. Records live for the lifetime of the server
+// so a charged allocation can always be released, and each model's
+// usage is exported as nv_memory_usage_bytes gauges refreshed at
+// scrape time.
+class MemoryUsageTracker {
+ public:
+  // Names the model charged for allocations made by the current
+  // thread while the scope is alive. Scopes nest; the enclosing scope
+  // is restored when the scope is destroyed.
+  class Scope {
+   public:
+    explicit Scope(MemoryUsage* usage);
+    ~Scope();
+
+   private:
+    MemoryUsage* previous_;
+  };
+
+  // Get the usage record for a model, creating it on first use. The
+  // returned record is valid for the lifetime of the server.
+  static MemoryUsage* UsageForModel(const std::string& model_name);
+
+  // Charge 'byte_size' bytes of 'memory_type' to the model scope
+  // active on the current thread. Returns the record charged so the
+  // charge can be released from any thread, nullptr if no scope is
+  // active or 'byte_size' is 0.
+  static MemoryUsage* Charge(
+      const TRTSERVER_Memory_Type memory_type, const size_t byte_size);
+
+  // Release a charge made by Charge(). 'usage' must be the record
+  // returned by the matching Charge() call.
+  static void Release(
+      MemoryUsage* usage, const TRTSERVER_Memory_Type memory_type,
+      const size_t byte_size);
+};
+
+}}  // namespace nvidia::inferenceserver
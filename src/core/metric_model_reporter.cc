@@ -26,6 +26,9 @@
 
 #include "src/core/metric_model_reporter.h"
 
+#include <stdlib.h>
+#include <mutex>
+#include <sstream>
 #include "src/core/constants.h"
 #include "src/core/metrics.h"
 
@@ -138,6 +141,155 @@ MetricModelReporter::MetricInferenceQueueDuration(int gpu_device) const
       gpu_device);
 }
 
+const std::vector<double>&
+MetricModelReporter::DurationBuckets()
+{
+  static std::vector<double> buckets;
+  static std::once_flag once;
+  std::call_once(once, []() {
+    // The boundaries can be overridden with a comma-separated list of
+    // microsecond values.
+    const char* bstr = getenv("TRTSERVER_METRICS_DURATION_BUCKETS");
+    if (bstr != nullptr) {
+      std::stringstream ss(bstr);
+      std::string boundary;
+      while (std::getline(ss, boundary, ',')) {
+        buckets.push_back(atof(boundary.c_str()));
+      }
+    }
+    if (buckets.empty()) {
+      // Log-spaced from 50us to ~100s, doubling each bucket, so that
+      // the relative quantile error is bounded across the full
+      // latency range.
+      for (double boundary = 50.0; boundary <= 100000000.0; boundary *= 2.0) {
+        buckets.push_back(boundary);
+      }
+    }
+  });
+
+  return buckets;
+}
+
+prometheus::Histogram&
+MetricModelReporter::GetDurationHistogramMetric(
+    std::map<int, prometheus::Histogram*>& metrics,
+    prometheus::Family<prometheus::Histogram>& family,
+    const int gpu_device) const
+{
+  const auto itr = metrics.find(gpu_device);
+  if (itr != metrics.end()) {
+    return *(itr->second);
+  }
+
+  std::map<std::string, std::string> labels;
+  GetMetricLabels(&labels, gpu_device);
+
+  prometheus::Histogram& hist = family.Add(labels, DurationBuckets());
+  metrics.insert(
+      std::map<int, prometheus::Histogram*>::value_type(gpu_device, &hist));
+  return hist;
+}
+
+prometheus::Histogram&
+MetricModelReporter::MetricInferenceRequestDurationHistogram(
+    int gpu_device) const
+{
+  return GetDurationHistogramMetric(
+      metric_inf_request_duration_us_hist_,
+      Metrics::FamilyInferenceRequestDurationHistogram(), gpu_device);
+}
+
+prometheus::Histogram&
+MetricModelReporter::MetricInferenceComputeDurationHistogram(
+    int gpu_device) const
+{
+  return GetDurationHistogramMetric(
+      metric_inf_compute_duration_us_hist_,
+      Metrics::FamilyInferenceComputeDurationHistogram(), gpu_device);
+}
+
+prometheus::Histogram&
+MetricModelReporter::MetricInferenceQueueDurationHistogram(
+    int gpu_device) const
+{
+  return GetDurationHistogramMetric(
+      metric_inf_queue_duration_us_hist_,
+      Metrics::FamilyInferenceQueueDurationHistogram(), gpu_device);
+}
+
+prometheus::Gauge&
+MetricModelReporter::GetGaugeMetric(
+    std::map<int, prometheus::Gauge*>& metrics,
+    prometheus::Family<prometheus::Gauge>& family, const int gpu_device) const
+{
+  const auto itr = metrics.find(gpu_device);
+  if (itr != metrics.end()) {
+    return *(itr->second);
+  }
+
+  std::map<std::string, std::string> labels;
+  GetMetricLabels(&labels, gpu_device);
+
+  prometheus::Gauge& gauge = family.Add(labels);
+  metrics.insert(
+      std::map<int, prometheus::Gauge*>::value_type(gpu_device, &gauge));
+  return gauge;
+}
+
+prometheus::Gauge&
+MetricModelReporter::MetricModelQueueDepth(int gpu_device) const
+{
+  return GetGaugeMetric(
+      metric_model_queue_depth_, Metrics::FamilyModelQueueDepth(), gpu_device);
+}
+
+prometheus::Gauge&
+MetricModelReporter::MetricModelOldestRequestAge(int gpu_device) const
+{
+  return GetGaugeMetric(
+      metric_model_oldest_request_age_, Metrics::FamilyModelOldestRequestAge(),
+      gpu_device);
+}
+
+prometheus::Histogram&
+MetricModelReporter::MetricInferenceBatchOccupancy(int gpu_device) const
+{
+  const auto itr = metric_inf_batch_occupancy_.find(gpu_device);
+  if (itr != metric_inf_batch_occupancy_.end()) {
+    return *(itr->second);
+  }
+
+  std::map<std::string, std::string> labels;
+  GetMetricLabels(&labels, gpu_device);
+
+  prometheus::Histogram& hist = Metrics::FamilyInferenceBatchOccupancy().Add(
+      labels, std::vector<double>{0.125, 0.25, 0.375, 0.5, 0.625, 0.75, 0.875,
+                                  1.0});
+  metric_inf_batch_occupancy_.insert(
+      std::map<int, prometheus::Histogram*>::value_type(gpu_device, &hist));
+  return hist;
+}
+
+prometheus::Histogram&
+MetricModelReporter::MetricInferenceStageDuration(const char* stage) const
+{
+  const auto itr = metric_inf_stage_duration_us_.find(stage);
+  if (itr != metric_inf_stage_duration_us_.end()) {
+    return *(itr->second);
+  }
+
+  std::map<std::string, std::string> labels;
+  GetMetricLabels(&labels, -1 /* gpu_device */);
+  labels.insert(
+      std::map<std::string, std::string>::value_type("stage", stage));
+
+  prometheus::Histogram& hist =
+      Metrics::FamilyInferenceStageDuration().Add(labels, DurationBuckets());
+  metric_inf_stage_duration_us_.insert(
+      std::map<std::string, prometheus::Histogram*>::value_type(stage, &hist));
+  return hist;
+}
+
 prometheus::Histogram&
 MetricModelReporter::MetricInferenceLoadRatio(int gpu_device) const
 {
@@ -61,6 +61,27 @@ class MetricModelReporter {
   prometheus::Counter& MetricInferenceComputeDuration(int gpu_device) const;
   prometheus::Counter& MetricInferenceQueueDuration(int gpu_device) const;
   prometheus::Histogram& MetricInferenceLoadRatio(int gpu_device) const;
+
+  // Duration histograms with log-spaced buckets so that latency
+  // percentiles can be computed directly from Prometheus. Durations
+  // are observed in microseconds.
+  prometheus::Histogram& MetricInferenceRequestDurationHistogram(
+      int gpu_device) const;
+  prometheus::Histogram& MetricInferenceComputeDurationHistogram(
+      int gpu_device) const;
+  prometheus::Histogram& MetricInferenceQueueDurationHistogram(
+      int gpu_device) const;
+
+  // Scheduler queue-state gauges, refreshed at scrape time by a
+  // metrics sampler, and the executed-batch occupancy histogram.
+  prometheus::Gauge& MetricModelQueueDepth(int gpu_device) const;
+  prometheus::Gauge& MetricModelOldestRequestAge(int gpu_device) const;
+  prometheus::Histogram& MetricInferenceBatchOccupancy(int gpu_device) const;
+
+  // Duration histogram for one pipeline stage of the model, see
+  // ModelInferStats::Report() for the stage names.
+  prometheus::Histogram& MetricInferenceStageDuration(
+      const char* stage) const;
 #endif  // TRTIS_ENABLE_STATS
 #endif  // TRTIS_ENABLE_METRICS
 
@@ -77,6 +98,18 @@ class MetricModelReporter {
       std::map<int, prometheus::Counter*>& metrics,
       prometheus::Family<prometheus::Counter>& family,
       const int gpu_device) const;
+  prometheus::Histogram& GetDurationHistogramMetric(
+      std::map<int, prometheus::Histogram*>& metrics,
+      prometheus::Family<prometheus::Histogram>& family,
+      const int gpu_device) const;
+  prometheus::Gauge& GetGaugeMetric(
+      std::map<int, prometheus::Gauge*>& metrics,
+      prometheus::Family<prometheus::Gauge>& family,
+      const int gpu_device) const;
+
+  // The log-spaced bucket boundaries used for the duration
+  // histograms, in microseconds.
+  static const std::vector<double>& DurationBuckets();
 
   mutable std::map<int, prometheus::Counter*> metric_inf_success_;
   mutable std::map<int, prometheus::Counter*> metric_inf_failure_;
@@ -86,6 +119,17 @@ class MetricModelReporter {
   mutable std::map<int, prometheus::Counter*> metric_inf_compute_duration_us_;
   mutable std::map<int, prometheus::Counter*> metric_inf_queue_duration_us_;
   mutable std::map<int, prometheus::Histogram*> metric_inf_load_ratio_;
+  mutable std::map<int, prometheus::Histogram*>
+      metric_inf_request_duration_us_hist_;
+  mutable std::map<int, prometheus::Histogram*>
+      metric_inf_compute_duration_us_hist_;
+  mutable std::map<int, prometheus::Histogram*>
+      metric_inf_queue_duration_us_hist_;
+  mutable std::map<int, prometheus::Gauge*> metric_model_queue_depth_;
+  mutable std::map<int, prometheus::Gauge*> metric_model_oldest_request_age_;
+  mutable std::map<int, prometheus::Histogram*> metric_inf_batch_occupancy_;
+  mutable std::map<std::string, prometheus::Histogram*>
+      metric_inf_stage_duration_us_;
 #endif  // TRTIS_ENABLE_STATS
 #endif  // TRTIS_ENABLE_METRICS
 };
@@ -29,6 +29,10 @@
 
 #include "src/core/metrics.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits>
 #include <thread>
 #include "src/core/constants.h"
 #include "src/core/logging.h"
@@ -36,13 +40,41 @@
 #ifdef TRTIS_ENABLE_METRICS_GPU
 #include <cuda_runtime_api.h>
 #include <nvml.h>
+#ifdef TRTIS_ENABLE_METRICS_DCGM
+#include <dcgm_agent.h>
+#include <dcgm_fields.h>
+#include <dcgm_structs.h>
+#endif  // TRTIS_ENABLE_METRICS_DCGM
 #endif  // TRTIS_ENABLE_METRICS_GPU
 
 namespace nvidia { namespace inferenceserver {
 
+#ifdef TRTIS_ENABLE_METRICS_GPU
+namespace {
+
+// The interval between GPU metric collections, in milliseconds. Can
+// be overridden with the TRTSERVER_METRICS_GPU_INTERVAL_MS
+// environment variable.
+uint64_t
+GpuMetricsIntervalMs()
+{
+  uint64_t interval_ms = 2000;
+  const char* istr = getenv("TRTSERVER_METRICS_GPU_INTERVAL_MS");
+  if (istr != nullptr) {
+    const int64_t parsed_ms = atoll(istr);
+    if (parsed_ms > 0) {
+      interval_ms = parsed_ms;
+    }
+  }
+  return interval_ms;
+}
+
+}  // namespace
+#endif  // TRTIS_ENABLE_METRICS_GPU
+
 Metrics::Metrics()
     : registry_(std::make_shared<prometheus::Registry>()),
-      serializer_(new prometheus::TextSerializer()),
+      serializer_(new prometheus::TextSerializer()), next_sampler_id_(1),
 #ifdef TRTIS_ENABLE_STATS
       inf_success_family_(
           prometheus::BuildCounter()
@@ -80,6 +112,46 @@ Metrics::Metrics()
       inf_load_ratio_family_(prometheus::BuildHistogram()
                                  .Name("nv_inference_load_ratio")
                                  .Register(*registry_)),
+      inf_request_duration_us_hist_family_(
+          prometheus::BuildHistogram()
+              .Name("nv_inference_request_duration_histogram_us")
+              .Help("Histogram of inference request duration in microseconds")
+              .Register(*registry_)),
+      inf_compute_duration_us_hist_family_(
+          prometheus::BuildHistogram()
+              .Name("nv_inference_compute_duration_histogram_us")
+              .Help("Histogram of inference compute duration in microseconds")
+              .Register(*registry_)),
+      inf_queue_duration_us_hist_family_(
+          prometheus::BuildHistogram()
+              .Name("nv_inference_queue_duration_histogram_us")
+              .Help("Histogram of inference queuing duration in microseconds")
+              .Register(*registry_)),
+      model_queue_depth_family_(
+          prometheus::BuildGauge()
+              .Name("nv_model_queue_depth")
+              .Help("Number of inference requests currently queued in the "
+                    "model's scheduler")
+              .Register(*registry_)),
+      model_oldest_request_age_us_family_(
+          prometheus::BuildGauge()
+              .Name("nv_model_oldest_request_age_us")
+              .Help("Age of the oldest queued inference request in "
+                    "microseconds")
+              .Register(*registry_)),
+      inf_batch_occupancy_family_(
+          prometheus::BuildHistogram()
+              .Name("nv_inference_batch_occupancy")
+              .Help("Executed batch size as a fraction of the maximum "
+                    "preferred batch size")
+              .Register(*registry_)),
+      inf_stage_duration_us_family_(
+          prometheus::BuildHistogram()
+              .Name("nv_inference_stage_duration_us")
+              .Help("Histogram of inference duration per pipeline stage in "
+                    "microseconds, recorded for sampled requests when stage "
+                    "timing is enabled")
+              .Register(*registry_)),
 #endif  // TRTIS_ENABLE_STATS
 #ifdef TRTIS_ENABLE_METRICS_GPU
       gpu_utilization_family_(prometheus::BuildGauge()
@@ -108,11 +180,60 @@ Metrics::Metrics()
               .Help("GPU energy consumption in joules since the Triton Server "
                     "started")
               .Register(*registry_)),
+      gpu_transfer_bytes_family_(
+          prometheus::BuildCounter()
+              .Name("nv_gpu_transfer_bytes")
+              .Help("Bytes copied between GPU devices since the Triton Server "
+                    "started, labeled by whether the direct peer-to-peer path "
+                    "was used")
+              .Register(*registry_)),
 #endif  // TRTIS_ENABLE_METRICS_GPU
+      memory_usage_family_(
+          prometheus::BuildGauge()
+              .Name("nv_memory_usage_bytes")
+              .Help("Host, pinned and GPU memory consumed by the model's "
+                    "in-flight requests, in bytes")
+              .Register(*registry_)),
+      pinned_pool_free_bytes_family_(
+          prometheus::BuildGauge()
+              .Name("nv_pinned_pool_free_bytes")
+              .Help("Free bytes in the pinned memory pool, labeled by the "
+                    "size class holding them")
+              .Register(*registry_)),
+      pinned_pool_largest_free_bytes_family_(
+          prometheus::BuildGauge()
+              .Name("nv_pinned_pool_largest_free_block_bytes")
+              .Help("Largest contiguous free block available in the pinned "
+                    "memory pool, in bytes")
+              .Register(*registry_)),
+      pinned_pool_fallback_family_(
+          prometheus::BuildCounter()
+              .Name("nv_pinned_pool_fallback_total")
+              .Help("Allocations served from non-pinned system memory "
+                    "because the pinned pool could not satisfy them")
+              .Register(*registry_)),
       gpu_metrics_enabled_(false)
 {
 }
 
+uint64_t
+Metrics::AddSampler(std::function<void()> sampler)
+{
+  auto singleton = GetSingleton();
+  std::lock_guard<std::mutex> lock(singleton->sampler_mu_);
+  const uint64_t sampler_id = singleton->next_sampler_id_++;
+  singleton->samplers_.emplace(sampler_id, std::move(sampler));
+  return sampler_id;
+}
+
+void
+Metrics::RemoveSampler(const uint64_t sampler_id)
+{
+  auto singleton = GetSingleton();
+  std::lock_guard<std::mutex> lock(singleton->sampler_mu_);
+  singleton->samplers_.erase(sampler_id);
+}
+
 Metrics::~Metrics()
 {
 #ifdef TRTIS_ENABLE_METRICS_GPU
@@ -121,6 +242,16 @@ Metrics::~Metrics()
     nvml_thread_exit_.store(true);
     nvml_thread_->join();
   }
+
+#ifdef TRTIS_ENABLE_METRICS_DCGM
+  // Signal the dcgm thread to exit and then wait for it...
+  if (dcgm_thread_ != nullptr) {
+    dcgm_thread_exit_.store(true);
+    dcgm_thread_->join();
+    dcgmStopEmbedded(dcgm_handle_);
+    dcgmShutdown();
+  }
+#endif  // TRTIS_ENABLE_METRICS_DCGM
 #endif  // TRTIS_ENABLE_METRICS_GPU
 }
 
@@ -134,12 +265,200 @@ Metrics::EnableGPUMetrics()
   }
 
   if (std::getenv("TRITON_SERVER_CPU_ONLY") == nullptr) {
-    singleton->InitializeNvmlMetrics();
+    // Prefer DCGM, which retrieves every field for every GPU with a
+    // single batched read; fall back to per-device NVML queries if
+    // DCGM is not available.
+    if (!singleton->InitializeDcgmMetrics()) {
+      singleton->InitializeNvmlMetrics();
+    }
   }
 
   singleton->gpu_metrics_enabled_ = true;
 }
 
+#ifdef TRTIS_ENABLE_METRICS_DCGM
+int
+Metrics::DcgmValuesCallback(
+    unsigned int gpu_id, dcgmFieldValue_v1* values, int num_values,
+    void* user_data)
+{
+  Metrics* metrics = reinterpret_cast<Metrics*>(user_data);
+  const auto itr = metrics->dcgm_gpu_index_.find(gpu_id);
+  if (itr == metrics->dcgm_gpu_index_.end()) {
+    return 0;
+  }
+
+  const size_t didx = itr->second;
+  for (int vidx = 0; vidx < num_values; ++vidx) {
+    const dcgmFieldValue_v1& value = values[vidx];
+    if (value.status != DCGM_ST_OK) {
+      continue;
+    }
+
+    switch (value.fieldId) {
+      case DCGM_FI_DEV_POWER_MGMT_LIMIT:
+        metrics->gpu_power_limit_[didx]->Set(value.value.dbl);
+        break;
+      case DCGM_FI_DEV_POWER_USAGE:
+        metrics->gpu_power_usage_[didx]->Set(value.value.dbl);
+        break;
+      case DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION: {
+        // DCGM reports cumulative energy in millijoules; the metric
+        // is the joules consumed since the server started.
+        const unsigned long long energy = value.value.i64;
+        if (metrics->dcgm_last_energy_[didx] == 0) {
+          metrics->dcgm_last_energy_[didx] = energy;
+        }
+        metrics->gpu_energy_consumption_[didx]->Increment(
+            (double)(energy - metrics->dcgm_last_energy_[didx]) * 0.001);
+        metrics->dcgm_last_energy_[didx] = energy;
+        break;
+      }
+      case DCGM_FI_DEV_GPU_UTIL:
+        metrics->gpu_utilization_[didx]->Set((double)value.value.i64 * 0.01);
+        break;
+      case DCGM_FI_DEV_FB_USED:
+        // DCGM reports framebuffer sizes in MB, the metric is in
+        // bytes.
+        metrics->gpu_memory_used_[didx]->Set(
+            (double)value.value.i64 * 1024 * 1024);
+        break;
+      case DCGM_FI_DEV_FB_TOTAL:
+        metrics->gpu_memory_total_[didx]->Set(
+            (double)value.value.i64 * 1024 * 1024);
+        break;
+      default:
+        break;
+    }
+  }
+
+  return 0;
+}
+#endif  // TRTIS_ENABLE_METRICS_DCGM
+
+bool
+Metrics::InitializeDcgmMetrics()
+{
+#ifndef TRTIS_ENABLE_METRICS_DCGM
+  return false;
+#else
+  dcgmReturn_t dcgmerr = dcgmInit();
+  if (dcgmerr != DCGM_ST_OK) {
+    LOG_ERROR << "failed to initialize DCGM: DCGM_ST_ERROR " << dcgmerr;
+    return false;
+  }
+
+  dcgmerr = dcgmStartEmbedded(DCGM_OPERATION_MODE_MANUAL, &dcgm_handle_);
+  if (dcgmerr != DCGM_ST_OK) {
+    LOG_ERROR << "failed to start embedded DCGM: DCGM_ST_ERROR " << dcgmerr;
+    dcgmShutdown();
+    return false;
+  }
+
+  unsigned int gpu_ids[DCGM_MAX_NUM_DEVICES];
+  int dcnt = 0;
+  dcgmerr = dcgmGetAllSupportedDevices(dcgm_handle_, gpu_ids, &dcnt);
+  if ((dcgmerr != DCGM_ST_OK) || (dcnt <= 0)) {
+    LOG_ERROR << "failed to get device count for dcgm metrics: DCGM_ST_ERROR "
+              << dcgmerr;
+    dcgmStopEmbedded(dcgm_handle_);
+    dcgmShutdown();
+    return false;
+  }
+
+  // Create DCGM metrics for each GPU
+  LOG_INFO << "found " << dcnt << " GPUs supporting DCGM metrics";
+  for (int didx = 0; didx < dcnt; ++didx) {
+    dcgmDeviceAttributes_t attrs;
+    attrs.version = dcgmDeviceAttributes_version;
+    dcgmerr = dcgmGetDeviceAttributes(dcgm_handle_, gpu_ids[didx], &attrs);
+
+    std::string uuid("unknown");
+    if (dcgmerr == DCGM_ST_OK) {
+      LOG_INFO << "  GPU " << gpu_ids[didx] << ": "
+               << attrs.identifiers.deviceName;
+      uuid = attrs.identifiers.uuid;
+    } else {
+      LOG_ERROR << "failed to get device attributes for GPU " << gpu_ids[didx]
+                << ": DCGM_ST_ERROR " << dcgmerr;
+    }
+
+    std::map<std::string, std::string> gpu_labels;
+    gpu_labels.insert(std::map<std::string, std::string>::value_type(
+        kMetricsLabelGpuUuid, uuid));
+
+    gpu_utilization_.push_back(&gpu_utilization_family_.Add(gpu_labels));
+    gpu_memory_total_.push_back(&gpu_memory_total_family_.Add(gpu_labels));
+    gpu_memory_used_.push_back(&gpu_memory_used_family_.Add(gpu_labels));
+    gpu_power_usage_.push_back(&gpu_power_usage_family_.Add(gpu_labels));
+    gpu_power_limit_.push_back(&gpu_power_limit_family_.Add(gpu_labels));
+    gpu_energy_consumption_.push_back(
+        &gpu_energy_consumption_family_.Add(gpu_labels));
+
+    dcgm_gpu_index_[gpu_ids[didx]] = didx;
+    dcgm_last_energy_.push_back(0);
+  }
+
+  // A single field group covering every exported metric, so that one
+  // batched read per interval retrieves all fields for all GPUs.
+  unsigned short field_ids[] = {
+      DCGM_FI_DEV_POWER_MGMT_LIMIT,         DCGM_FI_DEV_POWER_USAGE,
+      DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION, DCGM_FI_DEV_GPU_UTIL,
+      DCGM_FI_DEV_FB_USED,                  DCGM_FI_DEV_FB_TOTAL};
+  const int field_cnt = sizeof(field_ids) / sizeof(field_ids[0]);
+
+  dcgmFieldGrp_t field_group;
+  char field_group_name[] = "trtis_gpu_metrics";
+  dcgmerr = dcgmFieldGroupCreate(
+      dcgm_handle_, field_cnt, field_ids, field_group_name, &field_group);
+  if (dcgmerr != DCGM_ST_OK) {
+    LOG_ERROR << "failed to create DCGM field group: DCGM_ST_ERROR " << dcgmerr;
+    dcgmStopEmbedded(dcgm_handle_);
+    dcgmShutdown();
+    return false;
+  }
+
+  const uint64_t interval_ms = GpuMetricsIntervalMs();
+  dcgmerr = dcgmWatchFields(
+      dcgm_handle_, DCGM_GROUP_ALL_GPUS, field_group,
+      interval_ms * 1000 /* updateFreq, us */, 0 /* maxKeepAge, sec */,
+      1 /* maxKeepSamples */);
+  if (dcgmerr != DCGM_ST_OK) {
+    LOG_ERROR << "failed to watch DCGM fields: DCGM_ST_ERROR " << dcgmerr;
+    dcgmStopEmbedded(dcgm_handle_);
+    dcgmShutdown();
+    return false;
+  }
+
+  // Periodically collect and send the DCGM metrics...
+  dcgm_thread_exit_.store(false);
+  dcgm_thread_.reset(new std::thread([this, field_group, interval_ms] {
+    while (!dcgm_thread_exit_.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+
+      dcgmReturn_t dcgmerr = dcgmUpdateAllFields(dcgm_handle_, 1 /* wait */);
+      if (dcgmerr != DCGM_ST_OK) {
+        LOG_WARNING << "failed to update DCGM fields: DCGM_ST_ERROR "
+                    << dcgmerr;
+        continue;
+      }
+
+      // One call delivers the latest value of every watched field for
+      // every GPU via DcgmValuesCallback.
+      dcgmerr = dcgmGetLatestValues(
+          dcgm_handle_, DCGM_GROUP_ALL_GPUS, field_group, DcgmValuesCallback,
+          this);
+      if (dcgmerr != DCGM_ST_OK) {
+        LOG_WARNING << "failed to get latest DCGM values: DCGM_ST_ERROR "
+                    << dcgmerr;
+      }
+    }
+  }));
+
+  return true;
+#endif  // TRTIS_ENABLE_METRICS_DCGM
+}
+
 bool
 Metrics::InitializeNvmlMetrics()
 {
@@ -202,8 +521,9 @@ Metrics::InitializeNvmlMetrics()
 
   // Periodically send the NVML metrics...
   if (dcnt > 0) {
+    const uint64_t interval_ms = GpuMetricsIntervalMs();
     nvml_thread_exit_.store(false);
-    nvml_thread_.reset(new std::thread([this, dcnt] {
+    nvml_thread_.reset(new std::thread([this, dcnt, interval_ms] {
       // Stop attempting any metric the fails multiple consecutive
       // times for a device.
       constexpr int fail_threshold = 3;
@@ -219,7 +539,7 @@ Metrics::InitializeNvmlMetrics()
       }
 
       while (!nvml_thread_exit_.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
 
         for (unsigned int didx = 0; didx < dcnt; ++didx) {
           nvmlDevice_t gpu;
@@ -370,12 +690,306 @@ Metrics::GetRegistry()
   return singleton->registry_;
 }
 
+namespace {
+
+// Append 'value' to 'out' in the Prometheus text exposition format,
+// with the same precision the generic text serializer uses.
+void
+AppendMetricValue(std::string* out, const double value)
+{
+  char buffer[64];
+  const int len = snprintf(
+      buffer, sizeof(buffer), "%.*g",
+      std::numeric_limits<double>::max_digits10 - 1, value);
+  out->append(buffer, len);
+}
+
+// Append 'value' to 'out' with the escaping required for a label
+// value.
+void
+AppendEscapedLabelValue(std::string* out, const std::string& value)
+{
+  for (const char c : value) {
+    if ((c == '\\') || (c == '"')) {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (c == '\n') {
+      out->append("\\n");
+    } else {
+      out->push_back(c);
+    }
+  }
+}
+
+// Append 'help' to 'out' with the escaping required for a help
+// string.
+void
+AppendEscapedHelp(std::string* out, const std::string& help)
+{
+  for (const char c : help) {
+    if (c == '\\') {
+      out->append("\\\\");
+    } else if (c == '\n') {
+      out->append("\\n");
+    } else {
+      out->push_back(c);
+    }
+  }
+}
+
+const char*
+MetricTypeString(const prometheus::MetricType type)
+{
+  switch (type) {
+    case prometheus::MetricType::Counter:
+      return "counter";
+    case prometheus::MetricType::Gauge:
+      return "gauge";
+    case prometheus::MetricType::Histogram:
+      return "histogram";
+    case prometheus::MetricType::Summary:
+      return "summary";
+    default:
+      return "untyped";
+  }
+}
+
+// Append "name<suffix>{label set} " up to where the value goes. The
+// label set is omitted entirely when there are no labels.
+void
+AppendMetricPrefix(
+    std::string* out, const std::string& name, const char* suffix,
+    const prometheus::ClientMetric& metric, const std::string* extra_label)
+{
+  out->append(name);
+  out->append(suffix);
+  if (!metric.label.empty() || (extra_label != nullptr)) {
+    out->push_back('{');
+    bool first = true;
+    for (const auto& label : metric.label) {
+      if (!first) {
+        out->push_back(',');
+      }
+      first = false;
+      out->append(label.name);
+      out->append("=\"");
+      AppendEscapedLabelValue(out, label.value);
+      out->push_back('"');
+    }
+
+    if (extra_label != nullptr) {
+      if (!first) {
+        out->push_back(',');
+      }
+      out->append(*extra_label);
+    }
+
+    out->push_back('}');
+  }
+
+  out->push_back(' ');
+}
+
+void
+HashCombine(uint64_t* seed, const uint64_t value)
+{
+  *seed ^= value + 0x9e3779b97f4a7c15ull + (*seed << 6) + (*seed >> 2);
+}
+
+// Compute a value that identifies the static layout of a collected
+// snapshot: the family names and types, the label sets and the
+// histogram buckets, but not the metric values. Also count the number
+// of values the exposition carries and report whether the snapshot
+// contains a metric type the cached layout doesn't handle.
+uint64_t
+ExpositionSignature(
+    const std::vector<prometheus::MetricFamily>& families, size_t* value_cnt,
+    bool* fallback)
+{
+  const std::hash<std::string> hasher;
+  uint64_t signature = families.size();
+  *value_cnt = 0;
+  *fallback = false;
+
+  for (const auto& family : families) {
+    HashCombine(&signature, hasher(family.name));
+    HashCombine(&signature, static_cast<uint64_t>(family.type));
+    switch (family.type) {
+      case prometheus::MetricType::Counter:
+      case prometheus::MetricType::Gauge:
+      case prometheus::MetricType::Untyped:
+      case prometheus::MetricType::Histogram:
+        break;
+      default:
+        // e.g. a summary registered by an external user of
+        // GetRegistry().
+        *fallback = true;
+        break;
+    }
+
+    for (const auto& metric : family.metric) {
+      for (const auto& label : metric.label) {
+        HashCombine(&signature, hasher(label.name));
+        HashCombine(&signature, hasher(label.value));
+      }
+
+      if (family.type == prometheus::MetricType::Histogram) {
+        for (const auto& bucket : metric.histogram.bucket) {
+          uint64_t bound_bits;
+          memcpy(&bound_bits, &bucket.upper_bound, sizeof(bound_bits));
+          HashCombine(&signature, bound_bits);
+        }
+        // The buckets plus the +Inf bucket, sum and count lines.
+        *value_cnt += metric.histogram.bucket.size() + 3;
+      } else {
+        *value_cnt += 1;
+      }
+    }
+  }
+
+  return signature;
+}
+
+}  // namespace
+
+void
+Metrics::RebuildExpositionLayout(
+    const std::vector<prometheus::MetricFamily>& families,
+    const uint64_t signature, const size_t value_cnt)
+{
+  // Must hold the lock on 'exposition_mu_' while calling this
+  // function.
+  exposition_fragments_.clear();
+  exposition_fragments_.reserve(value_cnt + 1);
+
+  // The exposition is fragments[0] value0 fragments[1] value1 ...
+  // fragments[n]. 'fragment' accumulates static text until the next
+  // value position; each fragment after the first starts with the
+  // newline that terminates the preceding value's line.
+  std::string fragment;
+  auto cut = [this, &fragment]() {
+    exposition_fragments_.push_back(fragment);
+    fragment.clear();
+    fragment.push_back('\n');
+  };
+
+  for (const auto& family : families) {
+    fragment.append("# HELP ");
+    fragment.append(family.name);
+    fragment.push_back(' ');
+    AppendEscapedHelp(&fragment, family.help);
+    fragment.append("\n# TYPE ");
+    fragment.append(family.name);
+    fragment.push_back(' ');
+    fragment.append(MetricTypeString(family.type));
+    fragment.push_back('\n');
+
+    for (const auto& metric : family.metric) {
+      if (family.type == prometheus::MetricType::Histogram) {
+        for (const auto& bucket : metric.histogram.bucket) {
+          std::string le_label = "le=\"";
+          AppendMetricValue(&le_label, bucket.upper_bound);
+          le_label.push_back('"');
+          AppendMetricPrefix(
+              &fragment, family.name, "_bucket", metric, &le_label);
+          cut();
+        }
+
+        const std::string inf_label = "le=\"+Inf\"";
+        AppendMetricPrefix(&fragment, family.name, "_bucket", metric, &inf_label);
+        cut();
+        AppendMetricPrefix(&fragment, family.name, "_sum", metric, nullptr);
+        cut();
+        AppendMetricPrefix(&fragment, family.name, "_count", metric, nullptr);
+        cut();
+      } else {
+        AppendMetricPrefix(&fragment, family.name, "", metric, nullptr);
+        cut();
+      }
+    }
+  }
+
+  exposition_fragments_.push_back(fragment);
+
+  exposition_signature_ = signature;
+  exposition_value_cnt_ = value_cnt;
+  exposition_valid_ = true;
+}
+
 const std::string
 Metrics::SerializedMetrics()
 {
   auto singleton = Metrics::GetSingleton();
-  return singleton->serializer_->Serialize(
-      singleton->registry_.get()->Collect());
+
+  // Refresh point-in-time values before collecting so that scrapes
+  // observe current queue state without any bookkeeping on the
+  // inference hot path.
+  {
+    std::lock_guard<std::mutex> lock(singleton->sampler_mu_);
+    for (const auto& pr : singleton->samplers_) {
+      pr.second();
+    }
+  }
+
+  const auto families = singleton->registry_.get()->Collect();
+
+  std::lock_guard<std::mutex> lock(singleton->exposition_mu_);
+
+  size_t value_cnt = 0;
+  bool fallback = false;
+  const uint64_t signature =
+      ExpositionSignature(families, &value_cnt, &fallback);
+  if (fallback) {
+    return singleton->serializer_->Serialize(families);
+  }
+
+  if (!singleton->exposition_valid_ ||
+      (signature != singleton->exposition_signature_) ||
+      (value_cnt != singleton->exposition_value_cnt_)) {
+    singleton->RebuildExpositionLayout(families, signature, value_cnt);
+  }
+
+  // Fill the values in between the precomputed static fragments,
+  // reusing the buffer (and its capacity) across scrapes. The walk
+  // order must match RebuildExpositionLayout exactly.
+  std::string& buffer = singleton->exposition_buffer_;
+  buffer.clear();
+  size_t fidx = 0;
+  const auto& fragments = singleton->exposition_fragments_;
+  for (const auto& family : families) {
+    for (const auto& metric : family.metric) {
+      switch (family.type) {
+        case prometheus::MetricType::Counter:
+          buffer.append(fragments[fidx++]);
+          AppendMetricValue(&buffer, metric.counter.value);
+          break;
+        case prometheus::MetricType::Gauge:
+          buffer.append(fragments[fidx++]);
+          AppendMetricValue(&buffer, metric.gauge.value);
+          break;
+        case prometheus::MetricType::Histogram:
+          for (const auto& bucket : metric.histogram.bucket) {
+            buffer.append(fragments[fidx++]);
+            AppendMetricValue(&buffer, bucket.cumulative_count);
+          }
+          buffer.append(fragments[fidx++]);
+          AppendMetricValue(&buffer, metric.histogram.sample_count);
+          buffer.append(fragments[fidx++]);
+          AppendMetricValue(&buffer, metric.histogram.sample_sum);
+          buffer.append(fragments[fidx++]);
+          AppendMetricValue(&buffer, metric.histogram.sample_count);
+          break;
+        default:
+          buffer.append(fragments[fidx++]);
+          AppendMetricValue(&buffer, metric.untyped.value);
+          break;
+      }
+    }
+  }
+
+  buffer.append(fragments[fidx]);
+
+  return buffer;
 }
 
 Metrics*
@@ -29,11 +29,19 @@
 #ifdef TRTIS_ENABLE_METRICS
 
 #include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <thread>
+#include <vector>
 #include "prometheus/registry.h"
 #include "prometheus/serializer.h"
 #include "prometheus/text_serializer.h"
 
+#ifdef TRTIS_ENABLE_METRICS_DCGM
+#include <dcgm_agent.h>
+#endif  // TRTIS_ENABLE_METRICS_DCGM
+
 namespace nvidia { namespace inferenceserver {
 
 class Metrics {
@@ -47,6 +55,17 @@ class Metrics {
   // Get serialized metrics
   static const std::string SerializedMetrics();
 
+  // Register a sampler that is invoked just before the metrics are
+  // serialized for a scrape, so that point-in-time values such as
+  // queue depths can be refreshed at scrape time instead of being
+  // maintained on the inference hot path. Returns a non-zero id that
+  // can be used to remove the sampler.
+  static uint64_t AddSampler(std::function<void()> sampler);
+
+  // Remove a previously registered sampler. Guarantees that the
+  // sampler is not executing once this call returns.
+  static void RemoveSampler(const uint64_t sampler_id);
+
   // Get the UUID for a CUDA device. Return true and initialize 'uuid'
   // if a UUID is found, return false if a UUID cannot be returned.
   static bool UUIDForCudaDevice(int cuda_device, std::string* uuid);
@@ -107,17 +126,121 @@ class Metrics {
   {
     return GetSingleton()->inf_load_ratio_family_;
   }
+
+  // Metric family of inference request duration histogram, in
+  // microseconds
+  static prometheus::Family<prometheus::Histogram>&
+  FamilyInferenceRequestDurationHistogram()
+  {
+    return GetSingleton()->inf_request_duration_us_hist_family_;
+  }
+
+  // Metric family of inference compute duration histogram, in
+  // microseconds
+  static prometheus::Family<prometheus::Histogram>&
+  FamilyInferenceComputeDurationHistogram()
+  {
+    return GetSingleton()->inf_compute_duration_us_hist_family_;
+  }
+
+  // Metric family of inference queuing duration histogram, in
+  // microseconds
+  static prometheus::Family<prometheus::Histogram>&
+  FamilyInferenceQueueDurationHistogram()
+  {
+    return GetSingleton()->inf_queue_duration_us_hist_family_;
+  }
+
+  // Metric family of current per-model scheduler queue depth
+  static prometheus::Family<prometheus::Gauge>& FamilyModelQueueDepth()
+  {
+    return GetSingleton()->model_queue_depth_family_;
+  }
+
+  // Metric family of the age of the oldest queued request per model,
+  // in microseconds
+  static prometheus::Family<prometheus::Gauge>& FamilyModelOldestRequestAge()
+  {
+    return GetSingleton()->model_oldest_request_age_us_family_;
+  }
+
+  // Metric family of executed batch occupancy histogram
+  static prometheus::Family<prometheus::Histogram>&
+  FamilyInferenceBatchOccupancy()
+  {
+    return GetSingleton()->inf_batch_occupancy_family_;
+  }
+
+  // Metric family of per-stage inference duration histograms, in
+  // microseconds. Only populated for sampled requests when stage
+  // timing is enabled, see ModelInferStats::Report().
+  static prometheus::Family<prometheus::Histogram>&
+  FamilyInferenceStageDuration()
+  {
+    return GetSingleton()->inf_stage_duration_us_family_;
+  }
 #endif  // TRTIS_ENABLE_STATS
 
+#ifdef TRTIS_ENABLE_METRICS_GPU
+  // Metric family of cumulative bytes copied between GPU devices
+  static prometheus::Family<prometheus::Counter>& FamilyGpuTransferBytes()
+  {
+    return GetSingleton()->gpu_transfer_bytes_family_;
+  }
+#endif  // TRTIS_ENABLE_METRICS_GPU
+
+  // Metric family of host, pinned and device memory consumed by each
+  // model's in-flight requests, in bytes
+  static prometheus::Family<prometheus::Gauge>& FamilyMemoryUsage()
+  {
+    return GetSingleton()->memory_usage_family_;
+  }
+
+  // Metric family of free bytes in the pinned memory pool, labeled by
+  // the size class holding them. The "unclassed" entry reports the
+  // free space of the underlying managed buffer.
+  static prometheus::Family<prometheus::Gauge>& FamilyPinnedPoolFreeBytes()
+  {
+    return GetSingleton()->pinned_pool_free_bytes_family_;
+  }
+
+  // Metric family of the largest contiguous free block available in
+  // the pinned memory pool, in bytes. A small value while free space
+  // remains large indicates fragmentation.
+  static prometheus::Family<prometheus::Gauge>&
+  FamilyPinnedPoolLargestFreeBytes()
+  {
+    return GetSingleton()->pinned_pool_largest_free_bytes_family_;
+  }
+
+  // Metric family counting allocations served from non-pinned system
+  // memory because the pinned pool could not satisfy them.
+  static prometheus::Family<prometheus::Counter>& FamilyPinnedPoolFallbacks()
+  {
+    return GetSingleton()->pinned_pool_fallback_family_;
+  }
+
  private:
   Metrics();
   virtual ~Metrics();
   static Metrics* GetSingleton();
+  bool InitializeDcgmMetrics();
   bool InitializeNvmlMetrics();
 
+  // Rebuild the cached exposition layout from a collected snapshot.
+  // Must hold 'exposition_mu_'.
+  void RebuildExpositionLayout(
+      const std::vector<prometheus::MetricFamily>& families,
+      const uint64_t signature, const size_t value_cnt);
+
   std::shared_ptr<prometheus::Registry> registry_;
   std::unique_ptr<prometheus::Serializer> serializer_;
 
+  // Samplers run at scrape time, see AddSampler().
+  std::mutex sampler_mu_;
+  uint64_t next_sampler_id_;
+  std::map<uint64_t, std::function<void()>> samplers_;
+
 #ifdef TRTIS_ENABLE_STATS
   prometheus::Family<prometheus::Counter>& inf_success_family_;
   prometheus::Family<prometheus::Counter>& inf_failure_family_;
@@ -127,6 +250,16 @@ class Metrics {
   prometheus::Family<prometheus::Counter>& inf_compute_duration_us_family_;
   prometheus::Family<prometheus::Counter>& inf_queue_duration_us_family_;
   prometheus::Family<prometheus::Histogram>& inf_load_ratio_family_;
+  prometheus::Family<prometheus::Histogram>&
+      inf_request_duration_us_hist_family_;
+  prometheus::Family<prometheus::Histogram>&
+      inf_compute_duration_us_hist_family_;
+  prometheus::Family<prometheus::Histogram>&
+      inf_queue_duration_us_hist_family_;
+  prometheus::Family<prometheus::Gauge>& model_queue_depth_family_;
+  prometheus::Family<prometheus::Gauge>& model_oldest_request_age_us_family_;
+  prometheus::Family<prometheus::Histogram>& inf_batch_occupancy_family_;
+  prometheus::Family<prometheus::Histogram>& inf_stage_duration_us_family_;
 #endif  // TRTIS_ENABLE_STATS
 #ifdef TRTIS_ENABLE_METRICS_GPU
   prometheus::Family<prometheus::Gauge>& gpu_utilization_family_;
@@ -135,6 +268,7 @@ class Metrics {
   prometheus::Family<prometheus::Gauge>& gpu_power_usage_family_;
   prometheus::Family<prometheus::Gauge>& gpu_power_limit_family_;
   prometheus::Family<prometheus::Counter>& gpu_energy_consumption_family_;
+  prometheus::Family<prometheus::Counter>& gpu_transfer_bytes_family_;
 
   std::vector<prometheus::Gauge*> gpu_utilization_;
   std::vector<prometheus::Gauge*> gpu_memory_total_;
@@ -145,8 +279,41 @@ class Metrics {
 
   std::unique_ptr<std::thread> nvml_thread_;
   std::atomic<bool> nvml_thread_exit_;
+
+#ifdef TRTIS_ENABLE_METRICS_DCGM
+  // Callback invoked by dcgmGetLatestValues() with the batched field
+  // values for one GPU.
+  static int DcgmValuesCallback(
+      unsigned int gpu_id, dcgmFieldValue_v1* values, int num_values,
+      void* user_data);
+
+  dcgmHandle_t dcgm_handle_;
+  std::map<unsigned int, size_t> dcgm_gpu_index_;
+  std::vector<unsigned long long> dcgm_last_energy_;
+  std::unique_ptr<std::thread> dcgm_thread_;
+  std::atomic<bool> dcgm_thread_exit_;
+#endif  // TRTIS_ENABLE_METRICS_DCGM
 #endif  // TRTIS_ENABLE_METRICS_GPU
+  prometheus::Family<prometheus::Gauge>& memory_usage_family_;
+  prometheus::Family<prometheus::Gauge>& pinned_pool_free_bytes_family_;
+  prometheus::Family<prometheus::Gauge>& pinned_pool_largest_free_bytes_family_;
+  prometheus::Family<prometheus::Counter>& pinned_pool_fallback_family_;
+
   bool gpu_metrics_enabled_;
+
+  // Cached static layout of the metrics text exposition. The
+  // exposition is static fragments interleaved with metric values;
+  // the fragments (family headers, metric names, label sets,
+  // histogram bucket bounds) are rebuilt only when
+  // 'exposition_signature_' shows that the set of metrics changed,
+  // and a scrape just fills the values into the reused buffer. All
+  // protected by 'exposition_mu_'.
+  std::mutex exposition_mu_;
+  bool exposition_valid_ = false;
+  uint64_t exposition_signature_ = 0;
+  size_t exposition_value_cnt_ = 0;
+  std::vector<std::string> exposition_fragments_;
+  std::string exposition_buffer_;
 };
 
 }}  // namespace nvidia::inferenceserver
@@ -0,0 +1,160 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/model_artifact_cache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <set>
+#include "src/core/filesystem.h"
+#include "src/core/logging.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// Cache entries not used for this long are removed at startup.
+constexpr int64_t kMaxEntryAgeNs = 30ll * 24 * 60 * 60 * 1000000000ll;
+
+Status
+MakeLocalDirectory(const std::string& dir)
+{
+  if ((mkdir(dir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) == -1) &&
+      (errno != EEXIST)) {
+    return Status(
+        Status::Code::INTERNAL, "failed to create artifact cache directory '" +
+                                    dir + "': " + strerror(errno));
+  }
+
+  return Status::Success;
+}
+
+// Remove a cache entry directory and the files directly within
+// it. Entries never nest directories.
+void
+RemoveEntry(const std::string& dir)
+{
+  std::set<std::string> files;
+  Status status = GetDirectoryFiles(dir, false /* skip_hidden_files */, &files);
+  if (status.IsOk()) {
+    for (const auto& file : files) {
+      remove(JoinPath({dir, file}).c_str());
+    }
+  }
+
+  remove(dir.c_str());
+}
+
+}  // namespace
+
+std::unique_ptr<ModelArtifactCache> ModelArtifactCache::instance_;
+
+ModelArtifactCache::ModelArtifactCache(const std::string& dir) : dir_(dir) {}
+
+Status
+ModelArtifactCache::Create(const std::string& dir)
+{
+  if (instance_ != nullptr) {
+    LOG_WARNING << "New artifact cache could not be created, cache already "
+                << "exists at " << instance_->dir_;
+    return Status::Success;
+  }
+
+  RETURN_IF_ERROR(MakeLocalDirectory(dir));
+
+  LOG_INFO << "Model artifact cache: " << dir;
+  instance_.reset(new ModelArtifactCache(dir));
+  instance_->PruneStale();
+
+  return Status::Success;
+}
+
+bool
+ModelArtifactCache::Enabled()
+{
+  return instance_ != nullptr;
+}
+
+uint64_t
+ModelArtifactCache::Hash(const std::string& data)
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char c : data) {
+    hash ^= (uint64_t)(uint8_t)c;
+    hash *= 0x100000001b3ull;
+  }
+
+  return hash;
+}
+
+Status
+ModelArtifactCache::EntryDir(const std::string& key, std::string* dir)
+{
+  if (instance_ == nullptr) {
+    return Status(
+        Status::Code::UNAVAILABLE, "model artifact cache is not enabled");
+  }
+
+  const std::string entry_dir = JoinPath({instance_->dir_, key});
+
+  {
+    std::lock_guard<std::mutex> lock(instance_->mu_);
+    RETURN_IF_ERROR(MakeLocalDirectory(entry_dir));
+  }
+
+  *dir = entry_dir;
+  return Status::Success;
+}
+
+void
+ModelArtifactCache::PruneStale()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  const int64_t now_ns = now.tv_sec * 1000000000ll + now.tv_nsec;
+
+  std::set<std::string> entries;
+  Status status = GetDirectorySubdirs(dir_, &entries);
+  if (!status.IsOk()) {
+    LOG_WARNING << "Failed to prune artifact cache: " << status.Message();
+    return;
+  }
+
+  for (const auto& entry : entries) {
+    const std::string entry_dir = JoinPath({dir_, entry});
+    int64_t mtime_ns;
+    status = FileModificationTime(entry_dir, &mtime_ns);
+    if (status.IsOk() && ((now_ns - mtime_ns) > kMaxEntryAgeNs)) {
+      LOG_VERBOSE(1) << "Removing stale artifact cache entry " << entry;
+      RemoveEntry(entry_dir);
+    }
+  }
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,72 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+// A persistent on-disk cache for post-optimization model artifacts
+// (optimized graphs, timing caches, ...) so that a warm server
+// restart does not need to re-optimize every model. The cache is a
+// local directory with one subdirectory per entry; backends key
+// entries by a hash of the model content plus the backend version and
+// GPU compute capability, so a change to any of those naturally
+// creates a new entry. Entries that have not been used for 30 days
+// are removed when the cache is created.
+class ModelArtifactCache {
+ public:
+  // Create the artifact cache rooted at local directory 'dir',
+  // creating the directory if needed and pruning stale entries.
+  // Return Status object indicating success or failure.
+  static Status Create(const std::string& dir);
+
+  // True if an artifact cache has been created.
+  static bool Enabled();
+
+  // 64-bit FNV-1a hash of 'data', for building cache keys.
+  static uint64_t Hash(const std::string& data);
+
+  // Return in 'dir' the directory for cache entry 'key', creating it
+  // if needed. Return Status object indicating success or failure.
+  static Status EntryDir(const std::string& key, std::string* dir);
+
+ private:
+  ModelArtifactCache(const std::string& dir);
+
+  // Remove cache entries that have not been used recently.
+  void PruneStale();
+
+  static std::unique_ptr<ModelArtifactCache> instance_;
+
+  const std::string dir_;
+  std::mutex mu_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -30,51 +30,29 @@
 
 namespace nvidia { namespace inferenceserver {
 
-bool
-IsFixedSizeDataType(const DataType dtype)
+int64_t
+GetElementCount(const DimsList& dims)
 {
-  return dtype != TYPE_STRING;
-}
+  bool first = true;
+  int64_t cnt = 0;
+  for (auto dim : dims) {
+    if (dim == WILDCARD_DIM) {
+      return -1;
+    }
 
-size_t
-GetDataTypeByteSize(const DataType dtype)
-{
-  switch (dtype) {
-    case TYPE_BOOL:
-      return 1;
-    case TYPE_UINT8:
-      return 1;
-    case TYPE_UINT16:
-      return 2;
-    case TYPE_UINT32:
-      return 4;
-    case TYPE_UINT64:
-      return 8;
-    case TYPE_INT8:
-      return 1;
-    case TYPE_INT16:
-      return 2;
-    case TYPE_INT32:
-      return 4;
-    case TYPE_INT64:
-      return 8;
-    case TYPE_FP16:
-      return 2;
-    case TYPE_FP32:
-      return 4;
-    case TYPE_FP64:
-      return 8;
-    case TYPE_STRING:
-      return 0;
-    default:
-      break;
+    if (first) {
+      cnt = dim;
+      first = false;
+    } else {
+      cnt *= dim;
+    }
   }
 
-  return 0;
+  return cnt;
 }
 
 int64_t
-GetElementCount(const DimsList& dims)
+GetElementCount(const std::vector<int64_t>& dims)
 {
   bool first = true;
   int64_t cnt = 0;
@@ -95,7 +73,7 @@ GetElementCount(const DimsList& dims)
 }
 
 int64_t
-GetElementCount(const std::vector<int64_t>& dims)
+GetElementCount(const ShapeVector& dims)
 {
   bool first = true;
   int64_t cnt = 0;
@@ -159,6 +137,22 @@ GetByteSize(const DataType& dtype, const std::vector<int64_t>& dims)
   return cnt * dt_size;
 }
 
+int64_t
+GetByteSize(const DataType& dtype, const ShapeVector& dims)
+{
+  size_t dt_size = GetDataTypeByteSize(dtype);
+  if (dt_size == 0) {
+    return -1;
+  }
+
+  int64_t cnt = GetElementCount(dims);
+  if (cnt == -1) {
+    return -1;
+  }
+
+  return cnt * dt_size;
+}
+
 int64_t
 GetByteSize(const int batch_size, const DataType& dtype, const DimsList& dims)
 {
@@ -308,6 +302,22 @@ CompareDims(
   return true;
 }
 
+bool
+CompareDims(const std::vector<int64_t>& dims0, const ShapeVector& dims1)
+{
+  if (dims0.size() != dims1.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < dims0.size(); ++i) {
+    if (dims0[i] != dims1[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 bool
 CompareDimsWithWildcard(const DimsList& dims0, const DimsList& dims1)
 {
@@ -343,6 +353,59 @@ CompareDimsWithWildcard(
   return true;
 }
 
+bool
+CompareDimsWithWildcard(
+    const std::vector<int64_t>& dims0, const std::vector<int64_t>& dims1)
+{
+  if (dims0.size() != dims1.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < dims0.size(); ++i) {
+    if ((dims0[i] != WILDCARD_DIM) && (dims1[i] != WILDCARD_DIM) &&
+        (dims0[i] != dims1[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+CompareDimsWithWildcard(const DimsList& dims0, const ShapeVector& dims1)
+{
+  if (dims0.size() != (int64_t)dims1.size()) {
+    return false;
+  }
+
+  for (int i = 0; i < dims0.size(); ++i) {
+    if ((dims0[i] != WILDCARD_DIM) && (dims1[i] != WILDCARD_DIM) &&
+        (dims0[i] != dims1[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+CompareDimsWithWildcard(
+    const std::vector<int64_t>& dims0, const ShapeVector& dims1)
+{
+  if (dims0.size() != dims1.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < dims0.size(); ++i) {
+    if ((dims0[i] != WILDCARD_DIM) && (dims1[i] != WILDCARD_DIM) &&
+        (dims0[i] != dims1[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 std::string
 DimsListToString(const DimsList& dims)
 {
@@ -382,6 +445,24 @@ DimsListToString(const std::vector<int64_t>& dims, const int start_idx)
   return str;
 }
 
+std::string
+DimsListToString(const ShapeVector& dims)
+{
+  bool first = true;
+
+  std::string str("[");
+  for (const auto& dim : dims) {
+    if (!first) {
+      str += ",";
+    }
+    str += std::to_string(dim);
+    first = false;
+  }
+
+  str += "]";
+  return str;
+}
+
 const char*
 DataTypeToProtocolString(const DataType dtype)
 {
@@ -28,6 +28,7 @@
 #include <google/protobuf/any.pb.h>
 #include <stdint.h>
 #include "src/core/model_config.pb.h"
+#include "src/core/shape_vector.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -96,6 +97,13 @@ int64_t GetElementCount(const DimsList& dims);
 /// wilcard dimensions.
 int64_t GetElementCount(const std::vector<int64_t>& dims);
 
+/// Get the number of elements in a shape.
+/// \param dims The shape.
+/// \return The number of elements, or -1 if the number of elements
+/// cannot be determined because the shape contains one or more
+/// wilcard dimensions.
+int64_t GetElementCount(const ShapeVector& dims);
+
 /// Get the number of elements in the shape of a model input.
 /// \param mio The model input.
 /// \return The number of elements, or -1 if the number of elements
@@ -110,19 +118,62 @@ int64_t GetElementCount(const ModelInput& mio);
 /// wilcard dimensions.
 int64_t GetElementCount(const ModelOutput& mio);
 
-/// Are values of a datatype fixed-size, or variable-sized.
+/// Are values of a datatype fixed-size, or variable-sized. Defined
+/// inline so that call sites with a known datatype fold to a
+/// constant.
 /// \param dtype The data-type.
 /// \return True if datatype values are fixed-sized, false if
 /// variable-sized.
-bool IsFixedSizeDataType(const DataType dtype);
-
-/// Get the size of objects of a given datatype in bytes.
+inline bool
+IsFixedSizeDataType(const DataType dtype)
+{
+  return dtype != TYPE_STRING;
+}
+
+/// Get the size of objects of a given datatype in bytes. Defined
+/// inline so that call sites with a known datatype fold to a constant
+/// instead of paying a runtime branch inside per-tensor loops.
 /// \param dtype The data-type.
 /// \return The size, in bytes, of objects of the datatype, or 0 if
 /// size cannot be determine (for example, values of type TYPE_STRING
 /// have variable length and so size cannot be determine just from the
 /// type).
-size_t GetDataTypeByteSize(const DataType dtype);
+inline size_t
+GetDataTypeByteSize(const DataType dtype)
+{
+  switch (dtype) {
+    case TYPE_BOOL:
+      return 1;
+    case TYPE_UINT8:
+      return 1;
+    case TYPE_UINT16:
+      return 2;
+    case TYPE_UINT32:
+      return 4;
+    case TYPE_UINT64:
+      return 8;
+    case TYPE_INT8:
+      return 1;
+    case TYPE_INT16:
+      return 2;
+    case TYPE_INT32:
+      return 4;
+    case TYPE_INT64:
+      return 8;
+    case TYPE_FP16:
+      return 2;
+    case TYPE_FP32:
+      return 4;
+    case TYPE_FP64:
+      return 8;
+    case TYPE_STRING:
+      return 0;
+    default:
+      break;
+  }
+
+  return 0;
+}
 
 /// Get the size, in bytes, of a tensor based on datatype and
 /// shape.
@@ -140,6 +191,14 @@ int64_t GetByteSize(const DataType& dtype, const DimsList& dims);
 /// unable to determine the size.
 int64_t GetByteSize(const DataType& dtype, const std::vector<int64_t>& dims);
 
+/// Get the size, in bytes, of a tensor based on datatype and
+/// shape.
+/// \param dtype The data-type.
+/// \param dims The shape.
+/// \return The size, in bytes, of the corresponding tensor, or -1 if
+/// unable to determine the size.
+int64_t GetByteSize(const DataType& dtype, const ShapeVector& dims);
+
 /// Get the size, in bytes, of a tensor based on batch-size, datatype
 /// and shape. A tensor that has empty shape [] and non-zero
 /// batch-size is sized as a tensor with shape [ batch-size ].
@@ -208,6 +267,15 @@ bool CompareDims(const DimsList& dims0, const DimsList& dims1);
 bool CompareDims(
     const std::vector<int64_t>& dims0, const std::vector<int64_t>& dims1);
 
+/// Compare two model configuration shapes for equality. Wildcard
+/// dimensions (that is, dimensions with size WILDCARD_DIM) are
+/// compared literally so that to be equal the two shapes must both
+/// specify WILDCARD_DIM in the same dimensions.
+/// \params dims0 The first shape.
+/// \params dims1 The second shape.
+/// \return True if the shapes are equal, false if not equal.
+bool CompareDims(const std::vector<int64_t>& dims0, const ShapeVector& dims1);
+
 /// Compare two model configuration shapes for equality. Wildcard
 /// dimensions (that is, dimensions with size WILDCARD_DIM) are
 /// allowed to match with any value. So, a dimension in one shape
@@ -229,6 +297,38 @@ bool CompareDimsWithWildcard(const DimsList& dims0, const DimsList& dims1);
 bool CompareDimsWithWildcard(
     const DimsList& dims0, const std::vector<int64_t>& dims1);
 
+/// Compare two model configuration shapes for equality. Wildcard
+/// dimensions (that is, dimensions with size WILDCARD_DIM) are
+/// allowed to match with any value. So, a dimension in one shape
+/// specified as WILDCARD_DIM will always match the same dimension in
+/// the other shape.
+/// \params dims0 The first shape.
+/// \params dims1 The second shape.
+/// \return True if the shapes are equal, false if not equal.
+bool CompareDimsWithWildcard(
+    const std::vector<int64_t>& dims0, const std::vector<int64_t>& dims1);
+
+/// Compare two model configuration shapes for equality. Wildcard
+/// dimensions (that is, dimensions with size WILDCARD_DIM) are
+/// allowed to match with any value. So, a dimension in one shape
+/// specified as WILDCARD_DIM will always match the same dimension in
+/// the other shape.
+/// \params dims0 The first shape.
+/// \params dims1 The second shape.
+/// \return True if the shapes are equal, false if not equal.
+bool CompareDimsWithWildcard(const DimsList& dims0, const ShapeVector& dims1);
+
+/// Compare two model configuration shapes for equality. Wildcard
+/// dimensions (that is, dimensions with size WILDCARD_DIM) are
+/// allowed to match with any value. So, a dimension in one shape
+/// specified as WILDCARD_DIM will always match the same dimension in
+/// the other shape.
+/// \params dims0 The first shape.
+/// \params dims1 The second shape.
+/// \return True if the shapes are equal, false if not equal.
+bool CompareDimsWithWildcard(
+    const std::vector<int64_t>& dims0, const ShapeVector& dims1);
+
 /// Convert a DimsList to string representation.
 /// \param dims The DimsList to be converted.
 /// \return String representation of the DimsList in pattern
@@ -242,6 +342,12 @@ std::string DimsListToString(const DimsList& dims);
 std::string DimsListToString(
     const std::vector<int64_t>& dims, const int start_idx = 0);
 
+/// Convert a shape to string representation.
+/// \param dims The shape to be converted.
+/// \return String representation of the shape in pattern
+/// "[d0,d1,...,dn]"
+std::string DimsListToString(const ShapeVector& dims);
+
 /// Get the server protocol string representation of a datatype.
 /// \param dtype The data type.
 /// \return The string representation.
@@ -26,13 +26,20 @@
 
 #include "src/core/model_config_utils.h"
 
+#include <errno.h>
+#include <string.h>
 #include <deque>
 #include <set>
+
+#ifdef __linux__
+#include <sched.h>
+#endif  // __linux__
 #include "src/core/autofill.h"
 #include "src/core/constants.h"
 #include "src/core/cuda_utils.h"
 #include "src/core/filesystem.h"
 #include "src/core/logging.h"
+#include "src/core/model_artifact_cache.h"
 
 #ifdef TRTIS_ENABLE_GPU
 #include <cuda_runtime_api.h>
@@ -367,8 +374,72 @@ ValidateIOShape(
   return Status::Success;
 }
 
+// Append to 'manifest' one "<relative path>:<content hash>;" entry for
+// every file under 'path', recursing into subdirectories so that model
+// formats that are directories (e.g. SavedModel) contribute. Hashing
+// each file separately and hashing the manifest to form the key makes
+// a rename change the key even when the file bytes do not.
+Status
+HashDirectoryContent(
+    const std::string& path, const std::string& prefix, std::string* manifest)
+{
+  std::set<std::string> files;
+  RETURN_IF_ERROR(
+      GetDirectoryFiles(path, true /* skip_hidden_files */, &files));
+  for (const auto& file : files) {
+    std::string contents;
+    RETURN_IF_ERROR(ReadTextFile(JoinPath({path, file}), &contents));
+    manifest->append(
+        prefix + file + ":" +
+        std::to_string(ModelArtifactCache::Hash(contents)) + ";");
+  }
+
+  std::set<std::string> subdirs;
+  RETURN_IF_ERROR(GetDirectorySubdirs(path, &subdirs));
+  for (const auto& subdir : subdirs) {
+    RETURN_IF_ERROR(HashDirectoryContent(
+        JoinPath({path, subdir}), prefix + subdir + "/", manifest));
+  }
+
+  return Status::Success;
+}
+
 }  // namespace
 
+Status
+SetCpuAffinity(const std::vector<int32_t>& cpus)
+{
+  if (cpus.empty()) {
+    return Status::Success;
+  }
+
+#ifdef __linux__
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (const int32_t cpu : cpus) {
+    if ((cpu < 0) || (cpu >= CPU_SETSIZE)) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "invalid cpu id " + std::to_string(cpu) + " in cpu affinity set");
+    }
+    CPU_SET(cpu, &cpuset);
+  }
+
+  if (sched_setaffinity(0 /* calling thread */, sizeof(cpu_set_t), &cpuset) !=
+      0) {
+    return Status(
+        Status::Code::INTERNAL,
+        "failed to set cpu affinity: " + std::string(strerror(errno)));
+  }
+
+  return Status::Success;
+#else
+  return Status(
+      Status::Code::UNSUPPORTED,
+      "cpu affinity is not supported on this platform");
+#endif  // __linux__
+}
+
 Status
 GetModelVersionFromString(const std::string& version_string, int64_t* version)
 {
@@ -628,10 +699,60 @@ GetNormalizedModelConfig(
   // Autofill if requested...
   if (autofill) {
     const std::string model_name(BaseName(path));
-    std::unique_ptr<AutoFill> af;
-    RETURN_IF_ERROR(AutoFill::Create(
-        model_name, backend_config_map, std::string(path), *config, &af));
-    RETURN_IF_ERROR(af->Fix(config));
+
+    // If the persistent artifact cache is enabled, reuse the
+    // autofilled configuration saved by a previous server run for this
+    // exact model content so that a warm restart does not need to
+    // inspect the model definition again (for example, deserializing a
+    // TensorRT plan just to read its bindings). The configuration file
+    // itself contributes to the content hash, so editing it naturally
+    // invalidates the entry.
+    std::string cached_config_path;
+    bool cached = false;
+    if (ModelArtifactCache::Enabled()) {
+      std::string manifest;
+      Status cache_status = HashDirectoryContent(path, "", &manifest);
+      if (cache_status.IsOk()) {
+        const std::string key =
+            "autofill_" + model_name + "_" +
+            std::to_string(ModelArtifactCache::Hash(manifest));
+        std::string entry_dir;
+        cache_status = ModelArtifactCache::EntryDir(key, &entry_dir);
+        if (cache_status.IsOk()) {
+          cached_config_path = JoinPath({entry_dir, kModelConfigPbTxt});
+          bool exists = false;
+          cache_status = FileExists(cached_config_path, &exists);
+          if (cache_status.IsOk() && exists) {
+            cache_status = ReadTextProto(cached_config_path, config);
+            if (cache_status.IsOk()) {
+              LOG_VERBOSE(1) << "autofilled config for " << model_name
+                             << " loaded from artifact cache";
+              cached = true;
+            }
+          }
+        }
+      }
+      if (!cache_status.IsOk()) {
+        LOG_WARNING << "artifact cache unavailable for autofill of model '"
+                    << model_name << "': " << cache_status.Message();
+        cached_config_path.clear();
+      }
+    }
+
+    if (!cached) {
+      std::unique_ptr<AutoFill> af;
+      RETURN_IF_ERROR(AutoFill::Create(
+          model_name, backend_config_map, std::string(path), *config, &af));
+      RETURN_IF_ERROR(af->Fix(config));
+
+      if (!cached_config_path.empty()) {
+        Status cache_status = WriteTextProto(cached_config_path, *config);
+        if (!cache_status.IsOk()) {
+          LOG_WARNING << "failed to cache autofilled config for model '"
+                      << model_name << "': " << cache_status.Message();
+        }
+      }
+    }
 
     LOG_VERBOSE(1) << "autofilled config: " << config->DebugString();
   }
@@ -840,6 +961,46 @@ ValidateModelConfig(
         "must specify 'version policy' for " + config.name());
   }
 
+  if (config.admission_control().rate_limit().requests_per_second() < 0) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "rate limit 'requests_per_second' must be non-negative value for " +
+            config.name());
+  }
+  for (const auto& pr : config.admission_control().priority_rate_limit()) {
+    if (pr.second.requests_per_second() < 0) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "rate limit 'requests_per_second' must be non-negative value for "
+          "priority level " +
+              std::to_string(pr.first) + " of " + config.name());
+    }
+  }
+
+  if (config.traffic_split().percentage() > 100) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "traffic split 'percentage' must be 100 or less for " + config.name());
+  }
+  if ((config.traffic_split().percentage() > 0) &&
+      config.traffic_split().shadow_model_name().empty()) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "traffic split must specify 'shadow_model_name' for " + config.name());
+  }
+
+  if (config.request_mirror().percentage() > 100) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "request mirror 'percentage' must be 100 or less for " + config.name());
+  }
+  if ((config.request_mirror().percentage() > 0) &&
+      config.request_mirror().mirror_model_name().empty()) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "request mirror must specify 'mirror_model_name' for " + config.name());
+  }
+
   Status status;
   for (const auto& io : config.input()) {
     status = ValidateModelInput(io, config.max_batch_size(), config.platform());
@@ -857,6 +1018,41 @@ ValidateModelConfig(
     }
   }
 
+  for (const auto& batch_input : config.batch_input()) {
+    if (batch_input.target_name_size() == 0) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "batch input must specify at least one 'target_name' for " +
+              config.name());
+    }
+    if ((batch_input.data_type() != TYPE_INT32) &&
+        (batch_input.data_type() != TYPE_FP32)) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "batch input data type must be TYPE_INT32 or TYPE_FP32 for " +
+              config.name());
+    }
+    if (batch_input.source_input_size() != 1) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "batch input must specify exactly one 'source_input' for " +
+              config.name());
+    }
+    bool found_source = false;
+    for (const auto& io : config.input()) {
+      if (io.name() == batch_input.source_input(0)) {
+        found_source = true;
+        break;
+      }
+    }
+    if (!found_source) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "batch input 'source_input' must name a model input for " +
+              config.name());
+    }
+  }
+
   // If dynamic batching is specified make sure the preferred batch
   // sizes are positive and don't exceed maximum batch size.
   if (config.has_dynamic_batching()) {
@@ -983,6 +1179,44 @@ ValidateModelConfig(
       }
     }
 
+    // Check explicit state tensors. The state buffers are allocated
+    // up front so the size of each state must be known from the
+    // configuration alone.
+    {
+      std::set<std::string> state_input_names;
+      std::set<std::string> state_output_names;
+      for (const auto& state : batcher.state()) {
+        if (state.input_name().empty() || state.output_name().empty()) {
+          return Status(
+              Status::Code::INVALID_ARG,
+              "sequence batching state must specify 'input_name' and "
+              "'output_name' for " +
+                  config.name());
+        }
+        if (!state_input_names.insert(state.input_name()).second ||
+            !state_output_names.insert(state.output_name()).second) {
+          return Status(
+              Status::Code::INVALID_ARG,
+              "sequence batching state tensor names must be unique for " +
+                  config.name());
+        }
+        if (GetDataTypeByteSize(state.data_type()) == 0) {
+          return Status(
+              Status::Code::INVALID_ARG,
+              "sequence batching state '" + state.input_name() +
+                  "' must use a fixed-size data type for " + config.name());
+        }
+        for (const auto dim : state.dims()) {
+          if (dim <= 0) {
+            return Status(
+                Status::Code::INVALID_ARG,
+                "sequence batching state '" + state.input_name() +
+                    "' dims must be fixed-size for " + config.name());
+          }
+        }
+      }
+    }
+
     // If oldest-first strategy is enabled make sure the preferred
     // batch sizes are positive and don't exceed maximum batch size.
     if (config.sequence_batching().has_oldest()) {
@@ -1111,6 +1345,23 @@ ValidateModelConfig(
                                         " has unexpected kind KIND_AUTO");
       }
 
+      if ((group.cpus().size() > 0) &&
+          (group.kind() != ModelInstanceGroup::KIND_CPU)) {
+        return Status(
+            Status::Code::INVALID_ARG,
+            "instance group " + group.name() + " of model " + config.name() +
+                " specifies 'cpus' which is supported only for groups with "
+                "kind KIND_CPU");
+      }
+      for (const int32_t cid : group.cpus()) {
+        if (cid < 0) {
+          return Status(
+              Status::Code::INVALID_ARG,
+              "instance group " + group.name() + " of model " + config.name() +
+                  " specifies invalid cpu id of " + std::to_string(cid));
+        }
+      }
+
       if (
 #ifdef TRTIS_ENABLE_TENSORRT
           (config.platform() != kTensorRTPlanPlatform) &&
@@ -1166,6 +1417,16 @@ ValidateModelInput(
         "shape tensors are only supported for TensorRT platform");
   }
 
+  if (
+#ifdef TRTIS_ENABLE_TENSORRT
+      (platform != kTensorRTPlanPlatform) &&
+#endif  // TRTIS_ENABLE_TENSORRT
+      (io.memory_format() != MEMORY_FORMAT_LINEAR)) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "non-linear memory formats are only supported for TensorRT platform");
+  }
+
   if (
 #ifdef TRTIS_ENABLE_CUSTOM
       (platform != kCustomPlatform) &&
@@ -1215,6 +1476,16 @@ ValidateModelOutput(
         "shape tensors are only supported for TensorRT platform");
   }
 
+  if (
+#ifdef TRTIS_ENABLE_TENSORRT
+      (platform != kTensorRTPlanPlatform) &&
+#endif  // TRTIS_ENABLE_TENSORRT
+      (io.memory_format() != MEMORY_FORMAT_LINEAR)) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "non-linear memory formats are only supported for TensorRT platform");
+  }
+
   return Status::Success;
 }
 
@@ -31,6 +31,13 @@
 
 namespace nvidia { namespace inferenceserver {
 
+/// Bind the calling thread to a set of CPUs, as listed in the 'cpus'
+/// field of an instance group. An empty set leaves the thread
+/// unrestricted and returns success.
+/// \param cpus The zero-based CPU ids to bind to.
+/// \return The error status.
+Status SetCpuAffinity(const std::vector<int32_t>& cpus);
+
 /// Get the integral version from a string, or fail if string does not
 /// represent a valid version.
 /// \param version_string The string version.
@@ -27,7 +27,14 @@
 
 #include "src/core/model_repository_manager.h"
 
+#include <sys/inotify.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
 #include <deque>
 #include <future>
 #include <stdexcept>
@@ -37,6 +44,7 @@
 #include "src/core/ensemble_utils.h"
 #include "src/core/filesystem.h"
 #include "src/core/logging.h"
+#include "src/core/model_artifact_cache.h"
 #include "src/core/model_config_utils.h"
 #include "src/core/server_status.h"
 
@@ -76,7 +84,7 @@ BuildBackendConfigMap(
     const std::string& version, const bool strict_model_config,
     const float tf_gpu_memory_fraction, const bool tf_allow_soft_placement,
     const std::map<int, std::pair<int, uint64_t>> tf_vgpu_memory_limit_mb,
-    BackendConfigMap* backend_configs)
+    const int tf_shared_thread_pool_size, BackendConfigMap* backend_configs)
 {
 #ifdef TRTIS_ENABLE_TENSORFLOW
   //// Tensorflow GraphDef and SavedModel
@@ -119,6 +127,7 @@ BuildBackendConfigMap(
 #endif  // TRTIS_ENABLE_GPU
 
     graphdef_config->allow_soft_placement = tf_allow_soft_placement;
+    graphdef_config->shared_thread_pool_size = tf_shared_thread_pool_size;
 
     (*backend_configs)[kTensorFlowGraphDefPlatform] = graphdef_config;
     (*backend_configs)[kTensorFlowSavedModelPlatform] = graphdef_config;
@@ -225,6 +234,29 @@ GetModifiedTime(const std::string& path)
 
   return mtime;
 }
+
+// Return the most recent modification time of the subdirectories of
+// model directory 'path'. This covers the version directories (and so
+// the model contents) but not the model configuration file.
+int64_t
+GetVersionModifiedTime(const std::string& path)
+{
+  std::set<std::string> subdirs;
+  Status status = GetDirectorySubdirs(path, &subdirs);
+  if (!status.IsOk()) {
+    LOG_ERROR << "Failed to determine version modification time for '" << path
+              << "': " << status.AsString();
+    return 0;
+  }
+
+  int64_t mtime = 0;
+  for (const auto& child : subdirs) {
+    mtime = std::max(mtime, GetModifiedTime(JoinPath({path, child})));
+  }
+
+  return mtime;
+}
+
 // Return true if any file in the subdirectory root at 'path' has been
 // modified more recently than 'last'. Return the most-recent modified
 // time in 'last'.
@@ -258,10 +290,14 @@ struct BackendDeleter {
 }  // namespace
 
 struct ModelRepositoryManager::ModelInfo {
-  // [TODO] split modification time into versions' and model's
-  // so that we have more information on whether the model reload
-  // is necessary
   int64_t mtime_nsec_;
+
+  // Most recent modification time of the version subdirectories only,
+  // excluding the model configuration. Used to recognize a
+  // modification that touched the configuration but not the model
+  // contents, which may be applicable in place without a reload.
+  int64_t version_mtime_nsec_;
+
   ModelConfig model_config_;
   Platform platform_;
   std::string model_repository_path_;
@@ -273,6 +309,7 @@ class ModelRepositoryManager::BackendLifeCycle {
       InferenceServer* server, const double min_compute_capability,
       const std::shared_ptr<ServerStatusManager>& status_manager,
       const BackendConfigMap& backend_map,
+      const uint32_t max_concurrent_loads,
       std::unique_ptr<BackendLifeCycle>* life_cycle);
 
   ~BackendLifeCycle() = default;
@@ -307,6 +344,29 @@ class ModelRepositoryManager::BackendLifeCycle {
       ModelReadyState* state);
 
  private:
+  // An immutable snapshot of the ready versions of a model, used to
+  // resolve the requested version on the request path without taking
+  // 'map_mtx_'. Replaced as a whole, never modified. The weak
+  // references ensure that a stale snapshot can neither pin nor
+  // return an unloaded backend.
+  struct ResolutionSnapshot {
+    uint64_t generation_;
+    std::map<int64_t, std::weak_ptr<InferenceBackend>> ready_versions_;
+  };
+
+  // Per-model entry of the resolution cache. 'generation_' advances
+  // on every state change of any version of the model, a snapshot is
+  // only used when its generation matches.
+  struct ResolutionCacheEntry {
+    ResolutionCacheEntry() : generation_(0) {}
+
+    std::atomic<uint64_t> generation_;
+    std::shared_ptr<const ResolutionSnapshot> snapshot_;
+  };
+
+  using ResolutionCacheMap =
+      std::unordered_map<std::string, std::shared_ptr<ResolutionCacheEntry>>;
+
   struct BackendInfo {
     BackendInfo(
         const std::string& repository_path, const ModelReadyState state,
@@ -333,16 +393,27 @@ class ModelRepositoryManager::BackendLifeCycle {
     ModelConfig model_config_;
 
     std::shared_ptr<InferenceBackend> backend_;
+
+    // The resolution cache entry of the model this version belongs
+    // to, invalidated whenever the version changes state.
+    std::shared_ptr<ResolutionCacheEntry> cache_entry_;
   };
 
   BackendLifeCycle(
       const double min_compute_capability,
-      const std::shared_ptr<ServerStatusManager>& status_manager)
+      const std::shared_ptr<ServerStatusManager>& status_manager,
+      const uint32_t max_concurrent_loads)
       : min_compute_capability_(min_compute_capability),
-        status_manager_(status_manager)
+        resolution_cache_(std::make_shared<ResolutionCacheMap>()),
+        status_manager_(status_manager),
+        max_concurrent_loads_(max_concurrent_loads), inflight_load_count_(0)
   {
   }
 
+  // Invalidate the cached version resolution of the model the backend
+  // belongs to. Must be called wherever a version changes state.
+  void InvalidateResolutionCache(BackendInfo* backend_info);
+
   // Function called after backend state / next action is updated.
   // Caller must obtain the mutex of 'backend_info' before calling this function
   Status TriggerNextAction(
@@ -370,8 +441,23 @@ class ModelRepositoryManager::BackendLifeCycle {
   BackendMap map_;
   std::mutex map_mtx_;
 
+  // Map from model name to its resolution cache entry. Copied on
+  // write (under 'map_mtx_') when a model is first seen so that the
+  // request path can read it with a single atomic load.
+  std::shared_ptr<const ResolutionCacheMap> resolution_cache_;
+
   std::shared_ptr<ServerStatusManager> status_manager_;
 
+  // Bound on the number of backends being created concurrently,
+  // 0 indicates no limit. Model versions at the same level of the
+  // dependency graph are all loaded on their own threads, for large
+  // repositories the bound keeps the loads from oversubscribing CPU,
+  // host and device memory.
+  const uint32_t max_concurrent_loads_;
+  uint32_t inflight_load_count_;
+  std::mutex load_mtx_;
+  std::condition_variable load_cv_;
+
 #ifdef TRTIS_ENABLE_CAFFE2
   std::unique_ptr<NetDefBackendFactory> netdef_factory_;
 #endif  // TRTIS_ENABLE_CAFFE2
@@ -400,11 +486,11 @@ Status
 ModelRepositoryManager::BackendLifeCycle::Create(
     InferenceServer* server, const double min_compute_capability,
     const std::shared_ptr<ServerStatusManager>& status_manager,
-    const BackendConfigMap& backend_map,
+    const BackendConfigMap& backend_map, const uint32_t max_concurrent_loads,
     std::unique_ptr<BackendLifeCycle>* life_cycle)
 {
-  std::unique_ptr<BackendLifeCycle> local_life_cycle(
-      new BackendLifeCycle(min_compute_capability, status_manager));
+  std::unique_ptr<BackendLifeCycle> local_life_cycle(new BackendLifeCycle(
+      min_compute_capability, status_manager, max_concurrent_loads));
 
 #ifdef TRTIS_ENABLE_TENSORFLOW
   {
@@ -549,6 +635,35 @@ ModelRepositoryManager::BackendLifeCycle::GetInferenceBackend(
 {
   LOG_VERBOSE(1) << "GetInferenceBackend() '" << model_name << "' version "
                  << version;
+
+  // Lock-free fast path: resolve against the immutable snapshot built
+  // after the last state change of the model. On any miss fall
+  // through to the locked path, which also provides the proper error
+  // status.
+  {
+    auto cache_map = std::atomic_load(&resolution_cache_);
+    auto cit = cache_map->find(model_name);
+    if (cit != cache_map->end()) {
+      const uint64_t generation = cit->second->generation_.load();
+      auto snapshot = std::atomic_load(&cit->second->snapshot_);
+      if ((snapshot != nullptr) && (snapshot->generation_ == generation)) {
+        if (version == -1) {
+          if (!snapshot->ready_versions_.empty()) {
+            *backend = snapshot->ready_versions_.rbegin()->second.lock();
+          }
+        } else {
+          auto svit = snapshot->ready_versions_.find(version);
+          if (svit != snapshot->ready_versions_.end()) {
+            *backend = svit->second.lock();
+          }
+        }
+        if (*backend != nullptr) {
+          return Status::Success;
+        }
+      }
+    }
+  }
+
   std::lock_guard<std::mutex> map_lock(map_mtx_);
   auto mit = map_.find(model_name);
   if (mit == map_.end()) {
@@ -556,6 +671,24 @@ ModelRepositoryManager::BackendLifeCycle::GetInferenceBackend(
         Status::Code::NOT_FOUND, "model '" + model_name + "' is not found");
   }
 
+  // Rebuild the resolution snapshot while holding the lock so that
+  // later requests take the lock-free path.
+  auto cache_it = resolution_cache_->find(model_name);
+  if (cache_it != resolution_cache_->end()) {
+    auto snapshot = std::make_shared<ResolutionSnapshot>();
+    snapshot->generation_ = cache_it->second->generation_.load();
+    for (auto& version_backend : mit->second) {
+      std::lock_guard<std::recursive_mutex> lock(version_backend.second->mtx_);
+      if (version_backend.second->state_ == ModelReadyState::MODEL_READY) {
+        snapshot->ready_versions_.emplace(
+            version_backend.first, version_backend.second->backend_);
+      }
+    }
+    std::atomic_store(
+        &cache_it->second->snapshot_,
+        std::shared_ptr<const ResolutionSnapshot>(std::move(snapshot)));
+  }
+
   auto vit = mit->second.find(version);
   if (vit == mit->second.end()) {
     // In case the request is asking for latest version
@@ -596,6 +729,18 @@ ModelRepositoryManager::BackendLifeCycle::GetInferenceBackend(
   return Status::Success;
 }
 
+void
+ModelRepositoryManager::BackendLifeCycle::InvalidateResolutionCache(
+    BackendInfo* backend_info)
+{
+  if (backend_info->cache_entry_ != nullptr) {
+    backend_info->cache_entry_->generation_++;
+    std::atomic_store(
+        &backend_info->cache_entry_->snapshot_,
+        std::shared_ptr<const ResolutionSnapshot>());
+  }
+}
+
 Status
 ModelRepositoryManager::BackendLifeCycle::AsyncLoad(
     const std::string& repository_path, const std::string& model_name,
@@ -610,6 +755,22 @@ ModelRepositoryManager::BackendLifeCycle::AsyncLoad(
     it = map_.emplace(std::make_pair(model_name, VersionMap())).first;
   }
 
+  // Make sure the model has a resolution cache entry. The cache map
+  // is copied on write so the request path can read it without a
+  // lock.
+  std::shared_ptr<ResolutionCacheEntry> cache_entry;
+  auto cit = resolution_cache_->find(model_name);
+  if (cit == resolution_cache_->end()) {
+    cache_entry = std::make_shared<ResolutionCacheEntry>();
+    auto new_cache = std::make_shared<ResolutionCacheMap>(*resolution_cache_);
+    (*new_cache)[model_name] = cache_entry;
+    std::atomic_store(
+        &resolution_cache_,
+        std::shared_ptr<const ResolutionCacheMap>(std::move(new_cache)));
+  } else {
+    cache_entry = cit->second;
+  }
+
   for (const auto& version : versions) {
     auto res = it->second.emplace(
         std::make_pair(version, std::unique_ptr<BackendInfo>()));
@@ -617,6 +778,7 @@ ModelRepositoryManager::BackendLifeCycle::AsyncLoad(
       res.first->second.reset(new BackendInfo(
           repository_path, ModelReadyState::MODEL_UNKNOWN,
           ActionType::NO_ACTION, model_config));
+      res.first->second->cache_entry_ = cache_entry;
     }
   }
 
@@ -705,6 +867,7 @@ ModelRepositoryManager::BackendLifeCycle::Load(
       LOG_INFO << "re-loading: " << model_name << ":" << version;
       backend_info->state_ = ModelReadyState::MODEL_UNLOADING;
       backend_info->state_reason_.Clear();
+      InvalidateResolutionCache(backend_info);
       status_manager_->SetModelVersionReadyState(
           model_name, version, backend_info->state_,
           backend_info->state_reason_);
@@ -750,6 +913,7 @@ ModelRepositoryManager::BackendLifeCycle::Unload(
       LOG_INFO << "unloading: " << model_name << ":" << version;
       backend_info->state_ = ModelReadyState::MODEL_UNLOADING;
       backend_info->state_reason_.Clear();
+      InvalidateResolutionCache(backend_info);
       status_manager_->SetModelVersionReadyState(
           model_name, version, backend_info->state_,
           backend_info->state_reason_);
@@ -778,6 +942,32 @@ ModelRepositoryManager::BackendLifeCycle::CreateInferenceBackend(
 {
   LOG_VERBOSE(1) << "CreateInferenceBackend() '" << model_name << "' version "
                  << version;
+
+  // Each version is loaded on its own thread, wait for a load slot so
+  // that at most 'max_concurrent_loads_' backends are created at once.
+  if (max_concurrent_loads_ != 0) {
+    std::unique_lock<std::mutex> lk(load_mtx_);
+    load_cv_.wait(
+        lk, [this]() { return inflight_load_count_ < max_concurrent_loads_; });
+    inflight_load_count_++;
+  }
+
+  // A load on a serving node competes with live traffic for storage
+  // bandwidth and CPU. Pace this thread's file reads by the
+  // configured load read bandwidth and optionally lower the thread's
+  // scheduling priority (TRTSERVER_LOAD_NICE, nice value 1-19), so a
+  // background load trades its own duration for steady-state latency.
+  ScopedReadThrottle read_throttle;
+  {
+    static const int load_nice = []() {
+      const char* nstr = getenv("TRTSERVER_LOAD_NICE");
+      return (nstr == nullptr) ? 0 : atoi(nstr);
+    }();
+    if (load_nice > 0) {
+      setpriority(PRIO_PROCESS, syscall(SYS_gettid), load_nice);
+    }
+  }
+
   const auto version_path = JoinPath(
       {backend_info->repository_path_, model_name, std::to_string(version)});
   // make copy of the current model config in case model config in backend info
@@ -870,6 +1060,7 @@ ModelRepositoryManager::BackendLifeCycle::CreateInferenceBackend(
               std::lock_guard<std::recursive_mutex> lock(backend_info->mtx_);
               backend_info->state_ = ModelReadyState::MODEL_UNAVAILABLE;
               backend_info->state_reason_.set_message("unloaded");
+              this->InvalidateResolutionCache(backend_info);
               status_manager_->SetModelVersionReadyState(
                   model_name, version, backend_info->state_,
                   backend_info->state_reason_);
@@ -879,6 +1070,7 @@ ModelRepositoryManager::BackendLifeCycle::CreateInferenceBackend(
           }));
       backend_info->state_ = ModelReadyState::MODEL_READY;
       backend_info->state_reason_.Clear();
+      InvalidateResolutionCache(backend_info);
       status_manager_->SetModelVersionReadyState(
           model_name, version, backend_info->state_,
           backend_info->state_reason_);
@@ -889,27 +1081,226 @@ ModelRepositoryManager::BackendLifeCycle::CreateInferenceBackend(
                 << ": " << status.AsString();
       backend_info->state_ = ModelReadyState::MODEL_UNAVAILABLE;
       backend_info->state_reason_.set_message(status.AsString());
+      InvalidateResolutionCache(backend_info);
       status_manager_->SetModelVersionReadyState(
           model_name, version, backend_info->state_,
           backend_info->state_reason_);
     }
   }
 
+  // Release the load slot before triggering the next action since the
+  // next action may be another load.
+  if (max_concurrent_loads_ != 0) {
+    {
+      std::lock_guard<std::mutex> lk(load_mtx_);
+      inflight_load_count_--;
+    }
+    load_cv_.notify_one();
+  }
+
   // Check if next action is requested
   return TriggerNextAction(model_name, version, backend_info);
 }
 
+// Watches the model repository directories with inotify so that a
+// poll cycle can be limited to the model directories that actually
+// changed. Only local filesystem paths can be watched. inotify only
+// reports changes made through this host, so a full poll is still
+// forced periodically to pick up changes made by other clients of a
+// network filesystem.
+class ModelRepositoryManager::RepositoryWatcher {
+ public:
+  static Status Create(
+      const std::set<std::string>& repository_paths,
+      std::unique_ptr<RepositoryWatcher>* watcher);
+  ~RepositoryWatcher();
+
+  /// Collect the filesystem changes since the last call. Return true
+  /// and the names of the changed models in 'changed_models' if the
+  /// changes can be attributed to individual models, false if a full
+  /// poll of the repository is required.
+  bool DrainChanges(std::set<std::string>* changed_models);
+
+ private:
+  // Force a full poll every this many poll cycles to reconcile
+  // changes that inotify can't report.
+  static constexpr uint32_t kFullPollInterval = 10;
+
+  explicit RepositoryWatcher(const int fd) : fd_(fd), poll_cnt_(0) {}
+  Status AddWatch(const std::string& path, const std::string& model_name);
+  Status WatchModelDirectory(
+      const std::string& path, const std::string& model_name);
+
+  int fd_;
+  uint32_t poll_cnt_;
+
+  // Map from watch descriptor to the directory path and the name of
+  // the model that the directory belongs to. The model name is empty
+  // for repository root directories.
+  std::unordered_map<int, std::pair<std::string, std::string>> watches_;
+};
+
+constexpr uint32_t ModelRepositoryManager::RepositoryWatcher::kFullPollInterval;
+
+Status
+ModelRepositoryManager::RepositoryWatcher::Create(
+    const std::set<std::string>& repository_paths,
+    std::unique_ptr<RepositoryWatcher>* watcher)
+{
+  // inotify can only watch directories on the local filesystem.
+  for (const auto& path : repository_paths) {
+    if ((path.find("gs://") == 0) || (path.find("s3://") == 0)) {
+      return Status(
+          Status::Code::UNSUPPORTED,
+          "cannot watch non-local model repository " + path);
+    }
+  }
+
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd == -1) {
+    return Status(
+        Status::Code::INTERNAL,
+        std::string("failed to initialize inotify: ") + strerror(errno));
+  }
+
+  std::unique_ptr<RepositoryWatcher> local_watcher(new RepositoryWatcher(fd));
+  for (const auto& path : repository_paths) {
+    RETURN_IF_ERROR(local_watcher->AddWatch(path, "" /* model_name */));
+    std::set<std::string> subdirs;
+    RETURN_IF_ERROR(GetDirectorySubdirs(path, &subdirs));
+    for (const auto& subdir : subdirs) {
+      RETURN_IF_ERROR(local_watcher->WatchModelDirectory(
+          JoinPath({path, subdir}), subdir));
+    }
+  }
+
+  *watcher = std::move(local_watcher);
+  return Status::Success;
+}
+
+ModelRepositoryManager::RepositoryWatcher::~RepositoryWatcher()
+{
+  close(fd_);
+}
+
+Status
+ModelRepositoryManager::RepositoryWatcher::AddWatch(
+    const std::string& path, const std::string& model_name)
+{
+  const uint32_t mask = IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                        IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+  int wd = inotify_add_watch(fd_, path.c_str(), mask);
+  if (wd == -1) {
+    return Status(
+        Status::Code::INTERNAL,
+        "failed to watch model directory " + path + ": " + strerror(errno));
+  }
+
+  watches_[wd] = std::make_pair(path, model_name);
+  return Status::Success;
+}
+
+Status
+ModelRepositoryManager::RepositoryWatcher::WatchModelDirectory(
+    const std::string& path, const std::string& model_name)
+{
+  RETURN_IF_ERROR(AddWatch(path, model_name));
+
+  std::set<std::string> subdirs;
+  RETURN_IF_ERROR(GetDirectorySubdirs(path, &subdirs));
+  for (const auto& subdir : subdirs) {
+    RETURN_IF_ERROR(WatchModelDirectory(JoinPath({path, subdir}), model_name));
+  }
+
+  return Status::Success;
+}
+
+bool
+ModelRepositoryManager::RepositoryWatcher::DrainChanges(
+    std::set<std::string>* changed_models)
+{
+  changed_models->clear();
+
+  // Force a full poll on the first cycle, since events before the
+  // watches were in place can't have been seen, and periodically
+  // after that to reconcile changes that inotify doesn't report.
+  poll_cnt_++;
+  bool full_poll_needed =
+      (poll_cnt_ == 1) || ((poll_cnt_ % kFullPollInterval) == 0);
+
+  alignas(struct inotify_event) char buffer[16384];
+  ssize_t len;
+  while ((len = read(fd_, buffer, sizeof(buffer))) > 0) {
+    ssize_t offset = 0;
+    while (offset < len) {
+      const struct inotify_event* event =
+          reinterpret_cast<struct inotify_event*>(buffer + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+
+      if ((event->mask & IN_Q_OVERFLOW) != 0) {
+        // Events were dropped so the full set of changes is unknown.
+        full_poll_needed = true;
+        continue;
+      }
+      if ((event->mask & IN_IGNORED) != 0) {
+        watches_.erase(event->wd);
+        continue;
+      }
+
+      const auto wit = watches_.find(event->wd);
+      if (wit == watches_.end()) {
+        continue;
+      }
+
+      const std::string name =
+          (event->len > 0) ? std::string(event->name) : std::string();
+      std::string model_name = wit->second.second;
+      if (model_name.empty()) {
+        // Event on a repository root, the entry name is the model
+        // name. Only directories represent models.
+        if (((event->mask & IN_ISDIR) == 0) || name.empty() ||
+            (name[0] == '.')) {
+          continue;
+        }
+        model_name = name;
+      }
+
+      changed_models->insert(model_name);
+
+      // Newly appearing directories need to be watched as well. If
+      // the directory disappears before the watch is added the next
+      // poll of the model reports the change.
+      if (((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) &&
+          ((event->mask & IN_ISDIR) != 0)) {
+        Status status = WatchModelDirectory(
+            JoinPath({wit->second.first, name}), model_name);
+        if (!status.IsOk()) {
+          LOG_VERBOSE(1) << status.Message();
+        }
+      }
+    }
+  }
+
+  if ((len == -1) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+    LOG_ERROR << "failed to read inotify events: " << strerror(errno);
+    full_poll_needed = true;
+  }
+
+  return !full_poll_needed;
+}
+
 ModelRepositoryManager::ModelRepositoryManager(
     const std::shared_ptr<ServerStatusManager>& status_manager,
     const std::set<std::string>& repository_paths,
     const BackendConfigMap& backend_config_map, const bool autofill,
     const bool polling_enabled, const bool model_control_enabled,
-    const double min_compute_capability,
+    const bool lazy_load_enabled, const double min_compute_capability,
     std::unique_ptr<BackendLifeCycle> life_cycle)
     : repository_paths_(repository_paths),
       backend_config_map_(backend_config_map), autofill_(autofill),
       polling_enabled_(polling_enabled),
       model_control_enabled_(model_control_enabled),
+      lazy_load_enabled_(lazy_load_enabled),
       min_compute_capability_(min_compute_capability),
       status_manager_(status_manager),
       backend_life_cycle_(std::move(life_cycle))
@@ -926,8 +1317,9 @@ ModelRepositoryManager::Create(
     const std::set<std::string>& startup_models, const bool strict_model_config,
     const float tf_gpu_memory_fraction, const bool tf_allow_soft_placement,
     const std::map<int, std::pair<int, uint64_t>> tf_memory_limit_mb,
-    const bool polling_enabled, const bool model_control_enabled,
-    const double min_compute_capability,
+    const int tf_shared_thread_pool_size, const bool polling_enabled,
+    const bool model_control_enabled, const bool lazy_load_enabled,
+    const double min_compute_capability, const uint32_t model_load_concurrency,
     std::unique_ptr<ModelRepositoryManager>* model_repository_manager)
 {
   // The rest only matters if repository path is valid directory
@@ -946,27 +1338,70 @@ ModelRepositoryManager::Create(
         Status::Code::INVALID_ARG,
         "cannot enable both polling and explicit model control");
   }
+  if (lazy_load_enabled && (polling_enabled || model_control_enabled)) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "cannot enable lazy model loading with polling or explicit model "
+        "control");
+  }
+
+  // If configured, create the persistent artifact cache so that the
+  // backends can reuse post-optimization artifacts across server
+  // restarts. Failure to create the cache is not fatal, the backends
+  // just optimize from scratch as before.
+  const char* artifact_cache_dir = getenv("TRTSERVER_MODEL_CACHE_DIR");
+  if ((artifact_cache_dir != nullptr) && (artifact_cache_dir[0] != '\0')) {
+    Status cache_status = ModelArtifactCache::Create(artifact_cache_dir);
+    if (!cache_status.IsOk()) {
+      LOG_WARNING << "Failed to create model artifact cache: "
+                  << cache_status.Message();
+    }
+  }
 
   BackendConfigMap backend_config_map;
 
   BuildBackendConfigMap(
       server_version, strict_model_config, tf_gpu_memory_fraction,
-      tf_allow_soft_placement, tf_memory_limit_mb, &backend_config_map);
+      tf_allow_soft_placement, tf_memory_limit_mb, tf_shared_thread_pool_size,
+      &backend_config_map);
 
   std::unique_ptr<BackendLifeCycle> life_cycle;
   RETURN_IF_ERROR(BackendLifeCycle::Create(
       server, min_compute_capability, status_manager, backend_config_map,
-      &life_cycle));
+      model_load_concurrency, &life_cycle));
 
   // Not setting the smart pointer directly to simplify clean up
   std::unique_ptr<ModelRepositoryManager> local_manager(
       new ModelRepositoryManager(
           status_manager, repository_paths, backend_config_map,
           !strict_model_config, polling_enabled, model_control_enabled,
-          min_compute_capability, std::move(life_cycle)));
+          lazy_load_enabled, min_compute_capability, std::move(life_cycle)));
+
+  // When polling is enabled, try to watch the repository directories
+  // so that a poll cycle only needs to examine the models that
+  // changed. If the repository can't be watched (e.g. cloud storage)
+  // every cycle falls back to a full poll.
+  if (polling_enabled) {
+    Status watcher_status = RepositoryWatcher::Create(
+        repository_paths, &local_manager->repository_watcher_);
+    if (!watcher_status.IsOk()) {
+      LOG_VERBOSE(1) << "repository watcher disabled: "
+                     << watcher_status.Message();
+    }
+  }
 
   bool all_models_polled = true;
-  if (!model_control_enabled) {
+  if (lazy_load_enabled) {
+    // Register the configuration of every model so the status
+    // endpoints can describe them, but only load the models that were
+    // explicitly requested at startup. The remaining models are
+    // loaded on their first inference request.
+    RETURN_IF_ERROR(local_manager->RegisterModels(&all_models_polled));
+    if (!startup_models.empty()) {
+      RETURN_IF_ERROR(local_manager->LoadUnloadModels(
+          startup_models, ActionType::LOAD, &all_models_polled));
+    }
+  } else if (!model_control_enabled) {
     // only error happens before model load / unload will be return
     // model loading / unloading error will be printed but ignored
     RETURN_IF_ERROR(local_manager->PollAndUpdateInternal(&all_models_polled));
@@ -1005,6 +1440,29 @@ Status
 ModelRepositoryManager::GetModelRepositoryIndex(
     ModelRepositoryIndex* repository_index)
 {
+  std::lock_guard<std::mutex> lock(index_mu_);
+
+  // The index is rebuilt from the filesystem only when a poll has
+  // invalidated it, so frequent index requests between polls don't
+  // repeatedly walk the repository.
+  if (!index_valid_) {
+    RETURN_IF_ERROR(RebuildRepositoryIndex());
+  }
+
+  repository_index->Clear();
+  repository_index->set_generation(index_generation_);
+  for (const auto& model : index_models_) {
+    auto entry = repository_index->add_models();
+    entry->set_name(model);
+  }
+
+  return Status::Success;
+}
+
+Status
+ModelRepositoryManager::RebuildRepositoryIndex()
+{
+  // Must hold the lock on 'index_mu_' while calling this function.
   std::set<std::string> duplicated_models;
   std::set<std::string> models;
   for (const auto& repository_path : repository_paths_) {
@@ -1023,15 +1481,73 @@ ModelRepositoryManager::GetModelRepositoryIndex(
     models.erase(duplicated_model);
   }
 
-  repository_index->Clear();
-  for (const auto& model : models) {
-    auto entry = repository_index->add_models();
-    entry->set_name(model);
+  if (models != index_models_) {
+    index_models_.swap(models);
+    index_generation_++;
   }
 
+  index_valid_ = true;
   return Status::Success;
 }
 
+void
+ModelRepositoryManager::InvalidateRepositoryIndex()
+{
+  std::lock_guard<std::mutex> lock(index_mu_);
+  index_valid_ = false;
+}
+
+void
+ModelRepositoryManager::UpdateRepositoryIndex(const std::set<std::string>& models)
+{
+  std::lock_guard<std::mutex> lock(index_mu_);
+
+  // If the index is already stale the next index request rebuilds it
+  // anyway.
+  if (!index_valid_) {
+    return;
+  }
+
+  bool changed = false;
+  for (const auto& model : models) {
+    // A model belongs in the index only if its directory exists in
+    // exactly one repository path, matching the duplicate handling of
+    // the full rebuild.
+    size_t dir_cnt = 0;
+    for (const auto& repository_path : repository_paths_) {
+      const auto model_path = JoinPath({repository_path, model});
+      bool exists = false;
+      Status status = FileExists(model_path, &exists);
+      if (status.IsOk() && exists) {
+        bool is_dir = false;
+        status = IsDirectory(model_path, &is_dir);
+        exists = is_dir;
+      }
+
+      if (!status.IsOk()) {
+        // Can't tell what changed... fall back to a full rebuild on
+        // the next index request.
+        index_valid_ = false;
+        return;
+      }
+
+      if (exists) {
+        dir_cnt++;
+      }
+    }
+
+    if (dir_cnt == 1) {
+      changed |= index_models_.insert(model).second;
+    } else {
+      changed |= (index_models_.erase(model) > 0);
+    }
+  }
+
+  if (changed) {
+    index_generation_++;
+  }
+}
+
 Status
 ModelRepositoryManager::PollAndUpdate()
 {
@@ -1051,6 +1567,18 @@ ModelRepositoryManager::PollAndUpdateInternal(bool* all_models_polled)
 
   std::set<std::string> added, deleted, modified, unmodified;
 
+  // If the repository watcher is active, limit the poll to the model
+  // directories that changed since the last poll.
+  bool full_poll = true;
+  std::set<std::string> changed_models;
+  if (repository_watcher_ != nullptr) {
+    full_poll = !repository_watcher_->DrainChanges(&changed_models);
+    if (!full_poll && changed_models.empty()) {
+      // Nothing has changed since the last poll.
+      return Status::Success;
+    }
+  }
+
   // We don't modify 'infos_' in place to minimize how long we need to
   // hold the lock and also prevent any partial changes to do an error
   // during processing.
@@ -1060,8 +1588,29 @@ ModelRepositoryManager::PollAndUpdateInternal(bool* all_models_polled)
   // which we read the model configuration.
   std::set<std::string> subdirs;
   RETURN_IF_ERROR(Poll(
-      subdirs, &added, &deleted, &modified, &unmodified, &new_infos,
-      all_models_polled));
+      full_poll ? subdirs : changed_models, &added, &deleted, &modified,
+      &unmodified, &new_infos, all_models_polled));
+
+  // Keep the in-memory repository index current. A watcher-limited
+  // poll updates just the changed model directories; a full poll
+  // marks the index for rebuild on the next index request.
+  if (full_poll) {
+    InvalidateRepositoryIndex();
+  } else {
+    UpdateRepositoryIndex(changed_models);
+  }
+
+  // When only the changed models were polled, the models that didn't
+  // see any filesystem change carry over unchanged.
+  if (!full_poll) {
+    for (const auto& pr : infos_) {
+      if (changed_models.find(pr.first) == changed_models.end()) {
+        new_infos.emplace(
+            pr.first, std::unique_ptr<ModelInfo>(new ModelInfo(*pr.second)));
+        unmodified.insert(pr.first);
+      }
+    }
+  }
 
   // Anything in 'infos_' that is not in "added", "modified", or
   // "unmodified" is deleted.
@@ -1073,8 +1622,30 @@ ModelRepositoryManager::PollAndUpdateInternal(bool* all_models_polled)
     }
   }
 
-  // Nothing to do if no model adds, deletes or modifies.
+  // A modified model whose only changes are hot-swappable scheduler
+  // parameters is updated in place instead of reloaded. Its new info
+  // still takes effect below with the swap of 'infos_'.
+  std::set<std::string> swapped;
+  for (auto mitr = modified.begin(); mitr != modified.end();) {
+    const auto nitr = new_infos.find(*mitr);
+    const auto itr = infos_.find(*mitr);
+    if ((nitr != new_infos.end()) && (itr != infos_.end()) &&
+        TryUpdateSchedulerConfig(*mitr, *itr->second, *nitr->second)) {
+      swapped.insert(*mitr);
+      unmodified.insert(*mitr);
+      mitr = modified.erase(mitr);
+    } else {
+      ++mitr;
+    }
+  }
+
+  // Nothing to load or unload if no model adds, deletes or modifies,
+  // but the new info of any in-place update must still be retained so
+  // the model isn't seen as modified again on the next poll.
   if (added.empty() && deleted.empty() && modified.empty()) {
+    for (const auto& name : swapped) {
+      infos_.find(name)->second = std::move(new_infos.find(name)->second);
+    }
     return Status::Success;
   }
 
@@ -1096,6 +1667,93 @@ ModelRepositoryManager::PollAndUpdateInternal(bool* all_models_polled)
   return Status::Success;
 }
 
+Status
+ModelRepositoryManager::RegisterModels(bool* all_models_polled)
+{
+  // Serialize all operations that change model state
+  std::lock_guard<std::mutex> lock(poll_mu_);
+
+  std::set<std::string> added, deleted, modified, unmodified;
+  std::set<std::string> all_models;
+
+  // Poll every model to validate its configuration and make it
+  // visible in the server status, but deliberately don't record the
+  // poll results in 'infos_'. A later load must see the model as
+  // newly added so that it is actually loaded.
+  ModelInfoMap new_infos;
+  RETURN_IF_ERROR(Poll(
+      all_models, &added, &deleted, &modified, &unmodified, &new_infos,
+      all_models_polled));
+
+  InvalidateRepositoryIndex();
+
+  for (const auto& model_name : added) {
+    const auto& model_config =
+        new_infos.find(model_name)->second->model_config_;
+    RETURN_IF_ERROR(status_manager_->InitForModel(model_name, model_config));
+    LOG_VERBOSE(1) << "registered model '" << model_name
+                   << "' for lazy loading";
+  }
+
+  return Status::Success;
+}
+
+Status
+ModelRepositoryManager::LazyLoadModel(const std::string& model_name)
+{
+  // Serialize all operations that change model state. Concurrent
+  // first requests for a model queue here and find the model ready
+  // once the first one completes the load.
+  std::lock_guard<std::mutex> lock(poll_mu_);
+
+  // Another request may have loaded the model while this one waited
+  // for the lock.
+  const auto version_states = backend_life_cycle_->GetVersionStates(model_name);
+  for (const auto& state : version_states) {
+    if (state.second == ModelReadyState::MODEL_READY) {
+      return Status::Success;
+    }
+  }
+
+  // Don't retry a model that already failed to load, the repeated
+  // load attempts would stall every request for it.
+  const auto sitr = lazy_load_status_.find(model_name);
+  if (sitr != lazy_load_status_.end()) {
+    return sitr->second;
+  }
+
+  LOG_INFO << "lazily loading model '" << model_name << "'";
+
+  bool polled = true;
+  Status status = LoadUnloadModels({model_name}, ActionType::LOAD, &polled);
+  if (status.IsOk() && !polled) {
+    status = Status(
+        Status::Code::NOT_FOUND,
+        "failed to poll model '" + model_name + "' from model repository");
+  }
+
+  if (status.IsOk()) {
+    bool ready = false;
+    for (const auto& state :
+         backend_life_cycle_->GetVersionStates(model_name)) {
+      ready |= (state.second == ModelReadyState::MODEL_READY);
+    }
+    if (!ready) {
+      status = Status(
+          Status::Code::INTERNAL,
+          "failed to load '" + model_name + "', no version is available");
+    }
+  }
+
+  if (!status.IsOk()) {
+    LOG_ERROR << "failed to lazily load model '" << model_name
+              << "': " << status.Message();
+    lazy_load_status_.emplace(model_name, status);
+  }
+
+  return status;
+}
+
 Status
 ModelRepositoryManager::Update(
     const std::set<std::string>& added, const std::set<std::string>& deleted,
@@ -1275,6 +1933,83 @@ ModelRepositoryManager::LoadUnloadModel(
   return Status::Success;
 }
 
+bool
+ModelRepositoryManager::TryUpdateSchedulerConfig(
+    const std::string& model_name, const ModelInfo& old_info,
+    const ModelInfo& new_info)
+{
+  // The model contents must be unchanged, only the configuration may
+  // have been modified.
+  if (old_info.version_mtime_nsec_ != new_info.version_mtime_nsec_) {
+    return false;
+  }
+
+  // The configurations may differ only in the scheduler parameters
+  // that the schedulers can swap between batch formations.
+  // Queue-policy and priority changes restructure the request queues
+  // and so still require a full reload.
+  ModelConfig old_config = old_info.model_config_;
+  ModelConfig new_config = new_info.model_config_;
+  for (auto config : {&old_config, &new_config}) {
+    if (config->has_dynamic_batching()) {
+      auto batcher = config->mutable_dynamic_batching();
+      batcher->clear_preferred_batch_size();
+      batcher->clear_max_queue_delay_microseconds();
+    }
+    if (config->has_sequence_batching()) {
+      auto batcher = config->mutable_sequence_batching();
+      batcher->clear_max_sequence_idle_microseconds();
+      if (batcher->has_oldest()) {
+        batcher->mutable_oldest()->clear_preferred_batch_size();
+        batcher->mutable_oldest()->clear_max_queue_delay_microseconds();
+      }
+    }
+  }
+  if (old_config.SerializeAsString() != new_config.SerializeAsString()) {
+    return false;
+  }
+
+  // Apply the new parameters to every in-service version. On any
+  // failure fall back to a full reload, which converges all versions.
+  bool updated = false;
+  for (const auto& pr : backend_life_cycle_->GetVersionStates(model_name)) {
+    if (pr.second != ModelReadyState::MODEL_READY) {
+      continue;
+    }
+
+    std::shared_ptr<InferenceBackend> backend;
+    Status status = backend_life_cycle_->GetInferenceBackend(
+        model_name, pr.first, &backend);
+    if (status.IsOk()) {
+      status = backend->UpdateSchedulerConfig(new_info.model_config_);
+    }
+    if (!status.IsOk()) {
+      LOG_WARNING << "failed in-place scheduler update for '" << model_name
+                  << "' version " << pr.first << ": " << status.Message()
+                  << ", the model will be fully reloaded";
+      return false;
+    }
+
+    updated = true;
+  }
+
+  if (updated) {
+    // Keep the status reporting in sync with the applied
+    // configuration.
+    Status status = status_manager_->UpdateConfigForModel(
+        model_name, new_info.model_config_);
+    if (!status.IsOk()) {
+      LOG_WARNING << "failed to update status configuration for '"
+                  << model_name << "': " << status.Message();
+    }
+
+    LOG_INFO << "updated scheduler configuration of '" << model_name
+             << "' in place";
+  }
+
+  return updated;
+}
+
 Status
 ModelRepositoryManager::LoadUnloadModels(
     const std::set<std::string>& model_names, ActionType type,
@@ -1300,6 +2035,10 @@ ModelRepositoryManager::LoadUnloadModels(
             &polled));
         *all_models_polled &= polled;
 
+        // An explicit load often follows the client adding the model
+        // directory, so fold the polled models into the index.
+        UpdateRepositoryIndex(models);
+
         // More models should be polled if the polled models are ensembles
         std::set<std::string> next_models;
 #ifdef TRTIS_ENABLE_ENSEMBLE
@@ -1324,6 +2063,21 @@ ModelRepositoryManager::LoadUnloadModels(
         models.swap(next_models);
       }
 
+      // A modified model whose only changes are hot-swappable
+      // scheduler parameters is updated in place instead of reloaded.
+      for (auto mitr = modified.begin(); mitr != modified.end();) {
+        const auto nitr = new_infos.find(*mitr);
+        const auto itr = infos_.find(*mitr);
+        if ((nitr != new_infos.end()) && (itr != infos_.end()) &&
+            TryUpdateSchedulerConfig(*mitr, *itr->second, *nitr->second)) {
+          itr->second = std::move(nitr->second);
+          unmodified.insert(*mitr);
+          mitr = modified.erase(mitr);
+        } else {
+          ++mitr;
+        }
+      }
+
       // Only update the infos when all validation is completed
       for (const auto& model_name : added) {
         auto nitr = new_infos.find(model_name);
@@ -1404,6 +2158,15 @@ ModelRepositoryManager::GetInferenceBackend(
 {
   Status status = backend_life_cycle_->GetInferenceBackend(
       model_name, model_version, backend);
+  if (!status.IsOk() && lazy_load_enabled_) {
+    // In lazy-load mode the first request for a model triggers its
+    // load. Loaded models take the fast path above.
+    Status load_status = LazyLoadModel(model_name);
+    if (load_status.IsOk()) {
+      status = backend_life_cycle_->GetInferenceBackend(
+          model_name, model_version, backend);
+    }
+  }
   if (!status.IsOk()) {
     backend->reset();
     status = Status(
@@ -1492,15 +2255,33 @@ ModelRepositoryManager::Poll(
     STATE_INVALID
   };
 
-  for (const auto& pair : model_to_repository) {
-    const auto& child = pair.first;
-    const auto& repository = pair.second;
+  // Each model is polled independently: checking the modification
+  // time, loading, normalizing and validating the configuration read
+  // nothing but the model directory and 'infos_'. Autofill may need to
+  // open the model definition itself (for example deserializing a
+  // TensorRT plan to read its bindings), which makes a serial pass
+  // over a large repository take seconds per model, so poll the models
+  // concurrently and merge the results in repository order below.
+  struct ModelPollResult {
+    std::string child_;
+    std::string repository_;
+    ModelPollState state_ = STATE_UNMODIFIED;
+    std::unique_ptr<ModelInfo> info_;
+    Status status_;
+  };
 
-    auto model_poll_state = STATE_UNMODIFIED;
-    const auto full_path = JoinPath({repository, child});
+  std::vector<ModelPollResult> poll_results;
+  poll_results.reserve(model_to_repository.size());
+  for (const auto& pair : model_to_repository) {
+    poll_results.emplace_back();
+    poll_results.back().child_ = pair.first;
+    poll_results.back().repository_ = pair.second;
+  }
 
+  auto poll_fn = [this](ModelPollResult* result) {
+    const auto& child = result->child_;
+    const auto full_path = JoinPath({result->repository_, child});
 
-    std::unique_ptr<ModelInfo> model_info;
     const auto iitr = infos_.find(child);
     // If 'child' is a new model or an existing model that has been
     // modified since the last time it was polled, then need to
@@ -1508,33 +2289,34 @@ ModelRepositoryManager::Poll(
     int64_t mtime_ns;
     if (iitr == infos_.end()) {
       mtime_ns = GetModifiedTime(std::string(full_path));
-      model_poll_state = STATE_ADDED;
+      result->state_ = STATE_ADDED;
     } else {
       mtime_ns = iitr->second->mtime_nsec_;
       if (IsModified(std::string(full_path), &mtime_ns)) {
-        model_poll_state = STATE_MODIFIED;
+        result->state_ = STATE_MODIFIED;
       }
     }
 
-    Status status = Status::Success;
-    if (model_poll_state != STATE_UNMODIFIED) {
-      model_info.reset(new ModelInfo());
-      ModelConfig& model_config = model_info->model_config_;
-      model_info->mtime_nsec_ = mtime_ns;
-      model_info->model_repository_path_ = repository;
+    if (result->state_ != STATE_UNMODIFIED) {
+      result->info_.reset(new ModelInfo());
+      ModelConfig& model_config = result->info_->model_config_;
+      result->info_->mtime_nsec_ = mtime_ns;
+      result->info_->version_mtime_nsec_ =
+          GetVersionModifiedTime(std::string(full_path));
+      result->info_->model_repository_path_ = result->repository_;
 
       // If enabled, try to automatically generate missing parts of
       // the model configuration (autofill) from the model
       // definition. In all cases normalize and validate the config.
-      status = GetNormalizedModelConfig(
+      result->status_ = GetNormalizedModelConfig(
           full_path, backend_config_map_, autofill_, min_compute_capability_,
           &model_config);
-      if (status.IsOk()) {
-        status = ValidateModelConfig(
+      if (result->status_.IsOk()) {
+        result->status_ = ValidateModelConfig(
             model_config, std::string(), min_compute_capability_);
       }
-      if (status.IsOk()) {
-        model_info->platform_ = GetPlatform(model_config.platform());
+      if (result->status_.IsOk()) {
+        result->info_->platform_ = GetPlatform(model_config.platform());
 
         // Make sure the name of the model matches the name of the
         // directory. This is a somewhat arbitrary requirement but seems
@@ -1542,7 +2324,7 @@ ModelRepositoryManager::Poll(
         // check to make sure we don't have two different models with the
         // same name.
         if (model_config.name() != child) {
-          status = Status(
+          result->status_ = Status(
               Status::Code::INVALID_ARG,
               "unexpected directory name '" + child + "' for model '" +
                   model_config.name() +
@@ -1550,14 +2332,51 @@ ModelRepositoryManager::Poll(
         }
       }
 
-      if (!status.IsOk()) {
-        if (model_poll_state == STATE_MODIFIED) {
-          model_poll_state = STATE_UNMODIFIED;
+      if (!result->status_.IsOk()) {
+        if (result->state_ == STATE_MODIFIED) {
+          result->state_ = STATE_UNMODIFIED;
         } else {
-          model_poll_state = STATE_INVALID;
+          result->state_ = STATE_INVALID;
+        }
+      }
+    }
+  };
+
+  {
+    const size_t worker_cnt = std::min(
+        poll_results.size(),
+        (size_t)std::max(1u, std::thread::hardware_concurrency()));
+    std::atomic<size_t> next_result(0);
+    const size_t result_cnt = poll_results.size();
+    ModelPollResult* results = poll_results.data();
+    auto worker_fn = [poll_fn, &next_result, results, result_cnt]() {
+      while (true) {
+        const size_t idx = next_result.fetch_add(1);
+        if (idx >= result_cnt) {
+          break;
         }
+        poll_fn(&results[idx]);
+      }
+    };
+
+    if (worker_cnt <= 1) {
+      worker_fn();
+    } else {
+      std::vector<std::thread> workers;
+      for (size_t widx = 0; widx < worker_cnt; widx++) {
+        workers.emplace_back(worker_fn);
+      }
+      for (auto& worker : workers) {
+        worker.join();
       }
     }
+  }
+
+  for (auto& result : poll_results) {
+    const auto& child = result.child_;
+    const auto model_poll_state = result.state_;
+    std::unique_ptr<ModelInfo> model_info = std::move(result.info_);
+    const Status& status = result.status_;
 
     if (model_poll_state != STATE_INVALID) {
       const auto& ret = updated_infos->emplace(child, nullptr);
@@ -1568,7 +2387,7 @@ ModelRepositoryManager::Poll(
       }
 
       if (model_poll_state == STATE_UNMODIFIED) {
-        ret.first->second.reset(new ModelInfo(*iitr->second));
+        ret.first->second.reset(new ModelInfo(*infos_.find(child)->second));
         unmodified->insert(child);
       } else {
         ret.first->second = std::move(model_info);
@@ -82,14 +82,24 @@ class ModelRepositoryManager {
   /// for TensorFlow models.
   /// \param tf_allow_soft_placement If true instruct TensorFlow to use CPU
   /// implementation of an operation when a GPU implementation is not available
+  /// \param tf_shared_thread_pool_size If >= 0 TensorFlow sessions
+  /// schedule work on a thread pool shared across all TF models, sized
+  /// to the value (or to the TF default when 0). If < 0 each session
+  /// creates its own thread pools.
   /// \param polling_enabled If true, then PollAndUpdate() is allowed.
   /// Otherwise, it is not allowed.
   /// \param model_control_enabled If true, then LoadUnloadModel() is allowed
   /// and the models in the model repository will not be loaded at startup.
   /// Otherwise, LoadUnloadModel() is not allowed and the models will be loaded.
   /// Cannot be set to true if polling_enabled is true.
+  /// \param lazy_load_enabled If true, model configurations are registered
+  /// at startup but each model is loaded on its first inference request.
+  /// Models listed in startup_models are loaded at startup. Cannot be set
+  /// to true if polling_enabled or model_control_enabled is true.
   /// \param min_compute_capability The minimum support CUDA compute
   /// capability.
+  /// \param model_load_concurrency The maximum number of models that
+  /// may be loading concurrently, 0 indicates no limit.
   /// \return The error status.
   static Status Create(
       InferenceServer* server, const std::string& server_version,
@@ -99,8 +109,10 @@ class ModelRepositoryManager {
       const bool strict_model_config, const float tf_gpu_memory_fraction,
       const bool tf_allow_soft_placement,
       const std::map<int, std::pair<int, uint64_t>> tf_memory_limit_mb,
-      const bool polling_enabled, const bool model_control_enabled,
+      const int tf_shared_thread_pool_size, const bool polling_enabled,
+      const bool model_control_enabled, const bool lazy_load_enabled,
       const double min_compute_capability,
+      const uint32_t model_load_concurrency,
       std::unique_ptr<ModelRepositoryManager>* model_repository_manager);
 
   /// Poll the model repository to determine the new set of models and
@@ -141,11 +153,17 @@ class ModelRepositoryManager {
       const std::string& model_name, const int64_t model_version,
       std::shared_ptr<InferenceBackend>* backend);
 
+  /// Populate the model repository index from the in-memory index,
+  /// rebuilding it from the filesystem only when a poll has
+  /// invalidated it. The index carries a generation number that
+  /// changes only when the index contents change, so a polling client
+  /// can cache the model list.
   Status GetModelRepositoryIndex(ModelRepositoryIndex* repository_index);
 
  private:
   struct ModelInfo;
   class BackendLifeCycle;
+  class RepositoryWatcher;
 
   // Map from model name to information about the model.
   using ModelInfoMap =
@@ -159,12 +177,23 @@ class ModelRepositoryManager {
       const std::set<std::string>& repository_paths,
       const BackendConfigMap& backend_config_map, const bool autofill,
       const bool polling_enabled, const bool model_control_enabled,
-      const double min_compute_capability,
+      const bool lazy_load_enabled, const double min_compute_capability,
       std::unique_ptr<BackendLifeCycle> life_cycle);
 
   /// The internal function that are called in Create() and PollAndUpdate().
   Status PollAndUpdateInternal(bool* all_models_polled);
 
+  /// Poll the repository and register the configuration of every
+  /// model with the status manager, without loading any model. Used
+  /// in lazy-load mode so that model metadata is available before the
+  /// models themselves are loaded.
+  Status RegisterModels(bool* all_models_polled);
+
+  /// Load 'model_name' on its first inference request. Blocks until
+  /// the load completes; concurrent requests for the model queue
+  /// behind the load and are released when it finishes.
+  Status LazyLoadModel(const std::string& model_name);
+
   /// The internal function that load or unload a set of models.
   Status LoadUnloadModels(
       const std::set<std::string>& models, ActionType type,
@@ -193,6 +222,21 @@ class ModelRepositoryManager {
       std::set<std::string>* unmodified, ModelInfoMap* updated_infos,
       bool* all_models_polled);
 
+  /// Attempt to apply the configuration of a modified model to its
+  /// live schedulers instead of fully reloading the model. The update
+  /// is applied only when the model contents are unchanged and the
+  /// configurations differ solely in hot-swappable scheduler
+  /// parameters (preferred batch sizes, queue delay, sequence idle
+  /// timeout).
+  /// \param model_name The name of the modified model.
+  /// \param old_info The model info currently in effect.
+  /// \param new_info The model info from the latest poll.
+  /// \return True if the update was applied in place and the model
+  /// does not need to be reloaded.
+  bool TryUpdateSchedulerConfig(
+      const std::string& model_name, const ModelInfo& old_info,
+      const ModelInfo& new_info);
+
   /// Update the configurations of newly added / modified model and their
   /// information shown in server status
   /// \param added The names of the models added to the repository.
@@ -266,16 +310,36 @@ class ModelRepositoryManager {
       const std::string model_repository_path, const std::string& name,
       const ModelConfig& model_config, std::set<int64_t>* versions);
 
+  /// Rebuild the in-memory repository index by walking the repository
+  /// paths. The generation is advanced only if the rebuilt index
+  /// differs from the current one. Must hold 'index_mu_'.
+  Status RebuildRepositoryIndex();
+
+  /// Mark the in-memory repository index as stale so the next index
+  /// request rebuilds it from the filesystem.
+  void InvalidateRepositoryIndex();
+
+  /// Incrementally apply a set of changed model directories to the
+  /// in-memory repository index, avoiding a full repository walk. Any
+  /// filesystem error just invalidates the index.
+  void UpdateRepositoryIndex(const std::set<std::string>& models);
+
   const std::set<std::string> repository_paths_;
   const BackendConfigMap backend_config_map_;
   const bool autofill_;
   const bool polling_enabled_;
   const bool model_control_enabled_;
+  const bool lazy_load_enabled_;
   const double min_compute_capability_;
 
   std::mutex poll_mu_;
   ModelInfoMap infos_;
 
+  // In lazy-load mode, the error status of models that failed to
+  // load lazily, so a broken model is not re-loaded on every request.
+  // Protected by 'poll_mu_'.
+  std::map<std::string, Status> lazy_load_status_;
+
   std::unordered_map<std::string, std::unique_ptr<DependencyNode>>
       dependency_graph_;
   std::unordered_map<std::string, std::unique_ptr<DependencyNode>>
@@ -284,6 +348,21 @@ class ModelRepositoryManager {
   std::shared_ptr<ServerStatusManager> status_manager_;
 
   std::unique_ptr<BackendLifeCycle> backend_life_cycle_;
+
+  // Watches the repository directories for changes so that a poll
+  // cycle only needs to examine the models that changed. nullptr if
+  // the repository can't be watched, in which case every poll cycle
+  // examines all models.
+  std::unique_ptr<RepositoryWatcher> repository_watcher_;
+
+  // The in-memory model repository index, maintained by the
+  // poll/watch machinery so that serving an index request doesn't
+  // walk the repository. 'index_generation_' changes only when the
+  // index contents change. All protected by 'index_mu_'.
+  std::mutex index_mu_;
+  bool index_valid_ = false;
+  std::set<std::string> index_models_;
+  uint64_t index_generation_ = 0;
 };
 
 }}  // namespace nvidia::inferenceserver
@@ -0,0 +1,98 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <utility>
+
+namespace nvidia { namespace inferenceserver {
+
+//
+// Lock-free multi-producer single-consumer queue. Producers push
+// concurrently without blocking; a single consumer drains all queued
+// items at once in FIFO order. Multiple threads may act as the
+// consumer as long as they serialize DrainAll() calls externally
+// (e.g. under the lock they already hold).
+//
+template <typename Item>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(nullptr) {}
+
+  ~MpscQueue()
+  {
+    Node* node = head_.load(std::memory_order_relaxed);
+    while (node != nullptr) {
+      Node* next = node->next_;
+      delete node;
+      node = next;
+    }
+  }
+
+  // Add an item to the queue. Never blocks and never takes a lock so
+  // may be called concurrently from any number of threads.
+  void Push(Item&& item)
+  {
+    Node* node = new Node(std::move(item));
+    node->next_ = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(
+        node->next_, node, std::memory_order_release,
+        std::memory_order_relaxed)) {
+    }
+  }
+
+  // Whether the queue appears empty. The result is approximate in the
+  // presence of concurrent producers.
+  bool Empty() const { return head_.load(std::memory_order_acquire) == nullptr; }
+
+  // Remove and return all queued items in FIFO order.
+  std::deque<Item> DrainAll()
+  {
+    std::deque<Item> items;
+    // The internal list is LIFO so reverse it while unlinking to
+    // return items in arrival order.
+    Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+      items.emplace_front(std::move(node->item_));
+      Node* next = node->next_;
+      delete node;
+      node = next;
+    }
+    return items;
+  }
+
+ private:
+  struct Node {
+    Node(Item&& item) : item_(std::move(item)), next_(nullptr) {}
+    Item item_;
+    Node* next_;
+  };
+
+  std::atomic<Node*> head_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,94 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver {
+
+// An immutable table interning a fixed set of tensor names, built once
+// at model load. Intern() maps a name to a dense index that callers
+// use with flat per-tensor vectors, replacing string-keyed map lookups
+// on the request path. The table is a sorted flat vector searched with
+// binary search: for the tensor counts of typical models this touches
+// a single cache line and does no hashing or node chasing.
+class TensorNameTable {
+ public:
+  TensorNameTable() = default;
+
+  // Add 'name' to the table and return its index. Must not be called
+  // after Freeze(). Adding a duplicate name returns the existing
+  // index.
+  int32_t Add(const std::string& name)
+  {
+    for (const auto& entry : entries_) {
+      if (entry.first == name) {
+        return entry.second;
+      }
+    }
+
+    const int32_t index = entries_.size();
+    entries_.emplace_back(name, index);
+    return index;
+  }
+
+  // Sort the table for lookup. Must be called once, after the last
+  // Add() and before the first Intern().
+  void Freeze()
+  {
+    std::sort(
+        entries_.begin(), entries_.end(),
+        [](const Entry& lhs, const Entry& rhs) {
+          return lhs.first < rhs.first;
+        });
+  }
+
+  // Return the index for 'name', or -1 if the name is not in the
+  // table.
+  int32_t Intern(const std::string& name) const
+  {
+    const auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), name,
+        [](const Entry& entry, const std::string& name) {
+          return entry.first < name;
+        });
+    if ((it == entries_.end()) || (it->first != name)) {
+      return -1;
+    }
+
+    return it->second;
+  }
+
+  size_t Size() const { return entries_.size(); }
+
+ private:
+  using Entry = std::pair<std::string, int32_t>;
+  std::vector<Entry> entries_;
+};
+
+}}  // namespace nvidia::inferenceserver
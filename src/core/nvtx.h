@@ -43,6 +43,24 @@ class NvtxRange {
     }
   }
 
+  // A range correlated with a request: 'id' is carried in the range
+  // payload so Nsight Systems can filter every range and marker of
+  // one request across frontend, scheduler and backend.
+  NvtxRange(const std::string& label, const uint64_t id)
+  {
+    nvtxEventAttributes_t attrs = {};
+    attrs.version = NVTX_VERSION;
+    attrs.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+    attrs.messageType = NVTX_MESSAGE_TYPE_ASCII;
+    attrs.message.ascii = label.c_str();
+    attrs.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
+    attrs.payload.ullValue = id;
+    depth_ = nvtxRangePushEx(&attrs);
+    if (depth_ < 0) {
+      LOG_ERROR << "Unable to start NVTX range '" << label << "'";
+    }
+  }
+
   ~NvtxRange()
   {
     if (depth_ >= 0) {
@@ -54,6 +72,21 @@ class NvtxRange {
   int depth_;
 };
 
+// An instant marker correlated with a request via the marker payload,
+// see NvtxRange above.
+inline void
+NvtxMarker(const std::string& label, const uint64_t id)
+{
+  nvtxEventAttributes_t attrs = {};
+  attrs.version = NVTX_VERSION;
+  attrs.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+  attrs.messageType = NVTX_MESSAGE_TYPE_ASCII;
+  attrs.message.ascii = label.c_str();
+  attrs.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
+  attrs.payload.ullValue = id;
+  nvtxMarkEx(&attrs);
+}
+
 }}  // namespace nvidia::inferenceserver
 
 #endif  // TRTIS_ENABLE_NVTX
@@ -64,9 +97,13 @@ class NvtxRange {
 #ifdef TRTIS_ENABLE_NVTX
 #define NVTX_INITIALIZE nvtxInitialize(nullptr)
 #define NVTX_RANGE(V, L) nvidia::inferenceserver::NvtxRange V(L)
+#define NVTX_RANGE_ID(V, L, ID) nvidia::inferenceserver::NvtxRange V(L, ID)
 #define NVTX_MARKER(L) nvtxMarkA(L)
+#define NVTX_MARKER_ID(L, ID) nvidia::inferenceserver::NvtxMarker(L, ID)
 #else
 #define NVTX_INITIALIZE
 #define NVTX_RANGE(V, L)
+#define NVTX_RANGE_ID(V, L, ID)
 #define NVTX_MARKER(L)
+#define NVTX_MARKER_ID(L, ID)
 #endif  // TRTIS_ENABLE_NVTX
@@ -27,9 +27,17 @@
 
 #include "src/core/pinned_memory_manager.h"
 
+#include <sys/mman.h>
+#include <algorithm>
+#include <atomic>
 #include <sstream>
+#include <vector>
 #include "src/core/logging.h"
 
+#ifdef TRTIS_ENABLE_METRICS
+#include "src/core/metrics.h"
+#endif  // TRTIS_ENABLE_METRICS
+
 #ifdef TRTIS_ENABLE_GPU
 #include <cuda_runtime_api.h>
 #endif  // TRTIS_ENABLE_GPU
@@ -46,13 +54,148 @@ PointerToString(void* ptr)
   return ss.str();
 }
 
+// Small pinned allocations are rounded up to one of the power-of-two
+// size classes 512B << [0, kNumSizeClasses) and served from
+// segregated free lists fronted by per-thread caches so that
+// concurrent Alloc / Free calls don't contend on the managed buffer
+// mutex. Larger allocations go to the managed buffer directly.
+constexpr size_t kNumSizeClasses = 13;
+constexpr uint64_t kMinClassByteSize = 512;
+
+// Marks blocks that were allocated directly from the managed buffer
+// (or with malloc for the non-pinned fallback) instead of a size
+// class.
+constexpr uint16_t kUnclassedBlock = 0xffff;
+
+// Every block starts with a header recording how to free it. The
+// header is padded to 64 bytes so the returned pointer keeps an
+// alignment suitable for DMA.
+constexpr uint64_t kBlockHeaderByteSize = 64;
+constexpr uint32_t kBlockMagic = 0x70696e62;  // "pinb"
+
+struct BlockHeader {
+  uint32_t magic_;
+  uint16_t size_class_;
+  uint16_t is_pinned_;
+
+  // Non-zero if the block is an anonymous mapping of this many bytes
+  // (a huge-page backed fallback block) that must be freed with
+  // munmap instead of free.
+  uint64_t mmapped_byte_size_;
+};
+
+// The huge page size assumed for MAP_HUGETLB and the threshold above
+// which huge-page backing is attempted.
+constexpr uint64_t kHugePageByteSize = 2 * 1024 * 1024;
+
+// Round 'byte_size' up to a whole number of huge pages.
+uint64_t
+RoundToHugePages(const uint64_t byte_size)
+{
+  return ((byte_size + kHugePageByteSize - 1) / kHugePageByteSize) *
+         kHugePageByteSize;
+}
+
+// Create an anonymous mapping of 'byte_size' bytes backed by huge
+// pages: explicitly when MAP_HUGETLB pages are available, otherwise
+// with transparent-huge-page advice. Returns nullptr if the mapping
+// can't be created. 'byte_size' must be a multiple of
+// kHugePageByteSize.
+void*
+MapHugePages(const uint64_t byte_size)
+{
+  void* mapping = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  mapping = mmap(
+      nullptr, byte_size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif  // MAP_HUGETLB
+  if (mapping == MAP_FAILED) {
+    // No explicit huge pages are reserved, fall back to a normal
+    // mapping and ask the kernel to back it with transparent huge
+    // pages.
+    mapping = mmap(
+        nullptr, byte_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+      return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(mapping, byte_size, MADV_HUGEPAGE);
+#endif  // MADV_HUGEPAGE
+  }
+  return mapping;
+}
+
+// The maximum number of blocks of one size class held in a thread
+// cache. When exceeded, a batch of blocks is returned to the central
+// free list.
+constexpr size_t kThreadCacheMaxBlocks = 16;
+
+// The number of blocks moved between a thread cache and a central
+// free list at once.
+constexpr size_t kThreadCacheBatchBlocks = 8;
+
+uint64_t
+ClassByteSize(const size_t class_idx)
+{
+  return kMinClassByteSize << class_idx;
+}
+
+// Return the smallest size class that holds 'byte_size', or
+// kNumSizeClasses if the size is too large for any class.
+size_t
+SizeToClass(const uint64_t byte_size)
+{
+  size_t class_idx = 0;
+  while ((class_idx < kNumSizeClasses) &&
+         (ClassByteSize(class_idx) < byte_size)) {
+    class_idx++;
+  }
+  return class_idx;
+}
+
+// Central free lists shared by all threads, one mutex and list per
+// size class.
+std::mutex central_mtx[kNumSizeClasses];
+std::vector<void*> central_free_blocks[kNumSizeClasses];
+
+// Cache of free blocks owned by a single thread. Blocks are returned
+// to the central free lists when the thread exits.
+struct ThreadCache {
+  ~ThreadCache()
+  {
+    for (size_t class_idx = 0; class_idx < kNumSizeClasses; class_idx++) {
+      auto& cached = free_blocks_[class_idx];
+      if (!cached.empty()) {
+        std::lock_guard<std::mutex> lk(central_mtx[class_idx]);
+        auto& central = central_free_blocks[class_idx];
+        central.insert(central.end(), cached.begin(), cached.end());
+      }
+    }
+  }
+
+  std::vector<void*> free_blocks_[kNumSizeClasses];
+};
+
+thread_local ThreadCache thread_cache;
+
+// Number of allocations served from non-pinned system memory because
+// the pinned pool could not satisfy them, exported as a counter at
+// scrape time.
+std::atomic<uint64_t> fallback_alloc_cnt(0);
+
 }  // namespace
 
 std::unique_ptr<PinnedMemoryManager> PinnedMemoryManager::instance_;
 
 PinnedMemoryManager::PinnedMemoryManager(
-    void* pinned_memory_buffer, uint64_t size)
-    : pinned_memory_buffer_(pinned_memory_buffer)
+    void* pinned_memory_buffer, uint64_t size, bool buffer_host_registered,
+    bool huge_pages_enabled)
+    : pinned_memory_buffer_(pinned_memory_buffer),
+      pinned_memory_buffer_byte_size_(size),
+      buffer_host_registered_(buffer_host_registered),
+      huge_pages_enabled_(huge_pages_enabled)
 {
   if (pinned_memory_buffer_ != nullptr) {
     managed_pinned_memory_ = boost::interprocess::managed_external_buffer(
@@ -62,16 +205,32 @@ PinnedMemoryManager::PinnedMemoryManager(
 
 PinnedMemoryManager::~PinnedMemoryManager()
 {
+#ifdef TRTIS_ENABLE_METRICS
+  if (sampler_id_ != 0) {
+    Metrics::RemoveSampler(sampler_id_);
+  }
+#endif  // TRTIS_ENABLE_METRICS
+
   // Clean up
   for (const auto& memory_info : memory_info_) {
     const auto& is_pinned = memory_info.second;
     if (!is_pinned) {
-      free(memory_info.first);
+      BlockHeader* header = reinterpret_cast<BlockHeader*>(memory_info.first);
+      if (header->mmapped_byte_size_ > 0) {
+        munmap(memory_info.first, header->mmapped_byte_size_);
+      } else {
+        free(memory_info.first);
+      }
     }
   }
 #ifdef TRTIS_ENABLE_GPU
   if (pinned_memory_buffer_ != nullptr) {
-    cudaFreeHost(pinned_memory_buffer_);
+    if (buffer_host_registered_) {
+      cudaHostUnregister(pinned_memory_buffer_);
+      munmap(pinned_memory_buffer_, pinned_memory_buffer_byte_size_);
+    } else {
+      cudaFreeHost(pinned_memory_buffer_);
+    }
   }
 #endif  // TRTIS_ENABLE_GPU
 }
@@ -82,11 +241,54 @@ PinnedMemoryManager::AllocInternal(
     bool allow_nonpinned_fallback)
 {
   auto status = Status::Success;
+  const uint64_t total_byte_size = size + kBlockHeaderByteSize;
+  const size_t class_idx = SizeToClass(total_byte_size);
+
+  void* block = nullptr;
   if (pinned_memory_buffer_ != nullptr) {
-    std::lock_guard<std::mutex> lk(buffer_mtx_);
-    *ptr = managed_pinned_memory_.allocate(size, std::nothrow_t{});
-    *allocated_type = TRTSERVER_MEMORY_CPU_PINNED;
-    if (*ptr == nullptr) {
+    if (class_idx < kNumSizeClasses) {
+      // Common case, serve the allocation from the thread cache,
+      // refilling a batch of blocks from the central free list when
+      // the cache is empty.
+      auto& cached = thread_cache.free_blocks_[class_idx];
+      if (cached.empty()) {
+        std::lock_guard<std::mutex> lk(central_mtx[class_idx]);
+        auto& central = central_free_blocks[class_idx];
+        const size_t count =
+            std::min(central.size(), kThreadCacheBatchBlocks);
+        cached.insert(cached.end(), central.end() - count, central.end());
+        central.resize(central.size() - count);
+      }
+      if (!cached.empty()) {
+        block = cached.back();
+        cached.pop_back();
+      }
+    }
+    if (block == nullptr) {
+      const uint64_t block_byte_size = (class_idx < kNumSizeClasses)
+                                           ? ClassByteSize(class_idx)
+                                           : total_byte_size;
+      {
+        std::lock_guard<std::mutex> lk(buffer_mtx_);
+        block =
+            managed_pinned_memory_.allocate(block_byte_size, std::nothrow_t{});
+      }
+      if (block == nullptr) {
+        // The buffer may still hold enough free space split across the
+        // size-class free lists. Return those blocks so adjacent free
+        // chunks coalesce, then retry once.
+        CompactInternal();
+        std::lock_guard<std::mutex> lk(buffer_mtx_);
+        block =
+            managed_pinned_memory_.allocate(block_byte_size, std::nothrow_t{});
+      }
+      if (block != nullptr) {
+        LOG_VERBOSE(1) << "pinned memory allocation: "
+                       << "size " << size << ", addr "
+                       << (static_cast<char*>(block) + kBlockHeaderByteSize);
+      }
+    }
+    if (block == nullptr) {
       status = Status(
           Status::Code::INTERNAL, "failed to allocate pinned system memory");
     }
@@ -97,6 +299,7 @@ PinnedMemoryManager::AllocInternal(
   }
 
   bool is_pinned = true;
+  uint64_t mmapped_byte_size = 0;
   if ((!status.IsOk()) && allow_nonpinned_fallback) {
     static bool warning_logged = false;
     if (!warning_logged) {
@@ -104,42 +307,46 @@ PinnedMemoryManager::AllocInternal(
                   << ", falling back to non-pinned system memory";
       warning_logged = true;
     }
-    *ptr = malloc(size);
-    *allocated_type = TRTSERVER_MEMORY_CPU;
+    block = nullptr;
+    if (huge_pages_enabled_ && (total_byte_size >= kHugePageByteSize)) {
+      const uint64_t rounded_byte_size = RoundToHugePages(total_byte_size);
+      block = MapHugePages(rounded_byte_size);
+      if (block != nullptr) {
+        mmapped_byte_size = rounded_byte_size;
+      }
+    }
+    if (block == nullptr) {
+      block = malloc(total_byte_size);
+    }
     is_pinned = false;
-    if (*ptr == nullptr) {
+    if (block == nullptr) {
       status = Status(
           Status::Code::INTERNAL,
           "failed to allocate non-pinned system memory");
     } else {
       status = Status::Success;
+      fallback_alloc_cnt++;
+      LOG_VERBOSE(1) << "non-pinned memory allocation: "
+                     << "size " << size << ", addr "
+                     << (static_cast<char*>(block) + kBlockHeaderByteSize);
+      // Track the fallback allocation so it can be released if it is
+      // still outstanding when the manager is destructed.
+      std::lock_guard<std::mutex> lk(info_mtx_);
+      memory_info_.emplace(block, is_pinned);
     }
   }
 
-  // keep track of allocated buffer or clean up
-  {
-    std::lock_guard<std::mutex> lk(info_mtx_);
-    if (status.IsOk()) {
-      auto res = memory_info_.emplace(*ptr, is_pinned);
-      if (!res.second) {
-        status = Status(
-            Status::Code::INTERNAL, "unexpected memory address collision, '" +
-                                        PointerToString(*ptr) +
-                                        "' has been managed");
-      }
-      LOG_VERBOSE(1) << (is_pinned ? "" : "non-")
-                     << "pinned memory allocation: "
-                     << "size " << size << ", addr " << *ptr;
-    }
-  }
-
-  if ((!status.IsOk()) && (*ptr != nullptr)) {
-    if (is_pinned) {
-      std::lock_guard<std::mutex> lk(buffer_mtx_);
-      managed_pinned_memory_.deallocate(*ptr);
-    } else {
-      free(*ptr);
-    }
+  if (status.IsOk()) {
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+    header->magic_ = kBlockMagic;
+    header->size_class_ =
+        (is_pinned && (class_idx < kNumSizeClasses)) ? class_idx
+                                                     : kUnclassedBlock;
+    header->is_pinned_ = is_pinned ? 1 : 0;
+    header->mmapped_byte_size_ = mmapped_byte_size;
+    *ptr = static_cast<char*>(block) + kBlockHeaderByteSize;
+    *allocated_type =
+        is_pinned ? TRTSERVER_MEMORY_CPU_PINNED : TRTSERVER_MEMORY_CPU;
   }
 
   return status;
@@ -148,33 +355,129 @@ PinnedMemoryManager::AllocInternal(
 Status
 PinnedMemoryManager::FreeInternal(void* ptr)
 {
-  bool is_pinned = true;
-  {
-    std::lock_guard<std::mutex> lk(info_mtx_);
-    auto it = memory_info_.find(ptr);
-    if (it != memory_info_.end()) {
-      is_pinned = it->second;
-      LOG_VERBOSE(1) << (is_pinned ? "" : "non-")
-                     << "pinned memory deallocation: "
-                     << "addr " << ptr;
-      memory_info_.erase(it);
+  BlockHeader* header = reinterpret_cast<BlockHeader*>(
+      static_cast<char*>(ptr) - kBlockHeaderByteSize);
+  if (header->magic_ != kBlockMagic) {
+    return Status(
+        Status::Code::INTERNAL, "unexpected memory address '" +
+                                    PointerToString(ptr) +
+                                    "' is not being managed");
+  }
+  // Scrub the magic so a double free is detected.
+  header->magic_ = 0;
+
+  if (header->is_pinned_ == 0) {
+    LOG_VERBOSE(1) << "non-pinned memory deallocation: "
+                   << "addr " << ptr;
+    {
+      std::lock_guard<std::mutex> lk(info_mtx_);
+      memory_info_.erase(header);
+    }
+    if (header->mmapped_byte_size_ > 0) {
+      munmap(header, header->mmapped_byte_size_);
     } else {
-      return Status(
-          Status::Code::INTERNAL, "unexpected memory address '" +
-                                      PointerToString(ptr) +
-                                      "' is not being managed");
+      free(header);
     }
+    return Status::Success;
   }
 
-  if (is_pinned) {
+  if (header->size_class_ >= kNumSizeClasses) {
+    LOG_VERBOSE(1) << "pinned memory deallocation: "
+                   << "addr " << ptr;
     std::lock_guard<std::mutex> lk(buffer_mtx_);
-    managed_pinned_memory_.deallocate(ptr);
-  } else {
-    free(ptr);
+    managed_pinned_memory_.deallocate(header);
+    return Status::Success;
+  }
+
+  // Common case, keep the block in the thread cache for reuse,
+  // spilling a batch to the central free list when the cache is full.
+  auto& cached = thread_cache.free_blocks_[header->size_class_];
+  cached.push_back(header);
+  if (cached.size() > kThreadCacheMaxBlocks) {
+    std::lock_guard<std::mutex> lk(central_mtx[header->size_class_]);
+    auto& central = central_free_blocks[header->size_class_];
+    central.insert(
+        central.end(), cached.end() - kThreadCacheBatchBlocks, cached.end());
+    cached.resize(cached.size() - kThreadCacheBatchBlocks);
   }
   return Status::Success;
 }
 
+void
+PinnedMemoryManager::CompactInternal()
+{
+  // Only blocks on the central free lists are returned; blocks held
+  // in thread caches stay cached for their owning threads.
+  for (size_t class_idx = 0; class_idx < kNumSizeClasses; class_idx++) {
+    std::vector<void*> blocks;
+    {
+      std::lock_guard<std::mutex> lk(central_mtx[class_idx]);
+      blocks.swap(central_free_blocks[class_idx]);
+    }
+    if (!blocks.empty()) {
+      std::lock_guard<std::mutex> lk(buffer_mtx_);
+      for (void* block : blocks) {
+        managed_pinned_memory_.deallocate(block);
+      }
+    }
+  }
+}
+
+uint64_t
+PinnedMemoryManager::LargestFreeBlock()
+{
+  uint64_t lo = 0;
+  uint64_t hi = managed_pinned_memory_.get_free_memory();
+  while (lo < hi) {
+    const uint64_t mid = lo + (hi - lo + 1) / 2;
+    void* probe = managed_pinned_memory_.allocate(mid, std::nothrow_t{});
+    if (probe != nullptr) {
+      managed_pinned_memory_.deallocate(probe);
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+#ifdef TRTIS_ENABLE_METRICS
+void
+PinnedMemoryManager::RegisterMetrics()
+{
+  std::vector<prometheus::Gauge*> class_gauges;
+  for (size_t class_idx = 0; class_idx < kNumSizeClasses; class_idx++) {
+    class_gauges.push_back(&Metrics::FamilyPinnedPoolFreeBytes().Add(
+        {{"size_class", std::to_string(ClassByteSize(class_idx))}}));
+  }
+  auto* unclassed_gauge =
+      &Metrics::FamilyPinnedPoolFreeBytes().Add({{"size_class", "unclassed"}});
+  auto* largest_gauge = &Metrics::FamilyPinnedPoolLargestFreeBytes().Add({});
+  auto* fallback_counter = &Metrics::FamilyPinnedPoolFallbacks().Add({});
+  auto last_fallback_cnt = std::make_shared<uint64_t>(0);
+  sampler_id_ = Metrics::AddSampler([this, class_gauges, unclassed_gauge,
+                                     largest_gauge, fallback_counter,
+                                     last_fallback_cnt]() {
+    for (size_t class_idx = 0; class_idx < kNumSizeClasses; class_idx++) {
+      size_t block_cnt;
+      {
+        std::lock_guard<std::mutex> lk(central_mtx[class_idx]);
+        block_cnt = central_free_blocks[class_idx].size();
+      }
+      class_gauges[class_idx]->Set(block_cnt * ClassByteSize(class_idx));
+    }
+    if (pinned_memory_buffer_ != nullptr) {
+      std::lock_guard<std::mutex> lk(buffer_mtx_);
+      unclassed_gauge->Set(managed_pinned_memory_.get_free_memory());
+      largest_gauge->Set(LargestFreeBlock());
+    }
+    const uint64_t cnt = fallback_alloc_cnt.load();
+    fallback_counter->Increment(cnt - *last_fallback_cnt);
+    *last_fallback_cnt = cnt;
+  });
+}
+#endif  // TRTIS_ENABLE_METRICS
+
 Status
 PinnedMemoryManager::Create(const Options& options)
 {
@@ -184,21 +487,56 @@ PinnedMemoryManager::Create(const Options& options)
   }
 
   void* buffer = nullptr;
+  uint64_t buffer_byte_size = options.pinned_memory_pool_byte_size_;
+  bool buffer_host_registered = false;
 #ifdef TRTIS_ENABLE_GPU
-  auto err = cudaHostAlloc(
-      &buffer, options.pinned_memory_pool_byte_size_, cudaHostAllocPortable);
-  if (err != cudaSuccess) {
-    buffer = nullptr;
-    LOG_ERROR << "failed to allocate pinned system memory: "
-              << std::string(cudaGetErrorString(err));
-  } else {
-    LOG_VERBOSE(1) << "Pinned memory pool is created at '"
-                   << PointerToString(buffer) << "' with size "
-                   << options.pinned_memory_pool_byte_size_;
+  // When huge pages are requested, map the pool buffer with huge-page
+  // backing and pin it with cudaHostRegister instead of letting
+  // cudaHostAlloc allocate 4KB pages.
+  if (options.huge_pages_enabled_ &&
+      (buffer_byte_size >= kHugePageByteSize)) {
+    const uint64_t rounded_byte_size = RoundToHugePages(buffer_byte_size);
+    void* mapping = MapHugePages(rounded_byte_size);
+    if (mapping != nullptr) {
+      auto err = cudaHostRegister(
+          mapping, rounded_byte_size, cudaHostRegisterPortable);
+      if (err == cudaSuccess) {
+        buffer = mapping;
+        buffer_byte_size = rounded_byte_size;
+        buffer_host_registered = true;
+        LOG_VERBOSE(1) << "Pinned memory pool is created at '"
+                       << PointerToString(buffer)
+                       << "' with size " << buffer_byte_size
+                       << " using huge pages";
+      } else {
+        LOG_WARNING << "failed to register huge-page pinned memory pool: "
+                    << std::string(cudaGetErrorString(err))
+                    << ", falling back to 4KB pages";
+        munmap(mapping, rounded_byte_size);
+      }
+    }
+  }
+
+  if (buffer == nullptr) {
+    buffer_byte_size = options.pinned_memory_pool_byte_size_;
+    auto err = cudaHostAlloc(&buffer, buffer_byte_size, cudaHostAllocPortable);
+    if (err != cudaSuccess) {
+      buffer = nullptr;
+      LOG_ERROR << "failed to allocate pinned system memory: "
+                << std::string(cudaGetErrorString(err));
+    } else {
+      LOG_VERBOSE(1) << "Pinned memory pool is created at '"
+                     << PointerToString(buffer) << "' with size "
+                     << buffer_byte_size;
+    }
   }
 #endif  // TRTIS_ENABLE_GPU
-  instance_.reset(
-      new PinnedMemoryManager(buffer, options.pinned_memory_pool_byte_size_));
+  instance_.reset(new PinnedMemoryManager(
+      buffer, buffer_byte_size, buffer_host_registered,
+      options.huge_pages_enabled_));
+#ifdef TRTIS_ENABLE_METRICS
+  instance_->RegisterMetrics();
+#endif  // TRTIS_ENABLE_METRICS
   return Status::Success;
 }
 
@@ -227,4 +565,12 @@ PinnedMemoryManager::Free(void* ptr)
   return instance_->FreeInternal(ptr);
 }
 
+void
+PinnedMemoryManager::Compact()
+{
+  if (instance_ != nullptr) {
+    instance_->CompactInternal();
+  }
+}
+
 }}  // namespace nvidia::inferenceserver
\ No newline at end of file
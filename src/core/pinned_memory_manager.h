@@ -27,6 +27,7 @@
 #pragma once
 
 #include <boost/interprocess/managed_external_buffer.hpp>
+#include <map>
 #include <memory>
 #include <mutex>
 #include "src/core/status.h"
@@ -40,9 +41,19 @@ class PinnedMemoryManager {
  public:
   // Options to configure pinned memeory manager.
   struct Options {
-    Options(uint64_t b = 0) : pinned_memory_pool_byte_size_(b) {}
+    Options(uint64_t b = 0, bool huge_pages = false)
+        : pinned_memory_pool_byte_size_(b), huge_pages_enabled_(huge_pages)
+    {
+    }
 
     uint64_t pinned_memory_pool_byte_size_;
+
+    // Back the pool, and large non-pinned fallback allocations, with
+    // 2MB huge pages so the gather/copy paths over large batches
+    // don't thrash the TLB. Explicit MAP_HUGETLB pages are used when
+    // available, with transparent-huge-page advice as fallback; if
+    // neither can be obtained the pool is allocated normally.
+    bool huge_pages_enabled_;
   };
 
   ~PinnedMemoryManager();
@@ -64,23 +75,61 @@ class PinnedMemoryManager {
   // Return Status object indicating success or failure.
   static Status Free(void* ptr);
 
+  // Return free size-class blocks to the managed buffer so that
+  // adjacent free chunks coalesce back into larger contiguous
+  // regions. Run automatically when an allocation fails due to
+  // fragmentation; may also be called explicitly at idle time.
+  static void Compact();
+
  protected:
-  PinnedMemoryManager(void* pinned_memory_buffer, uint64_t size);
+  PinnedMemoryManager(
+      void* pinned_memory_buffer, uint64_t size, bool buffer_host_registered,
+      bool huge_pages_enabled);
 
   Status AllocInternal(
       void** ptr, uint64_t size, TRTSERVER_Memory_Type* allocated_type,
       bool allow_nonpinned_fallback = false);
   Status FreeInternal(void* ptr);
+  void CompactInternal();
+
+  // Largest contiguous block currently obtainable from the managed
+  // buffer, found by probing with binary search. Caller must hold
+  // 'buffer_mtx_'.
+  uint64_t LargestFreeBlock();
+
+#ifdef TRTIS_ENABLE_METRICS
+  // Register the pool fragmentation gauges and fallback counter, and
+  // the scrape-time sampler that refreshes them.
+  void RegisterMetrics();
+#endif  // TRTIS_ENABLE_METRICS
 
  private:
   static std::unique_ptr<PinnedMemoryManager> instance_;
 
+  // Tracks outstanding non-pinned fallback allocations so they can be
+  // released when the manager is destructed. Pinned allocations are
+  // self-describing via their block header, see
+  // pinned_memory_manager.cc.
   std::mutex info_mtx_;
   std::map<void*, bool> memory_info_;
 
   void* pinned_memory_buffer_;
+  uint64_t pinned_memory_buffer_byte_size_;
+
+  // True if the pool buffer is a mapping pinned with cudaHostRegister
+  // (the huge-page path) rather than a cudaHostAlloc allocation.
+  bool buffer_host_registered_;
+
+  // True if large non-pinned fallback allocations should also be
+  // backed by huge pages.
+  bool huge_pages_enabled_;
+
   std::mutex buffer_mtx_;
   boost::interprocess::managed_external_buffer managed_pinned_memory_;
+
+#ifdef TRTIS_ENABLE_METRICS
+  uint64_t sampler_id_ = 0;
+#endif  // TRTIS_ENABLE_METRICS
 };
 
 }}  // namespace nvidia::inferenceserver
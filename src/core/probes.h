@@ -0,0 +1,68 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#ifdef TRTIS_ENABLE_USDT
+#include <sys/sdt.h>
+#endif  // TRTIS_ENABLE_USDT
+
+//
+// Macros for USDT (user statically-defined tracing) probes on the
+// request hot path. The probes use provider name "trtis" and can be
+// attached with bpftrace or similar tools without rebuilding the
+// server, for example:
+//
+//   bpftrace -e 'usdt:./tritonserver:trtis:backend_run_start { ... }'
+//
+// The probes are compiled to no-ops unless the server is built with
+// -DTRTIS_ENABLE_USDT=ON, and have negligible overhead (a nop
+// instruction per probe) when built in but not attached. Probe
+// arguments must be cheap to evaluate since they are evaluated even
+// when the probe is not attached.
+//
+// The probe points currently defined are:
+//
+//   request_arrival(model name, batch size)
+//   queue_enqueue(model name, batch size)
+//   queue_dequeue(model name, batch size)
+//   batch_dispatch(runner id, payload count)
+//   backend_run_start(model name, payload count)
+//   backend_run_end(model name, payload count)
+//   input_copy_start(input name) / input_copy_end(input name)
+//   output_copy_start(output name) / output_copy_end(output name)
+//   response_finalize(model name)
+//
+#ifdef TRTIS_ENABLE_USDT
+#define TRTIS_PROBE(name) DTRACE_PROBE(trtis, name)
+#define TRTIS_PROBE1(name, a1) DTRACE_PROBE1(trtis, name, a1)
+#define TRTIS_PROBE2(name, a1, a2) DTRACE_PROBE2(trtis, name, a1, a2)
+#define TRTIS_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(trtis, name, a1, a2, a3)
+#else
+#define TRTIS_PROBE(name)
+#define TRTIS_PROBE1(name, a1)
+#define TRTIS_PROBE2(name, a1, a2)
+#define TRTIS_PROBE3(name, a1, a2, a3)
+#endif  // TRTIS_ENABLE_USDT
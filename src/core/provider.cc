@@ -26,7 +26,10 @@
 
 #include "src/core/provider.h"
 
+#include <algorithm>
 #include <deque>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include "src/core/backend.h"
 #include "src/core/constants.h"
@@ -56,51 +59,90 @@ AddClassResults(
   T* probs = reinterpret_cast<T*>(poutput_buffer);
   const size_t entry_cnt = batch1_element_count;
   const size_t class_cnt = std::min(cls_count, entry_cnt);
-  std::vector<size_t> idx(entry_cnt);
+
+  // Hoist the per-output lookups out of the per-class loops; for large
+  // probability vectors they otherwise dominate the formatting cost.
+  static const std::string not_found;
+  const std::vector<std::string>* labels =
+      label_provider->GetLabels(poutput->name());
+  const std::vector<std::string>* label_suffixes =
+      label_provider->GetLabelSuffixes(poutput->name());
+  const InferResponseProvider::SecondaryLabelProvider* secondary_provider =
+      nullptr;
+  if (!lookup_map.empty()) {
+    auto it = lookup_map.find(poutput->name());
+    if (it != lookup_map.end()) {
+      secondary_provider = &it->second;
+    }
+  }
+
+  // Top entries for one batch item as (probability, entry index),
+  // maintained as a min-heap on probability while scanning.
+  std::vector<std::pair<T, size_t>> top_entries;
+  top_entries.reserve(class_cnt + 1);
+  auto heap_cmp = [](
+      const std::pair<T, size_t>& lhs, const std::pair<T, size_t>& rhs) {
+    return lhs.first > rhs.first;
+  };
 
   std::vector<std::string> raw_cls_contents;
   size_t total_raw_size = 0;
   for (size_t i = 0; i < batch_size; ++i) {
-    iota(idx.begin(), idx.end(), 0);
-    sort(idx.begin(), idx.end(), [&probs](size_t i1, size_t i2) {
-      return probs[i1] > probs[i2];
-    });
+    // Partial top-K selection. Most entries fail the heap-top test
+    // with a single compare so the full sort of the probability
+    // vector is avoided.
+    top_entries.clear();
+    for (size_t j = 0; j < entry_cnt; ++j) {
+      if ((top_entries.size() == class_cnt) &&
+          !(probs[j] > top_entries.front().first)) {
+        continue;
+      }
+
+      top_entries.emplace_back(probs[j], j);
+      std::push_heap(top_entries.begin(), top_entries.end(), heap_cmp);
+      if (top_entries.size() > class_cnt) {
+        std::pop_heap(top_entries.begin(), top_entries.end(), heap_cmp);
+        top_entries.pop_back();
+      }
+    }
+    std::sort_heap(top_entries.begin(), top_entries.end(), heap_cmp);
 
     if (protocol_version == 1) {
       auto bcls = poutput->add_batch_classes();
       for (size_t k = 0; k < class_cnt; ++k) {
+        const size_t entry_idx = top_entries[k].second;
         auto cls = bcls->add_cls();
-        cls->set_idx(idx[k]);
-        const auto& label = label_provider->GetLabel(poutput->name(), idx[k]);
+        cls->set_idx(entry_idx);
+        const auto& label =
+            ((labels != nullptr) && (entry_idx < labels->size()))
+                ? (*labels)[entry_idx]
+                : not_found;
         cls->set_label(label);
 
-        if (label == "" && !lookup_map.empty()) {
-          auto it = lookup_map.find(poutput->name());
-          if (it != lookup_map.end()) {
-            cls->set_label(
-                it->second.second->GetLabel(it->second.first, idx[k]));
-          }
+        if (label.empty() && (secondary_provider != nullptr)) {
+          cls->set_label(secondary_provider->second->GetLabel(
+              secondary_provider->first, entry_idx));
         }
 
-        cls->set_value(static_cast<float>(probs[idx[k]]));
+        cls->set_value(static_cast<float>(top_entries[k].first));
       }
     } else {
       for (size_t k = 0; k < class_cnt; ++k) {
+        const size_t entry_idx = top_entries[k].second;
         std::string cls_content =
-            std::to_string(idx[k]) + ":" +
-            std::to_string(static_cast<float>(probs[idx[k]]));
-
-        const auto& label = label_provider->GetLabel(poutput->name(), idx[k]);
-        if (!label.empty()) {
+            std::to_string(entry_idx) + ":" +
+            std::to_string(static_cast<float>(top_entries[k].first));
+
+        // The preformatted ":<label>" suffix makes appending the
+        // label a single copy.
+        if ((label_suffixes != nullptr) &&
+            (entry_idx < label_suffixes->size()) &&
+            !(*label_suffixes)[entry_idx].empty()) {
+          cls_content += (*label_suffixes)[entry_idx];
+        } else if (secondary_provider != nullptr) {
           cls_content += ":";
-          cls_content += label;
-        } else if (!lookup_map.empty()) {
-          auto it = lookup_map.find(poutput->name());
-          if (it != lookup_map.end()) {
-            cls_content += ":";
-            cls_content +=
-                it->second.second->GetLabel(it->second.first, idx[k]);
-          }
+          cls_content += secondary_provider->second->GetLabel(
+              secondary_provider->first, entry_idx);
         }
 
         total_raw_size += cls_content.size();
@@ -126,6 +168,60 @@ AddClassResults(
   }
 }
 
+// Recycles the buffers that the provider allocates itself for non-RAW
+// (classification) results so steady-state serving doesn't allocate a
+// fresh buffer per response. Buffers obtained through the response
+// allocator are owned by the frontend and are not pooled here. Buffers
+// are grouped into power-of-two size classes and the pool is capped so
+// a burst of large results doesn't hold memory forever.
+class OutputBufferPool {
+ public:
+  OutputBufferPool() : pooled_byte_size_(0) {}
+
+  // Get a buffer of at least 'byte_size' bytes. 'actual_byte_size'
+  // returns the buffer's capacity, which must be passed to Release().
+  std::unique_ptr<char[]> Get(const size_t byte_size, size_t* actual_byte_size)
+  {
+    size_t class_byte_size = 64;
+    while (class_byte_size < byte_size) {
+      class_byte_size <<= 1;
+    }
+    *actual_byte_size = class_byte_size;
+
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      auto it = free_buffers_.find(class_byte_size);
+      if ((it != free_buffers_.end()) && !it->second.empty()) {
+        std::unique_ptr<char[]> buffer = std::move(it->second.back());
+        it->second.pop_back();
+        pooled_byte_size_ -= class_byte_size;
+        return buffer;
+      }
+    }
+
+    return std::unique_ptr<char[]>(new char[class_byte_size]);
+  }
+
+  // Return a buffer obtained from Get() to the pool.
+  void Release(std::unique_ptr<char[]>&& buffer, const size_t byte_size)
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if ((pooled_byte_size_ + byte_size) <= kMaxPooledByteSize) {
+      free_buffers_[byte_size].emplace_back(std::move(buffer));
+      pooled_byte_size_ += byte_size;
+    }
+  }
+
+ private:
+  static constexpr size_t kMaxPooledByteSize = 1 << 26;
+
+  std::mutex mtx_;
+  size_t pooled_byte_size_;
+  std::map<size_t, std::vector<std::unique_ptr<char[]>>> free_buffers_;
+};
+
+OutputBufferPool output_buffer_pool;
+
 }  // namespace
 
 //
@@ -174,7 +270,15 @@ InferResponseProvider::InferResponseProvider(
 bool
 InferResponseProvider::RequiresOutput(const std::string& name)
 {
-  return output_map_.find(name) != output_map_.end();
+  return (output_map_.find(name) != output_map_.end()) ||
+         (internal_outputs_.find(name) != internal_outputs_.end());
+}
+
+void
+InferResponseProvider::AddInternalOutputBuffer(
+    const std::string& name, const std::shared_ptr<MutableMemory>& buffer)
+{
+  internal_outputs_[name] = buffer;
 }
 
 Status
@@ -260,6 +364,28 @@ InferResponseProvider::SetSecondaryLabelProvider(
   secondary_label_provider_map_[name] = provider;
 }
 
+void
+InferResponseProvider::OutputReady(const std::string& name)
+{
+  if (output_ready_fn_ == nullptr) {
+    return;
+  }
+
+  for (const auto& output : outputs_) {
+    if (name == output.name_) {
+      // Only raw outputs resident in system memory can be consumed
+      // incrementally. Classification outputs are materialized during
+      // response finalization and GPU-resident contents are not
+      // addressable by the frontend.
+      if ((output.cls_count_ == 0) &&
+          (output.memory_type_ != TRTSERVER_MEMORY_GPU)) {
+        output_ready_fn_(name, output.ptr_, output.byte_size_);
+      }
+      return;
+    }
+  }
+}
+
 Status
 InferResponseProvider::FinalizeResponse(const InferenceBackend& is)
 {
@@ -274,27 +400,25 @@ InferResponseProvider::FinalizeResponse(const InferenceBackend& is)
 
   int output_idx = 0;
   for (auto& output : outputs_) {
-    const ModelOutput* output_config;
-    RETURN_IF_ERROR(is.GetOutput(output.name_, &output_config));
+    const InferenceBackend::OutputPlan* output_plan;
+    RETURN_IF_ERROR(is.GetOutputPlan(output.name_, &output_plan));
 
     // Verify that the actual output shape matches what is expected by
     // the model configuration. If there is an output reshape, we've
     // already verified that reshape and dims have same element count
     // so don't need to do that here.
-    bool skip_batch = (is.Config().max_batch_size() != 0);
-    DimsList batch1_backend_shape;
+    bool skip_batch = is.SupportsBatching();
+    std::vector<int64_t> batch1_backend_shape;
     size_t batch1_element_count = 1;
     for (auto d : output.shape_) {
       if (!skip_batch) {
-        batch1_backend_shape.Add(d);
+        batch1_backend_shape.push_back(d);
         batch1_element_count *= (size_t)d;
       }
       skip_batch = false;
     }
 
-    const DimsList& expected_shape = (output_config->has_reshape())
-                                         ? output_config->reshape().shape()
-                                         : output_config->dims();
+    const std::vector<int64_t>& expected_shape = output_plan->expected_shape_;
     if (!CompareDimsWithWildcard(expected_shape, batch1_backend_shape)) {
       return Status(
           Status::Code::INVALID_ARG,
@@ -309,7 +433,7 @@ InferResponseProvider::FinalizeResponse(const InferenceBackend& is)
 
     if (irequest_->ProtocolVersion() == 2) {
       if (output.cls_count_ == 0) {
-        poutput->set_data_type(output_config->data_type());
+        poutput->set_data_type(output_plan->data_type_);
       } else {
         poutput->set_data_type(DataType::TYPE_STRING);
       }
@@ -321,8 +445,7 @@ InferResponseProvider::FinalizeResponse(const InferenceBackend& is)
       poutput->mutable_raw()->set_batch_byte_size(output.byte_size_);
 
       // FIXMEV2 include batch dimension in V2 shape.
-      if ((irequest_->ProtocolVersion() == 2) &&
-          (is.Config().max_batch_size() != 0)) {
+      if ((irequest_->ProtocolVersion() == 2) && is.SupportsBatching()) {
         poutput->mutable_raw()->add_dims(batch_size);
       }
 
@@ -330,16 +453,13 @@ InferResponseProvider::FinalizeResponse(const InferenceBackend& is)
       // variable-size dimensions so that we can set the output shape correctly.
       // If there is not a reshape then use output shape as that will have
       // actual sized in place of any wildcard dimensions.
-      if (output_config->has_reshape()) {
+      if (output_plan->has_reshape_) {
         std::deque<int64_t> variable_size_values;
-        for (int64_t idx = 0; idx < output_config->reshape().shape_size();
-             idx++) {
-          if (output_config->reshape().shape(idx) == -1) {
-            variable_size_values.push_back(batch1_backend_shape[idx]);
-          }
+        for (const auto idx : output_plan->variable_dim_index_) {
+          variable_size_values.push_back(batch1_backend_shape[idx]);
         }
 
-        for (const auto& dim : output_config->dims()) {
+        for (const auto& dim : output_plan->dims_) {
           if (dim == -1) {
             poutput->mutable_raw()->add_dims(variable_size_values.front());
             variable_size_values.pop_front();
@@ -348,7 +468,9 @@ InferResponseProvider::FinalizeResponse(const InferenceBackend& is)
           }
         }
       } else {
-        poutput->mutable_raw()->mutable_dims()->MergeFrom(batch1_backend_shape);
+        for (const auto d : batch1_backend_shape) {
+          poutput->mutable_raw()->add_dims(d);
+        }
       }
 
       if (irequest_->ProtocolVersion() == 2) {
@@ -367,7 +489,7 @@ InferResponseProvider::FinalizeResponse(const InferenceBackend& is)
       }
 
       // Class result...
-      switch (output_config->data_type()) {
+      switch (output_plan->data_type_) {
         case DataType::TYPE_UINT8:
           AddClassResults<uint8_t>(
               poutput, &output.cls_contents_, output.buffer_.get(),
@@ -446,7 +568,7 @@ InferResponseProvider::FinalizeResponse(const InferenceBackend& is)
               Status::Code::INVALID_ARG,
               "class result not available for output '" + output.name_ +
                   "' due to unsupported type '" +
-                  DataType_Name(output_config->data_type()) + "'");
+                  DataType_Name(output_plan->data_type_) + "'");
       }
     }
 
@@ -494,32 +616,164 @@ InferResponseProvider::Create(
 
 InferResponseProvider::~InferResponseProvider()
 {
-  for (const auto& output : outputs_) {
+  for (auto& output : outputs_) {
+    // The response has been sent at this point so provider-allocated
+    // buffers can be recycled for later responses.
+    if (output.buffer_ != nullptr) {
+      output_buffer_pool.Release(
+          std::move(output.buffer_), output.buffer_byte_size_);
+    }
+
     if (output.release_buffer_ != nullptr) {
-      if (!using_triton_) {
-        auto err = release_fn_(
-            allocator_, output.release_buffer_, output.release_userp_,
-            output.byte_size_, output.memory_type_, output.memory_type_id_);
-        if (err != nullptr) {
-          LOG_ERROR << "failed to release result tensor '" << output.name_
-                    << "': " << TRTSERVER_ErrorMessage(err);
-          TRTSERVER_ErrorDelete(err);
-        }
-      } else {
-        auto err = triton_release_fn_(
-            triton_allocator_, output.release_buffer_, output.release_userp_,
-            output.byte_size_, TrtMemTypeToTriton(output.memory_type_),
-            output.memory_type_id_);
-        if (err != nullptr) {
-          LOG_ERROR << "failed to release result tensor '" << output.name_
-                    << "': " << TRITONSERVER_ErrorMessage(err);
-          TRITONSERVER_ErrorDelete(err);
-        }
-      }
+      CallReleaseFn(
+          output.name_, output.release_buffer_, output.release_userp_,
+          output.byte_size_, output.memory_type_, output.memory_type_id_);
+    }
+  }
+
+  // Release any reserved buffers that were never consumed by an
+  // AllocateOutputBuffer() call, for example when the inference
+  // fails.
+  for (const auto& pr : preallocated_) {
+    const PreallocatedOutput& pre = pr.second;
+    CallReleaseFn(
+        pr.first, pre.buffer_, pre.buffer_userp_, pre.byte_size_,
+        pre.memory_type_, pre.memory_type_id_);
+  }
+}
+
+Status
+InferResponseProvider::CallAllocFn(
+    const std::string& name, const size_t byte_size,
+    const TRTSERVER_Memory_Type preferred_memory_type,
+    const int64_t preferred_memory_type_id, void** buffer, void** buffer_userp,
+    TRTSERVER_Memory_Type* actual_memory_type, int64_t* actual_memory_type_id)
+{
+  if (!using_triton_) {
+    auto err = alloc_fn_(
+        allocator_, name.c_str(), byte_size, preferred_memory_type,
+        preferred_memory_type_id, alloc_userp_, buffer, buffer_userp,
+        actual_memory_type, actual_memory_type_id);
+    if (err != nullptr) {
+      Status status = Status(
+          TrtServerCodeToStatusCode(TRTSERVER_ErrorCode(err)),
+          TRTSERVER_ErrorMessage(err));
+      TRTSERVER_ErrorDelete(err);
+      return status;
+    }
+  } else {
+    TRITONSERVER_Memory_Type triton_actual_memory_type;
+    auto err = triton_alloc_fn_(
+        triton_allocator_, name.c_str(), byte_size,
+        TrtMemTypeToTriton(preferred_memory_type), preferred_memory_type_id,
+        alloc_userp_, buffer, buffer_userp, &triton_actual_memory_type,
+        actual_memory_type_id);
+    *actual_memory_type = TritonMemTypeToTrt(triton_actual_memory_type);
+    if (err != nullptr) {
+      Status status = Status(
+          TritonServerCodeToStatusCode(TRITONSERVER_ErrorCode(err)),
+          TRITONSERVER_ErrorMessage(err));
+      TRITONSERVER_ErrorDelete(err);
+      return status;
+    }
+  }
+
+  return Status::Success;
+}
+
+void
+InferResponseProvider::CallReleaseFn(
+    const std::string& name, void* buffer, void* buffer_userp,
+    const size_t byte_size, const TRTSERVER_Memory_Type memory_type,
+    const int64_t memory_type_id)
+{
+  if (!using_triton_) {
+    auto err = release_fn_(
+        allocator_, buffer, buffer_userp, byte_size, memory_type,
+        memory_type_id);
+    if (err != nullptr) {
+      LOG_ERROR << "failed to release result tensor '" << name
+                << "': " << TRTSERVER_ErrorMessage(err);
+      TRTSERVER_ErrorDelete(err);
+    }
+  } else {
+    auto err = triton_release_fn_(
+        triton_allocator_, buffer, buffer_userp, byte_size,
+        TrtMemTypeToTriton(memory_type), memory_type_id);
+    if (err != nullptr) {
+      LOG_ERROR << "failed to release result tensor '" << name
+                << "': " << TRITONSERVER_ErrorMessage(err);
+      TRITONSERVER_ErrorDelete(err);
     }
   }
 }
 
+Status
+InferResponseProvider::PreallocateOutputBuffers(const InferenceBackend& is)
+{
+  // The V1 protocols assemble the response body in the order the
+  // allocator is invoked, so reserving buffers ahead of the backend's
+  // allocation calls would reorder the outputs. The V2 protocols
+  // match outputs by name.
+  if (protocol_version_ != 2) {
+    return Status::Success;
+  }
+
+  const int batch_size =
+      is.SupportsBatching() ? irequest_->BatchSize() : 0;
+
+  for (const auto& pr : output_map_) {
+    // Classification results are formatted into a provider-owned
+    // buffer so there is nothing to reserve from the allocator.
+    if (pr.second.ClassificationCount() > 0) {
+      continue;
+    }
+
+    const InferenceBackend::OutputPlan* output_plan;
+    if (!is.GetOutputPlan(pr.first, &output_plan).IsOk()) {
+      continue;
+    }
+    if (output_plan->has_reshape_) {
+      continue;
+    }
+
+    // The exact size is only known up front for a fixed-shape output
+    // of a fixed-size datatype.
+    const int64_t byte_size =
+        GetByteSize(batch_size, output_plan->data_type_, output_plan->dims_);
+    if (byte_size <= 0) {
+      continue;
+    }
+
+    void* buffer = nullptr;
+    void* buffer_userp = nullptr;
+    TRTSERVER_Memory_Type actual_memory_type;
+    int64_t actual_memory_type_id;
+    RETURN_IF_ERROR(CallAllocFn(
+        pr.first, byte_size, TRTSERVER_MEMORY_CPU, 0 /* memory_type_id */,
+        &buffer, &buffer_userp, &actual_memory_type, &actual_memory_type_id));
+
+    // The allocator is free to decline the reservation, in which case
+    // the output is allocated as usual when inference completes.
+    if (buffer == nullptr) {
+      continue;
+    }
+
+    LOG_VERBOSE(1) << "preallocated " << byte_size << " byte response buffer "
+                   << "for output '" << pr.first << "'";
+
+    PreallocatedOutput pre;
+    pre.buffer_ = buffer;
+    pre.buffer_userp_ = buffer_userp;
+    pre.byte_size_ = byte_size;
+    pre.memory_type_ = actual_memory_type;
+    pre.memory_type_id_ = actual_memory_type_id;
+    preallocated_.emplace(pr.first, pre);
+  }
+
+  return Status::Success;
+}
+
 const InferResponseHeader&
 InferResponseProvider::ResponseHeader() const
 {
@@ -532,6 +786,52 @@ InferResponseProvider::MutableResponseHeader()
   return &response_header_;
 }
 
+bool
+InferResponseProvider::DonateOutputBuffer(
+    const std::string& name, const std::vector<int64_t>& content_shape,
+    const std::shared_ptr<Memory>& memory)
+{
+  if (buffer_donation_fn_ == nullptr) {
+    return false;
+  }
+
+  const auto& pr = output_map_.find(name);
+  if ((pr == output_map_.end()) || (pr->second.ClassificationCount() > 0)) {
+    return false;
+  }
+
+  // The contents must be a single contiguous buffer since the
+  // consumer receives one (address, byte-size) pair.
+  size_t content_byte_size;
+  TRTSERVER_Memory_Type memory_type;
+  int64_t memory_type_id;
+  const char* content =
+      memory->BufferAt(0, &content_byte_size, &memory_type, &memory_type_id);
+  if ((content == nullptr) || (content_byte_size != memory->TotalByteSize())) {
+    return false;
+  }
+
+  if (!buffer_donation_fn_(name, memory)) {
+    return false;
+  }
+
+  outputs_.emplace_back();
+  Output* loutput = &(outputs_.back());
+  loutput->name_ = name;
+  loutput->shape_ = content_shape;
+  loutput->cls_count_ = 0;
+  loutput->ptr_ = const_cast<char*>(content);
+  loutput->byte_size_ = content_byte_size;
+  loutput->buffer_byte_size_ = 0;
+  loutput->memory_type_ = memory_type;
+  loutput->memory_type_id_ = memory_type_id;
+  loutput->release_buffer_ = nullptr;
+  loutput->release_userp_ = nullptr;
+  loutput->donated_memory_ = memory;
+
+  return true;
+}
+
 Status
 InferResponseProvider::AllocateOutputBuffer(
     const std::string& name, void** content, size_t content_byte_size,
@@ -542,6 +842,23 @@ InferResponseProvider::AllocateOutputBuffer(
 {
   *content = nullptr;
 
+  // An internal output is collected into its registered buffer and
+  // never becomes part of the client-visible response.
+  const auto int_itr = internal_outputs_.find(name);
+  if (int_itr != internal_outputs_.end()) {
+    if (int_itr->second->TotalByteSize() != content_byte_size) {
+      return Status(
+          Status::Code::INTERNAL,
+          "unexpected byte size " + std::to_string(content_byte_size) +
+              " for internal output '" + name + "', expecting " +
+              std::to_string(int_itr->second->TotalByteSize()));
+    }
+
+    *content = int_itr->second->MutableBuffer(
+        actual_memory_type, actual_memory_type_id);
+    return Status::Success;
+  }
+
   const auto& pr = output_map_.find(name);
   if (pr == output_map_.end()) {
     return Status(Status::Code::INTERNAL, "unexpected output '" + name + "'");
@@ -554,6 +871,7 @@ InferResponseProvider::AllocateOutputBuffer(
   loutput->cls_count_ = 0;
   loutput->ptr_ = nullptr;
   loutput->byte_size_ = content_byte_size;
+  loutput->buffer_byte_size_ = 0;
 
   // For class result, the provider will be responsible for allocating
   // the requested memory. The user-provided allocator should only be invoked
@@ -563,6 +881,36 @@ InferResponseProvider::AllocateOutputBuffer(
   // return success and nullptr to align with the behavior of
   // 'TRTSERVER_ResponseAllocatorAllocFn_t'
   const bool is_class = (pr->second.ClassificationCount() > 0);
+
+  // If a buffer was reserved for this output by
+  // PreallocateOutputBuffers() then consume it instead of invoking
+  // the allocator again, as long as the actual size matches the
+  // reserved size.
+  if (!is_class) {
+    auto pre_itr = preallocated_.find(name);
+    if (pre_itr != preallocated_.end()) {
+      const PreallocatedOutput pre = pre_itr->second;
+      preallocated_.erase(pre_itr);
+      if (pre.byte_size_ == content_byte_size) {
+        *content = pre.buffer_;
+        loutput->ptr_ = pre.buffer_;
+        loutput->memory_type_ = pre.memory_type_;
+        loutput->memory_type_id_ = pre.memory_type_id_;
+        loutput->release_buffer_ = pre.buffer_;
+        loutput->release_userp_ = pre.buffer_userp_;
+        *actual_memory_type = pre.memory_type_;
+        *actual_memory_type_id = pre.memory_type_id_;
+        return Status::Success;
+      }
+
+      // The reserved size doesn't match the actual output size so
+      // the buffer can't be used. Release it and allocate as usual.
+      CallReleaseFn(
+          name, pre.buffer_, pre.buffer_userp_, pre.byte_size_,
+          pre.memory_type_, pre.memory_type_id_);
+    }
+  }
+
   if (is_class) {
     // For class result no additional buffer is needed.
     if (content_byte_size == 0) {
@@ -573,10 +921,10 @@ InferResponseProvider::AllocateOutputBuffer(
     }
 
     loutput->cls_count_ = pr->second.ClassificationCount();
-    char* buffer = new char[content_byte_size];
-    *content = static_cast<void*>(buffer);
-    loutput->ptr_ = static_cast<void*>(buffer);
-    loutput->buffer_.reset(buffer);
+    loutput->buffer_ =
+        output_buffer_pool.Get(content_byte_size, &loutput->buffer_byte_size_);
+    *content = static_cast<void*>(loutput->buffer_.get());
+    loutput->ptr_ = static_cast<void*>(loutput->buffer_.get());
   }
 
   // If a buffer has been allocated for cls result, then no
@@ -588,33 +936,10 @@ InferResponseProvider::AllocateOutputBuffer(
   void* buffer_userp = nullptr;
   TRTSERVER_Memory_Type raw_actual_memory_type;
   int64_t raw_actual_memory_type_id;
-  Status status;
-  if (!using_triton_) {
-    auto err = alloc_fn_(
-        allocator_, name.c_str(), alloc_byte_size, preferred_memory_type,
-        preferred_memory_type_id, alloc_userp_, &buffer, &buffer_userp,
-        &raw_actual_memory_type, &raw_actual_memory_type_id);
-    if (err != nullptr) {
-      status = Status(
-          TrtServerCodeToStatusCode(TRTSERVER_ErrorCode(err)),
-          TRTSERVER_ErrorMessage(err));
-      TRTSERVER_ErrorDelete(err);
-    }
-  } else {
-    TRITONSERVER_Memory_Type triton_actual_memory_type;
-    auto err = triton_alloc_fn_(
-        triton_allocator_, name.c_str(), alloc_byte_size,
-        TrtMemTypeToTriton(preferred_memory_type), preferred_memory_type_id,
-        alloc_userp_, &buffer, &buffer_userp, &triton_actual_memory_type,
-        &raw_actual_memory_type_id);
-    raw_actual_memory_type = TritonMemTypeToTrt(triton_actual_memory_type);
-    if (err != nullptr) {
-      status = Status(
-          TritonServerCodeToStatusCode(TRITONSERVER_ErrorCode(err)),
-          TRITONSERVER_ErrorMessage(err));
-      TRITONSERVER_ErrorDelete(err);
-    }
-  }
+  Status status = CallAllocFn(
+      name, alloc_byte_size, preferred_memory_type, preferred_memory_type_id,
+      &buffer, &buffer_userp, &raw_actual_memory_type,
+      &raw_actual_memory_type_id);
   if (!is_class) {
     *content = buffer;
     loutput->ptr_ = buffer;
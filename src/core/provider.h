@@ -83,6 +83,18 @@ class InferResponseProvider {
   // Return true if this provider requires a named output.
   bool RequiresOutput(const std::string& name);
 
+  // Reserve buffers ahead of inference for requested outputs whose
+  // exact byte size is already known: fixed-shape outputs of a
+  // fixed-size datatype, computed from the model configuration and
+  // the request batch size. The reserved buffer is consumed by the
+  // matching AllocateOutputBuffer() call so the frontend prepares
+  // response buffers while the inference runs instead of after it
+  // completes. Outputs whose size cannot be determined up front are
+  // skipped and allocated as usual. Only applies to protocol V2
+  // requests since the V1 protocols assemble the response in
+  // allocation order.
+  Status PreallocateOutputBuffers(const InferenceBackend& is);
+
   // Get a buffer to store results for a named output. Must be called
   // exactly once for each output that is being returned for the
   // request. The output must be listed in the request header.
@@ -94,6 +106,41 @@ class InferResponseProvider {
       TRTSERVER_Memory_Type* actual_memory_type,
       int64_t* actual_memory_type_id);
 
+  // Callback invoked when a producer offers the provider ownership of
+  // an already-populated memory block as the complete contents of an
+  // output, instead of copying into a freshly allocated buffer.
+  // Receives the output name and the memory block, and returns true
+  // if the consumer accepted the block.
+  using BufferDonationFn =
+      std::function<bool(const std::string&, const std::shared_ptr<Memory>&)>;
+
+  // Set a callback that accepts donated output buffers. Only
+  // consumers that read responses through shared memory blocks (such
+  // as an enclosing ensemble) can accept donations; frontends that
+  // allocate the response destination themselves leave this unset.
+  void SetBufferDonationFn(BufferDonationFn fn)
+  {
+    buffer_donation_fn_ = std::move(fn);
+  }
+
+  // Hand an already-populated memory block to the response consumer
+  // as the complete contents of output 'name', avoiding the
+  // allocate-and-copy path. Requires a consumer that registered a
+  // donation callback, a contiguous block, and a raw
+  // (non-classification) output; the block must not be written after
+  // donation. Return true if the buffer was accepted, false if the
+  // caller must fall back to AllocateOutputBuffer() and copy.
+  bool DonateOutputBuffer(
+      const std::string& name, const std::vector<int64_t>& content_shape,
+      const std::shared_ptr<Memory>& memory);
+
+  // Register 'buffer' to receive the complete contents of output
+  // 'name'. The output is produced by the model but is not part of
+  // the client-visible response; used by the sequence batcher to
+  // collect explicit sequence-state outputs.
+  void AddInternalOutputBuffer(
+      const std::string& name, const std::shared_ptr<MutableMemory>& buffer);
+
   // Get the address and byte-size of an output buffer. Error is
   // returned if the buffer is not already allocated.
   Status OutputBufferContents(
@@ -127,6 +174,35 @@ class InferResponseProvider {
   void SetSecondaryLabelProvider(
       const std::string& name, const SecondaryLabelProvider& provider);
 
+  // Callback invoked when the contents of a single named output are
+  // complete in its response buffer, before the response as a whole
+  // is finalized. Receives the output name, the buffer holding the
+  // contents, and the contents byte size.
+  using OutputReadyFn =
+      std::function<void(const std::string&, const void*, size_t)>;
+
+  // Set a callback to be invoked as each output's contents become
+  // complete, so that a frontend can consume large outputs
+  // incrementally instead of waiting for the full response. Only raw
+  // outputs resident in system memory are reported; classification
+  // outputs are materialized during response finalization and so are
+  // never reported early.
+  void SetOutputReadyCallback(OutputReadyFn fn)
+  {
+    output_ready_fn_ = std::move(fn);
+  }
+
+  // True if an output-ready callback is registered. Backends use this
+  // to skip the per-output signaling overhead when no one is
+  // listening.
+  bool OutputStreamingEnabled() const { return output_ready_fn_ != nullptr; }
+
+  // Report that the contents of the named output are complete in the
+  // output's response buffer. Called by the backend when the copy of
+  // that output has finished, typically before the other outputs of
+  // the same execution have been copied.
+  void OutputReady(const std::string& name);
+
   // Finalize response based on a backend.
   Status FinalizeResponse(const InferenceBackend& is);
 
@@ -147,6 +223,22 @@ class InferResponseProvider {
       TRITONSERVER_ResponseAllocatorReleaseFn_t release_fn,
       const uint32_t protocol_version);
 
+  // Invoke the response allocator's allocation function for the named
+  // output.
+  Status CallAllocFn(
+      const std::string& name, const size_t byte_size,
+      const TRTSERVER_Memory_Type preferred_memory_type,
+      const int64_t preferred_memory_type_id, void** buffer,
+      void** buffer_userp, TRTSERVER_Memory_Type* actual_memory_type,
+      int64_t* actual_memory_type_id);
+
+  // Invoke the response allocator's release function for the named
+  // output, logging any error.
+  void CallReleaseFn(
+      const std::string& name, void* buffer, void* buffer_userp,
+      const size_t byte_size, const TRTSERVER_Memory_Type memory_type,
+      const int64_t memory_type_id);
+
   std::shared_ptr<InferenceRequest> irequest_;
 
   // Map from output name to the InferenceRequest output information
@@ -166,16 +258,43 @@ class InferResponseProvider {
 
     // Created buffer for non-RAW results
     std::unique_ptr<char[]> buffer_;
+    // Capacity of 'buffer_', a power-of-two size class so the buffer
+    // can be recycled when the provider is destructed.
+    size_t buffer_byte_size_;
     // Classification contents in binary format (length bytes + raw data)
     std::vector<char> cls_contents_;
 
     void* release_buffer_;
     void* release_userp_;
+
+    // Set when the output contents were donated by the producer, see
+    // DonateOutputBuffer(). Keeps the block alive while the provider
+    // can still be asked for the output contents.
+    std::shared_ptr<Memory> donated_memory_;
   };
 
   // Ordered list of outputs as they "added" by AllocateOutputBuffer().
   std::vector<Output> outputs_;
 
+  // Buffer reserved ahead of inference for an output.
+  struct PreallocatedOutput {
+    void* buffer_;
+    void* buffer_userp_;
+    size_t byte_size_;
+    TRTSERVER_Memory_Type memory_type_;
+    int64_t memory_type_id_;
+  };
+
+  // Map from output name to the buffer reserved for that output by
+  // PreallocateOutputBuffers().
+  std::unordered_map<std::string, PreallocatedOutput> preallocated_;
+
+  // Map from output name to the buffer registered by
+  // AddInternalOutputBuffer(). These outputs are produced by the
+  // model but excluded from the client-visible response.
+  std::unordered_map<std::string, std::shared_ptr<MutableMemory>>
+      internal_outputs_;
+
   // label provider used to generate classification results.
   std::shared_ptr<LabelProvider> label_provider_;
 
@@ -194,6 +313,14 @@ class InferResponseProvider {
   TRITONSERVER_ResponseAllocatorAllocFn_t triton_alloc_fn_;
   TRITONSERVER_ResponseAllocatorReleaseFn_t triton_release_fn_;
 
+  // Callback invoked as each output's contents become complete, or
+  // nullptr if no frontend is consuming outputs incrementally.
+  OutputReadyFn output_ready_fn_;
+
+  // Callback accepting donated output buffers, or nullptr if the
+  // consumer requires contents to be copied into allocated buffers.
+  BufferDonationFn buffer_donation_fn_;
+
   // FIXMEV2 use to differentiate how outputs should be represented
   const uint32_t protocol_version_;
 
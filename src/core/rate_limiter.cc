@@ -0,0 +1,77 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/rate_limiter.h"
+
+#include <time.h>
+#include <algorithm>
+#include "src/core/constants.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+uint64_t
+NowNanoseconds()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return TIMESPEC_TO_NANOS(now);
+}
+
+}  // namespace
+
+TokenBucket::TokenBucket(
+    const double tokens_per_second, const uint64_t burst_size)
+    : tokens_per_second_(tokens_per_second),
+      burst_size_((burst_size == 0) ? 1.0 : (double)burst_size),
+      tokens_(burst_size_), last_refill_ns_(NowNanoseconds())
+{
+}
+
+bool
+TokenBucket::TryAcquire()
+{
+  const uint64_t now_ns = NowNanoseconds();
+
+  std::lock_guard<std::mutex> lock(mu_);
+  if (now_ns > last_refill_ns_) {
+    tokens_ = std::min(
+        burst_size_,
+        tokens_ + ((now_ns - last_refill_ns_) * tokens_per_second_ /
+                   (double)NANOS_PER_SECOND));
+    last_refill_ns_ = now_ns;
+  }
+
+  if (tokens_ < 1.0) {
+    return false;
+  }
+
+  tokens_ -= 1.0;
+  return true;
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,58 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <mutex>
+#include <stdint.h>
+
+namespace nvidia { namespace inferenceserver {
+
+// A token bucket used to rate limit request admission for a model.
+// The bucket refills continuously at the configured rate up to the
+// burst size; each admitted request takes one token and a request
+// that finds the bucket empty is shed. The bucket starts full so a
+// freshly loaded model can absorb an initial burst.
+class TokenBucket {
+ public:
+  // Create a bucket that refills at 'tokens_per_second' and holds at
+  // most 'burst_size' tokens. A burst size of 0 allows a burst of a
+  // single request.
+  TokenBucket(const double tokens_per_second, const uint64_t burst_size);
+
+  // Take one token from the bucket. Returns false without taking a
+  // token if the bucket is empty.
+  bool TryAcquire();
+
+ private:
+  const double tokens_per_second_;
+  const double burst_size_;
+
+  std::mutex mu_;
+  double tokens_;
+  uint64_t last_refill_ns_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,255 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/response_cache.h"
+
+#include <cstring>
+#include "src/core/infer_request.h"
+#include "src/core/logging.h"
+#include "src/core/memory.h"
+#include "src/core/provider.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// 64-bit FNV-1a.
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+void
+HashBytes(const void* bytes, const size_t byte_size, uint64_t* hash)
+{
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes);
+  for (size_t idx = 0; idx < byte_size; idx++) {
+    *hash = (*hash ^ data[idx]) * kFnvPrime;
+  }
+}
+
+void
+HashString(const std::string& str, uint64_t* hash)
+{
+  HashBytes(str.data(), str.size(), hash);
+}
+
+}  // namespace
+
+ResponseCache::ResponseCache(const uint64_t max_byte_size)
+    : max_shard_byte_size_(std::max(
+          max_byte_size / kNumShards, static_cast<uint64_t>(1)))
+{
+  for (size_t idx = 0; idx < kNumShards; idx++) {
+    shards_.emplace_back(new Shard());
+  }
+}
+
+bool
+ResponseCache::Digest(const InferenceRequest& request, uint64_t* digest)
+{
+  uint64_t hash = kFnvOffsetBasis;
+
+  HashString(request.ModelName(), &hash);
+  const int64_t version = request.ActualModelVersion();
+  HashBytes(&version, sizeof(version), &hash);
+
+  // The requested outputs are part of the key so that a hit always
+  // provides exactly the outputs that the request asked for.
+  // Classification outputs can't be captured from the response
+  // provider as raw tensors so requests using them are not cacheable.
+  for (const auto& pr : request.RequestedOutputs()) {
+    if (pr.second.ClassificationCount() != 0) {
+      return false;
+    }
+
+    HashString(pr.first, &hash);
+  }
+
+  for (const auto& pr : request.OriginalInputs()) {
+    HashString(pr.first, &hash);
+    for (const int64_t dim : pr.second.Shape()) {
+      HashBytes(&dim, sizeof(dim), &hash);
+    }
+
+    const auto& data = pr.second.Data();
+    if (data == nullptr) {
+      continue;
+    }
+
+    size_t content_byte_size;
+    TRTSERVER_Memory_Type memory_type;
+    int64_t memory_type_id;
+    size_t content_idx = 0;
+    const char* content = data->BufferAt(
+        content_idx, &content_byte_size, &memory_type, &memory_type_id);
+    while (content != nullptr) {
+      if (memory_type != TRTSERVER_MEMORY_CPU) {
+        return false;
+      }
+
+      HashBytes(content, content_byte_size, &hash);
+      content_idx++;
+      content = data->BufferAt(
+          content_idx, &content_byte_size, &memory_type, &memory_type_id);
+    }
+  }
+
+  *digest = hash;
+  return true;
+}
+
+Status
+ResponseCache::Lookup(
+    const uint64_t digest,
+    const std::shared_ptr<InferResponseProvider>& response_provider)
+{
+  Shard* shard = shards_[digest % kNumShards].get();
+
+  // Copy the outputs out of the entry while holding the shard lock so
+  // that a concurrent eviction can't invalidate them, then fill the
+  // response provider without the lock held.
+  std::vector<CachedOutput> outputs;
+  {
+    std::lock_guard<std::mutex> lk(shard->mtx_);
+    auto it = shard->entries_.find(digest);
+    if (it == shard->entries_.end()) {
+      return Status(Status::Code::NOT_FOUND, "response not cached");
+    }
+
+    shard->lru_.erase(it->second.lru_it_);
+    shard->lru_.push_front(digest);
+    it->second.lru_it_ = shard->lru_.begin();
+    outputs = it->second.outputs_;
+  }
+
+  for (const auto& output : outputs) {
+    void* buffer;
+    TRTSERVER_Memory_Type actual_memory_type;
+    int64_t actual_memory_type_id;
+    RETURN_IF_ERROR(response_provider->AllocateOutputBuffer(
+        output.name_, &buffer, output.data_.size(), output.shape_,
+        TRTSERVER_MEMORY_CPU, 0 /* preferred_memory_type_id */,
+        &actual_memory_type, &actual_memory_type_id));
+
+    // The response allocator chooses the placement of the output
+    // buffer and a cached entry can only be copied into CPU memory.
+    // The request can't fall back to normal execution at this point
+    // because the output has already been allocated.
+    if (actual_memory_type != TRTSERVER_MEMORY_CPU) {
+      return Status(
+          Status::Code::UNSUPPORTED,
+          "cached output '" + output.name_ +
+              "' can't be copied to non-CPU memory");
+    }
+    if ((buffer == nullptr) && !output.data_.empty()) {
+      return Status(
+          Status::Code::INTERNAL,
+          "failed to allocate buffer for cached output '" + output.name_ +
+              "'");
+    }
+
+    if (!output.data_.empty()) {
+      memcpy(buffer, output.data_.data(), output.data_.size());
+    }
+  }
+
+  return Status::Success;
+}
+
+void
+ResponseCache::Insert(
+    const uint64_t digest, const InferenceRequest& request,
+    const std::shared_ptr<InferResponseProvider>& response_provider)
+{
+  Entry entry;
+  entry.byte_size_ = 0;
+
+  for (const auto& pr : request.RequestedOutputs()) {
+    const void* content;
+    size_t content_byte_size;
+    TRTSERVER_Memory_Type memory_type;
+    int64_t memory_type_id;
+    Status status = response_provider->OutputBufferContents(
+        pr.first, &content, &content_byte_size, &memory_type, &memory_type_id);
+    if (!status.IsOk() || (memory_type != TRTSERVER_MEMORY_CPU)) {
+      return;
+    }
+
+    const int64_t* shape;
+    uint64_t dim_count;
+    status = response_provider->OutputShape(pr.first, &shape, &dim_count);
+    if (!status.IsOk()) {
+      return;
+    }
+
+    CachedOutput output;
+    output.name_ = pr.first;
+    output.shape_.assign(shape, shape + dim_count);
+    output.data_.assign(
+        reinterpret_cast<const char*>(content),
+        reinterpret_cast<const char*>(content) + content_byte_size);
+    entry.byte_size_ += content_byte_size;
+    entry.outputs_.emplace_back(std::move(output));
+  }
+
+  if (entry.byte_size_ > max_shard_byte_size_) {
+    return;
+  }
+
+  Shard* shard = shards_[digest % kNumShards].get();
+  std::lock_guard<std::mutex> lk(shard->mtx_);
+
+  // If the digest is already cached, refresh its LRU position and
+  // keep the existing entry.
+  auto it = shard->entries_.find(digest);
+  if (it != shard->entries_.end()) {
+    shard->lru_.erase(it->second.lru_it_);
+    shard->lru_.push_front(digest);
+    it->second.lru_it_ = shard->lru_.begin();
+    return;
+  }
+
+  shard->byte_size_ += entry.byte_size_;
+  shard->lru_.push_front(digest);
+  entry.lru_it_ = shard->lru_.begin();
+  shard->entries_.emplace(digest, std::move(entry));
+  Evict(shard);
+}
+
+void
+ResponseCache::Evict(Shard* shard)
+{
+  while ((shard->byte_size_ > max_shard_byte_size_) && !shard->lru_.empty()) {
+    const uint64_t victim = shard->lru_.back();
+    shard->lru_.pop_back();
+    auto it = shard->entries_.find(victim);
+    if (it != shard->entries_.end()) {
+      shard->byte_size_ -= it->second.byte_size_;
+      shard->entries_.erase(it);
+    }
+  }
+}
+
+}}  // namespace nvidia::inferenceserver
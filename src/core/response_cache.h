@@ -0,0 +1,105 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+class InferenceRequest;
+class InferResponseProvider;
+
+// A size-bounded LRU cache of inference responses keyed by a digest of
+// the request inputs. The cache is sharded to reduce lock contention
+// between concurrent requests. Only requests whose inputs reside in
+// CPU memory, and whose outputs are raw tensors in CPU memory, are
+// cacheable; anything else simply bypasses the cache.
+class ResponseCache {
+ public:
+  explicit ResponseCache(const uint64_t max_byte_size);
+
+  // Compute the digest identifying 'request' for cache purposes. The
+  // digest covers the input names, shapes and tensor contents as well
+  // as the requested outputs. Return false if the request is not
+  // cacheable, in which case 'digest' is untouched.
+  static bool Digest(const InferenceRequest& request, uint64_t* digest);
+
+  // Look up 'digest' and, on a hit, copy the cached outputs into
+  // 'response_provider'. Return success on a hit, NOT_FOUND on a miss
+  // with 'response_provider' untouched, and any other error if the
+  // cached outputs could not be copied into the buffers provided by
+  // the response allocator.
+  Status Lookup(
+      const uint64_t digest,
+      const std::shared_ptr<InferResponseProvider>& response_provider);
+
+  // Insert the outputs held by 'response_provider' for 'request' into
+  // the cache under 'digest'. The insert is silently abandoned if any
+  // output is not a raw CPU tensor or if the entry is larger than a
+  // cache shard.
+  void Insert(
+      const uint64_t digest, const InferenceRequest& request,
+      const std::shared_ptr<InferResponseProvider>& response_provider);
+
+ private:
+  struct CachedOutput {
+    std::string name_;
+    std::vector<int64_t> shape_;
+    std::vector<char> data_;
+  };
+
+  struct Entry {
+    std::vector<CachedOutput> outputs_;
+    uint64_t byte_size_;
+    std::list<uint64_t>::iterator lru_it_;
+  };
+
+  struct Shard {
+    std::mutex mtx_;
+    std::unordered_map<uint64_t, Entry> entries_;
+
+    // LRU order of the digests in 'entries_', most recently used at
+    // the front.
+    std::list<uint64_t> lru_;
+    uint64_t byte_size_ = 0;
+  };
+
+  // Evict entries from 'shard' until its size is within
+  // 'max_shard_byte_size_'. Caller must hold the shard lock.
+  void Evict(Shard* shard);
+
+  static constexpr size_t kNumShards = 8;
+
+  const uint64_t max_shard_byte_size_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -26,8 +26,11 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <vector>
 #include "src/core/api.pb.h"
 #include "src/core/infer_request.h"
+#include "src/core/model_config.h"
 #include "src/core/server_status.h"
 #include "src/core/status.h"
 
@@ -51,7 +54,8 @@ class Scheduler {
           request_(std::move(payload.request_)),
           response_provider_(std::move(payload.response_provider_)),
           complete_function_(std::move(payload.complete_function_)),
-          status_(std::move(payload.status_))
+          status_(std::move(payload.status_)),
+          shape_signature_(payload.shape_signature_)
     {
     }
     Payload(
@@ -72,6 +76,7 @@ class Scheduler {
       response_provider_ = std::move(payload.response_provider_);
       complete_function_ = std::move(payload.complete_function_);
       status_ = std::move(payload.status_);
+      shape_signature_ = payload.shape_signature_;
       return *this;
     }
 
@@ -80,6 +85,11 @@ class Scheduler {
     std::shared_ptr<InferResponseProvider> response_provider_;
     std::function<void(const Status&)> complete_function_;
     Status status_;
+
+    // Signature identifying the shapes of the inputs that must be
+    // equal across a batch, as computed by ShapeSignature(). Zero if
+    // no signature has been computed for the request.
+    uint64_t shape_signature_ = 0;
   };
 
   // The prototype for the initialization function that will be called
@@ -98,6 +108,15 @@ class Scheduler {
   // prevents scheduler from sending sample payloads to the runner.
   using StandardWarmupFunc = std::function<Status(uint32_t runner_idx)>;
 
+  // The prototype for the release function that can be called by the
+  // "standard" schedulers when dynamic instance scaling deactivates
+  // the runner for 'runner_idx'. The release function frees the
+  // execution context associated with the runner; a later call to the
+  // init function recreates it. A non-OK error status indicates that
+  // the context could not be released and the runner must stay
+  // active.
+  using StandardReleaseFunc = std::function<Status(uint32_t runner_idx)>;
+
   // The prototype for the run function that will be called by the
   // "standard" schedulers created based on a model's
   // scheduling_choice settings. The run function must accept a
@@ -126,6 +145,57 @@ class Scheduler {
       const std::shared_ptr<InferenceRequest>& request,
       const std::shared_ptr<InferResponseProvider>& response_provider,
       std::function<void(const Status&)> OnComplete) = 0;
+
+  // Update the scheduler parameters from 'config' without draining or
+  // recreating the scheduler. Only parameters that can be swapped
+  // atomically between batch formations are applied; schedulers that
+  // support no in-place update return UNSUPPORTED and the caller must
+  // fall back to a full model reload.
+  virtual Status UpdateConfig(const ModelConfig& config)
+  {
+    return Status(
+        Status::Code::UNSUPPORTED,
+        "scheduler does not support in-place configuration update");
+  }
+
+  // The scheduler-visible state of one in-flight sequence, used to
+  // migrate live sequences between instances during a drain.
+  struct SequenceState {
+    // The correlation ID of the sequence.
+    CorrelationID correlation_id_;
+
+    // Microseconds since the most recent request of the sequence, at
+    // the time the snapshot was taken. Ages, not timestamps, so that
+    // the snapshot is meaningful on another host.
+    uint64_t idle_microseconds_;
+
+    // Opaque per-sequence backend state. Empty if the backend does
+    // not support explicit sequence state.
+    std::string backend_state_;
+  };
+
+  // Export the state of all in-flight sequences. The scheduler must
+  // be quiesced, with no in-flight or backlogged requests, when the
+  // snapshot is taken. Schedulers that don't track sequences return
+  // UNSUPPORTED.
+  virtual Status SnapshotSequenceStates(std::vector<SequenceState>* states)
+  {
+    return Status(
+        Status::Code::UNSUPPORTED,
+        "scheduler does not support sequence-state snapshot");
+  }
+
+  // Restore sequences exported by SnapshotSequenceStates() on another
+  // scheduler instance. Each restored sequence occupies a sequence
+  // slot as if its next request had arrived. Schedulers that don't
+  // track sequences return UNSUPPORTED.
+  virtual Status RestoreSequenceStates(
+      const std::vector<SequenceState>& states)
+  {
+    return Status(
+        Status::Code::UNSUPPORTED,
+        "scheduler does not support sequence-state restore");
+  }
 };
 
 }}  // namespace nvidia::inferenceserver
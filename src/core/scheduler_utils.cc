@@ -51,9 +51,17 @@ InitPendingShape(
       shapes.first = input->Shape();
 
       // For shape tensors must compare the contents of the tensor in
-      // addition to the tensor shape itself.
+      // addition to the tensor shape itself. Prefer the value cached
+      // on the request at admission so the scheduler thread doesn't
+      // stall reading the tensor from the device.
       if (itr->second) {
-        RETURN_IF_ERROR(OnPeek(runner_id, *input, payload, &shapes.second));
+        const std::vector<int64_t>* peeked =
+            irequest->PeekedShapeTensor(input->Name());
+        if (peeked != nullptr) {
+          shapes.second = *peeked;
+        } else {
+          RETURN_IF_ERROR(OnPeek(runner_id, *input, payload, &shapes.second));
+        }
 
         LOG_VERBOSE(1) << "peek '" << input->Name() << "', shape "
                        << DimsListToString(shapes.first) << ", value "
@@ -85,13 +93,19 @@ CompareWithPendingShape(
       }
 
       // If there are shape-tensor contents then compare those as
-      // well.
+      // well, using the value cached on the request at admission when
+      // available.
       if (!itr->second.second.empty()) {
         std::vector<int64_t> shape;
 
+        const std::vector<int64_t>* peeked =
+            irequest->PeekedShapeTensor(input->Name());
+        if (peeked != nullptr) {
+          shape = *peeked;
+        }
         // If fail getting the tensor shape then conservatively return
         // false to indicate that the shapes don't match.
-        if (!OnPeek(runner_id, *input, payload, &shape).IsOk()) {
+        else if (!OnPeek(runner_id, *input, payload, &shape).IsOk()) {
           return false;
         }
         if (!CompareDims(itr->second.second, shape)) {
@@ -104,12 +118,54 @@ CompareWithPendingShape(
   return true;
 }
 
+uint64_t
+ShapeSignature(
+    const InferenceRequest& request,
+    const std::unordered_map<std::string, bool>& enforce_equal_shape_tensors)
+{
+  // FNV-1a over the names and dims of the enforced inputs.
+  uint64_t signature = 0xcbf29ce484222325ull;
+  for (const auto& pr : request.ImmutableInputs()) {
+    const InferenceRequest::Input* input = pr.second;
+    const auto itr = enforce_equal_shape_tensors.find(input->Name());
+    if (itr != enforce_equal_shape_tensors.end()) {
+      // The contents of a shape tensor can't be represented in the
+      // signature.
+      if (itr->second) {
+        return 0;
+      }
+
+      signature =
+          (signature ^ std::hash<std::string>{}(input->Name())) *
+          0x100000001b3ull;
+      for (const auto dim : input->Shape()) {
+        signature = (signature ^ (uint64_t)dim) * 0x100000001b3ull;
+      }
+    }
+  }
+
+  // Reserve 0 to mean "no signature".
+  return (signature == 0) ? 1 : signature;
+}
+
 Status
-PriorityQueue::PolicyQueue::Enqueue(Scheduler::Payload&& payload)
+PriorityQueue::PolicyQueue::Enqueue(
+    Scheduler::Payload&& payload, const uint64_t service_time_estimate_ns)
 {
   if ((max_queue_size_ != 0) && (Size() >= max_queue_size_)) {
     return Status(Status::Code::UNAVAILABLE, "Exceeds maximum queue size");
   }
+
+  // With a wait bound configured, shed the payload when the queued
+  // payloads ahead of it are estimated to take longer than the bound
+  // to drain. The estimate scales with the measured execution speed of
+  // the model, so a slowdown tightens the effective queue bound where
+  // a fixed count would let queueing latency grow unchecked.
+  if ((max_queue_wait_us_ != 0) && (service_time_estimate_ns != 0) &&
+      ((Size() * service_time_estimate_ns) > (max_queue_wait_us_ * 1000))) {
+    return Status(
+        Status::Code::UNAVAILABLE, "Exceeds maximum estimated queue wait");
+  }
   queue_.emplace_back(std::move(payload));
   auto timeout_us = default_timeout_us_;
   if (allow_timeout_override_) {
@@ -118,15 +174,24 @@ PriorityQueue::PolicyQueue::Enqueue(Scheduler::Payload&& payload)
       timeout_us = override_timeout_us;
     }
   }
+  uint64_t timeout_timestamp_ns = 0;
   if (timeout_us != 0) {
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
-    timeout_timestamp_ns_.emplace_back(
-        TIMESPEC_TO_NANOS(now) + timeout_us * 1000);
-  } else {
-    timeout_timestamp_ns_.emplace_back(0);
+    timeout_timestamp_ns = TIMESPEC_TO_NANOS(now) + timeout_us * 1000;
   }
 
+  // The request deadline set by the frontend is always honored,
+  // independent of the queue policy. The effective timestamp is the
+  // earlier of the policy timeout and the deadline so that batch
+  // formation never waits past either.
+  const uint64_t deadline_ns = queue_.back().request_->DeadlineNanoseconds();
+  if ((deadline_ns != 0) &&
+      ((timeout_timestamp_ns == 0) || (deadline_ns < timeout_timestamp_ns))) {
+    timeout_timestamp_ns = deadline_ns;
+  }
+  timeout_timestamp_ns_.emplace_back(timeout_timestamp_ns);
+
   return Status::Success;
 }
 
@@ -155,9 +220,26 @@ PriorityQueue::PolicyQueue::ApplyPolicy(
   if (idx < queue_.size()) {
     size_t curr_idx = idx;
     while (curr_idx < queue_.size()) {
-      if ((timeout_timestamp_ns_[curr_idx] != 0) &&
+      if (queue_[curr_idx].request_->IsCancelled()) {
+        // A cancelled payload is dropped regardless of the queue
+        // policy. It is counted with the rejected payloads so that
+        // the caller's batch-size accounting stays correct, but is
+        // released separately so that it completes with a
+        // cancellation status.
+        cancelled_queue_.emplace_back(std::move(queue_[curr_idx]));
+        *rejected_count += 1;
+        *rejected_batch_size += cancelled_queue_.back().request_->BatchSize();
+        curr_idx++;
+      } else if (
+          (timeout_timestamp_ns_[curr_idx] != 0) &&
           (now_nanoseconds > timeout_timestamp_ns_[curr_idx])) {
-        if (timeout_action_ == ModelQueuePolicy::DELAY) {
+        // A payload whose request deadline has passed is rejected
+        // even if the policy action is DELAY, executing it would be
+        // wasted work since the client will not use the response.
+        const uint64_t deadline_ns =
+            queue_[curr_idx].request_->DeadlineNanoseconds();
+        if ((timeout_action_ == ModelQueuePolicy::DELAY) &&
+            ((deadline_ns == 0) || (now_nanoseconds <= deadline_ns))) {
           delayed_queue_.emplace_back(std::move(queue_[curr_idx]));
         } else {
           rejected_queue_.emplace_back(std::move(queue_[curr_idx]));
@@ -191,6 +273,44 @@ PriorityQueue::PolicyQueue::ApplyPolicy(
   return ((idx - queue_.size()) < delayed_queue_.size());
 }
 
+bool
+PriorityQueue::PolicyQueue::EnforceTimeouts(
+    const uint64_t now_nanoseconds, size_t* rejected_count,
+    size_t* rejected_batch_size)
+{
+  bool removed = false;
+  size_t idx = 0;
+  while (idx < queue_.size()) {
+    if (queue_[idx].request_->IsCancelled()) {
+      cancelled_queue_.emplace_back(std::move(queue_[idx]));
+      *rejected_count += 1;
+      *rejected_batch_size += cancelled_queue_.back().request_->BatchSize();
+      queue_.erase(queue_.begin() + idx);
+      timeout_timestamp_ns_.erase(timeout_timestamp_ns_.begin() + idx);
+      removed = true;
+    } else if (
+        (timeout_timestamp_ns_[idx] != 0) &&
+        (now_nanoseconds > timeout_timestamp_ns_[idx])) {
+      const uint64_t deadline_ns = queue_[idx].request_->DeadlineNanoseconds();
+      if ((timeout_action_ == ModelQueuePolicy::DELAY) &&
+          ((deadline_ns == 0) || (now_nanoseconds <= deadline_ns))) {
+        delayed_queue_.emplace_back(std::move(queue_[idx]));
+      } else {
+        rejected_queue_.emplace_back(std::move(queue_[idx]));
+        *rejected_count += 1;
+        *rejected_batch_size += rejected_queue_.back().request_->BatchSize();
+      }
+      queue_.erase(queue_.begin() + idx);
+      timeout_timestamp_ns_.erase(timeout_timestamp_ns_.begin() + idx);
+      removed = true;
+    } else {
+      idx++;
+    }
+  }
+
+  return removed;
+}
+
 std::deque<Scheduler::Payload>
 PriorityQueue::PolicyQueue::ReleaseRejectedQueue()
 {
@@ -199,6 +319,14 @@ PriorityQueue::PolicyQueue::ReleaseRejectedQueue()
   return res;
 }
 
+std::deque<Scheduler::Payload>
+PriorityQueue::PolicyQueue::ReleaseCancelledQueue()
+{
+  std::deque<Scheduler::Payload> res;
+  cancelled_queue_.swap(res);
+  return res;
+}
+
 Scheduler::Payload&
 PriorityQueue::PolicyQueue::At(size_t idx)
 {
@@ -219,8 +347,28 @@ PriorityQueue::PolicyQueue::TimeoutAt(size_t idx)
   }
 }
 
+uint64_t
+PriorityQueue::PolicyQueue::FrontEnqueueTime()
+{
+  uint64_t oldest_ns = 0;
+  if (!queue_.empty()) {
+    oldest_ns = TIMESPEC_TO_NANOS(queue_.front().stats_->Timestamp(
+        ModelInferStats::TimestampKind::kQueueStart));
+  }
+  if (!delayed_queue_.empty()) {
+    const uint64_t delayed_ns =
+        TIMESPEC_TO_NANOS(delayed_queue_.front().stats_->Timestamp(
+            ModelInferStats::TimestampKind::kQueueStart));
+    if ((oldest_ns == 0) || (delayed_ns < oldest_ns)) {
+      oldest_ns = delayed_ns;
+    }
+  }
+  return oldest_ns;
+}
+
 PriorityQueue::PriorityQueue()
-    : size_(0), front_priority_level_(0), last_priority_level_(0)
+    : size_(0), front_priority_level_(0), last_priority_level_(0),
+      service_time_estimate_ns_(0)
 {
   ModelQueuePolicy default_policy;
   queues_.emplace(0, PolicyQueue(default_policy));
@@ -231,7 +379,8 @@ PriorityQueue::PriorityQueue()
 PriorityQueue::PriorityQueue(
     const ModelQueuePolicy& default_queue_policy, uint32_t priority_levels,
     const ModelQueuePolicyMap queue_policy_map)
-    : size_(0), last_priority_level_(priority_levels)
+    : size_(0), last_priority_level_(priority_levels),
+      service_time_estimate_ns_(0)
 {
   if (priority_levels == 0) {
     queues_.emplace(0, PolicyQueue(default_queue_policy));
@@ -252,10 +401,15 @@ PriorityQueue::PriorityQueue(
 Status
 PriorityQueue::Enqueue(uint32_t priority_level, Scheduler::Payload&& payload)
 {
-  auto status = queues_[priority_level].Enqueue(std::move(payload));
+  auto status = queues_[priority_level].Enqueue(
+      std::move(payload), service_time_estimate_ns_);
   if (status.IsOk()) {
     size_++;
     front_priority_level_ = std::min(front_priority_level_, priority_level);
+    const uint64_t timeout_ns = queues_[priority_level].NewestTimeout();
+    if (timeout_ns != 0) {
+      deadline_heap_.emplace(timeout_ns, priority_level);
+    }
     // Invalidate the pending batch cursor if the enqueued item is placed
     // within the pending batch. At the same priority level, the payload is
     // guaranteed to be after pending batch if the batch hasn't reached
@@ -303,6 +457,76 @@ PriorityQueue::ReleaseRejectedPayloads()
   return std::move(res);
 }
 
+std::shared_ptr<std::vector<std::deque<Scheduler::Payload>>>
+PriorityQueue::ReleaseCancelledPayloads()
+{
+  auto res = std::make_shared<std::vector<std::deque<Scheduler::Payload>>>(
+      queues_.size());
+  size_t idx = 0;
+  for (auto& queue : queues_) {
+    (*res)[idx] = std::move(queue.second.ReleaseCancelledQueue());
+    idx++;
+  }
+  return std::move(res);
+}
+
+uint64_t
+PriorityQueue::OldestQueuedEnqueueTime()
+{
+  uint64_t oldest_ns = 0;
+  for (auto& queue : queues_) {
+    const uint64_t front_ns = queue.second.FrontEnqueueTime();
+    if ((front_ns != 0) && ((oldest_ns == 0) || (front_ns < oldest_ns))) {
+      oldest_ns = front_ns;
+    }
+  }
+  return oldest_ns;
+}
+
+size_t
+PriorityQueue::EnforceTimeouts()
+{
+  if (deadline_heap_.empty()) {
+    return 0;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_nanoseconds = TIMESPEC_TO_NANOS(now);
+
+  // Pop every deadline that has passed. Entries may be stale (the
+  // payload already left its queue), so the actual expired payloads
+  // are found by sweeping the affected priority levels.
+  std::set<uint32_t> expired_levels;
+  while (!deadline_heap_.empty() &&
+         (now_nanoseconds > deadline_heap_.top().first)) {
+    expired_levels.insert(deadline_heap_.top().second);
+    deadline_heap_.pop();
+  }
+
+  if (expired_levels.empty()) {
+    return 0;
+  }
+
+  size_t rejected_count = 0;
+  size_t rejected_batch_size = 0;
+  bool removed = false;
+  for (const auto level : expired_levels) {
+    auto it = queues_.find(level);
+    if (it != queues_.end()) {
+      removed |= it->second.EnforceTimeouts(
+          now_nanoseconds, &rejected_count, &rejected_batch_size);
+    }
+  }
+
+  if (removed) {
+    size_ -= rejected_count;
+    pending_cursor_.valid_ = false;
+  }
+
+  return rejected_batch_size;
+}
+
 bool
 PriorityQueue::IsCursorValid()
 {
@@ -26,6 +26,8 @@
 #pragma once
 
 #include <deque>
+#include <queue>
+#include <set>
 #include <unordered_map>
 #include "src/core/model_config.h"
 #include "src/core/scheduler.h"
@@ -47,6 +49,16 @@ bool CompareWithPendingShape(
     const Scheduler::StandardShapeTensorPeekFunc& OnPeek,
     const PendingBatchShapes& pending_batch_shapes);
 
+// Compute a signature identifying the shapes of the request inputs
+// listed in 'enforce_equal_shape_tensors'. Two requests with the same
+// non-zero signature may be batched together. Returns 0 if the
+// constraint cannot be represented by a signature (the contents of a
+// shape tensor must be compared) and the caller must fall back to
+// explicit shape comparison.
+uint64_t ShapeSignature(
+    const InferenceRequest& request,
+    const std::unordered_map<std::string, bool>& enforce_equal_shape_tensors);
+
 using ModelQueuePolicyMap =
     ::google::protobuf::Map<::google::protobuf::uint32, ModelQueuePolicy>;
 
@@ -73,6 +85,20 @@ class PriorityQueue {
   std::shared_ptr<std::vector<std::deque<Scheduler::Payload>>>
   ReleaseRejectedPayloads();
 
+  // Retrieve the payloads that were dropped because their request was
+  // cancelled.
+  std::shared_ptr<std::vector<std::deque<Scheduler::Payload>>>
+  ReleaseCancelledPayloads();
+
+  // Proactively enforce the queue-policy timeouts across all priority
+  // levels. A min-heap of deadlines is consulted first so that no
+  // work is done before the earliest deadline has actually passed.
+  // Expired payloads are delayed or rejected per their queue policy
+  // and the pending batch cursor is invalidated if the queue is
+  // altered. Returns the total batch size of the newly rejected
+  // payloads.
+  size_t EnforceTimeouts();
+
   // Return the number of payloads in the queue, rejected payloads are not
   // included.
   size_t Size() { return size_; }
@@ -131,6 +157,20 @@ class PriorityQueue {
   // Return the number of payloads in pending batch.
   size_t PendingBatchCount() { return pending_cursor_.pending_batch_count_; }
 
+  // Return the enqueue time of the oldest payload across all priority
+  // levels, in ns. Returns 0 if the queue is empty. Unlike
+  // OldestEnqueueTime() this considers the whole queue, not just the
+  // pending batch.
+  uint64_t OldestQueuedEnqueueTime();
+
+  // Set the estimated service time per queued payload, in ns, used by
+  // queue policies that bound the queue by estimated wait time. A
+  // value of 0 disables the bound until an estimate is available.
+  void SetServiceTimeEstimate(const uint64_t service_time_ns)
+  {
+    service_time_estimate_ns_ = service_time_ns;
+  }
+
  private:
   class PolicyQueue {
    public:
@@ -138,7 +178,8 @@ class PriorityQueue {
     // as regular queue.
     PolicyQueue()
         : timeout_action_(ModelQueuePolicy::REJECT), default_timeout_us_(0),
-          allow_timeout_override_(false), max_queue_size_(0)
+          allow_timeout_override_(false), max_queue_size_(0),
+          max_queue_wait_us_(0)
     {
     }
 
@@ -147,12 +188,16 @@ class PriorityQueue {
         : timeout_action_(policy.timeout_action()),
           default_timeout_us_(policy.default_timeout_microseconds()),
           allow_timeout_override_(policy.allow_timeout_override()),
-          max_queue_size_(policy.max_queue_size())
+          max_queue_size_(policy.max_queue_size()),
+          max_queue_wait_us_(policy.max_queue_wait_microseconds())
     {
     }
 
     // Enqueue an payload and set up its timeout accordingly.
-    Status Enqueue(Scheduler::Payload&& payload);
+    // 'service_time_estimate_ns' is the estimated service time per
+    // queued payload used to enforce 'max_queue_wait_us_'.
+    Status Enqueue(
+        Scheduler::Payload&& payload, const uint64_t service_time_estimate_ns);
 
     // Dequeue the payload at the front of the queue.
     Scheduler::Payload Dequeue();
@@ -167,9 +212,28 @@ class PriorityQueue {
     bool ApplyPolicy(
         size_t idx, size_t* rejected_count, size_t* rejected_batch_size);
 
+    // Move every expired payload out of the queue according to the
+    // policy, regardless of its position. 'rejected_count' and
+    // 'rejected_batch_size' are incremented for the newly rejected
+    // payloads. Return true if any payload was removed from the
+    // queue.
+    bool EnforceTimeouts(
+        const uint64_t now_nanoseconds, size_t* rejected_count,
+        size_t* rejected_batch_size);
+
+    // Return the timeout timestamp assigned to the most recently
+    // enqueued payload, in ns. A value of 0 indicates no timeout.
+    uint64_t NewestTimeout()
+    {
+      return timeout_timestamp_ns_.empty() ? 0 : timeout_timestamp_ns_.back();
+    }
+
     // Return the rejected payloads held by the request queue.
     std::deque<Scheduler::Payload> ReleaseRejectedQueue();
 
+    // Return the cancelled payloads held by the request queue.
+    std::deque<Scheduler::Payload> ReleaseCancelledQueue();
+
     // Return the payload at 'idx'.
     Scheduler::Payload& At(size_t idx);
 
@@ -187,17 +251,23 @@ class PriorityQueue {
     // Return the number of unexpired requests in the queue
     size_t UnexpiredSize() { return queue_.size(); }
 
+    // Return the enqueue time of the payload at the front of the
+    // queue, in ns. Returns 0 if the queue is empty.
+    uint64_t FrontEnqueueTime();
+
    private:
     // Variables that define the policy for the queue
     const ModelQueuePolicy::TimeoutAction timeout_action_;
     const uint64_t default_timeout_us_;
     const bool allow_timeout_override_;
     const uint32_t max_queue_size_;
+    const uint64_t max_queue_wait_us_;
 
     std::deque<uint64_t> timeout_timestamp_ns_;
     std::deque<Scheduler::Payload> queue_;
     std::deque<Scheduler::Payload> delayed_queue_;
     std::deque<Scheduler::Payload> rejected_queue_;
+    std::deque<Scheduler::Payload> cancelled_queue_;
   };
   using PriorityQueues = std::map<uint32_t, PolicyQueue>;
 
@@ -237,6 +307,20 @@ class PriorityQueue {
 
   Cursor pending_cursor_;
   Cursor current_mark_;
+
+  // The estimated service time per queued payload, in ns, provided by
+  // the scheduler from the measured execution times of recent
+  // batches. 0 until an estimate is available.
+  uint64_t service_time_estimate_ns_;
+
+  // Min-heap of (timeout timestamp, priority level) across all policy
+  // queues. Entries for payloads that have already left their queue
+  // are discarded lazily when popped.
+  std::priority_queue<
+      std::pair<uint64_t, uint32_t>,
+      std::vector<std::pair<uint64_t, uint32_t>>,
+      std::greater<std::pair<uint64_t, uint32_t>>>
+      deadline_heap_;
 };
 
 }}  // namespace nvidia::inferenceserver
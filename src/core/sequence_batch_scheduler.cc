@@ -30,7 +30,9 @@
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
 #include "src/core/constants.h"
+#include "src/core/cpu_affinity.h"
 #include "src/core/dynamic_batch_scheduler.h"
 #include "src/core/logging.h"
 #include "src/core/model_config_utils.h"
@@ -74,6 +76,15 @@ SequenceBatchScheduler::Create(
         config.sequence_batching().oldest().max_candidate_sequences();
   }
 
+  // Create the explicit sequence-state cache if the model declares
+  // state tensors. The cache is shared by all the batchers since a
+  // sequence's state is keyed by correlation ID, not by slot.
+  if (config.sequence_batching().state_size() > 0) {
+    sched->state_cache_.reset(new SequenceStateCache(
+        config.sequence_batching(),
+        config.sequence_batching().state_cache_byte_size()));
+  }
+
   // Based on the model configuration create input tensors for control
   // signals indicating sequence start, sequence continue, and
   // sequence not ready.
@@ -213,6 +224,32 @@ GetBooleanOverrideInputs(
   return Status::Success;
 }
 
+// Return true if 'null_request' can continue to serve as the null
+// request for a batch whose representative request is 'request': the
+// inputs must match by name, shape and datatype so that the null
+// payload batches with the real ones.
+bool
+NullRequestCompatible(
+    const InferenceRequest& null_request, const InferenceRequest& request)
+{
+  const auto& null_inputs = null_request.OriginalInputs();
+  const auto& inputs = request.OriginalInputs();
+  if (null_inputs.size() != inputs.size()) {
+    return false;
+  }
+
+  for (const auto& pr : inputs) {
+    const auto itr = null_inputs.find(pr.first);
+    if ((itr == null_inputs.end()) ||
+        (itr->second.DType() != pr.second.DType()) ||
+        (itr->second.Shape() != pr.second.Shape())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 }  // namespace
 
 Status
@@ -349,16 +386,72 @@ SequenceBatchScheduler::Enqueue(
     return;
   }
 
-  BatcherSequenceSlot* target = nullptr;
-
   const bool seq_start =
       ((irequest->Flags() & InferRequestHeader::FLAG_SEQUENCE_START) != 0);
   const bool seq_end =
       ((irequest->Flags() & InferRequestHeader::FLAG_SEQUENCE_END) != 0);
 
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_us = TIMESPEC_TO_NANOS(now) / 1000;
+
+  SequenceShard* shard = ShardFor(correlation_id);
+
+  // Fast path: the request continues a sequence that already has an
+  // assigned sequence slot. Only the shard lock is needed so requests
+  // for independent sequences don't contend, and in particular never
+  // touch 'mu_'.
+  {
+    std::unique_lock<std::mutex> shard_lock(shard->mu_);
+    auto sb_itr = shard->seq_slots_.find(correlation_id);
+    if (sb_itr != shard->seq_slots_.end()) {
+      if (seq_start) {
+        LOG_WARNING
+            << "sequence " << correlation_id << " for model '"
+            << irequest->ModelName()
+            << "' has a conflict. The previous sequence did not end before "
+               "this sequence start. Previous sequence will be terminated "
+               "early.";
+      }
+
+      // Record the timestamp of this request for the correlation
+      // ID. The reaper thread will check to make sure that
+      // max_sequence_idle_microseconds value is not exceed for any
+      // sequence, and if it is it will release the sequence slot (if
+      // any) allocated to that sequence.
+      TouchSequence(shard, correlation_id, now_us);
+
+      const size_t batcher_idx = sb_itr->second.batcher_idx_;
+      const uint32_t seq_slot = sb_itr->second.seq_slot_;
+
+      // If the sequence is ending then stop tracking the correlation.
+      if (seq_end) {
+        shard->seq_slots_.erase(sb_itr);
+      }
+
+      shard_lock.unlock();
+
+      LOG_VERBOSE(1) << "Enqueuing CORRID " << correlation_id
+                     << " into batcher " << batcher_idx << ", sequence slot "
+                     << seq_slot << ": " << irequest->ModelName();
+
+      batchers_[batcher_idx]->Enqueue(
+          seq_slot, correlation_id, stats, irequest, response_provider,
+          OnComplete);
+      return;
+    }
+  }
+
+  // Slow path: the sequence is starting, backlogged, or was never
+  // started correctly. Take the global lock and then re-check the
+  // shard under the mu_-then-shard lock order, since another request
+  // may have raced ahead of us.
+  BatcherSequenceSlot* target = nullptr;
+
   std::unique_lock<std::mutex> lock(mu_);
+  std::unique_lock<std::mutex> shard_lock(shard->mu_);
 
-  auto sb_itr = sequence_to_batcherseqslot_map_.find(correlation_id);
+  auto sb_itr = shard->seq_slots_.find(correlation_id);
   auto bl_itr = sequence_to_backlog_map_.find(correlation_id);
 
   // If this request is not starting a new sequence its correlation ID
@@ -366,8 +459,10 @@ SequenceBatchScheduler::Enqueue(
   // or in the backlog. If it doesn't then the sequence wasn't started
   // correctly or there has been a correlation ID conflict. In either
   // case fail this request.
-  if (!seq_start && (sb_itr == sequence_to_batcherseqslot_map_.end()) &&
+  if (!seq_start && (sb_itr == shard->seq_slots_.end()) &&
       (bl_itr == sequence_to_backlog_map_.end())) {
+    shard_lock.unlock();
+    lock.unlock();
     OnComplete(Status(
         Status::Code::INVALID_ARG,
         "inference request for sequence " + std::to_string(correlation_id) +
@@ -377,17 +472,7 @@ SequenceBatchScheduler::Enqueue(
     return;
   }
 
-  // Record the timestamp of this request for the correlation ID. The
-  // reaper thread will check to make sure that
-  // max_sequence_idle_microseconds value is not exceed for any
-  // sequence, and if it is it will release the sequence slot (if any)
-  // allocated to that sequence.
-  {
-    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    uint64_t now_us = TIMESPEC_TO_NANOS(now) / 1000;
-    correlation_id_timestamps_[correlation_id] = now_us;
-  }
+  TouchSequence(shard, correlation_id, now_us);
 
   // If this request starts a new sequence but the correlation ID
   // already has an in-progress sequence then that previous sequence
@@ -397,7 +482,7 @@ SequenceBatchScheduler::Enqueue(
   // starts... as long as it has a single end. The previous sequence
   // that was not correctly ended will have its existing requests
   // handled and then the new sequence will start.
-  if (seq_start && ((sb_itr != sequence_to_batcherseqslot_map_.end()) ||
+  if (seq_start && ((sb_itr != shard->seq_slots_.end()) ||
                     (bl_itr != sequence_to_backlog_map_.end()))) {
     LOG_WARNING
         << "sequence " << correlation_id << " for model '"
@@ -407,11 +492,12 @@ SequenceBatchScheduler::Enqueue(
   }
 
   // This request already has an assigned slot...
-  if (sb_itr != sequence_to_batcherseqslot_map_.end()) {
+  if (sb_itr != shard->seq_slots_.end()) {
     target = &sb_itr->second;
   }
   // This request already has a queue in the backlog...
   else if (bl_itr != sequence_to_backlog_map_.end()) {
+    shard_lock.unlock();
     LOG_VERBOSE(1) << "Enqueuing CORRID " << correlation_id
                    << " into existing backlog: " << irequest->ModelName();
 
@@ -431,12 +517,14 @@ SequenceBatchScheduler::Enqueue(
   // slot. By the above checks it must be starting. If there is a free
   // sequence slot available then assign this sequence to that slot...
   else if (!ready_batcher_seq_slots_.empty()) {
-    target = &sequence_to_batcherseqslot_map_[correlation_id];
+    target = &shard->seq_slots_[correlation_id];
     *target = ready_batcher_seq_slots_.top();
     ready_batcher_seq_slots_.pop();
   }
   // Last option is to assign this request to the backlog...
   else {
+    shard_lock.unlock();
+
     LOG_VERBOSE(1) << "Enqueuing CORRID " << correlation_id
                    << " into new backlog: " << irequest->ModelName();
 
@@ -458,11 +546,12 @@ SequenceBatchScheduler::Enqueue(
   // slot. If the sequence is ending then stop tracking the
   // correlation.
   if (seq_end) {
-    sequence_to_batcherseqslot_map_.erase(correlation_id);
+    shard->seq_slots_.erase(correlation_id);
   }
 
   // Enqueue request into batcher and sequence slot.  Don't hold the
-  // lock while enqueuing in a specific batcher.
+  // locks while enqueuing in a specific batcher.
+  shard_lock.unlock();
   lock.unlock();
 
   LOG_VERBOSE(1) << "Enqueuing CORRID " << correlation_id << " into batcher "
@@ -475,9 +564,15 @@ SequenceBatchScheduler::Enqueue(
 
 CorrelationID
 SequenceBatchScheduler::ReleaseSequenceSlot(
+    const CorrelationID ending_correlation_id,
     const BatcherSequenceSlot& batcher_seq_slot,
     std::deque<Scheduler::Payload>* payloads)
 {
+  // The ending sequence no longer needs its explicit state.
+  if ((state_cache_ != nullptr) && (ending_correlation_id != 0)) {
+    state_cache_->Release(ending_correlation_id);
+  }
+
   std::unique_lock<std::mutex> lock(mu_);
 
   // If there is a backlogged sequence and it is requested, return it
@@ -498,18 +593,21 @@ SequenceBatchScheduler::ReleaseSequenceSlot(
       const bool seq_end =
           ((irequest->Flags() & InferRequestHeader::FLAG_SEQUENCE_END) != 0);
       if (!seq_end) {
+        SequenceShard* shard = ShardFor(correlation_id);
+        std::lock_guard<std::mutex> shard_lock(shard->mu_);
+
         // Since the correlation ID is being actively collected in the
         // backlog, there should not be any in-flight sequences with
         // that same correlation ID that have an assigned slot.
-        if (sequence_to_batcherseqslot_map_.find(correlation_id) !=
-            sequence_to_batcherseqslot_map_.end()) {
+        if (shard->seq_slots_.find(correlation_id) !=
+            shard->seq_slots_.end()) {
           LOG_ERROR << "internal: backlog sequence " << correlation_id
                     << " conflicts with in-flight sequence for model '"
                     << irequest->ModelName() << "'";
         }
 
         sequence_to_backlog_map_.erase(correlation_id);
-        sequence_to_batcherseqslot_map_[correlation_id] = batcher_seq_slot;
+        shard->seq_slots_[correlation_id] = batcher_seq_slot;
       }
 
       LOG_VERBOSE(1) << "CORRID " << correlation_id << " reusing batcher "
@@ -558,6 +656,172 @@ SequenceBatchScheduler::DelayScheduler(
   return false;
 }
 
+Status
+SequenceBatchScheduler::UpdateConfig(const ModelConfig& config)
+{
+  if (!config.has_sequence_batching()) {
+    return Status(
+        Status::Code::INVALID_ARG,
+        "sequence batching is not enabled for model " + config.name());
+  }
+
+  // Forward the batcher parameters to each batcher. A failure may
+  // leave earlier batchers updated; the caller falls back to a full
+  // reload in that case which converges every batcher.
+  for (const auto& batcher : batchers_) {
+    RETURN_IF_ERROR(batcher->UpdateConfig(config));
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    max_sequence_idle_microseconds_ =
+        config.sequence_batching().max_sequence_idle_microseconds();
+  }
+
+  // Wake the reaper so the new idle timeout takes effect immediately.
+  reaper_cv_.notify_all();
+
+  return Status::Success;
+}
+
+Status
+SequenceBatchScheduler::SnapshotSequenceStates(
+    std::vector<SequenceState>* states)
+{
+  states->clear();
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_us = TIMESPEC_TO_NANOS(now) / 1000;
+
+  std::unique_lock<std::mutex> lock(mu_);
+
+  // A backlogged sequence has requests that were never delivered to
+  // the model, so its state can't be captured faithfully. The caller
+  // must let the drain quiesce the backlog first.
+  if (!backlog_queues_.empty()) {
+    return Status(
+        Status::Code::UNAVAILABLE,
+        "cannot snapshot sequence states while sequences are backlogged");
+  }
+
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> shard_lock(shard.mu_);
+    for (const auto& pr : shard.seq_slots_) {
+      SequenceState state;
+      state.correlation_id_ = pr.first;
+
+      // Record the idle age rather than the timestamp so that the
+      // snapshot is meaningful on another host.
+      const auto ts_itr = shard.timestamps_.find(pr.first);
+      state.idle_microseconds_ =
+          ((ts_itr == shard.timestamps_.end()) ||
+           (ts_itr->second->second > now_us))
+              ? 0
+              : (now_us - ts_itr->second->second);
+
+      if (state_snapshot_fn_ != nullptr) {
+        RETURN_IF_ERROR(
+            state_snapshot_fn_(pr.first, &state.backend_state_));
+      }
+
+      states->emplace_back(std::move(state));
+    }
+  }
+
+  return Status::Success;
+}
+
+Status
+SequenceBatchScheduler::RestoreSequenceStates(
+    const std::vector<SequenceState>& states)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_us = TIMESPEC_TO_NANOS(now) / 1000;
+
+  // Restore the most-idle sequences first so that the expiration
+  // order maintained by TouchSequence() is preserved.
+  std::vector<const SequenceState*> ordered;
+  ordered.reserve(states.size());
+  for (const auto& state : states) {
+    ordered.push_back(&state);
+  }
+  std::sort(
+      ordered.begin(), ordered.end(),
+      [](const SequenceState* a, const SequenceState* b) {
+        return a->idle_microseconds_ > b->idle_microseconds_;
+      });
+
+  std::unique_lock<std::mutex> lock(mu_);
+
+  if (ready_batcher_seq_slots_.size() < states.size()) {
+    return Status(
+        Status::Code::UNAVAILABLE,
+        "insufficient free sequence slots to restore " +
+            std::to_string(states.size()) + " sequences, " +
+            std::to_string(ready_batcher_seq_slots_.size()) + " available");
+  }
+
+  for (const SequenceState* state : ordered) {
+    const CorrelationID correlation_id = state->correlation_id_;
+    SequenceShard* shard = ShardFor(correlation_id);
+    std::lock_guard<std::mutex> shard_lock(shard->mu_);
+
+    if ((shard->seq_slots_.find(correlation_id) !=
+         shard->seq_slots_.end()) ||
+        (sequence_to_backlog_map_.find(correlation_id) !=
+         sequence_to_backlog_map_.end())) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "sequence " + std::to_string(correlation_id) +
+              " is already active, cannot restore");
+    }
+
+    // Hand the backend its state for the sequence before any request
+    // of the sequence can be scheduled.
+    if ((state_restore_fn_ != nullptr) && !state->backend_state_.empty()) {
+      RETURN_IF_ERROR(
+          state_restore_fn_(correlation_id, state->backend_state_));
+    }
+
+    BatcherSequenceSlot* target = &shard->seq_slots_[correlation_id];
+    *target = ready_batcher_seq_slots_.top();
+    ready_batcher_seq_slots_.pop();
+
+    // Preserve the idle accounting so a migrated sequence that was
+    // already near its idle timeout still expires on time.
+    const uint64_t last_us = (state->idle_microseconds_ > now_us)
+                                 ? 0
+                                 : (now_us - state->idle_microseconds_);
+    TouchSequence(shard, correlation_id, last_us);
+
+    LOG_VERBOSE(1) << "Restored CORRID " << correlation_id << " into batcher "
+                   << target->batcher_idx_ << ", sequence slot "
+                   << target->seq_slot_;
+  }
+
+  // Wake the reaper to pick up the restored idle timestamps.
+  reaper_cv_.notify_all();
+
+  return Status::Success;
+}
+
+void
+SequenceBatchScheduler::TouchSequence(
+    SequenceShard* shard, const CorrelationID correlation_id,
+    const uint64_t now_us)
+{
+  auto ts_itr = shard->timestamps_.find(correlation_id);
+  if (ts_itr != shard->timestamps_.end()) {
+    ts_itr->second->second = now_us;
+    shard->lru_.splice(shard->lru_.end(), shard->lru_, ts_itr->second);
+  } else {
+    shard->lru_.emplace_back(correlation_id, now_us);
+    shard->timestamps_[correlation_id] = std::prev(shard->lru_.end());
+  }
+}
+
 void
 SequenceBatchScheduler::ReaperThread(const int nice)
 {
@@ -583,50 +847,62 @@ SequenceBatchScheduler::ReaperThread(const int nice)
       clock_gettime(CLOCK_MONOTONIC, &now);
       uint64_t now_us = TIMESPEC_TO_NANOS(now) / 1000;
 
-      for (auto cid_itr = correlation_id_timestamps_.cbegin();
-           cid_itr != correlation_id_timestamps_.cend();) {
-        int64_t remaining_microseconds =
-            (int64_t)max_sequence_idle_microseconds_ -
-            (now_us - cid_itr->second);
-        if (remaining_microseconds > 0) {
-          wait_microseconds =
-              std::min(wait_microseconds, (uint64_t)remaining_microseconds + 1);
-          ++cid_itr;
-          continue;
-        }
+      // Visit the shards one at a time so that at any moment at most
+      // one shard is blocked from the fast enqueue path. Each shard
+      // keeps its sequences in last-seen order, so expired sequences
+      // are popped from the front until the first unexpired one: work
+      // is proportional to the number of expired sequences, not the
+      // number of live ones, and the front of the list gives the
+      // exact next expiration to sleep until.
+      for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> shard_lock(shard.mu_);
+
+        while (!shard.lru_.empty()) {
+          const CorrelationID idle_correlation_id = shard.lru_.front().first;
+          int64_t remaining_microseconds =
+              (int64_t)max_sequence_idle_microseconds_ -
+              (now_us - shard.lru_.front().second);
+          if (remaining_microseconds > 0) {
+            wait_microseconds = std::min(
+                wait_microseconds, (uint64_t)remaining_microseconds + 1);
+            break;
+          }
+
+          LOG_VERBOSE(1) << "Reaper: CORRID " << idle_correlation_id
+                         << ": max sequence idle exceeded";
+
+          auto idle_sb_itr = shard.seq_slots_.find(idle_correlation_id);
 
-        const CorrelationID idle_correlation_id = cid_itr->first;
-        LOG_VERBOSE(1) << "Reaper: CORRID " << idle_correlation_id
-                       << ": max sequence idle exceeded";
-
-        auto idle_sb_itr =
-            sequence_to_batcherseqslot_map_.find(idle_correlation_id);
-
-        // If the idle correlation ID has an assigned sequence slot,
-        // then release that assignment so it becomes available for
-        // another sequence. Release is done by enqueuing and must be
-        // done outside the lock, so just collect needed info here.
-        if (idle_sb_itr != sequence_to_batcherseqslot_map_.end()) {
-          force_end_sequences[idle_correlation_id] = idle_sb_itr->second;
-
-          sequence_to_batcherseqslot_map_.erase(idle_correlation_id);
-          cid_itr = correlation_id_timestamps_.erase(cid_itr);
-        } else {
-          // If the idle correlation ID is in the backlog, then just
-          // need to increase the timeout so that we revisit it again in
-          // the future to check if it is assigned to a sequence slot.
+          // If the idle correlation ID has an assigned sequence slot,
+          // then release that assignment so it becomes available for
+          // another sequence. Release is done by enqueuing and must be
+          // done outside the lock, so just collect needed info here.
+          if (idle_sb_itr != shard.seq_slots_.end()) {
+            force_end_sequences[idle_correlation_id] = idle_sb_itr->second;
+
+            shard.seq_slots_.erase(idle_correlation_id);
+            shard.timestamps_.erase(idle_correlation_id);
+            shard.lru_.pop_front();
+            continue;
+          }
+
+          // If the idle correlation ID is in the backlog, leave it at
+          // the front and revisit shortly to check if it has been
+          // assigned a sequence slot. Reaping of anything behind it is
+          // delayed by at most the same revisit interval.
           auto idle_bl_itr = sequence_to_backlog_map_.find(idle_correlation_id);
           if (idle_bl_itr != sequence_to_backlog_map_.end()) {
             LOG_VERBOSE(1) << "Reaper: found idle CORRID "
                            << idle_correlation_id;
             wait_microseconds =
                 std::min(wait_microseconds, backlog_idle_wait_microseconds);
-            ++cid_itr;
-          } else {
-            LOG_VERBOSE(1) << "Reaper: ignoring stale idle CORRID "
-                           << idle_correlation_id;
-            cid_itr = correlation_id_timestamps_.erase(cid_itr);
+            break;
           }
+
+          LOG_VERBOSE(1) << "Reaper: ignoring stale idle CORRID "
+                         << idle_correlation_id;
+          shard.timestamps_.erase(idle_correlation_id);
+          shard.lru_.pop_front();
         }
       }
     }
@@ -800,6 +1076,46 @@ SequenceBatch::SetControlTensors(
   }
 }
 
+void
+SequenceBatch::SetStateTensors(
+    const std::shared_ptr<InferenceRequest>& irequest,
+    const std::shared_ptr<InferResponseProvider>& response_provider,
+    const bool not_ready)
+{
+  SequenceStateCache* cache = base_->StateCache();
+  if (cache == nullptr) {
+    return;
+  }
+
+  std::shared_ptr<SequenceStates> states;
+  Status status;
+  if (not_ready) {
+    // A null request must still carry the state input tensors. The
+    // shared zero state serves since the model can't assume the
+    // inputs of a not-ready slot are meaningful, and there is no
+    // response provider to collect the output.
+    status = cache->NullStates(&states);
+  } else {
+    const bool seq_start =
+        ((irequest->Flags() & InferRequestHeader::FLAG_SEQUENCE_START) != 0);
+    status = cache->GetOrCreate(irequest->CorrelationId(), seq_start, &states);
+  }
+
+  if (!status.IsOk()) {
+    LOG_ERROR << "failed to get sequence state for CORRID "
+              << irequest->CorrelationId() << ": " << status.Message();
+    return;
+  }
+
+  for (const auto& tensor : states->Tensors()) {
+    irequest->AddOverrideInput(tensor.input_override_);
+    if (response_provider != nullptr) {
+      response_provider->AddInternalOutputBuffer(
+          tensor.output_name_, tensor.output_memory_);
+    }
+  }
+}
+
 DirectSequenceBatch::DirectSequenceBatch(
     SequenceBatchScheduler* base, const uint32_t batcher_idx,
     const size_t seq_slot_cnt, const ModelConfig& config,
@@ -890,8 +1206,13 @@ DirectSequenceBatch::Enqueue(
 
     // If runner is idle then wake it to service this request. We do
     // the actual wake outside of the lock to avoid having the woken
-    // thread immediately block on the lock
+    // thread immediately block on the lock. Clearing the idle flag
+    // here coalesces the wakes: other requests enqueued before the
+    // runner actually wakes see the flag already cleared and skip the
+    // redundant notify, so at most one wake syscall is made per idle
+    // period.
     wake_runner = scheduler_idle_;
+    scheduler_idle_ = false;
   }
 
   if (wake_runner) {
@@ -912,6 +1233,8 @@ DirectSequenceBatch::SchedulerThread(
                    << nice << " failed)...";
   }
 
+  BindThreadToAffinityPool(AffinityPool::SCHEDULER);
+
   // Initialize using the thread. If error then just exit this thread
   // now... that means the corresponding model instance will not have
   // any runner and so will not get used for execution.
@@ -958,6 +1281,7 @@ DirectSequenceBatch::SchedulerThread(
 
   while (!scheduler_thread_exit_) {
     auto payloads = std::make_shared<std::vector<Scheduler::Payload>>();
+    std::vector<Scheduler::Payload> cancelled_payloads;
     uint64_t wait_microseconds = default_wait_microseconds;
 
     // Hold the lock for as short a time as possible.
@@ -1005,8 +1329,31 @@ DirectSequenceBatch::SchedulerThread(
 
               SequenceBatchScheduler::BatcherSequenceSlot batcher_seq_slot(
                   batcher_idx_, seq_slot);
-              seq_slot_correlation_ids_[seq_slot] =
-                  base_->ReleaseSequenceSlot(batcher_seq_slot, &queue);
+              seq_slot_correlation_ids_[seq_slot] = base_->ReleaseSequenceSlot(
+                  seq_slot_correlation_ids_[seq_slot], batcher_seq_slot,
+                  &queue);
+            } else if (queue.front().request_->IsCancelled()) {
+              // The client that issued the sequence is gone, so the
+              // rest of the sequence will never arrive or matter.
+              // Drop every queued payload of the sequence and release
+              // the slot early for a sequence from the backlog. The
+              // payloads are completed outside the lock.
+              LOG_VERBOSE(1) << "cancelled sequence CORRID "
+                             << seq_slot_correlation_ids_[seq_slot]
+                             << " in batcher " << batcher_idx_ << ", slot "
+                             << seq_slot;
+              while (!queue.empty()) {
+                if (queue.front().request_ != nullptr) {
+                  cancelled_payloads.emplace_back(std::move(queue.front()));
+                }
+                queue.pop_front();
+              }
+
+              SequenceBatchScheduler::BatcherSequenceSlot batcher_seq_slot(
+                  batcher_idx_, seq_slot);
+              seq_slot_correlation_ids_[seq_slot] = base_->ReleaseSequenceSlot(
+                  seq_slot_correlation_ids_[seq_slot], batcher_seq_slot,
+                  &queue);
             }
           }
 
@@ -1021,17 +1368,30 @@ DirectSequenceBatch::SchedulerThread(
             // this null request will have the correct shape for any
             // created batch.
             if (null_irequest == nullptr) {
-              null_irequest =
-                  std::make_shared<InferenceRequest>(*queue.front().request_);
-
-              // Note that when the not-ready control input of the
-              // request is "true" the model can't assume that any
-              // other inputs are meaningful, including CORRID. So we
-              // just use zero for that and use whatever values the
-              // other inputs have in request_.
-              SetControlTensors(
-                  null_irequest, seq_slot, 0 /* corrid */,
-                  true /* not_ready */);
+              // Reuse the null request from the previous execution
+              // when the input shapes still match, avoiding a request
+              // copy per batch. The control tensors and not-ready
+              // state of a cached null request are already set.
+              if ((cached_null_irequest_ == nullptr) ||
+                  !NullRequestCompatible(
+                      *cached_null_irequest_, *queue.front().request_)) {
+                cached_null_irequest_ = std::make_shared<InferenceRequest>(
+                    *queue.front().request_);
+
+                // Note that when the not-ready control input of the
+                // request is "true" the model can't assume that any
+                // other inputs are meaningful, including CORRID. So we
+                // just use zero for that and use whatever values the
+                // other inputs have in request_.
+                SetControlTensors(
+                    cached_null_irequest_, seq_slot, 0 /* corrid */,
+                    true /* not_ready */);
+                SetStateTensors(
+                    cached_null_irequest_, nullptr /* response_provider */,
+                    true /* not_ready */);
+              }
+
+              null_irequest = cached_null_irequest_;
             }
 
             // If this is the first non-null payload capture the
@@ -1092,6 +1452,7 @@ DirectSequenceBatch::SchedulerThread(
             // Set the control tensor values in the request.
             SetControlTensors(
                 irequest, seq_slot, seq_slot_correlation_ids_[seq_slot]);
+            SetStateTensors(irequest, seq_slot_payload.response_provider_);
 
             payloads->emplace_back(
                 seq_slot_payload.stats_, irequest,
@@ -1128,8 +1489,8 @@ DirectSequenceBatch::SchedulerThread(
 
             SequenceBatchScheduler::BatcherSequenceSlot batcher_seq_slot(
                 batcher_idx_, seq_slot);
-            seq_slot_correlation_ids_[seq_slot] =
-                base_->ReleaseSequenceSlot(batcher_seq_slot, &queue);
+            seq_slot_correlation_ids_[seq_slot] = base_->ReleaseSequenceSlot(
+                seq_slot_correlation_ids_[seq_slot], batcher_seq_slot, &queue);
           }
         }
       }
@@ -1151,6 +1512,17 @@ DirectSequenceBatch::SchedulerThread(
       }
     }
 
+    // Finish cancelled payloads if any
+    if (!cancelled_payloads.empty()) {
+      static Status cancelled_status =
+          Status(Status::Code::UNAVAILABLE, "Request cancelled by client");
+      for (auto& cancelled_payload : cancelled_payloads) {
+        if (cancelled_payload.complete_function_ != nullptr) {
+          cancelled_payload.complete_function_(cancelled_status);
+        }
+      }
+    }
+
     if ((payloads != nullptr) && !payloads->empty()) {
       auto OnCompleteQueuedPayloads = [payloads](const Status& rstatus) {
         // Payloads that don't have a completion function don't have
@@ -1248,7 +1620,8 @@ OldestSequenceBatch::OldestSequenceBatch(
           base, batcher_idx, seq_slot_cnt, enforce_equal_shape_tensors,
           start_input_overrides, end_input_overrides, startend_input_overrides,
           continue_input_overrides, notready_input_overrides),
-      in_flight_(seq_slot_cnt, false), queues_(seq_slot_cnt)
+      in_flight_(seq_slot_cnt, false),
+      seq_slot_correlation_ids_(seq_slot_cnt, 0), queues_(seq_slot_cnt)
 {
   // Initialize to handle CORRID control. If error just exit
   // now... that means the corresponding model instance will not have
@@ -1272,7 +1645,10 @@ OldestSequenceBatch::OldestSequenceBatch(
       enforce_equal_shape_tensors_, true /* preserve_ordering */,
       preferred_batch_sizes,
       config.sequence_batching().oldest().max_queue_delay_microseconds(),
-      &dynamic_batcher_);
+      1 /* min_active_runner_cnt */,
+      0 /* scale_to_zero_idle_microseconds */,
+      Scheduler::StandardReleaseFunc() /* OnRelease */,
+      nullptr /* metric_reporter */, &dynamic_batcher_);
   if (!status.IsOk()) {
     LOG_ERROR << "failed creating dynamic sequence batcher for OldestFirst "
               << batcher_idx_ << ": " << status.Message();
@@ -1285,6 +1661,19 @@ OldestSequenceBatch::OldestSequenceBatch(
 
 OldestSequenceBatch::~OldestSequenceBatch() {}
 
+Status
+OldestSequenceBatch::UpdateConfig(const ModelConfig& config)
+{
+  if (dynamic_batcher_ == nullptr) {
+    return Status(
+        Status::Code::UNAVAILABLE,
+        "no dynamic batcher for OldestFirst sequence batcher " +
+            std::to_string(batcher_idx_));
+  }
+
+  return dynamic_batcher_->UpdateConfig(config);
+}
+
 void
 OldestSequenceBatch::CompleteAndNext(
     const uint32_t seq_slot, std::function<void(const Status&)> OnComplete,
@@ -1328,8 +1717,30 @@ OldestSequenceBatch::CompleteAndNext(
         LOG_VERBOSE(1) << "force-end sequence in batcher " << batcher_idx_
                        << ", slot " << seq_slot;
         release_seq_slot = true;
+      } else if (irequest->IsCancelled()) {
+        // The client that issued the sequence is gone. Complete the
+        // queued payloads of the sequence without executing them and
+        // release the slot early for a backlogged sequence.
+        LOG_VERBOSE(1) << "cancelled sequence CORRID "
+                       << irequest->CorrelationId() << " in batcher "
+                       << batcher_idx_ << ", slot " << seq_slot;
+        static Status cancelled_status =
+            Status(Status::Code::UNAVAILABLE, "Request cancelled by client");
+        while (queue.size() > 1) {
+          Scheduler::Payload& next = queue.back();
+          if ((next.request_ != nullptr) &&
+              (next.complete_function_ != nullptr)) {
+            next.complete_function_(cancelled_status);
+          }
+          queue.pop_back();
+        }
+        if (payload.complete_function_ != nullptr) {
+          payload.complete_function_(cancelled_status);
+        }
+        release_seq_slot = true;
       } else {
         const CorrelationID correlation_id = irequest->CorrelationId();
+        seq_slot_correlation_ids_[seq_slot] = correlation_id;
 
         // After handling the last inference in a sequence we must
         // release the sequence slot to make it available to another
@@ -1343,6 +1754,7 @@ OldestSequenceBatch::CompleteAndNext(
 
         // Add the appropriate control tensor values to the request.
         SetControlTensors(irequest, seq_slot, correlation_id);
+        SetStateTensors(irequest, payload.response_provider_);
 
         LOG_VERBOSE(1) << "issue to dynamic batcher CORRID " << correlation_id
                        << " in batcher " << batcher_idx_ << ", slot "
@@ -1374,8 +1786,9 @@ OldestSequenceBatch::CompleteAndNext(
 
       SequenceBatchScheduler::BatcherSequenceSlot batcher_seq_slot(
           batcher_idx_, seq_slot);
-      const CorrelationID released_cid =
-          base_->ReleaseSequenceSlot(batcher_seq_slot, &queue);
+      const CorrelationID released_cid = base_->ReleaseSequenceSlot(
+          seq_slot_correlation_ids_[seq_slot], batcher_seq_slot, &queue);
+      seq_slot_correlation_ids_[seq_slot] = released_cid;
       if (released_cid != 0) {
         LOG_VERBOSE(1) << "Enqueued new sequence containing " << queue.size()
                        << " requests into OldestFirst batcher " << batcher_idx_
@@ -26,10 +26,12 @@
 #pragma once
 
 #include <sys/time.h>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <future>
+#include <list>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -39,6 +41,7 @@
 #include "src/core/provider.h"
 #include "src/core/scheduler.h"
 #include "src/core/scheduler_utils.h"
+#include "src/core/sequence_states.h"
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -71,6 +74,35 @@ class SequenceBatchScheduler : public Scheduler {
       const std::shared_ptr<InferResponseProvider>& response_provider,
       std::function<void(const Status&)> OnComplete) override;
 
+  // \see Scheduler::UpdateConfig()
+  Status UpdateConfig(const ModelConfig& config) override;
+
+  // \see Scheduler::SnapshotSequenceStates()
+  Status SnapshotSequenceStates(
+      std::vector<SequenceState>* states) override;
+
+  // \see Scheduler::RestoreSequenceStates()
+  Status RestoreSequenceStates(
+      const std::vector<SequenceState>& states) override;
+
+  // The prototype for the functions used to capture and restore the
+  // per-sequence backend state during sequence migration. A backend
+  // that keeps explicit per-sequence state registers these; without
+  // them a snapshot carries only the scheduler bookkeeping.
+  using SequenceStateSnapshotFunc =
+      std::function<Status(const CorrelationID correlation_id, std::string*)>;
+  using SequenceStateRestoreFunc = std::function<Status(
+      const CorrelationID correlation_id, const std::string&)>;
+
+  // Register the backend state capture/restore functions.
+  void SetSequenceStateFns(
+      const SequenceStateSnapshotFunc& snapshot_fn,
+      const SequenceStateRestoreFunc& restore_fn)
+  {
+    state_snapshot_fn_ = snapshot_fn;
+    state_restore_fn_ = restore_fn;
+  }
+
   // A batcher-sequence_slot combination. The batcher is represented
   // by the index into 'batchers_'.
   struct BatcherSequenceSlot {
@@ -83,7 +115,11 @@ class SequenceBatchScheduler : public Scheduler {
 
   // Fill a sequence slot with a sequence from the backlog or show
   // that the sequence slot is no longer being used.
+  // 'ending_correlation_id' is the correlation ID of the sequence
+  // vacating the slot, or zero if not known; its explicit state, if
+  // any, is released.
   CorrelationID ReleaseSequenceSlot(
+      const CorrelationID ending_correlation_id,
       const BatcherSequenceSlot& seq_slot,
       std::deque<Scheduler::Payload>* payloads);
 
@@ -92,6 +128,10 @@ class SequenceBatchScheduler : public Scheduler {
   bool DelayScheduler(
       const uint32_t batcher_idx, const size_t cnt, const size_t total);
 
+  // The explicit sequence-state cache for the model, or nullptr if
+  // the model declares no state tensors.
+  SequenceStateCache* StateCache() { return state_cache_.get(); }
+
  private:
   void ReaperThread(const int nice);
 
@@ -115,7 +155,10 @@ class SequenceBatchScheduler : public Scheduler {
   // The max_sequence_idle_microseconds value for this scheduler.
   uint64_t max_sequence_idle_microseconds_;
 
-  // Mutex
+  // Mutex protecting the cross-sequence state: the backlog and the
+  // ready sequence slots. The correlation-ID indexed state lives in
+  // 'shards_' under per-shard locks. When both are needed 'mu_' is
+  // always acquired before a shard lock.
   std::mutex mu_;
 
   // The reaper thread
@@ -126,11 +169,46 @@ class SequenceBatchScheduler : public Scheduler {
   // The SequenceBatchs being managed by this scheduler.
   std::vector<std::shared_ptr<SequenceBatch>> batchers_;
 
-  // Map from a request's correlation ID to the BatcherSequenceSlot
-  // assigned to that correlation ID.
   using BatcherSequenceSlotMap =
       std::unordered_map<CorrelationID, BatcherSequenceSlot>;
-  BatcherSequenceSlotMap sequence_to_batcherseqslot_map_;
+
+  // The correlation-ID indexed state, sharded by a hash of the
+  // correlation ID so that requests continuing independent in-flight
+  // sequences take different locks and never contend. Each shard
+  // holds the slot assignment and idle tracking for the correlation
+  // IDs hashing to it.
+  //
+  // Because every sequence shares the same idle timeout, keeping the
+  // sequences ordered by the timestamp of their most recent request
+  // is also expiration order: the reaper pops expired sequences from
+  // the front of 'lru_' and stops at the first unexpired one, making
+  // reaping O(expired) instead of a scan of every live sequence.
+  struct SequenceShard {
+    std::mutex mu_;
+    BatcherSequenceSlotMap seq_slots_;
+
+    // Sequences in last-seen order, oldest at the front, with the
+    // timestamp, in microseconds, of the most recent request.
+    std::list<std::pair<CorrelationID, uint64_t>> lru_;
+    std::unordered_map<
+        CorrelationID, std::list<std::pair<CorrelationID, uint64_t>>::iterator>
+        timestamps_;
+  };
+
+  SequenceShard* ShardFor(const CorrelationID correlation_id)
+  {
+    return &shards_[correlation_id % kSequenceShardCount];
+  }
+
+  // Record a request for 'correlation_id' at 'now_us', moving the
+  // sequence to the back of the shard's expiration order. Caller must
+  // hold the shard lock.
+  void TouchSequence(
+      SequenceShard* shard, const CorrelationID correlation_id,
+      const uint64_t now_us);
+
+  static constexpr size_t kSequenceShardCount = 16;
+  std::array<SequenceShard, kSequenceShardCount> shards_;
 
   // Map from a request's correlation ID to the backlog queue
   // collecting requests for that correlation ID.
@@ -150,9 +228,14 @@ class SequenceBatchScheduler : public Scheduler {
       BatcherSequenceSlotCompare>
       ready_batcher_seq_slots_;
 
-  // For each correlation ID the most recently seen timestamp, in
-  // microseconds, for a request using that correlation ID.
-  std::unordered_map<CorrelationID, uint64_t> correlation_id_timestamps_;
+  // Functions used to capture and restore per-sequence backend state
+  // during sequence migration. May be nullptr.
+  SequenceStateSnapshotFunc state_snapshot_fn_;
+  SequenceStateRestoreFunc state_restore_fn_;
+
+  // The explicit sequence-state cache, created only when the model
+  // configuration declares state tensors.
+  std::shared_ptr<SequenceStateCache> state_cache_;
 
   // Used for debugging/testing.
   size_t backlog_delay_cnt_;
@@ -188,12 +271,29 @@ class SequenceBatch {
       const std::shared_ptr<InferResponseProvider>& response_provider,
       std::function<void(const Status&)> OnComplete) = 0;
 
+  // Update any hot-swappable batcher parameters from 'config'. The
+  // default implementation has no such parameters.
+  virtual Status UpdateConfig(const ModelConfig& config)
+  {
+    return Status::Success;
+  }
+
  protected:
   bool CreateCorrelationIDControl(const ModelConfig& config);
   void SetControlTensors(
       const std::shared_ptr<InferenceRequest>& irequest, const int32_t seq_slot,
       const CorrelationID corr_id, const bool not_ready = false);
 
+  // Attach the explicit-state input overrides to 'irequest' and
+  // register collection of the state outputs with
+  // 'response_provider'. No-op if the model declares no state
+  // tensors. With 'not_ready' a shared zero state is attached and no
+  // output is collected, for the null requests that pad a batch.
+  void SetStateTensors(
+      const std::shared_ptr<InferenceRequest>& irequest,
+      const std::shared_ptr<InferResponseProvider>& response_provider,
+      const bool not_ready = false);
+
   // The controlling scheduler.
   SequenceBatchScheduler* const base_;
 
@@ -304,6 +404,12 @@ class DirectSequenceBatch : public SequenceBatch {
   // The maximum active sequence slot. A value of -1 indicates that
   // no slots are active in the backend.
   int32_t max_active_seq_slot_;
+
+  // The null request used to fill idle sequence slots in a batch,
+  // reused across executions as long as the representative request's
+  // inputs keep the same shapes. Rebuilding it per execution caused a
+  // request copy, with all its input map churn, on every batch.
+  std::shared_ptr<InferenceRequest> cached_null_irequest_;
 };
 
 // Scheduler that implements the oldest-first sequence scheduling
@@ -340,6 +446,9 @@ class OldestSequenceBatch : public SequenceBatch {
       const std::shared_ptr<InferResponseProvider>& response_provider,
       std::function<void(const Status&)> OnComplete) override;
 
+  // \see SequenceBatch::UpdateConfig()
+  Status UpdateConfig(const ModelConfig& config) override;
+
  private:
   void CompleteAndNext(
       const uint32_t seq_slot, std::function<void(const Status&)> OnComplete,
@@ -356,6 +465,12 @@ class OldestSequenceBatch : public SequenceBatch {
   // most one request from each sequence can be scheduled at a time.
   std::vector<bool> in_flight_;
 
+  // For each sequence slot the correlation ID of the sequence
+  // currently assigned to it, or zero. Needed to release the explicit
+  // state of a sequence that is force-ended by the reaper, since the
+  // null marker request carries no correlation ID.
+  std::vector<CorrelationID> seq_slot_correlation_ids_;
+
   // Queues holding inference requests. There are 'seq_slot_cnt'
   // queues, one for each sequence slot where requests assigned to
   // that slot are enqueued to wait for inferencing.
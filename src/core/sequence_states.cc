@@ -0,0 +1,209 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/sequence_states.h"
+
+#include <string.h>
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// Default bound for the per-model sequence state cache, 256MB.
+constexpr uint64_t kDefaultStateCacheByteSize = 256 * 1024 * 1024;
+
+}  // namespace
+
+Status
+SequenceStates::Create(
+    const ModelSequenceBatching& batcher_config,
+    std::shared_ptr<SequenceStates>* states)
+{
+  auto lstates = std::make_shared<SequenceStates>();
+
+  for (const auto& state : batcher_config.state()) {
+    const int64_t byte_size = GetByteSize(state.data_type(), state.dims());
+    if (byte_size <= 0) {
+      return Status(
+          Status::Code::INVALID_ARG,
+          "unable to determine byte size for sequence state '" +
+              state.input_name() + "'");
+    }
+
+    StateTensor tensor;
+    tensor.input_name_ = state.input_name();
+    tensor.output_name_ = state.output_name();
+
+    // Prefer pinned memory so feeding GPU models doesn't pay a
+    // staging copy; AllocatedMemory falls back to system memory.
+    tensor.input_memory_ = std::make_shared<AllocatedMemory>(
+        byte_size, TRTSERVER_MEMORY_CPU_PINNED, 0);
+    tensor.output_memory_ = std::make_shared<AllocatedMemory>(
+        byte_size, TRTSERVER_MEMORY_CPU_PINNED, 0);
+    if ((tensor.input_memory_->TotalByteSize() == 0) ||
+        (tensor.output_memory_->TotalByteSize() == 0)) {
+      return Status(
+          Status::Code::INTERNAL,
+          "failed to allocate buffers for sequence state '" +
+              state.input_name() + "'");
+    }
+
+    std::vector<int64_t> dims;
+    for (const auto dim : state.dims()) {
+      dims.push_back(dim);
+    }
+
+    tensor.input_override_ = std::make_shared<InferenceRequest::Input>(
+        state.input_name(), state.data_type(), dims, byte_size);
+    *tensor.input_override_->MutableShape() =
+        tensor.input_override_->OriginalShape();
+    RETURN_IF_ERROR(tensor.input_override_->SetData(tensor.input_memory_));
+
+    lstates->tensors_.emplace_back(std::move(tensor));
+  }
+
+  lstates->Reset();
+  *states = std::move(lstates);
+
+  return Status::Success;
+}
+
+void
+SequenceStates::Reset()
+{
+  for (auto& tensor : tensors_) {
+    memset(
+        tensor.input_memory_->MutableBuffer(), 0,
+        tensor.input_memory_->TotalByteSize());
+  }
+}
+
+void
+SequenceStates::Advance()
+{
+  for (auto& tensor : tensors_) {
+    std::swap(tensor.input_memory_, tensor.output_memory_);
+    tensor.input_override_->RemoveAllData();
+    tensor.input_override_->SetData(tensor.input_memory_);
+  }
+}
+
+SequenceStateCache::SequenceStateCache(
+    const ModelSequenceBatching& batcher_config, const uint64_t max_byte_size)
+    : batcher_config_(batcher_config), sequence_byte_size_(0),
+      max_byte_size_(
+          (max_byte_size == 0) ? kDefaultStateCacheByteSize : max_byte_size),
+      allocated_byte_size_(0)
+{
+  for (const auto& state : batcher_config.state()) {
+    const int64_t byte_size = GetByteSize(state.data_type(), state.dims());
+    if (byte_size > 0) {
+      // Both halves of the double buffer.
+      sequence_byte_size_ += 2 * byte_size;
+    }
+  }
+}
+
+Status
+SequenceStateCache::GetOrCreate(
+    const CorrelationID correlation_id, const bool start,
+    std::shared_ptr<SequenceStates>* states)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+
+  auto itr = states_.find(correlation_id);
+  if (itr != states_.end()) {
+    if (start) {
+      // The previous sequence with this correlation ID did not end
+      // correctly; reuse its buffers for the new sequence.
+      itr->second->Reset();
+    } else {
+      itr->second->Advance();
+    }
+
+    *states = itr->second;
+    return Status::Success;
+  }
+
+  if (!start) {
+    return Status(
+        Status::Code::INTERNAL,
+        "no state for sequence " + std::to_string(correlation_id) +
+            ", the sequence was not started");
+  }
+
+  std::shared_ptr<SequenceStates> lstates;
+  if (!free_states_.empty()) {
+    lstates = std::move(free_states_.front());
+    free_states_.pop_front();
+    lstates->Reset();
+  } else {
+    if ((allocated_byte_size_ + sequence_byte_size_) > max_byte_size_) {
+      return Status(
+          Status::Code::UNAVAILABLE,
+          "sequence state cache exhausted, " +
+              std::to_string(allocated_byte_size_) + " of " +
+              std::to_string(max_byte_size_) +
+              " bytes in use by concurrent sequences");
+    }
+
+    RETURN_IF_ERROR(SequenceStates::Create(batcher_config_, &lstates));
+    allocated_byte_size_ += sequence_byte_size_;
+  }
+
+  states_[correlation_id] = lstates;
+  *states = std::move(lstates);
+
+  return Status::Success;
+}
+
+void
+SequenceStateCache::Release(const CorrelationID correlation_id)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+
+  auto itr = states_.find(correlation_id);
+  if (itr != states_.end()) {
+    free_states_.emplace_back(std::move(itr->second));
+    states_.erase(itr);
+  }
+}
+
+Status
+SequenceStateCache::NullStates(std::shared_ptr<SequenceStates>* states)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+
+  if (null_states_ == nullptr) {
+    RETURN_IF_ERROR(SequenceStates::Create(batcher_config_, &null_states_));
+    allocated_byte_size_ += sequence_byte_size_;
+  }
+
+  *states = null_states_;
+  return Status::Success;
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,117 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "src/core/infer_request.h"
+#include "src/core/memory.h"
+#include "src/core/model_config.h"
+#include "src/core/model_config.pb.h"
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+// The server-managed explicit state of one sequence, as declared by
+// the 'state' section of the sequence-batching configuration. Each
+// state tensor is double-buffered: the model reads the state from
+// 'input_override_' while writing the state for the next step into
+// 'output_memory_'; Advance() swaps the buffers before the next step
+// is fed.
+class SequenceStates {
+ public:
+  struct StateTensor {
+    std::string input_name_;
+    std::string output_name_;
+    std::shared_ptr<MutableMemory> input_memory_;
+    std::shared_ptr<MutableMemory> output_memory_;
+    std::shared_ptr<InferenceRequest::Input> input_override_;
+  };
+
+  // Create the state buffers for one sequence as described by
+  // 'batcher_config'.
+  static Status Create(
+      const ModelSequenceBatching& batcher_config,
+      std::shared_ptr<SequenceStates>* states);
+
+  // Zero the input-side state buffers for the start of a new
+  // sequence.
+  void Reset();
+
+  // Make the state collected from the just-completed step the input
+  // state for the next step.
+  void Advance();
+
+  const std::vector<StateTensor>& Tensors() const { return tensors_; }
+
+ private:
+  std::vector<StateTensor> tensors_;
+};
+
+// A size-bounded cache of the explicit sequence states of a model,
+// keyed by correlation ID. Buffers of ended sequences are kept on a
+// free list and reused, so the number of concurrent sequences with
+// state is limited by the configured byte size and not by the number
+// of batch slots.
+class SequenceStateCache {
+ public:
+  SequenceStateCache(
+      const ModelSequenceBatching& batcher_config,
+      const uint64_t max_byte_size);
+
+  // Get the states for 'correlation_id'. With 'start' a fresh
+  // zero-initialized state is assigned to the sequence; otherwise the
+  // existing state advances to the next step. Returns an error if the
+  // cache byte-size bound does not admit another sequence.
+  Status GetOrCreate(
+      const CorrelationID correlation_id, const bool start,
+      std::shared_ptr<SequenceStates>* states);
+
+  // The sequence has ended; return its buffers to the free list.
+  void Release(const CorrelationID correlation_id);
+
+  // A shared zero-filled state used as the input override for the
+  // null requests that pad a batch. Created on first use.
+  Status NullStates(std::shared_ptr<SequenceStates>* states);
+
+ private:
+  const ModelSequenceBatching batcher_config_;
+
+  // The byte size of the buffers of one sequence.
+  uint64_t sequence_byte_size_;
+  const uint64_t max_byte_size_;
+
+  std::mutex mu_;
+  uint64_t allocated_byte_size_;
+  std::unordered_map<CorrelationID, std::shared_ptr<SequenceStates>> states_;
+  std::deque<std::shared_ptr<SequenceStates>> free_states_;
+  std::shared_ptr<SequenceStates> null_states_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -27,6 +27,7 @@
 #include "src/core/server.h"
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
 #include <algorithm>
@@ -40,15 +41,19 @@
 #include "src/core/backend.h"
 #include "src/core/constants.h"
 #include "src/core/cuda_utils.h"
+#include "src/core/infer_request.h"
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/model_config_utils.h"
 #include "src/core/model_repository_manager.h"
+#include "src/core/nvtx.h"
 #include "src/core/pinned_memory_manager.h"
+#include "src/core/probes.h"
 #include "src/core/provider.h"
 #include "src/core/server.h"
 #include "src/core/server_status.pb.h"
+#include "src/core/trtserver.h"
 
 #ifdef TRTIS_ENABLE_GPU
 #include "src/core/cuda_memory_manager.h"
@@ -73,6 +78,50 @@ class ScopedAtomicIncrement {
   std::atomic<uint64_t>& counter_;
 };
 
+// Allocator for the responses of mirrored requests. The responses
+// are discarded, so every allocation is satisfied with plain system
+// memory and simply freed on release.
+TRTSERVER_Error*
+MirrorResponseAlloc(
+    TRTSERVER_ResponseAllocator* allocator, const char* tensor_name,
+    size_t byte_size, TRTSERVER_Memory_Type preferred_memory_type,
+    int64_t preferred_memory_type_id, void* userp, void** buffer,
+    void** buffer_userp, TRTSERVER_Memory_Type* allocated_memory_type,
+    int64_t* allocated_memory_type_id)
+{
+  *buffer = (byte_size > 0) ? malloc(byte_size) : nullptr;
+  *buffer_userp = nullptr;
+  *allocated_memory_type = TRTSERVER_MEMORY_CPU;
+  *allocated_memory_type_id = 0;
+
+  return nullptr;  // Success
+}
+
+TRTSERVER_Error*
+MirrorResponseRelease(
+    TRTSERVER_ResponseAllocator* allocator, void* buffer, void* buffer_userp,
+    size_t byte_size, TRTSERVER_Memory_Type memory_type,
+    int64_t memory_type_id)
+{
+  free(buffer);
+  return nullptr;  // Success
+}
+
+TRTSERVER_ResponseAllocator*
+MirrorResponseAllocator()
+{
+  static TRTSERVER_ResponseAllocator* allocator = []() {
+    TRTSERVER_ResponseAllocator* lallocator = nullptr;
+    LOG_TRTSERVER_ERROR(
+        TRTSERVER_ResponseAllocatorNew(
+            &lallocator, MirrorResponseAlloc, MirrorResponseRelease),
+        "failed to create mirror response allocator");
+    return lallocator;
+  }();
+
+  return allocator;
+}
+
 }  // namespace
 
 //
@@ -104,6 +153,9 @@ InferenceServer::InferenceServer()
   strict_model_config_ = true;
   strict_readiness_ = true;
   exit_timeout_secs_ = 30;
+  max_inflight_requests_ = 0;
+  max_inflight_byte_size_ = 0;
+  model_load_concurrency_ = 0;
   pinned_memory_pool_size_ = 1 << 28;
 #ifdef TRTIS_ENABLE_GPU
   min_supported_compute_capability_ = TRTIS_MIN_COMPUTE_CAPABILITY;
@@ -113,9 +165,11 @@ InferenceServer::InferenceServer()
 
   tf_soft_placement_enabled_ = true;
   tf_gpu_memory_fraction_ = 0.0;
+  tf_shared_thread_pool_size_ = -1;
   tf_vgpu_memory_limits_ = {};
 
   inflight_request_counter_ = 0;
+  inflight_byte_size_counter_ = 0;
 
   status_manager_.reset(new ServerStatusManager(version_));
 }
@@ -136,6 +190,14 @@ InferenceServer::Init()
   }
 
   PinnedMemoryManager::Options options(pinned_memory_pool_size_);
+  {
+    // Opt-in huge-page backing for the pinned pool and large host
+    // staging buffers.
+    const char* hstr = getenv("TRTSERVER_PINNED_MEMORY_HUGE_PAGES");
+    if (hstr != nullptr) {
+      options.huge_pages_enabled_ = (atoi(hstr) != 0);
+    }
+  }
   status = PinnedMemoryManager::Create(options);
   if (!status.IsOk()) {
     ready_state_ = ServerReadyState::SERVER_FAILED_TO_INITIALIZE;
@@ -171,15 +233,19 @@ InferenceServer::Init()
     LOG_ERROR << status.Message();
   }
 
-  // Create the model manager for the repository. Unless model control
-  // is disabled, all models are eagerly loaded when the manager is created.
+  // Create the model manager for the repository. Unless explicit model
+  // control or lazy loading is enabled, all models are eagerly loaded
+  // when the manager is created.
   bool polling_enabled = (model_control_mode_ == MODE_POLL);
   bool model_control_enabled = (model_control_mode_ == MODE_EXPLICIT);
+  bool lazy_load_enabled = (model_control_mode_ == MODE_LAZY);
   status = ModelRepositoryManager::Create(
       this, version_, status_manager_, model_repository_paths_, startup_models_,
       strict_model_config_, tf_gpu_memory_fraction_, tf_soft_placement_enabled_,
-      tf_vgpu_memory_limits_, polling_enabled, model_control_enabled,
-      min_supported_compute_capability_, &model_repository_manager_);
+      tf_vgpu_memory_limits_, tf_shared_thread_pool_size_, polling_enabled,
+      model_control_enabled, lazy_load_enabled,
+      min_supported_compute_capability_, model_load_concurrency_,
+      &model_repository_manager_);
   if (!status.IsOk()) {
     if (model_repository_manager_ == nullptr) {
       ready_state_ = ServerReadyState::SERVER_FAILED_TO_INITIALIZE;
@@ -199,7 +265,8 @@ InferenceServer::Init()
 Status
 InferenceServer::Stop()
 {
-  if (ready_state_ != ServerReadyState::SERVER_READY) {
+  if ((ready_state_ != ServerReadyState::SERVER_READY) &&
+      (ready_state_ != ServerReadyState::SERVER_DRAINING)) {
     return Status::Success;
   }
 
@@ -250,6 +317,43 @@ InferenceServer::Stop()
       Status::Code::INTERNAL, "Exit timeout expired. Exiting immediately.");
 }
 
+Status
+InferenceServer::Drain()
+{
+  if (ready_state_ != ServerReadyState::SERVER_READY) {
+    return Status::Success;
+  }
+
+  // Once draining the readiness endpoints report not-ready and new
+  // inference requests are rejected, but the server stays live and
+  // in-flight requests run to completion. Models are not unloaded so
+  // the non-inference APIs continue to work until Stop().
+  ready_state_ = ServerReadyState::SERVER_DRAINING;
+
+  LOG_INFO << "Draining, waiting for in-flight inferences to complete.";
+
+  uint32_t drain_timeout_iters = exit_timeout_secs_;
+
+  while (true) {
+    LOG_INFO << "Timeout " << drain_timeout_iters << ": Found "
+             << inflight_request_counter_ << " in-flight requests";
+
+    if (inflight_request_counter_ == 0) {
+      return Status::Success;
+    }
+    if (drain_timeout_iters <= 0) {
+      break;
+    }
+
+    drain_timeout_iters--;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  }
+
+  return Status(
+      Status::Code::INTERNAL,
+      "Drain timeout expired with in-flight requests remaining.");
+}
+
 Status
 InferenceServer::PollModelRepository()
 {
@@ -299,30 +403,10 @@ InferenceServer::IsReady(bool* ready)
   // Additionally can report ready only when all models are ready.
   *ready = (ready_state_ == ServerReadyState::SERVER_READY);
   if (*ready && strict_readiness_) {
-    // Strict readiness... get the model status and make sure all
-    // models are ready.
-    ServerStatus server_status;
-    Status status =
-        status_manager_->Get(&server_status, id_, ready_state_, UptimeNs());
-
-    *ready = status.IsOk();
-    if (*ready) {
-      for (const auto& ms : server_status.model_status()) {
-        // If a model status is present but no version status,
-        // the model is not ready as there is no proper version to be served
-        if (ms.second.version_status().size() == 0) {
-          *ready = false;
-          goto strict_done;
-        }
-        for (const auto& vs : ms.second.version_status()) {
-          if (vs.second.ready_state() != ModelReadyState::MODEL_READY) {
-            *ready = false;
-            goto strict_done;
-          }
-        }
-      }
-    strict_done:;
-    }
+    // Strict readiness... all models must be ready. The status
+    // manager caches the answer across probes so that the model
+    // status is only rescanned after a model lifecycle change.
+    *ready = status_manager_->AllModelVersionsReady();
   }
 
   return Status::Success;
@@ -374,6 +458,43 @@ InferenceServer::ModelReadyVersions(
   return Status::Success;
 }
 
+Status
+InferenceServer::GetInferenceBackend(
+    const std::string& model_name, const int64_t model_version,
+    std::shared_ptr<InferenceBackend>* backend)
+{
+  RETURN_IF_ERROR(model_repository_manager_->GetInferenceBackend(
+      model_name, model_version, backend));
+
+  // Route the configured percentage of the model's requests to its
+  // shadow model. The shadow lookup deliberately doesn't consult the
+  // shadow model's own traffic split, so splits cannot chain. The
+  // split is deterministic over a rolling window of 100 requests
+  // rather than randomized so that small percentages are honored
+  // exactly.
+  const auto& split = (*backend)->Config().traffic_split();
+  if ((split.percentage() > 0) && !split.shadow_model_name().empty()) {
+    static std::atomic<uint64_t> request_cnt(0);
+    if ((request_cnt++ % 100) < split.percentage()) {
+      const int64_t shadow_version =
+          (split.shadow_model_version() > 0) ? split.shadow_model_version()
+                                             : -1 /* latest */;
+      std::shared_ptr<InferenceBackend> shadow;
+      Status status = model_repository_manager_->GetInferenceBackend(
+          split.shadow_model_name(), shadow_version, &shadow);
+      if (status.IsOk()) {
+        *backend = std::move(shadow);
+      } else {
+        LOG_ERROR << "traffic split for model '" << model_name
+                  << "' can't route to shadow model '"
+                  << split.shadow_model_name() << "': " << status.Message();
+      }
+    }
+  }
+
+  return Status::Success;
+}
+
 void
 InferenceServer::InferAsync(
     const std::shared_ptr<InferenceBackend>& backend,
@@ -382,6 +503,10 @@ InferenceServer::InferAsync(
     const std::shared_ptr<ModelInferStats>& infer_stats,
     std::function<void(const Status&)> OnCompleteInfer)
 {
+  TRTIS_PROBE2(
+      request_arrival, request->ModelName().c_str(), request->BatchSize());
+  NVTX_MARKER_ID("RequestArrival " + request->ModelName(), request->UniqueId());
+
   if (ready_state_ != ServerReadyState::SERVER_READY) {
     OnCompleteInfer(Status(Status::Code::UNAVAILABLE, "Server not ready"));
     return;
@@ -390,22 +515,181 @@ InferenceServer::InferAsync(
   std::shared_ptr<ScopedAtomicIncrement> inflight(
       new ScopedAtomicIncrement(inflight_request_counter_));
 
+  // Enforce the server-wide admission limits. The counters are updated
+  // optimistically and backed out on rejection so that concurrent
+  // requests don't race past the limits.
+  uint64_t request_byte_size = 0;
+  if ((max_inflight_requests_ > 0) || (max_inflight_byte_size_ > 0)) {
+    request_byte_size = request->TotalInputByteSize();
+    const uint64_t inflight_bytes =
+        (inflight_byte_size_counter_ += request_byte_size);
+    if (((max_inflight_requests_ > 0) &&
+         (inflight_request_counter_ > max_inflight_requests_)) ||
+        ((max_inflight_byte_size_ > 0) &&
+         (inflight_bytes > max_inflight_byte_size_))) {
+      inflight_byte_size_counter_ -= request_byte_size;
+      OnCompleteInfer(Status(
+          Status::Code::UNAVAILABLE,
+          "server in-flight request limit exceeded"));
+      return;
+    }
+  }
+
+  // Duplicate a sampled fraction of the requests to the mirror
+  // model, if one is configured. The duplication is asynchronous to
+  // this request: the mirrored copy runs at the lowest priority level
+  // of the mirror model's scheduler and its response is discarded, so
+  // mirror load can never delay primary traffic. A mirrored request
+  // is never itself mirrored, so mirror configurations cannot chain.
+  const auto& mirror = backend->Config().request_mirror();
+  if (!request->IsMirror() && (mirror.percentage() > 0) &&
+      !mirror.mirror_model_name().empty()) {
+    static std::atomic<uint64_t> mirror_cnt(0);
+    if ((mirror_cnt++ % 100) < mirror.percentage()) {
+      MirrorRequest(mirror, *request);
+    }
+  }
+
   // Need to capture 'backend' to keep it alive... it goes away when
   // it goes out of scope which can cause the model to be unloaded,
   // and we don't want that to happen when a request is in flight.
   auto OnCompleteHandleInfer = [this, OnCompleteInfer, backend,
-                                response_provider,
+                                response_provider, request_byte_size,
                                 inflight](const Status& status) mutable {
+    inflight_byte_size_counter_ -= request_byte_size;
     if (status.IsOk()) {
+      TRTIS_PROBE1(response_finalize, backend->Name().c_str());
       OnCompleteInfer(response_provider->FinalizeResponse(*backend));
     } else {
       OnCompleteInfer(status);
     }
   };
 
+  // For outputs whose exact size is known from the model
+  // configuration, reserve the response buffers now so the frontend
+  // prepares them while the inference runs instead of after it
+  // completes.
+  Status prealloc_status =
+      response_provider->PreallocateOutputBuffers(*backend);
+  if (!prealloc_status.IsOk()) {
+    inflight_byte_size_counter_ -= request_byte_size;
+    OnCompleteInfer(prealloc_status);
+    return;
+  }
+
   backend->Run(infer_stats, request, response_provider, OnCompleteHandleInfer);
 }
 
+void
+InferenceServer::MirrorRequest(
+    const ModelRequestMirror& mirror, const InferenceRequest& request)
+{
+  const int64_t mirror_version = (mirror.mirror_model_version() > 0)
+                                     ? mirror.mirror_model_version()
+                                     : -1 /* latest */;
+  std::shared_ptr<InferenceBackend> backend;
+  Status status = model_repository_manager_->GetInferenceBackend(
+      mirror.mirror_model_name(), mirror_version, &backend);
+  if (!status.IsOk()) {
+    LOG_VERBOSE(1) << "request mirror can't use model '"
+                   << mirror.mirror_model_name()
+                   << "': " << status.Message();
+    return;
+  }
+
+  // Build a copy of the request against the mirror model. The input
+  // data blocks are shared with the original request, not copied.
+  auto irequest = std::make_shared<InferenceRequest>(
+      mirror.mirror_model_name(), mirror_version, backend->Version(),
+      request.ProtocolVersion());
+  irequest->SetIsMirror(true);
+  irequest->SetCorrelationId(request.CorrelationId());
+  irequest->SetFlags(request.Flags());
+  irequest->SetBatchSize(request.BatchSize());
+
+  // Run the mirrored copy at the lowest priority level of the mirror
+  // model's scheduler so that it only executes when no higher
+  // priority request is waiting.
+  const auto& batcher = backend->Config().dynamic_batching();
+  if (batcher.priority_levels() > 0) {
+    irequest->SetPriority(batcher.priority_levels());
+  }
+
+  for (const auto& pr : request.OriginalInputs()) {
+    const InferenceRequest::Input& in = pr.second;
+    InferenceRequest::Input* input = nullptr;
+    status = irequest->AddOriginalInput(
+        in.Name(),
+        std::vector<int64_t>(
+            in.OriginalShape().begin(), in.OriginalShape().end()),
+        in.BatchByteSize(), &input);
+    if (status.IsOk()) {
+      input->SetDType(in.DType());
+      status = input->SetData(in.Data());
+    }
+    if (!status.IsOk()) {
+      break;
+    }
+  }
+
+  if (status.IsOk()) {
+    for (const auto& pr : request.RequestedOutputs()) {
+      status = irequest->AddRequestedOutput(
+          pr.first, pr.second.ClassificationCount());
+      if (!status.IsOk()) {
+        break;
+      }
+    }
+  }
+
+  if (status.IsOk()) {
+    status = irequest->PrepareForInference(*backend);
+  }
+
+  std::shared_ptr<InferResponseProvider> response_provider;
+  if (status.IsOk()) {
+    status = InferResponseProvider::Create(
+        irequest, backend->GetLabelProvider(), MirrorResponseAllocator(),
+        MirrorResponseAlloc, nullptr /* alloc_userp */, MirrorResponseRelease,
+        request.ProtocolVersion(), &response_provider);
+  }
+
+  if (!status.IsOk()) {
+    LOG_VERBOSE(1) << "can't mirror request to model '"
+                   << mirror.mirror_model_name()
+                   << "': " << status.Message();
+    return;
+  }
+
+#ifdef TRTIS_ENABLE_STATS
+  auto infer_stats =
+      std::make_shared<ModelInferStats>(status_manager_, backend->Name());
+  infer_stats->CaptureTimestamp(ModelInferStats::TimestampKind::kRequestStart);
+  infer_stats->SetRequestedVersion(mirror_version);
+  infer_stats->SetMetricReporter(backend->MetricReporter());
+  infer_stats->SetBatchSize(irequest->BatchSize());
+  infer_stats->SetFailed(true);
+#else
+  auto infer_stats = std::make_shared<ModelInferStats>();
+#endif  // TRTIS_ENABLE_STATS
+
+  InferAsync(
+      backend, irequest, response_provider, infer_stats,
+      [response_provider, infer_stats](const Status& status) mutable {
+        // The mirrored response is discarded.
+        if (!status.IsOk()) {
+          LOG_VERBOSE(1) << "Mirrored infer failed: " << status.Message();
+        }
+
+#ifdef TRTIS_ENABLE_STATS
+        infer_stats->SetFailed(!status.IsOk());
+        infer_stats->CaptureTimestamp(
+            ModelInferStats::TimestampKind::kRequestEnd);
+        infer_stats->Report();
+#endif  // TRTIS_ENABLE_STATS
+      });
+}
+
 Status
 InferenceServer::GetStatus(
     ServerStatus* server_status, const std::string& model_name)
@@ -45,7 +45,7 @@ namespace nvidia { namespace inferenceserver {
 
 class InferenceBackend;
 
-enum ModelControlMode { MODE_NONE, MODE_POLL, MODE_EXPLICIT };
+enum ModelControlMode { MODE_NONE, MODE_POLL, MODE_EXPLICIT, MODE_LAZY };
 
 // Inference server information.
 class InferenceServer {
@@ -60,6 +60,14 @@ class InferenceServer {
   // if exit timeout occurs.
   Status Stop();
 
+  // Drain the server. New inference requests are rejected and
+  // readiness reports not-ready while in-flight requests continue to
+  // completion, so that a load balancer can take the server out of
+  // rotation without client-visible errors. Models stay loaded; a
+  // drained server must still be stopped to exit. Return an error if
+  // the exit timeout expires before all in-flight requests complete.
+  Status Drain();
+
   // Check the model repository for changes and update server state
   // based on those changes.
   Status PollModelRepository();
@@ -175,6 +183,21 @@ class InferenceServer {
   int32_t ExitTimeoutSeconds() const { return exit_timeout_secs_; }
   void SetExitTimeoutSeconds(int32_t s) { exit_timeout_secs_ = std::max(0, s); }
 
+  // Get / set the maximum number of in-flight inference requests. A
+  // value of 0 indicates no limit.
+  uint64_t MaxInflightRequests() const { return max_inflight_requests_; }
+  void SetMaxInflightRequests(uint64_t m) { max_inflight_requests_ = m; }
+
+  // Get / set the maximum total input byte size of in-flight inference
+  // requests. A value of 0 indicates no limit.
+  uint64_t MaxInflightByteSize() const { return max_inflight_byte_size_; }
+  void SetMaxInflightByteSize(uint64_t m) { max_inflight_byte_size_ = m; }
+
+  // Get / set the maximum number of models that may be loading
+  // concurrently. A value of 0 indicates no limit.
+  uint32_t ModelLoadConcurrency() const { return model_load_concurrency_; }
+  void SetModelLoadConcurrency(uint32_t c) { model_load_concurrency_ = c; }
+
   // Get / set Tensorflow soft placement enable.
   bool TensorFlowSoftPlacementEnabled() const
   {
@@ -189,6 +212,18 @@ class InferenceServer {
   float TensorFlowGPUMemoryFraction() const { return tf_gpu_memory_fraction_; }
   void SetTensorFlowGPUMemoryFraction(float f) { tf_gpu_memory_fraction_ = f; }
 
+  // Get / set Tensorflow shared thread pool size. If >= 0 TF sessions
+  // schedule work on a thread pool shared across all TF models instead
+  // of creating per-session pools.
+  int TensorFlowSharedThreadPoolSize() const
+  {
+    return tf_shared_thread_pool_size_;
+  }
+  void SetTensorFlowSharedThreadPoolSize(int s)
+  {
+    tf_shared_thread_pool_size_ = s;
+  }
+
   // Get / set Tensorflow vGPU memory limits
   const std::map<int, std::pair<int, uint64_t>>& TensorFlowVGPUMemoryLimits()
       const
@@ -208,19 +243,24 @@ class InferenceServer {
     return status_manager_;
   }
 
-  // Return the requested InferenceBackend object.
+  // Return the requested InferenceBackend object. If the model has a
+  // traffic split configured, the configured percentage of the
+  // requests is routed to the shadow model's backend instead.
   Status GetInferenceBackend(
       const std::string& model_name, const int64_t model_version,
-      std::shared_ptr<InferenceBackend>* backend)
-  {
-    return model_repository_manager_->GetInferenceBackend(
-        model_name, model_version, backend);
-  }
+      std::shared_ptr<InferenceBackend>* backend);
 
  private:
   // Return the uptime of the server in nanoseconds.
   uint64_t UptimeNs() const;
 
+  // Asynchronously duplicate 'request' to the model named by the
+  // 'mirror' configuration. The mirrored response is discarded but
+  // the mirror model's statistics and metrics are recorded. Failure
+  // to mirror never affects the original request.
+  void MirrorRequest(
+      const ModelRequestMirror& mirror, const InferenceRequest& request);
+
   const std::string version_;
   std::string id_;
   std::vector<const char*> extensions_;
@@ -242,6 +282,7 @@ class InferenceServer {
   bool tf_soft_placement_enabled_;
   float tf_gpu_memory_fraction_;
   std::map<int, std::pair<int, uint64_t>> tf_vgpu_memory_limits_;
+  int tf_shared_thread_pool_size_;
 
   // Current state of the inference server.
   ServerReadyState ready_state_;
@@ -250,6 +291,17 @@ class InferenceServer {
   // for all in-flight requests to complete before exiting.
   std::atomic<uint64_t> inflight_request_counter_;
 
+  // Server-wide admission limits on inference requests, and the total
+  // input byte size of the inference requests currently in flight. A
+  // limit of 0 indicates no limit.
+  uint64_t max_inflight_requests_;
+  uint64_t max_inflight_byte_size_;
+  std::atomic<uint64_t> inflight_byte_size_counter_;
+
+  // The maximum number of models that may be loading concurrently.
+  // A limit of 0 indicates no limit.
+  uint32_t model_load_concurrency_;
+
   std::shared_ptr<ServerStatusManager> status_manager_;
   std::unique_ptr<ModelRepositoryManager> model_repository_manager_;
 };
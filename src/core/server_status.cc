@@ -26,7 +26,10 @@
 
 #include "src/core/server_status.h"
 
+#include <stdlib.h>
 #include <time.h>
+#include <functional>
+#include <thread>
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/metric_model_reporter.h"
@@ -36,7 +39,50 @@
 
 namespace nvidia { namespace inferenceserver {
 
+#if defined(TRTIS_ENABLE_STATS) && defined(TRTIS_ENABLE_METRICS)
+namespace {
+
+// The 1-in-N sampling rate for the per-stage duration histograms,
+// read once from TRTSERVER_STAGE_TIMING_SAMPLE_RATE. 0 disables stage
+// timing; a value of 100 samples 1% of requests.
+uint64_t
+StageTimingSampleRate()
+{
+  static uint64_t rate = 0;
+  static std::once_flag once;
+  std::call_once(once, []() {
+    const char* rstr = getenv("TRTSERVER_STAGE_TIMING_SAMPLE_RATE");
+    if (rstr != nullptr) {
+      const int64_t parsed = atoll(rstr);
+      if (parsed > 0) {
+        rate = parsed;
+      }
+    }
+  });
+  return rate;
+}
+
+// Return true if the current request should record per-stage
+// durations.
+bool
+SampleStageTiming()
+{
+  const uint64_t rate = StageTimingSampleRate();
+  if (rate == 0) {
+    return false;
+  }
+
+  static std::atomic<uint64_t> request_cnt{0};
+  return ((++request_cnt % rate) == 0);
+}
+
+}  // namespace
+#endif  // TRTIS_ENABLE_STATS && TRTIS_ENABLE_METRICS
+
+constexpr size_t ServerStatusManager::kInferStatsShardCount;
+
 ServerStatusManager::ServerStatusManager(const std::string& server_version)
+    : snapshot_current_(false), all_versions_ready_(-1)
 {
   const auto& version = server_version;
   if (!version.empty()) {
@@ -59,6 +105,8 @@ ServerStatusManager::InitForModel(
   }
 
   ms[model_name].mutable_config()->CopyFrom(model_config);
+  snapshot_current_ = false;
+  all_versions_ready_.store(-1, std::memory_order_release);
 
   return Status::Success;
 }
@@ -79,6 +127,8 @@ ServerStatusManager::UpdateConfigForModel(
   }
 
   ms[model_name].mutable_config()->CopyFrom(model_config);
+  snapshot_current_ = false;
+  all_versions_ready_.store(-1, std::memory_order_release);
 
   return Status::Success;
 }
@@ -108,16 +158,79 @@ ServerStatusManager::SetModelVersionReadyState(
     *(vitr->second.mutable_ready_state_reason()) = state_reason;
   }
 
+  snapshot_current_ = false;
+  all_versions_ready_.store(-1, std::memory_order_release);
+
   return Status::Success;
 }
 
+bool
+ServerStatusManager::AllModelVersionsReady() const
+{
+  // Fast path for the common case where no model lifecycle change has
+  // occurred since the last probe.
+  int ready = all_versions_ready_.load(std::memory_order_acquire);
+  if (ready >= 0) {
+    return ready != 0;
+  }
+
+  std::lock_guard<std::mutex> lock(mu_);
+
+  ready = 1;
+  for (const auto& ms : server_status_.model_status()) {
+    // If a model status is present but no version status, the model
+    // is not ready as there is no proper version to be served.
+    if (ms.second.version_status().size() == 0) {
+      ready = 0;
+      break;
+    }
+    for (const auto& vs : ms.second.version_status()) {
+      if (vs.second.ready_state() != ModelReadyState::MODEL_READY) {
+        ready = 0;
+        break;
+      }
+    }
+    if (ready == 0) {
+      break;
+    }
+  }
+
+  // The store is made while holding 'mu_' so it cannot race with an
+  // invalidation from a lifecycle mutator.
+  all_versions_ready_.store(ready, std::memory_order_release);
+
+  return ready != 0;
+}
+
+// Refresh the copy-on-write snapshot if the status has changed since
+// the last generation and return it. Caller must hold 'mu_'.
+const std::shared_ptr<const ServerStatus>&
+ServerStatusManager::RefreshSnapshot() const
+{
+  if (!snapshot_current_ || (status_snapshot_ == nullptr)) {
+    status_snapshot_ = std::make_shared<ServerStatus>(server_status_);
+    snapshot_current_ = true;
+  }
+
+  return status_snapshot_;
+}
+
 Status
 ServerStatusManager::Get(
     ServerStatus* server_status, const std::string& server_id,
     ServerReadyState server_ready_state, uint64_t server_uptime_ns) const
 {
-  std::lock_guard<std::mutex> lock(mu_);
-  server_status->CopyFrom(server_status_);
+  std::shared_ptr<const ServerStatus> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    FoldInferStats();
+    snapshot = RefreshSnapshot();
+  }
+
+  // The copy for the response is made from the immutable snapshot
+  // without holding 'mu_', so concurrent status readers don't
+  // serialize on the lock.
+  server_status->CopyFrom(*snapshot);
   server_status->set_id(server_id);
   server_status->set_ready_state(server_ready_state);
   server_status->set_uptime_ns(server_uptime_ns);
@@ -131,16 +244,21 @@ ServerStatusManager::Get(
     ServerReadyState server_ready_state, uint64_t server_uptime_ns,
     const std::string& model_name) const
 {
-  std::lock_guard<std::mutex> lock(mu_);
+  std::shared_ptr<const ServerStatus> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    FoldInferStats();
+    snapshot = RefreshSnapshot();
+  }
 
   server_status->Clear();
-  server_status->set_version(server_status_.version());
+  server_status->set_version(snapshot->version());
   server_status->set_id(server_id);
   server_status->set_ready_state(server_ready_state);
   server_status->set_uptime_ns(server_uptime_ns);
 
-  const auto& itr = server_status_.model_status().find(model_name);
-  if (itr == server_status_.model_status().end()) {
+  const auto& itr = snapshot->model_status().find(model_name);
+  if (itr == snapshot->model_status().end()) {
     return Status(
         Status::Code::INVALID_ARG,
         "no status available for unknown model '" + model_name + "'");
@@ -191,6 +309,8 @@ ServerStatusManager::UpdateServerStat(
       break;
     }
   }
+
+  snapshot_current_ = false;
 }
 
 void
@@ -198,46 +318,16 @@ ServerStatusManager::UpdateFailedInferStats(
     const std::string& model_name, const int64_t model_version,
     size_t batch_size, uint64_t last_timestamp_ms, uint64_t request_duration_ns)
 {
-  std::lock_guard<std::mutex> lock(mu_);
-
-  // Model must exist...
-  auto itr = server_status_.mutable_model_status()->find(model_name);
-  if (itr == server_status_.model_status().end()) {
-    LOG_ERROR << "can't update INFER duration stat for " << model_name;
-  } else {
-    // batch_size may be zero if the failure occurred before it could
-    // be determined... but we still record the failure.
-
-    // model version
-    auto& mvs = *itr->second.mutable_version_status();
-    auto mvs_itr = mvs.find(model_version);
-    if (mvs_itr == mvs.end()) {
-      ModelVersionStatus& version_status = mvs[model_version];
-      version_status.set_last_inference_timestamp_milliseconds(
-          last_timestamp_ms);
-      InferRequestStats& stats =
-          (*version_status.mutable_infer_stats())[batch_size];
-      stats.mutable_failed()->set_count(1);
-      stats.mutable_failed()->set_total_time_ns(request_duration_ns);
-    } else {
-      ModelVersionStatus& version_status = mvs_itr->second;
-      if (last_timestamp_ms > 0) {
-        version_status.set_last_inference_timestamp_milliseconds(
-            last_timestamp_ms);
-      }
-      auto& is = *version_status.mutable_infer_stats();
-      auto is_itr = is.find(batch_size);
-      if (is_itr == is.end()) {
-        InferRequestStats& stats = is[batch_size];
-        stats.mutable_failed()->set_count(1);
-        stats.mutable_failed()->set_total_time_ns(request_duration_ns);
-      } else {
-        InferRequestStats& stats = is_itr->second;
-        stats.mutable_failed()->set_count(stats.failed().count() + 1);
-        stats.mutable_failed()->set_total_time_ns(
-            stats.failed().total_time_ns() + request_duration_ns);
-      }
-    }
+  // batch_size may be zero if the failure occurred before it could
+  // be determined... but we still record the failure.
+  InferStatsShard* shard = LocalShard();
+  std::lock_guard<std::mutex> lock(shard->mu_);
+  InferStatCounts& counts =
+      shard->counts_[InferStatKey(model_name, model_version, batch_size)];
+  counts.failed_count_ += 1;
+  counts.failed_duration_ns_ += request_duration_ns;
+  if (last_timestamp_ms > counts.last_timestamp_ms_) {
+    counts.last_timestamp_ms_ = last_timestamp_ms;
   }
 }
 
@@ -248,69 +338,25 @@ ServerStatusManager::UpdateSuccessInferStats(
     uint64_t request_duration_ns, uint64_t queue_duration_ns,
     uint64_t compute_duration_ns)
 {
-  std::lock_guard<std::mutex> lock(mu_);
-
-  // Model must exist...
-  auto itr = server_status_.mutable_model_status()->find(model_name);
-  if (itr == server_status_.model_status().end()) {
-    LOG_ERROR << "can't update duration stat for " << model_name;
-  } else if (batch_size == 0) {
+  if (batch_size == 0) {
     LOG_ERROR << "can't update INFER durations without batch size for "
               << model_name;
-  } else {
-    // model version
-    auto& mvs = *itr->second.mutable_version_status();
-    auto mvs_itr = mvs.find(model_version);
-    InferRequestStats* new_stats = nullptr;
-    InferRequestStats* existing_stats = nullptr;
-    if (mvs_itr == mvs.end()) {
-      ModelVersionStatus& version_status = mvs[model_version];
-      version_status.set_model_inference_count(batch_size);
-      version_status.set_model_execution_count(execution_cnt);
-      version_status.set_last_inference_timestamp_milliseconds(
-          last_timestamp_ms);
-      new_stats = &((*version_status.mutable_infer_stats())[batch_size]);
-    } else {
-      ModelVersionStatus& version_status = mvs_itr->second;
-      version_status.set_model_inference_count(
-          version_status.model_inference_count() + batch_size);
-      version_status.set_model_execution_count(
-          version_status.model_execution_count() + execution_cnt);
-      if (last_timestamp_ms > 0) {
-        version_status.set_last_inference_timestamp_milliseconds(
-            last_timestamp_ms);
-      }
-
-      auto& is = *version_status.mutable_infer_stats();
-      auto is_itr = is.find(batch_size);
-      if (is_itr == is.end()) {
-        new_stats = &is[batch_size];
-      } else {
-        existing_stats = &is_itr->second;
-      }
-    }
+    return;
+  }
 
-    if (new_stats != nullptr) {
-      new_stats->mutable_success()->set_count(1);
-      new_stats->mutable_success()->set_total_time_ns(request_duration_ns);
-      new_stats->mutable_compute()->set_count(1);
-      new_stats->mutable_compute()->set_total_time_ns(compute_duration_ns);
-      new_stats->mutable_queue()->set_count(1);
-      new_stats->mutable_queue()->set_total_time_ns(queue_duration_ns);
-    } else if (existing_stats != nullptr) {
-      InferRequestStats& stats = *existing_stats;
-      stats.mutable_success()->set_count(stats.success().count() + 1);
-      stats.mutable_success()->set_total_time_ns(
-          stats.success().total_time_ns() + request_duration_ns);
-      stats.mutable_compute()->set_count(stats.compute().count() + 1);
-      stats.mutable_compute()->set_total_time_ns(
-          stats.compute().total_time_ns() + compute_duration_ns);
-      stats.mutable_queue()->set_count(stats.queue().count() + 1);
-      stats.mutable_queue()->set_total_time_ns(
-          stats.queue().total_time_ns() + queue_duration_ns);
-    } else {
-      LOG_ERROR << "Internal error logging INFER stats for " << model_name;
-    }
+  InferStatsShard* shard = LocalShard();
+  std::lock_guard<std::mutex> lock(shard->mu_);
+  InferStatCounts& counts =
+      shard->counts_[InferStatKey(model_name, model_version, batch_size)];
+  counts.success_count_ += 1;
+  counts.success_duration_ns_ += request_duration_ns;
+  counts.queue_duration_ns_ += queue_duration_ns;
+  counts.compute_count_ += 1;
+  counts.compute_duration_ns_ += compute_duration_ns;
+  counts.inference_count_ += batch_size;
+  counts.execution_count_ += execution_cnt;
+  if (last_timestamp_ms > counts.last_timestamp_ms_) {
+    counts.last_timestamp_ms_ = last_timestamp_ms;
   }
 }
 
@@ -322,81 +368,115 @@ ServerStatusManager::UpdateSuccessInferStats(
     uint64_t compute_input_duration_ns, uint64_t compute_infer_duration_ns,
     uint64_t compute_output_duration_ns)
 {
-  std::lock_guard<std::mutex> lock(mu_);
+  // The V2 stats don't vary by batch size, all requests are recorded
+  // in the batch-size 1 slot.
+  InferStatsShard* shard = LocalShard();
+  std::lock_guard<std::mutex> lock(shard->mu_);
+  InferStatCounts& counts =
+      shard->counts_[InferStatKey(model_name, model_version, 1)];
+  counts.success_count_ += 1;
+  counts.success_duration_ns_ += request_duration_ns;
+  counts.queue_duration_ns_ += queue_duration_ns;
+  counts.compute_split_count_ += 1;
+  counts.compute_input_duration_ns_ += compute_input_duration_ns;
+  counts.compute_infer_duration_ns_ += compute_infer_duration_ns;
+  counts.compute_output_duration_ns_ += compute_output_duration_ns;
+  counts.inference_count_ += 1;
+  counts.execution_count_ += execution_cnt;
+  if (last_timestamp_ms > counts.last_timestamp_ms_) {
+    counts.last_timestamp_ms_ = last_timestamp_ms;
+  }
+}
 
-  // Model must exist...
-  auto itr = server_status_.mutable_model_status()->find(model_name);
-  if (itr == server_status_.model_status().end()) {
-    LOG_ERROR << "can't update duration stat for " << model_name;
-  } else {
-    // model version
-    auto& mvs = *itr->second.mutable_version_status();
-    auto mvs_itr = mvs.find(model_version);
-    InferRequestStats* new_stats = nullptr;
-    InferRequestStats* existing_stats = nullptr;
-    if (mvs_itr == mvs.end()) {
-      ModelVersionStatus& version_status = mvs[model_version];
-      version_status.set_model_inference_count(1);
-      version_status.set_model_execution_count(execution_cnt);
-      version_status.set_last_inference_timestamp_milliseconds(
-          last_timestamp_ms);
-      new_stats = &((*version_status.mutable_infer_stats())[1]);
-    } else {
-      ModelVersionStatus& version_status = mvs_itr->second;
+ServerStatusManager::InferStatsShard*
+ServerStatusManager::LocalShard()
+{
+  const size_t shard_idx =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) %
+      kInferStatsShardCount;
+  return &infer_stats_shards_[shard_idx];
+}
+
+void
+ServerStatusManager::FoldInferStats() const
+{
+  for (size_t shard_idx = 0; shard_idx < kInferStatsShardCount; shard_idx++) {
+    std::map<InferStatKey, InferStatCounts> counts;
+    {
+      std::lock_guard<std::mutex> lock(infer_stats_shards_[shard_idx].mu_);
+      counts.swap(infer_stats_shards_[shard_idx].counts_);
+    }
+
+    if (!counts.empty()) {
+      snapshot_current_ = false;
+    }
+
+    for (const auto& pr : counts) {
+      const std::string& model_name = std::get<0>(pr.first);
+      const int64_t model_version = std::get<1>(pr.first);
+      const size_t batch_size = std::get<2>(pr.first);
+      const InferStatCounts& cnts = pr.second;
+
+      // Model must exist...
+      auto itr = server_status_.mutable_model_status()->find(model_name);
+      if (itr == server_status_.model_status().end()) {
+        LOG_ERROR << "can't update INFER duration stat for " << model_name;
+        continue;
+      }
+
+      ModelVersionStatus& version_status =
+          (*itr->second.mutable_version_status())[model_version];
       version_status.set_model_inference_count(
-          version_status.model_inference_count() + 1);
+          version_status.model_inference_count() + cnts.inference_count_);
       version_status.set_model_execution_count(
-          version_status.model_execution_count() + execution_cnt);
-      if (last_timestamp_ms > 0) {
+          version_status.model_execution_count() + cnts.execution_count_);
+      if (cnts.last_timestamp_ms_ >
+          version_status.last_inference_timestamp_milliseconds()) {
         version_status.set_last_inference_timestamp_milliseconds(
-            last_timestamp_ms);
+            cnts.last_timestamp_ms_);
       }
 
-      auto& is = *version_status.mutable_infer_stats();
-      auto is_itr = is.find(1);
-      if (is_itr == is.end()) {
-        new_stats = &is[1];
-      } else {
-        existing_stats = &is_itr->second;
+      InferRequestStats& stats =
+          (*version_status.mutable_infer_stats())[batch_size];
+      if (cnts.success_count_ > 0) {
+        stats.mutable_success()->set_count(
+            stats.success().count() + cnts.success_count_);
+        stats.mutable_success()->set_total_time_ns(
+            stats.success().total_time_ns() + cnts.success_duration_ns_);
+        stats.mutable_queue()->set_count(
+            stats.queue().count() + cnts.success_count_);
+        stats.mutable_queue()->set_total_time_ns(
+            stats.queue().total_time_ns() + cnts.queue_duration_ns_);
+      }
+      if (cnts.failed_count_ > 0) {
+        stats.mutable_failed()->set_count(
+            stats.failed().count() + cnts.failed_count_);
+        stats.mutable_failed()->set_total_time_ns(
+            stats.failed().total_time_ns() + cnts.failed_duration_ns_);
+      }
+      if (cnts.compute_count_ > 0) {
+        stats.mutable_compute()->set_count(
+            stats.compute().count() + cnts.compute_count_);
+        stats.mutable_compute()->set_total_time_ns(
+            stats.compute().total_time_ns() + cnts.compute_duration_ns_);
+      }
+      if (cnts.compute_split_count_ > 0) {
+        stats.mutable_compute_input()->set_count(
+            stats.compute_input().count() + cnts.compute_split_count_);
+        stats.mutable_compute_input()->set_total_time_ns(
+            stats.compute_input().total_time_ns() +
+            cnts.compute_input_duration_ns_);
+        stats.mutable_compute_infer()->set_count(
+            stats.compute_infer().count() + cnts.compute_split_count_);
+        stats.mutable_compute_infer()->set_total_time_ns(
+            stats.compute_infer().total_time_ns() +
+            cnts.compute_infer_duration_ns_);
+        stats.mutable_compute_output()->set_count(
+            stats.compute_output().count() + cnts.compute_split_count_);
+        stats.mutable_compute_output()->set_total_time_ns(
+            stats.compute_output().total_time_ns() +
+            cnts.compute_output_duration_ns_);
       }
-    }
-
-    if (new_stats != nullptr) {
-      new_stats->mutable_success()->set_count(1);
-      new_stats->mutable_success()->set_total_time_ns(request_duration_ns);
-      new_stats->mutable_compute_input()->set_count(1);
-      new_stats->mutable_compute_input()->set_total_time_ns(
-          compute_input_duration_ns);
-      new_stats->mutable_compute_infer()->set_count(1);
-      new_stats->mutable_compute_infer()->set_total_time_ns(
-          compute_infer_duration_ns);
-      new_stats->mutable_compute_output()->set_count(1);
-      new_stats->mutable_compute_output()->set_total_time_ns(
-          compute_output_duration_ns);
-      new_stats->mutable_queue()->set_count(1);
-      new_stats->mutable_queue()->set_total_time_ns(queue_duration_ns);
-    } else if (existing_stats != nullptr) {
-      InferRequestStats& stats = *existing_stats;
-      stats.mutable_success()->set_count(stats.success().count() + 1);
-      stats.mutable_success()->set_total_time_ns(
-          stats.success().total_time_ns() + request_duration_ns);
-      stats.mutable_compute_input()->set_count(
-          stats.compute_input().count() + 1);
-      stats.mutable_compute_input()->set_total_time_ns(
-          stats.compute_input().total_time_ns() + compute_input_duration_ns);
-      stats.mutable_compute_infer()->set_count(
-          stats.compute_infer().count() + 1);
-      stats.mutable_compute_infer()->set_total_time_ns(
-          stats.compute_infer().total_time_ns() + compute_infer_duration_ns);
-      stats.mutable_compute_output()->set_count(
-          stats.compute_output().count() + 1);
-      stats.mutable_compute_output()->set_total_time_ns(
-          stats.compute_output().total_time_ns() + compute_output_duration_ns);
-      stats.mutable_queue()->set_count(stats.queue().count() + 1);
-      stats.mutable_queue()->set_total_time_ns(
-          stats.queue().total_time_ns() + queue_duration_ns);
-    } else {
-      LOG_ERROR << "Internal error logging INFER stats for " << model_name;
     }
   }
 }
@@ -538,10 +618,54 @@ ModelInferStats::Report()
       metric_reporter_->MetricInferenceQueueDuration(gpu_device_)
           .Increment(queue_duration_ns / 1000);
 
+      metric_reporter_->MetricInferenceRequestDurationHistogram(gpu_device_)
+          .Observe(request_duration_ns / 1000);
+      metric_reporter_->MetricInferenceComputeDurationHistogram(gpu_device_)
+          .Observe(compute_duration_ns / 1000);
+      metric_reporter_->MetricInferenceQueueDurationHistogram(gpu_device_)
+          .Observe(queue_duration_ns / 1000);
+
       metric_reporter_->MetricInferenceLoadRatio(gpu_device_)
           .Observe(
               (double)request_duration_ns /
               std::max(1.0, (double)compute_duration_ns));
+
+      // Record the fine-grained stage breakdown for sampled requests
+      // when stage timing is enabled. The stage timestamps are
+      // captured unconditionally along the request path; sampling
+      // only bounds the histogram update cost.
+      if (SampleStageTiming()) {
+        metric_reporter_->MetricInferenceStageDuration("normalize")
+            .Observe(
+                Duration(
+                    TimestampKind::kRequestStart, TimestampKind::kQueueStart) /
+                1000);
+        metric_reporter_->MetricInferenceStageDuration("queue").Observe(
+            queue_duration_ns / 1000);
+        metric_reporter_->MetricInferenceStageDuration("compute_input")
+            .Observe(
+                Duration(
+                    TimestampKind::kComputeStart,
+                    TimestampKind::kComputeInputEnd) /
+                1000);
+        metric_reporter_->MetricInferenceStageDuration("compute_infer")
+            .Observe(
+                Duration(
+                    TimestampKind::kComputeInputEnd,
+                    TimestampKind::kComputeOutputStart) /
+                1000);
+        metric_reporter_->MetricInferenceStageDuration("compute_output")
+            .Observe(
+                Duration(
+                    TimestampKind::kComputeOutputStart,
+                    TimestampKind::kComputeEnd) /
+                1000);
+        metric_reporter_->MetricInferenceStageDuration("finalize")
+            .Observe(
+                Duration(
+                    TimestampKind::kComputeEnd, TimestampKind::kRequestEnd) /
+                1000);
+      }
     }
 #endif  // TRTIS_ENABLE_METRICS
   }
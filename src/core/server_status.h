@@ -26,7 +26,11 @@
 #pragma once
 
 #include <time.h>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <tuple>
 #include "src/core/model_config.pb.h"
 #include "src/core/server_status.pb.h"
 #include "src/core/status.h"
@@ -251,6 +255,13 @@ class ServerStatusManager {
       const std::string& model_name, int64_t version, ModelReadyState state,
       const ModelReadyStateReason& state_reason);
 
+  // Return true if every model has at least one version and all
+  // versions are in the MODEL_READY state. The result is cached in an
+  // atomic and recomputed only after a model lifecycle change, so
+  // health probes can ask at high frequency without touching the
+  // status protobuf.
+  bool AllModelVersionsReady() const;
+
   // Get the entire server status, including status for all models.
   Status Get(
       ServerStatus* server_status, const std::string& server_id,
@@ -287,8 +298,95 @@ class ServerStatusManager {
       uint64_t compute_output_duration_ns);
 
  private:
+  // Inference statistics accumulated for one (model, version, batch
+  // size) since the last fold into the status protobuf.
+  struct InferStatCounts {
+    InferStatCounts()
+        : success_count_(0), success_duration_ns_(0), failed_count_(0),
+          failed_duration_ns_(0), queue_duration_ns_(0),
+          compute_count_(0), compute_duration_ns_(0), compute_split_count_(0),
+          compute_input_duration_ns_(0), compute_infer_duration_ns_(0),
+          compute_output_duration_ns_(0), inference_count_(0),
+          execution_count_(0), last_timestamp_ms_(0)
+    {
+    }
+
+    uint64_t success_count_;
+    uint64_t success_duration_ns_;
+    uint64_t failed_count_;
+    uint64_t failed_duration_ns_;
+    uint64_t queue_duration_ns_;
+
+    // [V1] aggregate compute duration.
+    uint64_t compute_count_;
+    uint64_t compute_duration_ns_;
+
+    // [V2] compute duration split into input / infer / output.
+    uint64_t compute_split_count_;
+    uint64_t compute_input_duration_ns_;
+    uint64_t compute_infer_duration_ns_;
+    uint64_t compute_output_duration_ns_;
+
+    uint64_t inference_count_;
+    uint64_t execution_count_;
+    uint64_t last_timestamp_ms_;
+  };
+
+  // model name, model version, batch size
+  using InferStatKey = std::tuple<std::string, int64_t, size_t>;
+
+  // The inference completion path records its statistics into one of
+  // several shards, selected by thread, so that concurrent updates
+  // across runner threads don't serialize on a single lock. Each
+  // shard's mutex is effectively uncontended; the shards are folded
+  // into 'server_status_' only when a status request arrives. Each
+  // shard is padded to a whole number of cache lines so that runner
+  // threads recording into adjacent shards don't false-share a line.
+  struct InferStatsShard {
+    std::mutex mu_;
+    std::map<InferStatKey, InferStatCounts> counts_;
+
+    // Explicit padding rather than alignas(64): the manager is
+    // allocated with plain new and C++11 has no aligned operator
+    // new, so extended alignment would trip -Waligned-new and not be
+    // honored anyway. Padding to a multiple of 64 bytes keeps any
+    // two shards off a common line regardless of the base address.
+    char padding_
+        [64 - ((sizeof(std::mutex) +
+                sizeof(std::map<InferStatKey, InferStatCounts>)) %
+               64)];
+  };
+
+  // Return the shard that the calling thread should record into.
+  InferStatsShard* LocalShard();
+
+  // Fold all sharded counts into 'server_status_'. Caller must hold
+  // 'mu_'. Invalidates the status snapshot if anything was folded.
+  void FoldInferStats() const;
+
+  // Refresh the copy-on-write status snapshot if needed and return
+  // it. Caller must hold 'mu_'.
+  const std::shared_ptr<const ServerStatus>& RefreshSnapshot() const;
+
+  static constexpr size_t kInferStatsShardCount = 8;
+
   mutable std::mutex mu_;
-  ServerStatus server_status_;
+  mutable ServerStatus server_status_;
   uint32_t protocol_version_;
+
+  mutable InferStatsShard infer_stats_shards_[kInferStatsShardCount];
+
+  // Copy-on-write snapshot of 'server_status_'. Status readers copy
+  // from the immutable snapshot outside of 'mu_' so that concurrent
+  // status scrapers never hold the lock while serializing; a new
+  // generation is created under 'mu_' only when the status has
+  // changed since the last one. Guarded by 'mu_'.
+  mutable std::shared_ptr<const ServerStatus> status_snapshot_;
+  mutable bool snapshot_current_;
+
+  // Cached result of AllModelVersionsReady: -1 unknown, 0 not ready,
+  // 1 ready. Invalidated, under 'mu_', by the model lifecycle
+  // mutators; infer stat updates don't affect it.
+  mutable std::atomic<int> all_versions_ready_;
 };
 }}  // namespace nvidia::inferenceserver
@@ -0,0 +1,230 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver {
+
+// A tensor shape with fixed inline capacity. Almost all tensor shapes
+// have only a few dimensions, so a shape held in a ShapeVector does
+// not allocate unless it exceeds the inline capacity; only then does
+// the storage spill to the heap. Used on the per-request hot path
+// where std::vector<int64_t> shapes would allocate per tensor per
+// request. The type converts implicitly to and from
+// std::vector<int64_t> for interoperability; the conversion to a
+// vector allocates, so hot-path consumers should take a ShapeVector
+// directly.
+class ShapeVector {
+ public:
+  using value_type = int64_t;
+  using iterator = int64_t*;
+  using const_iterator = const int64_t*;
+
+  ShapeVector() : buf_(inline_), size_(0), capacity_(kInlineCapacity) {}
+
+  ShapeVector(const std::vector<int64_t>& dims)
+      : buf_(inline_), size_(0), capacity_(kInlineCapacity)
+  {
+    assign(dims.begin(), dims.end());
+  }
+
+  ShapeVector(std::initializer_list<int64_t> dims)
+      : buf_(inline_), size_(0), capacity_(kInlineCapacity)
+  {
+    assign(dims.begin(), dims.end());
+  }
+
+  template <typename It>
+  ShapeVector(It first, It last)
+      : buf_(inline_), size_(0), capacity_(kInlineCapacity)
+  {
+    assign(first, last);
+  }
+
+  ShapeVector(const ShapeVector& rhs)
+      : buf_(inline_), size_(0), capacity_(kInlineCapacity)
+  {
+    assign(rhs.begin(), rhs.end());
+  }
+
+  ShapeVector(ShapeVector&& rhs)
+      : buf_(inline_), size_(0), capacity_(kInlineCapacity)
+  {
+    *this = std::move(rhs);
+  }
+
+  ~ShapeVector()
+  {
+    if (buf_ != inline_) {
+      delete[] buf_;
+    }
+  }
+
+  ShapeVector& operator=(const ShapeVector& rhs)
+  {
+    if (this != &rhs) {
+      assign(rhs.begin(), rhs.end());
+    }
+    return *this;
+  }
+
+  ShapeVector& operator=(ShapeVector&& rhs)
+  {
+    if (this != &rhs) {
+      if (rhs.buf_ == rhs.inline_) {
+        // Inline contents can't be stolen, copy them.
+        assign(rhs.begin(), rhs.end());
+        rhs.size_ = 0;
+      } else {
+        if (buf_ != inline_) {
+          delete[] buf_;
+        }
+        buf_ = rhs.buf_;
+        size_ = rhs.size_;
+        capacity_ = rhs.capacity_;
+        rhs.buf_ = rhs.inline_;
+        rhs.size_ = 0;
+        rhs.capacity_ = kInlineCapacity;
+      }
+    }
+    return *this;
+  }
+
+  // Implicit conversion for consumers that require a
+  // std::vector<int64_t>. Allocates.
+  operator std::vector<int64_t>() const
+  {
+    return std::vector<int64_t>(begin(), end());
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  void clear() { size_ = 0; }
+
+  int64_t* data() { return buf_; }
+  const int64_t* data() const { return buf_; }
+
+  iterator begin() { return buf_; }
+  iterator end() { return buf_ + size_; }
+  const_iterator begin() const { return buf_; }
+  const_iterator end() const { return buf_ + size_; }
+
+  int64_t& operator[](size_t idx) { return buf_[idx]; }
+  const int64_t& operator[](size_t idx) const { return buf_[idx]; }
+  int64_t& front() { return buf_[0]; }
+  const int64_t& front() const { return buf_[0]; }
+  int64_t& back() { return buf_[size_ - 1]; }
+  const int64_t& back() const { return buf_[size_ - 1]; }
+
+  void reserve(size_t capacity)
+  {
+    if (capacity > capacity_) {
+      Grow(capacity);
+    }
+  }
+
+  void push_back(int64_t dim)
+  {
+    if (size_ == capacity_) {
+      Grow(size_ + 1);
+    }
+    buf_[size_++] = dim;
+  }
+
+  // Insert 'dim' before 'pos'. Only forward shifting is required for
+  // shapes so no overlap-safe memmove is needed.
+  iterator insert(const_iterator pos, int64_t dim)
+  {
+    const size_t idx = pos - buf_;
+    if (size_ == capacity_) {
+      Grow(size_ + 1);
+    }
+    for (size_t i = size_; i > idx; i--) {
+      buf_[i] = buf_[i - 1];
+    }
+    buf_[idx] = dim;
+    size_++;
+    return buf_ + idx;
+  }
+
+  template <typename It>
+  void assign(It first, It last)
+  {
+    clear();
+    for (; first != last; ++first) {
+      push_back(static_cast<int64_t>(*first));
+    }
+  }
+
+  bool operator==(const ShapeVector& rhs) const
+  {
+    if (size_ != rhs.size_) {
+      return false;
+    }
+    for (size_t i = 0; i < size_; i++) {
+      if (buf_[i] != rhs.buf_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool operator!=(const ShapeVector& rhs) const { return !(*this == rhs); }
+
+ private:
+  // Covers the overwhelming majority of model shapes; larger shapes
+  // spill to the heap.
+  static const size_t kInlineCapacity = 8;
+
+  void Grow(size_t needed)
+  {
+    size_t new_capacity = capacity_ * 2;
+    if (new_capacity < needed) {
+      new_capacity = needed;
+    }
+    int64_t* new_buf = new int64_t[new_capacity];
+    for (size_t i = 0; i < size_; i++) {
+      new_buf[i] = buf_[i];
+    }
+    if (buf_ != inline_) {
+      delete[] buf_;
+    }
+    buf_ = new_buf;
+    capacity_ = new_capacity;
+  }
+
+  int64_t inline_[kInlineCapacity];
+  int64_t* buf_;
+  size_t size_;
+  size_t capacity_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -34,7 +34,7 @@ std::string
 Status::AsString() const
 {
   std::string str(CodeString(code_));
-  str += ": " + msg_;
+  str += ": " + Message();
   return str;
 }
 
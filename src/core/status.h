@@ -25,6 +25,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <memory>
 #include <string>
 #include "src/core/tritonserver.h"
 #include "src/core/trtserver.h"
@@ -46,11 +47,17 @@ class Status {
   };
 
  public:
-  // Construct a status from a code with no message.
+  // Construct a status from a code with no message. This is the hot
+  // path: a status without a message is just the code, no allocation
+  // is performed and copies are pointer-sized.
   explicit Status(Code code = Code::SUCCESS) : code_(code) {}
 
-  // Construct a status from a code and message.
-  explicit Status(Code code, const std::string& msg) : code_(code), msg_(msg) {}
+  // Construct a status from a code and message. The message is
+  // allocated once and shared by copies of the status.
+  explicit Status(Code code, const std::string& msg)
+      : code_(code), msg_(std::make_shared<const std::string>(msg))
+  {
+  }
 
   // Convenience "success" value. Can be used as Status::Success to
   // indicate no error.
@@ -60,7 +67,11 @@ class Status {
   Code StatusCode() const { return code_; }
 
   // Return the message for this status.
-  const std::string& Message() const { return msg_; }
+  const std::string& Message() const
+  {
+    static const std::string empty;
+    return (msg_ == nullptr) ? empty : *msg_;
+  }
 
   // Return true if this status indicates "ok"/"success", false if
   // status indicates some kind of failure.
@@ -74,7 +85,11 @@ class Status {
 
  private:
   Code code_;
-  std::string msg_;
+
+  // Error text, nullptr unless a message was provided. Kept behind a
+  // shared pointer so success statuses and copies never touch the
+  // allocator.
+  std::shared_ptr<const std::string> msg_;
 };
 
 // Return the Status::Code corresponding to a
@@ -37,7 +37,7 @@ namespace nvidia { namespace inferenceserver {
 template <typename Item>
 class SyncQueue {
  public:
-  SyncQueue() {}
+  SyncQueue() : waiting_cnt_(0) {}
 
   bool Empty()
   {
@@ -49,7 +49,9 @@ class SyncQueue {
   {
     std::unique_lock<std::mutex> lk(mu_);
     if (queue_.empty()) {
+      waiting_cnt_++;
       cv_.wait(lk, [this] { return !queue_.empty(); });
+      waiting_cnt_--;
     }
     auto res = queue_.front();
     queue_.pop_front();
@@ -58,17 +60,28 @@ class SyncQueue {
 
   void Put(const Item& value)
   {
+    bool wake = false;
     {
       std::lock_guard<std::mutex> lk(mu_);
       queue_.push_back(value);
+      wake = (waiting_cnt_ > 0);
+    }
+
+    // Each Put makes a single item available so at most one waiting
+    // Get needs to wake, and no wake syscall is needed at all when no
+    // Get is waiting.
+    if (wake) {
+      cv_.notify_one();
     }
-    cv_.notify_all();
   }
 
  private:
   std::mutex mu_;
   std::condition_variable cv_;
   std::deque<Item> queue_;
+
+  // Number of threads blocked in Get(). Protected by 'mu_'.
+  size_t waiting_cnt_;
 };
 
 }}  // namespace nvidia::inferenceserver
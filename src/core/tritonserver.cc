@@ -33,6 +33,7 @@
 #include "rapidjson/error/en.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
+#include "src/core/arena.h"
 #include "src/core/backend.h"
 #include "src/core/infer_request.h"
 #include "src/core/logging.h"
@@ -270,6 +271,15 @@ class TritonServerOptions {
   unsigned int ExitTimeout() const { return exit_timeout_; }
   void SetExitTimeout(unsigned int t) { exit_timeout_ = t; }
 
+  uint64_t MaxInflightRequests() const { return max_inflight_requests_; }
+  void SetMaxInflightRequests(uint64_t m) { max_inflight_requests_ = m; }
+
+  uint64_t MaxInflightByteSize() const { return max_inflight_byte_size_; }
+  void SetMaxInflightByteSize(uint64_t m) { max_inflight_byte_size_ = m; }
+
+  uint32_t ModelLoadConcurrency() const { return model_load_concurrency_; }
+  void SetModelLoadConcurrency(uint32_t c) { model_load_concurrency_ = c; }
+
   bool Metrics() const { return metrics_; }
   void SetMetrics(bool b) { metrics_ = b; }
 
@@ -282,6 +292,15 @@ class TritonServerOptions {
   float TensorFlowGpuMemoryFraction() const { return tf_gpu_mem_fraction_; }
   void SetTensorFlowGpuMemoryFraction(float f) { tf_gpu_mem_fraction_ = f; }
 
+  int TensorFlowSharedThreadPoolSize() const
+  {
+    return tf_shared_thread_pool_size_;
+  }
+  void SetTensorFlowSharedThreadPoolSize(int s)
+  {
+    tf_shared_thread_pool_size_ = s;
+  }
+
   const std::map<int, std::pair<int, uint64_t>>& TensorFlowVgpuMemoryLimits()
       const
   {
@@ -306,12 +325,16 @@ class TritonServerOptions {
   bool metrics_;
   bool gpu_metrics_;
   unsigned int exit_timeout_;
+  uint64_t max_inflight_requests_;
+  uint64_t max_inflight_byte_size_;
+  uint32_t model_load_concurrency_;
   uint64_t pinned_memory_pool_size_;
   std::map<int, uint64_t> cuda_memory_pool_size_;
   double min_compute_capability_;
 
   bool tf_soft_placement_;
   float tf_gpu_mem_fraction_;
+  int tf_shared_thread_pool_size_;
   std::map<int, std::pair<int, uint64_t>> tf_vgpu_memory_limits_;
 };
 
@@ -319,13 +342,16 @@ TritonServerOptions::TritonServerOptions()
     : server_id_("inference:0"), server_protocol_version_(1),
       model_control_mode_(ni::MODE_POLL), exit_on_error_(true),
       strict_model_config_(true), strict_readiness_(true), metrics_(true),
-      gpu_metrics_(true), exit_timeout_(30), pinned_memory_pool_size_(1 << 28),
+      gpu_metrics_(true), exit_timeout_(30), max_inflight_requests_(0),
+      max_inflight_byte_size_(0), model_load_concurrency_(0),
+      pinned_memory_pool_size_(1 << 28),
 #ifdef TRTIS_ENABLE_GPU
       min_compute_capability_(TRTIS_MIN_COMPUTE_CAPABILITY),
 #else
       min_compute_capability_(0),
 #endif  // TRTIS_ENABLE_GPU
-      tf_soft_placement_(true), tf_gpu_mem_fraction_(0)
+      tf_soft_placement_(true), tf_gpu_mem_fraction_(0),
+      tf_shared_thread_pool_size_(-1)
 {
 #ifndef TRTIS_ENABLE_METRICS
   metrics_ = false;
@@ -688,6 +714,10 @@ TRITONSERVER_ServerOptionsSetModelControlMode(
       loptions->SetModelControlMode(ni::MODE_EXPLICIT);
       break;
     }
+    case TRITONSERVER_MODEL_CONTROL_LAZY: {
+      loptions->SetModelControlMode(ni::MODE_LAZY);
+      break;
+    }
     default: {
       return TRITONSERVER_ErrorNew(
           TRITONSERVER_ERROR_INVALID_ARG,
@@ -779,6 +809,36 @@ TRITONSERVER_ServerOptionsSetExitTimeout(
   return nullptr;  // Success
 }
 
+TRITONSERVER_Error*
+TRITONSERVER_ServerOptionsSetMaxInflightRequests(
+    TRITONSERVER_ServerOptions* options, uint64_t max)
+{
+  TritonServerOptions* loptions =
+      reinterpret_cast<TritonServerOptions*>(options);
+  loptions->SetMaxInflightRequests(max);
+  return nullptr;  // Success
+}
+
+TRITONSERVER_Error*
+TRITONSERVER_ServerOptionsSetMaxInflightByteSize(
+    TRITONSERVER_ServerOptions* options, uint64_t max)
+{
+  TritonServerOptions* loptions =
+      reinterpret_cast<TritonServerOptions*>(options);
+  loptions->SetMaxInflightByteSize(max);
+  return nullptr;  // Success
+}
+
+TRITONSERVER_Error*
+TRITONSERVER_ServerOptionsSetModelLoadConcurrency(
+    TRITONSERVER_ServerOptions* options, uint32_t concurrency)
+{
+  TritonServerOptions* loptions =
+      reinterpret_cast<TritonServerOptions*>(options);
+  loptions->SetModelLoadConcurrency(concurrency);
+  return nullptr;  // Success
+}
+
 TRITONSERVER_Error*
 TRITONSERVER_ServerOptionsSetLogInfo(
     TRITONSERVER_ServerOptions* options, bool log)
@@ -888,6 +948,16 @@ TRITONSERVER_ServerOptionsSetTensorFlowGpuMemoryFraction(
   return nullptr;  // Success
 }
 
+TRITONSERVER_Error*
+TRITONSERVER_ServerOptionsSetTensorFlowSharedThreadPoolSize(
+    TRITONSERVER_ServerOptions* options, int size)
+{
+  TritonServerOptions* loptions =
+      reinterpret_cast<TritonServerOptions*>(options);
+  loptions->SetTensorFlowSharedThreadPoolSize(size);
+  return nullptr;  // Success
+}
+
 TRITONSERVER_Error*
 TRITONSERVER_ServerOptionsAddTensorFlowVgpuMemoryLimits(
     TRITONSERVER_ServerOptions* options, int gpu_device, int num_vgpus,
@@ -931,10 +1001,15 @@ TRITONSERVER_ServerNew(
       loptions->MinSupportedComputeCapability());
   lserver->SetStrictReadinessEnabled(loptions->StrictReadiness());
   lserver->SetExitTimeoutSeconds(loptions->ExitTimeout());
+  lserver->SetMaxInflightRequests(loptions->MaxInflightRequests());
+  lserver->SetMaxInflightByteSize(loptions->MaxInflightByteSize());
+  lserver->SetModelLoadConcurrency(loptions->ModelLoadConcurrency());
   lserver->SetTensorFlowSoftPlacementEnabled(
       loptions->TensorFlowSoftPlacement());
   lserver->SetTensorFlowGPUMemoryFraction(
       loptions->TensorFlowGpuMemoryFraction());
+  lserver->SetTensorFlowSharedThreadPoolSize(
+      loptions->TensorFlowSharedThreadPoolSize());
   lserver->SetTensorFlowVGPUMemoryLimits(
       loptions->TensorFlowVgpuMemoryLimits());
 
@@ -973,6 +1048,16 @@ TRITONSERVER_ServerStop(TRITONSERVER_Server* server)
   return nullptr;  // Success
 }
 
+TRITONSERVER_Error*
+TRITONSERVER_ServerDrain(TRITONSERVER_Server* server)
+{
+  ni::InferenceServer* lserver = reinterpret_cast<ni::InferenceServer*>(server);
+  if (lserver != nullptr) {
+    RETURN_IF_STATUS_ERROR(lserver->Drain());
+  }
+  return nullptr;  // Success
+}
+
 TRITONSERVER_Error*
 TRITONSERVER_ServerPollModelRepository(TRITONSERVER_Server* server)
 {
@@ -1758,9 +1843,15 @@ TRITONSERVER_ServerInferAsync(
   ltrtrequest->SetResponse(nullptr);
   RETURN_IF_STATUS_ERROR(lrequest->PrepareForInference(*lbackend));
 
+  // Per-request objects are placed in a pooled arena so they are
+  // allocated with a single bump allocation and freed wholesale when
+  // the request completes.
+  auto arena = ni::ArenaPool::Get();
+
 #ifdef TRTIS_ENABLE_STATS
-  auto infer_stats = std::make_shared<ni::ModelInferStats>(
-      lserver->StatusManager(), lrequest->ModelName());
+  auto infer_stats = std::allocate_shared<ni::ModelInferStats>(
+      ni::ArenaAllocator<ni::ModelInferStats>(arena), lserver->StatusManager(),
+      lrequest->ModelName());
   infer_stats->CaptureTimestamp(
       ni::ModelInferStats::TimestampKind::kRequestStart);
   infer_stats->SetRequestedVersion(lrequest->RequestedModelVersion());
@@ -1771,7 +1862,8 @@ TRITONSERVER_ServerInferAsync(
       reinterpret_cast<ni::OpaqueTraceManager*>(trace_manager));
   infer_stats->NewTrace();
 #else
-  auto infer_stats = std::make_shared<ni::ModelInferStats>();
+  auto infer_stats = std::allocate_shared<ni::ModelInferStats>(
+      ni::ArenaAllocator<ni::ModelInferStats>(arena));
 #endif  // TRTIS_ENABLE_STATS
 
   std::shared_ptr<ni::InferResponseProvider> infer_response_provider;
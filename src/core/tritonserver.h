@@ -719,7 +719,8 @@ TRITONSERVER_InferenceRequestRemoveAllOutputs(
 typedef enum tritonserver_modelcontrolmode_enum {
   TRITONSERVER_MODEL_CONTROL_NONE,
   TRITONSERVER_MODEL_CONTROL_POLL,
-  TRITONSERVER_MODEL_CONTROL_EXPLICIT
+  TRITONSERVER_MODEL_CONTROL_EXPLICIT,
+  TRITONSERVER_MODEL_CONTROL_LAZY
 } TRITONSERVER_Model_Control_Mode;
 
 /// Create a new server options object. The caller takes ownership of
@@ -773,6 +774,12 @@ TRITONSERVER_ServerOptionsSetModelRepositoryPath(
 ///   not be loaded on startup. The corresponding model control APIs must be
 ///   called to load / unload a model in the model repository.
 ///
+///   TRITONSERVER_MODEL_CONTROL_LAZY: the configurations of the models in the
+///   model repository will be registered on startup but each model will be
+///   loaded when the first inference request for it arrives. That first
+///   request waits for the load to complete. Models set with
+///   TRITONSERVER_ServerOptionsSetStartupModel are loaded on startup.
+///
 /// \param options The server options object.
 /// \param mode The mode to use for the model control.
 /// \return a TRITONSERVER_Error indicating success or failure.
@@ -784,7 +791,8 @@ TRITONSERVER_ServerOptionsSetModelControlMode(
 /// present in one, and only one, of the specified model repositories.
 /// This function can be called multiple times with different model name
 /// to set multiple startup models.
-/// Note that it only takes affect on TRITONSERVER_MODEL_CONTROL_EXPLICIT mode.
+/// Note that it only takes affect on TRITONSERVER_MODEL_CONTROL_EXPLICIT and
+/// TRITONSERVER_MODEL_CONTROL_LAZY modes.
 /// \param options The server options object.
 /// \param mode_name The name of the model to load on startup.
 /// \return a TRITONSERVER_Error indicating success or failure.
@@ -859,6 +867,35 @@ TRITONSERVER_EXPORT TRITONSERVER_Error*
 TRITONSERVER_ServerOptionsSetExitTimeout(
     TRITONSERVER_ServerOptions* options, unsigned int timeout);
 
+/// Set the maximum number of in-flight inference requests in a server
+/// options.
+/// \param options The server options object.
+/// \param max The maximum number of in-flight requests, or 0 for no
+/// limit.
+/// \return a TRITONSERVER_Error indicating success or failure.
+TRITONSERVER_EXPORT TRITONSERVER_Error*
+TRITONSERVER_ServerOptionsSetMaxInflightRequests(
+    TRITONSERVER_ServerOptions* options, uint64_t max);
+
+/// Set the maximum total input byte size of in-flight inference
+/// requests in a server options.
+/// \param options The server options object.
+/// \param max The maximum total input byte size, or 0 for no limit.
+/// \return a TRITONSERVER_Error indicating success or failure.
+TRITONSERVER_EXPORT TRITONSERVER_Error*
+TRITONSERVER_ServerOptionsSetMaxInflightByteSize(
+    TRITONSERVER_ServerOptions* options, uint64_t max);
+
+/// Set the maximum number of models that may be loading concurrently
+/// in a server options.
+/// \param options The server options object.
+/// \param concurrency The maximum number of concurrent model loads,
+/// or 0 for no limit.
+/// \return a TRITONSERVER_Error indicating success or failure.
+TRITONSERVER_EXPORT TRITONSERVER_Error*
+TRITONSERVER_ServerOptionsSetModelLoadConcurrency(
+    TRITONSERVER_ServerOptions* options, uint32_t concurrency);
+
 /// Enable or disable info level logging.
 /// \param options The server options object.
 /// \param log True to enable info logging, false to disable.
@@ -923,6 +960,18 @@ TRITONSERVER_EXPORT TRITONSERVER_Error*
 TRITONSERVER_ServerOptionsSetTensorFlowGpuMemoryFraction(
     TRITONSERVER_ServerOptions* options, float fraction);
 
+/// Set the size of the thread pool shared by all TensorFlow sessions
+/// created by the inference server. A value less than zero (the
+/// default) causes each session to create its own thread pools. Zero
+/// (0) shares a pool sized by TensorFlow based on the number of CPU
+/// cores.
+/// \param options The server options object.
+/// \param size The number of threads in the shared pool.
+/// \return a TRITONSERVER_Error indicating success or failure.
+TRITONSERVER_EXPORT TRITONSERVER_Error*
+TRITONSERVER_ServerOptionsSetTensorFlowSharedThreadPoolSize(
+    TRITONSERVER_ServerOptions* options, int size);
+
 /// Add Tensorflow virtual GPU instances to a physical GPU.
 /// \param options The server options object.
 /// \param gpu_device The physical GPU device id.
@@ -964,6 +1013,16 @@ TRITONSERVER_EXPORT TRITONSERVER_Error* TRITONSERVER_ServerDelete(
 TRITONSERVER_EXPORT TRITONSERVER_Error* TRITONSERVER_ServerStop(
     TRITONSERVER_Server* server);
 
+/// Drain a server object. The server stops accepting new inference
+/// requests and reports not-ready, but remains live and waits for
+/// in-flight requests to complete before returning. A server can't
+/// return to the ready state once it is drained. Returns an error if
+/// the exit timeout expires with requests still in flight.
+/// \param server The inference server object.
+/// \return a TRITONSERVER_Error indicating success or failure.
+TRITONSERVER_EXPORT TRITONSERVER_Error* TRITONSERVER_ServerDrain(
+    TRITONSERVER_Server* server);
+
 /// Check the model repository for changes and update server state
 /// based on those changes.
 /// \param server The inference server object.
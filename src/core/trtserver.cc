@@ -26,9 +26,15 @@
 
 #include "src/core/trtserver.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <vector>
+#include "src/core/arena.h"
 #include "src/core/backend.h"
+#include "src/core/constants.h"
 #include "src/core/infer_request.h"
 #include "src/core/logging.h"
 #include "src/core/metrics.h"
@@ -123,16 +129,25 @@ class TrtServerResponseAllocator {
   {
     return release_fn_;
   }
+  TRTSERVER_ResponseAllocatorOutputReadyFn_t OutputReadyFn() const
+  {
+    return output_ready_fn_;
+  }
+  void SetOutputReadyFn(TRTSERVER_ResponseAllocatorOutputReadyFn_t fn)
+  {
+    output_ready_fn_ = fn;
+  }
 
  private:
   TRTSERVER_ResponseAllocatorAllocFn_t alloc_fn_;
   TRTSERVER_ResponseAllocatorReleaseFn_t release_fn_;
+  TRTSERVER_ResponseAllocatorOutputReadyFn_t output_ready_fn_;
 };
 
 TrtServerResponseAllocator::TrtServerResponseAllocator(
     TRTSERVER_ResponseAllocatorAllocFn_t alloc_fn,
     TRTSERVER_ResponseAllocatorReleaseFn_t release_fn)
-    : alloc_fn_(alloc_fn), release_fn_(release_fn)
+    : alloc_fn_(alloc_fn), release_fn_(release_fn), output_ready_fn_(nullptr)
 {
 }
 
@@ -256,6 +271,15 @@ class TrtServerOptions {
   unsigned int ExitTimeout() const { return exit_timeout_; }
   void SetExitTimeout(unsigned int t) { exit_timeout_ = t; }
 
+  uint64_t MaxInflightRequests() const { return max_inflight_requests_; }
+  void SetMaxInflightRequests(uint64_t m) { max_inflight_requests_ = m; }
+
+  uint64_t MaxInflightByteSize() const { return max_inflight_byte_size_; }
+  void SetMaxInflightByteSize(uint64_t m) { max_inflight_byte_size_ = m; }
+
+  uint32_t ModelLoadConcurrency() const { return model_load_concurrency_; }
+  void SetModelLoadConcurrency(uint32_t c) { model_load_concurrency_ = c; }
+
   bool Metrics() const { return metrics_; }
   void SetMetrics(bool b) { metrics_ = b; }
 
@@ -268,6 +292,15 @@ class TrtServerOptions {
   float TensorFlowGpuMemoryFraction() const { return tf_gpu_mem_fraction_; }
   void SetTensorFlowGpuMemoryFraction(float f) { tf_gpu_mem_fraction_ = f; }
 
+  int TensorFlowSharedThreadPoolSize() const
+  {
+    return tf_shared_thread_pool_size_;
+  }
+  void SetTensorFlowSharedThreadPoolSize(int s)
+  {
+    tf_shared_thread_pool_size_ = s;
+  }
+
   const std::map<int, std::pair<int, uint64_t>>& TensorFlowVgpuMemoryLimits()
       const
   {
@@ -292,12 +325,16 @@ class TrtServerOptions {
   bool metrics_;
   bool gpu_metrics_;
   unsigned int exit_timeout_;
+  uint64_t max_inflight_requests_;
+  uint64_t max_inflight_byte_size_;
+  uint32_t model_load_concurrency_;
   uint64_t pinned_memory_pool_size_;
   std::map<int, uint64_t> cuda_memory_pool_size_;
   double min_compute_capability_;
 
   bool tf_soft_placement_;
   float tf_gpu_mem_fraction_;
+  int tf_shared_thread_pool_size_;
   std::map<int, std::pair<int, uint64_t>> tf_vgpu_memory_limits_;
 };
 
@@ -305,13 +342,16 @@ TrtServerOptions::TrtServerOptions()
     : server_id_("inference:0"), server_protocol_version_(1),
       model_control_mode_(ni::MODE_POLL), exit_on_error_(true),
       strict_model_config_(true), strict_readiness_(true), metrics_(true),
-      gpu_metrics_(true), exit_timeout_(30), pinned_memory_pool_size_(1 << 28),
+      gpu_metrics_(true), exit_timeout_(30), max_inflight_requests_(0),
+      max_inflight_byte_size_(0), model_load_concurrency_(0),
+      pinned_memory_pool_size_(1 << 28),
 #ifdef TRTIS_ENABLE_GPU
       min_compute_capability_(TRTIS_MIN_COMPUTE_CAPABILITY),
 #else
       min_compute_capability_(0),
 #endif  // TRTIS_ENABLE_GPU
-      tf_soft_placement_(true), tf_gpu_mem_fraction_(0)
+      tf_soft_placement_(true), tf_gpu_mem_fraction_(0),
+      tf_shared_thread_pool_size_(-1)
 {
 #ifndef TRTIS_ENABLE_METRICS
   metrics_ = false;
@@ -344,6 +384,7 @@ class TrtServerRequestOptions {
   TRTSERVER_Error* SetBatchSize(uint64_t batch_size);
   TRTSERVER_Error* SetPriority(uint32_t priority);
   TRTSERVER_Error* SetTimeoutMicroseconds(uint64_t timeout_us);
+  TRTSERVER_Error* SetDeadlineMicroseconds(uint64_t deadline_us);
 
   TRTSERVER_Error* AddInput(
       const char* input_name, const int64_t* dims, uint64_t dim_count,
@@ -353,6 +394,7 @@ class TrtServerRequestOptions {
 
   const std::string& ModelName() const { return model_name_; }
   int64_t ModelVersion() const { return model_version_; }
+  uint64_t DeadlineNanoseconds() const { return deadline_ns_; }
   ni::InferRequestHeader* InferRequestHeader() const;
 #ifdef TRTIS_ENABLE_GRPC_V2
   const std::string& IdStr() const { return id_str_; }
@@ -368,12 +410,16 @@ class TrtServerRequestOptions {
 
   std::shared_ptr<ni::InferRequestHeader> request_header_;
 
+  // Absolute request deadline on the monotonic clock, in ns. 0
+  // indicates no deadline.
+  uint64_t deadline_ns_;
+
   std::mutex mtx_;
 };
 
 TrtServerRequestOptions::TrtServerRequestOptions(
     const char* model_name, int64_t model_version)
-    : model_name_(model_name), model_version_(model_version)
+    : model_name_(model_name), model_version_(model_version), deadline_ns_(0)
 {
   request_header_ = std::make_shared<ni::InferRequestHeader>();
 }
@@ -382,7 +428,7 @@ TrtServerRequestOptions::TrtServerRequestOptions(
     const char* model_name, int64_t model_version,
     const std::shared_ptr<ni::InferRequestHeader>& request_header)
     : model_name_(model_name), model_version_(model_version),
-      request_header_(request_header)
+      request_header_(request_header), deadline_ns_(0)
 {
 }
 
@@ -444,6 +490,20 @@ TrtServerRequestOptions::SetTimeoutMicroseconds(uint64_t timeout_us)
   return nullptr;  // Success
 }
 
+TRTSERVER_Error*
+TrtServerRequestOptions::SetDeadlineMicroseconds(uint64_t deadline_us)
+{
+  std::lock_guard<std::mutex> lk(mtx_);
+  if (deadline_us == 0) {
+    deadline_ns_ = 0;
+  } else {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    deadline_ns_ = TIMESPEC_TO_NANOS(now) + deadline_us * 1000;
+  }
+  return nullptr;  // Success
+}
+
 TRTSERVER_Error*
 TrtServerRequestOptions::AddInput(
     const char* input_name, const int64_t* dims, uint64_t dim_count,
@@ -527,6 +587,30 @@ class TrtInferenceRequest {
   std::shared_ptr<ni::InferResponseProvider> response_provider_;
 };
 
+//
+// TrtServerModelHandle
+//
+// Implementation for TRTSERVER_ModelHandle. Holding the backend
+// shared pointer pins the model version against unload for the
+// lifetime of the handle.
+//
+class TrtServerModelHandle {
+ public:
+  explicit TrtServerModelHandle(
+      const std::shared_ptr<ni::InferenceBackend>& backend)
+      : backend_(backend)
+  {
+  }
+
+  const std::shared_ptr<ni::InferenceBackend>& Backend() const
+  {
+    return backend_;
+  }
+
+ private:
+  std::shared_ptr<ni::InferenceBackend> backend_;
+};
+
 //
 // TrtServerResponse
 //
@@ -622,6 +706,49 @@ TrtServerModelIndex::GetModelNames(
   return nullptr;
 }
 
+// Create a request provider for an already-resolved 'backend'.
+// 'model_name' and 'requested_version' are recorded in the request as
+// what the caller asked for, which may differ from the resolved
+// backend version when the latest version was requested.
+TRTSERVER_Error*
+InferenceRequestProviderNewInternal(
+    TRTSERVER_InferenceRequestProvider** request_provider,
+    ni::InferenceServer* lserver,
+    const std::shared_ptr<ni::InferenceBackend>& backend,
+    const std::string& model_name, const int64_t requested_version,
+    TrtServerRequestOptions* loptions)
+{
+  std::unique_ptr<ni::InferenceRequest> request(new ni::InferenceRequest(
+      model_name, requested_version, backend->Version(),
+      lserver->ProtocolVersion()));
+  request->SetId(loptions->InferRequestHeader()->id());
+#ifdef TRTIS_ENABLE_GRPC_V2
+  request->SetIdStr(loptions->IdStr());
+#endif  // TRTIS_ENABLE_GRPC_V2
+  request->SetFlags(loptions->InferRequestHeader()->flags());
+  request->SetCorrelationId(loptions->InferRequestHeader()->correlation_id());
+  request->SetBatchSize(loptions->InferRequestHeader()->batch_size());
+  request->SetPriority(loptions->InferRequestHeader()->priority());
+  request->SetTimeoutMicroseconds(
+      loptions->InferRequestHeader()->timeout_microseconds());
+  request->SetDeadlineNanoseconds(loptions->DeadlineNanoseconds());
+  for (const auto& io : loptions->InferRequestHeader()->input()) {
+    RETURN_IF_STATUS_ERROR(
+        request->AddOriginalInput(io.name(), io.dims(), io.batch_byte_size()));
+  }
+
+  for (const auto& io : loptions->InferRequestHeader()->output()) {
+    uint32_t cls_cnt = io.has_cls() ? io.cls().count() : 0;
+    RETURN_IF_STATUS_ERROR(request->AddRequestedOutput(io.name(), cls_cnt));
+  }
+
+  RETURN_IF_STATUS_ERROR(request->PrepareForInference(*backend));
+
+  *request_provider = reinterpret_cast<TRTSERVER_InferenceRequestProvider*>(
+      new TrtInferenceRequest(backend, request.release()));
+
+  return nullptr;  // Success
+}
 
 }  // namespace
 
@@ -680,6 +807,17 @@ TRTSERVER_ResponseAllocatorNew(
   return nullptr;  // Success
 }
 
+TRTSERVER_Error*
+TRTSERVER_ResponseAllocatorSetOutputReadyFn(
+    TRTSERVER_ResponseAllocator* allocator,
+    TRTSERVER_ResponseAllocatorOutputReadyFn_t output_ready_fn)
+{
+  TrtServerResponseAllocator* lalloc =
+      reinterpret_cast<TrtServerResponseAllocator*>(allocator);
+  lalloc->SetOutputReadyFn(output_ready_fn);
+  return nullptr;  // Success
+}
+
 TRTSERVER_Error*
 TRTSERVER_ResponseAllocatorDelete(TRTSERVER_ResponseAllocator* allocator)
 {
@@ -952,6 +1090,16 @@ TRTSERVER_InferenceRequestOptionsSetTimeoutMicroseconds(
   return nullptr;  // Success
 }
 
+TRTSERVER_Error*
+TRTSERVER_InferenceRequestOptionsSetDeadlineMicroseconds(
+    TRTSERVER_InferenceRequestOptions* request_options, uint64_t deadline_us)
+{
+  TrtServerRequestOptions* loptions =
+      reinterpret_cast<TrtServerRequestOptions*>(request_options);
+  loptions->SetDeadlineMicroseconds(deadline_us);
+  return nullptr;  // Success
+}
+
 TRTSERVER_Error*
 TRTSERVER_InferenceRequestOptionsAddInput(
     TRTSERVER_InferenceRequestOptions* request_options, const char* input_name,
@@ -994,6 +1142,34 @@ TRTSERVER_InferenceRequestOptionsDelete(
   return nullptr;  // Success
 }
 
+//
+// TRTSERVER_ModelHandle
+//
+TRTSERVER_Error*
+TRTSERVER_ServerModelHandleNew(
+    TRTSERVER_ModelHandle** model_handle, TRTSERVER_Server* server,
+    const char* model_name, int64_t model_version)
+{
+  ni::InferenceServer* lserver = reinterpret_cast<ni::InferenceServer*>(server);
+
+  std::shared_ptr<ni::InferenceBackend> backend;
+  RETURN_IF_STATUS_ERROR(lserver->GetInferenceBackend(
+      std::string(model_name), model_version, &backend));
+
+  *model_handle = reinterpret_cast<TRTSERVER_ModelHandle*>(
+      new TrtServerModelHandle(backend));
+  return nullptr;  // Success
+}
+
+TRTSERVER_Error*
+TRTSERVER_ModelHandleDelete(TRTSERVER_ModelHandle* model_handle)
+{
+  TrtServerModelHandle* lhandle =
+      reinterpret_cast<TrtServerModelHandle*>(model_handle);
+  delete lhandle;
+  return nullptr;  // Success
+}
+
 //
 // TRTSERVER_InferenceRequestProvider
 //
@@ -1034,35 +1210,27 @@ TRTSERVER_InferenceRequestProviderNewV2(
   RETURN_IF_STATUS_ERROR(lserver->GetInferenceBackend(
       loptions->ModelName(), loptions->ModelVersion(), &backend));
 
-  std::unique_ptr<ni::InferenceRequest> request(new ni::InferenceRequest(
-      loptions->ModelName(), loptions->ModelVersion(), backend->Version(),
-      lserver->ProtocolVersion()));
-  request->SetId(loptions->InferRequestHeader()->id());
-#ifdef TRTIS_ENABLE_GRPC_V2
-  request->SetIdStr(loptions->IdStr());
-#endif  // TRTIS_ENABLE_GRPC_V2
-  request->SetFlags(loptions->InferRequestHeader()->flags());
-  request->SetCorrelationId(loptions->InferRequestHeader()->correlation_id());
-  request->SetBatchSize(loptions->InferRequestHeader()->batch_size());
-  request->SetPriority(loptions->InferRequestHeader()->priority());
-  request->SetTimeoutMicroseconds(
-      loptions->InferRequestHeader()->timeout_microseconds());
-  for (const auto& io : loptions->InferRequestHeader()->input()) {
-    RETURN_IF_STATUS_ERROR(
-        request->AddOriginalInput(io.name(), io.dims(), io.batch_byte_size()));
-  }
-
-  for (const auto& io : loptions->InferRequestHeader()->output()) {
-    uint32_t cls_cnt = io.has_cls() ? io.cls().count() : 0;
-    RETURN_IF_STATUS_ERROR(request->AddRequestedOutput(io.name(), cls_cnt));
-  }
-
-  RETURN_IF_STATUS_ERROR(request->PrepareForInference(*backend));
+  return InferenceRequestProviderNewInternal(
+      request_provider, lserver, backend, loptions->ModelName(),
+      loptions->ModelVersion(), loptions);
+}
 
-  *request_provider = reinterpret_cast<TRTSERVER_InferenceRequestProvider*>(
-      new TrtInferenceRequest(backend, request.release()));
+TRTSERVER_Error*
+TRTSERVER_InferenceRequestProviderNewWithHandle(
+    TRTSERVER_InferenceRequestProvider** request_provider,
+    TRTSERVER_Server* server, TRTSERVER_ModelHandle* model_handle,
+    TRTSERVER_InferenceRequestOptions* request_options)
+{
+  ni::InferenceServer* lserver = reinterpret_cast<ni::InferenceServer*>(server);
+  TrtServerModelHandle* lhandle =
+      reinterpret_cast<TrtServerModelHandle*>(model_handle);
+  TrtServerRequestOptions* loptions =
+      reinterpret_cast<TrtServerRequestOptions*>(request_options);
 
-  return nullptr;  // Success
+  const auto& backend = lhandle->Backend();
+  return InferenceRequestProviderNewInternal(
+      request_provider, lserver, backend, backend->Name(), backend->Version(),
+      loptions);
 }
 
 TRTSERVER_Error*
@@ -1075,6 +1243,16 @@ TRTSERVER_InferenceRequestProviderDelete(
   return nullptr;  // Success
 }
 
+TRTSERVER_Error*
+TRTSERVER_InferenceRequestProviderCancel(
+    TRTSERVER_InferenceRequestProvider* request_provider)
+{
+  TrtInferenceRequest* ltrtrequest =
+      reinterpret_cast<TrtInferenceRequest*>(request_provider);
+  ltrtrequest->Request()->Cancel();
+  return nullptr;  // Success
+}
+
 TRTSERVER_Error*
 TRTSERVER_InferenceRequestProviderInputBatchByteSize(
     TRTSERVER_InferenceRequestProvider* request_provider, const char* name,
@@ -1236,6 +1414,10 @@ TRTSERVER_ServerOptionsSetModelControlMode(
       loptions->SetModelControlMode(ni::MODE_EXPLICIT);
       break;
     }
+    case TRTSERVER_MODEL_CONTROL_LAZY: {
+      loptions->SetModelControlMode(ni::MODE_LAZY);
+      break;
+    }
     default: {
       return TRTSERVER_ErrorNew(
           TRTSERVER_ERROR_INVALID_ARG,
@@ -1319,6 +1501,33 @@ TRTSERVER_ServerOptionsSetExitTimeout(
   return nullptr;  // Success
 }
 
+TRTSERVER_Error*
+TRTSERVER_ServerOptionsSetMaxInflightRequests(
+    TRTSERVER_ServerOptions* options, uint64_t max)
+{
+  TrtServerOptions* loptions = reinterpret_cast<TrtServerOptions*>(options);
+  loptions->SetMaxInflightRequests(max);
+  return nullptr;  // Success
+}
+
+TRTSERVER_Error*
+TRTSERVER_ServerOptionsSetMaxInflightByteSize(
+    TRTSERVER_ServerOptions* options, uint64_t max)
+{
+  TrtServerOptions* loptions = reinterpret_cast<TrtServerOptions*>(options);
+  loptions->SetMaxInflightByteSize(max);
+  return nullptr;  // Success
+}
+
+TRTSERVER_Error*
+TRTSERVER_ServerOptionsSetModelLoadConcurrency(
+    TRTSERVER_ServerOptions* options, uint32_t concurrency)
+{
+  TrtServerOptions* loptions = reinterpret_cast<TrtServerOptions*>(options);
+  loptions->SetModelLoadConcurrency(concurrency);
+  return nullptr;  // Success
+}
+
 TRTSERVER_Error*
 TRTSERVER_ServerOptionsSetLogInfo(TRTSERVER_ServerOptions* options, bool log)
 {
@@ -1421,6 +1630,15 @@ TRTSERVER_ServerOptionsSetTensorFlowGpuMemoryFraction(
   return nullptr;  // Success
 }
 
+TRTSERVER_Error*
+TRTSERVER_ServerOptionsSetTensorFlowSharedThreadPoolSize(
+    TRTSERVER_ServerOptions* options, int size)
+{
+  TrtServerOptions* loptions = reinterpret_cast<TrtServerOptions*>(options);
+  loptions->SetTensorFlowSharedThreadPoolSize(size);
+  return nullptr;  // Success
+}
+
 TRTSERVER_Error*
 TRTSERVER_ServerOptionsAddTensorFlowVgpuMemoryLimits(
     TRTSERVER_ServerOptions* options, int gpu_device, int num_vgpus,
@@ -1461,10 +1679,15 @@ TRTSERVER_ServerNew(TRTSERVER_Server** server, TRTSERVER_ServerOptions* options)
       loptions->MinSupportedComputeCapability());
   lserver->SetStrictReadinessEnabled(loptions->StrictReadiness());
   lserver->SetExitTimeoutSeconds(loptions->ExitTimeout());
+  lserver->SetMaxInflightRequests(loptions->MaxInflightRequests());
+  lserver->SetMaxInflightByteSize(loptions->MaxInflightByteSize());
+  lserver->SetModelLoadConcurrency(loptions->ModelLoadConcurrency());
   lserver->SetTensorFlowSoftPlacementEnabled(
       loptions->TensorFlowSoftPlacement());
   lserver->SetTensorFlowGPUMemoryFraction(
       loptions->TensorFlowGpuMemoryFraction());
+  lserver->SetTensorFlowSharedThreadPoolSize(
+      loptions->TensorFlowSharedThreadPoolSize());
   lserver->SetTensorFlowVGPUMemoryLimits(
       loptions->TensorFlowVgpuMemoryLimits());
 
@@ -1740,9 +1963,15 @@ TRTSERVER_ServerInferAsync(
   ltrtrequest->SetResponse(nullptr);
   RETURN_IF_STATUS_ERROR(lrequest->PrepareForInference(*lbackend));
 
+  // Per-request objects are placed in a pooled arena so they are
+  // allocated with a single bump allocation and freed wholesale when
+  // the request completes.
+  auto arena = ni::ArenaPool::Get();
+
 #ifdef TRTIS_ENABLE_STATS
-  auto infer_stats = std::make_shared<ni::ModelInferStats>(
-      lserver->StatusManager(), lrequest->ModelName());
+  auto infer_stats = std::allocate_shared<ni::ModelInferStats>(
+      ni::ArenaAllocator<ni::ModelInferStats>(arena), lserver->StatusManager(),
+      lrequest->ModelName());
   infer_stats->CaptureTimestamp(
       ni::ModelInferStats::TimestampKind::kRequestStart);
   infer_stats->SetRequestedVersion(lrequest->RequestedModelVersion());
@@ -1753,7 +1982,8 @@ TRTSERVER_ServerInferAsync(
       reinterpret_cast<ni::OpaqueTraceManager*>(trace_manager));
   infer_stats->NewTrace();
 #else
-  auto infer_stats = std::make_shared<ni::ModelInferStats>();
+  auto infer_stats = std::allocate_shared<ni::ModelInferStats>(
+      ni::ArenaAllocator<ni::ModelInferStats>(arena));
 #endif  // TRTIS_ENABLE_STATS
 
   std::shared_ptr<ni::InferResponseProvider> infer_response_provider;
@@ -1767,6 +1997,20 @@ TRTSERVER_ServerInferAsync(
     infer_response_provider = std::move(del_response_provider);
   }
 
+  // If the allocator wants per-output completion, forward each
+  // output-ready report to it with this request's 'userp'.
+  if (lresponsealloc->OutputReadyFn() != nullptr) {
+    TRTSERVER_ResponseAllocatorOutputReadyFn_t output_ready_fn =
+        lresponsealloc->OutputReadyFn();
+    void* userp = response_allocator_userp;
+    infer_response_provider->SetOutputReadyCallback(
+        [response_allocator, output_ready_fn, userp](
+            const std::string& name, const void* content, size_t byte_size) {
+          output_ready_fn(
+              response_allocator, name.c_str(), content, byte_size, userp);
+        });
+  }
+
 #ifdef TRTIS_ENABLE_GRPC_V2
   const std::string& id_str = lrequest->IdStr();
 #else
@@ -1805,6 +2049,83 @@ TRTSERVER_ServerInferAsync(
   return nullptr;  // Success
 }
 
+namespace {
+
+// Completion rendezvous for TRTSERVER_ServerInferSync. The waiting
+// thread spins on 'done_' for a short window before falling back to
+// the condition variable so a quickly-completing inference doesn't
+// pay a sleep/wakeup handoff.
+struct SyncInferCompletion {
+  SyncInferCompletion() : done_(false), response_(nullptr) {}
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::atomic<bool> done_;
+  TRTSERVER_InferenceResponse* response_;
+};
+
+// How long the calling thread spins waiting for a synchronous
+// inference to complete before blocking.
+constexpr int64_t kSyncInferSpinMicroseconds = 50;
+
+void
+SyncInferComplete(
+    TRTSERVER_Server* server, TRTSERVER_TraceManager* trace_manager,
+    TRTSERVER_InferenceResponse* response, void* userp)
+{
+  SyncInferCompletion* completion =
+      reinterpret_cast<SyncInferCompletion*>(userp);
+
+  {
+    std::lock_guard<std::mutex> lock(completion->mtx_);
+    completion->response_ = response;
+    completion->done_.store(true, std::memory_order_release);
+  }
+
+  completion->cv_.notify_one();
+}
+
+}  // namespace
+
+TRTSERVER_Error*
+TRTSERVER_ServerInferSync(
+    TRTSERVER_Server* server, TRTSERVER_TraceManager* trace_manager,
+    TRTSERVER_InferenceRequestProvider* request_provider,
+    TRTSERVER_ResponseAllocator* response_allocator,
+    void* response_allocator_userp, TRTSERVER_InferenceResponse** response)
+{
+  SyncInferCompletion completion;
+
+  TRTSERVER_Error* err = TRTSERVER_ServerInferAsync(
+      server, trace_manager, request_provider, response_allocator,
+      response_allocator_userp, SyncInferComplete, &completion);
+  if (err != nullptr) {
+    return err;
+  }
+
+  // Spin briefly before blocking. When the scheduler admits the
+  // request immediately and the model executes quickly, the response
+  // is ready within the spin window and the calling thread avoids
+  // the wakeup latency of the condition variable.
+  if (!completion.done_.load(std::memory_order_acquire)) {
+    const auto spin_deadline =
+        std::chrono::steady_clock::now() +
+        std::chrono::microseconds(kSyncInferSpinMicroseconds);
+    while (!completion.done_.load(std::memory_order_acquire)) {
+      if (std::chrono::steady_clock::now() >= spin_deadline) {
+        std::unique_lock<std::mutex> lock(completion.mtx_);
+        completion.cv_.wait(lock, [&completion] {
+          return completion.done_.load(std::memory_order_acquire);
+        });
+        break;
+      }
+    }
+  }
+
+  *response = completion.response_;
+  return nullptr;  // Success
+}
+
 
 //
 // TRTSERVER2
@@ -2165,9 +2486,15 @@ TRTSERVER2_ServerInferAsync(
   ltrtrequest->SetResponse(nullptr);
   RETURN_IF_STATUS_ERROR(lrequest->PrepareForInference(*lbackend));
 
+  // Per-request objects are placed in a pooled arena so they are
+  // allocated with a single bump allocation and freed wholesale when
+  // the request completes.
+  auto arena = ni::ArenaPool::Get();
+
 #ifdef TRTIS_ENABLE_STATS
-  auto infer_stats = std::make_shared<ni::ModelInferStats>(
-      lserver->StatusManager(), lrequest->ModelName());
+  auto infer_stats = std::allocate_shared<ni::ModelInferStats>(
+      ni::ArenaAllocator<ni::ModelInferStats>(arena), lserver->StatusManager(),
+      lrequest->ModelName());
   infer_stats->CaptureTimestamp(
       ni::ModelInferStats::TimestampKind::kRequestStart);
   infer_stats->SetRequestedVersion(lrequest->RequestedModelVersion());
@@ -2178,7 +2505,8 @@ TRTSERVER2_ServerInferAsync(
       reinterpret_cast<ni::OpaqueTraceManager*>(trace_manager));
   infer_stats->NewTrace();
 #else
-  auto infer_stats = std::make_shared<ni::ModelInferStats>();
+  auto infer_stats = std::allocate_shared<ni::ModelInferStats>(
+      ni::ArenaAllocator<ni::ModelInferStats>(arena));
 #endif  // TRTIS_ENABLE_STATS
 
   std::shared_ptr<ni::InferResponseProvider> infer_response_provider;
@@ -54,6 +54,7 @@ struct TRTSERVER_InferenceRequestOptions;
 struct TRTSERVER_InferenceRequestProvider;
 struct TRTSERVER_InferenceResponse;
 struct TRTSERVER_Metrics;
+struct TRTSERVER_ModelHandle;
 struct TRTSERVER_Protobuf;
 struct TRTSERVER_ResponseAllocator;
 struct TRTSERVER_Server;
@@ -187,6 +188,37 @@ typedef TRTSERVER_Error* (*TRTSERVER_ResponseAllocatorReleaseFn_t)(
     size_t byte_size, TRTSERVER_Memory_Type memory_type,
     int64_t memory_type_id);
 
+/// Type for function that is called when the contents of a single
+/// result tensor are complete in its allocated buffer, before the
+/// response as a whole completes. A frontend can use this to stream a
+/// large result to the client while the remaining results are still
+/// being produced.
+///
+/// 'tensor_name', 'content' and 'byte_size' describe the completed
+/// result tensor; 'content' is within the buffer returned by
+/// TRTSERVER_ResponseAllocatorAllocFn_t for that tensor. The 'userp'
+/// data is the same as what is supplied in the call to
+/// TRTSERVER_ServerInferAsync. Only result tensors allocated in
+/// system memory are reported, and the function may be called from a
+/// thread other than the one that completes the request. The contents
+/// must not be modified.
+typedef void (*TRTSERVER_ResponseAllocatorOutputReadyFn_t)(
+    TRTSERVER_ResponseAllocator* allocator, const char* tensor_name,
+    const void* content, size_t byte_size, void* userp);
+
+/// Set the function called as each result tensor's contents become
+/// complete. Optional; if not set, results are only visible through
+/// the completed response. Support depends on the backend producing
+/// the response: a backend that does not report per-tensor completion
+/// simply never invokes the function.
+/// \param allocator The response allocator object.
+/// \param output_ready_fn The function to call as each result
+/// tensor's contents become complete.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ResponseAllocatorSetOutputReadyFn(
+    TRTSERVER_ResponseAllocator* allocator,
+    TRTSERVER_ResponseAllocatorOutputReadyFn_t output_ready_fn);
+
 /// Create a new response allocator object.
 /// \param allocator Returns the new response allocator object.
 /// \param alloc_fn The function to call to allocate buffers for result
@@ -492,6 +524,21 @@ TRTSERVER_EXPORT TRTSERVER_Error*
 TRTSERVER_InferenceRequestOptionsSetTimeoutMicroseconds(
     TRTSERVER_InferenceRequestOptions* request_options, uint64_t timeout_us);
 
+/// Set the deadline for the request in a request options, as
+/// microseconds from the time of this call. Unlike the timeout, which
+/// is honored only when the model's queue policy allows a timeout
+/// override, the deadline is always honored: a queued request whose
+/// deadline has passed is rejected instead of executed, and batch
+/// formation never delays a batch past the earliest deadline in it.
+/// Typically derived from the transport deadline of the client
+/// request (e.g. the gRPC call deadline).
+/// \param request_options The request options object.
+/// \param deadline_us The deadline, in microseconds from now.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error*
+TRTSERVER_InferenceRequestOptionsSetDeadlineMicroseconds(
+    TRTSERVER_InferenceRequestOptions* request_options, uint64_t deadline_us);
+
 /// Add a input meta-data associated with the request in a request options.
 /// \param request_options The request options object.
 /// \param input_name The name of the input.
@@ -535,6 +582,39 @@ TRTSERVER_InferenceRequestOptionsAddClassificationOutput(
 TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_InferenceRequestOptionsDelete(
     TRTSERVER_InferenceRequestOptions* request_options);
 
+/// TRTSERVER_ModelHandle
+///
+/// Object representing a resolved handle to a loaded model
+/// version. The model name and version are resolved once, when the
+/// handle is created, and the handle can then be used to create
+/// inference request providers without a per-request model lookup.
+/// The handle pins the model version: the server does not complete
+/// unloading the version until every handle for it is deleted, so
+/// handles should be released when the model is no longer needed.
+///
+
+/// Create a handle to a loaded model version. The caller takes
+/// ownership of the TRTSERVER_ModelHandle object and must call
+/// TRTSERVER_ModelHandleDelete to release the object.
+/// \param model_handle Returns the new model handle object.
+/// \param server The inference server object.
+/// \param model_name The name of the model.
+/// \param model_version The version of the model, or -1 to select the
+/// latest (highest numbered) version. The selection is made when the
+/// handle is created; the handle does not follow later version
+/// changes.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerModelHandleNew(
+    TRTSERVER_ModelHandle** model_handle, TRTSERVER_Server* server,
+    const char* model_name, int64_t model_version);
+
+/// Delete a model handle object, releasing the pin on the model
+/// version.
+/// \param model_handle The model handle object.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ModelHandleDelete(
+    TRTSERVER_ModelHandle* model_handle);
+
 /// TRTSERVER_InferenceRequestProvider
 ///
 /// Object representing the request provider for an inference
@@ -576,12 +656,45 @@ TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_InferenceRequestProviderNewV2(
     TRTSERVER_Server* server,
     TRTSERVER_InferenceRequestOptions* request_options);
 
+/// Create a new inference request provider object using a model
+/// handle in place of the model name and version in
+/// 'request_options', which are ignored. The model was resolved when
+/// the handle was created so no model lookup is performed. As with
+/// TRTSERVER_InferenceRequestProviderNewV2() the caller retains
+/// ownership of 'request_options' and must extend the options
+/// object's lifetime to be longer than the lifetime of any providers
+/// created with the options object.
+/// \param request_provider Returns the new request provider object.
+/// \param server the inference server object.
+/// \param model_handle The model handle identifying the model version
+/// that the inference request is for.
+/// \param request_options The request options object for this inference
+/// request.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error*
+TRTSERVER_InferenceRequestProviderNewWithHandle(
+    TRTSERVER_InferenceRequestProvider** request_provider,
+    TRTSERVER_Server* server, TRTSERVER_ModelHandle* model_handle,
+    TRTSERVER_InferenceRequestOptions* request_options);
+
 /// Delete an inference request provider object.
 /// \param request_provider The request provider object.
 /// \return a TRTSERVER_Error indicating success or failure.
 TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_InferenceRequestProviderDelete(
     TRTSERVER_InferenceRequestProvider* request_provider);
 
+/// Cancel the inference request associated with a request provider.
+/// If the request is still queued in the scheduler it is dropped and
+/// completed with an unavailable error instead of being executed. A
+/// request that has already been dispatched for execution is not
+/// interrupted. Cancellation is not reversible. To be able to cancel,
+/// the caller must not delete the request provider until the
+/// TRTSERVER_ServerInferAsync() completion callback is invoked.
+/// \param request_provider The request provider object.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_InferenceRequestProviderCancel(
+    TRTSERVER_InferenceRequestProvider* request_provider);
+
 /// Get the size, in bytes, expected by the inference server for the
 /// named input tensor. The returned size is the total size for the
 /// entire batch of the input.
@@ -681,7 +794,8 @@ TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_InferenceResponseOutputData(
 typedef enum trtserver_modelcontrolmode_enum {
   TRTSERVER_MODEL_CONTROL_NONE,
   TRTSERVER_MODEL_CONTROL_POLL,
-  TRTSERVER_MODEL_CONTROL_EXPLICIT
+  TRTSERVER_MODEL_CONTROL_EXPLICIT,
+  TRTSERVER_MODEL_CONTROL_LAZY
 } TRTSERVER_Model_Control_Mode;
 
 /// Create a new server options object. The caller takes ownership of
@@ -743,6 +857,12 @@ TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerOptionsSetModelRepositoryPath(
 ///   be loaded on startup. The corresponding model control APIs must be called
 ///   to load / unload a model in the model repository.
 ///
+///   TRTSERVER_MODEL_CONTROL_LAZY: the configurations of the models in the
+///   model repository will be registered on startup but each model will be
+///   loaded when the first inference request for it arrives. That first
+///   request waits for the load to complete. Models set with
+///   TRTSERVER_ServerOptionsSetStartupModel are loaded on startup.
+///
 /// \param options The server options object.
 /// \param mode The mode to use for the model control.
 /// \return a TRTSERVER_Error indicating success or failure.
@@ -753,7 +873,8 @@ TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerOptionsSetModelControlMode(
 /// present in one, and only one, of the specified model repositories.
 /// This function can be called multiple times with different model name
 /// to set multiple startup models.
-/// Note that it only takes affect on TRTSERVER_MODEL_CONTROL_EXPLICIT mode.
+/// Note that it only takes affect on TRTSERVER_MODEL_CONTROL_EXPLICIT and
+/// TRTSERVER_MODEL_CONTROL_LAZY modes.
 /// \param options The server options object.
 /// \param mode_name The name of the model to load on startup.
 /// \return a TRTSERVER_Error indicating success or failure.
@@ -823,6 +944,33 @@ TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerOptionsSetStrictReadiness(
 TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerOptionsSetExitTimeout(
     TRTSERVER_ServerOptions* options, unsigned int timeout);
 
+/// Set the maximum number of in-flight inference requests in a server
+/// options.
+/// \param options The server options object.
+/// \param max The maximum number of in-flight requests, or 0 for no
+/// limit.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerOptionsSetMaxInflightRequests(
+    TRTSERVER_ServerOptions* options, uint64_t max);
+
+/// Set the maximum total input byte size of in-flight inference
+/// requests in a server options.
+/// \param options The server options object.
+/// \param max The maximum total input byte size, or 0 for no limit.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerOptionsSetMaxInflightByteSize(
+    TRTSERVER_ServerOptions* options, uint64_t max);
+
+/// Set the maximum number of models that may be loading concurrently
+/// in a server options.
+/// \param options The server options object.
+/// \param concurrency The maximum number of concurrent model loads,
+/// or 0 for no limit.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error*
+TRTSERVER_ServerOptionsSetModelLoadConcurrency(
+    TRTSERVER_ServerOptions* options, uint32_t concurrency);
+
 /// Enable or disable info level logging.
 /// \param options The server options object.
 /// \param log True to enable info logging, false to disable.
@@ -887,6 +1035,18 @@ TRTSERVER_EXPORT TRTSERVER_Error*
 TRTSERVER_ServerOptionsSetTensorFlowGpuMemoryFraction(
     TRTSERVER_ServerOptions* options, float fraction);
 
+/// Set the size of the thread pool shared by all TensorFlow sessions
+/// created by the inference server. A value less than zero (the
+/// default) causes each session to create its own thread pools. Zero
+/// (0) shares a pool sized by TensorFlow based on the number of CPU
+/// cores.
+/// \param options The server options object.
+/// \param size The number of threads in the shared pool.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error*
+TRTSERVER_ServerOptionsSetTensorFlowSharedThreadPoolSize(
+    TRTSERVER_ServerOptions* options, int size);
+
 /// Add Tensorflow virtual GPU instances to a physical GPU.
 /// \param options The server options object.
 /// \param gpu_device The physical GPU device id.
@@ -1078,6 +1238,32 @@ TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerInferAsync(
     void* response_allocator_userp, TRTSERVER_InferenceCompleteFn_t complete_fn,
     void* complete_userp);
 
+/// Perform inference synchronously, blocking the calling thread until
+/// the inference completes. Intended for embedders doing sequential
+/// inference: the calling thread spins briefly before blocking so
+/// that a request admitted and executed immediately by the scheduler
+/// completes without paying a sleep/wakeup handoff. Ownership
+/// semantics for 'request_provider' match
+/// TRTSERVER_ServerInferAsync. The caller retains ownership of
+/// 'trace_manager'.
+/// \param server The inference server object.
+/// \param trace_manager The trace manager object for this request, or nullptr
+/// if no tracing.
+/// \param request_provider The request provider for the request.
+/// \param response_allocator The TRTSERVER_ResponseAllocator to use
+/// to allocate buffers to hold inference results.
+/// \param response_allocator_userp User-provided pointer that is
+/// delivered to the response allocator's allocation function.
+/// \param response Returns the inference response. The caller takes
+/// ownership of the response object and must call
+/// TRTSERVER_InferenceResponseDelete to release the object.
+/// \return a TRTSERVER_Error indicating success or failure.
+TRTSERVER_EXPORT TRTSERVER_Error* TRTSERVER_ServerInferSync(
+    TRTSERVER_Server* server, TRTSERVER_TraceManager* trace_manager,
+    TRTSERVER_InferenceRequestProvider* request_provider,
+    TRTSERVER_ResponseAllocator* response_allocator,
+    void* response_allocator_userp, TRTSERVER_InferenceResponse** response);
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,8 +39,10 @@
 #define LOG_ERROR std::cerr
 #define LOG_INFO std::cout
 
-// This custom backend takes any number of inputs and copies each
-// input to the corresponding output. The number of inputs must equal
+// This custom backend takes any number of inputs and forwards each
+// input to the corresponding output. A contiguous input is donated
+// directly as the output value without copying, making this the
+// reference zero-copy backend. The number of inputs must equal
 // the number of outputs and each pair must be named
 // INPUTn/OUTPUTn. The datatype and size of each input must match the
 // corresponding output.
@@ -60,18 +62,12 @@ class Context : public CustomInstance {
   // Validate the model configuration for the derived backend instance
   int Init();
 
-#ifdef TRTIS_ENABLE_GPU
-  // Version 2 interface may need to deal with data in GPU memory,
-  // which requires CUDA support.
-  int Execute(
-      const uint32_t payload_cnt, CustomPayload* payloads,
-      CustomGetNextInputV2Fn_t input_fn,
-      CustomGetOutputV2Fn_t output_fn) override;
-#else
+  // Version 3 interface so that a contiguous input can be donated
+  // directly as the output value without copying.
   int Execute(
       const uint32_t payload_cnt, CustomPayload* payloads,
-      CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn) override;
-#endif  // TRTIS_ENABLE_GPU
+      CustomGetNextInputV2Fn_t input_fn, CustomGetOutputV2Fn_t output_fn,
+      CustomPutOutputV2Fn_t put_output_fn) override;
 
  private:
   // Delay to introduce into execution, in milliseconds.
@@ -206,18 +202,20 @@ Context::Init()
   return ErrorCodes::Success;
 }
 
-#ifdef TRTIS_ENABLE_GPU
 int
 Context::Execute(
     const uint32_t payload_cnt, CustomPayload* payloads,
-    CustomGetNextInputV2Fn_t input_fn, CustomGetOutputV2Fn_t output_fn)
+    CustomGetNextInputV2Fn_t input_fn, CustomGetOutputV2Fn_t output_fn,
+    CustomPutOutputV2Fn_t put_output_fn)
 {
   // Delay if requested...
   if (execute_delay_ms_ > 0) {
     std::this_thread::sleep_for(std::chrono::milliseconds(execute_delay_ms_));
   }
 
+#ifdef TRTIS_ENABLE_GPU
   bool cuda_copy = false;
+#endif  // TRTIS_ENABLE_GPU
   for (uint32_t pidx = 0; pidx < payload_cnt; ++pidx) {
     CustomPayload& payload = payloads[pidx];
 
@@ -257,9 +255,8 @@ Context::Execute(
         break;
       }
 
-      // copy....
-      // Peek memory type and id of the input content as
-      // we would like to allocate output buffer on the same device as input
+      // Peek the first chunk of the input. The server hands out the
+      // input as a single chunk whenever it is contiguous in memory.
       CustomMemoryType src_memory_type = CUSTOM_MEMORY_CPU;
       int64_t src_memory_type_id = 0;
       const void* content;
@@ -271,6 +268,39 @@ Context::Execute(
         break;
       }
 
+      // If the input arrived as one contiguous chunk then donate it
+      // directly as the output value instead of copying it. The input
+      // buffer is owned by the request and remains valid until the
+      // execution completes, so no release callback is needed.
+      if ((content != nullptr) &&
+          (content_byte_size == (uint64_t)batchn_byte_size)) {
+        if (!put_output_fn(
+                payload.output_context, output_cname, shape.size(), &shape[0],
+                batchn_byte_size, const_cast<void*>(content), src_memory_type,
+                src_memory_type_id, nullptr /* release_fn */,
+                nullptr /* release_userp */)) {
+          payload.error_code = kOutputBuffer;
+          break;
+        }
+
+        // Consume the end-of-input marker.
+        if (!input_fn(
+                payload.input_context, input_name.c_str(), &content,
+                &content_byte_size, &src_memory_type, &src_memory_type_id)) {
+          payload.error_code = kInputContents;
+          break;
+        }
+        if (content != nullptr) {
+          payload.error_code = kInputSize;
+          break;
+        }
+
+        continue;
+      }
+
+      // The input is not contiguous... fall back to copying the
+      // chunks into a server-provided output buffer. Prefer to
+      // allocate the output buffer on the same device as the input.
       auto dst_memory_type = src_memory_type;
       int64_t dst_memory_type_id = src_memory_type_id;
       void* obuffer;
@@ -298,35 +328,37 @@ Context::Execute(
           break;
         }
 
-        auto copy_type = cudaMemcpyHostToHost;
-        switch (src_memory_type) {
-          case CUSTOM_MEMORY_GPU: {
-            switch (dst_memory_type) {
-              case CUSTOM_MEMORY_GPU:
-                copy_type = cudaMemcpyDeviceToDevice;
-                break;
-              default:
-                copy_type = cudaMemcpyDeviceToHost;
-                break;
+        if ((src_memory_type == CUSTOM_MEMORY_CPU) &&
+            (dst_memory_type == CUSTOM_MEMORY_CPU)) {
+          memcpy(output_buffer + total_byte_size, content, content_byte_size);
+        } else {
+#ifdef TRTIS_ENABLE_GPU
+          auto copy_type = cudaMemcpyHostToHost;
+          switch (src_memory_type) {
+            case CUSTOM_MEMORY_GPU: {
+              switch (dst_memory_type) {
+                case CUSTOM_MEMORY_GPU:
+                  copy_type = cudaMemcpyDeviceToDevice;
+                  break;
+                default:
+                  copy_type = cudaMemcpyDeviceToHost;
+                  break;
+              }
+              break;
             }
-            break;
-          }
-          default: {
-            switch (dst_memory_type) {
-              case CUSTOM_MEMORY_GPU:
-                copy_type = cudaMemcpyHostToDevice;
-                break;
-              default:
-                // default 'copy_type' value: cudaMemcpyHostToHost
-                break;
+            default: {
+              switch (dst_memory_type) {
+                case CUSTOM_MEMORY_GPU:
+                  copy_type = cudaMemcpyHostToDevice;
+                  break;
+                default:
+                  // default 'copy_type' value: cudaMemcpyHostToHost
+                  break;
+              }
+              break;
             }
-            break;
           }
-        }
 
-        if (copy_type == cudaMemcpyHostToHost) {
-          memcpy(output_buffer + total_byte_size, content, content_byte_size);
-        } else {
           cudaError_t err;
           if ((src_memory_type_id != dst_memory_type_id) &&
               (copy_type == cudaMemcpyDeviceToDevice)) {
@@ -344,6 +376,10 @@ Context::Execute(
           } else {
             cuda_copy = true;
           }
+#else
+          payload.error_code = kGpuNotSupported;
+          break;
+#endif  // TRTIS_ENABLE_GPU
         }
         total_byte_size += content_byte_size;
 
@@ -356,103 +392,14 @@ Context::Execute(
       }
     }
   }
+#ifdef TRTIS_ENABLE_GPU
   if (cuda_copy) {
     cudaStreamSynchronize(stream_);
   }
+#endif  // TRTIS_ENABLE_GPU
 
   return ErrorCodes::Success;
 }
-#else
-int
-Context::Execute(
-    const uint32_t payload_cnt, CustomPayload* payloads,
-    CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn)
-{
-  // Delay if requested...
-  if (execute_delay_ms_ > 0) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(execute_delay_ms_));
-  }
-
-  for (uint32_t pidx = 0; pidx < payload_cnt; ++pidx) {
-    CustomPayload& payload = payloads[pidx];
-
-    for (uint32_t output_idx = 0; output_idx < payload.output_cnt;
-         ++output_idx) {
-      if (payload.error_code != 0) {
-        break;
-      }
-
-      const char* output_cname = payload.required_output_names[output_idx];
-      const auto itr = copy_map_.find(output_cname);
-      if (itr == copy_map_.end()) {
-        payload.error_code = kRequestOutput;
-        break;
-      }
-
-      const std::string& input_name = itr->second.input_name_;
-      const DataType datatype = itr->second.datatype_;
-
-      std::vector<int64_t> shape;
-      if (model_config_.max_batch_size() != 0) {
-        shape.push_back(payload.batch_size);
-      }
-      for (uint32_t input_idx = 0; input_idx < payload.input_cnt; ++input_idx) {
-        if (!strcmp(payload.input_names[input_idx], input_name.c_str())) {
-          shape.insert(
-              shape.end(), payload.input_shape_dims[input_idx],
-              payload.input_shape_dims[input_idx] +
-                  payload.input_shape_dim_cnts[input_idx]);
-          break;
-        }
-      }
-
-      const int64_t batchn_byte_size = GetByteSize(datatype, shape);
-      if (batchn_byte_size < 0) {
-        payload.error_code = kOutputBuffer;
-        break;
-      }
-
-      void* obuffer;
-      if (!output_fn(
-              payload.output_context, output_cname, shape.size(), &shape[0],
-              batchn_byte_size, &obuffer)) {
-        payload.error_code = kOutputBuffer;
-        break;
-      }
-
-      // If no error but the 'obuffer' is returned as nullptr, then
-      // skip writing this output.
-      if (obuffer == nullptr) {
-        continue;
-      }
-
-      char* output_buffer = reinterpret_cast<char*>(obuffer);
-
-      uint64_t total_byte_size = 0;
-      while (true) {
-        const void* content;
-        uint64_t content_byte_size = 128 * 1024;
-        if (!input_fn(
-                payload.input_context, input_name.c_str(), &content,
-                &content_byte_size)) {
-          payload.error_code = kInputContents;
-          break;
-        }
-
-        // If 'content' returns nullptr we have all the input.
-        if (content == nullptr) {
-          break;
-        }
-
-        memcpy(output_buffer + total_byte_size, content, content_byte_size);
-        total_byte_size += content_byte_size;
-      }
-    }
-  }
-
-  return ErrorCodes::Success;
-}
-#endif  // TRTIS_ENABLE_GPU
 
 
 }  // namespace identity
@@ -483,11 +430,7 @@ extern "C" {
 uint32_t
 CustomVersion()
 {
-#ifdef TRTIS_ENABLE_GPU
-  return 2;
-#else
-  return 1;
-#endif  // TRTIS_ENABLE_GPU
+  return 3;
 }
 
 }  // extern "C"
@@ -24,15 +24,24 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
+#include <cstdint>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "src/core/model_config.h"
 #include "src/core/model_config.pb.h"
 #include "src/custom/sdk/custom_instance.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define IMAGE_PREPROCESS_ENABLE_SIMD 1
+#endif
+
 #define LOG_ERROR std::cerr
 #define LOG_INFO std::cout
 
@@ -46,6 +55,288 @@ namespace image_preprocess {
 
 enum ScaleType { NONE = 0, VGG = 1, INCEPTION = 2, ONE255 = 3 };
 
+namespace {
+
+// Coefficients for the fused uint8 -> float32 conversion,
+// out = in * scale[channel] + bias[channel]. The scaling types above
+// are all affine so they fold into these two coefficients per
+// channel.
+struct NormParams {
+  float scale_[3];
+  float bias_[3];
+};
+
+NormParams
+MakeNormParams(const ScaleType scaling, const size_t c)
+{
+  NormParams params;
+  for (size_t ch = 0; ch < 3; ++ch) {
+    params.scale_[ch] = 1.f;
+    params.bias_[ch] = 0.f;
+  }
+
+  if (scaling == ScaleType::INCEPTION) {
+    for (size_t ch = 0; ch < 3; ++ch) {
+      params.scale_[ch] = 1.f / 128.f;
+      params.bias_[ch] = -1.f;
+    }
+  } else if (scaling == ScaleType::VGG) {
+    if (c == 1) {
+      params.bias_[0] = -128.f;
+    } else {
+      // Channel order is RGB at this point, see Preprocess().
+      params.bias_[0] = -104.f;
+      params.bias_[1] = -117.f;
+      params.bias_[2] = -123.f;
+    }
+  } else if (scaling == ScaleType::ONE255) {
+    for (size_t ch = 0; ch < 3; ++ch) {
+      params.scale_[ch] = 1.f / 255.f;
+    }
+  }
+
+  return params;
+}
+
+// Convert an interleaved uint8 image to normalized float32 keeping
+// the interleaved (NHWC) layout.
+void
+FusedConvertNHWCScalar(
+    const uint8_t* src, float* dst, const size_t pixel_cnt, const size_t c,
+    const NormParams& params)
+{
+  size_t i = 0;
+  for (size_t p = 0; p < pixel_cnt; ++p) {
+    for (size_t ch = 0; ch < c; ++ch, ++i) {
+      dst[i] = (src[i] * params.scale_[ch]) + params.bias_[ch];
+    }
+  }
+}
+
+// Convert an interleaved uint8 image to normalized float32,
+// deinterleaving the channels into planar (NCHW) layout.
+void
+FusedConvertNCHWScalar(
+    const uint8_t* src, float* dst, const size_t pixel_cnt, const size_t c,
+    const NormParams& params)
+{
+  for (size_t ch = 0; ch < c; ++ch) {
+    float* out = dst + (ch * pixel_cnt);
+    for (size_t i = 0; i < pixel_cnt; ++i) {
+      out[i] = (src[(i * c) + ch] * params.scale_[ch]) + params.bias_[ch];
+    }
+  }
+}
+
+#ifdef IMAGE_PREPROCESS_ENABLE_SIMD
+__attribute__((target("avx2,fma"))) void
+FusedConvertNHWCAvx2(
+    const uint8_t* src, float* dst, const size_t pixel_cnt, const size_t c,
+    const NormParams& params)
+{
+  const size_t element_cnt = pixel_cnt * c;
+  size_t i = 0;
+
+  if (c == 1) {
+    const __m256 vscale = _mm256_set1_ps(params.scale_[0]);
+    const __m256 vbias = _mm256_set1_ps(params.bias_[0]);
+    for (; (i + 8) <= element_cnt; i += 8) {
+      const __m128i u8 =
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+      const __m256 vf = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(u8));
+      _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(vf, vscale, vbias));
+    }
+  } else {
+    // The channel pattern of an interleaved 3-channel row repeats
+    // every lcm(8, 3) = 24 elements, so three precomputed
+    // coefficient vectors cover a full period and the layout never
+    // needs to be shuffled.
+    float scale_period[24], bias_period[24];
+    for (size_t j = 0; j < 24; ++j) {
+      scale_period[j] = params.scale_[j % 3];
+      bias_period[j] = params.bias_[j % 3];
+    }
+    __m256 vscale[3], vbias[3];
+    for (size_t k = 0; k < 3; ++k) {
+      vscale[k] = _mm256_loadu_ps(scale_period + (k * 8));
+      vbias[k] = _mm256_loadu_ps(bias_period + (k * 8));
+    }
+
+    for (; (i + 24) <= element_cnt; i += 24) {
+      for (size_t k = 0; k < 3; ++k) {
+        const __m128i u8 = _mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(src + i + (k * 8)));
+        const __m256 vf = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(u8));
+        _mm256_storeu_ps(
+            dst + i + (k * 8), _mm256_fmadd_ps(vf, vscale[k], vbias[k]));
+      }
+    }
+  }
+
+  for (; i < element_cnt; ++i) {
+    dst[i] = (src[i] * params.scale_[i % c]) + params.bias_[i % c];
+  }
+}
+
+__attribute__((target("avx2,fma"))) void
+FusedConvertNCHWAvx2(
+    const uint8_t* src, float* dst, const size_t pixel_cnt, const size_t c,
+    const NormParams& params)
+{
+  // The strided byte gather stays scalar (vector byte gathers are
+  // slower than plain loads on current cores) but the widening
+  // conversion and the normalization math are vectorized.
+  for (size_t ch = 0; ch < c; ++ch) {
+    const __m256 vscale = _mm256_set1_ps(params.scale_[ch]);
+    const __m256 vbias = _mm256_set1_ps(params.bias_[ch]);
+    float* out = dst + (ch * pixel_cnt);
+    size_t i = 0;
+    for (; (i + 8) <= pixel_cnt; i += 8) {
+      uint8_t gathered[8];
+      for (size_t j = 0; j < 8; ++j) {
+        gathered[j] = src[((i + j) * c) + ch];
+      }
+      const __m128i u8 =
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(gathered));
+      const __m256 vf = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(u8));
+      _mm256_storeu_ps(out + i, _mm256_fmadd_ps(vf, vscale, vbias));
+    }
+    for (; i < pixel_cnt; ++i) {
+      out[i] = (src[(i * c) + ch] * params.scale_[ch]) + params.bias_[ch];
+    }
+  }
+}
+
+__attribute__((target("avx512f"))) void
+FusedConvertNHWCAvx512(
+    const uint8_t* src, float* dst, const size_t pixel_cnt, const size_t c,
+    const NormParams& params)
+{
+  const size_t element_cnt = pixel_cnt * c;
+  size_t i = 0;
+
+  if (c == 1) {
+    const __m512 vscale = _mm512_set1_ps(params.scale_[0]);
+    const __m512 vbias = _mm512_set1_ps(params.bias_[0]);
+    for (; (i + 16) <= element_cnt; i += 16) {
+      const __m128i u8 =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m512 vf = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(u8));
+      _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(vf, vscale, vbias));
+    }
+  } else {
+    // lcm(16, 3) = 48 element period, see the AVX2 variant.
+    float scale_period[48], bias_period[48];
+    for (size_t j = 0; j < 48; ++j) {
+      scale_period[j] = params.scale_[j % 3];
+      bias_period[j] = params.bias_[j % 3];
+    }
+    __m512 vscale[3], vbias[3];
+    for (size_t k = 0; k < 3; ++k) {
+      vscale[k] = _mm512_loadu_ps(scale_period + (k * 16));
+      vbias[k] = _mm512_loadu_ps(bias_period + (k * 16));
+    }
+
+    for (; (i + 48) <= element_cnt; i += 48) {
+      for (size_t k = 0; k < 3; ++k) {
+        const __m128i u8 = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + i + (k * 16)));
+        const __m512 vf = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(u8));
+        _mm512_storeu_ps(
+            dst + i + (k * 16), _mm512_fmadd_ps(vf, vscale[k], vbias[k]));
+      }
+    }
+  }
+
+  for (; i < element_cnt; ++i) {
+    dst[i] = (src[i] * params.scale_[i % c]) + params.bias_[i % c];
+  }
+}
+
+__attribute__((target("avx512f"))) void
+FusedConvertNCHWAvx512(
+    const uint8_t* src, float* dst, const size_t pixel_cnt, const size_t c,
+    const NormParams& params)
+{
+  for (size_t ch = 0; ch < c; ++ch) {
+    const __m512 vscale = _mm512_set1_ps(params.scale_[ch]);
+    const __m512 vbias = _mm512_set1_ps(params.bias_[ch]);
+    float* out = dst + (ch * pixel_cnt);
+    size_t i = 0;
+    for (; (i + 16) <= pixel_cnt; i += 16) {
+      uint8_t gathered[16];
+      for (size_t j = 0; j < 16; ++j) {
+        gathered[j] = src[((i + j) * c) + ch];
+      }
+      const __m128i u8 =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(gathered));
+      const __m512 vf = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(u8));
+      _mm512_storeu_ps(out + i, _mm512_fmadd_ps(vf, vscale, vbias));
+    }
+    for (; i < pixel_cnt; ++i) {
+      out[i] = (src[(i * c) + ch] * params.scale_[ch]) + params.bias_[ch];
+    }
+  }
+}
+#endif  // IMAGE_PREPROCESS_ENABLE_SIMD
+
+enum class SimdLevel { SCALAR = 0, AVX2 = 1, AVX512 = 2 };
+
+SimdLevel
+DetectSimdLevel()
+{
+#ifdef IMAGE_PREPROCESS_ENABLE_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::AVX2;
+  }
+#endif  // IMAGE_PREPROCESS_ENABLE_SIMD
+  return SimdLevel::SCALAR;
+}
+
+// Convert an interleaved uint8 image to normalized float32 in the
+// requested layout, dispatching to the widest instruction set the
+// CPU supports.
+void
+FusedConvert(
+    const bool nhwc, const uint8_t* src, float* dst, const size_t pixel_cnt,
+    const size_t c, const NormParams& params)
+{
+  static const SimdLevel simd_level = DetectSimdLevel();
+
+#ifdef IMAGE_PREPROCESS_ENABLE_SIMD
+  if (simd_level == SimdLevel::AVX512) {
+    if (nhwc) {
+      FusedConvertNHWCAvx512(src, dst, pixel_cnt, c, params);
+    } else {
+      FusedConvertNCHWAvx512(src, dst, pixel_cnt, c, params);
+    }
+    return;
+  }
+  if (simd_level == SimdLevel::AVX2) {
+    if (nhwc) {
+      FusedConvertNHWCAvx2(src, dst, pixel_cnt, c, params);
+    } else {
+      FusedConvertNCHWAvx2(src, dst, pixel_cnt, c, params);
+    }
+    return;
+  }
+#else
+  (void)simd_level;
+#endif  // IMAGE_PREPROCESS_ENABLE_SIMD
+
+  if (nhwc) {
+    FusedConvertNHWCScalar(src, dst, pixel_cnt, c, params);
+  } else {
+    FusedConvertNCHWScalar(src, dst, pixel_cnt, c, params);
+  }
+}
+
+}  // namespace
+
 // Context object. All state must be kept in this object.
 class Context : public CustomInstance {
  public:
@@ -209,22 +500,55 @@ Context::Execute(
     // If no error but the 'obuffer' is returned as nullptr, then
     // skip writing this output.
     if (obuffer != nullptr) {
-      size_t byte_used = 0;
-      for (const auto& data : input) {
-        cv::Mat img = imdecode(cv::Mat(data), 1);
-        if (img.empty()) {
-          payloads[idx].error_code = kOpenCV;
-          break;
+      // Every preprocessed image has the same fixed size, so the
+      // output offset of each image is known up front and the images
+      // of a batch can be decoded and preprocessed in parallel, each
+      // writing to its own disjoint slice of 'obuffer'.
+      const size_t image_stride =
+          (size_t)GetByteSize(output_type_, output_shape_);
+      const size_t image_cnt = input.size();
+
+      std::vector<int> image_errors(image_cnt, (int)ErrorCodes::Success);
+      auto worker = [&](const size_t start, const size_t end) {
+        for (size_t i = start; i < end; ++i) {
+          cv::Mat img = imdecode(cv::Mat(input[i]), 1);
+          if (img.empty()) {
+            image_errors[i] = kOpenCV;
+            continue;
+          }
+
+          size_t image_byte_size;
+          image_errors[i] = Preprocess(
+              img, (char*)obuffer + (i * image_stride), &image_byte_size);
         }
+      };
 
-        size_t image_byte_size;
+      size_t thread_cnt = std::thread::hardware_concurrency();
+      thread_cnt = std::max((size_t)1, std::min(thread_cnt, image_cnt));
+      if (thread_cnt == 1) {
+        worker(0, image_cnt);
+      } else {
+        const size_t images_per_thread =
+            (image_cnt + thread_cnt - 1) / thread_cnt;
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < thread_cnt; ++t) {
+          const size_t start = t * images_per_thread;
+          const size_t end = std::min(image_cnt, start + images_per_thread);
+          if (start >= end) {
+            break;
+          }
+          workers.emplace_back(worker, start, end);
+        }
+        for (auto& w : workers) {
+          w.join();
+        }
+      }
 
-        err = Preprocess(img, (char*)obuffer + byte_used, &image_byte_size);
-        if (err != ErrorCodes::Success) {
-          payloads[idx].error_code = err;
+      for (const auto image_error : image_errors) {
+        if (image_error != ErrorCodes::Success) {
+          payloads[idx].error_code = image_error;
           break;
         }
-        byte_used += image_byte_size;
       }
     }
   }
@@ -357,6 +681,20 @@ Context::Preprocess(const cv::Mat& img, char* data, size_t* image_byte_size)
     sample_resized = sample;
   }
 
+  // Fast path for the common FP32 output: the type conversion, the
+  // normalization and the layout transform are fused into a single
+  // SIMD pass from the resized uint8 image directly into the output
+  // buffer, instead of materializing intermediate Mats.
+  if ((output_type_ == DataType::TYPE_FP32) &&
+      (sample_resized.depth() == CV_8U) && sample_resized.isContinuous()) {
+    const NormParams params = MakeNormParams(scaling_, c);
+    FusedConvert(
+        format_ == ModelInput::FORMAT_NHWC, sample_resized.ptr<uint8_t>(),
+        reinterpret_cast<float*>(data), h * w, c, params);
+    *image_byte_size = h * w * c * sizeof(float);
+    return ErrorCodes::Success;
+  }
+
   cv::Mat sample_type;
   sample_resized.convertTo(sample_type, (c == 3) ? img_type3 : img_type1);
 
@@ -36,6 +36,37 @@ CustomInstance::CustomInstance(
 {
 }
 
+void
+CustomInstance::SetPinnedMemoryCallbacks(
+    void* pinned_memory_context, CustomPinnedAllocFn_t pinned_alloc_fn,
+    CustomPinnedFreeFn_t pinned_free_fn)
+{
+  pinned_memory_context_ = pinned_memory_context;
+  pinned_alloc_fn_ = pinned_alloc_fn;
+  pinned_free_fn_ = pinned_free_fn;
+}
+
+bool
+CustomInstance::PinnedAlloc(uint64_t byte_size, void** buffer)
+{
+  if (pinned_alloc_fn_ == nullptr) {
+    *buffer = nullptr;
+    return false;
+  }
+
+  return pinned_alloc_fn_(pinned_memory_context_, byte_size, buffer);
+}
+
+bool
+CustomInstance::PinnedFree(void* buffer)
+{
+  if (pinned_free_fn_ == nullptr) {
+    return false;
+  }
+
+  return pinned_free_fn_(pinned_memory_context_, buffer);
+}
+
 /////////////
 
 extern "C" {
@@ -65,6 +96,12 @@ CustomInitialize(const CustomInitializeData* data, void** custom_instance)
     return ErrorCodes::CreationFailure;
   }
 
+  // Make the server's pinned-memory pool available to the instance.
+  static_cast<CustomInstance*>(*custom_instance)
+      ->SetPinnedMemoryCallbacks(
+          data->pinned_memory_context, data->pinned_alloc_fn,
+          data->pinned_free_fn);
+
   return ErrorCodes::Success;
 }
 
@@ -113,6 +150,21 @@ CustomExecuteV2(
   return instance->Execute(payload_cnt, payloads, input_fn, output_fn);
 }
 
+int
+CustomExecuteV3(
+    void* custom_instance, const uint32_t payload_cnt, CustomPayload* payloads,
+    CustomGetNextInputV2Fn_t input_fn, CustomGetOutputV2Fn_t output_fn,
+    CustomPutOutputV2Fn_t put_output_fn)
+{
+  if (custom_instance == nullptr) {
+    return ErrorCodes::Unknown;
+  }
+
+  CustomInstance* instance = static_cast<CustomInstance*>(custom_instance);
+  return instance->Execute(
+      payload_cnt, payloads, input_fn, output_fn, put_output_fn);
+}
+
 }  // extern "C"
 
 }}}  // namespace nvidia::inferenceserver::custom
@@ -97,6 +97,26 @@ class CustomInstance {
     return ErrorCodes::InvalidInvocationV2;
   }
 
+  /// Execute the custom instance. User should override this function
+  /// if version 3 of the custom interface is used.
+  ///
+  /// \param payload_cnt The number of payloads to execute.
+  /// \param payloads The payloads to execute.
+  /// \param input_fn The callback function to get tensor input (see
+  /// CustomGetNextInputV2Fn_t).
+  /// \param output_fn The callback function to get buffer for tensor
+  /// output (see CustomGetOutputV2Fn_t).
+  /// \param put_output_fn The callback function to donate a
+  /// backend-owned buffer as tensor output (see CustomPutOutputV2Fn_t).
+  /// \return Error code indicating success or the type of failure
+  virtual int Execute(
+      const uint32_t payload_cnt, CustomPayload* payloads,
+      CustomGetNextInputV2Fn_t input_fn, CustomGetOutputV2Fn_t output_fn,
+      CustomPutOutputV2Fn_t put_output_fn)
+  {
+    return ErrorCodes::InvalidInvocationV3;
+  }
+
   /// Get the string for an error code.
   ///
   /// /param error Error code returned by a CustomInstance function
@@ -106,6 +126,20 @@ class CustomInstance {
     return errors_.ErrorString(error);
   }
 
+  /// Record the server's pinned-memory pool callbacks for this
+  /// instance. Called by the SDK during CustomInitialize, after
+  /// Create returns; backends don't call this directly.
+  ///
+  /// \param pinned_memory_context The context to pass to the callback
+  /// functions.
+  /// \param pinned_alloc_fn The callback function to allocate a
+  /// pinned staging buffer (see CustomPinnedAllocFn_t).
+  /// \param pinned_free_fn The callback function to release a pinned
+  /// staging buffer (see CustomPinnedFreeFn_t).
+  void SetPinnedMemoryCallbacks(
+      void* pinned_memory_context, CustomPinnedAllocFn_t pinned_alloc_fn,
+      CustomPinnedFreeFn_t pinned_free_fn);
+
  protected:
   /// Base constructor for CustomInstance
   ///
@@ -126,6 +160,26 @@ class CustomInstance {
     return errors_.RegisterError(error_message);
   }
 
+  /// Allocate a staging buffer from the server's pinned-memory pool.
+  /// Pinned buffers give full-bandwidth cudaMemcpy transfers and
+  /// should be used to stage data moving to or from GPU memory; this
+  /// is the same fast path used by the built-in backends. The buffer
+  /// must be released with PinnedFree. Available after initialization
+  /// completes, so not from within Create or Init.
+  ///
+  /// \param byte_size The size of the buffer, in bytes.
+  /// \param buffer Returns the allocated buffer.
+  /// \return false if the pool is unavailable or exhausted, in which
+  /// case the backend should fall back to its own allocation.
+  bool PinnedAlloc(uint64_t byte_size, void** buffer);
+
+  /// Release a buffer obtained from PinnedAlloc back to the server's
+  /// pinned-memory pool.
+  ///
+  /// \param buffer The buffer to release.
+  /// \return false if error, true if success.
+  bool PinnedFree(void* buffer);
+
   /// The name of this backend instance
   const std::string instance_name_;
 
@@ -139,6 +193,12 @@ class CustomInstance {
  private:
   /// Error code manager.
   ErrorCodes errors_{};
+
+  /// The server's pinned-memory pool callbacks, nullptr if the
+  /// server does not expose the pool.
+  void* pinned_memory_context_ = nullptr;
+  CustomPinnedAllocFn_t pinned_alloc_fn_ = nullptr;
+  CustomPinnedFreeFn_t pinned_free_fn_ = nullptr;
 };
 
 }}}  // namespace nvidia::inferenceserver::custom
@@ -40,6 +40,9 @@ ErrorCodes::ErrorCodes()
       InvalidInvocationV2,
       "invalid V2 function invocation while the custom backend is not V2");
   RegisterError(Unknown, "unknown error");
+  RegisterError(
+      InvalidInvocationV3,
+      "invalid V3 function invocation while the custom backend is not V3");
 }
 
 const char*
@@ -58,6 +58,10 @@ class ErrorCodes {
   /// Error code for an unknown error.
   static const int Unknown = 5;
 
+  /// Error code when V3 version of a function is called
+  /// while the custom backend is not V3.
+  static const int InvalidInvocationV3 = 6;
+
   ErrorCodes();
   ~ErrorCodes() = default;
 
@@ -75,7 +79,7 @@ class ErrorCodes {
 
  private:
   /// List of error messages indexed by the error codes
-  std::vector<std::string> err_messages_{Unknown + 1};
+  std::vector<std::string> err_messages_{InvalidInvocationV3 + 1};
 
   /// Register a specific error. This is use for internal class registration
   /// only.
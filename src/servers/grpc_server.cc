@@ -26,6 +26,8 @@
 
 #include "src/servers/grpc_server.h"
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <map>
@@ -1057,6 +1059,20 @@ InferHandler::Process(Handler::State* state, bool rpc_ok)
       err = SetTRTSERVER_InferenceRequestOptions(
           request_options, request.meta_data());
     }
+    if (err == nullptr) {
+      // Propagate the gRPC call deadline, if any, so that the
+      // scheduler doesn't delay the request past it and drops it if
+      // it can no longer be served in time.
+      const auto deadline = state->context_->ctx_->deadline();
+      if (deadline != std::chrono::system_clock::time_point::max()) {
+        const auto deadline_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                deadline - std::chrono::system_clock::now())
+                .count();
+        err = TRTSERVER_InferenceRequestOptionsSetDeadlineMicroseconds(
+            request_options, (deadline_us > 0) ? deadline_us : 1);
+      }
+    }
     TRTSERVER_InferenceRequestProvider* request_provider = nullptr;
     if (err == nullptr) {
       err = TRTSERVER_InferenceRequestProviderNewV2(
@@ -1367,6 +1383,19 @@ StreamInferHandler::Process(Handler::State* state, bool rpc_ok)
       err = SetTRTSERVER_InferenceRequestOptions(
           request_options, request.meta_data());
     }
+    if (err == nullptr) {
+      // The stream deadline bounds every request on the stream, so
+      // propagate it to each inference.
+      const auto deadline = state->context_->ctx_->deadline();
+      if (deadline != std::chrono::system_clock::time_point::max()) {
+        const auto deadline_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                deadline - std::chrono::system_clock::now())
+                .count();
+        err = TRTSERVER_InferenceRequestOptionsSetDeadlineMicroseconds(
+            request_options, (deadline_us > 0) ? deadline_us : 1);
+      }
+    }
 
     TRTSERVER_InferenceRequestProvider* request_provider = nullptr;
     if (err == nullptr) {
@@ -1868,8 +1897,22 @@ GRPCServer::Start()
   health_cq_ = grpc_builder_.AddCompletionQueue();
   status_cq_ = grpc_builder_.AddCompletionQueue();
   repository_cq_ = grpc_builder_.AddCompletionQueue();
-  infer_cq_ = grpc_builder_.AddCompletionQueue();
-  stream_infer_cq_ = grpc_builder_.AddCompletionQueue();
+
+  // The inference and streaming-inference completion queues are
+  // sharded, with each shard serviced by its own single-threaded
+  // handler. InferHandler::Process and StreamInferHandler::Process
+  // are not safe for concurrent calls on the same queue, so scaling
+  // comes from adding queues rather than adding threads to one
+  // queue.
+  const int infer_cq_cnt = std::max(1, infer_thread_cnt_);
+  for (int i = 0; i < infer_cq_cnt; ++i) {
+    infer_cqs_.emplace_back(grpc_builder_.AddCompletionQueue());
+  }
+  const int stream_infer_cq_cnt = std::max(1, stream_infer_thread_cnt_);
+  for (int i = 0; i < stream_infer_cq_cnt; ++i) {
+    stream_infer_cqs_.emplace_back(grpc_builder_.AddCompletionQueue());
+  }
+
   modelcontrol_cq_ = grpc_builder_.AddCompletionQueue();
   shmcontrol_cq_ = grpc_builder_.AddCompletionQueue();
   grpc_server_ = grpc_builder_.BuildAndStart();
@@ -1898,29 +1941,33 @@ GRPCServer::Start()
   hrepository->Start(1 /* thread_cnt */);
   repository_handler_.reset(hrepository);
 
-  // Handler for inference requests. 'infer_thread_cnt_' is not used
-  // below due to thread-safety requirements and the way
-  // InferHandler::Process is written. We should likely implement it
-  // by making multiple completion queues each of which is serviced by
-  // a single thread.
-  InferHandler* hinfer = new InferHandler(
-      "InferHandler", server_, server_id_, trace_manager_, shm_manager_,
-      &service_, infer_cq_.get(),
-      infer_allocation_pool_size_ /* max_state_bucket_count */);
-  hinfer->Start(/* infer_thread_cnt_ */ 1);
-  infer_handler_.reset(hinfer);
-
-  // Handler for streaming inference requests.
-  // 'stream_infer_thread_cnt_' is not used below due to thread-safety
-  // requirements and the way StreamInferHandler::Process is
-  // written. We should likely implement it by making multiple
-  // completion queues each of which is serviced by a single thread.
-  StreamInferHandler* hstreaminfer = new StreamInferHandler(
-      "StreamInferHandler", server_, server_id_, trace_manager_, shm_manager_,
-      &service_, stream_infer_cq_.get(),
-      infer_allocation_pool_size_ /* max_state_bucket_count */);
-  hstreaminfer->Start(/* stream_infer_thread_cnt_ */ 1);
-  stream_infer_handler_.reset(hstreaminfer);
+  // Handlers for inference requests, one single-threaded handler per
+  // completion-queue shard. The state pool is divided across the
+  // shards so the total number of pooled request-state objects stays
+  // at 'infer_allocation_pool_size_'.
+  const int infer_pool_size =
+      std::max(1, infer_allocation_pool_size_ / infer_cq_cnt);
+  for (int i = 0; i < infer_cq_cnt; ++i) {
+    InferHandler* hinfer = new InferHandler(
+        "InferHandler" + std::to_string(i), server_, server_id_,
+        trace_manager_, shm_manager_, &service_, infer_cqs_[i].get(),
+        infer_pool_size /* max_state_bucket_count */);
+    hinfer->Start(1 /* thread_cnt */);
+    infer_handlers_.emplace_back(hinfer);
+  }
+
+  // Handlers for streaming inference requests, one single-threaded
+  // handler per completion-queue shard.
+  const int stream_infer_pool_size =
+      std::max(1, infer_allocation_pool_size_ / stream_infer_cq_cnt);
+  for (int i = 0; i < stream_infer_cq_cnt; ++i) {
+    StreamInferHandler* hstreaminfer = new StreamInferHandler(
+        "StreamInferHandler" + std::to_string(i), server_, server_id_,
+        trace_manager_, shm_manager_, &service_, stream_infer_cqs_[i].get(),
+        stream_infer_pool_size /* max_state_bucket_count */);
+    hstreaminfer->Start(1 /* thread_cnt */);
+    stream_infer_handlers_.emplace_back(hstreaminfer);
+  }
 
   // Handler for model-control requests. A single thread processes all
   // of these requests.
@@ -1957,8 +2004,12 @@ GRPCServer::Stop()
   health_cq_->Shutdown();
   status_cq_->Shutdown();
   repository_cq_->Shutdown();
-  infer_cq_->Shutdown();
-  stream_infer_cq_->Shutdown();
+  for (auto& cq : infer_cqs_) {
+    cq->Shutdown();
+  }
+  for (auto& cq : stream_infer_cqs_) {
+    cq->Shutdown();
+  }
   modelcontrol_cq_->Shutdown();
   shmcontrol_cq_->Shutdown();
 
@@ -1967,8 +2018,12 @@ GRPCServer::Stop()
   dynamic_cast<HealthHandler*>(health_handler_.get())->Stop();
   dynamic_cast<StatusHandler*>(status_handler_.get())->Stop();
   dynamic_cast<RepositoryHandler*>(repository_handler_.get())->Stop();
-  dynamic_cast<InferHandler*>(infer_handler_.get())->Stop();
-  dynamic_cast<StreamInferHandler*>(stream_infer_handler_.get())->Stop();
+  for (auto& handler : infer_handlers_) {
+    dynamic_cast<InferHandler*>(handler.get())->Stop();
+  }
+  for (auto& handler : stream_infer_handlers_) {
+    dynamic_cast<StreamInferHandler*>(handler.get())->Stop();
+  }
   dynamic_cast<ModelControlHandler*>(modelcontrol_handler_.get())->Stop();
   dynamic_cast<SharedMemoryControlHandler*>(shmcontrol_handler_.get())->Stop();
 
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <grpc++/grpc++.h>
+#include <vector>
 #include "src/core/grpc_service.grpc.pb.h"
 #include "src/core/trtserver.h"
 #include "src/servers/shared_memory_manager.h"
@@ -77,8 +78,8 @@ class GRPCServer {
   std::unique_ptr<grpc::ServerCompletionQueue> health_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> status_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> repository_cq_;
-  std::unique_ptr<grpc::ServerCompletionQueue> infer_cq_;
-  std::unique_ptr<grpc::ServerCompletionQueue> stream_infer_cq_;
+  std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> infer_cqs_;
+  std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> stream_infer_cqs_;
   std::unique_ptr<grpc::ServerCompletionQueue> modelcontrol_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> shmcontrol_cq_;
 
@@ -88,8 +89,8 @@ class GRPCServer {
   std::unique_ptr<HandlerBase> health_handler_;
   std::unique_ptr<HandlerBase> status_handler_;
   std::unique_ptr<HandlerBase> repository_handler_;
-  std::unique_ptr<HandlerBase> infer_handler_;
-  std::unique_ptr<HandlerBase> stream_infer_handler_;
+  std::vector<std::unique_ptr<HandlerBase>> infer_handlers_;
+  std::vector<std::unique_ptr<HandlerBase>> stream_infer_handlers_;
   std::unique_ptr<HandlerBase> modelcontrol_handler_;
   std::unique_ptr<HandlerBase> shmcontrol_handler_;
 
@@ -26,24 +26,33 @@
 
 #include "src/servers/grpc_server_v2.h"
 
+#include <google/protobuf/arena.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <map>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 #include "grpc++/grpc++.h"
 #include "grpc++/security/server_credentials.h"
 #include "grpc++/server.h"
 #include "grpc++/server_builder.h"
 #include "grpc++/server_context.h"
+#include "grpc++/support/byte_buffer.h"
+#include "grpc++/support/slice.h"
 #include "grpc++/support/status.h"
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
 #include "src/core/constants.h"
+#include "src/core/cpu_affinity.h"
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
 #include "src/core/server_status.pb.h"
+#include "src/core/spin_wait.h"
 #include "src/core/tritonserver.h"
 #include "src/servers/common.h"
 
@@ -51,6 +60,364 @@
 #include "src/servers/tracer.h"
 #endif  // TRTIS_ENABLE_TRACING
 
+namespace {
+
+// An output tensor whose raw contents are at least this large is sent
+// to the wire as a zero-copy slice referencing the response's tensor
+// buffer directly, instead of being copied into gRPC's serialization
+// buffers. Smaller tensors aren't worth the extra slices on the wire.
+const size_t kZeroCopyContentsThreshold = 16 * 1024;
+
+// Owns the raw tensor contents referenced by the zero-copy slices of
+// a serialized response. Each slice holds a reference; the transport
+// releasing the last slice deletes the holder and with it the tensor
+// buffers.
+struct SliceContentsHolder {
+  SliceContentsHolder() : refcount_(0) {}
+  std::vector<std::string> contents_;
+  std::atomic<size_t> refcount_;
+};
+
+void
+SliceContentsRelease(void* userp)
+{
+  SliceContentsHolder* holder = static_cast<SliceContentsHolder*>(userp);
+  if (holder->refcount_.fetch_sub(1) == 1) {
+    delete holder;
+  }
+}
+
+// Protobuf wire-format helpers used to re-emit the envelopes around a
+// zero-copy tensor payload byte-for-byte. All field numbers involved
+// are below 16 so every tag encodes in a single byte.
+size_t
+VarintByteSize(uint64_t value)
+{
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+void
+AppendVarint(uint64_t value, std::string* buffer)
+{
+  uint8_t encoded[10];
+  size_t size = 0;
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    encoded[size++] = byte | ((value > 0) ? 0x80 : 0);
+  } while (value > 0);
+  buffer->append(reinterpret_cast<const char*>(encoded), size);
+}
+
+void
+AppendLengthDelimitedHeader(
+    int field_number, size_t byte_size, std::string* buffer)
+{
+  buffer->push_back(static_cast<char>((field_number << 3) | 2));
+  AppendVarint(byte_size, buffer);
+}
+
+// Byte size of a length-delimited field (single-byte tag) holding
+// 'byte_size' payload bytes.
+size_t
+LengthDelimitedByteSize(size_t byte_size)
+{
+  return 1 /* tag */ + VarintByteSize(byte_size) + byte_size;
+}
+
+bool
+HasZeroCopyContents(const nvidia::inferenceserver::ModelInferResponse& response)
+{
+  for (const auto& output : response.outputs()) {
+    if (output.contents().raw_contents().size() >= kZeroCopyContentsThreshold) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+HasZeroCopyContents(
+    const nvidia::inferenceserver::ModelStreamInferResponse& response)
+{
+  return HasZeroCopyContents(response.infer_response());
+}
+
+bool
+HasZeroCopyContents(
+    const nvidia::inferenceserver::ModelBatchInferResponse& response)
+{
+  for (const auto& r : response.responses()) {
+    if (HasZeroCopyContents(r)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Close the current scratch slice, copying the accumulated envelope
+// bytes into 'slices'.
+void
+FlushScratchSlice(std::string* scratch, std::vector<grpc::Slice>* slices)
+{
+  if (!scratch->empty()) {
+    slices->emplace_back(scratch->data(), scratch->size());
+    scratch->clear();
+  }
+}
+
+// Emit the wire-format bytes of 'response' into 'slices': large raw
+// tensor contents become zero-copy slices owned by 'holder', all
+// other bytes are copied through 'scratch'. The emitted bytes are
+// exactly the standard serialization of the message as it was on
+// entry; the large contents strings are moved out of the message, so
+// the message must not be serialized again.
+void
+EmitInferResponseSlices(
+    nvidia::inferenceserver::ModelInferResponse* response,
+    std::string* scratch, std::vector<grpc::Slice>* slices,
+    SliceContentsHolder* holder)
+{
+  // Top-level fields other than the outputs serialize through a small
+  // copy of the message.
+  nvidia::inferenceserver::ModelInferResponse head;
+  head.set_model_name(response->model_name());
+  head.set_model_version(response->model_version());
+  head.set_id(response->id());
+  *head.mutable_parameters() = response->parameters();
+  head.AppendToString(scratch);
+
+  for (auto& output : *(response->mutable_outputs())) {
+    const size_t raw_byte_size = output.contents().raw_contents().size();
+    if (raw_byte_size < kZeroCopyContentsThreshold) {
+      AppendLengthDelimitedHeader(
+          5 /* outputs */, output.ByteSizeLong(), scratch);
+      output.AppendToString(scratch);
+      continue;
+    }
+
+    // Move the raw contents out of the tensor so the remainder of the
+    // tensor and of its contents submessage serialize normally, then
+    // re-emit the enclosing envelopes with lengths that account for
+    // the moved-out payload.
+    holder->contents_.emplace_back();
+    std::string& raw = holder->contents_.back();
+    raw.swap(*(output.mutable_contents()->mutable_raw_contents()));
+
+    const size_t contents_byte_size =
+        output.contents().ByteSizeLong() + LengthDelimitedByteSize(raw.size());
+    std::string contents_rest;
+    output.contents().AppendToString(&contents_rest);
+    output.clear_contents();
+
+    const size_t output_byte_size =
+        output.ByteSizeLong() + LengthDelimitedByteSize(contents_byte_size);
+
+    AppendLengthDelimitedHeader(5 /* outputs */, output_byte_size, scratch);
+    output.AppendToString(scratch);
+    AppendLengthDelimitedHeader(4 /* contents */, contents_byte_size, scratch);
+    scratch->append(contents_rest);
+    AppendLengthDelimitedHeader(1 /* raw_contents */, raw.size(), scratch);
+    FlushScratchSlice(scratch, slices);
+
+    holder->refcount_++;
+    slices->emplace_back(
+        const_cast<char*>(raw.data()), raw.size(), SliceContentsRelease,
+        holder);
+  }
+}
+
+void
+EmitStreamInferResponseSlices(
+    nvidia::inferenceserver::ModelStreamInferResponse* response,
+    std::string* scratch, std::vector<grpc::Slice>* slices,
+    SliceContentsHolder* holder)
+{
+  if (!response->error_message().empty()) {
+    AppendLengthDelimitedHeader(
+        1 /* error_message */, response->error_message().size(), scratch);
+    scratch->append(response->error_message());
+  }
+
+  if (response->has_infer_response()) {
+    AppendLengthDelimitedHeader(
+        2 /* infer_response */, response->infer_response().ByteSizeLong(),
+        scratch);
+    EmitInferResponseSlices(
+        response->mutable_infer_response(), scratch, slices, holder);
+  }
+}
+
+void
+EmitBatchInferResponseSlices(
+    nvidia::inferenceserver::ModelBatchInferResponse* response,
+    std::string* scratch, std::vector<grpc::Slice>* slices,
+    SliceContentsHolder* holder)
+{
+  for (auto& r : *(response->mutable_responses())) {
+    AppendLengthDelimitedHeader(1 /* responses */, r.ByteSizeLong(), scratch);
+    EmitStreamInferResponseSlices(&r, scratch, slices, holder);
+  }
+}
+
+// Assemble the emitted slices into 'bb'.
+grpc::Status
+FinishSliceByteBuffer(
+    std::string* scratch, std::vector<grpc::Slice>* slices,
+    SliceContentsHolder* holder, grpc::ByteBuffer* bb)
+{
+  FlushScratchSlice(scratch, slices);
+
+  // No slice took a reference on the holder, so it is released here.
+  if (holder->refcount_ == 0) {
+    delete holder;
+  }
+
+  grpc::ByteBuffer buffer(slices->data(), slices->size());
+  bb->Swap(&buffer);
+  return grpc::Status::OK;
+}
+
+// Standard protobuf serialization into a single slice, used for
+// responses with no large raw tensor contents.
+template <typename ResponseType>
+grpc::Status
+SerializeViaProtobuf(const ResponseType& msg, grpc::ByteBuffer* bb)
+{
+  grpc::Slice slice(msg.ByteSizeLong());
+  msg.SerializeWithCachedSizesToArray(const_cast<uint8_t*>(slice.begin()));
+  grpc::ByteBuffer buffer(&slice, 1);
+  bb->Swap(&buffer);
+  return grpc::Status::OK;
+}
+
+template <typename ResponseType>
+grpc::Status
+DeserializeViaProtobuf(grpc::ByteBuffer* buffer, ResponseType* msg)
+{
+  std::vector<grpc::Slice> slices;
+  grpc::Status status = buffer->Dump(&slices);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::string bytes;
+  for (const auto& slice : slices) {
+    bytes.append(reinterpret_cast<const char*>(slice.begin()), slice.size());
+  }
+
+  if (!msg->ParseFromString(bytes)) {
+    return grpc::Status(
+        grpc::StatusCode::INTERNAL, "failed to parse message");
+  }
+
+  return grpc::Status::OK;
+}
+
+}  // namespace
+
+namespace grpc {
+
+// Custom serialization for the inference response messages: the raw
+// contents of large output tensors travel as zero-copy slices that
+// reference the buffers the inference wrote into, so they cross from
+// the response protobuf to the wire without an intermediate copy.
+// Serializing a response moves its large tensor buffers into the
+// slice holder, which is fine as a response is serialized exactly
+// once, when it is written.
+template <>
+class SerializationTraits<nvidia::inferenceserver::ModelInferResponse> {
+ public:
+  static Status Serialize(
+      const nvidia::inferenceserver::ModelInferResponse& msg, ByteBuffer* bb,
+      bool* own_buffer)
+  {
+    *own_buffer = true;
+    if (!HasZeroCopyContents(msg)) {
+      return SerializeViaProtobuf(msg, bb);
+    }
+
+    SliceContentsHolder* holder = new SliceContentsHolder();
+    std::vector<Slice> slices;
+    std::string scratch;
+    EmitInferResponseSlices(
+        const_cast<nvidia::inferenceserver::ModelInferResponse*>(&msg),
+        &scratch, &slices, holder);
+    return FinishSliceByteBuffer(&scratch, &slices, holder, bb);
+  }
+
+  static Status Deserialize(
+      ByteBuffer* buffer, nvidia::inferenceserver::ModelInferResponse* msg)
+  {
+    return DeserializeViaProtobuf(buffer, msg);
+  }
+};
+
+template <>
+class SerializationTraits<nvidia::inferenceserver::ModelStreamInferResponse> {
+ public:
+  static Status Serialize(
+      const nvidia::inferenceserver::ModelStreamInferResponse& msg,
+      ByteBuffer* bb, bool* own_buffer)
+  {
+    *own_buffer = true;
+    if (!HasZeroCopyContents(msg)) {
+      return SerializeViaProtobuf(msg, bb);
+    }
+
+    SliceContentsHolder* holder = new SliceContentsHolder();
+    std::vector<Slice> slices;
+    std::string scratch;
+    EmitStreamInferResponseSlices(
+        const_cast<nvidia::inferenceserver::ModelStreamInferResponse*>(&msg),
+        &scratch, &slices, holder);
+    return FinishSliceByteBuffer(&scratch, &slices, holder, bb);
+  }
+
+  static Status Deserialize(
+      ByteBuffer* buffer,
+      nvidia::inferenceserver::ModelStreamInferResponse* msg)
+  {
+    return DeserializeViaProtobuf(buffer, msg);
+  }
+};
+
+template <>
+class SerializationTraits<nvidia::inferenceserver::ModelBatchInferResponse> {
+ public:
+  static Status Serialize(
+      const nvidia::inferenceserver::ModelBatchInferResponse& msg,
+      ByteBuffer* bb, bool* own_buffer)
+  {
+    *own_buffer = true;
+    if (!HasZeroCopyContents(msg)) {
+      return SerializeViaProtobuf(msg, bb);
+    }
+
+    SliceContentsHolder* holder = new SliceContentsHolder();
+    std::vector<Slice> slices;
+    std::string scratch;
+    EmitBatchInferResponseSlices(
+        const_cast<nvidia::inferenceserver::ModelBatchInferResponse*>(&msg),
+        &scratch, &slices, holder);
+    return FinishSliceByteBuffer(&scratch, &slices, holder, bb);
+  }
+
+  static Status Deserialize(
+      ByteBuffer* buffer,
+      nvidia::inferenceserver::ModelBatchInferResponse* msg)
+  {
+    return DeserializeViaProtobuf(buffer, msg);
+  }
+};
+
+}  // namespace grpc
+
 namespace nvidia { namespace inferenceserver {
 
 namespace {
@@ -193,7 +560,8 @@ struct AllocPayload {
       std::unordered_map<std::string, std::shared_ptr<std::string>>;
 
   explicit AllocPayload()
-      : response_(nullptr), shm_map_(nullptr), serialized_data_map_(nullptr)
+      : response_(nullptr), shm_map_(nullptr), serialized_data_map_(nullptr),
+        shm_auto_(false)
   {
   }
   ~AllocPayload()
@@ -208,6 +576,11 @@ struct AllocPayload {
   // Used to extend the lifetime of the serialized data in case
   // repeated byte contents were provided in the request.
   TensorSerializedDataMap* serialized_data_map_;
+
+  // True if the request asked for automatic shared-memory placement
+  // of outputs that have no explicit shared-memory parameters.
+  bool shm_auto_;
+  std::shared_ptr<SharedMemoryManager> shm_manager_;
 };
 
 //
@@ -224,26 +597,37 @@ class HandlerState {
   // transaction (e.g. a stream).
   struct Context {
     explicit Context(const uint64_t unique_id = 0)
-        : unique_id_(unique_id), step_(Steps::START), finish_ok_(true)
+        : unique_id_(unique_id), step_(Steps::START), finish_ok_(true),
+          ordered_response_(true), write_inflight_(false)
     {
       ctx_.reset(new grpc::ServerContext());
       responder_.reset(new ServerResponderType(ctx_.get()));
     }
 
+    // Switch this context to unordered response delivery: each
+    // response is written as soon as its inference completes instead
+    // of in request order.
+    void SetUnorderedResponse()
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      ordered_response_ = false;
+    }
+
     // Enqueue 'state' so that its response is delivered in the
     // correct order.
     void EnqueueForResponse(HandlerStateType* state)
     {
       std::lock_guard<std::mutex> lock(mu_);
-      states_.push(state);
+      states_.push_back(state);
     }
 
-    // Check the state at the front of the queue and write it if
-    // ready. The state at the front of the queue is ready if it is in
+    // Write a queued state if one is ready. In the default ordered
+    // mode the state at the front of the queue is ready if it is in
     // the WRITEREADY state and it equals 'required_state' (or
-    // 'required_state' is nullptr). Return nullptr if front of queue
-    // was not ready (and so not written), or return the state if it
-    // was ready and written.
+    // 'required_state' is nullptr). In unordered mode any WRITEREADY
+    // state may be written once the previous write has finished.
+    // Return nullptr if no state was ready (and so not written), or
+    // return the state that was written.
     HandlerStateType* WriteResponseIfReady(HandlerStateType* required_state)
     {
       std::lock_guard<std::mutex> lock(mu_);
@@ -251,13 +635,56 @@ class HandlerState {
         return nullptr;
       }
 
-      HandlerStateType* state = states_.front();
-      if (state->step_ != Steps::WRITEREADY) {
-        return nullptr;
+      HandlerStateType* state = nullptr;
+      if (ordered_response_) {
+        state = states_.front();
+        if (state->step_ != Steps::WRITEREADY) {
+          return nullptr;
+        }
+
+        if ((required_state != nullptr) && (state != required_state)) {
+          return nullptr;
+        }
+      } else {
+        // Only one write may be outstanding on a stream at a time,
+        // so deliver in completion order: write the first ready
+        // state once no other write is in flight.
+        if (write_inflight_) {
+          return nullptr;
+        }
+
+        for (HandlerStateType* queued : states_) {
+          if (queued->step_ == Steps::WRITEREADY) {
+            state = queued;
+            break;
+          }
+        }
+
+        if (state == nullptr) {
+          return nullptr;
+        }
       }
 
-      if ((required_state != nullptr) && (state != required_state)) {
-        return nullptr;
+      // When the stream is congested the response that will be
+      // written next is often already ready. In that case ask gRPC to
+      // buffer this message instead of flushing it to the wire: the
+      // write for the next response is guaranteed to be issued as
+      // soon as this write's completion tag is processed, so a burst
+      // of ready responses coalesces into a single network flush
+      // carried by the last (unbuffered) write of the burst. Note
+      // that a ready state can only leave the queue by being written,
+      // so the follow-on write can't be skipped.
+      bool buffer_write = false;
+      if (ordered_response_) {
+        buffer_write = (states_.size() > 1) && (states_.front() == state) &&
+                       (states_[1]->step_ == Steps::WRITEREADY);
+      } else {
+        for (HandlerStateType* queued : states_) {
+          if ((queued != state) && (queued->step_ == Steps::WRITEREADY)) {
+            buffer_write = true;
+            break;
+          }
+        }
       }
 
 #ifdef TRTIS_ENABLE_TRACING
@@ -268,26 +695,45 @@ class HandlerState {
 #endif  // TRTIS_ENABLE_TRACING
 
       state->step_ = Steps::WRITTEN;
-      responder_->Write(state->response_, state);
+      write_inflight_ = true;
+      if (buffer_write) {
+        responder_->Write(
+            *state->response_, grpc::WriteOptions().set_buffer_hint(), state);
+      } else {
+        responder_->Write(*state->response_, state);
+      }
 
       return state;
     }
 
-    // If 'state' is at the front of the queue and written, pop it and
-    // return true. Other return false.
+    // If 'state' has been written, pop it from the queue and return
+    // true. Otherwise return false. In the default ordered mode
+    // 'state' must be at the front of the queue.
     bool PopCompletedResponse(HandlerStateType* state)
     {
       std::lock_guard<std::mutex> lock(mu_);
-      if (states_.empty()) {
+      if (states_.empty() || (state->step_ != Steps::WRITTEN)) {
         return false;
       }
 
-      HandlerStateType* front = states_.front();
-      if ((front == state) && (state->step_ == Steps::WRITTEN)) {
-        states_.pop();
+      if (ordered_response_) {
+        if (states_.front() != state) {
+          return false;
+        }
+
+        states_.pop_front();
+        write_inflight_ = false;
         return true;
       }
 
+      for (auto it = states_.begin(); it != states_.end(); ++it) {
+        if (*it == state) {
+          states_.erase(it);
+          write_inflight_ = false;
+          return true;
+        }
+      }
+
       return false;
     }
 
@@ -312,7 +758,7 @@ class HandlerState {
     // orders. A state enters this queue when it has successfully read
     // a request and exits the queue when it is written.
     std::mutex mu_;
-    std::queue<HandlerStateType*> states_;
+    std::deque<HandlerStateType*> states_;
 
     // The step of the entire context.
     Steps step_;
@@ -320,10 +766,21 @@ class HandlerState {
     // True if this context should finish with OK status, false if
     // should finish with CANCELLED status.
     bool finish_ok_;
+
+    // True, the default, if responses must be written in request
+    // order. False if each response is written as soon as it is
+    // ready.
+    bool ordered_response_;
+
+    // True while a response write is outstanding on the stream. Used
+    // in unordered mode where the front of 'states_' doesn't track
+    // the write in flight.
+    bool write_inflight_;
   };
 
   explicit HandlerState(
       const std::shared_ptr<Context>& context, Steps start_step = Steps::START)
+      : arena_(MakeArenaOptions())
   {
     Reset(context, start_step);
   }
@@ -334,8 +791,15 @@ class HandlerState {
     context_ = context;
     unique_id_ = RequestStatusUtil::NextUniqueRequestId();
     step_ = start_step;
-    request_.Clear();
-    response_.Clear();
+
+    // Recycle the arena instead of clearing the messages so that all
+    // message allocations, including per-field strings and repeated
+    // fields, are bump allocations that never hit the global
+    // allocator. The arena retains 'arena_block_' across resets so a
+    // recycled state serves small messages without any allocation.
+    arena_.Reset();
+    request_ = google::protobuf::Arena::CreateMessage<RequestType>(&arena_);
+    response_ = google::protobuf::Arena::CreateMessage<ResponseType>(&arena_);
   }
 
   void Release() { context_ = nullptr; }
@@ -349,12 +813,28 @@ class HandlerState {
   std::unique_ptr<TraceMetaData> trace_meta_data_;
 #endif  // TRTIS_ENABLE_TRACING
 
-  RequestType request_;
-  ResponseType response_;
+  // The request and response messages, arena-allocated and owned by
+  // 'arena_'.
+  RequestType* request_;
+  ResponseType* response_;
 
   // For inference requests the allocator payload, unused for other
   // requests.
   AllocPayload alloc_payload_;
+
+ private:
+  google::protobuf::ArenaOptions MakeArenaOptions()
+  {
+    google::protobuf::ArenaOptions options;
+    options.initial_block = arena_block_;
+    options.initial_block_size = sizeof(arena_block_);
+    return options;
+  }
+
+  // The initial arena block, kept with the state so the arena reuses
+  // it across resets.
+  char arena_block_[8192];
+  google::protobuf::Arena arena_;
 };
 
 //
@@ -479,13 +959,44 @@ Handler<ServiceType, ServerResponderType, RequestType, ResponseType>::Start()
   auto barrier = std::make_shared<Barrier>(2);
 
   thread_.reset(new std::thread([this, barrier] {
+    BindThreadToAffinityPool(AffinityPool::GRPC_POLLER);
+
     StartNewRequest();
     barrier->Wait();
 
+    // In low-latency mode poll the completion queue with an immediate
+    // deadline for a bounded window before falling back to the
+    // blocking Next(), so a completion that arrives while the poller
+    // is hot doesn't pay the epoll wakeup latency.
+    const int64_t spin_us = SpinWaitMicroseconds();
+
     void* tag;
     bool ok;
 
-    while (cq_->Next(&tag, &ok)) {
+    while (true) {
+      bool got_event = false;
+
+      if (spin_us > 0) {
+        const auto spin_deadline = std::chrono::steady_clock::now() +
+                                   std::chrono::microseconds(spin_us);
+        do {
+          const auto status = cq_->AsyncNext(
+              &tag, &ok, std::chrono::system_clock::now());
+          if (status == grpc::CompletionQueue::GOT_EVENT) {
+            got_event = true;
+            break;
+          }
+          if (status == grpc::CompletionQueue::SHUTDOWN) {
+            return;
+          }
+          SpinPause();
+        } while (std::chrono::steady_clock::now() < spin_deadline);
+      }
+
+      if (!got_event && !cq_->Next(&tag, &ok)) {
+        return;
+      }
+
       State* state = static_cast<State*>(tag);
       if (!Process(state, ok)) {
         LOG_VERBOSE(1) << "Done for " << Name() << ", " << state->unique_id_;
@@ -989,6 +1500,88 @@ CommonHandler::SetUpAllRequests()
       "CudaSharedMemoryUnregister", 0, OnRegisterCudaSharedMemoryUnregister,
       OnExecuteCudaSharedMemoryUnregister);
 
+  //
+  // CudaSharedMemoryBatchRegister
+  //
+  auto OnRegisterCudaSharedMemoryBatchRegister =
+      [this](
+          grpc::ServerContext* ctx,
+          CudaSharedMemoryBatchRegisterRequest* request,
+          grpc::ServerAsyncResponseWriter<
+              CudaSharedMemoryBatchRegisterResponse>* responder,
+          void* tag) {
+        this->service_->RequestCudaSharedMemoryBatchRegister(
+            ctx, request, responder, this->cq_, this->cq_, tag);
+      };
+
+  auto OnExecuteCudaSharedMemoryBatchRegister =
+      [this](
+          CudaSharedMemoryBatchRegisterRequest& request,
+          CudaSharedMemoryBatchRegisterResponse* response,
+          grpc::Status* status) {
+        TRITONSERVER_Error* err = nullptr;
+#ifdef TRTIS_ENABLE_GPU
+        err = shm_manager_->RegisterCUDASharedMemoryBatch(request);
+#else
+        err = TRITONSERVER_ErrorNew(
+            TRITONSERVER_ERROR_INVALID_ARG,
+            "failed to register CUDA shared memory regions, GPUs not "
+            "supported");
+#endif  // TRTIS_ENABLE_GPU
+
+        GrpcStatusUtil::Create(status, err);
+        TRITONSERVER_ErrorDelete(err);
+      };
+
+  new CommonCallData<
+      grpc::ServerAsyncResponseWriter<CudaSharedMemoryBatchRegisterResponse>,
+      CudaSharedMemoryBatchRegisterRequest,
+      CudaSharedMemoryBatchRegisterResponse>(
+      "CudaSharedMemoryBatchRegister", 0,
+      OnRegisterCudaSharedMemoryBatchRegister,
+      OnExecuteCudaSharedMemoryBatchRegister);
+
+  //
+  // CudaSharedMemoryBatchUnregister
+  //
+  auto OnRegisterCudaSharedMemoryBatchUnregister =
+      [this](
+          grpc::ServerContext* ctx,
+          CudaSharedMemoryBatchUnregisterRequest* request,
+          grpc::ServerAsyncResponseWriter<
+              CudaSharedMemoryBatchUnregisterResponse>* responder,
+          void* tag) {
+        this->service_->RequestCudaSharedMemoryBatchUnregister(
+            ctx, request, responder, this->cq_, this->cq_, tag);
+      };
+
+  auto OnExecuteCudaSharedMemoryBatchUnregister =
+      [this](
+          CudaSharedMemoryBatchUnregisterRequest& request,
+          CudaSharedMemoryBatchUnregisterResponse* response,
+          grpc::Status* status) {
+        TRITONSERVER_Error* err = nullptr;
+#ifdef TRTIS_ENABLE_GPU
+        err = shm_manager_->UnregisterCUDASharedMemoryBatch(request);
+#else
+        err = TRITONSERVER_ErrorNew(
+            TRITONSERVER_ERROR_INVALID_ARG,
+            "failed to unregister CUDA shared memory regions, GPUs not "
+            "supported");
+#endif  // TRTIS_ENABLE_GPU
+
+        GrpcStatusUtil::Create(status, err);
+        TRITONSERVER_ErrorDelete(err);
+      };
+
+  new CommonCallData<
+      grpc::ServerAsyncResponseWriter<CudaSharedMemoryBatchUnregisterResponse>,
+      CudaSharedMemoryBatchUnregisterRequest,
+      CudaSharedMemoryBatchUnregisterResponse>(
+      "CudaSharedMemoryBatchUnregister", 0,
+      OnRegisterCudaSharedMemoryBatchUnregister,
+      OnExecuteCudaSharedMemoryBatchUnregister);
+
   //
   // RepositoryIndex
   //
@@ -1156,7 +1749,7 @@ ServerLiveHandler::StartNewRequest()
   auto context = std::make_shared<State::Context>();
   State* state = StateNew(context);
   service_->RequestServerLive(
-      state->context_->ctx_.get(), &state->request_,
+      state->context_->ctx_.get(), state->request_,
       state->context_->responder_.get(), cq_, cq_, state);
 
   LOG_VERBOSE(1) << "New request handler for " << Name() << ", "
@@ -1178,7 +1771,7 @@ ServerLiveHandler::Process(Handler::State* state, bool rpc_ok)
     state->step_ = Steps::FINISH;
   }
 
-  ServerLiveResponse& response = state->response_;
+  ServerLiveResponse& response = *state->response_;
 
   if (state->step_ == Steps::START) {
     bool live = false;
@@ -1236,7 +1829,7 @@ ServerReadyHandler::StartNewRequest()
   auto context = std::make_shared<State::Context>();
   State* state = StateNew(context);
   service_->RequestServerReady(
-      state->context_->ctx_.get(), &state->request_,
+      state->context_->ctx_.get(), state->request_,
       state->context_->responder_.get(), cq_, cq_, state);
 
   LOG_VERBOSE(1) << "New request handler for " << Name() << ", "
@@ -1258,7 +1851,7 @@ ServerReadyHandler::Process(Handler::State* state, bool rpc_ok)
     state->step_ = Steps::FINISH;
   }
 
-  ServerReadyResponse& response = state->response_;
+  ServerReadyResponse& response = *state->response_;
 
   if (state->step_ == Steps::START) {
     bool ready = false;
@@ -1316,7 +1909,7 @@ ModelReadyHandler::StartNewRequest()
   auto context = std::make_shared<State::Context>();
   State* state = StateNew(context);
   service_->RequestModelReady(
-      state->context_->ctx_.get(), &state->request_,
+      state->context_->ctx_.get(), state->request_,
       state->context_->responder_.get(), cq_, cq_, state);
 
   LOG_VERBOSE(1) << "New request handler for " << Name() << ", "
@@ -1338,8 +1931,8 @@ ModelReadyHandler::Process(Handler::State* state, bool rpc_ok)
     state->step_ = Steps::FINISH;
   }
 
-  const ModelReadyRequest& request = state->request_;
-  ModelReadyResponse& response = state->response_;
+  const ModelReadyRequest& request = *state->request_;
+  ModelReadyResponse& response = *state->response_;
 
   if (state->step_ == Steps::START) {
     bool is_ready = false;
@@ -1398,7 +1991,7 @@ ServerMetadataHandler::StartNewRequest()
   auto context = std::make_shared<State::Context>();
   State* state = StateNew(context);
   service_->RequestServerMetadata(
-      state->context_->ctx_.get(), &state->request_,
+      state->context_->ctx_.get(), state->request_,
       state->context_->responder_.get(), cq_, cq_, state);
 
   LOG_VERBOSE(1) << "New request handler for " << Name() << ", "
@@ -1420,7 +2013,7 @@ ServerMetadataHandler::Process(Handler::State* state, bool rpc_ok)
     state->step_ = Steps::FINISH;
   }
 
-  ServerMetadataResponse& response = state->response_;
+  ServerMetadataResponse& response = *state->response_;
 
   if (state->step_ == Steps::START) {
     TRITONSERVER_Message* server_metadata_message = nullptr;
@@ -1505,7 +2098,7 @@ ModelMetadataHandler::StartNewRequest()
   auto context = std::make_shared<State::Context>();
   State* state = StateNew(context);
   service_->RequestModelMetadata(
-      state->context_->ctx_.get(), &state->request_,
+      state->context_->ctx_.get(), state->request_,
       state->context_->responder_.get(), cq_, cq_, state);
 
   LOG_VERBOSE(1) << "New request handler for " << Name() << ", "
@@ -1527,8 +2120,8 @@ ModelMetadataHandler::Process(Handler::State* state, bool rpc_ok)
     state->step_ = Steps::FINISH;
   }
 
-  const ModelMetadataRequest& request = state->request_;
-  ModelMetadataResponse& response = state->response_;
+  const ModelMetadataRequest& request = *state->request_;
+  ModelMetadataResponse& response = *state->response_;
 
   if (state->step_ == Steps::START) {
     TRITONSERVER_Message* model_metadata_message = nullptr;
@@ -1632,7 +2225,7 @@ ModelConfigHandler::StartNewRequest()
   auto context = std::make_shared<State::Context>();
   State* state = StateNew(context);
   service_->RequestModelConfig(
-      state->context_->ctx_.get(), &state->request_,
+      state->context_->ctx_.get(), state->request_,
       state->context_->responder_.get(), cq_, cq_, state);
 
   LOG_VERBOSE(1) << "New request handler for " << Name() << ", "
@@ -1654,8 +2247,8 @@ ModelConfigHandler::Process(Handler::State* state, bool rpc_ok)
     state->step_ = Steps::FINISH;
   }
 
-  const ModelConfigRequest& request = state->request_;
-  ModelConfigResponse& response = state->response_;
+  const ModelConfigRequest& request = *state->request_;
+  ModelConfigResponse& response = *state->response_;
 
   if (state->step_ == Steps::START) {
     TRITONSERVER_Message* model_config_message = nullptr;
@@ -1751,6 +2344,38 @@ InferResponseAlloc(
       }
     }
 
+    // If the request asked for automatic shared-memory placement,
+    // reserve a block from a registered region and report the chosen
+    // placement in the output parameters. Fall back to an inline
+    // response if no registered region is large enough.
+    if (!use_shm && payload->shm_auto_) {
+      std::string region_name;
+      size_t region_offset;
+      void* base;
+      TRITONSERVER_Error* err = payload->shm_manager_->AutoReserve(
+          byte_size, &region_name, &region_offset, &base);
+      if (err == nullptr) {
+        *buffer = base;
+        *actual_memory_type = TRITONSERVER_MEMORY_CPU;
+        *actual_memory_type_id = 0;
+        use_shm = true;
+
+        auto& params = *output_tensor->mutable_parameters();
+        params["shared_memory_region"].set_string_param(region_name);
+        params["shared_memory_offset"].set_int64_param(region_offset);
+        params["shared_memory_byte_size"].set_int64_param(byte_size);
+
+        LOG_VERBOSE(1) << "GRPC: auto shared-memory for '" << tensor_name
+                       << "' in region '" << region_name << "', offset "
+                       << region_offset << ", size " << byte_size;
+      } else {
+        LOG_VERBOSE(1) << "GRPC: no automatic shared-memory placement for '"
+                       << tensor_name
+                       << "': " << TRITONSERVER_ErrorMessage(err);
+        TRITONSERVER_ErrorDelete(err);
+      }
+    }
+
     if (!use_shm) {
       // Can't allocate for any memory type other than CPU. If asked to
       // allocate on GPU memory then force allocation on CPU instead.
@@ -1795,7 +2420,21 @@ ParseSharedMemoryParams(
 {
   *has_shared_memory = false;
   *offset = 0 /* default value */;
-  const auto& region_it = tensor.parameters().find("shared_memory_region");
+
+  // Tensors without parameters, the common case, have no
+  // shared-memory settings. Skip the lookups entirely so the
+  // per-request allocator setup does no work for them.
+  if (tensor.parameters().empty()) {
+    return nullptr;  // success
+  }
+
+  // Construct the parameter keys once instead of building a
+  // temporary std::string for every lookup on every request.
+  static const std::string kRegionParam("shared_memory_region");
+  static const std::string kOffsetParam("shared_memory_offset");
+  static const std::string kByteSizeParam("shared_memory_byte_size");
+
+  const auto& region_it = tensor.parameters().find(kRegionParam);
   if (region_it != tensor.parameters().end()) {
     *has_shared_memory = true;
     const auto& infer_param = region_it->second;
@@ -1812,7 +2451,7 @@ ParseSharedMemoryParams(
     *region_name = infer_param.string_param();
   }
 
-  const auto& offset_it = tensor.parameters().find("shared_memory_offset");
+  const auto& offset_it = tensor.parameters().find(kOffsetParam);
   if (offset_it != tensor.parameters().end()) {
     if (!*has_shared_memory) {
       return TRITONSERVER_ErrorNew(
@@ -1837,7 +2476,7 @@ ParseSharedMemoryParams(
     *offset = infer_param.int64_param();
   }
 
-  const auto& bs_it = tensor.parameters().find("shared_memory_byte_size");
+  const auto& bs_it = tensor.parameters().find(kByteSizeParam);
   if (bs_it != tensor.parameters().end()) {
     if (!*has_shared_memory) {
       return TRITONSERVER_ErrorNew(
@@ -1880,20 +2519,38 @@ InferAllocatorPayload(
     const std::shared_ptr<TRITONSERVER_Server>& tritonserver,
     const std::shared_ptr<SharedMemoryManager>& shm_manager,
     const ModelInferRequest& request,
-    AllocPayload::TensorSerializedDataMap* serialized_data_map,
+    std::unique_ptr<AllocPayload::TensorSerializedDataMap>* serialized_data_map,
     ModelInferResponse* response, AllocPayload* alloc_payload)
 {
   alloc_payload->response_ = response;
   if (alloc_payload->shm_map_ != nullptr) {
     alloc_payload->shm_map_->clear();
   }
-  if (alloc_payload->serialized_data_map_ != nullptr) {
-    alloc_payload->serialized_data_map_->clear();
-  }
-  if (!serialized_data_map->empty()) {
-    alloc_payload->serialized_data_map_ = serialized_data_map;
+
+  // A request can ask for automatic shared-memory placement of its
+  // outputs with the 'shared_memory_auto' parameter. The payload may
+  // be recycled from an earlier request so always reset the flag.
+  alloc_payload->shm_auto_ = false;
+  {
+    const auto& auto_it = request.parameters().find("shared_memory_auto");
+    if (auto_it != request.parameters().end()) {
+      if (auto_it->second.parameter_choice_case() !=
+          InferParameter::ParameterChoiceCase::kBoolParam) {
+        return TRITONSERVER_ErrorNew(
+            TRITONSERVER_ERROR_INVALID_ARG,
+            "invalid value type for 'shared_memory_auto' parameter, expected "
+            "bool_param.");
+      }
+      alloc_payload->shm_auto_ = auto_it->second.bool_param();
+      alloc_payload->shm_manager_ = shm_manager;
+    }
   }
 
+  // Take ownership of the serialized data, if any, releasing the map
+  // left from any previous use of this payload.
+  delete alloc_payload->serialized_data_map_;
+  alloc_payload->serialized_data_map_ = serialized_data_map->release();
+
   // If any of the outputs use shared memory, then we must calculate
   // the memory address for that output and store it in the allocator
   // payload so that it is available when the allocation callback is
@@ -1956,12 +2613,25 @@ InferGRPCToInputHelper(
   return nullptr;  // success
 }
 
+// Return the serialized-data map, allocating it on first use. The
+// map is only needed when some input requires re-serialization; for
+// raw and shared-memory inputs no copy of the tensor data is made.
+AllocPayload::TensorSerializedDataMap*
+SerializedDataMap(
+    std::unique_ptr<AllocPayload::TensorSerializedDataMap>* serialized_data_map)
+{
+  if (*serialized_data_map == nullptr) {
+    serialized_data_map->reset(new AllocPayload::TensorSerializedDataMap());
+  }
+  return serialized_data_map->get();
+}
+
 TRITONSERVER_Error*
 InferGRPCToInput(
     const std::shared_ptr<TRITONSERVER_Server>& tritonserver,
     const std::shared_ptr<SharedMemoryManager>& shm_manager,
     const ModelInferRequest& request,
-    AllocPayload::TensorSerializedDataMap* serialized_data_map,
+    std::unique_ptr<AllocPayload::TensorSerializedDataMap>* serialized_data_map,
     TRITONSERVER_InferenceRequest* inference_request)
 {
   // Verify that the batch-byte-size of each input matches the size of
@@ -1994,7 +2664,10 @@ InferGRPCToInput(
                 .c_str());
       }
 
-      // Try to read the raw contents if available
+      // Try to read the raw contents if available. The proto-owned
+      // string is referenced, not copied: the core wraps it as a
+      // MemoryReference block and the request message is kept alive
+      // by the handler state until the inference completes.
       const std::string& raw = io.contents().raw_contents();
       base = raw.c_str();
       byte_size = raw.size();
@@ -2016,7 +2689,7 @@ InferGRPCToInput(
           std::shared_ptr<std::string> serialized(new std::string());
           serialized->reserve(
               io.contents().int_contents_size() * elem_byte_size);
-          serialized_data_map->emplace(io.name(), serialized);
+          SerializedDataMap(serialized_data_map)->emplace(io.name(), serialized);
           for (const auto& element : io.contents().int_contents()) {
             // Assuming the system is little-endian, picking the
             // least significant byte of 32-bit integer as a
@@ -2033,7 +2706,7 @@ InferGRPCToInput(
           std::shared_ptr<std::string> serialized(new std::string());
           serialized->reserve(
               io.contents().int_contents_size() * elem_byte_size);
-          serialized_data_map->emplace(io.name(), serialized);
+          SerializedDataMap(serialized_data_map)->emplace(io.name(), serialized);
           for (const auto& element : io.contents().int_contents()) {
             // Assuming the system is little-endian, picking the
             // least 2 significant bytes of 32-bit integer as a
@@ -2066,7 +2739,7 @@ InferGRPCToInput(
               io.name(), request.model_name(), "UINT8", io.datatype(),
               byte_size));
           std::shared_ptr<std::string> serialized(new std::string());
-          serialized_data_map->emplace(io.name(), serialized);
+          SerializedDataMap(serialized_data_map)->emplace(io.name(), serialized);
           serialized->reserve(
               io.contents().uint_contents_size() * elem_byte_size);
           for (const auto& element : io.contents().uint_contents()) {
@@ -2083,7 +2756,7 @@ InferGRPCToInput(
               io.name(), request.model_name(), "UINT16", io.datatype(),
               byte_size));
           std::shared_ptr<std::string> serialized(new std::string());
-          serialized_data_map->emplace(io.name(), serialized);
+          SerializedDataMap(serialized_data_map)->emplace(io.name(), serialized);
           serialized->reserve(
               io.contents().uint_contents_size() * elem_byte_size);
           for (const auto& element : io.contents().uint_contents()) {
@@ -2131,7 +2804,7 @@ InferGRPCToInput(
             io.name(), request.model_name(), "BYTES", io.datatype(),
             byte_size));
         std::shared_ptr<std::string> serialized(new std::string());
-        serialized_data_map->emplace(io.name(), serialized);
+        SerializedDataMap(serialized_data_map)->emplace(io.name(), serialized);
 
         // Serialize the output tensor strings. Each string is
         // serialized as a 4-byte length followed by the string itself
@@ -2265,6 +2938,72 @@ SetInferenceRequestMetadata(
   return nullptr;  // Success
 }
 
+// Finish filling 'response' for a completed inference request:
+// output shapes, datatypes and, for classification outputs that are
+// not in shared memory, the byte contents.
+TRITONSERVER_Error*
+InferResponseCompleteCommon(
+    TRITONSERVER_InferenceRequest* request, const AllocPayload& alloc_payload,
+    ModelInferResponse* response)
+{
+  TRITONSERVER_Error* err = TRITONSERVER_InferenceRequestError(request);
+  if (err != nullptr) {
+    return err;
+  }
+
+  for (auto& output : *(response->mutable_outputs())) {
+    const int64_t* shape;
+    uint64_t dim_count;
+    const char* datatype;
+    err = TRITONSERVER_InferenceRequestOutputShape(
+        request, output.name().c_str(), &shape, &dim_count);
+    if (err == nullptr) {
+      err = TRITONSERVER_InferenceRequestOutputDataType(
+          request, output.name().c_str(), &datatype);
+    }
+    if (err != nullptr) {
+      return err;
+    }
+
+    for (size_t idx = 0; idx < dim_count; idx++) {
+      output.add_shape(shape[idx]);
+    }
+    output.set_datatype(datatype);
+
+    // Check if the output is classification results (no
+    // raw_contents and not using explicit or automatically placed
+    // shared memory)
+    if ((output.contents().raw_contents().size() == 0) &&
+        (output.parameters().find("shared_memory_region") ==
+         output.parameters().end())) {
+      if ((alloc_payload.shm_map_ == nullptr) ||
+          (alloc_payload.shm_map_->find(output.name()) ==
+           alloc_payload.shm_map_->end())) {
+        size_t element_cnt = shape[0] * shape[1];
+        const char* base;
+        size_t byte_size;
+        TRITONSERVER_Memory_Type mem_type;
+        int64_t mem_id;
+        err = TRITONSERVER_InferenceRequestOutputData(
+            request, output.name().c_str(), (const void**)&base, &byte_size,
+            &mem_type, &mem_id);
+        if (err != nullptr) {
+          return err;
+        }
+        size_t offset = 0;
+        for (size_t idx = 0; idx < element_cnt; idx++) {
+          size_t length = *(reinterpret_cast<const uint32_t*>(base + offset));
+          offset += sizeof(uint32_t);
+          output.mutable_contents()->add_byte_contents(base + offset, length);
+          offset += length;
+        }
+      }
+    }
+  }
+
+  return nullptr;  // Success
+}
+
 //
 // ModelInferHandler
 //
@@ -2323,7 +3062,7 @@ ModelInferHandler::StartNewRequest()
 #endif  // TRTIS_ENABLE_TRACING
 
   service_->RequestModelInfer(
-      state->context_->ctx_.get(), &state->request_,
+      state->context_->ctx_.get(), state->request_,
       state->context_->responder_.get(), cq_, cq_, state);
 
   LOG_VERBOSE(1) << "New request handler for " << Name() << ", "
@@ -2351,8 +3090,8 @@ ModelInferHandler::Process(Handler::State* state, bool rpc_ok)
     finished = true;
   }
 
-  const ModelInferRequest& request = state->request_;
-  ModelInferResponse& response = state->response_;
+  const ModelInferRequest& request = *state->request_;
+  ModelInferResponse& response = *state->response_;
 
   if (state->step_ == Steps::START) {
     TRITONSERVER_Error* err = nullptr;
@@ -2392,18 +3131,18 @@ ModelInferHandler::Process(Handler::State* state, bool rpc_ok)
       err = SetInferenceRequestMetadata(irequest, request);
     }
 
-    // Will be used to hold the serialized data in case explicit string
-    // tensors are present in the request.
-    AllocPayload::TensorSerializedDataMap* serialized_data_map =
-        new AllocPayload::TensorSerializedDataMap();
+    // Holds serialized data in case some input tensor must be
+    // re-serialized; left unallocated when all inputs pass raw or
+    // shared-memory contents.
+    std::unique_ptr<AllocPayload::TensorSerializedDataMap> serialized_data_map;
 
     if (err == nullptr) {
       err = InferGRPCToInput(
-          tritonserver_, shm_manager_, request, serialized_data_map, irequest);
+          tritonserver_, shm_manager_, request, &serialized_data_map, irequest);
     }
     if (err == nullptr) {
       err = InferAllocatorPayload(
-          tritonserver_, shm_manager_, request, serialized_data_map, &response,
+          tritonserver_, shm_manager_, request, &serialized_data_map, &response,
           &state->alloc_payload_);
     }
     if (err == nullptr) {
@@ -2482,57 +3221,10 @@ ModelInferHandler::InferComplete(
   LOG_VERBOSE(1) << "ModelInferHandler::InferComplete, " << state->unique_id_
                  << " step " << state->step_;
 
-  ModelInferResponse& response = state->response_;
+  ModelInferResponse& response = *state->response_;
 
-  TRITONSERVER_Error* err = TRITONSERVER_InferenceRequestError(request);
-  if (err == nullptr) {
-    for (auto& output : *(response.mutable_outputs())) {
-      const int64_t* shape;
-      uint64_t dim_count;
-      const char* datatype;
-      err = TRITONSERVER_InferenceRequestOutputShape(
-          request, output.name().c_str(), &shape, &dim_count);
-      if (err == nullptr) {
-        err = TRITONSERVER_InferenceRequestOutputDataType(
-            request, output.name().c_str(), &datatype);
-      }
-      if (err != nullptr) {
-        break;
-      }
-
-      for (size_t idx = 0; idx < dim_count; idx++) {
-        output.add_shape(shape[idx]);
-      }
-      output.set_datatype(datatype);
-
-      // Check if the output is classification results
-      // (no raw_contents and not using shared memory)
-      if (output.contents().raw_contents().size() == 0) {
-        if ((state->alloc_payload_.shm_map_ == nullptr) ||
-            (state->alloc_payload_.shm_map_->find(output.name()) ==
-             state->alloc_payload_.shm_map_->end())) {
-          size_t element_cnt = shape[0] * shape[1];
-          const char* base;
-          size_t byte_size;
-          TRITONSERVER_Memory_Type mem_type;
-          int64_t mem_id;
-          err = TRITONSERVER_InferenceRequestOutputData(
-              request, output.name().c_str(), (const void**)&base, &byte_size,
-              &mem_type, &mem_id);
-          if (err != nullptr) {
-            break;
-          }
-          size_t offset = 0;
-          for (size_t idx = 0; idx < element_cnt; idx++) {
-            size_t length = *(reinterpret_cast<const uint32_t*>(base + offset));
-            offset += sizeof(uint32_t);
-            output.mutable_contents()->add_byte_contents(base + offset, length);
-            offset += length;
-          }
-        }
-      }
-    }
-  }
+  TRITONSERVER_Error* err =
+      InferResponseCompleteCommon(request, state->alloc_payload_, &response);
 
   // Make sure response doesn't exceed GRPC limits.
   if ((err == nullptr) && (response.ByteSizeLong() > INT_MAX)) {
@@ -2571,6 +3263,269 @@ ModelInferHandler::InferComplete(
   state->context_->responder_->Finish(response, status, state);
 }
 
+//
+// ModelBatchInferHandler
+//
+class ModelBatchInferHandler
+    : public Handler<
+          GRPCInferenceService::AsyncService,
+          grpc::ServerAsyncResponseWriter<ModelBatchInferResponse>,
+          ModelBatchInferRequest, ModelBatchInferResponse> {
+ public:
+  ModelBatchInferHandler(
+      const std::string& name,
+      const std::shared_ptr<TRITONSERVER_Server>& tritonserver,
+      const std::shared_ptr<SharedMemoryManager>& shm_manager,
+      GRPCInferenceService::AsyncService* service,
+      grpc::ServerCompletionQueue* cq, size_t max_state_bucket_count)
+      : Handler(name, tritonserver, service, cq, max_state_bucket_count),
+        shm_manager_(shm_manager)
+  {
+    // Create the allocator that will be used to allocate buffers for
+    // the result tensors.
+    FAIL_IF_TRITON_ERR(
+        TRITONSERVER_ResponseAllocatorNew(
+            &allocator_, InferResponseAlloc, InferResponseRelease),
+        "creating batch inference response allocator");
+  }
+
+ protected:
+  void StartNewRequest() override;
+  bool Process(State* state, bool rpc_ok) override;
+
+ private:
+  struct BatchData;
+
+  // One logical inference request within a batched RPC.
+  struct SubRequest {
+    SubRequest(BatchData* batch, size_t idx) : batch_(batch), idx_(idx) {}
+    BatchData* batch_;
+    const size_t idx_;
+    AllocPayload alloc_payload_;
+  };
+
+  // Bookkeeping shared by the sub-requests of one batched RPC. The
+  // last sub-request to complete finishes the RPC and deletes this.
+  struct BatchData {
+    State* state_;
+    std::atomic<size_t> remaining_;
+    std::vector<std::unique_ptr<SubRequest>> sub_requests_;
+  };
+
+  static void SubRequestComplete(
+      TRITONSERVER_Server* server, TRITONSERVER_TraceManager* trace_manager,
+      TRITONSERVER_InferenceRequest* request, void* userp);
+  static void SubRequestDone(BatchData* batch);
+
+  std::shared_ptr<SharedMemoryManager> shm_manager_;
+  TRITONSERVER_ResponseAllocator* allocator_;
+};
+
+void
+ModelBatchInferHandler::StartNewRequest()
+{
+  auto context = std::make_shared<State::Context>();
+  State* state = StateNew(context);
+
+  service_->RequestModelBatchInfer(
+      state->context_->ctx_.get(), state->request_,
+      state->context_->responder_.get(), cq_, cq_, state);
+
+  LOG_VERBOSE(1) << "New request handler for " << Name() << ", "
+                 << state->unique_id_;
+}
+
+bool
+ModelBatchInferHandler::Process(Handler::State* state, bool rpc_ok)
+{
+  LOG_VERBOSE(1) << "Process for " << Name() << ", rpc_ok=" << rpc_ok << ", "
+                 << state->unique_id_ << " step " << state->step_;
+
+  // We need an explicit finish indicator. Can't use 'state->step_'
+  // because the completion callbacks could update 'state's step_ to
+  // be FINISH before this thread exits this function.
+  bool finished = false;
+
+  // If RPC failed on a new request then the server is shutting down
+  // and so we should do nothing (including not registering for a new
+  // request). If RPC failed on a non-START step then there is nothing
+  // we can do since we one execute one step.
+  const bool shutdown = (!rpc_ok && (state->step_ == Steps::START));
+  if (shutdown) {
+    state->step_ = Steps::FINISH;
+    finished = true;
+  }
+
+  const ModelBatchInferRequest& request = *state->request_;
+  ModelBatchInferResponse& response = *state->response_;
+
+  if (state->step_ == Steps::START) {
+    // Start a new request to replace this one...
+    if (!shutdown) {
+      StartNewRequest();
+    }
+
+    if (request.requests().size() == 0) {
+      TRITONSERVER_Error* err = TRITONSERVER_ErrorNew(
+          TRITONSERVER_ERROR_INVALID_ARG,
+          "batch inference request must contain at least one request");
+      grpc::Status status;
+      GrpcStatusUtil::Create(&status, err);
+      TRITONSERVER_ErrorDelete(err);
+
+      state->step_ = COMPLETE;
+      state->context_->responder_->Finish(response, status, state);
+      return !finished;
+    }
+
+    // Pre-size the result slots before issuing any sub-request so
+    // that the completion callbacks, which may run concurrently on
+    // other threads, never grow the repeated field.
+    for (int i = 0; i < request.requests().size(); ++i) {
+      response.add_responses();
+    }
+
+    BatchData* batch = new BatchData;
+    batch->state_ = state;
+    batch->remaining_ = request.requests().size();
+
+    state->step_ = ISSUED;
+
+    // Each entry is issued as an individual inference request so the
+    // dynamic batcher is free to merge entries, from this RPC or
+    // others, into one execution. A failure to issue an entry is
+    // reported in its result slot and doesn't fail the other entries.
+    for (int i = 0; i < request.requests().size(); ++i) {
+      const ModelInferRequest& infer_request = request.requests(i);
+      ModelStreamInferResponse* result = response.mutable_responses(i);
+
+      batch->sub_requests_.emplace_back(new SubRequest(batch, i));
+      SubRequest* sub = batch->sub_requests_.back().get();
+
+      TRITONSERVER_InferenceRequest* irequest = nullptr;
+      TRITONSERVER_Error* err = TRITONSERVER_InferenceRequestNew(
+          &irequest, tritonserver_.get(), infer_request.model_name().c_str(),
+          infer_request.model_version().c_str());
+
+      if (err == nullptr) {
+        err = SetInferenceRequestMetadata(irequest, infer_request);
+      }
+
+      // Holds serialized data in case some input tensor must be
+      // re-serialized; left unallocated when all inputs pass raw or
+      // shared-memory contents.
+      std::unique_ptr<AllocPayload::TensorSerializedDataMap>
+          serialized_data_map;
+
+      if (err == nullptr) {
+        err = InferGRPCToInput(
+            tritonserver_, shm_manager_, infer_request, &serialized_data_map,
+            irequest);
+      }
+      if (err == nullptr) {
+        err = InferAllocatorPayload(
+            tritonserver_, shm_manager_, infer_request, &serialized_data_map,
+            result->mutable_infer_response(), &sub->alloc_payload_);
+      }
+      if (err == nullptr) {
+        // Set fields that are known in advance.
+        result->mutable_infer_response()->set_id(infer_request.id());
+        result->mutable_infer_response()->set_model_name(
+            infer_request.model_name());
+        result->mutable_infer_response()->set_model_version(
+            infer_request.model_version());
+
+        err = TRITONSERVER_ServerInferAsync(
+            tritonserver_.get(), nullptr /* trace_manager */, irequest,
+            allocator_, &sub->alloc_payload_ /* response_allocator_userp */,
+            SubRequestComplete, reinterpret_cast<void*>(sub));
+      }
+
+      if (err != nullptr) {
+        LOG_VERBOSE(1) << "Batch infer failed: "
+                       << TRITONSERVER_ErrorMessage(err);
+
+        LOG_TRITONSERVER_ERROR(
+            TRITONSERVER_InferenceRequestDelete(irequest),
+            "deleting GRPC batch inference request");
+
+        result->mutable_infer_response()->Clear();
+        result->set_error_message(TRITONSERVER_ErrorMessage(err));
+        TRITONSERVER_ErrorDelete(err);
+
+        SubRequestDone(batch);
+      }
+    }
+  } else if (state->step_ == Steps::COMPLETE) {
+    state->step_ = Steps::FINISH;
+    finished = true;
+  }
+
+  return !finished;
+}
+
+void
+ModelBatchInferHandler::SubRequestComplete(
+    TRITONSERVER_Server* server, TRITONSERVER_TraceManager* trace_manager,
+    TRITONSERVER_InferenceRequest* request, void* userp)
+{
+  SubRequest* sub = reinterpret_cast<SubRequest*>(userp);
+  ModelStreamInferResponse* result =
+      sub->batch_->state_->response_->mutable_responses(sub->idx_);
+
+  TRITONSERVER_Error* err = InferResponseCompleteCommon(
+      request, sub->alloc_payload_, result->mutable_infer_response());
+  if (err != nullptr) {
+    result->mutable_infer_response()->Clear();
+    result->set_error_message(TRITONSERVER_ErrorMessage(err));
+    TRITONSERVER_ErrorDelete(err);
+  }
+
+  LOG_TRITONSERVER_ERROR(
+      TRITONSERVER_InferenceRequestDelete(request),
+      "deleting GRPC batch inference request");
+
+  SubRequestDone(sub->batch_);
+}
+
+void
+ModelBatchInferHandler::SubRequestDone(BatchData* batch)
+{
+  if (batch->remaining_.fetch_sub(1) != 1) {
+    return;
+  }
+
+  // All sub-requests have completed... finish the RPC.
+  State* state = batch->state_;
+  ModelBatchInferResponse& response = *state->response_;
+
+  // Make sure response doesn't exceed GRPC limits.
+  TRITONSERVER_Error* err = nullptr;
+  if (response.ByteSizeLong() > INT_MAX) {
+    err = TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_INVALID_ARG,
+        std::string(
+            "Response has byte size " +
+            std::to_string(response.ByteSizeLong()) +
+            " which exceeds gRPC's byte size limit " + std::to_string(INT_MAX) +
+            ".")
+            .c_str());
+  }
+
+  if (err != nullptr) {
+    response.Clear();
+  }
+
+  grpc::Status status;
+  GrpcStatusUtil::Create(&status, err);
+  TRITONSERVER_ErrorDelete(err);
+
+  state->step_ = COMPLETE;
+  state->context_->responder_->Finish(response, status, state);
+
+  delete batch;
+}
+
 //
 // ModelStreamInferHandler
 //
@@ -2665,11 +3620,11 @@ ModelStreamInferHandler::Process(Handler::State* state, bool rpc_ok)
     // used yet so use it to read a request off the connection.
     state->context_->step_ = Steps::READ;
     state->step_ = Steps::READ;
-    state->context_->responder_->Read(&state->request_, state);
+    state->context_->responder_->Read(state->request_, state);
 
   } else if (state->step_ == Steps::READ) {
     TRITONSERVER_Error* err = nullptr;
-    const ModelInferRequest& request = state->request_;
+    const ModelInferRequest& request = *state->request_;
 #ifdef TRTIS_ENABLE_TRACING
     if (state->trace_meta_data_ != nullptr) {
       if (err == nullptr) {
@@ -2677,13 +3632,13 @@ ModelStreamInferHandler::Process(Handler::State* state, bool rpc_ok)
         err = GetModelVersionFromString(
             request.model_version(), &requested_model_version);
         state->trace_meta_data_->tracer_->SetModel(
-            state->request_.model_name(), requested_model_version);
+            state->request_->model_name(), requested_model_version);
       } else {
         // If failed to retrieve the requested_model_version
         // then use the default model version just to record
         // the timestamps in the tracer
         state->trace_meta_data_->tracer_->SetModel(
-            state->request_.model_name(), -1);
+            state->request_->model_name(), -1);
       }
       state->trace_meta_data_->tracer_->CaptureTimestamp(
           TRITONSERVER_TRACE_LEVEL_MIN, "grpc wait/read end");
@@ -2709,9 +3664,25 @@ ModelStreamInferHandler::Process(Handler::State* state, bool rpc_ok)
       return !finished;
     }
 
+    // A request may opt the stream into unordered response delivery
+    // so that each response is written as soon as its inference
+    // completes instead of in request order. Responses carry the
+    // request id so the client can correlate them.
+    if (!request.parameters().empty()) {
+      const auto& param_it =
+          request.parameters().find("unordered_stream_response");
+      if ((param_it != request.parameters().end()) &&
+          (param_it->second.parameter_choice_case() ==
+           InferParameter::ParameterChoiceCase::kBoolParam) &&
+          param_it->second.bool_param()) {
+        state->context_->SetUnorderedResponse();
+      }
+    }
+
     // Request has been successfully read so put it in the context
     // queue so that it's response is sent in the same order as the
-    // request was received.
+    // request was received (or, on an unordered stream, as soon as
+    // it is ready).
     state->context_->EnqueueForResponse(state);
 
     // Need to get context here as it is needed below. 'state' can
@@ -2721,7 +3692,7 @@ ModelStreamInferHandler::Process(Handler::State* state, bool rpc_ok)
     std::shared_ptr<StateContext> context = state->context_;
 
     // Issue the inference request into server...
-    ModelStreamInferResponse& response = state->response_;
+    ModelStreamInferResponse& response = *state->response_;
 
     // Create the inference request which contains all the
     // input information needed for an inference.
@@ -2736,18 +3707,18 @@ ModelStreamInferHandler::Process(Handler::State* state, bool rpc_ok)
       err = SetInferenceRequestMetadata(irequest, request);
     }
 
-    // Will be used to hold the serialized data in case explicit string
-    // tensors are present in the request.
-    AllocPayload::TensorSerializedDataMap* serialized_data_map =
-        new AllocPayload::TensorSerializedDataMap();
+    // Holds serialized data in case some input tensor must be
+    // re-serialized; left unallocated when all inputs pass raw or
+    // shared-memory contents.
+    std::unique_ptr<AllocPayload::TensorSerializedDataMap> serialized_data_map;
 
     if (err == nullptr) {
       err = InferGRPCToInput(
-          tritonserver_, shm_manager_, request, serialized_data_map, irequest);
+          tritonserver_, shm_manager_, request, &serialized_data_map, irequest);
     }
     if (err == nullptr) {
       err = InferAllocatorPayload(
-          tritonserver_, shm_manager_, request, serialized_data_map,
+          tritonserver_, shm_manager_, request, &serialized_data_map,
           response.mutable_infer_response(), &state->alloc_payload_);
     }
     if (err == nullptr) {
@@ -2816,7 +3787,7 @@ ModelStreamInferHandler::Process(Handler::State* state, bool rpc_ok)
 #endif  // TRTIS_ENABLE_TRACING
 
     next_read_state->context_->responder_->Read(
-        &next_read_state->request_, next_read_state);
+        next_read_state->request_, next_read_state);
 
   } else if (state->step_ == Steps::WRITTEN) {
 #ifdef TRTIS_ENABLE_TRACING
@@ -2885,7 +3856,7 @@ ModelStreamInferHandler::StreamInferComplete(
                  << state->context_->unique_id_ << ", " << state->unique_id_
                  << " step " << state->step_;
 
-  ModelStreamInferResponse& response = state->response_;
+  ModelStreamInferResponse& response = *state->response_;
 
   TRITONSERVER_Error* err = TRITONSERVER_InferenceRequestError(request);
   if (err == nullptr) {
@@ -2981,10 +3952,16 @@ GRPCServerV2::GRPCServerV2(
     const std::shared_ptr<TRITONSERVER_Server>& server,
     const std::shared_ptr<nvidia::inferenceserver::TraceManager>& trace_manager,
     const std::shared_ptr<SharedMemoryManager>& shm_manager,
-    const std::string& server_addr, const int infer_allocation_pool_size)
+    const std::string& server_addr, const std::string& server_uds_addr,
+    const int infer_thread_cnt, const int stream_infer_thread_cnt,
+    const int infer_allocation_pool_size,
+    const grpc_compression_level infer_compression_level)
     : server_(server), trace_manager_(trace_manager), shm_manager_(shm_manager),
-      server_addr_(server_addr),
-      infer_allocation_pool_size_(infer_allocation_pool_size), running_(false)
+      server_addr_(server_addr), server_uds_addr_(server_uds_addr),
+      infer_thread_cnt_(infer_thread_cnt),
+      stream_infer_thread_cnt_(stream_infer_thread_cnt),
+      infer_allocation_pool_size_(infer_allocation_pool_size),
+      infer_compression_level_(infer_compression_level), running_(false)
 {
 }
 
@@ -2998,11 +3975,17 @@ GRPCServerV2::Create(
     const std::shared_ptr<TRITONSERVER_Server>& server,
     const std::shared_ptr<nvidia::inferenceserver::TraceManager>& trace_manager,
     const std::shared_ptr<SharedMemoryManager>& shm_manager, int32_t port,
-    int infer_allocation_pool_size, std::unique_ptr<GRPCServerV2>* grpc_server)
+    const std::string& uds_path, int infer_thread_cnt,
+    int stream_infer_thread_cnt, int infer_allocation_pool_size,
+    grpc_compression_level infer_compression_level,
+    std::unique_ptr<GRPCServerV2>* grpc_server)
 {
   const std::string addr = "0.0.0.0:" + std::to_string(port);
+  const std::string uds_addr = uds_path.empty() ? "" : ("unix:" + uds_path);
   grpc_server->reset(new GRPCServerV2(
-      server, trace_manager, shm_manager, addr, infer_allocation_pool_size));
+      server, trace_manager, shm_manager, addr, uds_addr,
+      std::max(1, infer_thread_cnt), std::max(1, stream_infer_thread_cnt),
+      infer_allocation_pool_size, infer_compression_level));
 
   return nullptr;  // success
 }
@@ -3017,7 +4000,19 @@ GRPCServerV2::Start()
 
   grpc_builder_.AddListeningPort(
       server_addr_, grpc::InsecureServerCredentials());
+  if (!server_uds_addr_.empty()) {
+    // Also listen on a unix domain socket for clients co-located on
+    // the same host, avoiding the TCP loopback overhead.
+    grpc_builder_.AddListeningPort(
+        server_uds_addr_, grpc::InsecureServerCredentials());
+  }
   grpc_builder_.SetMaxMessageSize(MAX_GRPC_MESSAGE_SIZE);
+
+  // Responses are compressed at this level when the client indicates
+  // that it accepts compression. Requests compressed by the client
+  // are decompressed by gRPC before reaching the handlers.
+  grpc_builder_.SetDefaultCompressionLevel(infer_compression_level_);
+
   grpc_builder_.RegisterService(&service_);
   server_live_cq_ = grpc_builder_.AddCompletionQueue();
   server_ready_cq_ = grpc_builder_.AddCompletionQueue();
@@ -3025,9 +4020,14 @@ GRPCServerV2::Start()
   server_metadata_cq_ = grpc_builder_.AddCompletionQueue();
   model_metadata_cq_ = grpc_builder_.AddCompletionQueue();
   model_config_cq_ = grpc_builder_.AddCompletionQueue();
-  model_infer_cq_ = grpc_builder_.AddCompletionQueue();
   common_cq_ = grpc_builder_.AddCompletionQueue();
-  model_stream_infer_cq_ = grpc_builder_.AddCompletionQueue();
+  for (int i = 0; i < infer_thread_cnt_; ++i) {
+    model_infer_cqs_.emplace_back(grpc_builder_.AddCompletionQueue());
+  }
+  for (int i = 0; i < stream_infer_thread_cnt_; ++i) {
+    model_stream_infer_cqs_.emplace_back(grpc_builder_.AddCompletionQueue());
+  }
+  model_batch_infer_cq_ = grpc_builder_.AddCompletionQueue();
   grpc_server_ = grpc_builder_.BuildAndStart();
 
   // Handler for server-live requests.
@@ -3072,21 +4072,35 @@ GRPCServerV2::Start()
   hmodelconfig->Start();
   model_config_handler_.reset(hmodelconfig);
 
-  // Handler for model inference requests.
-  ModelInferHandler* hmodelinfer = new ModelInferHandler(
-      "ModelInferHandler", server_, trace_manager_, shm_manager_, &service_,
-      model_infer_cq_.get(),
-      infer_allocation_pool_size_ /* max_state_bucket_count */);
-  hmodelinfer->Start();
-  model_infer_handler_.reset(hmodelinfer);
+  // Handlers for model inference requests. One handler instance per
+  // completion queue, each polled by its own thread and keeping its
+  // own state bucket, so inference ingestion scales across cores.
+  for (int i = 0; i < infer_thread_cnt_; ++i) {
+    ModelInferHandler* hmodelinfer = new ModelInferHandler(
+        "ModelInferHandler" + std::to_string(i), server_, trace_manager_,
+        shm_manager_, &service_, model_infer_cqs_[i].get(),
+        infer_allocation_pool_size_ /* max_state_bucket_count */);
+    hmodelinfer->Start();
+    model_infer_handlers_.emplace_back(hmodelinfer);
+  }
+
+  // Handlers for streaming inference requests.
+  for (int i = 0; i < stream_infer_thread_cnt_; ++i) {
+    ModelStreamInferHandler* hmodelstreaminfer = new ModelStreamInferHandler(
+        "ModelStreamInferHandler" + std::to_string(i), server_, trace_manager_,
+        shm_manager_, &service_, model_stream_infer_cqs_[i].get(),
+        infer_allocation_pool_size_ /* max_state_bucket_count */);
+    hmodelstreaminfer->Start();
+    model_stream_infer_handlers_.emplace_back(hmodelstreaminfer);
+  }
 
-  // Handler for streaming inference requests.
-  ModelStreamInferHandler* hmodelstreaminfer = new ModelStreamInferHandler(
-      "ModelStreamInferHandler", server_, trace_manager_, shm_manager_,
-      &service_, model_stream_infer_cq_.get(),
+  // Handler for batched inference requests.
+  ModelBatchInferHandler* hmodelbatchinfer = new ModelBatchInferHandler(
+      "ModelBatchInferHandler", server_, shm_manager_, &service_,
+      model_batch_infer_cq_.get(),
       infer_allocation_pool_size_ /* max_state_bucket_count */);
-  hmodelstreaminfer->Start();
-  model_stream_infer_handler_.reset(hmodelstreaminfer);
+  hmodelbatchinfer->Start();
+  model_batch_infer_handler_.reset(hmodelbatchinfer);
 
   // A common Handler for other non-critical requests
   CommonHandler* hcommon = new CommonHandler(
@@ -3116,9 +4130,14 @@ GRPCServerV2::Stop()
   server_metadata_cq_->Shutdown();
   model_metadata_cq_->Shutdown();
   model_config_cq_->Shutdown();
-  model_infer_cq_->Shutdown();
   common_cq_->Shutdown();
-  model_stream_infer_cq_->Shutdown();
+  for (const auto& cq : model_infer_cqs_) {
+    cq->Shutdown();
+  }
+  for (const auto& cq : model_stream_infer_cqs_) {
+    cq->Shutdown();
+  }
+  model_batch_infer_cq_->Shutdown();
 
   // Must stop all handlers explicitly to wait for all the handler
   // threads to join since they are referencing completion queue, etc.
@@ -3128,9 +4147,14 @@ GRPCServerV2::Stop()
   dynamic_cast<ServerMetadataHandler*>(server_metadata_handler_.get())->Stop();
   dynamic_cast<ModelMetadataHandler*>(model_metadata_handler_.get())->Stop();
   dynamic_cast<ModelConfigHandler*>(model_config_handler_.get())->Stop();
-  dynamic_cast<ModelInferHandler*>(model_infer_handler_.get())->Stop();
   dynamic_cast<CommonHandler*>(common_handler_.get())->Stop();
-  dynamic_cast<ModelStreamInferHandler*>(model_stream_infer_handler_.get())
+  for (const auto& handler : model_infer_handlers_) {
+    dynamic_cast<ModelInferHandler*>(handler.get())->Stop();
+  }
+  for (const auto& handler : model_stream_infer_handlers_) {
+    dynamic_cast<ModelStreamInferHandler*>(handler.get())->Stop();
+  }
+  dynamic_cast<ModelBatchInferHandler*>(model_batch_infer_handler_.get())
       ->Stop();
 
   running_ = false;
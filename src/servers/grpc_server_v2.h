@@ -40,7 +40,10 @@ class GRPCServerV2 {
       const std::shared_ptr<nvidia::inferenceserver::TraceManager>&
           trace_manager,
       const std::shared_ptr<SharedMemoryManager>& shm_manager, int32_t port,
+      const std::string& uds_path, int infer_thread_cnt,
+      int stream_infer_thread_cnt,
       int infer_allocation_pool_size,
+      grpc_compression_level infer_compression_level,
       std::unique_ptr<GRPCServerV2>* grpc_server);
 
   ~GRPCServerV2();
@@ -68,25 +71,46 @@ class GRPCServerV2 {
       const std::shared_ptr<nvidia::inferenceserver::TraceManager>&
           trace_manager,
       const std::shared_ptr<SharedMemoryManager>& shm_manager,
-      const std::string& server_addr, const int infer_allocation_pool_size);
+      const std::string& server_addr, const std::string& server_uds_addr,
+      const int infer_thread_cnt, const int stream_infer_thread_cnt,
+      const int infer_allocation_pool_size,
+      const grpc_compression_level infer_compression_level);
 
   std::shared_ptr<TRITONSERVER_Server> server_;
   std::shared_ptr<TraceManager> trace_manager_;
   std::shared_ptr<SharedMemoryManager> shm_manager_;
   const std::string server_addr_;
 
+  // If not empty, a unix domain socket address the server also
+  // listens on, for clients co-located on the same host.
+  const std::string server_uds_addr_;
+
+  const int infer_thread_cnt_;
+  const int stream_infer_thread_cnt_;
   const int infer_allocation_pool_size_;
 
+  // The compression level used for responses when the client
+  // indicates that it accepts compression.
+  const grpc_compression_level infer_compression_level_;
+
   std::unique_ptr<grpc::ServerCompletionQueue> server_live_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> server_ready_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> model_ready_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> server_metadata_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> model_metadata_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> model_config_cq_;
-  std::unique_ptr<grpc::ServerCompletionQueue> model_infer_cq_;
-  std::unique_ptr<grpc::ServerCompletionQueue> model_stream_infer_cq_;
   std::unique_ptr<grpc::ServerCompletionQueue> common_cq_;
 
+  // The inference services use one completion queue per poller
+  // thread, each with its own handler instance, so ingestion scales
+  // across cores.
+  std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> model_infer_cqs_;
+  std::vector<std::unique_ptr<grpc::ServerCompletionQueue>>
+      model_stream_infer_cqs_;
+
+  // Completion queue for the batched inference service.
+  std::unique_ptr<grpc::ServerCompletionQueue> model_batch_infer_cq_;
+
   grpc::ServerBuilder grpc_builder_;
   std::unique_ptr<grpc::Server> grpc_server_;
 
@@ -96,10 +120,15 @@ class GRPCServerV2 {
   std::unique_ptr<HandlerBase> server_metadata_handler_;
   std::unique_ptr<HandlerBase> model_metadata_handler_;
   std::unique_ptr<HandlerBase> model_config_handler_;
-  std::unique_ptr<HandlerBase> model_infer_handler_;
-  std::unique_ptr<HandlerBase> model_stream_infer_handler_;
   std::unique_ptr<HandlerBase> common_handler_;
 
+  // One handler per completion queue, indexed like 'model_infer_cqs_'
+  // and 'model_stream_infer_cqs_'. Each handler keeps its own state
+  // bucket so state reuse never crosses pollers.
+  std::vector<std::unique_ptr<HandlerBase>> model_infer_handlers_;
+  std::vector<std::unique_ptr<HandlerBase>> model_stream_infer_handlers_;
+  std::unique_ptr<HandlerBase> model_batch_infer_handler_;
+
   GRPCInferenceService::AsyncService service_;
   bool running_;
 };
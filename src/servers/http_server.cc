@@ -32,6 +32,7 @@
 #include <google/protobuf/util/json_util.h>
 #include <re2/re2.h>
 #include <algorithm>
+#include <mutex>
 #include <thread>
 #include "src/core/api.pb.h"
 #include "src/core/constants.h"
@@ -253,6 +254,8 @@ class HTTPAPIServer : public HTTPServerImpl {
           evbuffer_free(buffer);
         }
       }
+
+      TRTSERVER_InferenceRequestProviderDelete(request_provider_);
     }
 
     evhtp_request_t* EvHtpRequest() const { return req_; }
@@ -260,6 +263,12 @@ class HTTPAPIServer : public HTTPServerImpl {
     static void InferComplete(
         TRTSERVER_Server* server, TRTSERVER_TraceManager* trace_manager,
         TRTSERVER_InferenceResponse* response, void* userp);
+
+    // Cancel the inference request when the client connection fails
+    // before the response has been sent.
+    static void RequestErrorCallback(
+        evhtp_request_t* req, evhtp_error_flags errtype, void* arg);
+
     evhtp_res FinalizeResponse(TRTSERVER_InferenceResponse* response);
 
 #ifdef TRTIS_ENABLE_TRACING
@@ -268,6 +277,11 @@ class HTTPAPIServer : public HTTPServerImpl {
 
     ResponseMetaData response_meta_data_;
 
+    // The request provider for the in-flight inference. Ownership is
+    // transferred here once the inference is started so that the
+    // request can be cancelled on client disconnect.
+    TRTSERVER_InferenceRequestProvider* request_provider_;
+
    private:
     evhtp_request_t* req_;
     evthr_t* thread_;
@@ -333,6 +347,15 @@ class HTTPAPIServer : public HTTPServerImpl {
   re2::RE2 modelcontrol_regex_;
   re2::RE2 sharedmemorycontrol_regex_;
   re2::RE2 repository_regex_;
+
+  // Parsed inference request headers, keyed by model name and the
+  // client-provided digest, so that clients sending identical headers
+  // can skip the text-format parse after the first request. The 'id'
+  // field is cleared in the cached templates since it varies per
+  // request.
+  static constexpr size_t kHeaderCacheMaxEntries = 1024;
+  std::mutex header_cache_mu_;
+  std::unordered_map<std::string, InferRequestHeader> header_cache_;
 };
 
 TRTSERVER_Error*
@@ -1128,7 +1151,7 @@ HTTPAPIServer::HandleInfer(evhtp_request_t* req, const std::string& infer_uri)
   // this is the first place where we have a tracer.
   std::unique_ptr<TraceMetaData> trace_meta_data;
   if (trace_manager_ != nullptr) {
-    trace_meta_data.reset(trace_manager_->SampleTrace());
+    trace_meta_data.reset(trace_manager_->SampleTrace(model_name));
     if (trace_meta_data != nullptr) {
       trace_meta_data->tracer_->SetModel(model_name, model_version);
       trace_meta_data->tracer_->CaptureTimestamp(
@@ -1141,26 +1164,69 @@ HTTPAPIServer::HandleInfer(evhtp_request_t* req, const std::string& infer_uri)
   }
 #endif  // TRTIS_ENABLE_TRACING
 
-  std::string infer_request_header_str;
   const char* infer_request_header =
       evhtp_kv_find(req->headers_in, kInferRequestHTTPHeader);
+  const char* header_digest =
+      evhtp_kv_find(req->headers_in, kInferRequestDigestHTTPHeader);
+
+  InferRequestHeader request_header_protobuf;
   if (infer_request_header != NULL) {
-    infer_request_header_str = std::string(infer_request_header);
+    if (!google::protobuf::TextFormat::ParseFromString(
+            std::string(infer_request_header), &request_header_protobuf)) {
+      evhtp_send_reply(req, EVHTP_RES_BADREQ);
+      return;
+    }
+
+    // If the client also sent a digest, remember the parsed header
+    // so that its subsequent requests can send just the digest and
+    // skip the text-format parse. The 'id' field varies per request
+    // so it is not part of the cached template.
+    if (header_digest != NULL) {
+      InferRequestHeader template_header = request_header_protobuf;
+      template_header.clear_id();
+      std::lock_guard<std::mutex> lock(header_cache_mu_);
+      while (header_cache_.size() >= kHeaderCacheMaxEntries) {
+        header_cache_.erase(header_cache_.begin());
+      }
+      header_cache_[model_name + "/" + header_digest] =
+          std::move(template_header);
+    }
+  } else if (header_digest != NULL) {
+    bool found = false;
+    {
+      std::lock_guard<std::mutex> lock(header_cache_mu_);
+      const auto itr = header_cache_.find(model_name + "/" + header_digest);
+      if (itr != header_cache_.end()) {
+        request_header_protobuf = itr->second;
+        found = true;
+      }
+    }
+    if (!found) {
+      std::string error_msg =
+          "unknown '" + std::string(kInferRequestDigestHTTPHeader) +
+          "' digest, resend the request with the full '" +
+          std::string(kInferRequestHTTPHeader) + "' header";
+      evbuffer_add(req->buffer_out, error_msg.c_str(), error_msg.size());
+      evhtp_send_reply(req, EVHTP_RES_BADREQ);
+      return;
+    }
+
+    // The per-request id travels in its own header since it is not
+    // part of the cached template.
+    const char* id_c_str =
+        evhtp_kv_find(req->headers_in, kInferRequestIdHTTPHeader);
+    if (id_c_str != NULL) {
+      request_header_protobuf.set_id(atoll(id_c_str));
+    }
   } else {
     std::string error_msg = "The request header should contain '" +
-                            std::string(kInferRequestHTTPHeader) + "'";
+                            std::string(kInferRequestHTTPHeader) + "' or '" +
+                            std::string(kInferRequestDigestHTTPHeader) + "'";
     evbuffer_add(req->buffer_out, error_msg.c_str(), error_msg.size());
     evhtp_send_reply(req, EVHTP_RES_BADREQ);
     return;
   }
 
-  InferRequestHeader request_header_protobuf;
-  if (!google::protobuf::TextFormat::ParseFromString(
-          infer_request_header_str, &request_header_protobuf)) {
-    evhtp_send_reply(req, EVHTP_RES_BADREQ);
-    return;
-  }
-
   uint64_t unique_id = RequestStatusUtil::NextUniqueRequestId();
 
   // Create the inference request provider which provides all the
@@ -1172,6 +1238,17 @@ HTTPAPIServer::HandleInfer(evhtp_request_t* req, const std::string& infer_uri)
     err = SetTRTSERVER_InferenceRequestOptions(
         request_options, request_header_protobuf);
   }
+  if (err == nullptr) {
+    // An optional header carries the request deadline as microseconds
+    // from now, for clients that can't express a transport deadline
+    // the way gRPC does.
+    const char* deadline_c_str =
+        evhtp_kv_find(req->headers_in, kInferRequestDeadlineHTTPHeader);
+    if (deadline_c_str != nullptr) {
+      err = TRTSERVER_InferenceRequestOptionsSetDeadlineMicroseconds(
+          request_options, atoll(deadline_c_str));
+    }
+  }
   TRTSERVER_InferenceRequestProvider* request_provider = nullptr;
   if (err == nullptr) {
     err = TRTSERVER_InferenceRequestProviderNewV2(
@@ -1203,13 +1280,23 @@ HTTPAPIServer::HandleInfer(evhtp_request_t* req, const std::string& infer_uri)
           InferRequest::InferComplete,
           reinterpret_cast<void*>(infer_request.get()));
       if (err == nullptr) {
+        // Retain ownership of the request provider so that the
+        // request can be cancelled if the client closes the
+        // connection while the inference is in flight.
+        infer_request->request_provider_ = request_provider;
+        request_provider = nullptr;
+        evhtp_set_hook(
+            &req->hooks, evhtp_hook_on_error,
+            (evhtp_hook)InferRequest::RequestErrorCallback,
+            infer_request.get());
         infer_request.release();
       }
     }
   }
 
-  // The request provider can be deleted before ServerInferAsync
-  // callback completes.
+  // The request provider is deleted here only if the inference was
+  // not started, otherwise ownership was transferred to the
+  // InferRequest above.
   TRTSERVER_InferenceRequestProviderDelete(request_provider);
   TRTSERVER_InferenceRequestOptionsDelete(request_options);
 
@@ -1250,6 +1337,7 @@ HTTPAPIServer::OKReplyCallback(evthr_t* thr, void* arg, void* shared)
       reinterpret_cast<HTTPAPIServer::InferRequest*>(arg);
 
   evhtp_request_t* request = infer_request->EvHtpRequest();
+  evhtp_unset_hook(&request->hooks, evhtp_hook_on_error);
   evhtp_send_reply(request, EVHTP_RES_OK);
   evhtp_request_resume(request);
 
@@ -1274,6 +1362,7 @@ HTTPAPIServer::BADReplyCallback(evthr_t* thr, void* arg, void* shared)
       reinterpret_cast<HTTPAPIServer::InferRequest*>(arg);
 
   evhtp_request_t* request = infer_request->EvHtpRequest();
+  evhtp_unset_hook(&request->hooks, evhtp_hook_on_error);
   evhtp_send_reply(request, EVHTP_RES_BADREQ);
   evhtp_request_resume(request);
 
@@ -1294,8 +1383,8 @@ HTTPAPIServer::BADReplyCallback(evthr_t* thr, void* arg, void* shared)
 HTTPAPIServer::InferRequest::InferRequest(
     evhtp_request_t* req, uint64_t request_id, const char* server_id,
     uint64_t unique_id)
-    : req_(req), request_id_(request_id), server_id_(server_id),
-      unique_id_(unique_id)
+    : request_provider_(nullptr), req_(req), request_id_(request_id),
+      server_id_(server_id), unique_id_(unique_id)
 {
   evhtp_connection_t* htpconn = evhtp_request_get_connection(req);
   thread_ = htpconn->thread;
@@ -1326,6 +1415,24 @@ HTTPAPIServer::InferRequest::InferComplete(
       "deleting inference response");
 }
 
+void
+HTTPAPIServer::InferRequest::RequestErrorCallback(
+    evhtp_request_t* req, evhtp_error_flags errtype, void* arg)
+{
+  HTTPAPIServer::InferRequest* infer_request =
+      reinterpret_cast<HTTPAPIServer::InferRequest*>(arg);
+
+  LOG_VERBOSE(1) << "HTTP connection error, cancelling inference request "
+                 << infer_request->unique_id_;
+
+  // Only mark the in-flight request as cancelled, the scheduler drops
+  // it if it has not yet been dispatched. The response path still
+  // runs so 'infer_request' is cleaned up as usual.
+  LOG_TRTSERVER_ERROR(
+      TRTSERVER_InferenceRequestProviderCancel(infer_request->request_provider_),
+      "cancelling inference request");
+}
+
 evhtp_res
 HTTPAPIServer::InferRequest::FinalizeResponse(
     TRTSERVER_InferenceResponse* response)
@@ -30,9 +30,19 @@
 #include <evhtp/evhtp.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
+#include <netinet/in.h>
 #include <re2/re2.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <zlib.h>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
 #include "rapidjson/rapidjson.h"
@@ -40,6 +50,7 @@
 #include "rapidjson/writer.h"
 #include "src/core/api.pb.h"
 #include "src/core/constants.h"
+#include "src/core/cpu_affinity.h"
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
 #include "src/core/server_status.pb.h"
@@ -57,17 +68,56 @@ extern "C" {
 
 namespace nvidia { namespace inferenceserver {
 
+// Create a listening socket on 'port' with SO_REUSEPORT set so that
+// several event loops can each bind their own listener and let the
+// kernel distribute connections across them. Return -1 on failure.
+static evutil_socket_t
+NewReusePortSocket(const int32_t port)
+{
+  evutil_socket_t sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0) {
+    return -1;
+  }
+
+  int on = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+  evutil_make_socket_nonblocking(sock);
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if ((bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) ||
+      (listen(sock, 1024) < 0)) {
+    evutil_closesocket(sock);
+    return -1;
+  }
+
+  return sock;
+}
+
 // Generic HTTP server using evhtp
 class HTTPServerV2Impl : public HTTPServerV2 {
  public:
-  explicit HTTPServerV2Impl(const int32_t port, const int thread_cnt)
-      : port_(port), thread_cnt_(thread_cnt)
+  explicit HTTPServerV2Impl(
+      const int32_t port, const int thread_cnt, const int event_loop_cnt = 1,
+      const std::string& uds_path = "")
+      : port_(port), thread_cnt_(thread_cnt),
+        // SO_REUSEPORT does not distribute connections across unix
+        // domain socket listeners so a UDS server uses a single loop.
+        event_loop_cnt_(
+            uds_path.empty() ? std::max(1, event_loop_cnt) : 1),
+        uds_path_(uds_path)
   {
   }
 
   virtual ~HTTPServerV2Impl() { Stop(); }
 
   static void Dispatch(evhtp_request_t* req, void* arg);
+  static evhtp_res NewConnection(evhtp_connection_t* conn, void* arg);
+  static void ThreadInit(evhtp_t* htp, evthr_t* thread, void* arg);
 
   TRITONSERVER_Error* Start() override;
   TRITONSERVER_Error* Stop() override;
@@ -75,58 +125,147 @@ class HTTPServerV2Impl : public HTTPServerV2 {
  protected:
   virtual void Handle(evhtp_request_t* req) = 0;
 
+  // Called once the headers of a request have been received, before
+  // any of the body. Return EVHTP_RES_OK to continue processing the
+  // request.
+  virtual evhtp_res HandleHeaders(evhtp_request_t* req)
+  {
+    return EVHTP_RES_OK;
+  }
+
+  static evhtp_res OnHeaders(
+      evhtp_request_t* req, evhtp_headers_t* headers, void* arg);
+
   static void StopCallback(int sock, short events, void* arg);
 
   int32_t port_;
   int thread_cnt_;
 
-  evhtp_t* htp_;
-  struct event_base* evbase_;
-  std::thread worker_;
-  int fds_[2];
-  event* break_ev_;
+  // The number of event loops. With a single loop the server binds
+  // one socket and runs the evhtp worker-thread pool behind it. With
+  // more than one loop each loop binds its own SO_REUSEPORT listener
+  // and serves its connections on its own thread.
+  const int event_loop_cnt_;
+
+  // If not empty, the unix domain socket path the server binds
+  // instead of a TCP port, for clients co-located on the same host.
+  const std::string uds_path_;
+
+  // One entry per event loop.
+  std::vector<evhtp_t*> htps_;
+  std::vector<struct event_base*> evbases_;
+  std::vector<std::thread> workers_;
+  std::vector<std::array<int, 2>> fds_;
+  std::vector<event*> break_evs_;
 };
 
 TRITONSERVER_Error*
 HTTPServerV2Impl::Start()
 {
-  if (!worker_.joinable()) {
-    evbase_ = event_base_new();
-    htp_ = evhtp_new(evbase_, NULL);
-    evhtp_enable_flag(htp_, EVHTP_FLAG_ENABLE_NODELAY);
-    evhtp_set_gencb(htp_, HTTPServerV2Impl::Dispatch, this);
-    evhtp_use_threads_wexit(htp_, NULL, NULL, thread_cnt_, NULL);
-    evhtp_bind_socket(htp_, "0.0.0.0", port_, 1024);
+  if (!workers_.empty()) {
+    return TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_ALREADY_EXISTS,
+        "HTTP V2 server is already running.");
+  }
+
+  for (int i = 0; i < event_loop_cnt_; ++i) {
+    struct event_base* evbase = event_base_new();
+    evhtp_t* htp = evhtp_new(evbase, NULL);
+    evhtp_enable_flag(htp, EVHTP_FLAG_ENABLE_NODELAY);
+    evhtp_set_gencb(htp, HTTPServerV2Impl::Dispatch, this);
+    evhtp_set_post_accept_cb(htp, HTTPServerV2Impl::NewConnection, this);
+    if (!uds_path_.empty()) {
+      // A stale socket file left behind by a previous run would make
+      // the bind fail.
+      unlink(uds_path_.c_str());
+      evhtp_use_threads_wexit(
+          htp, HTTPServerV2Impl::ThreadInit, NULL, thread_cnt_, NULL);
+      if (evhtp_bind_socket(
+              htp, ("unix:" + uds_path_).c_str(), 0, 1024) != 0) {
+        evhtp_free(htp);
+        event_base_free(evbase);
+        return TRITONSERVER_ErrorNew(
+            TRITONSERVER_ERROR_INTERNAL,
+            std::string(
+                "failed to bind unix domain socket at '" + uds_path_ + "'")
+                .c_str());
+      }
+    } else if (event_loop_cnt_ == 1) {
+      evhtp_use_threads_wexit(
+          htp, HTTPServerV2Impl::ThreadInit, NULL, thread_cnt_, NULL);
+      evhtp_bind_socket(htp, "0.0.0.0", port_, 1024);
+    } else {
+      evutil_socket_t sock = NewReusePortSocket(port_);
+      if (sock < 0) {
+        evhtp_free(htp);
+        event_base_free(evbase);
+        return TRITONSERVER_ErrorNew(
+            TRITONSERVER_ERROR_INTERNAL,
+            std::string(
+                "failed to bind SO_REUSEPORT socket on port " +
+                std::to_string(port_))
+                .c_str());
+      }
+
+      evhtp_accept_socket(htp, sock, 1024);
+    }
+
     // Set listening event for breaking event loop
-    evutil_socketpair(AF_UNIX, SOCK_STREAM, 0, fds_);
-    break_ev_ = event_new(evbase_, fds_[0], EV_READ, StopCallback, evbase_);
-    event_add(break_ev_, NULL);
-    worker_ = std::thread(event_base_loop, evbase_, 0);
-    return nullptr;
+    std::array<int, 2> fds;
+    evutil_socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data());
+    event* break_ev =
+        event_new(evbase, fds[0], EV_READ, StopCallback, evbase);
+    event_add(break_ev, NULL);
+
+    htps_.push_back(htp);
+    evbases_.push_back(evbase);
+    fds_.push_back(fds);
+    break_evs_.push_back(break_ev);
+    workers_.emplace_back([evbase] {
+      BindThreadToAffinityPool(AffinityPool::HTTP_WORKER);
+      event_base_loop(evbase, 0);
+    });
   }
 
-  return TRITONSERVER_ErrorNew(
-      TRITONSERVER_ERROR_ALREADY_EXISTS, "HTTP V2 server is already running.");
+  return nullptr;
 }
 
 TRITONSERVER_Error*
 HTTPServerV2Impl::Stop()
 {
-  if (worker_.joinable()) {
-    // Notify event loop to break via fd write
-    send(fds_[1], &evbase_, sizeof(event_base*), 0);
-    worker_.join();
-    event_free(break_ev_);
-    evutil_closesocket(fds_[0]);
-    evutil_closesocket(fds_[1]);
-    evhtp_unbind_socket(htp_);
-    evhtp_free(htp_);
-    event_base_free(evbase_);
-    return nullptr;
+  if (workers_.empty()) {
+    return TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_UNAVAILABLE, "HTTP V2 server is not running.");
   }
 
-  return TRITONSERVER_ErrorNew(
-      TRITONSERVER_ERROR_UNAVAILABLE, "HTTP V2 server is not running.");
+  // Notify every event loop to break via fd write
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    send(fds_[i][1], &evbases_[i], sizeof(struct event_base*), 0);
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    event_free(break_evs_[i]);
+    evutil_closesocket(fds_[i][0]);
+    evutil_closesocket(fds_[i][1]);
+    evhtp_unbind_socket(htps_[i]);
+    evhtp_free(htps_[i]);
+    event_base_free(evbases_[i]);
+  }
+
+  if (!uds_path_.empty()) {
+    unlink(uds_path_.c_str());
+  }
+
+  htps_.clear();
+  evbases_.clear();
+  workers_.clear();
+  fds_.clear();
+  break_evs_.clear();
+
+  return nullptr;
 }
 
 void
@@ -142,6 +281,28 @@ HTTPServerV2Impl::Dispatch(evhtp_request_t* req, void* arg)
   (static_cast<HTTPServerV2Impl*>(arg))->Handle(req);
 }
 
+void
+HTTPServerV2Impl::ThreadInit(evhtp_t* htp, evthr_t* thread, void* arg)
+{
+  BindThreadToAffinityPool(AffinityPool::HTTP_WORKER);
+}
+
+evhtp_res
+HTTPServerV2Impl::NewConnection(evhtp_connection_t* conn, void* arg)
+{
+  evhtp_connection_set_hook(
+      conn, evhtp_hook_on_headers, (evhtp_hook)HTTPServerV2Impl::OnHeaders,
+      arg);
+  return EVHTP_RES_OK;
+}
+
+evhtp_res
+HTTPServerV2Impl::OnHeaders(
+    evhtp_request_t* req, evhtp_headers_t* headers, void* arg)
+{
+  return (static_cast<HTTPServerV2Impl*>(arg))->HandleHeaders(req);
+}
+
 #ifdef TRTIS_ENABLE_METRICS
 
 // Handle HTTP requests to obtain prometheus metrics
@@ -211,8 +372,10 @@ class HTTPAPIServerV2 : public HTTPServerV2Impl {
           trace_manager,
       const std::shared_ptr<SharedMemoryManager>& shm_manager,
       const std::vector<std::string>& endpoints, const int32_t port,
-      const int thread_cnt)
-      : HTTPServerV2Impl(port, thread_cnt), server_(server),
+      const int thread_cnt, const int event_loop_cnt,
+      const std::string& uds_path = "")
+      : HTTPServerV2Impl(port, thread_cnt, event_loop_cnt, uds_path),
+        server_(server),
         trace_manager_(trace_manager), shm_manager_(shm_manager),
         allocator_(nullptr), server_regex_(R"(/v2(?:/health/(live|ready))?)"),
         model_regex_(
@@ -299,6 +462,11 @@ class HTTPAPIServerV2 : public HTTPServerV2Impl {
     }
 
     std::vector<evbuffer*> response_buffer_;
+    // Map from output tensor name to the evbuffer in
+    // 'response_buffer_' holding that tensor's data. Entries are
+    // non-owning and only exist for outputs that are not returned in
+    // shared memory.
+    std::unordered_map<std::string, evbuffer*> response_buffer_map_;
     std::vector<std::vector<char>> request_buffer_;
     rapidjson::Document request_json_;
     rapidjson::Document response_json_;
@@ -320,6 +488,9 @@ class HTTPAPIServerV2 : public HTTPServerV2Impl {
           evbuffer_free(buffer);
         }
       }
+      if (decompressed_body_ != nullptr) {
+        evbuffer_free(decompressed_body_);
+      }
     }
 
     evhtp_request_t* EvHtpRequest() const { return req_; }
@@ -335,6 +506,11 @@ class HTTPAPIServerV2 : public HTTPServerV2Impl {
 
     AllocPayload response_meta_data_;
 
+    // Holds the decompressed request body when the request arrived
+    // compressed. Input tensors reference this data so it must live
+    // as long as the request.
+    evbuffer* decompressed_body_ = nullptr;
+
    private:
     evhtp_request_t* req_;
     evthr_t* thread_;
@@ -342,6 +518,60 @@ class HTTPAPIServerV2 : public HTTPServerV2Impl {
     const uint64_t unique_id_;
   };
 
+  //
+  // StreamState
+  //
+  // State for an inference request whose body is ingested
+  // incrementally. The JSON header is parsed as soon as it has fully
+  // arrived and the binary tensor data that follows it is appended
+  // directly to the inference request as body chunks are received,
+  // overlapping the network receive with request setup.
+  struct StreamState {
+    StreamState(
+        const std::string& model_name, const std::string& model_version_str,
+        const size_t header_length)
+        : model_name_(model_name), model_version_str_(model_version_str),
+          header_length_(header_length), header_parsed_(false), consumed_(0),
+          irequest_(nullptr), err_(nullptr)
+    {
+    }
+
+    ~StreamState()
+    {
+      if (err_ != nullptr) {
+        TRITONSERVER_ErrorDelete(err_);
+      }
+      if (irequest_ != nullptr) {
+        LOG_TRITONSERVER_ERROR(
+            TRITONSERVER_InferenceRequestDelete(irequest_),
+            "deleting inference request");
+      }
+    }
+
+    const std::string model_name_;
+    const std::string model_version_str_;
+    const size_t header_length_;
+
+    // True once the JSON header has been parsed and the inference
+    // request created.
+    bool header_parsed_;
+
+    // The number of bytes of the request body, including the JSON
+    // header, already handed to the inference request.
+    size_t consumed_;
+
+    // The binary inputs, in request-body order, that still need data
+    // and the number of bytes each still needs.
+    std::deque<std::pair<std::string, size_t>> pending_inputs_;
+
+    TRITONSERVER_InferenceRequest* irequest_;
+    std::unique_ptr<InferRequestClass> infer_request_;
+
+    // Error encountered while ingesting the body, reported once the
+    // request completes.
+    TRITONSERVER_Error* err_;
+  };
+
  private:
   static TRITONSERVER_Error* InferResponseAlloc(
       TRITONSERVER_ResponseAllocator* allocator, const char* tensor_name,
@@ -391,11 +621,19 @@ class HTTPAPIServerV2 : public HTTPServerV2Impl {
   TRITONSERVER_Error* EVBufferToInput(
       const std::string& model_name, TRITONSERVER_InferenceRequest* irequest,
       evbuffer* input_buffer, InferRequestClass* infer_req,
-      size_t header_length);
+      size_t header_length, StreamState* stream_state);
   TRITONSERVER_Error* EVBufferToJson(
       rapidjson::Document* document, evbuffer_iovec* v, int* v_idx,
       const size_t length, int n);
 
+  evhtp_res HandleHeaders(evhtp_request_t* req) override;
+  static evhtp_res StreamReadHook(
+      evhtp_request_t* req, evbuffer* buf, void* arg);
+  static evhtp_res StreamFiniHook(evhtp_request_t* req, void* arg);
+  TRITONSERVER_Error* StreamIngestChunk(
+      evhtp_request_t* req, StreamState* state);
+  std::unique_ptr<StreamState> ExtractStreamState(evhtp_request_t* req);
+
   static void OKReplyCallback(evthr_t* thr, void* arg, void* shared);
   static void BADReplyCallback(evthr_t* thr, void* arg, void* shared);
 
@@ -418,6 +656,13 @@ class HTTPAPIServerV2 : public HTTPServerV2Impl {
   re2::RE2 modelcontrol_regex_;
   re2::RE2 systemsharedmemory_regex_;
   re2::RE2 cudasharedmemory_regex_;
+
+  // Ingestion state for in-flight requests, keyed by the evhtp
+  // request. Protected by 'stream_states_mtx_' since each event loop
+  // runs on its own thread.
+  std::mutex stream_states_mtx_;
+  std::unordered_map<evhtp_request_t*, std::unique_ptr<StreamState>>
+      stream_states_;
 };
 
 TRITONSERVER_Error*
@@ -524,6 +769,11 @@ HTTPAPIServerV2::InferResponseAlloc(
             "failed to commit output tensors to output buffer");
       }
 
+      // Remember which evbuffer holds this tensor's data so
+      // FinalizeResponse can hand the bytes to libevent without
+      // copying them.
+      payload->response_buffer_map_[tensor_name] = evhttp_buffer;
+
       LOG_VERBOSE(1) << "HTTP using buffer for: '" << tensor_name
                      << "', size: " << byte_size << ", addr: " << *buffer;
     }
@@ -851,6 +1101,59 @@ WriteDataToJson(
   return nullptr;
 }
 
+// Decompress the complete contents of 'input' into 'output'. Both
+// gzip and zlib (deflate) framed data are accepted.
+TRITONSERVER_Error*
+DecompressBuffer(evbuffer* input, evbuffer* output)
+{
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+
+  // 15 + 32 enables automatic detection of gzip or zlib framing.
+  if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+    return TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_INTERNAL,
+        "failed to initialize decompression stream");
+  }
+
+  int n = evbuffer_peek(input, -1, NULL, NULL, 0);
+  struct evbuffer_iovec* v = static_cast<struct evbuffer_iovec*>(
+      alloca(sizeof(struct evbuffer_iovec) * n));
+  if (evbuffer_peek(input, -1, NULL, v, n) != n) {
+    inflateEnd(&stream);
+    return TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_INTERNAL, "unexpected error getting input buffers");
+  }
+
+  int ret = Z_OK;
+  for (int i = 0; (i < n) && (ret != Z_STREAM_END); i++) {
+    stream.next_in = reinterpret_cast<Bytef*>(v[i].iov_base);
+    stream.avail_in = v[i].iov_len;
+    while ((stream.avail_in > 0) && (ret != Z_STREAM_END)) {
+      unsigned char chunk[64 * 1024];
+      stream.next_out = chunk;
+      stream.avail_out = sizeof(chunk);
+      ret = inflate(&stream, Z_NO_FLUSH);
+      if ((ret != Z_OK) && (ret != Z_STREAM_END)) {
+        inflateEnd(&stream);
+        return TRITONSERVER_ErrorNew(
+            TRITONSERVER_ERROR_INVALID_ARG,
+            "failed to decompress request body");
+      }
+      evbuffer_add(output, chunk, sizeof(chunk) - stream.avail_out);
+    }
+  }
+
+  inflateEnd(&stream);
+  if (ret != Z_STREAM_END) {
+    return TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_INVALID_ARG,
+        "compressed request body is incomplete");
+  }
+
+  return nullptr;  // Success
+}
+
 void
 EVBufferAddErrorJson(evbuffer* buffer, TRITONSERVER_Error* err)
 {
@@ -1585,10 +1888,197 @@ HTTPAPIServerV2::EVBufferToJson(
   return nullptr;
 }
 
+evhtp_res
+HTTPAPIServerV2::HandleHeaders(evhtp_request_t* req)
+{
+  // Only infer requests that use the binary-data extension can be
+  // ingested incrementally. All other requests are handled once the
+  // complete body has been received.
+  if (req->method != htp_method_POST) {
+    return EVHTP_RES_OK;
+  }
+
+  // A compressed body can only be decompressed once it is complete,
+  // so it can't be ingested incrementally.
+  const char* content_encoding =
+      evhtp_kv_find(req->headers_in, kContentEncodingHTTPHeader);
+  if ((content_encoding != NULL) &&
+      (strcmp(content_encoding, "identity") != 0)) {
+    return EVHTP_RES_OK;
+  }
+
+  const char* header_length_c_str =
+      evhtp_kv_find(req->headers_in, kInferHeaderContentLengthHTTPHeader);
+  if (header_length_c_str == NULL) {
+    return EVHTP_RES_OK;
+  }
+  const size_t header_length = std::atoi(header_length_c_str);
+  if (header_length == 0) {
+    return EVHTP_RES_OK;
+  }
+
+  std::string model_name, version, kind;
+  if (!RE2::FullMatch(
+          std::string(req->uri->path->full), model_regex_, &model_name,
+          &version, &kind) ||
+      (kind != "infer")) {
+    return EVHTP_RES_OK;
+  }
+
+  evhtp_request_set_hook(
+      req, evhtp_hook_on_read, (evhtp_hook)StreamReadHook, this);
+  evhtp_request_set_hook(
+      req, evhtp_hook_on_request_fini, (evhtp_hook)StreamFiniHook, this);
+
+  std::unique_ptr<StreamState> state(
+      new StreamState(model_name, version, header_length));
+  {
+    std::lock_guard<std::mutex> lock(stream_states_mtx_);
+    stream_states_.emplace(req, std::move(state));
+  }
+
+  return EVHTP_RES_OK;
+}
+
+evhtp_res
+HTTPAPIServerV2::StreamReadHook(evhtp_request_t* req, evbuffer* buf, void* arg)
+{
+  HTTPAPIServerV2* server = static_cast<HTTPAPIServerV2*>(arg);
+
+  // Move the chunk into the request buffer now so that the data gets
+  // its final, stable address before being appended to the inference
+  // request. evhtp would otherwise do the same move after this hook
+  // returns. When evhtp buffers the body contiguously 'buf' is
+  // already empty and the data is already in 'buffer_in'.
+  evbuffer_add_buffer(req->buffer_in, buf);
+
+  StreamState* state = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(server->stream_states_mtx_);
+    auto itr = server->stream_states_.find(req);
+    if (itr != server->stream_states_.end()) {
+      state = itr->second.get();
+    }
+  }
+
+  if ((state != nullptr) && (state->err_ == nullptr)) {
+    // Defer reporting any error until the request completes so the
+    // reply is sent from the normal completion path.
+    state->err_ = server->StreamIngestChunk(req, state);
+  }
+
+  return EVHTP_RES_OK;
+}
+
+evhtp_res
+HTTPAPIServerV2::StreamFiniHook(evhtp_request_t* req, void* arg)
+{
+  HTTPAPIServerV2* server = static_cast<HTTPAPIServerV2*>(arg);
+
+  // Normally the state is claimed by HandleInfer. If the request is
+  // destroyed without completing, because the client disconnected,
+  // then release whatever was ingested so far.
+  server->ExtractStreamState(req);
+  return EVHTP_RES_OK;
+}
+
+std::unique_ptr<HTTPAPIServerV2::StreamState>
+HTTPAPIServerV2::ExtractStreamState(evhtp_request_t* req)
+{
+  std::lock_guard<std::mutex> lock(stream_states_mtx_);
+  auto itr = stream_states_.find(req);
+  if (itr == stream_states_.end()) {
+    return nullptr;
+  }
+
+  std::unique_ptr<StreamState> state = std::move(itr->second);
+  stream_states_.erase(itr);
+  return state;
+}
+
+TRITONSERVER_Error*
+HTTPAPIServerV2::StreamIngestChunk(evhtp_request_t* req, StreamState* state)
+{
+  const size_t total = evbuffer_get_length(req->buffer_in);
+
+  // Wait until the complete JSON header has arrived, then parse it
+  // and create the inference request. Any binary input data that
+  // arrived along with the header is consumed below.
+  if (!state->header_parsed_) {
+    if (total < state->header_length_) {
+      return nullptr;  // Success
+    }
+
+    RETURN_IF_TRITON_ERR(TRITONSERVER_InferenceRequestNew(
+        &state->irequest_, server_.get(), state->model_name_.c_str(),
+        state->model_version_str_.c_str()));
+    state->infer_request_.reset(new InferRequestClass(
+        req, server_id_, RequestStatusUtil::NextUniqueRequestId()));
+    RETURN_IF_TRITON_ERR(EVBufferToInput(
+        state->model_name_, state->irequest_, req->buffer_in,
+        state->infer_request_.get(), state->header_length_, state));
+
+    state->header_parsed_ = true;
+    state->consumed_ = state->header_length_;
+  }
+
+  if ((state->consumed_ == total) || state->pending_inputs_.empty()) {
+    return nullptr;  // Success
+  }
+
+  // Append the newly arrived bytes to the binary inputs, in the
+  // order the inputs appear in the request body.
+  struct evbuffer_ptr pos;
+  if (evbuffer_ptr_set(
+          req->buffer_in, &pos, state->consumed_, EVBUFFER_PTR_SET) != 0) {
+    return TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_INTERNAL,
+        "unexpected error seeking in input buffer");
+  }
+
+  int n = evbuffer_peek(req->buffer_in, -1, &pos, NULL, 0);
+  struct evbuffer_iovec* v = static_cast<struct evbuffer_iovec*>(
+      alloca(sizeof(struct evbuffer_iovec) * n));
+  if (evbuffer_peek(req->buffer_in, -1, &pos, v, n) != n) {
+    return TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_INTERNAL, "unexpected error getting input buffers");
+  }
+
+  int v_idx = 0;
+  while (!state->pending_inputs_.empty() && (v_idx < n)) {
+    auto& pending = state->pending_inputs_.front();
+
+    char* base = static_cast<char*>(v[v_idx].iov_base);
+    size_t base_size;
+    if (v[v_idx].iov_len > pending.second) {
+      base_size = pending.second;
+      v[v_idx].iov_base = static_cast<void*>(base + base_size);
+      v[v_idx].iov_len -= base_size;
+      pending.second = 0;
+    } else {
+      base_size = v[v_idx].iov_len;
+      pending.second -= base_size;
+      v_idx++;
+    }
+
+    RETURN_IF_TRITON_ERR(TRITONSERVER_InferenceRequestAppendInputData(
+        state->irequest_, pending.first.c_str(), base, base_size,
+        TRITONSERVER_MEMORY_CPU, 0 /* memory_type_id */));
+
+    state->consumed_ += base_size;
+    if (pending.second == 0) {
+      state->pending_inputs_.pop_front();
+    }
+  }
+
+  return nullptr;  // Success
+}
+
 TRITONSERVER_Error*
 HTTPAPIServerV2::EVBufferToInput(
     const std::string& model_name, TRITONSERVER_InferenceRequest* irequest,
-    evbuffer* input_buffer, InferRequestClass* infer_req, size_t header_length)
+    evbuffer* input_buffer, InferRequestClass* infer_req, size_t header_length,
+    StreamState* stream_state)
 {
   // Extract individual input data from HTTP body and register in
   // 'request_provider'. The input data from HTTP body is not
@@ -1724,34 +2214,40 @@ HTTPAPIServerV2::EVBufferToInput(
             "data format");
       }
 
-      // Process one block at a time
-      while ((byte_size > 0) && (v_idx < n)) {
-        char* base = static_cast<char*>(v[v_idx].iov_base);
-        size_t base_size;
-        if (v[v_idx].iov_len > byte_size) {
-          base_size = byte_size;
-          v[v_idx].iov_base = static_cast<void*>(base + byte_size);
-          v[v_idx].iov_len -= byte_size;
-          byte_size = 0;
-        } else {
-          base_size = v[v_idx].iov_len;
-          byte_size -= v[v_idx].iov_len;
-          v_idx++;
-        }
+      if (stream_state != nullptr) {
+        // The binary data is appended incrementally as body chunks
+        // arrive, just record how many bytes this input needs.
+        stream_state->pending_inputs_.emplace_back(input_name, byte_size);
+      } else {
+        // Process one block at a time
+        while ((byte_size > 0) && (v_idx < n)) {
+          char* base = static_cast<char*>(v[v_idx].iov_base);
+          size_t base_size;
+          if (v[v_idx].iov_len > byte_size) {
+            base_size = byte_size;
+            v[v_idx].iov_base = static_cast<void*>(base + byte_size);
+            v[v_idx].iov_len -= byte_size;
+            byte_size = 0;
+          } else {
+            base_size = v[v_idx].iov_len;
+            byte_size -= v[v_idx].iov_len;
+            v_idx++;
+          }
 
-        RETURN_IF_TRITON_ERR(TRITONSERVER_InferenceRequestAppendInputData(
-            irequest, input_name, base, base_size, TRITONSERVER_MEMORY_CPU,
-            0 /* memory_type_id */));
-      }
+          RETURN_IF_TRITON_ERR(TRITONSERVER_InferenceRequestAppendInputData(
+              irequest, input_name, base, base_size, TRITONSERVER_MEMORY_CPU,
+              0 /* memory_type_id */));
+        }
 
-      if (byte_size != 0) {
-        return TRITONSERVER_ErrorNew(
-            TRITONSERVER_ERROR_INVALID_ARG,
-            std::string(
-                "unexpected size for input '" + std::string(input_name) +
-                "', expecting " + std::to_string(byte_size) +
-                " bytes for model '" + model_name + "'")
-                .c_str());
+        if (byte_size != 0) {
+          return TRITONSERVER_ErrorNew(
+              TRITONSERVER_ERROR_INVALID_ARG,
+              std::string(
+                  "unexpected size for input '" + std::string(input_name) +
+                  "', expecting " + std::to_string(byte_size) +
+                  " bytes for model '" + model_name + "'")
+                  .c_str());
+        }
       }
     } else {
       // Process input if in shared memory.
@@ -1823,7 +2319,10 @@ HTTPAPIServerV2::EVBufferToInput(
     }
   }
 
-  if (v_idx != n) {
+  // When ingesting incrementally only the JSON header has been
+  // consumed here, the binary data blocks are consumed as they
+  // arrive.
+  if ((stream_state == nullptr) && (v_idx != n)) {
     return TRITONSERVER_ErrorNew(
         TRITONSERVER_ERROR_INVALID_ARG,
         std::string(
@@ -1899,7 +2398,7 @@ HTTPAPIServerV2::HandleInfer(
   // this is the first place where we have a tracer.
   std::unique_ptr<TraceMetaData> trace_meta_data;
   if (trace_manager_ != nullptr) {
-    trace_meta_data.reset(trace_manager_->SampleTrace());
+    trace_meta_data.reset(trace_manager_->SampleTrace(model_name));
     if (trace_meta_data != nullptr) {
       int64_t requested_model_version;
       err = GetModelVersionFromString(
@@ -1922,66 +2421,123 @@ HTTPAPIServerV2::HandleInfer(
   }
 #endif  // TRTIS_ENABLE_TRACING
 
-  uint64_t unique_id = RequestStatusUtil::NextUniqueRequestId();
-
-  // Create the inference request object which provides all information needed
-  // for an inference.
   TRITONSERVER_InferenceRequest* irequest = nullptr;
-  if (err == nullptr) {
-    err = TRITONSERVER_InferenceRequestNew(
-        &irequest, server_.get(), model_name.c_str(),
-        model_version_str.c_str());
-  }
-
-  if (err == nullptr) {
-    std::unique_ptr<InferRequestClass> infer_request(
-        new InferRequestClass(req, server_id_, unique_id));
-
-    // Find Inference-Header-Content-Length in header. If missing set to 0
-    size_t header_length = 0;
-    const char* header_length_c_str =
-        evhtp_kv_find(req->headers_in, kInferHeaderContentLengthHTTPHeader);
-    if (header_length_c_str != NULL) {
-      header_length = std::atoi(header_length_c_str);
+  std::unique_ptr<InferRequestClass> infer_request;
+
+  // If the body was ingested incrementally as it arrived then the
+  // inference request is already populated, otherwise parse the
+  // complete buffered body now.
+  std::unique_ptr<StreamState> stream_state = ExtractStreamState(req);
+  if ((stream_state != nullptr) && !stream_state->header_parsed_ &&
+      (stream_state->err_ == nullptr)) {
+    // The body is smaller than the advertised JSON header length,
+    // let the normal parsing path generate the error.
+    stream_state.reset();
+  }
+
+  if (stream_state != nullptr) {
+    irequest = stream_state->irequest_;
+    stream_state->irequest_ = nullptr;
+    infer_request = std::move(stream_state->infer_request_);
+    if (err == nullptr) {
+      err = stream_state->err_;
+      stream_state->err_ = nullptr;
+    }
+    if ((err == nullptr) &&
+        (!stream_state->pending_inputs_.empty() ||
+         (stream_state->consumed_ != evbuffer_get_length(req->buffer_in)))) {
+      err = TRITONSERVER_ErrorNew(
+          TRITONSERVER_ERROR_INVALID_ARG,
+          std::string(
+              "unexpected size for binary input data for model '" +
+              model_name + "'")
+              .c_str());
+    }
+  } else {
+    // Create the inference request object which provides all information
+    // needed for an inference.
+    if (err == nullptr) {
+      err = TRITONSERVER_InferenceRequestNew(
+          &irequest, server_.get(), model_name.c_str(),
+          model_version_str.c_str());
     }
 
-    err = EVBufferToInput(
-        model_name, irequest, req->buffer_in, infer_request.get(),
-        header_length);
     if (err == nullptr) {
-      // Provide the trace manager object to use for this request, if nullptr
-      // then no tracing will be performed.
-      TRITONSERVER_TraceManager* trace_manager = nullptr;
-#ifdef TRTIS_ENABLE_TRACING
-      if (trace_meta_data != nullptr) {
-        infer_request->trace_meta_data_ = std::move(trace_meta_data);
-        TRITONSERVER_TraceManagerNew(
-            &trace_manager, TraceManager::CreateTrace,
-            TraceManager::ReleaseTrace, infer_request->trace_meta_data_.get());
+      infer_request.reset(new InferRequestClass(
+          req, server_id_, RequestStatusUtil::NextUniqueRequestId()));
+
+      // If the client compressed the body then transparently
+      // decompress it and parse the decompressed bytes instead.
+      evbuffer* input_buffer = req->buffer_in;
+      const char* content_encoding =
+          evhtp_kv_find(req->headers_in, kContentEncodingHTTPHeader);
+      if ((content_encoding != NULL) &&
+          (strcmp(content_encoding, "identity") != 0)) {
+        if ((strcmp(content_encoding, "gzip") == 0) ||
+            (strcmp(content_encoding, "deflate") == 0)) {
+          infer_request->decompressed_body_ = evbuffer_new();
+          err = DecompressBuffer(
+              req->buffer_in, infer_request->decompressed_body_);
+          input_buffer = infer_request->decompressed_body_;
+        } else {
+          err = TRITONSERVER_ErrorNew(
+              TRITONSERVER_ERROR_INVALID_ARG,
+              std::string(
+                  "unsupported Content-Encoding '" +
+                  std::string(content_encoding) + "'")
+                  .c_str());
+        }
+      }
+
+      // Find Inference-Header-Content-Length in header. If missing set to 0
+      size_t header_length = 0;
+      const char* header_length_c_str =
+          evhtp_kv_find(req->headers_in, kInferHeaderContentLengthHTTPHeader);
+      if (header_length_c_str != NULL) {
+        header_length = std::atoi(header_length_c_str);
       }
-#endif  // TRTIS_ENABLE_TRACING
 
-      rapidjson::Document& response_json =
-          infer_request->response_meta_data_.response_json_;
-      rapidjson::Document::AllocatorType& allocator =
-          response_json.GetAllocator();
-      response_json.SetObject();
-      rapidjson::Value model_name_val(model_name.c_str(), allocator);
-      response_json.AddMember("model_name", model_name_val, allocator);
-      rapidjson::Value model_version_val(model_version_str.c_str(), allocator);
-      response_json.AddMember("model_version", model_version_val, allocator);
-
-      err = TRITONSERVER_ServerInferAsync(
-          server_.get(), trace_manager, irequest, allocator_,
-          reinterpret_cast<void*>(&infer_request->response_meta_data_),
-          InferRequestClass::InferComplete,
-          reinterpret_cast<void*>(infer_request.get()));
       if (err == nullptr) {
-        infer_request.release();
+        err = EVBufferToInput(
+            model_name, irequest, input_buffer, infer_request.get(),
+            header_length, nullptr /* stream_state */);
       }
     }
   }
 
+  if (err == nullptr) {
+    // Provide the trace manager object to use for this request, if nullptr
+    // then no tracing will be performed.
+    TRITONSERVER_TraceManager* trace_manager = nullptr;
+#ifdef TRTIS_ENABLE_TRACING
+    if (trace_meta_data != nullptr) {
+      infer_request->trace_meta_data_ = std::move(trace_meta_data);
+      TRITONSERVER_TraceManagerNew(
+          &trace_manager, TraceManager::CreateTrace,
+          TraceManager::ReleaseTrace, infer_request->trace_meta_data_.get());
+    }
+#endif  // TRTIS_ENABLE_TRACING
+
+    rapidjson::Document& response_json =
+        infer_request->response_meta_data_.response_json_;
+    rapidjson::Document::AllocatorType& allocator =
+        response_json.GetAllocator();
+    response_json.SetObject();
+    rapidjson::Value model_name_val(model_name.c_str(), allocator);
+    response_json.AddMember("model_name", model_name_val, allocator);
+    rapidjson::Value model_version_val(model_version_str.c_str(), allocator);
+    response_json.AddMember("model_version", model_version_val, allocator);
+
+    err = TRITONSERVER_ServerInferAsync(
+        server_.get(), trace_manager, irequest, allocator_,
+        reinterpret_cast<void*>(&infer_request->response_meta_data_),
+        InferRequestClass::InferComplete,
+        reinterpret_cast<void*>(infer_request.get()));
+    if (err == nullptr) {
+      infer_request.release();
+    }
+  }
+
   // The request provider can be deleted before ServerInferAsync
   // callback completes.
 
@@ -2142,9 +2698,24 @@ HTTPAPIServerV2::InferRequestClass::FinalizeResponse(
       }
 
       if (CheckBinaryOutputData(request_output)) {
-        // Write outputs into binary buffer. Copy it after JSON buffer
+        // Write outputs into binary buffer. Placed after JSON buffer
         has_binary = true;
-        evbuffer_add(binary_buf, base, byte_size);
+
+        // If the output was written directly into one of the
+        // response evbuffers then move the data into 'binary_buf'
+        // instead of copying it. libevent just relinks the underlying
+        // buffer chain so the response is scatter-gathered to the
+        // socket without touching the tensor bytes.
+        auto buffer_itr =
+            response_meta_data_.response_buffer_map_.find(output_name);
+        if ((buffer_itr != response_meta_data_.response_buffer_map_.end()) &&
+            (evbuffer_get_length(buffer_itr->second) == byte_size)) {
+          evbuffer_add_buffer(binary_buf, buffer_itr->second);
+        } else {
+          // Shared-memory outputs don't live in an evbuffer and so
+          // still require a copy.
+          evbuffer_add(binary_buf, base, byte_size);
+        }
         rapidjson::Value binary_size_val(byte_size);
         auto itr = output_metadata[i].FindMember("parameters");
         if (itr != output_metadata[i].MemberEnd()) {
@@ -2247,6 +2818,8 @@ HTTPAPIServerV2::InferRequestClass::FinalizeResponse(
     }
   }
 
+  evbuffer_free(binary_buf);
+
   return status;
 }
 
@@ -2256,6 +2829,7 @@ HTTPServerV2::CreateAPIServer(
     const std::shared_ptr<nvidia::inferenceserver::TraceManager>& trace_manager,
     const std::shared_ptr<SharedMemoryManager>& shm_manager,
     const std::map<int32_t, std::vector<std::string>>& port_map, int thread_cnt,
+    int event_loop_cnt, const std::string& uds_path,
     std::vector<std::unique_ptr<HTTPServerV2>>* http_servers)
 {
   if (port_map.empty()) {
@@ -2270,7 +2844,21 @@ HTTPServerV2::CreateAPIServer(
     LOG_INFO << "Starting HTTPV2Service at " << addr;
     http_servers->emplace_back(new HTTPAPIServerV2(
         server, trace_manager, shm_manager, ep_map.second, ep_map.first,
-        thread_cnt));
+        thread_cnt, event_loop_cnt));
+  }
+
+  // An additional server on a unix domain socket, serving every
+  // endpoint, for clients co-located on the same host.
+  if (!uds_path.empty()) {
+    LOG_INFO << "Starting HTTPV2Service at unix:" << uds_path;
+    std::vector<std::string> endpoints;
+    for (auto const& ep_map : port_map) {
+      endpoints.insert(
+          endpoints.end(), ep_map.second.begin(), ep_map.second.end());
+    }
+    http_servers->emplace_back(new HTTPAPIServerV2(
+        server, trace_manager, shm_manager, endpoints, -1 /* port */,
+        thread_cnt, 1 /* event_loop_cnt */, uds_path));
   }
 
   return nullptr;
@@ -43,7 +43,8 @@ class HTTPServerV2 {
           trace_manager,
       const std::shared_ptr<SharedMemoryManager>& smb_manager,
       const std::map<int32_t, std::vector<std::string>>& port_map,
-      const int thread_cnt,
+      const int thread_cnt, const int event_loop_cnt,
+      const std::string& uds_path,
       std::vector<std::unique_ptr<HTTPServerV2>>* http_servers);
 
   static TRITONSERVER_Error* CreateMetricsServer(
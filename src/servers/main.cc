@@ -28,12 +28,15 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <condition_variable>
 #include <csignal>
 #include <iostream>
 #include <list>
 #include <mutex>
+#include <sstream>
+#include <thread>
 
 #ifdef TRTIS_ENABLE_ASAN
 #include <sanitizer/lsan_interface.h>
@@ -41,7 +44,10 @@
 
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
+#include "src/core/cpu_affinity.h"
+#include "src/core/filesystem.h"
 #include "src/core/logging.h"
+#include "src/core/spin_wait.h"
 #include "src/core/tritonserver.h"
 #include "src/core/trtserver.h"
 #include "src/servers/common.h"
@@ -73,6 +79,7 @@ namespace {
 // Exit mutex and cv used to signal the main thread that it should
 // close the server and exit.
 volatile bool exiting_ = false;
+volatile bool draining_ = false;
 std::mutex exit_mu_;
 std::condition_variable exit_cv_;
 
@@ -83,6 +90,17 @@ int32_t repository_poll_secs_ = 15;
 // Whether explicit model control is allowed
 bool allow_model_control_ = false;
 
+// If not empty, run the model-repository prefetch phase instead of
+// starting the server: every model file is downloaded into the local
+// download cache with full parallelism and a manifest describing the
+// repository is written to this path, then the process exits. A
+// manifest left by a previous run is used to skip repository
+// discovery.
+std::string prefetch_manifest_path_;
+
+// The model repository paths, recorded here for the prefetch phase.
+std::set<std::string> prefetch_repository_paths_;
+
 // Default to using the V1 protocol.
 int32_t api_version_ = 1;
 
@@ -130,6 +148,7 @@ int32_t metrics_port_ = 8002;
 std::string trace_filepath_;
 auto trace_level_ = TRITONSERVER_TRACE_LEVEL_DISABLED;
 int32_t trace_rate_ = 1000;
+std::vector<std::string> trace_model_rates_;
 #endif  // TRTIS_ENABLE_TRACING
 
 #if defined(TRTIS_ENABLE_GRPC) || defined(TRTIS_ENABLE_GRPC_V2)
@@ -146,11 +165,31 @@ int grpc_stream_infer_thread_cnt_ = 1;
 // requests doesn't exceed this value there will be no
 // allocation/deallocation of request/response objects.
 int grpc_infer_allocation_pool_size_ = 8;
+
+// The compression level used for GRPC inference responses when the
+// client indicates that it accepts compression. Only used by the V2
+// GRPC endpoint.
+grpc_compression_level grpc_infer_response_compression_level_ =
+    GRPC_COMPRESS_LEVEL_NONE;
+
+// If not empty, a unix domain socket path the V2 GRPC front-end also
+// listens on, for clients co-located on the same host.
+std::string grpc_uds_path_;
 #endif  // TRTIS_ENABLE_GRPC || TRTIS_ENABLE_GRPC_V2
 
 #if defined(TRTIS_ENABLE_HTTP) || defined(TRTIS_ENABLE_HTTP_V2)
 // The number of threads to initialize for the HTTP front-end.
 int http_thread_cnt_ = 8;
+
+// The number of SO_REUSEPORT event loops for the V2 HTTP front-end.
+// With the default of 1 a single accept/dispatch loop feeds the
+// worker threads; larger values bind one listener and event loop per
+// count so the kernel spreads connections across them.
+int http_event_loop_cnt_ = 1;
+
+// If not empty, a unix domain socket path the V2 HTTP front-end also
+// listens on, for clients co-located on the same host.
+std::string http_uds_path_;
 #endif  // TRTIS_ENABLE_HTTP || TRTIS_ENABLE_HTTP_V2
 
 // Command-line options
@@ -173,6 +212,8 @@ enum OptionId {
   OPTION_HTTP_PORT,
   OPTION_HTTP_HEALTH_PORT,
   OPTION_HTTP_THREAD_COUNT,
+  OPTION_HTTP_EVENT_LOOP_COUNT,
+  OPTION_HTTP_UNIX_SOCKET,
 #endif  // TRTIS_ENABLE_HTTP || TRTIS_ENABLE_HTTP_V2
 #if defined(TRTIS_ENABLE_GRPC) || defined(TRTIS_ENABLE_GRPC_V2)
   OPTION_ALLOW_GRPC,
@@ -180,6 +221,8 @@ enum OptionId {
   OPTION_GRPC_INFER_THREAD_COUNT,
   OPTION_GRPC_STREAM_INFER_THREAD_COUNT,
   OPTION_GRPC_INFER_ALLOCATION_POOL_SIZE,
+  OPTION_GRPC_INFER_RESPONSE_COMPRESSION_LEVEL,
+  OPTION_GRPC_UNIX_SOCKET,
 #endif  // TRTIS_ENABLE_GRPC || TRTIS_ENABLE_GRPC_V2
 #ifdef TRTIS_ENABLE_METRICS
   OPTION_ALLOW_METRICS,
@@ -190,18 +233,26 @@ enum OptionId {
   OPTION_TRACE_FILEPATH,
   OPTION_TRACE_LEVEL,
   OPTION_TRACE_RATE,
+  OPTION_TRACE_MODEL_RATE,
 #endif  // TRTIS_ENABLE_TRACING
   OPTION_MODEL_CONTROL_MODE,
   OPTION_ALLOW_POLL_REPO,
   OPTION_POLL_REPO_SECS,
   OPTION_ALLOW_MODEL_CONTROL,
   OPTION_STARTUP_MODEL,
+  OPTION_PREFETCH_MODEL_REPOSITORY,
   OPTION_PINNED_MEMORY_POOL_BYTE_SIZE,
   OPTION_CUDA_MEMORY_POOL_BYTE_SIZE,
   OPTION_MIN_SUPPORTED_COMPUTE_CAPABILITY,
   OPTION_EXIT_TIMEOUT_SECS,
+  OPTION_MAX_INFLIGHT_REQUESTS,
+  OPTION_MAX_INFLIGHT_BYTE_SIZE,
+  OPTION_MODEL_LOAD_CONCURRENCY,
+  OPTION_THREAD_AFFINITY,
+  OPTION_BUSY_WAIT_MICROSECONDS,
   OPTION_TF_ALLOW_SOFT_PLACEMENT,
   OPTION_TF_GPU_MEMORY_FRACTION,
+  OPTION_TF_SHARED_THREAD_POOL_SIZE,
   OPTION_TF_ADD_VGPU,
 };
 
@@ -273,6 +324,14 @@ std::vector<Option> options_
        "The port for the server to listen on for HTTP Health requests."},
       {OPTION_HTTP_THREAD_COUNT, "http-thread-count",
        "Number of threads handling HTTP requests."},
+      {OPTION_HTTP_EVENT_LOOP_COUNT, "http-event-loop-count",
+       "Number of SO_REUSEPORT event loops for HTTP requests. Values greater "
+       "than 1 bind one listener per loop so the kernel distributes "
+       "connections across them. Only used by the V2 HTTP endpoint."},
+      {OPTION_HTTP_UNIX_SOCKET, "http-unix-socket",
+       "If specified, the server also listens for HTTP requests on this unix "
+       "domain socket path, avoiding the TCP loopback overhead for clients "
+       "on the same host. Only used by the V2 HTTP endpoint."},
 #endif  // TRTIS_ENABLE_HTTP || TRTIS_ENABLE_HTTP_V2
 #if defined(TRTIS_ENABLE_GRPC) || defined(TRTIS_ENABLE_GRPC_V2)
       {OPTION_ALLOW_GRPC, "allow-grpc",
@@ -289,6 +348,17 @@ std::vector<Option> options_
        "allocated for reuse. As long as the number of in-flight requests "
        "doesn't exceed this value there will be no allocation/deallocation of "
        "request/response objects."},
+      {OPTION_GRPC_INFER_RESPONSE_COMPRESSION_LEVEL,
+       "grpc-infer-response-compression-level",
+       "The compression level used for GRPC inference responses when the "
+       "client indicates that it accepts compression. Must be \"none\", "
+       "\"low\", \"medium\" or \"high\". Requests compressed by the client "
+       "are always accepted. Only used by the V2 GRPC endpoint. Default is "
+       "\"none\"."},
+      {OPTION_GRPC_UNIX_SOCKET, "grpc-unix-socket",
+       "If specified, the server also listens for GRPC requests on this unix "
+       "domain socket path, avoiding the TCP loopback overhead for clients "
+       "on the same host. Only used by the V2 GRPC endpoint."},
 #endif  // TRTIS_ENABLE_GRPC || TRTIS_ENABLE_GRPC_V2
 #ifdef TRTIS_ENABLE_METRICS
       {OPTION_ALLOW_METRICS, "allow-metrics",
@@ -307,17 +377,25 @@ std::vector<Option> options_
        "MAX for maximal tracing. Default is OFF."},
       {OPTION_TRACE_RATE, "trace-rate",
        "Set the trace sampling rate. Default is 1000."},
+      {OPTION_TRACE_MODEL_RATE, "trace-model-rate",
+       "Set the trace sampling rate for a specific model, overriding "
+       "--trace-rate. The format of this option is <model name>:<rate>. A "
+       "rate of 0 disables tracing for the model. This option can be "
+       "specified multiple times."},
 #endif  // TRTIS_ENABLE_TRACING
       {OPTION_MODEL_CONTROL_MODE, "model-control-mode",
-       "Specify the mode for model management. Options are \"none\", \"poll\" "
-       "and \"explicit\". The default is \"poll\". "
+       "Specify the mode for model management. Options are \"none\", \"poll\", "
+       "\"explicit\" and \"lazy\". The default is \"poll\". "
        "For \"none\", the server will load all models in the model "
        "repositories only once at startup. For \"poll\", the server will poll "
        "the model repository to detect changes. The poll rate is controlled by "
        "'repository-poll-secs'. For \"explicit\", the model load and unload is "
        "initiated by using the model control APIs, and the models in the model "
        "repository will not be loaded at startup, unless the model is "
-       "specified by --load-model."},
+       "specified by --load-model. For \"lazy\", the models in the model "
+       "repository are loaded when the first inference request for them "
+       "arrives, except the models specified by --load-model which are loaded "
+       "at startup."},
       {OPTION_ALLOW_POLL_REPO, "allow-poll-model-repository",
        "[DEPRECATED] Poll the model repository to detect changes. The poll "
        "rate is controlled by 'repository-poll-secs'. This option is "
@@ -337,7 +415,16 @@ std::vector<Option> options_
       {OPTION_STARTUP_MODEL, "load-model",
        "Name of the model to be loaded on server startup. It may be specified "
        "multiple times to add multiple models. Note that this option will only "
-       "take affect if --allow-model-control is true."},
+       "take affect if --allow-model-control is true or --model-control-mode "
+       "is \"explicit\" or \"lazy\"."},
+      {OPTION_PREFETCH_MODEL_REPOSITORY, "prefetch-model-repository",
+       "Run the model-repository prefetch phase instead of starting the "
+       "server: download every model file into the local download cache with "
+       "full parallelism, write a manifest of the repository contents to the "
+       "given path and exit. The prefetch runs before any device "
+       "initialization so it can execute in a pre-start hook while the node "
+       "is still being provisioned. A manifest written by a previous run is "
+       "used to skip repository discovery."},
       {OPTION_PINNED_MEMORY_POOL_BYTE_SIZE, "pinned-memory-pool-byte-size",
        "The total byte size that can be allocated as pinned system memory. "
        "If GPU support is enabled, the server will allocate pinned system "
@@ -362,6 +449,34 @@ std::vector<Option> options_
        "Timeout (in seconds) when exiting to wait for in-flight inferences to "
        "finish. After the timeout expires the server exits even if inferences "
        "are still in flight."},
+      {OPTION_MAX_INFLIGHT_REQUESTS, "max-inflight-requests",
+       "The maximum number of inference requests that may be in flight at "
+       "any time. Requests that would exceed the limit are rejected "
+       "immediately. Default is 0 which indicates no limit."},
+      {OPTION_MAX_INFLIGHT_BYTE_SIZE, "max-inflight-byte-size",
+       "The maximum total input byte size of the inference requests that may "
+       "be in flight at any time. Requests that would exceed the limit are "
+       "rejected immediately. Default is 0 which indicates no limit."},
+      {OPTION_MODEL_LOAD_CONCURRENCY, "model-load-concurrency",
+       "The maximum number of models that may be loading concurrently. "
+       "Bounding the concurrency avoids oversubscribing CPU, host and "
+       "device memory when a large model repository is loaded at startup. "
+       "Default is 0 which indicates no limit."},
+      {OPTION_THREAD_AFFINITY, "thread-affinity",
+       "Bind the threads of a server thread pool to a set of CPUs so that, "
+       "for example, the frontend and the scheduler run on different cores "
+       "or on the NUMA node local to the network device. The format of this "
+       "option is <pool>:<cpus> where <pool> is \"http\", \"grpc\" or "
+       "\"scheduler\" and <cpus> is a CPU list such as \"0-3,8\". This "
+       "option can be specified multiple times, once per pool. By default "
+       "threads are not bound and may run on any CPU."},
+      {OPTION_BUSY_WAIT_MICROSECONDS, "busy-wait-microseconds",
+       "The number of microseconds that latency-critical completion "
+       "threads (GRPC completion-queue pollers and scheduler threads) "
+       "busy-wait for new work before sleeping. Spinning trades CPU "
+       "utilization for reduced wakeup latency and is appropriate for "
+       "models with very tight latency budgets. Default is 0 which "
+       "disables busy-waiting."},
       {OPTION_TF_ALLOW_SOFT_PLACEMENT, "tf-allow-soft-placement",
        "Instruct TensorFlow to use CPU implementation of an operation when "
        "a GPU implementation is not available."},
@@ -370,6 +485,12 @@ std::vector<Option> options_
        "value 0.0 indicates that TensorFlow should dynamically allocate "
        "memory as needed. Value of 1.0 indicates that TensorFlow should "
        "allocate all of GPU memory."},
+      {OPTION_TF_SHARED_THREAD_POOL_SIZE, "tf-shared-thread-pool-size",
+       "Share a single thread pool of the given size across all TensorFlow "
+       "sessions so that CPU models do not oversubscribe the cores with "
+       "per-session pools. Value of 0 shares a pool sized by TensorFlow "
+       "based on the number of CPU cores. Default value -1 disables "
+       "sharing and each session creates its own thread pools."},
   {
     OPTION_TF_ADD_VGPU, "tf-add-vgpu",
         "Add a tensorflow virtual GPU instances on a physical GPU. Input "
@@ -400,6 +521,25 @@ SignalHandler(int signum)
   exit_cv_.notify_all();
 }
 
+void
+DrainSignalHandler(int signum)
+{
+  // Don't need a mutex here since signals should be disabled while in
+  // the handler.
+  std::cout << "Drain signal (" << signum << ") received." << std::endl;
+
+  // Do nothing if already draining or exiting...
+  if (draining_ || exiting_)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(exit_mu_);
+    draining_ = true;
+  }
+
+  exit_cv_.notify_all();
+}
+
 bool
 CheckPortCollision()
 {
@@ -475,8 +615,10 @@ StartGrpcServiceV2(
         shm_manager)
 {
   TRITONSERVER_Error* err = nvidia::inferenceserver::GRPCServerV2::Create(
-      server, trace_manager, shm_manager, grpc_port_,
-      grpc_infer_allocation_pool_size_, service);
+      server, trace_manager, shm_manager, grpc_port_, grpc_uds_path_,
+      grpc_infer_thread_cnt_, grpc_stream_infer_thread_cnt_,
+      grpc_infer_allocation_pool_size_,
+      grpc_infer_response_compression_level_, service);
   if (err == nullptr) {
     err = (*service)->Start();
   }
@@ -535,7 +677,7 @@ StartHttpV2Service(
   TRITONSERVER_Error* err =
       nvidia::inferenceserver::HTTPServerV2::CreateAPIServer(
           server, trace_manager, shm_manager, port_map, http_thread_cnt_,
-          services);
+          http_event_loop_cnt_, http_uds_path_, services);
   if (err == nullptr) {
     for (auto& http_eps : *services) {
       if (http_eps != nullptr) {
@@ -825,6 +967,26 @@ StartTracing(
         err = (*trace_manager)->SetLevel(trace_level_);
       }
     }
+    for (const auto& model_rate : trace_model_rates_) {
+      if (err != nullptr) {
+        break;
+      }
+      const auto delim = model_rate.rfind(':');
+      if (delim == std::string::npos) {
+        err = TRITONSERVER_ErrorNew(
+            TRITONSERVER_ERROR_INVALID_ARG,
+            std::string(
+                "--trace-model-rate option format is '<model name>:<rate>'. "
+                "Got " +
+                model_rate)
+                .c_str());
+        break;
+      }
+      err = (*trace_manager)
+                ->SetModelRate(
+                    model_rate.substr(0, delim),
+                    std::stoi(model_rate.substr(delim + 1)));
+    }
   }
 
   if (err != nullptr) {
@@ -901,6 +1063,34 @@ ParseDoubleOption(const std::string arg)
   return std::stod(arg);
 }
 
+#if defined(TRTIS_ENABLE_GRPC) || defined(TRTIS_ENABLE_GRPC_V2)
+grpc_compression_level
+ParseCompressionLevelOption(std::string arg)
+{
+  std::transform(arg.begin(), arg.end(), arg.begin(), [](unsigned char c) {
+    return std::tolower(c);
+  });
+
+  if (arg == "none") {
+    return GRPC_COMPRESS_LEVEL_NONE;
+  }
+  if (arg == "low") {
+    return GRPC_COMPRESS_LEVEL_LOW;
+  }
+  if (arg == "medium") {
+    return GRPC_COMPRESS_LEVEL_MED;
+  }
+  if (arg == "high") {
+    return GRPC_COMPRESS_LEVEL_HIGH;
+  }
+
+  std::cerr << "invalid value for compression level option: " << arg
+            << std::endl;
+  std::cerr << Usage() << std::endl;
+  exit(1);
+}
+#endif  // TRTIS_ENABLE_GRPC || TRTIS_ENABLE_GRPC_V2
+
 // Condition here merely to avoid compilation error, this function will
 // be defined but not used otherwise.
 #ifdef TRTIS_ENABLE_LOGGING
@@ -1044,9 +1234,15 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
   bool strict_readiness = true;
   bool tf_allow_soft_placement = true;
   float tf_gpu_memory_fraction = 0.0;
+  int tf_shared_thread_pool_size = -1;
   std::list<VgpuOption> tf_vgpus;
   std::list<std::pair<int, uint64_t>> cuda_pools;
   int32_t exit_timeout_secs = 30;
+  int64_t max_inflight_requests = 0;
+  int64_t max_inflight_byte_size = 0;
+  int32_t model_load_concurrency = 0;
+  std::vector<std::string> thread_affinities;
+  int64_t busy_wait_microseconds = 0;
   int32_t repository_poll_secs = repository_poll_secs_;
   int64_t pinned_memory_pool_byte_size = 1 << 28;
 
@@ -1059,6 +1255,8 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
 #if defined(TRTIS_ENABLE_HTTP) || defined(TRTIS_ENABLE_HTTP_V2)
   int32_t http_port = http_port_;
   int32_t http_thread_cnt = http_thread_cnt_;
+  int32_t http_event_loop_cnt = http_event_loop_cnt_;
+  std::string http_uds_path = http_uds_path_;
   int32_t http_health_port = http_port_;
 #endif  // TRTIS_ENABLE_HTTP || TRTIS_ENABLE_HTTP_V2
 
@@ -1067,6 +1265,9 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
   int32_t grpc_infer_thread_cnt = grpc_infer_thread_cnt_;
   int32_t grpc_stream_infer_thread_cnt = grpc_stream_infer_thread_cnt_;
   int32_t grpc_infer_allocation_pool_size = grpc_infer_allocation_pool_size_;
+  grpc_compression_level grpc_infer_response_compression_level =
+      grpc_infer_response_compression_level_;
+  std::string grpc_uds_path = grpc_uds_path_;
 #endif  // TRTIS_ENABLE_GRPC || TRTIS_ENABLE_GRPC_V2
 
 #if defined(TRTIS_ENABLE_HTTP) || defined(TRTIS_ENABLE_GRPC)
@@ -1084,6 +1285,7 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
   std::string trace_filepath = trace_filepath_;
   auto trace_level = trace_level_;
   int32_t trace_rate = trace_rate_;
+  std::vector<std::string> trace_model_rates = trace_model_rates_;
 #endif  // TRTIS_ENABLE_TRACING
 
   bool deprecated_control_mode_set = false;
@@ -1164,6 +1366,12 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
       case OPTION_HTTP_THREAD_COUNT:
         http_thread_cnt = ParseIntOption(optarg);
         break;
+      case OPTION_HTTP_EVENT_LOOP_COUNT:
+        http_event_loop_cnt = ParseIntOption(optarg);
+        break;
+      case OPTION_HTTP_UNIX_SOCKET:
+        http_uds_path = optarg;
+        break;
 #endif  // TRTIS_ENABLE_HTTP
 
 #if defined(TRTIS_ENABLE_GRPC) || defined(TRTIS_ENABLE_GRPC_V2)
@@ -1182,6 +1390,13 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
       case OPTION_GRPC_INFER_ALLOCATION_POOL_SIZE:
         grpc_infer_allocation_pool_size = ParseIntOption(optarg);
         break;
+      case OPTION_GRPC_INFER_RESPONSE_COMPRESSION_LEVEL:
+        grpc_infer_response_compression_level =
+            ParseCompressionLevelOption(optarg);
+        break;
+      case OPTION_GRPC_UNIX_SOCKET:
+        grpc_uds_path = optarg;
+        break;
 #endif  // TRTIS_ENABLE_GRPC || TRTIS_ENABLE_GRPC_V2
 
 #ifdef TRTIS_ENABLE_METRICS
@@ -1206,6 +1421,9 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
       case OPTION_TRACE_RATE:
         trace_rate = ParseIntOption(optarg);
         break;
+      case OPTION_TRACE_MODEL_RATE:
+        trace_model_rates.push_back(optarg);
+        break;
 #endif  // TRTIS_ENABLE_TRACING
 
       case OPTION_ALLOW_POLL_REPO:
@@ -1222,6 +1440,9 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
       case OPTION_STARTUP_MODEL:
         startup_models_.insert(optarg);
         break;
+      case OPTION_PREFETCH_MODEL_REPOSITORY:
+        prefetch_manifest_path_ = optarg;
+        break;
       case OPTION_MODEL_CONTROL_MODE: {
         std::string mode_str(optarg);
         std::transform(
@@ -1232,6 +1453,8 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
           control_mode = TRITONSERVER_MODEL_CONTROL_POLL;
         } else if (mode_str == "explicit") {
           control_mode = TRITONSERVER_MODEL_CONTROL_EXPLICIT;
+        } else if (mode_str == "lazy") {
+          control_mode = TRITONSERVER_MODEL_CONTROL_LAZY;
         } else {
           std::cerr << "invalid argument for --model-control-mode" << std::endl;
           std::cerr << Usage() << std::endl;
@@ -1252,6 +1475,21 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
       case OPTION_EXIT_TIMEOUT_SECS:
         exit_timeout_secs = ParseIntOption(optarg);
         break;
+      case OPTION_MAX_INFLIGHT_REQUESTS:
+        max_inflight_requests = ParseLongLongOption(optarg);
+        break;
+      case OPTION_MAX_INFLIGHT_BYTE_SIZE:
+        max_inflight_byte_size = ParseLongLongOption(optarg);
+        break;
+      case OPTION_MODEL_LOAD_CONCURRENCY:
+        model_load_concurrency = ParseIntOption(optarg);
+        break;
+      case OPTION_THREAD_AFFINITY:
+        thread_affinities.push_back(optarg);
+        break;
+      case OPTION_BUSY_WAIT_MICROSECONDS:
+        busy_wait_microseconds = ParseLongLongOption(optarg);
+        break;
 
       case OPTION_TF_ALLOW_SOFT_PLACEMENT:
         tf_allow_soft_placement = ParseBoolOption(optarg);
@@ -1259,6 +1497,9 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
       case OPTION_TF_GPU_MEMORY_FRACTION:
         tf_gpu_memory_fraction = ParseFloatOption(optarg);
         break;
+      case OPTION_TF_SHARED_THREAD_POOL_SIZE:
+        tf_shared_thread_pool_size = ParseIntOption(optarg);
+        break;
       case OPTION_TF_ADD_VGPU:
         tf_vgpus.push_back(ParseVGPUOption(optarg));
         break;
@@ -1281,6 +1522,51 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
   LOG_SET_VERBOSE(log_verbose);
 #endif  // TRTIS_ENABLE_LOGGING
 
+  // Configure the thread-pool CPU sets before any server threads are
+  // created. The binding itself is applied by each pool at thread
+  // creation.
+  for (const auto& affinity : thread_affinities) {
+    size_t delim = affinity.find(':');
+    if (delim == std::string::npos) {
+      std::cerr << "--thread-affinity option format is '<pool>:<cpus>'. Got "
+                << affinity << std::endl;
+      std::cerr << Usage() << std::endl;
+      return false;
+    }
+
+    const std::string pool_str = affinity.substr(0, delim);
+    const std::string cpus_str = affinity.substr(delim + 1);
+    nvidia::inferenceserver::AffinityPool pool;
+    if (pool_str == "http") {
+      pool = nvidia::inferenceserver::AffinityPool::HTTP_WORKER;
+    } else if (pool_str == "grpc") {
+      pool = nvidia::inferenceserver::AffinityPool::GRPC_POLLER;
+    } else if (pool_str == "scheduler") {
+      pool = nvidia::inferenceserver::AffinityPool::SCHEDULER;
+    } else {
+      std::cerr << "--thread-affinity pool must be 'http', 'grpc' or "
+                << "'scheduler'. Got " << pool_str << std::endl;
+      std::cerr << Usage() << std::endl;
+      return false;
+    }
+
+    auto status =
+        nvidia::inferenceserver::SetAffinityPoolCpus(pool, cpus_str);
+    if (!status.IsOk()) {
+      std::cerr << "invalid argument for --thread-affinity: "
+                << status.Message() << std::endl;
+      std::cerr << Usage() << std::endl;
+      return false;
+    }
+  }
+
+  if (busy_wait_microseconds < 0) {
+    std::cerr << "--busy-wait-microseconds must be >= 0" << std::endl;
+    std::cerr << Usage() << std::endl;
+    return false;
+  }
+  nvidia::inferenceserver::SetSpinWaitMicroseconds(busy_wait_microseconds);
+
   repository_poll_secs_ =
       (allow_poll_model_repository) ? std::max(0, repository_poll_secs) : 0;
 
@@ -1319,6 +1605,8 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
   http_port_ = http_port;
   http_health_port_ = http_health_port;
   http_thread_cnt_ = http_thread_cnt;
+  http_event_loop_cnt_ = http_event_loop_cnt;
+  http_uds_path_ = http_uds_path;
   if (api_version_ == 2) {
     http_ports_ = {http_health_port_, http_port_};
   } else {
@@ -1332,6 +1620,9 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
   grpc_infer_thread_cnt_ = grpc_infer_thread_cnt;
   grpc_stream_infer_thread_cnt_ = grpc_stream_infer_thread_cnt;
   grpc_infer_allocation_pool_size_ = grpc_infer_allocation_pool_size;
+  grpc_infer_response_compression_level_ =
+      grpc_infer_response_compression_level;
+  grpc_uds_path_ = grpc_uds_path;
 #endif  // TRTIS_ENABLE_GRPC || TRTIS_ENABLE_GRPC_V2
 
 #ifdef TRTIS_ENABLE_METRICS
@@ -1343,12 +1634,15 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
   trace_filepath_ = trace_filepath;
   trace_level_ = trace_level;
   trace_rate_ = trace_rate;
+  trace_model_rates_ = trace_model_rates;
 #endif  // TRTIS_ENABLE_TRACING
 
   // Check if HTTP, GRPC and metrics port clash
   if (CheckPortCollision())
     return false;
 
+  prefetch_repository_paths_ = model_repository_paths;
+
   // Highly duplicated code conditioned by api_version,
   // just remove the api_version 1 case when dropping TRTSERVER API
   if (api_version == 1) {
@@ -1380,6 +1674,9 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
       case TRITONSERVER_MODEL_CONTROL_POLL:
         trt_control_mode = TRTSERVER_MODEL_CONTROL_POLL;
         break;
+      case TRITONSERVER_MODEL_CONTROL_LAZY:
+        trt_control_mode = TRTSERVER_MODEL_CONTROL_LAZY;
+        break;
       case TRITONSERVER_MODEL_CONTROL_NONE:
       default:
         trt_control_mode = TRTSERVER_MODEL_CONTROL_NONE;
@@ -1421,6 +1718,18 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
         TRTSERVER_ServerOptionsSetExitTimeout(
             loptions, std::max(0, exit_timeout_secs)),
         "setting exit timeout");
+    FAIL_IF_ERR(
+        TRTSERVER_ServerOptionsSetMaxInflightRequests(
+            loptions, std::max((int64_t)0, max_inflight_requests)),
+        "setting maximum in-flight requests");
+    FAIL_IF_ERR(
+        TRTSERVER_ServerOptionsSetMaxInflightByteSize(
+            loptions, std::max((int64_t)0, max_inflight_byte_size)),
+        "setting maximum in-flight byte size");
+    FAIL_IF_ERR(
+        TRTSERVER_ServerOptionsSetModelLoadConcurrency(
+            loptions, std::max(0, model_load_concurrency)),
+        "setting model load concurrency");
 
 #ifdef TRTIS_ENABLE_LOGGING
     FAIL_IF_ERR(
@@ -1454,6 +1763,10 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
         TRTSERVER_ServerOptionsSetTensorFlowGpuMemoryFraction(
             loptions, tf_gpu_memory_fraction),
         "setting tensorflow GPU memory fraction");
+    FAIL_IF_ERR(
+        TRTSERVER_ServerOptionsSetTensorFlowSharedThreadPoolSize(
+            loptions, tf_shared_thread_pool_size),
+        "setting tensorflow shared thread pool size");
     for (const auto& tf_vgpu : tf_vgpus) {
       FAIL_IF_ERR(
           TRTSERVER_ServerOptionsAddTensorFlowVgpuMemoryLimits(
@@ -1512,6 +1825,18 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
         TRITONSERVER_ServerOptionsSetExitTimeout(
             loptions, std::max(0, exit_timeout_secs)),
         "setting exit timeout");
+    FAIL_IF_TRITON_ERR(
+        TRITONSERVER_ServerOptionsSetMaxInflightRequests(
+            loptions, std::max((int64_t)0, max_inflight_requests)),
+        "setting maximum in-flight requests");
+    FAIL_IF_TRITON_ERR(
+        TRITONSERVER_ServerOptionsSetMaxInflightByteSize(
+            loptions, std::max((int64_t)0, max_inflight_byte_size)),
+        "setting maximum in-flight byte size");
+    FAIL_IF_TRITON_ERR(
+        TRITONSERVER_ServerOptionsSetModelLoadConcurrency(
+            loptions, std::max(0, model_load_concurrency)),
+        "setting model load concurrency");
 
 #ifdef TRTIS_ENABLE_LOGGING
     FAIL_IF_TRITON_ERR(
@@ -1545,6 +1870,10 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
         TRITONSERVER_ServerOptionsSetTensorFlowGpuMemoryFraction(
             loptions, tf_gpu_memory_fraction),
         "setting tensorflow GPU memory fraction");
+    FAIL_IF_TRITON_ERR(
+        TRITONSERVER_ServerOptionsSetTensorFlowSharedThreadPoolSize(
+            loptions, tf_shared_thread_pool_size),
+        "setting tensorflow shared thread pool size");
     for (const auto& tf_vgpu : tf_vgpus) {
       FAIL_IF_TRITON_ERR(
           TRITONSERVER_ServerOptionsAddTensorFlowVgpuMemoryLimits(
@@ -1555,6 +1884,216 @@ Parse(TRITONSERVER_ServerOptions** server_options, int argc, char** argv)
   }
   return true;
 }
+
+// A unit of prefetch work: one model version directory, or a model's
+// top-level files for an item with an empty version.
+struct PrefetchItem {
+  std::string model_name_;
+  std::string version_;
+  std::string path_;
+};
+
+// Hash recorded in the prefetch manifest for each file: FNV-1a over
+// the file contents.
+uint64_t
+PrefetchContentHash(const std::string& contents)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char c : contents) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Build the list of directories to prefetch by walking the model
+// repositories.
+nvidia::inferenceserver::Status
+DiscoverPrefetchItems(std::vector<PrefetchItem>* items)
+{
+  for (const auto& repository_path : prefetch_repository_paths_) {
+    std::set<std::string> models;
+    RETURN_IF_ERROR(
+        nvidia::inferenceserver::GetDirectorySubdirs(repository_path, &models));
+    for (const auto& model_name : models) {
+      const auto model_path =
+          nvidia::inferenceserver::JoinPath({repository_path, model_name});
+
+      // The model's top-level files (model configuration, labels...).
+      items->push_back(PrefetchItem{model_name, "", model_path});
+
+      std::set<std::string> versions;
+      RETURN_IF_ERROR(
+          nvidia::inferenceserver::GetDirectorySubdirs(model_path, &versions));
+      for (const auto& version : versions) {
+        items->push_back(PrefetchItem{
+            model_name, version,
+            nvidia::inferenceserver::JoinPath({model_path, version})});
+      }
+    }
+  }
+
+  return nvidia::inferenceserver::Status::Success;
+}
+
+// Build the list of directories to prefetch from the manifest written
+// by a previous prefetch run, so a new node doesn't pay the serial
+// repository discovery round-trips. Return false if the manifest
+// can't be used.
+bool
+PrefetchItemsFromManifest(std::vector<PrefetchItem>* items)
+{
+  bool exists = false;
+  if (!nvidia::inferenceserver::FileExists(prefetch_manifest_path_, &exists)
+           .IsOk() ||
+      !exists) {
+    return false;
+  }
+
+  std::string manifest;
+  if (!nvidia::inferenceserver::ReadTextFile(prefetch_manifest_path_, &manifest)
+           .IsOk()) {
+    return false;
+  }
+
+  std::set<std::string> seen_paths;
+  std::istringstream lines(manifest);
+  std::string line;
+  while (std::getline(lines, line)) {
+    // model <tab> version <tab> file <tab> byte size <tab> hash
+    // <tab> directory path
+    std::vector<std::string> fields;
+    size_t pos = 0;
+    while (pos <= line.size()) {
+      const size_t tab = line.find('\t', pos);
+      if (tab == std::string::npos) {
+        fields.push_back(line.substr(pos));
+        break;
+      }
+      fields.push_back(line.substr(pos, tab - pos));
+      pos = tab + 1;
+    }
+
+    if (fields.size() != 6) {
+      return false;
+    }
+
+    if (seen_paths.emplace(fields[5]).second) {
+      items->push_back(PrefetchItem{fields[0], fields[1], fields[5]});
+    }
+  }
+
+  return !items->empty();
+}
+
+// Download the model repositories into the local download cache with
+// full parallelism and write the prefetch manifest. Run in place of
+// the server, before any device initialization, so a pre-start hook
+// can overlap the downloads with the bring-up of the server process
+// proper.
+bool
+PrefetchModelRepository()
+{
+  std::vector<PrefetchItem> items;
+  if (PrefetchItemsFromManifest(&items)) {
+    LOG_INFO << "Prefetching " << items.size()
+             << " model directories from manifest " << prefetch_manifest_path_;
+  } else {
+    items.clear();
+    auto status = DiscoverPrefetchItems(&items);
+    if (!status.IsOk()) {
+      LOG_ERROR << "Failed to discover model repository contents: "
+                << status.Message();
+      return false;
+    }
+    LOG_INFO << "Prefetching " << items.size() << " model directories";
+  }
+
+  const size_t worker_cnt = std::max(
+      size_t(1),
+      std::min(items.size(), size_t(std::thread::hardware_concurrency())));
+
+  std::atomic<size_t> next_item(0);
+  std::atomic<bool> success(true);
+  std::mutex manifest_mu;
+  std::string manifest;
+
+  std::vector<std::thread> workers;
+  for (size_t w = 0; w < worker_cnt; w++) {
+    workers.emplace_back([&items, &next_item, &success, &manifest_mu,
+                          &manifest]() {
+      while (true) {
+        const size_t idx = next_item++;
+        if (idx >= items.size()) {
+          return;
+        }
+
+        const PrefetchItem& item = items[idx];
+        std::string local_path;
+        auto status = nvidia::inferenceserver::DownloadFileFolder(
+            item.path_, &local_path);
+        if (!status.IsOk()) {
+          LOG_ERROR << "Failed to prefetch " << item.path_ << ": "
+                    << status.Message();
+          success = false;
+          continue;
+        }
+
+        std::set<std::string> files;
+        status = nvidia::inferenceserver::GetDirectoryFiles(
+            local_path, true /* skip_hidden_files */, &files);
+
+        std::string entries;
+        for (const auto& file : files) {
+          if (!status.IsOk()) {
+            break;
+          }
+
+          std::string contents;
+          status = nvidia::inferenceserver::ReadTextFile(
+              nvidia::inferenceserver::JoinPath({local_path, file}), &contents);
+          if (status.IsOk()) {
+            entries += item.model_name_ + "\t" + item.version_ + "\t" + file +
+                       "\t" + std::to_string(contents.size()) + "\t" +
+                       std::to_string(PrefetchContentHash(contents)) + "\t" +
+                       item.path_ + "\n";
+          }
+        }
+
+        if (local_path != item.path_) {
+          nvidia::inferenceserver::DestroyFileFolder(local_path);
+        }
+
+        if (!status.IsOk()) {
+          LOG_ERROR << "Failed to prefetch " << item.path_ << ": "
+                    << status.Message();
+          success = false;
+          continue;
+        }
+
+        std::lock_guard<std::mutex> lock(manifest_mu);
+        manifest += entries;
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  if (success) {
+    auto status = nvidia::inferenceserver::WriteTextFile(
+        prefetch_manifest_path_, manifest);
+    if (!status.IsOk()) {
+      LOG_ERROR << "Failed to write prefetch manifest "
+                << prefetch_manifest_path_ << ": " << status.Message();
+      return false;
+    }
+  }
+
+  return success;
+}
+
 }  // namespace
 
 int
@@ -1569,6 +2108,14 @@ main(int argc, char** argv)
     exit(1);
   }
 
+  // If requested, run the model-repository prefetch phase in place of
+  // the server. This happens before any CUDA initialization so that a
+  // pre-start hook on a new node can overlap the model downloads with
+  // the device bring-up of the server process proper.
+  if (!prefetch_manifest_path_.empty()) {
+    exit(PrefetchModelRepository() ? 0 : 1);
+  }
+
   // Trace manager.
   std::shared_ptr<nvidia::inferenceserver::TraceManager> trace_manager;
 
@@ -1618,12 +2165,24 @@ main(int argc, char** argv)
     exit(1);
   }
 
-  // Trap SIGINT and SIGTERM to allow server to exit gracefully
+  // Trap SIGINT and SIGTERM to allow server to exit gracefully. Trap
+  // SIGUSR1 to drain the server before exiting: readiness fails and
+  // new requests are rejected while in-flight requests complete, so a
+  // load balancer can roll the node without client-visible errors.
   signal(SIGINT, SignalHandler);
   signal(SIGTERM, SignalHandler);
+  signal(SIGUSR1, DrainSignalHandler);
 
   // Wait until a signal terminates the server...
   while (!exiting_) {
+    if (draining_) {
+      // Wait for in-flight requests to complete (bounded by the exit
+      // timeout), then fall through to the normal exit path below.
+      LOG_TRITONSERVER_ERROR(
+          TRITONSERVER_ServerDrain(server_ptr), "failed to drain server");
+      break;
+    }
+
     // If enabled, poll the model repository to see if there have been
     // any changes.
     if (repository_poll_secs_ > 0) {
@@ -35,13 +35,25 @@
 
 namespace nvidia { namespace inferenceserver {
 
+#ifdef TRTIS_ENABLE_GPU
+constexpr size_t SharedMemoryManager::kCudaIpcIdleCacheLimit;
+constexpr size_t SharedMemoryManager::kHostRegistrationIdleCacheLimit;
+#endif  // TRTIS_ENABLE_GPU
+
 namespace {
 
 TRITONSERVER_Error*
 OpenSharedMemoryRegion(const std::string& shm_key, int* shm_fd)
 {
-  // get shared memory region descriptor
-  *shm_fd = shm_open(shm_key.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  // A key with a path component beyond the leading slash names a
+  // file, typically in a mounted hugetlbfs so that the mapping is
+  // backed by huge pages. Otherwise the key names a posix shared
+  // memory object.
+  if (shm_key.find('/', 1) != std::string::npos) {
+    *shm_fd = open(shm_key.c_str(), O_RDWR);
+  } else {
+    *shm_fd = shm_open(shm_key.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  }
   if (*shm_fd == -1) {
     LOG_VERBOSE(1) << "shm_open failed, errno: " << errno;
     return TRITONSERVER_ErrorNew(
@@ -124,6 +136,56 @@ OpenCudaIPCRegion(
 
   return nullptr;
 }
+
+std::string
+CudaIpcCacheKey(const cudaIpcMemHandle_t* cuda_shm_handle, const int device_id)
+{
+  std::string key(
+      reinterpret_cast<const char*>(cuda_shm_handle), sizeof(*cuda_shm_handle));
+  key.append(reinterpret_cast<const char*>(&device_id), sizeof(device_id));
+  return key;
+}
+
+std::string
+HostRegistrationKey(
+    const std::string& shm_key, const size_t offset, const size_t byte_size)
+{
+  std::string key = shm_key;
+  key.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+  key.append(reinterpret_cast<const char*>(&byte_size), sizeof(byte_size));
+  return key;
+}
+
+// Register a system shared memory mapping with CUDA so that copies
+// between the region and GPU memory run at pinned speed instead of
+// pageable speed. The mapped address is page aligned since it comes
+// from mmap, and the registered length is rounded up to whole pages
+// to satisfy the alignment requirements of cudaHostRegister. Return
+// false if the mapping could not be registered; that is not an error,
+// the region simply stays pageable (e.g. no CUDA device is available,
+// or the mapping is backed by a file CUDA can't pin).
+bool
+CudaHostRegister(void* mapped_addr, const size_t byte_size)
+{
+  int device_cnt = 0;
+  cudaError_t cuerr = cudaGetDeviceCount(&device_cnt);
+  if ((cuerr != cudaSuccess) || (device_cnt == 0)) {
+    return false;
+  }
+
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  const size_t register_byte_size =
+      ((byte_size + page_size - 1) / page_size) * page_size;
+  cuerr = cudaHostRegister(
+      mapped_addr, register_byte_size, cudaHostRegisterDefault);
+  if (cuerr != cudaSuccess) {
+    LOG_VERBOSE(1) << "unable to cudaHostRegister shared memory mapping: "
+                   << cudaGetErrorString(cuerr);
+    return false;
+  }
+
+  return true;
+}
 #endif  // TRTIS_ENABLE_GPU
 
 }  // namespace
@@ -136,6 +198,23 @@ SharedMemoryManager::~SharedMemoryManager()
   // UnregisterAll(TRITONSERVER_MEMORY_CPU);
   // UnregisterAll(TRITONSERVER_MEMORY_GPU);
 #endif  // TRTIS_ENABLE_GRPC_V2 || TRTIS_ENABLE_HTTP_V2
+
+#ifdef TRTIS_ENABLE_GPU
+  // Close any CUDA IPC mappings and host registrations kept for
+  // reuse.
+  std::lock_guard<std::mutex> lock(mu_);
+  TRITONSERVER_Error* err = CloseIdleCudaIpcMappings(0);
+  if (err != nullptr) {
+    LOG_ERROR << TRITONSERVER_ErrorMessage(err);
+    TRITONSERVER_ErrorDelete(err);
+  }
+
+  err = CloseIdleHostRegistrations(0);
+  if (err != nullptr) {
+    LOG_ERROR << TRITONSERVER_ErrorMessage(err);
+    TRITONSERVER_ErrorDelete(err);
+  }
+#endif  // TRTIS_ENABLE_GPU
 }
 
 TRITONSERVER_Error*
@@ -156,6 +235,25 @@ SharedMemoryManager::RegisterSystemSharedMemory(
   void* mapped_addr;
   int shm_fd = -1;
 
+#ifdef TRTIS_ENABLE_GPU
+  // Reuse a cached host-registered mapping of the same region if one
+  // exists, avoiding the mmap and the per-page cudaHostRegister cost
+  // for clients that register/unregister regions per session.
+  const std::string reg_key = HostRegistrationKey(shm_key, offset, byte_size);
+  auto reg_it = host_registration_cache_.find(reg_key);
+  if (reg_it != host_registration_cache_.end()) {
+    reg_it->second.use_count_++;
+
+    std::unique_ptr<SharedMemoryInfo> shm_info(new SharedMemoryInfo(
+        name, shm_key, offset, byte_size, -1, reg_it->second.mapped_addr_,
+        TRITONSERVER_MEMORY_CPU, 0));
+    shm_info->host_registration_key_ = reg_key;
+    shared_memory_map_.insert(std::make_pair(name, std::move(shm_info)));
+
+    return nullptr;  // success
+  }
+#endif  // TRTIS_ENABLE_GPU
+
   // don't re-open if shared memory is already open
   for (auto itr = shared_memory_map_.begin(); itr != shared_memory_map_.end();
        ++itr) {
@@ -192,10 +290,26 @@ SharedMemoryManager::RegisterSystemSharedMemory(
             .c_str());
   }
 
-  shared_memory_map_.insert(std::make_pair(
-      name, std::unique_ptr<SharedMemoryInfo>(new SharedMemoryInfo(
-                name, shm_key, offset, byte_size, shm_fd, mapped_addr,
-                TRITONSERVER_MEMORY_CPU, 0))));
+  std::unique_ptr<SharedMemoryInfo> shm_info(new SharedMemoryInfo(
+      name, shm_key, offset, byte_size, shm_fd, mapped_addr,
+      TRITONSERVER_MEMORY_CPU, 0));
+
+#ifdef TRTIS_ENABLE_GPU
+  // Pin the mapping so that copies between the region and GPU memory
+  // don't run at pageable speed. The mapping is cached even when
+  // registration fails so that re-registration doesn't retry the
+  // failing cudaHostRegister call every time.
+  HostRegistration registration;
+  registration.mapped_addr_ = mapped_addr;
+  registration.byte_size_ = byte_size;
+  registration.registered_ = CudaHostRegister(mapped_addr, byte_size);
+  registration.use_count_ = 1;
+  registration.last_use_ = ++host_registration_lru_clock_;
+  host_registration_cache_.insert(std::make_pair(reg_key, registration));
+  shm_info->host_registration_key_ = reg_key;
+#endif  // TRTIS_ENABLE_GPU
+
+  shared_memory_map_.insert(std::make_pair(name, std::move(shm_info)));
 
   return nullptr;  // success
 }
@@ -209,6 +323,17 @@ SharedMemoryManager::RegisterCUDASharedMemory(
   // Serialize all operations that write/read current shared memory regions
   std::lock_guard<std::mutex> lock(mu_);
 
+  return RegisterCUDASharedMemoryHelper(
+      name, cuda_shm_handle, byte_size, device_id);
+}
+
+TRITONSERVER_Error*
+SharedMemoryManager::RegisterCUDASharedMemoryHelper(
+    const std::string& name, const cudaIpcMemHandle_t* cuda_shm_handle,
+    const size_t byte_size, const int device_id)
+{
+  // Must hold the lock on 'mu_' while calling this function.
+
   // If name is already in shared_memory_map_ then return error saying already
   // registered
   if (shared_memory_map_.find(name) != shared_memory_map_.end()) {
@@ -221,23 +346,248 @@ SharedMemoryManager::RegisterCUDASharedMemory(
   // register
   void* mapped_addr;
 
-  // Get CUDA shared memory base address
-  TRITONSERVER_Error* err =
-      OpenCudaIPCRegion(cuda_shm_handle, &mapped_addr, device_id);
-  if (err != nullptr) {
+  // Reuse a cached mapping of the same handle if one exists,
+  // avoiding the device-synchronizing cudaIpcOpenMemHandle call for
+  // clients that register/unregister regions per session.
+  const std::string ipc_key = CudaIpcCacheKey(cuda_shm_handle, device_id);
+  auto cache_it = cuda_ipc_cache_.find(ipc_key);
+  if (cache_it != cuda_ipc_cache_.end()) {
+    mapped_addr = cache_it->second.mapped_addr_;
+    cache_it->second.use_count_++;
+  } else {
+    // Get CUDA shared memory base address
+    TRITONSERVER_Error* err =
+        OpenCudaIPCRegion(cuda_shm_handle, &mapped_addr, device_id);
+    if (err != nullptr) {
+      return TRITONSERVER_ErrorNew(
+          TRITONSERVER_ERROR_INVALID_ARG,
+          std::string(
+              "failed to register CUDA shared memory region '" + name + "'")
+              .c_str());
+    }
+
+    CudaIpcMapping mapping;
+    mapping.mapped_addr_ = mapped_addr;
+    mapping.use_count_ = 1;
+    mapping.last_use_ = ++cuda_ipc_lru_clock_;
+    cuda_ipc_cache_.insert(std::make_pair(ipc_key, mapping));
+  }
+
+  std::unique_ptr<SharedMemoryInfo> shm_info(new SharedMemoryInfo(
+      name, "", 0, byte_size, 0, mapped_addr, TRITONSERVER_MEMORY_GPU,
+      device_id));
+  shm_info->cuda_ipc_key_ = ipc_key;
+  shared_memory_map_.insert(std::make_pair(name, std::move(shm_info)));
+
+  return nullptr;  // success
+}
+
+#ifdef TRTIS_ENABLE_GRPC_V2
+TRITONSERVER_Error*
+SharedMemoryManager::RegisterCUDASharedMemoryBatch(
+    const CudaSharedMemoryBatchRegisterRequest& request)
+{
+  // Serialize all operations that write/read current shared memory
+  // regions. The entire batch is handled under a single lock
+  // acquisition so that registering N regions doesn't pay N
+  // lock/unlock round trips.
+  std::lock_guard<std::mutex> lock(mu_);
+
+  for (int ridx = 0; ridx < request.regions_size(); ++ridx) {
+    const auto& region = request.regions(ridx);
+    TRITONSERVER_Error* err = RegisterCUDASharedMemoryHelper(
+        region.name(),
+        reinterpret_cast<const cudaIpcMemHandle_t*>(
+            region.raw_handle().c_str()),
+        region.byte_size(), region.device_id());
+    if (err != nullptr) {
+      // Make the batch all-or-nothing... unregister the regions that
+      // were registered earlier in this batch. Failure to roll back
+      // is logged but the original error is what is returned.
+      for (int uidx = 0; uidx < ridx; ++uidx) {
+        TRITONSERVER_Error* unreg_err = UnregisterHelper(
+            request.regions(uidx).name(), TRITONSERVER_MEMORY_GPU);
+        if (unreg_err != nullptr) {
+          LOG_ERROR << "failed to unregister CUDA shared memory region '"
+                    << request.regions(uidx).name()
+                    << "' while rolling back batch register: "
+                    << TRITONSERVER_ErrorMessage(unreg_err);
+          TRITONSERVER_ErrorDelete(unreg_err);
+        }
+      }
+
+      return err;
+    }
+  }
+
+  return nullptr;  // success
+}
+
+TRITONSERVER_Error*
+SharedMemoryManager::UnregisterCUDASharedMemoryBatch(
+    const CudaSharedMemoryBatchUnregisterRequest& request)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+
+  std::string error_message =
+      "Failed to unregister the following cuda shared memory regions: ";
+  std::vector<std::string> unregister_fails;
+  for (const auto& name : request.names()) {
+    TRITONSERVER_Error* err =
+        UnregisterHelper(name, TRITONSERVER_MEMORY_GPU);
+    if (err != nullptr) {
+      unregister_fails.push_back(name);
+      TRITONSERVER_ErrorDelete(err);
+    }
+  }
+
+  if (!unregister_fails.empty()) {
+    for (auto unreg_fail : unregister_fails) {
+      error_message += unreg_fail + " ,";
+    }
+    LOG_ERROR << error_message;
     return TRITONSERVER_ErrorNew(
-        TRITONSERVER_ERROR_INVALID_ARG,
+        TRITONSERVER_ERROR_INTERNAL, error_message.c_str());
+  }
+
+  return nullptr;
+}
+#endif  // TRTIS_ENABLE_GRPC_V2
+
+TRITONSERVER_Error*
+SharedMemoryManager::ReleaseCudaIpcMapping(
+    const std::string& ipc_key, void* mapped_addr)
+{
+  // Must hold the lock on 'mu_' while calling this function.
+  auto it = cuda_ipc_cache_.find(ipc_key);
+  if (it != cuda_ipc_cache_.end()) {
+    if (--it->second.use_count_ == 0) {
+      // Defer the close... keep the mapping open so that a later
+      // registration of the same handle reuses it, but don't let
+      // idle mappings accumulate without bound.
+      it->second.last_use_ = ++cuda_ipc_lru_clock_;
+      return CloseIdleCudaIpcMappings(kCudaIpcIdleCacheLimit);
+    }
+
+    return nullptr;
+  }
+
+  // Not in the cache... close the handle directly.
+  cudaError_t err = cudaIpcCloseMemHandle(mapped_addr);
+  if (err != cudaSuccess) {
+    return TRITONSERVER_ErrorNew(
+        TRITONSERVER_ERROR_INTERNAL,
         std::string(
-            "failed to register CUDA shared memory region '" + name + "'")
+            "failed to close CUDA IPC handle: " +
+            std::string(cudaGetErrorString(err)))
             .c_str());
   }
 
-  shared_memory_map_.insert(std::make_pair(
-      name, std::unique_ptr<SharedMemoryInfo>(new SharedMemoryInfo(
-                name, "", 0, byte_size, 0, mapped_addr, TRITONSERVER_MEMORY_GPU,
-                device_id))));
+  return nullptr;
+}
 
-  return nullptr;  // success
+TRITONSERVER_Error*
+SharedMemoryManager::CloseIdleCudaIpcMappings(const size_t max_idle)
+{
+  // Must hold the lock on 'mu_' while calling this function.
+  size_t idle_cnt = 0;
+  for (const auto& mapping : cuda_ipc_cache_) {
+    if (mapping.second.use_count_ == 0) {
+      idle_cnt++;
+    }
+  }
+
+  while (idle_cnt > max_idle) {
+    auto oldest = cuda_ipc_cache_.end();
+    for (auto it = cuda_ipc_cache_.begin(); it != cuda_ipc_cache_.end(); ++it) {
+      if ((it->second.use_count_ == 0) &&
+          ((oldest == cuda_ipc_cache_.end()) ||
+           (it->second.last_use_ < oldest->second.last_use_))) {
+        oldest = it;
+      }
+    }
+
+    cudaError_t err = cudaIpcCloseMemHandle(oldest->second.mapped_addr_);
+    if (err != cudaSuccess) {
+      return TRITONSERVER_ErrorNew(
+          TRITONSERVER_ERROR_INTERNAL,
+          std::string(
+              "failed to close CUDA IPC handle: " +
+              std::string(cudaGetErrorString(err)))
+              .c_str());
+    }
+
+    cuda_ipc_cache_.erase(oldest);
+    idle_cnt--;
+  }
+
+  return nullptr;
+}
+
+TRITONSERVER_Error*
+SharedMemoryManager::ReleaseHostRegistration(
+    const std::string& reg_key, void* mapped_addr, const size_t byte_size)
+{
+  // Must hold the lock on 'mu_' while calling this function.
+  auto it = host_registration_cache_.find(reg_key);
+  if (it != host_registration_cache_.end()) {
+    if (--it->second.use_count_ == 0) {
+      // Defer the teardown... keep the mapping registered so that a
+      // later registration of the same region reuses it, but don't
+      // let idle registrations accumulate without bound.
+      it->second.last_use_ = ++host_registration_lru_clock_;
+      return CloseIdleHostRegistrations(kHostRegistrationIdleCacheLimit);
+    }
+
+    return nullptr;
+  }
+
+  // Not in the cache... unmap directly.
+  return UnmapSharedMemory(mapped_addr, byte_size);
+}
+
+TRITONSERVER_Error*
+SharedMemoryManager::CloseIdleHostRegistrations(const size_t max_idle)
+{
+  // Must hold the lock on 'mu_' while calling this function.
+  size_t idle_cnt = 0;
+  for (const auto& registration : host_registration_cache_) {
+    if (registration.second.use_count_ == 0) {
+      idle_cnt++;
+    }
+  }
+
+  while (idle_cnt > max_idle) {
+    auto oldest = host_registration_cache_.end();
+    for (auto it = host_registration_cache_.begin();
+         it != host_registration_cache_.end(); ++it) {
+      if ((it->second.use_count_ == 0) &&
+          ((oldest == host_registration_cache_.end()) ||
+           (it->second.last_use_ < oldest->second.last_use_))) {
+        oldest = it;
+      }
+    }
+
+    if (oldest->second.registered_) {
+      cudaError_t cuerr = cudaHostUnregister(oldest->second.mapped_addr_);
+      if (cuerr != cudaSuccess) {
+        return TRITONSERVER_ErrorNew(
+            TRITONSERVER_ERROR_INTERNAL,
+            std::string(
+                "failed to cudaHostUnregister shared memory mapping: " +
+                std::string(cudaGetErrorString(cuerr)))
+                .c_str());
+      }
+    }
+
+    RETURN_IF_TRITON_ERR(UnmapSharedMemory(
+        oldest->second.mapped_addr_, oldest->second.byte_size_));
+
+    host_registration_cache_.erase(oldest);
+    idle_cnt--;
+  }
+
+  return nullptr;
 }
 #endif  // TRTIS_ENABLE_GPU
 
@@ -266,6 +616,45 @@ SharedMemoryManager::GetMemoryInfo(
   return nullptr;
 }
 
+TRITONSERVER_Error*
+SharedMemoryManager::AutoReserve(
+    const size_t byte_size, std::string* region_name, size_t* offset,
+    void** base)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+
+  for (auto& shm_info : shared_memory_map_) {
+    SharedMemoryInfo* info = shm_info.second.get();
+    if ((info->kind_ != TRITONSERVER_MEMORY_CPU) ||
+        (info->byte_size_ < byte_size)) {
+      continue;
+    }
+
+    // Wrap the cursor when the remaining space can't hold the block.
+    if ((info->auto_cursor_ + byte_size) > info->byte_size_) {
+      info->auto_cursor_ = 0;
+    }
+
+    *region_name = info->name_;
+    *offset = info->auto_cursor_;
+    *base = (void*)((uint8_t*)info->mapped_addr_ + info->offset_ +
+                    info->auto_cursor_);
+
+    // Keep the blocks cache-line aligned.
+    info->auto_cursor_ += (byte_size + 63) & ~((size_t)63);
+
+    return nullptr;  // success
+  }
+
+  return TRITONSERVER_ErrorNew(
+      TRITONSERVER_ERROR_NOT_FOUND,
+      std::string(
+          "no system shared memory region large enough for automatic "
+          "placement of " +
+          std::to_string(byte_size) + " bytes")
+          .c_str());
+}
+
 TRITONSERVER_Error*
 SharedMemoryManager::GetStatus(SharedMemoryStatus* shm_status)
 {
@@ -336,19 +725,18 @@ SharedMemoryManager::UnregisterHelper(const std::string& name)
   auto it = shared_memory_map_.find(name);
   if (it != shared_memory_map_.end()) {
     if (it->second->kind_ == TRITONSERVER_MEMORY_CPU) {
+#ifdef TRTIS_ENABLE_GPU
+      RETURN_IF_TRITON_ERR(ReleaseHostRegistration(
+          it->second->host_registration_key_, it->second->mapped_addr_,
+          it->second->byte_size_));
+#else
       RETURN_IF_TRITON_ERR(
           UnmapSharedMemory(it->second->mapped_addr_, it->second->byte_size_));
+#endif  // TRTIS_ENABLE_GPU
     } else {
 #ifdef TRTIS_ENABLE_GPU
-      cudaError_t err = cudaIpcCloseMemHandle(it->second->mapped_addr_);
-      if (err != cudaSuccess) {
-        return TRITONSERVER_ErrorNew(
-            TRITONSERVER_ERROR_INTERNAL,
-            std::string(
-                "failed to close CUDA IPC handle: " +
-                std::string(cudaGetErrorString(err)))
-                .c_str());
-      }
+      RETURN_IF_TRITON_ERR(ReleaseCudaIpcMapping(
+          it->second->cuda_ipc_key_, it->second->mapped_addr_));
 #else
       return TRITONSERVER_ErrorNew(
           TRITONSERVER_ERROR_INVALID_ARG,
@@ -622,19 +1010,18 @@ SharedMemoryManager::UnregisterHelper(
   auto it = shared_memory_map_.find(name);
   if (it != shared_memory_map_.end() && it->second->kind_ == memory_type) {
     if (it->second->kind_ == TRITONSERVER_MEMORY_CPU) {
+#ifdef TRTIS_ENABLE_GPU
+      RETURN_IF_TRITON_ERR(ReleaseHostRegistration(
+          it->second->host_registration_key_, it->second->mapped_addr_,
+          it->second->byte_size_));
+#else
       RETURN_IF_TRITON_ERR(
           UnmapSharedMemory(it->second->mapped_addr_, it->second->byte_size_));
+#endif  // TRTIS_ENABLE_GPU
     } else {
 #ifdef TRTIS_ENABLE_GPU
-      cudaError_t err = cudaIpcCloseMemHandle(it->second->mapped_addr_);
-      if (err != cudaSuccess) {
-        return TRITONSERVER_ErrorNew(
-            TRITONSERVER_ERROR_INTERNAL,
-            std::string(
-                "failed to close CUDA IPC handle: " +
-                std::string(cudaGetErrorString(err)))
-                .c_str());
-      }
+      RETURN_IF_TRITON_ERR(ReleaseCudaIpcMapping(
+          it->second->cuda_ipc_key_, it->second->mapped_addr_));
 #else
       return TRITONSERVER_ErrorNew(
           TRITONSERVER_ERROR_INVALID_ARG,
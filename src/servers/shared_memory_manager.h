@@ -74,6 +74,25 @@ class SharedMemoryManager {
   TRITONSERVER_Error* RegisterCUDASharedMemory(
       const std::string& name, const cudaIpcMemHandle_t* cuda_shm_handle,
       const size_t byte_size, const int device_id);
+
+#ifdef TRTIS_ENABLE_GRPC_V2
+  /// Add a batch of CUDA shared memory blocks to the manager. All
+  /// handles are opened under a single lock acquisition. If any
+  /// region fails to register, the regions registered earlier in the
+  /// batch are unregistered so that either all regions in the batch
+  /// are registered or none are.
+  /// \param request The batch of regions to register.
+  /// \return a TRITONSERVER_Error indicating success or failure.
+  TRITONSERVER_Error* RegisterCUDASharedMemoryBatch(
+      const CudaSharedMemoryBatchRegisterRequest& request);
+
+  /// Remove a batch of named CUDA shared memory blocks from the
+  /// manager under a single lock acquisition.
+  /// \param request The names of the regions to unregister.
+  /// \return a TRITONSERVER_Error indicating success or failure.
+  TRITONSERVER_Error* UnregisterCUDASharedMemoryBatch(
+      const CudaSharedMemoryBatchUnregisterRequest& request);
+#endif  // TRTIS_ENABLE_GRPC_V2
 #endif  // TRTIS_ENABLE_GPU
 
   /// Get the access information for the shared memory block
@@ -91,6 +110,22 @@ class SharedMemoryManager {
       const std::string& name, size_t offset, void** shm_mapped_addr,
       TRITONSERVER_Memory_Type* memory_type, int64_t* device_id);
 
+  /// Reserve a block of 'byte_size' bytes from any registered system
+  /// (CPU) shared memory region for automatic output placement.
+  /// Offsets are handed out from a per-region cursor that wraps
+  /// around when the region is exhausted, so a client must consume a
+  /// result before the cursor of its region wraps. Return
+  /// TRITONSERVER_ERROR_NOT_FOUND if no registered region is large
+  /// enough.
+  /// \param byte_size The size, in bytes, of the block to reserve.
+  /// \param region_name Returns the name of the chosen region.
+  /// \param offset Returns the offset of the block within the region.
+  /// \param base Returns the pointer to the reserved block.
+  /// \return a TRITONSERVER_Error indicating success or failure.
+  TRITONSERVER_Error* AutoReserve(
+      const size_t byte_size, std::string* region_name, size_t* offset,
+      void** base);
+
   /// FIXMEV2 remove the Unregister/GetStatus that don't require mem type arg
 
   /// Removes the named shared memory block from the manager. Any future
@@ -160,6 +195,36 @@ class SharedMemoryManager {
   /// A helper function to remove the named shared memory blocks.
   TRITONSERVER_Error* UnregisterHelper(const std::string& name);
 
+#ifdef TRTIS_ENABLE_GPU
+  /// Register a single CUDA shared memory block. Must hold 'mu_'.
+  TRITONSERVER_Error* RegisterCUDASharedMemoryHelper(
+      const std::string& name, const cudaIpcMemHandle_t* cuda_shm_handle,
+      const size_t byte_size, const int device_id);
+
+  /// Decrease the use count of a cached CUDA IPC mapping. An idle
+  /// mapping is kept open for later re-registration of the same
+  /// handle; the least recently used idle mappings are closed when
+  /// too many accumulate. Must hold 'mu_'.
+  TRITONSERVER_Error* ReleaseCudaIpcMapping(
+      const std::string& ipc_key, void* mapped_addr);
+
+  /// Close least recently used idle CUDA IPC mappings until at most
+  /// 'max_idle' remain. Must hold 'mu_'.
+  TRITONSERVER_Error* CloseIdleCudaIpcMappings(const size_t max_idle);
+
+  /// Decrease the use count of a cached host-registered system
+  /// shared memory mapping. An idle mapping stays mapped and
+  /// registered for later re-registration of the same region; the
+  /// least recently used idle mappings are torn down when too many
+  /// accumulate. Must hold 'mu_'.
+  TRITONSERVER_Error* ReleaseHostRegistration(
+      const std::string& reg_key, void* mapped_addr, const size_t byte_size);
+
+  /// Tear down least recently used idle host-registered mappings
+  /// until at most 'max_idle' remain. Must hold 'mu_'.
+  TRITONSERVER_Error* CloseIdleHostRegistrations(const size_t max_idle);
+#endif  // TRTIS_ENABLE_GPU
+
   /// A helper function to remove the named shared memory blocks of
   /// specified type
   TRITONSERVER_Error* UnregisterHelper(
@@ -187,6 +252,19 @@ class SharedMemoryManager {
     void* mapped_addr_;
     TRITONSERVER_Memory_Type kind_;
     int64_t device_id_;
+
+    // For a CUDA region, the key of the cached IPC mapping that
+    // 'mapped_addr_' was obtained from.
+    std::string cuda_ipc_key_;
+
+    // For a CPU region, the key of the cached host registration that
+    // 'mapped_addr_' was obtained from, empty if the mapping is not
+    // in the registration cache.
+    std::string host_registration_key_;
+
+    // For a CPU region, the wrapping cursor used to hand out blocks
+    // for automatic output placement.
+    size_t auto_cursor_ = 0;
   };
 
   using SharedMemoryStateMap =
@@ -196,6 +274,54 @@ class SharedMemoryManager {
   SharedMemoryStateMap shared_memory_map_;
   // A mutex to protect the concurrent access to shared_memory_map_
   std::mutex mu_;
+
+#ifdef TRTIS_ENABLE_GPU
+  /// A cached CUDA IPC mapping, keyed by the raw handle bytes and
+  /// device, so that re-registration of the same handle reuses the
+  /// existing mapping instead of repeating the device-synchronizing
+  /// cudaIpcOpenMemHandle call. A mapping with 'use_count_' zero
+  /// stays open for later reuse until evicted.
+  struct CudaIpcMapping {
+    void* mapped_addr_;
+    size_t use_count_;
+    uint64_t last_use_;
+  };
+
+  // The maximum number of idle CUDA IPC mappings kept open for
+  // reuse.
+  static constexpr size_t kCudaIpcIdleCacheLimit = 16;
+
+  // The cached CUDA IPC mappings and the clock used to order idle
+  // mappings for eviction. Guarded by 'mu_'.
+  std::map<std::string, CudaIpcMapping> cuda_ipc_cache_;
+  uint64_t cuda_ipc_lru_clock_ = 0;
+
+  /// A system shared memory mapping that has been registered with
+  /// CUDA via cudaHostRegister so that copies between the region and
+  /// GPU memory run at pinned speed, keyed by the shm key, offset and
+  /// byte size of the mapping. Since cudaHostRegister must pin every
+  /// page of the region it is expensive, so a mapping with
+  /// 'use_count_' zero stays mapped and registered for later
+  /// re-registration of the same region until evicted. 'registered_'
+  /// is false if cudaHostRegister failed for the mapping, in which
+  /// case only the mapping itself is cached.
+  struct HostRegistration {
+    void* mapped_addr_;
+    size_t byte_size_;
+    bool registered_;
+    size_t use_count_;
+    uint64_t last_use_;
+  };
+
+  // The maximum number of idle host-registered mappings kept for
+  // reuse.
+  static constexpr size_t kHostRegistrationIdleCacheLimit = 8;
+
+  // The cached host registrations and the clock used to order idle
+  // registrations for eviction. Guarded by 'mu_'.
+  std::map<std::string, HostRegistration> host_registration_cache_;
+  uint64_t host_registration_lru_clock_ = 0;
+#endif  // TRTIS_ENABLE_GPU
 };
 
 }}  // namespace nvidia::inferenceserver
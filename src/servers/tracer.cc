@@ -26,11 +26,46 @@
 
 #include "src/servers/tracer.h"
 
+#include <chrono>
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// The binary trace format is an 8-byte magic header followed by
+// self-describing records, all multi-byte values little-endian:
+//
+//   name record:  u8 type=1, u16 table index, u16 length, 'length'
+//                 bytes of name
+//   trace record: u8 type=2, u16 model-name table index, i64 model
+//                 version, i64 id, i64 parent id, u16 event count,
+//                 then for each event a u16 name table index and a
+//                 u64 nanosecond timestamp
+//
+// The qa/common/trace_binary_to_json.py tool decodes this format.
+constexpr char kTraceFileMagic[] = "TRTSTRC1";
+constexpr uint8_t kNameRecordType = 1;
+constexpr uint8_t kTraceRecordType = 2;
+
+// How often the writer thread drains the trace queue.
+constexpr int kWriterIntervalMs = 100;
+
+// Write 'byte_cnt' bytes of 'value' in little-endian order,
+// independent of the host byte order.
+void
+WriteLE(std::ofstream* out, uint64_t value, size_t byte_cnt)
+{
+  char buf[8];
+  for (size_t i = 0; i < byte_cnt; ++i) {
+    buf[i] = (char)((value >> (8 * i)) & 0xff);
+  }
+  out->write(buf, byte_cnt);
+}
+
+}  // namespace
+
 TRITONSERVER_Error*
 TraceManager::Create(
     std::shared_ptr<TraceManager>* manager, const std::string& filepath)
@@ -43,7 +78,7 @@ TraceManager::Create(
 
   try {
     std::unique_ptr<std::ofstream> trace_file(new std::ofstream);
-    trace_file->open(filepath);
+    trace_file->open(filepath, std::ios::out | std::ios::binary);
 
     LOG_INFO << "Configure trace: " << filepath;
     manager->reset(new TraceManager(std::move(trace_file)));
@@ -64,18 +99,22 @@ TraceManager::Create(
 }
 
 TraceManager::TraceManager(std::unique_ptr<std::ofstream> trace_file)
-    : trace_file_(std::move(trace_file)), trace_cnt_(0),
-      level_(TRITONSERVER_TRACE_LEVEL_DISABLED), rate_(1000), sample_(1)
+    : trace_file_(std::move(trace_file)),
+      level_(TRITONSERVER_TRACE_LEVEL_DISABLED), default_sample_state_(1000),
+      writer_thread_exit_(false)
 {
+  trace_file_->write(kTraceFileMagic, 8);
+  writer_thread_.reset(new std::thread([this] { WriterThread(); }));
 }
 
 TraceManager::~TraceManager()
 {
   LOG_INFO << "Close trace";
 
-  if (trace_cnt_ > 0) {
-    *trace_file_ << "]";
-  }
+  // The writer thread performs a final drain of the queue after
+  // seeing the exit flag, so no queued trace is lost.
+  writer_thread_exit_.store(true);
+  writer_thread_->join();
 
   trace_file_->close();
 }
@@ -95,18 +134,51 @@ TRITONSERVER_Error*
 TraceManager::SetRate(uint32_t rate)
 {
   // We don't bother with a mutex here since this is the only writer.
-  rate_ = rate;
+  default_sample_state_.rate_ = rate;
 
   LOG_INFO << "Setting trace rate: " << rate;
 
   return nullptr;  // success
 }
 
+TRITONSERVER_Error*
+TraceManager::SetModelRate(const std::string& model_name, uint32_t rate)
+{
+  // Must be called before the server handles requests, SampleTrace()
+  // reads the map without a lock.
+  model_sample_states_[model_name].reset(new SampleState(rate));
+
+  LOG_INFO << "Setting trace rate for " << model_name << ": " << rate;
+
+  return nullptr;  // success
+}
+
 TraceMetaData*
 TraceManager::SampleTrace()
 {
-  uint64_t s = sample_.fetch_add(1);
-  if ((s % rate_) != 0) {
+  return Sample(&default_sample_state_);
+}
+
+TraceMetaData*
+TraceManager::SampleTrace(const std::string& model_name)
+{
+  const auto itr = model_sample_states_.find(model_name);
+  if (itr == model_sample_states_.end()) {
+    return Sample(&default_sample_state_);
+  }
+
+  return Sample(itr->second.get());
+}
+
+TraceMetaData*
+TraceManager::Sample(SampleState* state)
+{
+  if (state->rate_ == 0) {
+    return nullptr;
+  }
+
+  uint64_t s = state->sample_.fetch_add(1);
+  if ((s % state->rate_) != 0) {
     return nullptr;
   }
 
@@ -222,45 +294,95 @@ TraceManager::ReleaseTrace(
 }
 
 void
-TraceManager::WriteTrace(const std::stringstream& ss)
+TraceManager::WriteTrace(TraceRecord&& record)
 {
-  std::lock_guard<std::mutex> lock(mu_);
+  trace_queue_.Push(std::move(record));
+}
 
-  if (trace_file_ != nullptr) {
-    if (trace_cnt_ == 0) {
-      *trace_file_ << "[";
-    } else {
-      *trace_file_ << ",";
+void
+TraceManager::WriterThread()
+{
+  while (!writer_thread_exit_.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(kWriterIntervalMs));
+
+    for (const auto& record : trace_queue_.DrainAll()) {
+      WriteRecord(record);
     }
 
-    *trace_file_ << ss.rdbuf();
+    trace_file_->flush();
+  }
+
+  // Pick up any traces queued after the last drain above.
+  for (const auto& record : trace_queue_.DrainAll()) {
+    WriteRecord(record);
+  }
+
+  trace_file_->flush();
+}
+
+uint16_t
+TraceManager::InternName(const std::string& name)
+{
+  const auto itr = name_index_.find(name);
+  if (itr != name_index_.end()) {
+    return itr->second;
+  }
+
+  const uint16_t index = (uint16_t)name_index_.size();
+  name_index_.emplace(name, index);
+
+  WriteLE(trace_file_.get(), kNameRecordType, 1);
+  WriteLE(trace_file_.get(), index, 2);
+  WriteLE(trace_file_.get(), name.size(), 2);
+  trace_file_->write(name.data(), name.size());
+
+  return index;
+}
+
+void
+TraceManager::WriteRecord(const TraceRecord& record)
+{
+  // Intern all names first since interning writes a name record
+  // inline and name records must precede the trace record that
+  // references them.
+  const uint16_t model_index = InternName(record.model_name_);
+
+  std::vector<uint16_t> event_indices;
+  event_indices.reserve(record.events_.size());
+  for (const auto& event : record.events_) {
+    event_indices.push_back(InternName(event.name_));
   }
 
-  trace_cnt_++;
+  WriteLE(trace_file_.get(), kTraceRecordType, 1);
+  WriteLE(trace_file_.get(), model_index, 2);
+  WriteLE(trace_file_.get(), (uint64_t)record.model_version_, 8);
+  WriteLE(trace_file_.get(), (uint64_t)record.id_, 8);
+  WriteLE(trace_file_.get(), (uint64_t)record.parent_id_, 8);
+  WriteLE(trace_file_.get(), event_indices.size(), 2);
+  for (size_t i = 0; i < event_indices.size(); ++i) {
+    WriteLE(trace_file_.get(), event_indices[i], 2);
+    WriteLE(trace_file_.get(), record.events_[i].timestamp_ns_, 8);
+  }
 }
 
 Tracer::Tracer(
     const std::shared_ptr<TraceManager>& manager,
     TRITONSERVER_Trace_Level level)
     : manager_(manager), level_(level), model_version_(-1), id_(-1),
-      parent_id_(-1), timestamp_cnt_(0), trace_(nullptr)
+      parent_id_(-1), trace_(nullptr)
 {
-  tout_ << "{ \"timestamps\": [";
 }
 
 Tracer::~Tracer()
 {
-  tout_ << "], \"model_name\": \"" << model_name_
-        << "\", \"model_version\": " << model_version_;
-  if (id_ != -1) {
-    tout_ << ", \"id\":" << id_;
-  }
-  if (parent_id_ != -1) {
-    tout_ << ", \"parent_id\":" << parent_id_;
-  }
-  tout_ << " }";
+  TraceRecord record;
+  record.model_name_ = std::move(model_name_);
+  record.model_version_ = model_version_;
+  record.id_ = id_;
+  record.parent_id_ = parent_id_;
+  record.events_ = std::move(events_);
 
-  manager_->WriteTrace(tout_);
+  manager_->WriteTrace(std::move(record));
 
   if (trace_ != nullptr) {
     LOG_TRITONSERVER_ERROR(TRITONSERVER_TraceDelete(trace_), "deleting trace");
@@ -279,12 +401,7 @@ Tracer::CaptureTimestamp(
       timestamp_ns = TIMESPEC_TO_NANOS(ts);
     }
 
-    if (timestamp_cnt_ != 0) {
-      tout_ << ",";
-    }
-
-    tout_ << "{\"name\":\"" << name << "\", \"ns\":" << timestamp_ns << "}";
-    timestamp_cnt_++;
+    events_.emplace_back(name, timestamp_ns);
   }
 }
 
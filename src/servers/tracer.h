@@ -27,10 +27,12 @@
 
 #include <atomic>
 #include <fstream>
+#include <map>
 #include <memory>
-#include <mutex>
-#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
+#include "src/core/mpsc_queue.h"
 #include "src/core/tritonserver.h"
 #include "src/core/trtserver.h"
 
@@ -46,9 +48,38 @@ struct TraceMetaData {
   std::unique_ptr<Tracer> tracer_;
 };
 
+// A single captured trace event: a timestamp name and the nanosecond
+// precision time. The names come from a small set of well-known
+// strings and are interned into a name table when the trace is
+// written.
+struct TraceEvent {
+  TraceEvent(const std::string& name, uint64_t timestamp_ns)
+      : name_(name), timestamp_ns_(timestamp_ns)
+  {
+  }
+  std::string name_;
+  uint64_t timestamp_ns_;
+};
+
+// A completed trace, queued for the writer thread.
+struct TraceRecord {
+  std::string model_name_;
+  int64_t model_version_;
+  int64_t id_;
+  int64_t parent_id_;
+  std::vector<TraceEvent> events_;
+};
+
 //
 // Manager for tracing to a file.
 //
+// Request threads only append events to a per-trace buffer; completed
+// traces are pushed onto a lock-free queue and written by a
+// background thread in a compact binary format, so tracing never
+// formats text, takes a file lock, or performs file I/O on the
+// request path. The qa/common/trace_binary_to_json.py tool converts
+// the binary output to the documented JSON trace schema.
+//
 class TraceManager : public std::enable_shared_from_this<TraceManager> {
  public:
   // Create a trace manager that appends trace information
@@ -58,15 +89,25 @@ class TraceManager : public std::enable_shared_from_this<TraceManager> {
 
   ~TraceManager();
 
-  // Set the trace level and sampling rate.
+  // Set the trace level and default sampling rate.
   TRITONSERVER_Error* SetLevel(TRITONSERVER_Trace_Level level);
   TRITONSERVER_Error* SetRate(uint32_t rate);
 
+  // Set the sampling rate for a single model, overriding the default
+  // rate. A rate of 0 disables tracing for the model. Must be called
+  // before the server starts handling requests.
+  TRITONSERVER_Error* SetModelRate(
+      const std::string& model_name, uint32_t rate);
+
   // Return a trace meta data object that should be used to collected trace
   // activities for an inference request. Return nullptr if no tracing
   // should occur.
   TraceMetaData* SampleTrace();
 
+  // As above, but sampled at the rate configured for 'model_name' if
+  // one was set with SetModelRate().
+  TraceMetaData* SampleTrace(const std::string& model_name);
+
   // FIXMEV2 remove the static functions with TRTSERVER_Trace
   // Create a trace object that should be used to collected trace
   // activities for the model execution. Return nullptr if no tracing
@@ -85,8 +126,9 @@ class TraceManager : public std::enable_shared_from_this<TraceManager> {
   static void ReleaseTrace(
       TRITONSERVER_Trace* trace, void* activity_userp, void* userp);
 
-  // Write to the trace file.
-  void WriteTrace(const std::stringstream& ss);
+  // Queue a completed trace for the writer thread. Lock-free, may be
+  // called concurrently from any number of threads.
+  void WriteTrace(TraceRecord&& record);
 
  private:
   TraceManager(std::unique_ptr<std::ofstream> trace_file);
@@ -94,15 +136,49 @@ class TraceManager : public std::enable_shared_from_this<TraceManager> {
   // Helper function to create a new trace object.
   void NewTrace(TRITONSERVER_Trace** trace);
 
-  std::mutex mu_;
+  // Sampling state: an atomically incrementing counter and the rate
+  // it is tested against.
+  struct SampleState {
+    SampleState(uint32_t rate) : rate_(rate), sample_(0) {}
+    uint32_t rate_;
+    std::atomic<uint64_t> sample_;
+  };
+
+  TraceMetaData* Sample(SampleState* state);
+
+  // The writer thread drains 'trace_queue_' and writes the binary
+  // trace records.
+  void WriterThread();
+
+  // Return the index of 'name' in the trace file's name table,
+  // writing a name record first if the name has not been seen. Only
+  // called by the writer thread.
+  uint16_t InternName(const std::string& name);
+
+  // Write one binary trace record. Only called by the writer thread.
+  void WriteRecord(const TraceRecord& record);
+
   std::unique_ptr<std::ofstream> trace_file_;
-  uint32_t trace_cnt_;
 
   TRITONSERVER_Trace_Level level_;
-  uint32_t rate_;
 
-  // Atomically incrementing counter used to implement sampling rate.
-  std::atomic<uint64_t> sample_;
+  // Default sampling state, used for models without a configured
+  // rate.
+  SampleState default_sample_state_;
+
+  // Per-model sampling state. Configured before the server handles
+  // requests and read-only afterwards, so accessed without a lock.
+  std::map<std::string, std::unique_ptr<SampleState>> model_sample_states_;
+
+  // Completed traces awaiting the writer thread.
+  MpscQueue<TraceRecord> trace_queue_;
+
+  // Names already written to the trace file and their table indices.
+  // Only touched by the writer thread.
+  std::map<std::string, uint16_t> name_index_;
+
+  std::unique_ptr<std::thread> writer_thread_;
+  std::atomic<bool> writer_thread_exit_;
 };
 
 //
@@ -151,8 +227,7 @@ class Tracer {
   int64_t id_;
   int64_t parent_id_;
 
-  std::stringstream tout_;
-  uint32_t timestamp_cnt_;
+  std::vector<TraceEvent> events_;
 
   TRITONSERVER_Trace* trace_;
 };
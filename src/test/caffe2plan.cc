@@ -29,12 +29,15 @@
 #include <cuda_runtime_api.h>
 #include <errno.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <unistd.h>
 #include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <sstream>
+#include <string>
 #include <vector>
 
 namespace {
@@ -261,6 +264,108 @@ class Int8EntropyCalibrator : public nvinfer1::IInt8EntropyCalibrator {
   std::vector<char> mCalibrationCache;
 };
 
+// Full builder optimization takes minutes per network, so the built
+// PLAN is cached beside the output file and reused when the network,
+// the build parameters and the GPU are all unchanged. The cache file
+// holds the cache key on the first line followed by the serialized
+// PLAN; a key mismatch (new network, new flags, different GPU arch)
+// falls through to a full build that then refreshes the cache.
+uint64_t
+HashBytes(const void* data, size_t byte_size, uint64_t hash)
+{
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < byte_size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}
+
+bool
+HashFileContents(const std::string& path, uint64_t* hash)
+{
+  std::ifstream input(path, std::ios::binary);
+  if (!input.good()) {
+    return false;
+  }
+
+  char buffer[65536];
+  while (input.read(buffer, sizeof(buffer)) || (input.gcount() > 0)) {
+    *hash = HashBytes(buffer, input.gcount(), *hash);
+  }
+
+  return true;
+}
+
+bool
+BuildCacheKey(
+    const std::string& prototxt_filename, const std::string& model_filename,
+    const std::vector<std::string>& output_names,
+    nvinfer1::DataType model_dtype, const std::string& calibration_filename,
+    const size_t max_batch_size, const size_t max_workspace_size,
+    std::string* key)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  if (!HashFileContents(prototxt_filename, &hash) ||
+      !HashFileContents(model_filename, &hash)) {
+    return false;
+  }
+
+  std::ostringstream params;
+  for (const auto& name : output_names) {
+    params << name << ";";
+  }
+  params << static_cast<int>(model_dtype) << ";" << calibration_filename
+         << ";" << max_batch_size << ";" << max_workspace_size;
+  const std::string params_str = params.str();
+  hash = HashBytes(params_str.data(), params_str.size(), hash);
+
+  // The PLAN embeds tactics selected for the GPU it was built on, so
+  // the GPU arch is part of the key and a cache built on one arch is
+  // never reused on another.
+  cudaDeviceProp prop;
+  if (cudaGetDeviceProperties(&prop, 0) != cudaSuccess) {
+    return false;
+  }
+
+  std::ostringstream full_key;
+  full_key << std::hex << hash << std::dec << "-sm" << prop.major
+           << prop.minor << "-" << prop.name;
+  *key = full_key.str();
+  return true;
+}
+
+bool
+ReadCachedPlan(
+    const std::string& cache_filename, const std::string& key,
+    std::vector<char>* plan)
+{
+  std::ifstream input(cache_filename, std::ios::binary);
+  if (!input.good()) {
+    return false;
+  }
+
+  std::string cached_key;
+  if (!std::getline(input, cached_key) || (cached_key != key)) {
+    return false;
+  }
+
+  plan->assign(
+      std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  return !plan->empty();
+}
+
+void
+WriteCachedPlan(
+    const std::string& cache_filename, const std::string& key,
+    const void* plan_data, const size_t plan_byte_size)
+{
+  std::ofstream output(cache_filename, std::ios::binary);
+  output << key << '\n';
+  output.write(reinterpret_cast<const char*>(plan_data), plan_byte_size);
+}
+
 bool
 CaffeToPlan(
     const std::string& output_filename, const std::string& prototxt_filename,
@@ -284,6 +389,33 @@ CaffeToPlan(
     model_dtype = nvinfer1::DataType::kFLOAT;
   }
 
+  // Key the cache on the effective datatype, after any downgrade
+  // above, since that is what the builder actually uses.
+  const std::string cache_filename = output_filename + ".cache";
+  std::string cache_key;
+  const bool has_cache_key = BuildCacheKey(
+      prototxt_filename, model_filename, output_names, model_dtype,
+      calibration_filename, max_batch_size, max_workspace_size, &cache_key);
+
+  if (has_cache_key) {
+    std::vector<char> cached_plan;
+    if (ReadCachedPlan(cache_filename, cache_key, &cached_plan)) {
+      std::cerr << "Using cached PLAN from " << cache_filename << std::endl;
+
+      std::ofstream output(
+          output_filename, std::ios::binary | std::ios::out | std::ios::app);
+      output.write(&cached_plan[0], cached_plan.size());
+      output.close();
+
+      parser->destroy();
+      network->destroy();
+      builder->destroy();
+      nvcaffeparser1::shutdownProtobufLibrary();
+
+      return true;
+    }
+  }
+
   const nvcaffeparser1::IBlobNameToTensor* name_to_tensor = parser->parse(
       prototxt_filename.c_str(), model_filename.c_str(), *network,
       (model_dtype == nvinfer1::DataType::kINT8) ? nvinfer1::DataType::kFLOAT
@@ -321,6 +453,10 @@ CaffeToPlan(
   output.write(reinterpret_cast<const char*>(plan->data()), plan->size());
   output.close();
 
+  if (has_cache_key) {
+    WriteCachedPlan(cache_filename, cache_key, plan->data(), plan->size());
+  }
+
   engine->destroy();
   parser->destroy();
   network->destroy();
@@ -0,0 +1,359 @@
+// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Microbenchmarks for the scheduler and allocator hot paths. Run with
+//   core_benchmark --benchmark_out=<file> --benchmark_out_format=json
+// to produce results that can be compared between commits.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "src/core/backend.h"
+#include "src/core/dynamic_batch_scheduler.h"
+#include "src/core/infer_request.h"
+#include "src/core/memory.h"
+#include "src/core/model_config.pb.h"
+#include "src/core/pinned_memory_manager.h"
+#include "src/core/scheduler_utils.h"
+#include "src/core/server_status.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+std::shared_ptr<ni::ModelInferStats>
+CreateInferStats()
+{
+#ifdef TRTIS_ENABLE_STATS
+  static auto status_manager =
+      std::make_shared<ni::ServerStatusManager>("0.0.0");
+  return std::make_shared<ni::ModelInferStats>(status_manager, "benchmark");
+#else
+  return std::make_shared<ni::ModelInferStats>();
+#endif  // TRTIS_ENABLE_STATS
+}
+
+std::shared_ptr<ni::InferenceRequest>
+CreateRequest()
+{
+  auto request = std::make_shared<ni::InferenceRequest>(
+      "benchmark", -1 /* requested_model_version */,
+      -1 /* actual_model_version */, 1 /* protocol_version */);
+  request->SetBatchSize(1);
+  return request;
+}
+
+// Wrapper of InferenceBackend to expose SetModelConfig() so that a
+// request can be normalized against a configuration without loading a
+// full model.
+class BenchmarkBackend : public ni::InferenceBackend {
+ public:
+  BenchmarkBackend() : ni::InferenceBackend(0 /* min_compute_capability */) {}
+  ni::Status Init(const ni::ModelConfig& config)
+  {
+    return SetModelConfig("1" /* version path */, config);
+  }
+};
+
+//
+// DynamicBatchScheduler enqueue/dequeue throughput with a varying
+// number of concurrent producers. The run function completes the
+// payloads immediately so that the measurement is dominated by the
+// scheduling itself.
+//
+void
+BM_DynamicBatchSchedulerEnqueue(benchmark::State& state)
+{
+  const size_t producer_cnt = state.range(0);
+  const size_t requests_per_producer = 256;
+
+  std::atomic<size_t> completed(0);
+
+  ni::Scheduler::StandardInitFunc OnInit = [](uint32_t) {
+    return ni::Status::Success;
+  };
+  ni::Scheduler::StandardWarmupFunc OnWarmup = [](uint32_t) {
+    return ni::Status::Success;
+  };
+  ni::Scheduler::StandardReleaseFunc OnRelease = [](uint32_t) {
+    return ni::Status::Success;
+  };
+  ni::Scheduler::StandardShapeTensorPeekFunc OnPeek =
+      [](uint32_t, const ni::InferenceRequest::Input&,
+         const ni::Scheduler::Payload&, std::vector<int64_t>*) {
+        return ni::Status::Success;
+      };
+  ni::Scheduler::StandardRunFunc OnSchedule =
+      [&completed](
+          uint32_t, std::vector<ni::Scheduler::Payload>* payloads,
+          std::function<void(const ni::Status&)> OnRunComplete) {
+        for (auto& payload : *payloads) {
+          payload.complete_function_(ni::Status::Success);
+        }
+        completed += payloads->size();
+        OnRunComplete(ni::Status::Success);
+      };
+
+  std::unique_ptr<ni::Scheduler> scheduler;
+  auto status = ni::DynamicBatchScheduler::Create(
+      0 /* runner_id_start */, 2 /* runner_cnt */, 0 /* nice */, OnInit,
+      OnWarmup, OnSchedule, OnPeek, true /* dynamic_batching_enabled */,
+      std::unordered_map<std::string, bool>() /* enforce_equal_shape_tensors */,
+      false /* preserve_ordering */, std::set<int32_t>({8}),
+      0 /* max_queue_delay_microseconds */, 1 /* min_active_runner_cnt */,
+      0 /* scale_to_zero_idle_microseconds */, OnRelease,
+      nullptr /* metric_reporter */, &scheduler);
+  if (!status.IsOk()) {
+    state.SkipWithError(status.Message().c_str());
+    return;
+  }
+
+  for (auto _ : state) {
+    completed = 0;
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producer_cnt; p++) {
+      producers.emplace_back([&scheduler, requests_per_producer]() {
+        for (size_t i = 0; i < requests_per_producer; i++) {
+          scheduler->Enqueue(
+              CreateInferStats(), CreateRequest(),
+              nullptr /* response_provider */, [](const ni::Status&) {});
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    while (completed.load() < (producer_cnt * requests_per_producer)) {
+      std::this_thread::yield();
+    }
+  }
+
+  state.SetItemsProcessed(
+      state.iterations() * producer_cnt * requests_per_producer);
+}
+BENCHMARK(BM_DynamicBatchSchedulerEnqueue)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//
+// PriorityQueue enqueue/dequeue with different priority-level and
+// queue-policy mixes. The timeouts are long enough that no request
+// actually expires, so only the policy bookkeeping is measured.
+//
+void
+BM_PriorityQueueEnqueueDequeue(benchmark::State& state)
+{
+  const uint32_t priority_levels = state.range(0);
+  const bool policy_mix = (state.range(1) != 0);
+  const size_t request_cnt = 64;
+
+  ni::ModelQueuePolicy default_policy;
+  ni::ModelQueuePolicyMap policy_map;
+  if (policy_mix) {
+    default_policy.set_timeout_action(ni::ModelQueuePolicy::REJECT);
+    default_policy.set_default_timeout_microseconds(60 * 1000 * 1000);
+    ni::ModelQueuePolicy delay_policy = default_policy;
+    delay_policy.set_timeout_action(ni::ModelQueuePolicy::DELAY);
+    policy_map[1] = delay_policy;
+  }
+
+  std::vector<std::shared_ptr<ni::InferenceRequest>> requests;
+  for (size_t i = 0; i < request_cnt; i++) {
+    requests.push_back(CreateRequest());
+  }
+
+  for (auto _ : state) {
+    ni::PriorityQueue queue(default_policy, priority_levels, policy_map);
+    for (size_t i = 0; i < request_cnt; i++) {
+      const uint32_t level =
+          (priority_levels == 0) ? 0 : ((i % priority_levels) + 1);
+      ni::Scheduler::Payload payload(
+          nullptr /* stats */, requests[i], nullptr /* response_provider */,
+          [](const ni::Status&) {});
+      queue.Enqueue(level, std::move(payload));
+    }
+    while (!queue.Empty()) {
+      ni::Scheduler::Payload payload;
+      queue.Dequeue(&payload);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * request_cnt);
+}
+BENCHMARK(BM_PriorityQueueEnqueueDequeue)
+    ->Args({0, 0})
+    ->Args({4, 0})
+    ->Args({4, 1})
+    ->Args({16, 1});
+
+//
+// PinnedMemoryManager allocation/deallocation under contention. The
+// thread count gives the number of threads allocating concurrently
+// from the shared pool.
+//
+void
+BM_PinnedMemoryManagerAllocFree(benchmark::State& state)
+{
+  const uint64_t byte_size = state.range(0);
+
+  for (auto _ : state) {
+    void* ptr;
+    TRTSERVER_Memory_Type allocated_type;
+    auto status = ni::PinnedMemoryManager::Alloc(
+        &ptr, byte_size, &allocated_type, true /* allow_nonpinned_fallback */);
+    if (!status.IsOk()) {
+      state.SkipWithError(status.Message().c_str());
+      return;
+    }
+    ni::PinnedMemoryManager::Free(ptr);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PinnedMemoryManagerAllocFree)
+    ->Arg(1 << 10)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+//
+// MemoryReference::BufferAt iteration across a varying number of
+// buffer chunks, as done by the input-gather path.
+//
+void
+BM_MemoryReferenceBufferAt(benchmark::State& state)
+{
+  const size_t buffer_cnt = state.range(0);
+
+  std::vector<char> chunk(1024);
+  ni::MemoryReference memory;
+  for (size_t i = 0; i < buffer_cnt; i++) {
+    memory.AddBuffer(&chunk[0], chunk.size(), TRTSERVER_MEMORY_CPU, 0);
+  }
+
+  for (auto _ : state) {
+    size_t idx = 0;
+    size_t byte_size;
+    TRTSERVER_Memory_Type memory_type;
+    int64_t memory_type_id;
+    const char* buffer;
+    while ((buffer = memory.BufferAt(
+                idx++, &byte_size, &memory_type, &memory_type_id)) !=
+           nullptr) {
+      benchmark::DoNotOptimize(buffer);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * buffer_cnt);
+}
+BENCHMARK(BM_MemoryReferenceBufferAt)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096);
+
+//
+// InferenceRequest normalization against a model configuration with a
+// varying number of inputs. Includes the construction of the request
+// since the two always happen together on the request path.
+//
+void
+BM_InferenceRequestNormalize(benchmark::State& state)
+{
+  const size_t input_cnt = state.range(0);
+
+  ni::ModelConfig config;
+  config.set_name("benchmark");
+  config.set_max_batch_size(8);
+  for (size_t i = 0; i < input_cnt; i++) {
+    auto input = config.add_input();
+    input->set_name("INPUT" + std::to_string(i));
+    input->set_data_type(ni::DataType::TYPE_FP32);
+    input->add_dims(16);
+  }
+  auto output = config.add_output();
+  output->set_name("OUTPUT0");
+  output->set_data_type(ni::DataType::TYPE_FP32);
+  output->add_dims(16);
+
+  BenchmarkBackend backend;
+  auto status = backend.Init(config);
+  if (!status.IsOk()) {
+    state.SkipWithError(status.Message().c_str());
+    return;
+  }
+
+  const std::vector<int64_t> shape{16};
+  for (auto _ : state) {
+    ni::InferenceRequest request(
+        "benchmark", 1 /* requested_model_version */,
+        1 /* actual_model_version */, 1 /* protocol_version */);
+    request.SetBatchSize(1);
+    for (size_t i = 0; i < input_cnt; i++) {
+      request.AddOriginalInput(
+          "INPUT" + std::to_string(i), shape, 16 * sizeof(float));
+    }
+    status = request.PrepareForInference(backend);
+    if (!status.IsOk()) {
+      state.SkipWithError(status.Message().c_str());
+      return;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_InferenceRequestNormalize)->Arg(1)->Arg(4)->Arg(16);
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  ::benchmark::Initialize(&argc, argv);
+
+  // A single pinned memory pool is shared by all the benchmarks,
+  // large enough that the pool itself is not the bottleneck.
+  auto status = ni::PinnedMemoryManager::Create(
+      ni::PinnedMemoryManager::Options(1 << 28 /* 256 MB */));
+  if (!status.IsOk()) {
+    std::cerr << "failed to initialize pinned memory pool: "
+              << status.Message() << std::endl;
+    return 1;
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}